@@ -43,6 +43,10 @@
 #define MAX_DIR_LEVELS  150  // needs to be an even multiple of MIN_DIR_LEVELS; largest observed was dark messiah (22)
 
 #define WOW_THATS_A_LOT_OF_RAM 134217728  // 128 MB
+#define XEX_DEFAULTMEMORY 64              // MB a Xex check is allowed to use unless --xexmemory says otherwise
+#define XEX_WINDOWSIZE    4194304         // 4 MB, the most of a Xex's code that's read in at once
+#define XEX_MINWINDOWSIZE 131072          // 128 KB, give up if there isn't room for at least this much
+#define XEX_WINDOWSLACK   4096            // extra room past the window so reads can stay on sector boundaries
 
 // values for extended c/r
 #define NUM_SS_CR_SAMPLES   51  // should be an odd number, may cause poor formatting of bar graphs if greater than 59
@@ -72,9 +76,29 @@
 #include <math.h>      // for pow, roundf
 #include "rijndael-alg-fst.h"
 #include "sha1.h"
+#include "crc32.h"
+#include "aescbc.h"
+#include "sha1fast.h"
+#include "zeroscan.h"
 #include "mspack/mspack.h"
 #include "mspack/system.h"
 #include "mspack/lzx.h"
+#include "memspack.h"
+#include "xexhash.h"
+#ifndef WIN32
+    #include "readahead.h"
+    #include "shardcrc.h"
+    #include "fusedscan.h"
+    #include "sparse.h"
+    #include "filecopy.h"
+    #include "resultcache.h"
+    #include "chunkmanifest.h"
+    #include "iniindex.h"
+    #include "csvindex.h"
+    #include "prefetch.h"
+    #include "stealthstore.h"
+    #include "videopack.h"
+#endif
 
 #ifdef WIN32
     #define ABGX360_OS "Windows"
@@ -107,6 +131,8 @@
     #include <pwd.h>      // for getpwuid()
     #include <unistd.h>   // for getuid(), getpid(), read()
     #include <fcntl.h>    // for open(), fcntl()
+    #include <sys/wait.h> // for wait()
+    #include <sys/file.h> // for flock()
     int fd;
     #if defined(__linux__)
         #define ABGX360_OS "Linux"
@@ -166,6 +192,13 @@
 
 #define BIGBUF_SIZE 32768  // 32 KB, changing this could cause some problems
 
+// scratch globals the prefetch thread would otherwise share with the check it's prefetching for
+#ifdef _MSC_VER
+    #define THREADLOCAL __declspec(thread)
+#else
+    #define THREADLOCAL __thread
+#endif
+
 #define NUM_CURRENTPFIENTRIES   9  // update this when adding new pfi entries
 #define NUM_CURRENTVIDEOENTRIES 13 // update this when adding new video entries
 
@@ -214,6 +247,10 @@ char homedir[2048];
     char *stealthdir =     "StealthFiles/";
     char *userstealthdir = "UserStealthFiles/";
     char *imagedir =       "Images/";
+    char *resultcachedir = "ResultCache/";
+    char *iniindexfilename = "IniIndex.bin";
+    char *csvindexfilename = "CsvIndex.bin";
+    char *batchlockfilename = "Batch.lock";
 #endif
 
 // load replacements from abgx360.ini if it exists (make sure to update checkini() if these addresses are changed)
@@ -282,17 +319,35 @@ bool localonly = false, recursesubdirs = false, clobber = false;
 bool showachievements = false, hidesecretachievements = false, showavatarawards = false, unicode = false, imagedirmissing = false;
 bool skiplayerboundaryinfo = false, devkey = false, trustssv2angles = true, useinstalldir = false;
 struct badshit {unsigned char c[21], d[21], data[21]; int count; char* explanation;};
-char unrecognizedRTarray[21];
 // don't forget to add new args to the list before stat()
 int truncatearg = 0, userregionarg = 0, folderarg = 0, matcharg = 0, specialarg = 0, readretryarg = 0;
 int patchvideoarg = 0, patchpfiarg = 0, patchdmiarg = 0, patchssarg = 0;
 int extractvideoarg = 0, extractpfiarg = 0, extractdmiarg = 0, extractssarg = 0;
 int autouploaduserarg = 0, autouploadpassarg = 0, fixangledevarg = 0, connectiontimeoutarg = 0, dvdtimeoutarg = 0;
-int dvdarg = 0, userlangarg = 0, origarg = 0, speedarg = 0;
+int dvdarg = 0, userlangarg = 0, origarg = 0, speedarg = 0, crcthreadsarg = 0, queuedeptharg = 0, jobsarg = 0, devicejobsarg = 0;
+int xexmemoryarg = 0;
 //int riparg = 0, ripdestarg = 0;
 long connectiontimeout = 20, dvdtimeout = 20, userlang = 0;
+int crcthreads = 1, queuedepth = 1, jobs = 1, devicejobs = 1, xexmemory = XEX_DEFAULTMEMORY;
+bool onepass = false, iouring = false, odirect = false, batchchild = false, resultcache = true;
+bool makemanifest = false, reverify = false, useiniindex = true, rebuildiniindex = false, stealthprefetch = true;
+bool usestealthstore = true, gcstealthfiles = false, packvideofiles = false;
+#ifndef WIN32
+    // shared by every check (see findindexedini)
+    struct iniindex iniindex;
+    bool iniindexopened = false;
+    pthread_mutex_t iniindexlock = PTHREAD_MUTEX_INITIALIZER;
+    // shared by every check (see findcsvgamename)
+    struct csvindex csvindex;
+    bool csvindexopened = false;
+    // held by a batch job while it writes files that the other jobs use too (see lockshared)
+    int sharedlockfd = -1;
+    pthread_mutex_t sharedlock = PTHREAD_MUTEX_INITIALIZER;
+    pthread_mutex_t csvindexlock = PTHREAD_MUTEX_INITIALIZER;
+#endif
 float speed = 0.0;
-unsigned long curlprogressstartmsecs, userregion = 0L;
+unsigned long userregion = 0L;
+THREADLOCAL unsigned long curlprogressstartmsecs;
 char *green = "\033[1;32;40m", *yellow = "\033[1;33;40m", *red = "\033[1;31;40m", *cyan = "\033[1;36;40m", *blue = "\033[1;34;40m";
 char *darkblue = "\033[0;34;40m", *white = "\033[1;37;40m", *arrow = "\033[1;34;40m", *box = "\033[1;34;40m", *normal = "\033[0;37;40m";
 char *wtfhexcolor = "\033[1;31;40m", *wtfcharcolor = "\033[1;37;41m", *reset = "\033[0m", *brown = "\033[0;33;40m", *filename = "\033[0;37;44m";
@@ -307,16 +362,12 @@ char *sp0 = "\0", *sp1 = " ", *sp2 = "  ", *sp3 = "   ", *sp4 = "    ", *sp5 = "
 char *sp6 = "      ", *sp7 = "       ", *sp8 = "        ", *sp9 = "         ";
 char *sp10 = "          ", *sp11 = "           ", *sp12 = "            ", *sp18 = "                  ";
 char *sp20 = "                    ", *sp21 = "                     ", *sp28 = "                            ";
-char buffer[2048], buffer2[2048];
-char inifilename[24], xexinifilename[17], gamename[151];
 char sense[20], specialerror[200];
 char installdirvideofilepath[2048] = {0};
-unsigned char ubuffer[2048], ss[2048], fixed_ss[2048], cdb[12], zeros[2048];
-unsigned char bigbuffer[BIGBUF_SIZE];
-unsigned long filecount = 0L;
-unsigned long seek;
+unsigned char cdb[12], zeros[2048];
+THREADLOCAL unsigned long filecount = 0L;
+THREADLOCAL unsigned long seek;
 unsigned long getuint(unsigned char* ptr), getuintmsb(unsigned char* ptr), getint(char* ptr);
-sha1_context ctx;
 /*
 static uchar pfisha1[3][20] =
 {  // {xbox1, x360 wave 1, x360 wave 2} (0,1,2)
@@ -331,28 +382,20 @@ static uchar videosha1[3][20] =
     {0xa3,0x95,0xd4,0x45,0x07,0x37,0x4e,0xea,0x04,0xd7,0x37,0xc9,0x4b,0x92,0xa7,0xd4,0x1a,0x41,0x16,0x77}
 };
 */
-unsigned char dmi_mediaid[16], ss_mediaid[16], xex_mediaid[16], xex_discprofileid[16], titleid[4];
-unsigned long pfi_sectorstotal, pfi_sectorsL0, pfi_sectorsL1;
-unsigned long long pfi_offsetL1, pfi_offsetL0end;
 void printhtmltop(int argc, char *argv[]), printhtmlbottom(), printheader(), color(char *color), printwtfhexcolor(), printwtfcharcolor();
 void printwin32filetime(unsigned long long win32filetime), printmediaid(unsigned char* mediaid), hexdump(unsigned char* ptr, int stealthtype, int bytes);
 void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkvideopadding), checkdmi(unsigned char *dmi), checkpfi(unsigned char *pfi);
 //void checkap25(char *argv[]);
 //unsigned char ap25[2048];
 void checktopology();
-unsigned char topology[TOPOLOGY_SIZE];
 int checkss(), doautofix(), doverify(), checkgame();
 unsigned long getzeros(unsigned char* ptr, unsigned long firstbyte, unsigned long lastbyte);
 bool lookslikepfi(unsigned char* pfi), lookslike360dmi(unsigned char* dmi), lookslikexbox1dmi(unsigned char* dmi);
 bool lookslike360ss(unsigned char* ss), lookslikexbox1ss(unsigned char* ss);
-unsigned long fix_ss_crc32;
-long long fpfilesize;
-int isofilearg, readretries = 20, charsprinted;
-unsigned long readerrorstotal, readerrorsrecovered, writeerrorstotal, writeerrorsrecovered;
-int readerrorcharsprinted;
-int returnvalue;
-long longreturnvalue;
-unsigned long sizeoverbuffer, bufferremainder;
+int isofilearg, readretries = 20;
+THREADLOCAL int charsprinted;
+THREADLOCAL int returnvalue;
+THREADLOCAL long longreturnvalue;
 int checkreadandprinterrors(void *ptr, size_t size, size_t nmemb, FILE *stream, unsigned long loop, unsigned long long startoffset, char *name, char *action);
 int checkwriteandprinterrors(const void *ptr, size_t size, size_t nmemb, FILE *stream, unsigned long loop, unsigned long long startoffset, char *name, char *action);
 void initcheckread(), donecheckread(char *name);
@@ -370,137 +413,290 @@ int doautoupload(char *argv[], bool upload_ss_only);
 int trytowritestealthfile(const void *ptr, size_t size, size_t nmemb, FILE *stream, char *filename, long long offset);
 int trytoreadstealthfile(void *ptr, size_t size, size_t nmemb, FILE *stream, char *filename, long long offset);
 int padzeros(FILE *stream, char *filename, long long startoffset, long long endoffset);
+int punchzeros(FILE *stream, unsigned long long startoffset, unsigned long long endoffset);
 int writeini(char *inifilename, char *ini_discsource, char *ini_gamename, char *ini_gamertag, char *ini_drivename, char *ini_drivefw, char *ini_notes);
 int extractstealthfile(FILE *isofile, char *isofilename, long long offset, char *name, char *stealthfilename);
 FILE *openstealthfile(char *stealthfilename, char *localdir, char *webdir, int type, char *location);
-unsigned char regioncode[4];
+FILE *openforwriting(const char *filename);
+int openini(char *inifilename, char *webdir, int type, char *location);
+void closeini(FILE **inifile);
 char *readstdin(char *dest, int size);
 void checkdat(), makedat();
 int dotruncate(char *filename, long long filesize, long long truncatesize, bool stfu);
-char *isofilename = NULL;
 void checkini();
-unsigned long long corruptionoffset[100];
+// results of the single pass scan (--onepass) for the ranges it was asked to read
+struct onepassrange {
+    bool valid;
+    unsigned long long start, end;
+    unsigned long crc;
+    bool founddata;                // padding ranges: data was found at firstdata
+    unsigned long long firstdata;
+    #ifndef WIN32
+        struct chunkmanifest_region *chunks;  // chunk CRCs for --manifest are built instead of crc
+    #endif
+};
+struct onepassresults {
+    struct onepassrange videoL0, videoL1, paddingL0, paddingL1, game;
+    int corruptionoffsetcount;
+    unsigned long long corruptionoffset[100];
+};
+void doonepassscan(char *isofilename, FILE *stream, bool checkvideopadding);
+#ifndef WIN32
+    struct onepassrange *cachedrange(int index);
+    void loadresultcache(), applyresultcache(), clearonepassresults(), saveresultcache(), cachegameresult(unsigned long long start, unsigned long long end);
+    void cacheresult(int index, unsigned long long start, unsigned long long end, unsigned long crc, bool founddata, unsigned long long firstdata);
+    struct chunkmanifest_region *startmanifestregion(const char *name, FILE *stream, unsigned long long start, unsigned long long end);
+    void savemanifest();
+    int doreverify();
+    bool findindexedini(char *inifilename, int type, struct iniindex_entry *entry);
+    int buildiniindex(bool force);
+    void invalidateiniindex();
+    int findcsvgamename(char *csvfilename, unsigned char *mediaid, char *gamename);
+    void invalidatecsvindex();
+    void prefetchstealthfiles();
+    void startprefetch(), waitforprefetch();
+    struct prefetch_file *findprefetched(char *stealthfilename);
+    void forgetprefetched(char *stealthfilename);
+    void addtostealthstore(char *stealthfilename, char *localdir);
+    bool stealthfiletrusted(char *stealthfilename, char *localdir, FILE *stream);
+    int dogcstealthfiles();
+    FILE *openpackedvideofile(char *fullpath);
+    int dopackvideofiles();
+    void reverifyprogress(void *arg, unsigned long long bytesdone, unsigned long long bytestotal);
+#endif
+bool onepasshasrange(struct onepassrange *range, unsigned long long start, unsigned long long end);
+void printcorruptionoffsets();
 bool unverifiediniexists();
+int insertrangerebuild(char *filename, long long gamepartitionsize, unsigned long long gamestartoffset);
+#ifndef WIN32
+    long runbatch(char **filenames, bool *blockdevice, unsigned long filecount);
+    void lockshared(), unlockshared();
+#endif
 int rebuildiso(char *filename);
+int copyfilerange(FILE *instream, char *infilename, unsigned long long inoffset, FILE *outstream, char *outfilename,
+                  unsigned long long outoffset, unsigned long long length, char *action, bool showprogress);
 void printseekerror(char *filename, char *action);
-struct filesys { unsigned long datasector, datalength; } *filesystem, *holes;
-CURL *curl;
-CURLcode res;
+struct filesys { unsigned long datasector, datalength; };
+THREADLOCAL CURL *curl;
+THREADLOCAL CURLcode res;
+#ifndef WIN32
+    THREADLOCAL struct prefetch prefetcher;  // curl_multi handle for prefetchstealthfiles()
+#endif
 struct MyCurlFile { const char *filename; FILE *stream; };
-char curlerrorbuffer[CURL_ERROR_SIZE+1];
-struct stat buf;
+THREADLOCAL char curlerrorbuffer[CURL_ERROR_SIZE+1];
+THREADLOCAL struct stat buf;
 void parsetitleidresource(unsigned char *resourcebuffer, unsigned long resourcesize);
-int checkdefaultxex(unsigned char *defaultxexbuffer, unsigned long defaultxexsize);
-size_t dontcare;
+int checkdefaultxex(unsigned char *defaultxexbuffer, unsigned long defaultxexsize, FILE *fp, unsigned long long defaultxexaddress,
+                    char *filename, char *action);
+unsigned char *readxexheader(unsigned char *firstsector, unsigned long defaultxexsize, FILE *fp, unsigned long long defaultxexaddress,
+                             char *filename, char *action);
+// a forward only window over the code of a Xex (from codeoffset to the end), read a few MB at a time and decrypted as
+// it comes in so the whole thing never has to be in memory at once
+struct xexstream {
+    FILE *fp;
+    char *filename, *action;
+    unsigned long long address;       // where the Xex starts in fp
+    unsigned long size, codeoffset;
+    unsigned char *window;            // holds the Xex from windowstart up to windowend...
+    unsigned long windowsize;         // ...which can't be more than this (plus XEX_WINDOWSLACK)
+    unsigned long windowstart, windowend;
+    unsigned long readyend;           // everything before this has been decrypted (or is never going to be)
+    bool encrypted;
+    unsigned char sessionkey[16], ivec[16];
+    unsigned long crc;                // of the Xex up to windowend
+    FILE *defaultdec;                 // debug copy of the decrypted code
+    bool failed;
+};
+void openxexstream(struct xexstream *xs, FILE *fp, unsigned long long defaultxexaddress, unsigned long defaultxexsize,
+                   unsigned long codeoffset, unsigned long windowsize, const unsigned char *sessionkey, char *filename, char *action);
+unsigned char *getxexstream(struct xexstream *xs, unsigned long offset, unsigned long len);
+void closexexstream(struct xexstream *xs);
+int gatherxexblock(struct memspack_buffer *lzxcompressed);
+THREADLOCAL size_t dontcare;
 bool valid_ssv2_exists_in_db();
 struct angledev {unsigned int angle; int dev;};
 int getangledeviation(int angle, int target);
 
-// global vars that might need to be reset after every fileloop
-bool writefile = true;
-bool checkgamecrcalways = false, checkgamecrcnever = false, gamecrcfailed = false, verifyfailed = false;
-bool stealthfailed = false, stealthuncertain = false, xbox1iso = false;
-bool ss_stealthfailed = false, dmi_stealthfailed = false, pfi_stealthfailed = false, video_stealthfailed = false;
-bool dmi_stealthuncertain = false, ss_stealthuncertain = false, pfi_stealthuncertain = false, video_stealthuncertain = false;
-bool xex_foundmediaid = false, xex_founddiscprofileid = false, foundtitleid = false, foundregioncode = false, foundgamename = false;
-bool ss_foundtimestamp = false, usercancelledgamecrc = false;
-bool pfi_alreadydumped = false, pfi_foundsectorstotal = false, pfiexception = false;
-bool wtfhex = false, checkssbin = false;
-bool justastealthfile = false, isotoosmall = false;
-bool drtfucked = false, fixedss = false, fixedtopology = false; //fixedap25 = false;
-bool printstderr = false, rebuildfailed = false, curlheaderprinted = false;
-int unrecognizedRTcount = 0;
-//int videowave = 0, pfiwave = 0, truepfiwave = 0;
-unsigned long long video = 0, ss_authored = 0;
-unsigned long game_crc32 = 0, xex_crc32 = 0, ss_crc32 = 0, ss_rawcrc32 = 0, ss_staticcrc32 = 0, dmi_crc32 = 0, pfi_crc32 = 0;
-unsigned int ss_num_angles, ss_num_targets, ss_angleaddresses[4], ss_targets[4];
-unsigned long video_crc32 = 0, videoL0_crc32 = 0, videoL1_crc32 = 0;
-//uchar xex_sha1[20] = {0};
-uchar pfi_sha1[20] = {0};
-//video_sha1[20] = {0};
-int ini_dmi_count = 0;
-unsigned long ini_ss = 0, ini_pfi = 0, ini_video = 0, ini_rawss = 0, ini_v0 = 0, ini_v1 = 0, ini_game = 0, ini_xexhash = 0;
-unsigned long ini_dmi[30] = {0};
-int corruptionoffsetcount = 0;
-FILE *fp = NULL, *csvfile = NULL, *inifile = NULL, *xexinifile = NULL;
-int buffermaxdir = MIN_DIR_SECTORS;
-int bufferlevels = MIN_DIR_LEVELS;
-char *fsbuffer;
-char dirprefix[2048] = {0};
-unsigned long long totalbytes = 0;
-unsigned long totalfiles = 0, totaldirectories = 0;
-long long L0capacity = -1;
-int level = 0;
-bool parsingfsfailed = false;
-bool extractimages = false, embedimages = false, noxexiniavailable = false, offlinewarningprinted = false;
-bool ssv2 = false, iso_has_ssv2 = false;
-bool verify_found_bad_pfi_or_video = false;
-bool game_has_ap25 = false, xgd3 = false, topology_was_verified = false;
+bool printstderr = false;
 bool drive_speed_needs_to_be_reset = false;
-unsigned int ss_replay_table_offset = 0, ss_replay_table_length = 0;
-long layerbreak = -1;
 
-bool do_blank_ss = false;
-bool g_ssv2 = false; // set in checkss()
+// everything that belongs to the image being checked (most of it is reset after every fileloop), kept together
+// so it's clear what resetvars() has to reset and what a check leaves behind for the next one. there's only ever
+// one check running in a process (--jobs checks several files at once in separate processes) and check points
+// at it, the options, the abgx360.dat tables and the indexes are still ordinary globals
+struct checkcontext {
+    FILE *fp, *csvfile, *inifile, *xexinifile;
+    char *isofilename;
+    long long fpfilesize;
+    bool writefile;
+    // scratch buffers
+    char buffer[2048], buffer2[2048];
+    unsigned char ubuffer[2048], ss[2048], fixed_ss[2048];
+    unsigned char bigbuffer[BIGBUF_SIZE];
+    sha1_context ctx;
+    // verdicts
+    bool checkgamecrcalways, checkgamecrcnever, gamecrcfailed, verifyfailed;
+    bool stealthfailed, stealthuncertain, xbox1iso;
+    bool ss_stealthfailed, dmi_stealthfailed, pfi_stealthfailed, video_stealthfailed;
+    bool dmi_stealthuncertain, ss_stealthuncertain, pfi_stealthuncertain, video_stealthuncertain;
+    bool xex_foundmediaid, xex_founddiscprofileid, foundtitleid, foundregioncode, foundgamename;
+    bool ss_foundtimestamp, usercancelledgamecrc;
+    bool pfi_alreadydumped, pfi_foundsectorstotal, pfiexception;
+    bool wtfhex, checkssbin;
+    bool justastealthfile, isotoosmall;
+    bool drtfucked, fixedss, fixedtopology; //fixedap25;
+    bool rebuildfailed, curlheaderprinted;
+    bool parsingfsfailed;
+    bool extractimages, embedimages, noxexiniavailable, offlinewarningprinted;
+    bool ssv2, iso_has_ssv2;
+    bool verify_found_bad_pfi_or_video;
+    bool game_has_ap25, xgd3, topology_was_verified;
+    bool do_blank_ss;
+    bool g_ssv2;  // set in checkss()
+    int unrecognizedRTcount;
+    char unrecognizedRTarray[21];
+    //int videowave, pfiwave, truepfiwave;
+    // what was found on the image
+    char inifilename[24], xexinifilename[17], gamename[151];
+    unsigned char dmi_mediaid[16], ss_mediaid[16], xex_mediaid[16], xex_discprofileid[16], titleid[4], regioncode[4];
+    unsigned long pfi_sectorstotal, pfi_sectorsL0, pfi_sectorsL1;
+    unsigned long long pfi_offsetL1, pfi_offsetL0end;
+    unsigned char topology[TOPOLOGY_SIZE];
+    unsigned long long video, ss_authored;
+    unsigned long game_crc32, xex_crc32, ss_crc32, ss_rawcrc32, ss_staticcrc32, dmi_crc32, pfi_crc32, fix_ss_crc32;
+    unsigned int ss_num_angles, ss_num_targets, ss_angleaddresses[4], ss_targets[4];
+    unsigned long video_crc32, videoL0_crc32, videoL1_crc32;
+    //uchar xex_sha1[20];
+    uchar pfi_sha1[20];
+    //uchar video_sha1[20];
+    unsigned int ss_replay_table_offset, ss_replay_table_length;
+    long layerbreak;
+    long long L0capacity;
+    // what the verified ini says it should be
+    int ini_dmi_count;
+    unsigned long ini_ss, ini_pfi, ini_video, ini_rawss, ini_v0, ini_v1, ini_game, ini_xexhash;
+    unsigned long ini_dmi[30];
+    // read/write errors and progress
+    unsigned long readerrorstotal, readerrorsrecovered, writeerrorstotal, writeerrorsrecovered;
+    int readerrorcharsprinted;
+    unsigned long sizeoverbuffer, bufferremainder;
+    int corruptionoffsetcount;
+    unsigned long long corruptionoffset[100];
+    struct onepassresults onepassresults;
+    // filesystem parsing
+    struct filesys *filesystem, *holes;
+    int buffermaxdir;
+    int bufferlevels;
+    char *fsbuffer;
+    char dirprefix[2048];
+    unsigned long long totalbytes;
+    unsigned long totalfiles, totaldirectories;
+    int level;
+    #ifndef WIN32
+        // what the result cache knows about this image (see loadresultcache)
+        struct resultcache_entry cache;
+        char cachefilename[2048];
+        bool cacheloaded, cacheenabled, cachehit, cachedirty;
+        time_t cachetime;
+        // chunk CRCs of the video layers and game partition for --manifest
+        struct chunkmanifest manifest;
+        // how the long scans of this image read it (--queuedepth, --iouring, and --odirect if it's a block device)
+        struct readahead_settings readsettings;
+        // the ini (and xex ini) came from the ini index instead of being opened, inifile (xexinifile) is NULL
+        bool iniindexed, xexiniindexed;
+        struct iniindex_entry inientry, xexinientry;
+        // what prefetchstealthfiles() already asked the server for, openstealthfile() uses these results instead of
+        // asking again (prefetchjob is the one startprefetch() left running in prefetchthread)
+        struct prefetch_file *prefetched;
+        int numprefetched;
+        bool prefetchdone;
+        struct prefetchjob *prefetchjob;
+        pthread_t prefetchthread;
+    #endif
+};
+THREADLOCAL struct checkcontext *check = NULL;
 
 bool should_nuke_dmi() {
-	return xgd3
+	return check->xgd3
 		? false
-		: g_ssv2
+		: check->g_ssv2
 			? false
-			: do_blank_ss
+			: check->do_blank_ss
 	;
 }
 
 // reset these global vars after every fileloop and parse cmd line again
 void resetvars() {
     int i;
-    writefile = true;
-    checkgamecrcalways = false; checkgamecrcnever = false; gamecrcfailed = false; verifyfailed = false;
-    stealthfailed = false; stealthuncertain = false; xbox1iso = false;
-    ss_stealthfailed = false; dmi_stealthfailed = false; pfi_stealthfailed = false; video_stealthfailed = false;
-    dmi_stealthuncertain = false; ss_stealthuncertain = false; pfi_stealthuncertain = false; video_stealthuncertain = false;
-    xex_foundmediaid = false; xex_founddiscprofileid = false; foundtitleid = false; foundregioncode = false; foundgamename = false;
-    ss_foundtimestamp = false; usercancelledgamecrc = false;
-    pfi_alreadydumped = false; pfi_foundsectorstotal = false; pfiexception = false;
-    wtfhex = false; checkssbin = false;
-    justastealthfile = false; isotoosmall = false;
-    drtfucked = false; fixedss = false; fixedtopology = false; //fixedap25 = false;
-    printstderr = false; rebuildfailed = false; curlheaderprinted = false;
-    unrecognizedRTcount = 0;
+    check->writefile = true;
+    check->checkgamecrcalways = false; check->checkgamecrcnever = false; check->gamecrcfailed = false; check->verifyfailed = false;
+    check->stealthfailed = false; check->stealthuncertain = false; check->xbox1iso = false;
+    check->ss_stealthfailed = false; check->dmi_stealthfailed = false; check->pfi_stealthfailed = false; check->video_stealthfailed = false;
+    check->dmi_stealthuncertain = false; check->ss_stealthuncertain = false; check->pfi_stealthuncertain = false; check->video_stealthuncertain = false;
+    check->xex_foundmediaid = false; check->xex_founddiscprofileid = false; check->foundtitleid = false; check->foundregioncode = false; check->foundgamename = false;
+    check->ss_foundtimestamp = false; check->usercancelledgamecrc = false;
+    check->pfi_alreadydumped = false; check->pfi_foundsectorstotal = false; check->pfiexception = false;
+    check->wtfhex = false; check->checkssbin = false;
+    check->justastealthfile = false; check->isotoosmall = false;
+    check->drtfucked = false; check->fixedss = false; check->fixedtopology = false; //fixedap25 = false;
+    printstderr = false; check->rebuildfailed = false; check->curlheaderprinted = false;
+    check->unrecognizedRTcount = 0;
     //videowave = 0; pfiwave = 0; truepfiwave = 0;
-    video = 0; ss_authored = 0;
-    game_crc32 = 0; xex_crc32 = 0; ss_crc32 = 0; ss_rawcrc32 = 0; ss_staticcrc32 = 0; dmi_crc32 = 0; pfi_crc32 = 0;
-    ss_num_angles = 0; ss_num_targets = 0;
-    for(i=0;i<4;i++) { ss_angleaddresses[i] = 0; ss_targets[i] = 0; }
-    video_crc32 = 0; videoL0_crc32 = 0; videoL1_crc32 = 0;
+    check->video = 0; check->ss_authored = 0;
+    check->game_crc32 = 0; check->xex_crc32 = 0; check->ss_crc32 = 0; check->ss_rawcrc32 = 0; check->ss_staticcrc32 = 0; check->dmi_crc32 = 0; check->pfi_crc32 = 0;
+    check->ss_num_angles = 0; check->ss_num_targets = 0;
+    for(i=0;i<4;i++) { check->ss_angleaddresses[i] = 0; check->ss_targets[i] = 0; }
+    check->video_crc32 = 0; check->videoL0_crc32 = 0; check->videoL1_crc32 = 0;
     //memset(xex_sha1, 0, 20);
-    memset(pfi_sha1, 0, 20);
+    memset(check->pfi_sha1, 0, 20);
     //memset(video_sha1, 0, 20);
-    ini_dmi_count = 0;
-    ini_ss = 0; ini_pfi = 0; ini_video = 0; ini_rawss = 0; ini_v0 = 0; ini_v1 = 0; ini_game = 0; ini_xexhash = 0;
-    for(i=0;i<30;i++) ini_dmi[i] = 0L;
-    corruptionoffsetcount = 0;
-    fp = NULL; csvfile = NULL; inifile = NULL; xexinifile = NULL;
-    buffermaxdir = MIN_DIR_SECTORS;
-    bufferlevels = MIN_DIR_LEVELS;
-    memset(dirprefix, 0, 2048);
-    totalbytes = 0;
-    totalfiles = 0; totaldirectories = 0;
-    L0capacity = -1;
-    level = 0;
-    parsingfsfailed = false;
-    extractimages = false; embedimages = false; noxexiniavailable = false; offlinewarningprinted = false;
-    ssv2 = false; iso_has_ssv2 = false;
-    verify_found_bad_pfi_or_video = false;
-    game_has_ap25 = false; xgd3 = false; topology_was_verified = false;
-    do_blank_ss = false;
+    check->ini_dmi_count = 0;
+    check->ini_ss = 0; check->ini_pfi = 0; check->ini_video = 0; check->ini_rawss = 0; check->ini_v0 = 0; check->ini_v1 = 0; check->ini_game = 0; check->ini_xexhash = 0;
+    for(i=0;i<30;i++) check->ini_dmi[i] = 0L;
+    check->corruptionoffsetcount = 0;
+    memset(&check->onepassresults, 0, sizeof(struct onepassresults));
+    check->fp = NULL; check->csvfile = NULL; check->inifile = NULL; check->xexinifile = NULL;
+    check->buffermaxdir = MIN_DIR_SECTORS;
+    check->bufferlevels = MIN_DIR_LEVELS;
+    memset(check->dirprefix, 0, 2048);
+    check->totalbytes = 0;
+    check->totalfiles = 0; check->totaldirectories = 0;
+    check->L0capacity = -1;
+    check->level = 0;
+    check->parsingfsfailed = false;
+    check->extractimages = false; check->embedimages = false; check->noxexiniavailable = false; check->offlinewarningprinted = false;
+    check->ssv2 = false; check->iso_has_ssv2 = false;
+    check->verify_found_bad_pfi_or_video = false;
+    check->game_has_ap25 = false; check->xgd3 = false; check->topology_was_verified = false;
+    check->do_blank_ss = false;
     drive_speed_needs_to_be_reset = false;
-    ss_replay_table_offset = 0; ss_replay_table_length = 0;
-    layerbreak = -1;
+    check->ss_replay_table_offset = 0; check->ss_replay_table_length = 0;
+    check->layerbreak = -1;
+    #ifndef WIN32
+        check->cacheloaded = false; check->cacheenabled = false; check->cachehit = false; check->cachedirty = false;
+        chunkmanifest_free(&check->manifest);
+        chunkmanifest_init(&check->manifest, 0, 0);
+        check->iniindexed = false; check->xexiniindexed = false;
+        check->readsettings.queuedepth = queuedepth; check->readsettings.iouring = iouring; check->readsettings.direct = false;
+        waitforprefetch();
+        free(check->prefetched);
+        check->prefetched = NULL; check->numprefetched = 0; check->prefetchdone = false;
+    #endif
   return;
 }
 
+struct checkcontext *newcontext() {
+    struct checkcontext *context, *previous;
+    context = (struct checkcontext *) calloc(1, sizeof(struct checkcontext));
+    if (context == NULL) return NULL;
+    // start out the same way every fileloop does
+    previous = check;
+    check = context;
+    resetvars();
+    check = previous;
+  return context;
+}
+
 #ifndef WIN32
 
 // create unix versions of kbhit() and getch()
@@ -608,12 +804,23 @@ int getch() {
 
 #endif // #ifndef WIN32
 
+FILE *openforwriting(const char *filename) {
+    // fopen(filename, "wb") for a file that might be a stealth file: one that's in the stealth file store shares its
+    // inode with a verified object, so it has to be replaced rather than truncated and written over (any other file
+    // with more than one link would have its other names written over too)
+    #ifndef WIN32
+        struct stat st;
+        if (lstat(filename, &st) == 0 && S_ISREG(st.st_mode) && st.st_nlink > 1) remove(filename);
+    #endif
+  return fopen(filename, "wb");
+}
+
 size_t my_curl_write(void *buffer, size_t size, size_t nmemb, void *data) {
     if (size == 0 || nmemb == 0) return 0;
     struct MyCurlFile *out = (struct MyCurlFile *) data;
     if (out && !out->stream) {
         // open file for writing
-        out->stream = fopen(out->filename, "wb");
+        out->stream = openforwriting(out->filename);
         if (out->stream == NULL) {
             if (debug) {
                 color(red);
@@ -642,15 +849,15 @@ unsigned long converttosectors(unsigned long size) {
 int readblock(char* filename, char* action, FILE *fp, long long LBA, unsigned char* data, unsigned short num) {
     if (debugfs) {
         color(green);
-        printf("reading sector: %"LL"d (0x%"LL"X) num=%u%s", LBA, LBA*2048+video, num, newline);
+        printf("reading sector: %"LL"d (0x%"LL"X) num=%u%s", LBA, LBA*2048+check->video, num, newline);
         color(blue);
     }
-    if (fseeko(fp, LBA*2048+video, SEEK_SET) != 0) {
+    if (fseeko(fp, LBA*2048+check->video, SEEK_SET) != 0) {
         printseekerror(filename, action);
       return 1;
     }
     initcheckread();
-    if (checkreadandprinterrors(data, 1, num*2048, fp, 0, LBA*2048+video, filename, action) != 0) return 1;
+    if (checkreadandprinterrors(data, 1, num*2048, fp, 0, LBA*2048+check->video, filename, action) != 0) return 1;
     donecheckread(filename);
   return 0;
 }
@@ -676,10 +883,10 @@ unsigned short getwordmsb(unsigned char* ptr) {
 }
 
 void printentry(long long entry, long long offset, char* dirprefix, bool justcount, bool emptydir) {
-    unsigned long size = getint(fsbuffer+entry+offset+8);
-    totalbytes += (unsigned long long) size;
+    unsigned long size = getint(check->fsbuffer+entry+offset+8);
+    check->totalbytes += (unsigned long long) size;
     if ((!justcount && showfiles) || debugfs) {
-        unsigned long sector = getint(fsbuffer+entry+offset+4);
+        unsigned long sector = getint(check->fsbuffer+entry+offset+4);
         printf("%s%07lu %s", sp5, sector, sp2);
         if (size < 10) printf("%s", sp9);
         else if (size < 100) printf("%s", sp8);
@@ -694,23 +901,23 @@ void printentry(long long entry, long long offset, char* dirprefix, bool justcou
     
         if (*dirprefix != 0) printf("%s", dirprefix);
         if (emptydir) printf("%s", newline);
-        else printf("%.*s%s", (int) fsbuffer[entry+offset+13], fsbuffer+entry+offset+14, newline);
+        else printf("%.*s%s", (int) check->fsbuffer[entry+offset+13], check->fsbuffer+entry+offset+14, newline);
     }
 }
 
 int parse(char *filename, char* action, long long entry, long long offset, int level, FILE* fp, bool justcount, bool storeit, char* dirprefix) {
 	int returncode;
-    unsigned long sector = getint(fsbuffer+entry+offset+4);
-    unsigned short left = getword(fsbuffer+entry+offset);
-    unsigned short right = getword(fsbuffer+entry+offset+2);
-    unsigned long size = getint(fsbuffer+entry+offset+8);
+    unsigned long sector = getint(check->fsbuffer+entry+offset+4);
+    unsigned short left = getword(check->fsbuffer+entry+offset);
+    unsigned short right = getword(check->fsbuffer+entry+offset+2);
+    unsigned long size = getint(check->fsbuffer+entry+offset+8);
     if (debugfs) {
         color(normal);
         printf("entry=0x%07"LL"X, offset=0x%07"LL"X, level=%02d, left=%04u, right=%04u, sector=%07lu (0x%09"LL"X), "
                "size=%010lu bytes, type=0x%02X, strlen=%02d, %.*s%s",
-               entry, offset, level, left, right, sector, (long long) sector*2048+video, size,
-               (unsigned char) fsbuffer[entry+offset+12], fsbuffer[entry+offset+13],
-               (int) fsbuffer[entry+offset+13], fsbuffer+entry+offset+14, newline);
+               entry, offset, level, left, right, sector, (long long) sector*2048+check->video, size,
+               (unsigned char) check->fsbuffer[entry+offset+12], check->fsbuffer[entry+offset+13],
+               (int) check->fsbuffer[entry+offset+13], check->fsbuffer+entry+offset+14, newline);
         color(blue);
     }
     if (sector == 0xFFFFFFFFL) {
@@ -723,9 +930,9 @@ int parse(char *filename, char* action, long long entry, long long offset, int l
       return 0;
     }
     if (left) {
-        if ((long) left * 4 > (long) buffermaxdir * 2048 - 20) {
+        if ((long) left * 4 > (long) check->buffermaxdir * 2048 - 20) {
             // entry is outside of the directory space
-            parsingfsfailed = true;
+            check->parsingfsfailed = true;
             if (verbose) printf("%s", sp5);
             color(yellow);
             printf("Unable to parse filesystem because it appears to be corrupt%s",newline);
@@ -740,56 +947,56 @@ int parse(char *filename, char* action, long long entry, long long offset, int l
         }
         returncode = parse(filename, action, entry, (long long) left * 4, level, fp, justcount, storeit, dirprefix);
         if (returncode) {
-            if (returncode != 2) parsingfsfailed = true;
+            if (returncode != 2) check->parsingfsfailed = true;
           return returncode;
         }
     }
 
-    if (((unsigned char) fsbuffer[entry+offset+12] & 0x10) == 0x10) {
+    if (((unsigned char) check->fsbuffer[entry+offset+12] & 0x10) == 0x10) {
         // directory
         if (storeit) {
-            filesystem[totalfiles + totaldirectories].datasector = sector;
-            filesystem[totalfiles + totaldirectories].datalength = converttosectors(size);
+            check->filesystem[check->totalfiles + check->totaldirectories].datasector = sector;
+            check->filesystem[check->totalfiles + check->totaldirectories].datalength = converttosectors(size);
         }
-        totaldirectories++;
+        check->totaldirectories++;
         level++;
-        if (debugfs) { color(yellow); printf("level = %02d, bufferlevels = %02d%s", level, bufferlevels, newline); color(normal); }
+        if (debugfs) { color(yellow); printf("level = %02d, bufferlevels = %02d%s", level, check->bufferlevels, newline); color(normal); }
         if (level == MAX_DIR_LEVELS) {
             if (debugfs) {
                 color(red);
                 printf("ERROR: a directory is %d levels deep! (parsing folder aborted)%s", level, newline);
                 color(blue);
             }
-            parsingfsfailed = true;
-            bufferlevels = MAX_DIR_LEVELS;
+            check->parsingfsfailed = true;
+            check->bufferlevels = MAX_DIR_LEVELS;
           return 2;
         }
-        if (level == bufferlevels) {
+        if (level == check->bufferlevels) {
             if (debugfs) {
                 color(cyan);
                 printf("reallocating fsbuffer from %ld to %ld: level = %d, bufferlevels = %d, MIN_DIR_LEVELS = %d, "
                        "buffermaxdir = %d, sizeof(char) = %d%s",
-                        (long) bufferlevels * buffermaxdir * 2048 * sizeof(char),
-                        (long) (bufferlevels + MIN_DIR_LEVELS) * buffermaxdir * 2048 * sizeof(char),
-                        level, bufferlevels, MIN_DIR_LEVELS, buffermaxdir, (int) sizeof(char), newline);
+                        (long) check->bufferlevels * check->buffermaxdir * 2048 * sizeof(char),
+                        (long) (check->bufferlevels + MIN_DIR_LEVELS) * check->buffermaxdir * 2048 * sizeof(char),
+                        level, check->bufferlevels, MIN_DIR_LEVELS, check->buffermaxdir, (int) sizeof(char), newline);
             }
-            bufferlevels += MIN_DIR_LEVELS;
-            if (debugfs) printf("bufferlevels = %d%s", bufferlevels, newline);
-            char *newfsbuffer = (char *) realloc(fsbuffer, (size_t) bufferlevels * buffermaxdir * 2048 * sizeof(char));
+            check->bufferlevels += MIN_DIR_LEVELS;
+            if (debugfs) printf("bufferlevels = %d%s", check->bufferlevels, newline);
+            char *newfsbuffer = (char *) realloc(check->fsbuffer, (size_t) check->bufferlevels * check->buffermaxdir * 2048 * sizeof(char));
             if (newfsbuffer == NULL) {
                 color(red);
                 printf("ERROR: memory allocation for fsbuffer failed! Game over man... Game over!%s", newline);
                 color(normal);
               exit(1);
             }
-            fsbuffer = newfsbuffer;
+            check->fsbuffer = newfsbuffer;
             if (debugfs) { printf("reallocation successful%s", newline); color(blue); }
         }
         if (debugfs) { color(normal); printf("directory: "); }
-        unsigned long tocsector = getint(fsbuffer+entry+offset+4);
+        unsigned long tocsector = getint(check->fsbuffer+entry+offset+4);
         if (debugfs) printf("tocsector = %lu, ", tocsector);
         char dirname[2048];
-        int dirnamesize = (int) fsbuffer[entry+offset+13];
+        int dirnamesize = (int) check->fsbuffer[entry+offset+13];
         if (debugfs) { printf("dirnamesize = %d%s", dirnamesize, newline); color(blue); }
         if (dirnamesize + strlen(dirprefix) > 2046) {  // need space for "/" and terminating null
             if (verbose) printf("%s", sp5);
@@ -800,13 +1007,13 @@ int parse(char *filename, char* action, long long entry, long long offset, int l
                 color(red);
                 printf("strlen(dirprefix) = %d, dirprefix: %s%sdirnamesize = %d, dirname (max 20KB): %.*s%s",
                         (int) strlen(dirprefix), dirprefix, newline,
-                        dirnamesize, dirnamesize < 20480 ? dirnamesize : 20480, fsbuffer+entry+offset+14, newline);
+                        dirnamesize, dirnamesize < 20480 ? dirnamesize : 20480, check->fsbuffer+entry+offset+14, newline);
                 color(blue);
             }
-            parsingfsfailed = true;
+            check->parsingfsfailed = true;
           return 1;
         }
-        strncpy(dirname, fsbuffer+entry+offset+14, dirnamesize);
+        strncpy(dirname, check->fsbuffer+entry+offset+14, dirnamesize);
         dirname[dirnamesize] = 0;  // terminating null
         
         char newdirprefix[2048];
@@ -817,24 +1024,24 @@ int parse(char *filename, char* action, long long entry, long long offset, int l
         if (debugfs) { color(normal); printf("dirprefix: %s, newdirprefix: %s%s", dirprefix, newdirprefix, newline); color(blue); }
         
         if (size) {  // don't parse empty directories!
-            if (size > (unsigned long) buffermaxdir*2048) {
+            if (size > (unsigned long) check->buffermaxdir*2048) {
                 if (debugfs) {
                     color(yellow);
                     printf("ERROR: %s is %lu sectors long! (parsing folder aborted)%s", newdirprefix, converttosectors(size), newline);
                     color(blue);
                 }
-                buffermaxdir = converttosectors(size);
+                check->buffermaxdir = converttosectors(size);
               return 2;
             }
-            memset(fsbuffer+level*buffermaxdir*2048, 0, buffermaxdir*2048);
+            memset(check->fsbuffer+level*check->buffermaxdir*2048, 0, check->buffermaxdir*2048);
             if (debugfs) {
                 color(darkgray);
                 printf("about to readblock: tocsector=%06lu, size=%06lu, converttosectors(size)=%06lu%s",
                         tocsector, size, converttosectors(size), newline);
                 color(blue);
             }
-            if (readblock(filename, action, fp, tocsector, (unsigned char*) (fsbuffer+level*buffermaxdir*2048), converttosectors(size))) {
-                parsingfsfailed = true;
+            if (readblock(filename, action, fp, tocsector, (unsigned char*) (check->fsbuffer+level*check->buffermaxdir*2048), converttosectors(size))) {
+                check->parsingfsfailed = true;
               return 1;
             }
             if (debugfs) {
@@ -842,9 +1049,9 @@ int parse(char *filename, char* action, long long entry, long long offset, int l
                 printf("about to parse directory: %s, level=%02d%s", newdirprefix, level, newline);
                 color(blue);
             }
-            returncode = parse(filename, action, (long long) level*buffermaxdir*2048, 0, level, fp, justcount, storeit, newdirprefix);
+            returncode = parse(filename, action, (long long) level*check->buffermaxdir*2048, 0, level, fp, justcount, storeit, newdirprefix);
             if (returncode) {
-                if (returncode != 2) parsingfsfailed = true;
+                if (returncode != 2) check->parsingfsfailed = true;
               return returncode;
             }
         }
@@ -852,16 +1059,16 @@ int parse(char *filename, char* action, long long entry, long long offset, int l
     }
     else {
         if (storeit) {
-            filesystem[totalfiles + totaldirectories].datasector = sector;
-            filesystem[totalfiles + totaldirectories].datalength = converttosectors(size);
+            check->filesystem[check->totalfiles + check->totaldirectories].datasector = sector;
+            check->filesystem[check->totalfiles + check->totaldirectories].datalength = converttosectors(size);
         }
-        totalfiles++;
+        check->totalfiles++;
         printentry(entry, offset, dirprefix, justcount, false);
     }
     if (right) {
-        if ((long) right * 4 > (long) buffermaxdir * 2048 - 20) {
+        if ((long) right * 4 > (long) check->buffermaxdir * 2048 - 20) {
             // entry is outside of the directory space
-            parsingfsfailed = true;
+            check->parsingfsfailed = true;
             if (verbose) printf("%s", sp5);
             color(yellow);
             printf("Unable to parse filesystem because it appears to be corrupt%s",newline);
@@ -876,7 +1083,7 @@ int parse(char *filename, char* action, long long entry, long long offset, int l
         }
         returncode = parse(filename, action, entry, (long long) right * 4, level, fp, justcount, storeit, dirprefix);
         if (returncode) {
-            if (returncode != 2) parsingfsfailed = true;
+            if (returncode != 2) check->parsingfsfailed = true;
           return returncode;
         }
     }
@@ -884,9 +1091,24 @@ int parse(char *filename, char* action, long long entry, long long offset, int l
 }
 
 void doexitfunction() {
+    if (check == NULL) return;
+    #ifndef WIN32
+        if (batchchild) {
+            // the parent prints the report, nothing to pause for or reset
+            if (check->fp != NULL) fclose(check->fp);
+            if (curl != NULL) curl_easy_cleanup(curl);
+            waitforprefetch();
+            prefetch_cleanup(&prefetcher);
+          return;
+        }
+    #endif
     if (html) printhtmlbottom();
-    if (fp != NULL) fclose(fp);
+    if (check->fp != NULL) fclose(check->fp);
     if (curl != NULL) curl_easy_cleanup(curl);
+    #ifndef WIN32
+        waitforprefetch();
+        prefetch_cleanup(&prefetcher);
+    #endif
     if (!html && pauseshell) {
         printstderr = true;
         color(normal);
@@ -948,9 +1170,9 @@ void printcurlinfo(CURL *curl, char *filename) {
 
 int curlprogress(char *curlprogressdata, double dltotal, double dlnow, double ultotal, double ulnow) {
     if ((dltotal && dlnow) || (ultotal && ulnow)) {
-        if(!curlheaderprinted) {
+        if(!check->curlheaderprinted) {
             fprintf(stderr, "%s\n", curlprogressdata);
-            curlheaderprinted = true;
+            check->curlheaderprinted = true;
             curlprogressstartmsecs = getmsecs();
         }
         int chars = 0;
@@ -1207,7 +1429,7 @@ void docheckdirectories() {
             }
         }
     }
-    if (extractimages) {
+    if (check->extractimages) {
         // check for homedir/abgxdir/imagedir
         memset(dirbuffer, 0, 2048);
         strcat(dirbuffer, homedir);
@@ -1222,7 +1444,7 @@ void docheckdirectories() {
                 printf("ERROR: Failed to create the apparently missing Images directory '%s' (%s) "
                        "Extracting images will be disabled%s",
                         dirbuffer, strerror(errno), newline);
-                extractimages = false;
+                check->extractimages = false;
                 imagedirmissing = true;
               return;
             }
@@ -1252,6 +1474,25 @@ void docheckdirectories() {
             }
         }
     }
+    #ifndef WIN32
+        if (resultcache) {
+            // check for homedir/abgxdir/resultcachedir
+            memset(dirbuffer, 0, 2048);
+            strcat(dirbuffer, homedir);
+            strcat(dirbuffer, abgxdir);
+            strcat(dirbuffer, resultcachedir);
+            if (dirbuffer[strlen(dirbuffer) - 1] == '/') dirbuffer[strlen(dirbuffer) - 1] = 0x0;
+            if (stat(dirbuffer, &buf) == -1) {
+                if (debug) printf("stat failed for '%s' (%s)%s", dirbuffer, strerror(errno), newline);
+                if (mkdir(dirbuffer, 0777) == -1) {
+                    printf("ERROR: Failed to create the apparently missing ResultCache directory '%s' (%s) "
+                           "Results will not be cached%s",
+                            dirbuffer, strerror(errno), newline);
+                    resultcache = false;
+                }
+            }
+        }
+    #endif
     if (debug) printf("all necessary directories were created or already existed%s", newline);
   return;
 }
@@ -2724,31 +2965,31 @@ int opendeviceandgetname(char *drive, bool requestexclusiveaccess, bool errorsar
     }
     
     if (strlen(devicenamebuffer)) {
-        isofilename = calloc(4 + strlen(devicenamebuffer) + strlen(drive) + 1, sizeof(char));
-        if (isofilename == NULL) {
+        check->isofilename = calloc(4 + strlen(devicenamebuffer) + strlen(drive) + 1, sizeof(char));
+        if (check->isofilename == NULL) {
             color(red);
             printf("ERROR: Memory allocation for device name failed! Game over man... Game over!%s", newline);
             color(normal);
           exit(1);
         }
         #ifdef WIN32
-            sprintf(isofilename, "%s (%s:)", devicenamebuffer, drive);
+            sprintf(check->isofilename, "%s (%s:)", devicenamebuffer, drive);
         #else
-            sprintf(isofilename, "%s (%s)", devicenamebuffer, drive);
+            sprintf(check->isofilename, "%s (%s)", devicenamebuffer, drive);
         #endif
     }
     else {
-        isofilename = calloc(7 + strlen(drive) + 1, sizeof(char));
-        if (isofilename == NULL) {
+        check->isofilename = calloc(7 + strlen(drive) + 1, sizeof(char));
+        if (check->isofilename == NULL) {
             color(red);
             printf("ERROR: Memory allocation for device name failed! Game over man... Game over!%s", newline);
             color(normal);
           exit(1);
         }
         #ifdef WIN32
-            sprintf(isofilename, "Drive %s:", drive);
+            sprintf(check->isofilename, "Drive %s:", drive);
         #else
-            sprintf(isofilename, "%s", drive);
+            sprintf(check->isofilename, "%s", drive);
         #endif
     }
   return 0;
@@ -2781,7 +3022,7 @@ void setdvdspeed(float speed, bool resetting) {
     float currentspeed = -1.0;
     long lspeed = (long) roundf(speed);
     
-    if (isanxbox360rippingdrive(isofilename, false)) {
+    if (isanxbox360rippingdrive(check->isofilename, false)) {
         // mode sense to get current drive speed
         // speed sense may be unreliable depending on fw version without doing speed select first
         memset(cdb, 0, 12);
@@ -2799,9 +3040,9 @@ void setdvdspeed(float speed, bool resetting) {
             if      (speedbuffer[10] == 0x01) currentspeed = 2.0;
             else if (speedbuffer[10] == 0x02) currentspeed = 5.0;
             else if (speedbuffer[10] == 0x03) {
-                if (memcmp(isofilename, "PLDS DG-16D2S ", 14) == 0 ||
-                    memcmp(isofilename, "PBDS VAD6038-", 13) == 0 ||
-                    memcmp(isofilename, "SATA DVD-ROM 6243", 17) == 0) {
+                if (memcmp(check->isofilename, "PLDS DG-16D2S ", 14) == 0 ||
+                    memcmp(check->isofilename, "PBDS VAD6038-", 13) == 0 ||
+                    memcmp(check->isofilename, "SATA DVD-ROM 6243", 17) == 0) {
                     // liteon and benq have been observed to report an incorrect initial default speed of 8x when they were actually running at 5x
                     // (iXtreme v1.60 and iXtreme v3.0)
                     currentspeed = -1.0; // the actual speed could be 5x or 8x (if 8x was set manually), so leave currentspeed alone (-1 = unknown speed)
@@ -2827,7 +3068,7 @@ void setdvdspeed(float speed, bool resetting) {
         if (roundf(speed) != currentspeed) {
             if (resetting) fprintf(stderr, "\n");
             fprintf(stderr, "Setting drive speed to %lux... ", lspeed);
-            if (memcmp(isofilename, "TSSTcorp DVD-ROM TS-H943A ", 26) == 0) {
+            if (memcmp(check->isofilename, "TSSTcorp DVD-ROM TS-H943A ", 26) == 0) {
                 // use kreon cdb style for sammy (benq/liteon way gives error LOGICAL UNIT IS IN PROCESS OF BECOMING READY)
                 memset(cdb, 0, 12);
                 cdb[0] = 0xFF;
@@ -2882,11 +3123,11 @@ void setdvdspeed(float speed, bool resetting) {
             if (!resetting) fprintf(stderr, "\n");
         }
     }
-    else if ( (memcmp(isofilename, "TSSTcorp DVD-ROM SH-D162C ", 26) == 0 ||
-               memcmp(isofilename, "TSSTcorp DVD-ROM SH-D162D ", 26) == 0 ||
-               memcmp(isofilename, "TSSTcorp DVD-ROM SH-D163A ", 26) == 0 ||
-               memcmp(isofilename, "TSSTcorp DVD-ROM SH-D163B ", 26) == 0    ) &&
-               strstr(isofilename, "KREON ") != NULL) {
+    else if ( (memcmp(check->isofilename, "TSSTcorp DVD-ROM SH-D162C ", 26) == 0 ||
+               memcmp(check->isofilename, "TSSTcorp DVD-ROM SH-D162D ", 26) == 0 ||
+               memcmp(check->isofilename, "TSSTcorp DVD-ROM SH-D163A ", 26) == 0 ||
+               memcmp(check->isofilename, "TSSTcorp DVD-ROM SH-D163B ", 26) == 0    ) &&
+               strstr(check->isofilename, "KREON ") != NULL) {
         // todo: figure out if mode sense or similar is supported by kreons to get current drive speed
         
         if (lspeed <= 0) lspeed = 8;  // apparent default for SH-D163B
@@ -2926,7 +3167,7 @@ void setdvdspeed(float speed, bool resetting) {
             speedbuffer[0] = 4;
         }
         // End LBA (Start LBA is already set to 0)
-        unsigned long endlba = (unsigned long) (fpfilesize / 2048 - 1);
+        unsigned long endlba = (unsigned long) (check->fpfilesize / 2048 - 1);
         if (debug || testingdvd) printf("End LBA for SET STREAMING: 0x%08lX%s", endlba, newline);
         speedbuffer[8]  = (unsigned char)  (endlba >> 24);
         speedbuffer[9]  = (unsigned char) ((endlba & 0x00FF0000L) >> 16);
@@ -3015,7 +3256,7 @@ void getL0capacity() {
     // read disc structure with format code 20h (layer boundary information)
     int i;
     bool L0capacityInitStatus = false;
-    L0capacity = 0;
+    check->L0capacity = 0;
     unsigned char capbuffer[20] = {0};
     
     if (skiplayerboundaryinfo) return;
@@ -3055,21 +3296,21 @@ void getL0capacity() {
     else {
         layerboundaryrecovered:
         // get L0 data area capacity
-        L0capacity = (long long) getuintmsb(capbuffer+8);
+        check->L0capacity = (long long) getuintmsb(capbuffer+8);
         // check Init Status bit
         if (capbuffer[4] & 0x80) L0capacityInitStatus = true;
         if (debug || testingdvd) {
             printf("layer boundary info (L0capacity = %"LL"d, Init Status = %X):%s",
-                    L0capacity, L0capacityInitStatus, newline);
+                    check->L0capacity, L0capacityInitStatus, newline);
             hexdump(capbuffer, 0, 20);
         }
         // L0 data area capacity should be equal to the layerbreak calculated from the alternate pfi in the ss
-        if (L0capacity != (long long) layerbreak) {
-            if (L0capacityInitStatus && L0capacity == 2086912 && layerbreak == 2133520) color(yellow);
+        if (check->L0capacity != (long long) check->layerbreak) {
+            if (L0capacityInitStatus && check->L0capacity == 2086912 && check->layerbreak == 2133520) color(yellow);
             else color(red);
-            printf("Layerbreak for this DVD was reported as %"LL"d (should have been %ld)%s", L0capacity, layerbreak, newline);
+            printf("Layerbreak for this DVD was reported as %"LL"d (should have been %ld)%s", check->L0capacity, check->layerbreak, newline);
             if (L0capacityInitStatus) {
-                if (L0capacity == 2086912 && layerbreak == 2133520) {
+                if (check->L0capacity == 2086912 && check->layerbreak == 2133520) {
                     printf("Note: This might still be bootable on LT+ v2.0 or later firmware%s%s", newline, newline);
                 }
                 else {
@@ -3244,8 +3485,8 @@ void parsecmdline(int argc, char *argv[]) {
                 if (strcasecmp(argv[i], "--csv") == 0) csvupdate = true;
                 if (strcasecmp(argv[i], "--stayoffline") == 0) stayoffline = true;
                 if (strcasecmp(argv[i], "--regioncheck") == 0) stealthcheck = false;
-                if (strcasecmp(argv[i], "--nogamecrc") == 0) checkgamecrcnever = true;
-                if (strcasecmp(argv[i], "--gamecrc") == 0) checkgamecrcalways = true;
+                if (strcasecmp(argv[i], "--nogamecrc") == 0) check->checkgamecrcnever = true;
+                if (strcasecmp(argv[i], "--gamecrc") == 0) check->checkgamecrcalways = true;
                 if (strcasecmp(argv[i], "--p-video") == 0 && (i+1 < argc)) { patchvideoarg = i + 1; manualpatch = true; }
                 if (strcasecmp(argv[i], "--p-pfi") == 0 && (i+1 < argc)) { patchpfiarg = i + 1; manualpatch = true; }
                 if (strcasecmp(argv[i], "--p-dmi") == 0 && (i+1 < argc)) { patchdmiarg = i + 1; manualpatch = true; }
@@ -3256,7 +3497,7 @@ void parsecmdline(int argc, char *argv[]) {
                 if (strcasecmp(argv[i], "--e-ss") == 0 && (i+1 < argc)) { extractssarg = i + 1; manualextract = true; }
                 if (strcasecmp(argv[i], "--patchgarbage") == 0) patchvalidfilesonly = false;
                 if (strcasecmp(argv[i], "--patchitanyway") == 0) patchifstealthpasses = true;
-                if (strcasecmp(argv[i], "--blank-ss") == 0) do_blank_ss = true;
+                if (strcasecmp(argv[i], "--blank-ss") == 0) check->do_blank_ss = true;
                 if (strcasecmp(argv[i], "--debug") == 0) { extraverbose = true; debug = true; }
                 if (strcasecmp(argv[i], "--debugfs") == 0) { extraverbose = true; debug = true; debugfs = true; }
                 if (strcasecmp(argv[i], "--rebuildlowspace") == 0) rebuildlowspace = true;
@@ -3278,7 +3519,7 @@ void parsecmdline(int argc, char *argv[]) {
                 if (strcasecmp(argv[i], "--nofixdrt") == 0) fixDRT = false;
                 if (strcasecmp(argv[i], "--testing") == 0) testing = true;
                 if (strcasecmp(argv[i], "--testingdvd") == 0) testingdvd = true;
-                if (strcasecmp(argv[i], "--nowrite") == 0) writefile = false;
+                if (strcasecmp(argv[i], "--nowrite") == 0) check->writefile = false;
                 if (strcasecmp(argv[i], "--user") == 0 && (i+1 < argc)) { autouploaduserarg = i + 1; }
                 if (strcasecmp(argv[i], "--pass") == 0 && (i+1 < argc)) { autouploadpassarg = i + 1; }
                 if (strcasecmp(argv[i], "--localonly") == 0) localonly = true;
@@ -3292,8 +3533,8 @@ void parsecmdline(int argc, char *argv[]) {
                 if (strcasecmp(argv[i], "--ach") == 0) showachievements = true;
                 if (strcasecmp(argv[i], "--achs") == 0) { showachievements = true; hidesecretachievements = true; }
                 if (strcasecmp(argv[i], "--aa") == 0) showavatarawards = true;
-                if (strcasecmp(argv[i], "--images") == 0) { if (!imagedirmissing) extractimages = true; }
-                if (strcasecmp(argv[i], "--embed") == 0) { if (!imagedirmissing) embedimages = true; }
+                if (strcasecmp(argv[i], "--images") == 0) { if (!imagedirmissing) check->extractimages = true; }
+                if (strcasecmp(argv[i], "--embed") == 0) { if (!imagedirmissing) check->embedimages = true; }
                 if (strcasecmp(argv[i], "--skiplb") == 0) skiplayerboundaryinfo = true;
                 if (strcasecmp(argv[i], "--devkey") == 0) devkey = true;
                 if (strcasecmp(argv[i], "--notrust") == 0) trustssv2angles = false;
@@ -3301,6 +3542,51 @@ void parsecmdline(int argc, char *argv[]) {
                 if (strcasecmp(argv[i], "--orig") == 0 && (i+1 < argc)) origarg = i + 1;
                 #ifdef WIN32
                     if (strcasecmp(argv[i], "--dvd") == 0 && (i+1 < argc)) dvdarg = i + 1;
+                #else
+                    if (strcasecmp(argv[i], "--crcthreads") == 0 && (i+1 < argc)) {
+                        crcthreads = (int) strtol(argv[i+1], NULL, 10);
+                        if (crcthreads < 0) crcthreads = 1;
+                        if (crcthreads == 0) {
+                            // use one thread per cpu
+                            crcthreads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+                            if (crcthreads < 1) crcthreads = 1;
+                        }
+                        if (crcthreads > SHARDCRC_MAXSHARDS) crcthreads = SHARDCRC_MAXSHARDS;
+                        crcthreadsarg = i + 1;
+                    }
+                    if (strcasecmp(argv[i], "--onepass") == 0) onepass = true;
+                    if (strcasecmp(argv[i], "--queuedepth") == 0 && (i+1 < argc)) {
+                        queuedepth = (int) strtol(argv[i+1], NULL, 10);
+                        if (queuedepth < 1) queuedepth = 1;
+                        if (queuedepth > READAHEAD_MAXQUEUEDEPTH) queuedepth = READAHEAD_MAXQUEUEDEPTH;
+                        queuedeptharg = i + 1;
+                    }
+                    if (strcasecmp(argv[i], "--iouring") == 0) iouring = true;
+                    if (strcasecmp(argv[i], "--odirect") == 0) odirect = true;
+                    if (strcasecmp(argv[i], "--nocache") == 0) resultcache = false;
+                    if (strcasecmp(argv[i], "--manifest") == 0) makemanifest = true;
+                    if (strcasecmp(argv[i], "--reverify") == 0) reverify = true;
+                    if (strcasecmp(argv[i], "--noiniindex") == 0) useiniindex = false;
+                    if (strcasecmp(argv[i], "--rebuildiniindex") == 0) rebuildiniindex = true;
+                    if (strcasecmp(argv[i], "--noprefetch") == 0) stealthprefetch = false;
+                    if (strcasecmp(argv[i], "--nostealthstore") == 0) usestealthstore = false;
+                    if (strcasecmp(argv[i], "--gcstealthfiles") == 0) gcstealthfiles = true;
+                    if (strcasecmp(argv[i], "--packvideofiles") == 0) packvideofiles = true;
+                    if (strcasecmp(argv[i], "--jobs") == 0 && (i+1 < argc)) {
+                        jobs = (int) strtol(argv[i+1], NULL, 10);
+                        if (jobs < 0) jobs = 1;
+                        if (jobs == 0) {
+                            // one job per cpu
+                            jobs = (int) sysconf(_SC_NPROCESSORS_ONLN);
+                            if (jobs < 1) jobs = 1;
+                        }
+                        jobsarg = i + 1;
+                    }
+                    if (strcasecmp(argv[i], "--devicejobs") == 0 && (i+1 < argc)) {
+                        devicejobs = (int) strtol(argv[i+1], NULL, 10);
+                        if (devicejobs < 1) devicejobs = 1;
+                        devicejobsarg = i + 1;
+                    }
                 #endif
                 
                 if ((strcasecmp(argv[i], "--myregion") == 0 || strcasecmp(argv[i], "--rgn") == 0) && (i+1 < argc)) {
@@ -3337,6 +3623,11 @@ void parsecmdline(int argc, char *argv[]) {
                     if (readretries < 0) readretries = 20;
                     readretryarg = i + 1;
                 }
+                if (strcasecmp(argv[i], "--xexmemory") == 0 && (i+1 < argc)) {
+                    xexmemory = (int) strtol(argv[i+1], NULL, 10);
+                    if (xexmemory < 1) xexmemory = XEX_DEFAULTMEMORY;
+                    xexmemoryarg = i + 1;
+                }
                 if (strcasecmp(argv[i], "--lang") == 0 && (i+1 < argc)) {
                     userlang = strtol(argv[i+1], NULL, 10);
                     if (userlang < 0) userlang = 0;
@@ -3355,7 +3646,7 @@ void parsecmdline(int argc, char *argv[]) {
                 if (strncasecmp(argv[i]+u, "v", 1) == 0) extraverbose = true;
                 if (strncasecmp(argv[i]+u, "r", 1) == 0) stealthcheck = false;
                 if (strncasecmp(argv[i]+u, "h", 1) == 0) html = true;
-                if (strncasecmp(argv[i]+u, "g", 1) == 0) checkgamecrcnever = true;
+                if (strncasecmp(argv[i]+u, "g", 1) == 0) check->checkgamecrcnever = true;
                 if (strncasecmp(argv[i]+u, "t", 1) == 0) terminal = true;
                 if (strncasecmp(argv[i]+u, "o", 1) == 0) stayoffline = true;
                 if (strncasecmp(argv[i]+u, "u", 1) == 0) autoupload = true;
@@ -3367,8 +3658,8 @@ void parsecmdline(int argc, char *argv[]) {
                 if (strncasecmp(argv[i]+u, "b", 1) == 0) norebuild = true;
                 if (strncasecmp(argv[i]+u, "p", 1) == 0) checkpadding = true;
                 if (strncasecmp(argv[i]+u, "x", 1) == 0) fixangle359 = true;
-                if (strncasecmp(argv[i]+u, "w", 1) == 0) writefile = false;
-                if (strncasecmp(argv[i]+u, "i", 1) == 0) { if (!imagedirmissing) extractimages = true; }
+                if (strncasecmp(argv[i]+u, "w", 1) == 0) check->writefile = false;
+                if (strncasecmp(argv[i]+u, "i", 1) == 0) { if (!imagedirmissing) check->extractimages = true; }
                 if (strncasecmp(argv[i]+u, "e", 1) == 0) showachievements = true;
             }
         }
@@ -3605,11 +3896,186 @@ void initializeglobals() {
   return;
 }
 
+#ifndef WIN32
+// check filenames[] on up to jobs child processes at once, with no more than devicejobs of them reading from the
+// same device, and print each child's report in filename order as soon as every report before it is out
+// returns the index of the file to check in a child, or in the parent once all of the reports have been printed
+// -1 if every job succeeded or -2 if any of them failed (or couldn't be waited for)
+long runbatch(char **filenames, bool *blockdevice, unsigned long filecount) {
+    struct batchjob {
+        pid_t pid;
+        FILE *report, *errors;  // errors is NULL when stderr goes into the report
+        dev_t dev;
+        int status;
+        bool started, finished, waited;
+    } *batch;
+    unsigned long i, j, nextreport = 0, devicerunning;
+    int running = 0, status, devnull;
+    size_t n;
+    struct stat buf;
+    pid_t pid;
+    bool sameterminal, failed = false;
+    batch = (struct batchjob *) calloc(filecount, sizeof(struct batchjob));
+    if (batch == NULL) {
+        color(red);
+        printf("ERROR: Memory allocation for batch jobs failed! Game over man... Game over!%s", newline);
+        color(normal);
+      exit(1);
+    }
+    for (i=0;i<filecount;i++) {
+        // images on the same disk (or the disc in a drive) share one i/o queue
+        if (stat(filenames[i], &buf) == 0) batch[i].dev = blockdevice[i] ? buf.st_rdev : buf.st_dev;
+    }
+    // stderr (progress meters and the like) only goes into the report when it would have been on the same terminal
+    // as the report anyway, otherwise it's kept apart and copied to our stderr when the report is printed
+    sameterminal = isatty(STDOUT_FILENO) && isatty(STDERR_FILENO);
+    if (debug) printf("checking %lu files with up to %d jobs (%d per device)%s", filecount, jobs, devicejobs, newline);
+    while (nextreport < filecount) {
+        for (i=nextreport;i<filecount && running<jobs;i++) {
+            if (batch[i].started) continue;
+            devicerunning = 0;
+            for (j=nextreport;j<filecount;j++) {
+                if (batch[j].started && !batch[j].finished && batch[j].dev == batch[i].dev) devicerunning++;
+            }
+            if (devicerunning >= (unsigned long) devicejobs) continue;
+            batch[i].report = tmpfile();
+            if (batch[i].report != NULL && !sameterminal) batch[i].errors = tmpfile();
+            if (batch[i].report == NULL || (!sameterminal && batch[i].errors == NULL)) {
+                color(red);
+                printf("ERROR: Failed to create a temporary file for the report on %s (%s) Game over man... Game over!%s",
+                        filenames[i], strerror(errno), newline);
+                color(normal);
+              exit(1);
+            }
+            fflush(stdout);
+            fflush(stderr);
+            pid = fork();
+            if (pid == -1) {
+                fclose(batch[i].report);
+                batch[i].report = NULL;
+                if (batch[i].errors != NULL) fclose(batch[i].errors);
+                batch[i].errors = NULL;
+                if (running) break;  // try again when one of them finishes
+                color(red);
+                printf("ERROR: Failed to start a job for %s (%s) Game over man... Game over!%s", filenames[i], strerror(errno), newline);
+                color(normal);
+              exit(1);
+            }
+            if (pid == 0) {
+                // the report goes to the temp file and there's nobody to answer prompts (see readstdin)
+                batchchild = true;
+                dup2(fileno(batch[i].report), STDOUT_FILENO);
+                dup2(fileno(batch[i].errors != NULL ? batch[i].errors : batch[i].report), STDERR_FILENO);
+                devnull = open("/dev/null", O_RDWR);
+                if (devnull != -1) {
+                    dup2(devnull, STDIN_FILENO);
+                    close(devnull);
+                }
+                // line buffered like it is on a terminal, so stdout and stderr are in the order they would have been
+                setvbuf(stdout, NULL, _IOLBF, BUFSIZ);
+              return (long) i;
+            }
+            batch[i].pid = pid;
+            batch[i].started = true;
+            running++;
+        }
+        pid = wait(&status);
+        if (pid == -1 && errno == EINTR) continue;
+        if (pid == -1) {
+            // there's no telling when the rest of the jobs finish, so print whatever they've written so far
+            color(red);
+            printf("ERROR: Failed to wait for the batch jobs (%s), the reports that follow may be incomplete!%s", strerror(errno), newline);
+            color(normal);
+            fflush(stdout);
+            failed = true;
+            for (i=nextreport;i<filecount;i++) batch[i].finished = true;
+        }
+        else for (i=nextreport;i<filecount;i++) {
+            if (batch[i].started && !batch[i].finished && batch[i].pid == pid) {
+                batch[i].finished = true;
+                batch[i].status = status;
+                batch[i].waited = true;
+                running--;
+              break;
+            }
+        }
+        // print every report that's next in line
+        while (nextreport < filecount && batch[nextreport].finished) {
+            if (batch[nextreport].report == NULL) {
+                color(red);
+                printf("%s was not checked!%s", filenames[nextreport], newline);
+                color(normal);
+                nextreport++;
+              continue;
+            }
+            rewind(batch[nextreport].report);
+            while ((n = fread(check->bigbuffer, 1, BIGBUF_SIZE, batch[nextreport].report)) > 0) fwrite(check->bigbuffer, 1, n, stdout);
+            fflush(stdout);
+            fclose(batch[nextreport].report);
+            if (batch[nextreport].errors != NULL) {
+                rewind(batch[nextreport].errors);
+                while ((n = fread(check->bigbuffer, 1, BIGBUF_SIZE, batch[nextreport].errors)) > 0) fwrite(check->bigbuffer, 1, n, stderr);
+                fclose(batch[nextreport].errors);
+            }
+            if (batch[nextreport].waited && (!WIFEXITED(batch[nextreport].status) || WEXITSTATUS(batch[nextreport].status) != 0)) {
+                failed = true;
+                color(red);
+                if (WIFSIGNALED(batch[nextreport].status))
+                    printf("ERROR: The job checking %s was killed by signal %d!%s", filenames[nextreport], WTERMSIG(batch[nextreport].status), newline);
+                else printf("ERROR: The job checking %s failed with exit status %d!%s", filenames[nextreport], WEXITSTATUS(batch[nextreport].status), newline);
+                color(normal);
+                fflush(stdout);
+            }
+            nextreport++;
+        }
+        if (pid == -1) break;
+    }
+    free(batch);
+  return failed ? -2 : -1;
+}
+
+// batch jobs share the StealthFiles folder (and its stealth file store), the result cache and the files that get
+// downloaded into the abgx360 folder, so a job holds this lock while it downloads or updates any of them: an flock
+// on Batch.lock for the other jobs and a mutex for its own threads (the prefetcher), and it does nothing outside of
+// a batch job. abgx360.dat and GameNameLookup.csv don't need it, the parent updates them before starting any jobs
+void lockshared() {
+    char filename[2048];
+    if (!batchchild) return;
+    pthread_mutex_lock(&sharedlock);
+    if (sharedlockfd == -1) {
+        if (homeless) snprintf(filename, sizeof(filename), "%s", batchlockfilename);
+        else snprintf(filename, sizeof(filename), "%s%s%s", homedir, abgxdir, batchlockfilename);
+        // opened in the job rather than the parent so every job has its own lock
+        sharedlockfd = open(filename, O_RDWR | O_CREAT, 0644);
+        if (sharedlockfd == -1 && debug) printf("Failed to open %s (%s)%s", filename, strerror(errno), newline);
+    }
+    if (sharedlockfd != -1) {
+        while (flock(sharedlockfd, LOCK_EX) == -1 && errno == EINTR);
+    }
+  return;
+}
+
+void unlockshared() {
+    if (!batchchild) return;
+    if (sharedlockfd != -1) flock(sharedlockfd, LOCK_UN);
+    pthread_mutex_unlock(&sharedlock);
+  return;
+}
+#endif
+
 int main(int argc, char *argv[]) {
     int i, a;
     unsigned long m;
+    check = newcontext();
+    if (check == NULL) {
+        printf("ERROR: Memory allocation for the check context failed! Game over man... Game over!%s", newline);
+      return 1;
+    }
     atexit(doexitfunction);
     initializeglobals();
+    crc32_init();
+    aescbc_init();
+    sha1fast_init();
     
     if (argc < 2) {
         usage:
@@ -3684,7 +4150,43 @@ int main(int argc, char *argv[]) {
         printf("Game Partition CRC (default behavior is to check it only when needed):%s%s", newline, newline);
         color(normal);
         printf("%s --gamecrc %s always check it%s", sp6, sp4, newline);
-        printf("%s-g,%s--nogamecrc %s never check it%s%s", sp2, sp2, sp2, newline, newline);
+        printf("%s-g,%s--nogamecrc %s never check it%s", sp2, sp2, sp2, newline);
+        #ifndef WIN32
+            printf("%s --crcthreads %snumber%s split the partition into %snumber%s shards that are read%s", sp6, lessthan, greaterthan, lessthan, greaterthan, newline);
+            printf("%s%s and hashed in parallel (default=1; 0=one per cpu)%s", sp21, sp5, newline);
+            printf("%s --onepass %s read the whole ISO in one forward pass for the Video CRC,%s", sp6, sp4, newline);
+            printf("%s padding and Game CRC checks instead of seeking between%s", sp21, newline);
+            printf("%s them (only worth it when the Game CRC will be checked)%s", sp21, newline);
+            printf("%s --queuedepth %snumber%s keep %snumber%s reads in flight during the Game CRC%s", sp6, lessthan, greaterthan, lessthan, greaterthan, newline);
+            printf("%s%s and --onepass scans (default=1, max=%d)%s", sp21, sp5, READAHEAD_MAXQUEUEDEPTH, newline);
+            printf("%s --iouring %s queue those reads with io_uring instead of using one%s", sp6, sp4, newline);
+            printf("%s thread per read (if the kernel allows it)%s", sp21, newline);
+            printf("%s --odirect %s bypass the page cache when reading from a block device%s", sp6, sp4, newline);
+            printf("%s --nocache %s don't use or save the Video/Game CRC and padding results%s", sp6, sp4, newline);
+            printf("%s cached from earlier checks of images that haven't changed%s", sp21, newline);
+            printf("%s --manifest %s save the CRC of every %d MB of the Video and Game%s", sp6, sp3, CHUNKMANIFEST_CHUNKSIZE / 1048576, newline);
+            printf("%s partitions next to the ISO (as %sISO%s.chunks) while checking%s", sp21, lessthan, greaterthan, newline);
+            printf("%s --reverify %s only reread the ISO against its .chunks manifest (on%s", sp6, sp3, newline);
+            printf("%s --crcthreads threads) and show which sectors changed%s", sp21, newline);
+            printf("%s --noiniindex %s don't look up local inis in the ini index (it's only%s", sp6, sp1, newline);
+            printf("%s used with --localonly or when online functions are off)%s", sp21, newline);
+            printf("%s --rebuildiniindex rebuild the ini index now instead of when the%s", sp6, newline);
+            printf("%s StealthFiles folder changes%s", sp21, newline);
+            printf("%s --noprefetch %s don't download the inis and stealth files needed for%s", sp6, sp1, newline);
+            printf("%s Verification and AutoFix all at once before starting%s", sp21, newline);
+            printf("%s --nostealthstore don't keep stealth files verified by AutoFix in the%s", sp6, newline);
+            printf("%s StealthFiles/Store folder (they're read again next time)%s", sp21, newline);
+            printf("%s --gcstealthfiles remove stealth files no longer used from that folder%s", sp6, newline);
+            printf("%s and share one copy of any identical stealth files%s", sp21, newline);
+            printf("%s --packvideofiles compress the Video files in the StealthFiles folder%s", sp6, newline);
+            printf("%s (they're still read from there like before)%s", sp21, newline);
+            printf("%s --jobs %snumber%s %s check up to %snumber%s files at once (reports are%s", sp6, lessthan, greaterthan, sp5, lessthan, greaterthan, newline);
+            printf("%s%s still printed in order but prompts are answered no;%s", sp21, sp5, newline);
+            printf("%s%s default=1; 0=one per cpu)%s", sp21, sp5, newline);
+            printf("%s --devicejobs %snumber%s only read %snumber%s of those files from the same disk%s", sp6, lessthan, greaterthan, lessthan, greaterthan, newline);
+            printf("%s%s or drive at once (default=1)%s", sp21, sp5, newline);
+        #endif
+        printf("%s", newline);
         
         color(white);
         printf("AutoFix Threshold (use only one option, higher levels include lower ones):%s%s", newline, newline);
@@ -3713,6 +4215,11 @@ int main(int argc, char *argv[]) {
         printf("%s-l,%s --rebuildlowspace %s only requires 253 MB free space but will corrupt%s", sp2, sp1, sp1, newline);
         printf("%s%s your ISO if it fails or is aborted during the%s", sp21, sp5, newline);
         printf("%s%s rebuilding process%s", sp21, sp5, newline);
+        #ifndef WIN32
+            printf("%s%s (on filesystems that support it, like ext4 and%s", sp21, sp5, newline);
+            printf("%s%s xfs, both methods insert the space instantly%s", sp21, sp5, newline);
+            printf("%s%s without copying anything)%s", sp21, sp5, newline);
+        #endif
         printf("%s-b,%s --norebuild %s don't rebuild%s", sp2, sp1, sp7, newline);
         printf("%s-k,%s--keeporiginaliso %s don't delete the original ISO after rebuilding%s", sp2, sp2, sp1, newline);
         printf("%s%s (applies to the default method only)%s%s", sp21, sp5, newline, newline);
@@ -3778,6 +4285,8 @@ int main(int argc, char *argv[]) {
         printf("%s --dvdtimeout %ssecs%s change the timeout for DVD Drive I/O requests to%s", sp6, lessthan, greaterthan, newline);
         printf("%s%s %ssecs%s seconds (default=20)%s", sp21, sp5, lessthan, greaterthan, newline);
         printf("%s --devkey %s use the devkit AES key when decrypting an Xex%s", sp6, sp10, newline);
+        printf("%s --xexmemory %sMB%s%s most memory an Xex check can use, it's read in%s", sp6, lessthan, greaterthan, sp3, newline);
+        printf("%s%s pieces to stay under it (default=%d)%s", sp21, sp5, XEX_DEFAULTMEMORY, newline);
         printf("%s --help %s display this message (or just use %s%s%s%s", sp6, sp12, quotation, argv[0], quotation, newline);
         printf("%s%s with no arguments)%s%s", sp21, sp5, newline, newline);
         
@@ -3847,6 +4356,7 @@ int main(int argc, char *argv[]) {
             printf("SHA-1 Self Test Failed!%s", newline);
             color(normal);
         }
+        printf("SHA-1 implementation: %s%s", sha1fast_implementation(), newline);
     }
     
     #ifdef WIN32
@@ -3957,6 +4467,15 @@ int main(int argc, char *argv[]) {
     if (justhelp) goto usage;
     printheader();
     if (justheader) return 0;
+    #ifndef WIN32
+        if (rebuildiniindex && !homeless) {
+            pthread_mutex_lock(&iniindexlock);
+            iniindexopened = (buildiniindex(true) == 0);
+            pthread_mutex_unlock(&iniindexlock);
+        }
+        if (gcstealthfiles && !homeless) dogcstealthfiles();
+        if (packvideofiles && !homeless) dopackvideofiles();
+    #endif
     
     if (!stayoffline) {
         // initialize curl
@@ -3998,7 +4517,7 @@ int main(int argc, char *argv[]) {
             printf("Checking for updates to GameNameLookup.csv and abgx360.dat...%s", newline);
             // download an updated GameNameLookup.csv and abgx360.dat if server file is newer than the local one
             memset(curlerrorbuffer, 0, CURL_ERROR_SIZE+1);
-            memset(buffer, 0, 2048);
+            memset(check->buffer, 0, 2048);
             curl_easy_setopt(curl, CURLOPT_ENCODING, "");  // If a zero-length string is set, then an Accept-Encoding: header containing
                                                            // all supported encodings is sent.
             curl_easy_setopt(curl, CURLOPT_USERAGENT, curluseragent);
@@ -4014,23 +4533,23 @@ int main(int argc, char *argv[]) {
             curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0);
             if (extraverbose) curl_easy_setopt(curl, CURLOPT_VERBOSE, 1);
             if (!homeless) {
-                strcat(buffer, homedir);
-                strcat(buffer, abgxdir);
+                strcat(check->buffer, homedir);
+                strcat(check->buffer, abgxdir);
             }
-            strcat(buffer, "GameNameLookup.csv");
-            struct MyCurlFile curlwebcsv = {buffer, NULL};
+            strcat(check->buffer, "GameNameLookup.csv");
+            struct MyCurlFile curlwebcsv = {check->buffer, NULL};
             curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *) &curlwebcsv);
             curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, my_curl_write);
-            if (stat(buffer, &buf) == 0) {
+            if (stat(check->buffer, &buf) == 0) {
                 curl_easy_setopt(curl, CURLOPT_TIMECONDITION, 1);
                 curl_easy_setopt(curl, CURLOPT_TIMEVALUE, buf.st_mtime);
-                if (debug) printf("%s: buf.st_mtime = %ld%s", buffer, (long) buf.st_mtime, newline);
+                if (debug) printf("%s: buf.st_mtime = %ld%s", check->buffer, (long) buf.st_mtime, newline);
             }
             else {
                 curl_easy_setopt(curl, CURLOPT_TIMECONDITION, 0);
-                if (debug) printf("stat failed for %s (%s) - no time condition used%s", buffer, strerror(errno), newline);
+                if (debug) printf("stat failed for %s (%s) - no time condition used%s", check->buffer, strerror(errno), newline);
             }
-            curlheaderprinted = false;
+            check->curlheaderprinted = false;
             if (extraverbose) {
                 fprintf(stderr, "\n");
             }
@@ -4040,7 +4559,7 @@ int main(int argc, char *argv[]) {
             res = curl_easy_perform(curl);
             color(normal);
             printstderr = false;
-            if (extraverbose || curlheaderprinted) fprintf(stderr, "\n");
+            if (extraverbose || check->curlheaderprinted) fprintf(stderr, "\n");
             if (res != CURLE_OK) {  // error occurred
                 color(yellow);
                 if (res == CURLE_HTTP_RETURNED_ERROR) {
@@ -4067,14 +4586,19 @@ int main(int argc, char *argv[]) {
                 color(normal);
                 printcurlinfo(curl, "GameNameLookup.csv");
             }
-            if (curlwebcsv.stream != NULL) fclose(curlwebcsv.stream);
+            if (curlwebcsv.stream != NULL) {
+                fclose(curlwebcsv.stream);
+                #ifndef WIN32
+                    invalidatecsvindex();
+                #endif
+            }
             if (res != CURLE_OK && res != CURLE_HTTP_RETURNED_ERROR) {
                 goto skipdatupdate;
             }
         }
         // now get abgx360.dat
         memset(curlerrorbuffer, 0, CURL_ERROR_SIZE+1);
-        memset(buffer, 0, 2048);
+        memset(check->buffer, 0, 2048);
         if (!csvupdate) {
             printf("Checking for updates to abgx360.dat...%s", newline);
             curl_easy_setopt(curl, CURLOPT_ENCODING, "");  // If a zero-length string is set, then an Accept-Encoding: header containing
@@ -4094,22 +4618,22 @@ int main(int argc, char *argv[]) {
         curl_easy_setopt(curl, CURLOPT_URL, webdat);
         curl_easy_setopt(curl, CURLOPT_PROGRESSDATA, (char*) "Downloading abgx360.dat");
         if (!homeless) {
-            strcat(buffer, homedir);
-            strcat(buffer, abgxdir);
+            strcat(check->buffer, homedir);
+            strcat(check->buffer, abgxdir);
         }
-        strcat(buffer, "abgx360.dat");
-        struct MyCurlFile curlwebdat = {buffer, NULL};
+        strcat(check->buffer, "abgx360.dat");
+        struct MyCurlFile curlwebdat = {check->buffer, NULL};
         curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *) &curlwebdat);
-        if (stat(buffer, &buf) == 0) {
+        if (stat(check->buffer, &buf) == 0) {
             curl_easy_setopt(curl, CURLOPT_TIMECONDITION, 1);
             curl_easy_setopt(curl, CURLOPT_TIMEVALUE, buf.st_mtime);
-            if (debug) printf("%s: buf.st_mtime = %ld%s", buffer, (long) buf.st_mtime, newline);
+            if (debug) printf("%s: buf.st_mtime = %ld%s", check->buffer, (long) buf.st_mtime, newline);
         }
         else {
             curl_easy_setopt(curl, CURLOPT_TIMECONDITION, 0);
-            if (debug) printf("stat failed for %s (%s) - no time condition used%s", buffer, strerror(errno), newline);
+            if (debug) printf("stat failed for %s (%s) - no time condition used%s", check->buffer, strerror(errno), newline);
         }
-        curlheaderprinted = false;
+        check->curlheaderprinted = false;
         if (extraverbose) fprintf(stderr, "\n");
         printstderr = true;
         color(blue);
@@ -4117,7 +4641,7 @@ int main(int argc, char *argv[]) {
         res = curl_easy_perform(curl);
         color(normal);
         printstderr = false;
-        if (extraverbose || curlheaderprinted) fprintf(stderr, "\n");
+        if (extraverbose || check->curlheaderprinted) fprintf(stderr, "\n");
         if (res != CURLE_OK) {  // error occurred
             color(yellow);
             if (res == CURLE_HTTP_RETURNED_ERROR) {
@@ -4180,97 +4704,97 @@ int main(int argc, char *argv[]) {
               return 1;
             }
             
-            writefile = false;
-            fp = NULL;
+            check->writefile = false;
+            check->fp = NULL;
             
             if (opendeviceandgetname(argv[dvdarg], false, false)) return 1;
             
             // get size of media in bytes
-            fpfilesize = getdisccapacity(true, true);
-            if (fpfilesize == -1LL) return 1;
-            if (debug) printf("fpfilesize: %"LL"d%s", fpfilesize, newline);
+            check->fpfilesize = getdisccapacity(true, true);
+            if (check->fpfilesize == -1LL) return 1;
+            if (debug) printf("fpfilesize: %"LL"d%s", check->fpfilesize, newline);
             
             // make sure we will be able to read sector 32 in the game partition
             // (any game [xgd2/xgd3 with or without video] should be at least this big)
-            if (fpfilesize < 0xFDA0800LL /* 0xFD90000 (largest current video offset [xgd2]) + 33*2048 (to make sure we can read sector 32) */) {
+            if (check->fpfilesize < 0xFDA0800LL /* 0xFD90000 (largest current video offset [xgd2]) + 33*2048 (to make sure we can read sector 32) */) {
                 color(red);
-                printf("ERROR: Media size (%"LL"d bytes) is too small to be an Xbox 360 game!%s", fpfilesize, newline);
+                printf("ERROR: Media size (%"LL"d bytes) is too small to be an Xbox 360 game!%s", check->fpfilesize, newline);
                 color(normal);
               return 1;
             }
             
             // check to see if they burned just a game partition (unbootable) by looking for magic bytes at sector 32
-            video = 0LL;
-            memset(ubuffer, 0, 2048);
+            check->video = 0LL;
+            memset(check->ubuffer, 0, 2048);
             initcheckread();
-            if (checkreadandprinterrors(ubuffer, 1, 2048, fp, 0, 65536, isofilename, "Reading Sector 32") != 0) return 1;
-            donecheckread(isofilename);
-            if (debug) { printf("sector 32:%s", newline); hexdump(ubuffer, 0, 2048); }
+            if (checkreadandprinterrors(check->ubuffer, 1, 2048, check->fp, 0, 65536, check->isofilename, "Reading Sector 32") != 0) return 1;
+            donecheckread(check->isofilename);
+            if (debug) { printf("sector 32:%s", newline); hexdump(check->ubuffer, 0, 2048); }
             
-            if (memcmp(ubuffer, "MICROSOFT*XBOX*MEDIA", 20) != 0) {
+            if (memcmp(check->ubuffer, "MICROSOFT*XBOX*MEDIA", 20) != 0) {
                 // proper backups should have the game partition starting at 0xFD90000 (XGD2) or 0x2080000 (XGD3)
-                video = 0xFD90000LL;
+                check->video = 0xFD90000LL;
                 // read sector 32 + video
-                memset(ubuffer, 0, 2048);
+                memset(check->ubuffer, 0, 2048);
                 initcheckread();
-                if (checkreadandprinterrors(ubuffer, 1, 2048, fp, 0, video+65536LL, isofilename, "Reading Sector 32") != 0) return 1;
-                donecheckread(isofilename);
+                if (checkreadandprinterrors(check->ubuffer, 1, 2048, check->fp, 0, check->video+65536LL, check->isofilename, "Reading Sector 32") != 0) return 1;
+                donecheckread(check->isofilename);
                 if (debug) {
-                    printf("sector 32 + video (%"LL"d):%s", video, newline);
-                    hexdump(ubuffer, 0, 2048);
+                    printf("sector 32 + video (%"LL"d):%s", check->video, newline);
+                    hexdump(check->ubuffer, 0, 2048);
                 }
-                if (memcmp(ubuffer, "MICROSOFT*XBOX*MEDIA", 20) != 0) {
-                    video = 0x2080000LL;
+                if (memcmp(check->ubuffer, "MICROSOFT*XBOX*MEDIA", 20) != 0) {
+                    check->video = 0x2080000LL;
                     // read sector 32 + video
-                    memset(ubuffer, 0, 2048);
+                    memset(check->ubuffer, 0, 2048);
                     initcheckread();
-                    if (checkreadandprinterrors(ubuffer, 1, 2048, fp, 0, video+65536LL, isofilename, "Reading Sector 32") != 0) return 1;
-                    donecheckread(isofilename);
+                    if (checkreadandprinterrors(check->ubuffer, 1, 2048, check->fp, 0, check->video+65536LL, check->isofilename, "Reading Sector 32") != 0) return 1;
+                    donecheckread(check->isofilename);
                     if (debug) {
-                        printf("sector 32 + video (%"LL"d):%s", video, newline);
-                        hexdump(ubuffer, 0, 2048);
+                        printf("sector 32 + video (%"LL"d):%s", check->video, newline);
+                        hexdump(check->ubuffer, 0, 2048);
                     }
-                    if (memcmp(ubuffer, "MICROSOFT*XBOX*MEDIA", 20) != 0) {
+                    if (memcmp(check->ubuffer, "MICROSOFT*XBOX*MEDIA", 20) != 0) {
                         // should have found this string by now
                         color(red);
                         printf("ERROR: Media isn't recognized as an Xbox 360 game!%s", newline);
                         color(normal);
                       return 1;
                     }
-                    else xgd3 = true;
+                    else check->xgd3 = true;
                 }
             }
             
             // get layerbreak from the alternate PFI in the SS
             // if the SS doesn't exist/isn't valid or if altpfi_endpsnL0 is less than 0x30000 or if altpfi_startpsnL0
             // doesn't correspond to the video offset, assume the layerbreak based solely on the video offset
-            layerbreak = -1;
-            if (video != 0) {
-                memset(ubuffer, 0, 2048);
+            check->layerbreak = -1;
+            if (check->video != 0) {
+                memset(check->ubuffer, 0, 2048);
                 initcheckread();
-                if (checkreadandprinterrors(ubuffer, 1, 2048, fp, 0, video - (xgd3 ? 0x8800 : 0x800), isofilename, "Checking Alternate PFI") != 0) return 1;
-                donecheckread(isofilename);
-                if (lookslike360ss(ubuffer)) {
+                if (checkreadandprinterrors(check->ubuffer, 1, 2048, check->fp, 0, check->video - (check->xgd3 ? 0x8800 : 0x800), check->isofilename, "Checking Alternate PFI") != 0) return 1;
+                donecheckread(check->isofilename);
+                if (lookslike360ss(check->ubuffer)) {
                     // get End PSN of L0 Data Area
-                    unsigned char altpfi_endpsnL0hex[4] = {ubuffer[15], ubuffer[14], ubuffer[13], 0x00};
+                    unsigned char altpfi_endpsnL0hex[4] = {check->ubuffer[15], check->ubuffer[14], check->ubuffer[13], 0x00};
                     unsigned long altpfi_endpsnL0 = getuint(altpfi_endpsnL0hex);
                     // get Start PSN of L0 Data Area to check that it corresponds to the video offset
-                    unsigned char altpfi_startpsnL0hex[4] = {ubuffer[7], ubuffer[6], ubuffer[5], 0x00};
+                    unsigned char altpfi_startpsnL0hex[4] = {check->ubuffer[7], check->ubuffer[6], check->ubuffer[5], 0x00};
                     unsigned long altpfi_startpsnL0 = getuint(altpfi_startpsnL0hex);
                     if (debug) printf("about to take the layerbreak from the SS if these values are acceptable:%saltpfi_endpsnL0 = 0x%lX, altpfi_startpsnL0 = 0x%lX%s", newline, altpfi_endpsnL0, altpfi_startpsnL0, newline);
-                    if (altpfi_endpsnL0 >= 0x30000 && altpfi_startpsnL0 >= 0x30000 && ((altpfi_startpsnL0 - 0x30000) * 2048 == video)) {
-                        layerbreak = (long) altpfi_endpsnL0 - 0x30000 + 1;
-                        if (debug) printf("layerbreak (%ld) taken from SS altpfi_endpsnL0 (0x%lX)%s", layerbreak, altpfi_endpsnL0, newline);
+                    if (altpfi_endpsnL0 >= 0x30000 && altpfi_startpsnL0 >= 0x30000 && ((altpfi_startpsnL0 - 0x30000) * 2048 == check->video)) {
+                        check->layerbreak = (long) altpfi_endpsnL0 - 0x30000 + 1;
+                        if (debug) printf("layerbreak (%ld) taken from SS altpfi_endpsnL0 (0x%lX)%s", check->layerbreak, altpfi_endpsnL0, newline);
                     }
                 }
                 else if (debug) {
-                    printf("the sector at video - 0x%lX does not look like Xbox 360 SS:%s", (xgd3 ? 0x8800 : 0x800), newline);
-                    hexdump(ubuffer, 0, 2048);
+                    printf("the sector at video - 0x%lX does not look like Xbox 360 SS:%s", (check->xgd3 ? 0x8800 : 0x800), newline);
+                    hexdump(check->ubuffer, 0, 2048);
                 }
-                if (layerbreak == -1) {
-                    if      (video == 0xFD90000LL) layerbreak = 1913760;  // XGD2
-                    else                           layerbreak = 2133520;  // XGD3 or unknown (we shouldn't get here though if video isn't either 0xFD90000 or 0x2080000)
-                    if (debug) printf("layerbreak (%ld) assumed based on video offset (0x%"LL"X)%s", layerbreak, video, newline);
+                if (check->layerbreak == -1) {
+                    if      (check->video == 0xFD90000LL) check->layerbreak = 1913760;  // XGD2
+                    else                           check->layerbreak = 2133520;  // XGD3 or unknown (we shouldn't get here though if video isn't either 0xFD90000 or 0x2080000)
+                    if (debug) printf("layerbreak (%ld) assumed based on video offset (0x%"LL"X)%s", check->layerbreak, check->video, newline);
                 }
                 // check that they've burned with the correct layerbreak
                 getL0capacity();
@@ -4280,7 +4804,7 @@ int main(int argc, char *argv[]) {
             if (speedarg) setdvdspeed(speed, false);
             
             if (manualextract) {
-                if (video == 0) {
+                if (check->video == 0) {
                     color(yellow);
                     printf("ERROR: This disc is just a game partition (no stealth files to extract)%s%s", newline, newline);
                     color(normal);
@@ -4292,7 +4816,7 @@ int main(int argc, char *argv[]) {
             
             if (stealthcheck) {
                 printf("%s", newline);
-                if (video == 0) {
+                if (check->video == 0) {
                     // means that "MICROSOFT*XBOX*MEDIA" was found at sector 32
                     color(red);
                     printf("Stealth Failed!: Image is missing Video, PFI, DMI and SS%s", newline);
@@ -4302,75 +4826,80 @@ int main(int argc, char *argv[]) {
                   return 1;
                 }
                 
-                if (game_has_ap25) {
+                if (check->game_has_ap25) {
                     // check topology data
                     initcheckread();
-                    if (checkreadandprinterrors(topology, 1, TOPOLOGY_SIZE, fp, 0, video - (xgd3 ? 0x10000 : 0x8000), isofilename,
+                    if (checkreadandprinterrors(check->topology, 1, TOPOLOGY_SIZE, check->fp, 0, check->video - (check->xgd3 ? 0x10000 : 0x8000), check->isofilename,
                                                 "Reading the topology data") != 0) {
                         resetdrivespeedifneeded();
                       return 1;
                     }
-                    donecheckread(isofilename);
+                    donecheckread(check->isofilename);
                     checktopology();
                     if (verbose) printf("%s", newline);
                 }
                 
                 // check SS
                 initcheckread();
-                if (checkreadandprinterrors(ss, 1, 2048, fp, 0, video - (xgd3 ? 0x8800 : 0x800), isofilename, "Reading the SS") != 0) {
+                if (checkreadandprinterrors(check->ss, 1, 2048, check->fp, 0, check->video - (check->xgd3 ? 0x8800 : 0x800), check->isofilename, "Reading the SS") != 0) {
                     resetdrivespeedifneeded();
                   return 1;
                 }
-                donecheckread(isofilename);
+                donecheckread(check->isofilename);
                 checkss();
-                if (ssv2) iso_has_ssv2 = true;
-                else iso_has_ssv2 = false;
+                if (check->ssv2) check->iso_has_ssv2 = true;
+                else check->iso_has_ssv2 = false;
                 
                 // check DMI
                 initcheckread();
-                if (checkreadandprinterrors(ubuffer, 1, 2048, fp, 0, video - (xgd3 ? 0x9000 : 0x1000), isofilename, "Reading the DMI") != 0) {
+                if (checkreadandprinterrors(check->ubuffer, 1, 2048, check->fp, 0, check->video - (check->xgd3 ? 0x9000 : 0x1000), check->isofilename, "Reading the DMI") != 0) {
                     resetdrivespeedifneeded();
                   return 1;
                 }
-                donecheckread(isofilename);
-                checkdmi(ubuffer);
+                donecheckread(check->isofilename);
+                checkdmi(check->ubuffer);
                 
                 // check PFI
                 initcheckread();
-                if (checkreadandprinterrors(ubuffer, 1, 2048, fp, 0, video - (xgd3 ? 0x9800 : 0x1800), isofilename, "Reading the PFI") != 0) {
+                if (checkreadandprinterrors(check->ubuffer, 1, 2048, check->fp, 0, check->video - (check->xgd3 ? 0x9800 : 0x1800), check->isofilename, "Reading the PFI") != 0) {
                     resetdrivespeedifneeded();
                   return 1;
                 }
-                donecheckread(isofilename);
-                checkpfi(ubuffer);
+                donecheckread(check->isofilename);
+                checkpfi(check->ubuffer);
+                
+                #ifndef WIN32
+                    // the SS and Xex CRCs are known, look up the verified inis while the Video and Game CRCs are computed
+                    startprefetch();
+                #endif
                 
                 // check Video
                 if (verbose) printf("%s", newline);
-                checkvideo(isofilename, fp, false, checkpadding);
+                checkvideo(check->isofilename, check->fp, false, checkpadding);
                 
-                if (video_stealthfailed || pfi_stealthfailed || dmi_stealthfailed || ss_stealthfailed || stealthfailed) {
+                if (check->video_stealthfailed || check->pfi_stealthfailed || check->dmi_stealthfailed || check->ss_stealthfailed || check->stealthfailed) {
                     color(red);
                     printf("%sStealth check failed!%s", newline, newline);
                     color(normal);
                 }
-                else if (video_stealthuncertain || pfi_stealthuncertain || dmi_stealthuncertain || ss_stealthuncertain || stealthuncertain) {
+                else if (check->video_stealthuncertain || check->pfi_stealthuncertain || check->dmi_stealthuncertain || check->ss_stealthuncertain || check->stealthuncertain) {
                     color(yellow);
                     printf("%sStealth status is uncertain%s", newline, newline);
                     color(normal);
                     if (verify) {
                         returnvalue = doverify();
                         if (returnvalue == 0) {
-                            if (drtfucked) {
+                            if (check->drtfucked) {
                                 color(yellow);
                                 printf("Stealth and game data were verified but angle deviation cannot be verified%s", newline);
-                                if (game_has_ap25 && !topology_was_verified) {
+                                if (check->game_has_ap25 && !check->topology_was_verified) {
                                     printf("Note: Topology data wasn't verified either%s", newline);
                                 }
                             }
                             else {
                                 color(green);
                                 printf("Verification was successful, Stealth passed!%s", newline);
-                                if (game_has_ap25 && !topology_was_verified) {
+                                if (check->game_has_ap25 && !check->topology_was_verified) {
                                     color(yellow);
                                     printf("Note: Topology data was not verified%s", newline);
                                 }
@@ -4380,14 +4909,14 @@ int main(int argc, char *argv[]) {
                         else if (returnvalue == 2) {
                             color(yellow);
                             printf("Stealth was verified but game data wasn't%s", newline);
-                            if (drtfucked) printf("Angle deviation cannot be verified%s", newline);
-                            if (game_has_ap25 && !topology_was_verified) {
+                            if (check->drtfucked) printf("Angle deviation cannot be verified%s", newline);
+                            if (check->game_has_ap25 && !check->topology_was_verified) {
                                 printf("Note: Topology data wasn't verified either%s", newline);
                             }
                             color(normal);
                         }
                         else {
-                            verifyfailed = true;
+                            check->verifyfailed = true;
                             color(yellow);
                             if (returnvalue == 3) printf("Game data was verified but stealth wasn't%s", newline);
                             printf("Verification failed%s", newline);
@@ -4406,7 +4935,7 @@ int main(int argc, char *argv[]) {
                         if (returnvalue == 0) {
                             color(green);
                             printf("Verification was successful!%s", newline);
-                            if (game_has_ap25 && !topology_was_verified) {
+                            if (check->game_has_ap25 && !check->topology_was_verified) {
                                 color(yellow);
                                 printf("Note: Topology data was not verified%s", newline);
                             }
@@ -4415,23 +4944,23 @@ int main(int argc, char *argv[]) {
                         else if (returnvalue == 2) {
                             color(yellow);
                             printf("Stealth was verified but game data wasn't%s", newline);
-                            if (game_has_ap25 && !topology_was_verified) {
+                            if (check->game_has_ap25 && !check->topology_was_verified) {
                                 printf("Note: Topology data wasn't verified either%s", newline);
                             }
                             color(normal);
                         }
                         else {
-                            verifyfailed = true;
+                            check->verifyfailed = true;
                             color(yellow);
                             if (returnvalue == 3) printf("Game data was verified but stealth wasn't%s", newline);
                             printf("Verification failed%s", newline);
                             color(normal);
-                            if (autoupload && !stayoffline && !fixedss && autouploaduserarg && autouploadpassarg) {
+                            if (autoupload && !stayoffline && !check->fixedss && autouploaduserarg && autouploadpassarg) {
                                 doautoupload(argv, false);
                             }
                         }
                         if ( (returnvalue == 0 || returnvalue == 2) &&
-                              autoupload && !stayoffline && !fixedss && autouploaduserarg && autouploadpassarg && iso_has_ssv2) {
+                              autoupload && !stayoffline && !check->fixedss && autouploaduserarg && autouploadpassarg && check->iso_has_ssv2) {
                             // autoupload an ssv2 if stealth was verified but the existing ss in the db is ssv1
                             printf("%sChecking to see if the existing SS file in the db is SSv1...%s", newline, newline);
                             if (valid_ssv2_exists_in_db()) {
@@ -4442,20 +4971,20 @@ int main(int argc, char *argv[]) {
                         }
                     }
                 }
-                if (checkcorruption && game_crc32 == 0 && !checkgamecrcnever) {
+                if (checkcorruption && check->game_crc32 == 0 && !check->checkgamecrcnever) {
                     printf("%sChecking for AnyDVD style game data corruption while running CRC check...%s", newline, newline);
                     if (docheckgamecrc() == 0) {
-                        if (corruptionoffsetcount == 0) {
+                        if (check->corruptionoffsetcount == 0) {
                             color(green);
                             if (verbose) printf("%s", sp5);
                             printf("AnyDVD style corruption was not detected%s", newline);
                             color(normal);
                         }
-                        if (verbose) printf("%sGame CRC = %08lX%s%s", sp5, game_crc32, newline, newline);
+                        if (verbose) printf("%sGame CRC = %08lX%s%s", sp5, check->game_crc32, newline, newline);
                     }
                     else {
-                        checkgamecrcnever = true;
-                        if (!usercancelledgamecrc) gamecrcfailed = true;
+                        check->checkgamecrcnever = true;
+                        if (!check->usercancelledgamecrc) check->gamecrcfailed = true;
                     }
                 }
             }
@@ -4579,7 +5108,8 @@ int main(int argc, char *argv[]) {
                 i==fixangledevarg || i==patchvideoarg || i==patchpfiarg || i==patchdmiarg || i==patchssarg ||
                 i==autouploaduserarg || i==autouploadpassarg || i==extractvideoarg ||
                 i==extractpfiarg || i==extractdmiarg || i==extractssarg || i==connectiontimeoutarg || i==dvdarg ||
-                i==dvdtimeoutarg || i==userlangarg || i==origarg || i==speedarg /* || i==riparg || i==ripdestarg */) continue;
+                i==dvdtimeoutarg || i==userlangarg || i==origarg || i==speedarg || i==crcthreadsarg || i==queuedeptharg ||
+                i==jobsarg || i==devicejobsarg || i==xexmemoryarg /* || i==riparg || i==ripdestarg */) continue;
             if ( stat(argv[i], &buf) == -1 ) {
                 printf("ERROR: stat failed for %s (%s)%s", argv[i], strerror(errno), newline);
               continue;
@@ -4605,6 +5135,9 @@ int main(int argc, char *argv[]) {
             if (debug) for (m=0;m<filecount;m++) printf("%ld: %s%s", m, filenames[m], newline);
         }
         else {
+            #ifndef WIN32
+                if (rebuildiniindex || gcstealthfiles || packvideofiles) return 0;  // that was all we were asked to do
+            #endif
             color(red);
             printf("ERROR: No valid input files were specified!%s", newline);
             color(normal);
@@ -4613,86 +5146,102 @@ int main(int argc, char *argv[]) {
     }
     if (filecount == 1) {
         // open the only file from filenames list
-        isofilename = calloc(strlen(filenames[0]) + 1, sizeof(char));
-        if (isofilename == NULL) {
+        check->isofilename = calloc(strlen(filenames[0]) + 1, sizeof(char));
+        if (check->isofilename == NULL) {
             color(red);
             printf("ERROR: Memory allocation for isofilename failed! Game over man... Game over!%s", newline);
             color(normal);
           exit(1);
         }
-        strcpy(isofilename, filenames[0]);
-        fp = fopen(isofilename, "rb");
-        if (fp == NULL) {
+        strcpy(check->isofilename, filenames[0]);
+        check->fp = fopen(check->isofilename, "rb");
+        if (check->fp == NULL) {
             color(red);
-            printf("ERROR: Failed to open %s (%s)%s", isofilename, strerror(errno), newline);
+            printf("ERROR: Failed to open %s (%s)%s", check->isofilename, strerror(errno), newline);
             color(normal);
           return 1;
         }
         if (blockdevice[0]) {
-            writefile = false;
+            check->writefile = false;
         }
     }
     
-    unsigned long fileloop;
+    unsigned long fileloop, firstfile = 0, lastfile = filecount;
+    
+    #ifndef WIN32
+        if (jobs > 1 && filecount > 1) {
+            // the parent only runs the jobs and prints their reports, each child checks one file and exits
+            long batchfile = runbatch(filenames, blockdevice, filecount);
+            if (batchfile < 0) return batchfile == -1 ? 0 : 1;
+            firstfile = (unsigned long) batchfile;
+            lastfile = firstfile + 1;
+        }
+    #endif
     
-    for (fileloop=0;fileloop<filecount;fileloop++) {
+    for (fileloop=firstfile;fileloop<lastfile;fileloop++) {
         if (filecount > 1) {
-            if (fileloop) {
+            if (fileloop > firstfile) {
                 // do finishing up stuff for last file
                 #ifndef WIN32
                     if (blockdevice[fileloop-1]) resetdrivespeedifneeded();
                     if (fd != -1) close(fd);
+                    saveresultcache();
+                    savemanifest();
                 #endif
-                if (fp != NULL) fclose(fp);
+                if (check->fp != NULL) fclose(check->fp);
                 // reset global variables that need to be reset after every file loop and parse command line again
                 resetvars();
                 parsecmdline(argc, argv);
-                printf("%s", newline);
             }
+            if (fileloop) printf("%s", newline);
             // open file from filenames list
             color(filename);
             printf("%s:", filenames[fileloop]);
             color(normal);
             printf("%s", newline);
-            if (fileloop) isofilename = realloc(isofilename, (strlen(filenames[fileloop]) + 1) * sizeof(char));
-            else isofilename = calloc(strlen(filenames[fileloop]) + 1, sizeof(char));
-            if (isofilename == NULL) {
+            if (fileloop) check->isofilename = realloc(check->isofilename, (strlen(filenames[fileloop]) + 1) * sizeof(char));
+            else check->isofilename = calloc(strlen(filenames[fileloop]) + 1, sizeof(char));
+            if (check->isofilename == NULL) {
                 color(red);
                 printf("ERROR: memory allocation for isofilename failed! Game over man... Game over!%s", newline);
                 color(normal);
               exit(1);
             }
-            strcpy(isofilename, filenames[fileloop]);
-            fp = fopen(isofilename, do_blank_ss ? "rb+" : "rb");
-            if (fp == NULL) {
+            strcpy(check->isofilename, filenames[fileloop]);
+            check->fp = fopen(check->isofilename, check->do_blank_ss ? "rb+" : "rb");
+            if (check->fp == NULL) {
                 // couldn't open the file
                 color(red);
-                printf("ERROR: Failed to open %s (%s)%s", isofilename, strerror(errno), newline);
+                printf("ERROR: Failed to open %s (%s)%s", check->isofilename, strerror(errno), newline);
                 color(normal);
               continue;
             }
-            if (blockdevice[fileloop]) writefile = false;
+            if (blockdevice[fileloop]) check->writefile = false;
         }
         
         #ifdef WIN32
-            fpfilesize = getfilesize(fp);
-            if (fpfilesize == -1) continue;
-            if (debug) printf("fpfilesize: %"LL"d%s", fpfilesize, newline);
+            check->fpfilesize = getfilesize(check->fp);
+            if (check->fpfilesize == -1) continue;
+            if (debug) printf("fpfilesize: %"LL"d%s", check->fpfilesize, newline);
         #else
             if (blockdevice[fileloop]) {
-                if (opendevice(isofilename, "Getting media size") != 0) continue;
-                fpfilesize = getdisccapacity(true, true);
-                if (fpfilesize == -1) {
+                if (opendevice(check->isofilename, "Getting media size") != 0) continue;
+                check->fpfilesize = getdisccapacity(true, true);
+                if (check->fpfilesize == -1) {
                     close(fd);
                   continue;
                 }
-                if (debug) printf("fpfilesize: %"LL"d%s", fpfilesize, newline);
+                if (debug) printf("fpfilesize: %"LL"d%s", check->fpfilesize, newline);
             }
             else {
-                fpfilesize = getfilesize(fp);
-                if (fpfilesize == -1) continue;
-                if (debug) printf("fpfilesize: %"LL"d%s", fpfilesize, newline);
-            }
+                check->fpfilesize = getfilesize(check->fp);
+                if (check->fpfilesize == -1) continue;
+                if (debug) printf("fpfilesize: %"LL"d%s", check->fpfilesize, newline);
+            }
+            // O_DIRECT only pays off for discs and disks, image files are better off in the page cache
+            check->readsettings.queuedepth = queuedepth;
+            check->readsettings.iouring = iouring;
+            check->readsettings.direct = odirect && blockdevice[fileloop];
         #endif
         
         if (truncatefile) {
@@ -4700,16 +5249,16 @@ int main(int argc, char *argv[]) {
             if (strncasecmp(argv[truncatearg], "0x", 2) == 0) truncatesize = strtoll(argv[truncatearg], NULL, 16);
             else truncatesize = strtoll(argv[truncatearg], NULL, 10);
             if (truncatesize > 0) {
-                if (writefile) {
-                    if (dotruncate(isofilename, fpfilesize, truncatesize, false) != 0) continue;
+                if (check->writefile) {
+                    if (dotruncate(check->isofilename, check->fpfilesize, truncatesize, false) != 0) continue;
                     if (verbose) printf("%s", newline);
                     // get the new filesize
-                    fpfilesize = getfilesize(fp);
-                    if (fpfilesize == -1) continue;  // seek error
+                    check->fpfilesize = getfilesize(check->fp);
+                    if (check->fpfilesize == -1) continue;  // seek error
                 }
                 else {
                     color(yellow);
-                    if (truncatesize < fpfilesize) printf("Truncating file was aborted because writing is disabled%s", newline);
+                    if (truncatesize < check->fpfilesize) printf("Truncating file was aborted because writing is disabled%s", newline);
                     else printf("Extending file was aborted because writing is disabled%s", newline);
                     color(normal);
                     if (verbose) printf("%s", newline);
@@ -4717,36 +5266,43 @@ int main(int argc, char *argv[]) {
             }
         }
         
-        if (fpfilesize < 2048LL) {
+        if (check->fpfilesize < 2048LL) {
             color(yellow);
-            if (filecount > 1) printf("ERROR: filesize is only %"LL"d bytes (too small to be an Xbox 360 ISO or stealth file)%s", fpfilesize, newline);
-            else printf("ERROR: %s is only %"LL"d bytes (too small to be an Xbox 360 ISO or stealth file)%s", isofilename, fpfilesize, newline);
+            if (filecount > 1) printf("ERROR: filesize is only %"LL"d bytes (too small to be an Xbox 360 ISO or stealth file)%s", check->fpfilesize, newline);
+            else printf("ERROR: %s is only %"LL"d bytes (too small to be an Xbox 360 ISO or stealth file)%s", check->isofilename, check->fpfilesize, newline);
             color(normal);
           continue;
         }
         
+        #ifndef WIN32
+            if (reverify) {
+                doreverify();
+              continue;
+            }
+        #endif
+        
         // check to see if it's an spa
-        if (strlen(isofilename) > 4 && strncasecmp(isofilename+strlen(isofilename)-4, ".spa", 4) == 0) {
+        if (strlen(check->isofilename) > 4 && strncasecmp(check->isofilename+strlen(check->isofilename)-4, ".spa", 4) == 0) {
             initcheckread();
-            memset(ubuffer, 0, 2048);
-            if (checkreadandprinterrors(ubuffer, 1, 2048, fp, 0, 0, isofilename, "Checking .spa file") != 0) continue;
-            donecheckread(isofilename);
+            memset(check->ubuffer, 0, 2048);
+            if (checkreadandprinterrors(check->ubuffer, 1, 2048, check->fp, 0, 0, check->isofilename, "Checking .spa file") != 0) continue;
+            donecheckread(check->isofilename);
             // look for spa magic bytes
-            if (memcmp(ubuffer, "XDBF", 4) != 0) {
+            if (memcmp(check->ubuffer, "XDBF", 4) != 0) {
                 color(red);
                 printf("ERROR: %sXDBF%s magic was not found at the start of .spa file %s%s%s!%s",
-                        quotation, quotation, quotation, isofilename, quotation, newline);
+                        quotation, quotation, quotation, check->isofilename, quotation, newline);
                 color(normal);
               continue;
             }
-            if (fpfilesize > WOW_THATS_A_LOT_OF_RAM) {
+            if (check->fpfilesize > WOW_THATS_A_LOT_OF_RAM) {
                 if (debug) {
                     color(yellow);
-                    printf("fpfilesize (%"LL"d) is greater than WOW_THATS_A_LOT_OF_RAM (%d)%s", fpfilesize, WOW_THATS_A_LOT_OF_RAM, newline);
+                    printf("fpfilesize (%"LL"d) is greater than WOW_THATS_A_LOT_OF_RAM (%d)%s", check->fpfilesize, WOW_THATS_A_LOT_OF_RAM, newline);
                     color(normal);
                 }
                 fprintf(stderr, "Warning: Checking this SPA file will require %.1f MBs of RAM...\n",
-                                (float) fpfilesize/1048576);
+                                (float) check->fpfilesize/1048576);
                 char response[4];
                 memset(response, 0, 4);
                 while (response[0] != 'y' && response[0] != 'n' && response[0] != 'Y' && response[0] != 'N') {
@@ -4759,7 +5315,7 @@ int main(int argc, char *argv[]) {
                   continue;
                 }
             }
-            unsigned char *resourcebuffer = malloc(fpfilesize * sizeof(char));
+            unsigned char *resourcebuffer = malloc(check->fpfilesize * sizeof(char));
             if (resourcebuffer == NULL) {
                 color(red);
                 printf("ERROR: Memory allocation for resourcebuffer failed! Game over man... Game over!%s", newline);
@@ -4767,90 +5323,56 @@ int main(int argc, char *argv[]) {
               exit(1);
             }
             // seek back to start of the file
-            if (fseeko(fp, 0, SEEK_SET) != 0) {
-                printseekerror(isofilename, "Checking .spa file");
+            if (fseeko(check->fp, 0, SEEK_SET) != 0) {
+                printseekerror(check->isofilename, "Checking .spa file");
                 free(resourcebuffer);
               continue;
             }
             // read the entire .spa file into the buffer
             initcheckread();
-            if (checkreadandprinterrors(resourcebuffer, 1, fpfilesize, fp, 0, 0, isofilename, "Checking .spa file") != 0) {
+            if (checkreadandprinterrors(resourcebuffer, 1, check->fpfilesize, check->fp, 0, 0, check->isofilename, "Checking .spa file") != 0) {
                 free(resourcebuffer);
               continue;
             }
-            donecheckread(isofilename);
+            donecheckread(check->isofilename);
             if (debug) {
                 printf(".spa file 1st sector:%s", newline);
                 hexdump(resourcebuffer, 0, 2048);
             }
             // check it
             if (verbose) printf("Checking SPA%s", newline);
-            parsetitleidresource(resourcebuffer, fpfilesize);
+            parsetitleidresource(resourcebuffer, check->fpfilesize);
             free(resourcebuffer);
           continue;
         }
         
         // check to see if it's an xex
-        if (strlen(isofilename) > 4 && strncasecmp(isofilename+strlen(isofilename)-4, ".xex", 4) == 0) {
+        if (strlen(check->isofilename) > 4 && strncasecmp(check->isofilename+strlen(check->isofilename)-4, ".xex", 4) == 0) {
             initcheckread();
-            memset(ubuffer, 0, 2048);
-            if (checkreadandprinterrors(ubuffer, 1, 2048, fp, 0, 0, isofilename, "Checking .xex file") != 0) continue;
-            donecheckread(isofilename);
+            memset(check->ubuffer, 0, 2048);
+            if (checkreadandprinterrors(check->ubuffer, 1, 2048, check->fp, 0, 0, check->isofilename, "Checking .xex file") != 0) continue;
+            donecheckread(check->isofilename);
             // look for XEX magic bytes
-            if (memcmp(ubuffer, "XEX2", 4) != 0) {
+            if (memcmp(check->ubuffer, "XEX2", 4) != 0) {
                 color(red);
                 printf("ERROR: %sXEX2%s magic was not found at the start of .xex file %s%s%s!%s",
-                        quotation, quotation, quotation, isofilename, quotation, newline);
-                color(normal);
-              continue;
-            }
-            if (fpfilesize > WOW_THATS_A_LOT_OF_RAM) {
-                if (debug) {
-                    color(yellow);
-                    printf("fpfilesize (%"LL"d) is greater than WOW_THATS_A_LOT_OF_RAM (%d)%s", fpfilesize, WOW_THATS_A_LOT_OF_RAM, newline);
-                    color(normal);
-                }
-                fprintf(stderr, "Warning: Checking this Xex file will require %.1f MBs of RAM...\n",
-                                (float) fpfilesize/1048576);
-                char response[4];
-                memset(response, 0, 4);
-                while (response[0] != 'y' && response[0] != 'n' && response[0] != 'Y' && response[0] != 'N') {
-                    fprintf(stderr, "Do you want to continue? (y/n) ");
-                    readstdin(response, 4);
-                    if (debug) printf("response[0] = %c (0x%02X)%s", response[0], response[0], newline);
-                }
-                if (response[0] == 'n' || response[0] == 'N') {
-                    printf("Xex check was aborted as requested%s", newline);
-                  continue;
-                }
-            }
-            unsigned char *defaultxexbuffer = malloc(fpfilesize * sizeof(char));
-            if (defaultxexbuffer == NULL) {
-                color(red);
-                printf("ERROR: Memory allocation for defaultxexbuffer failed! Game over man... Game over!%s", newline);
+                        quotation, quotation, quotation, check->isofilename, quotation, newline);
                 color(normal);
-              exit(1);
-            }
-            // seek back to start of the file
-            if (fseeko(fp, 0, SEEK_SET) != 0) {
-                printseekerror(isofilename, "Checking .xex file");
-                free(defaultxexbuffer);
               continue;
             }
-            // read the entire .xex file into the buffer
+            // only the header is read in here, checkdefaultxex() reads the rest a window at a time
             initcheckread();
-            if (checkreadandprinterrors(defaultxexbuffer, 1, fpfilesize, fp, 0, 0, isofilename, "Checking .xex file") != 0) {
-                free(defaultxexbuffer);
-              continue;
-            }
-            donecheckread(isofilename);
+            unsigned char *defaultxexbuffer = readxexheader(check->ubuffer, (unsigned long) check->fpfilesize, check->fp, 0,
+                                                            check->isofilename, "Checking .xex file");
+            if (defaultxexbuffer == NULL) continue;
             if (debug) {
                 printf(".xex file 1st sector:%s", newline);
                 hexdump(defaultxexbuffer, 0, 2048);
             }
             // check it
             if (verbose) printf("Checking XEX%s", newline);
-            if (checkdefaultxex(defaultxexbuffer, fpfilesize) != 0) {
+            if (checkdefaultxex(defaultxexbuffer, (unsigned long) check->fpfilesize, check->fp, 0,
+                                check->isofilename, "Checking .xex file") != 0) {
                 free(defaultxexbuffer);
               continue;
             }
@@ -4859,84 +5381,84 @@ int main(int argc, char *argv[]) {
         }
         
         // ss and stealth files are 2 KB
-        if (fpfilesize == 2048LL) {
+        if (check->fpfilesize == 2048LL) {
             // auto detect if this is dmi, pfi or ss
             initcheckread();
-            memset(ubuffer, 0, 2048);
-            if (checkreadandprinterrors(ubuffer, 1, 2048, fp, 0, 0, isofilename, "Checking 2KB file") != 0) continue;
-            donecheckread(isofilename);
-            if (getzeros(ubuffer, 0, 2047) == 2048) {
-                color(yellow); printf("ERROR: %s is blank!%s", isofilename, newline); color(normal);
+            memset(check->ubuffer, 0, 2048);
+            if (checkreadandprinterrors(check->ubuffer, 1, 2048, check->fp, 0, 0, check->isofilename, "Checking 2KB file") != 0) continue;
+            donecheckread(check->isofilename);
+            if (zeroscan_allzeros(check->ubuffer, 2048)) {
+                color(yellow); printf("ERROR: %s is blank!%s", check->isofilename, newline); color(normal);
               continue;
             }
-            else if (lookslike360dmi(ubuffer) || lookslikexbox1dmi(ubuffer)) {
-                justastealthfile = true;
-                checkdmi(ubuffer);
+            else if (lookslike360dmi(check->ubuffer) || lookslikexbox1dmi(check->ubuffer)) {
+                check->justastealthfile = true;
+                checkdmi(check->ubuffer);
             }
-            else if (lookslikepfi(ubuffer)) {
-                justastealthfile = true;
-                checkpfi(ubuffer);
+            else if (lookslikepfi(check->ubuffer)) {
+                check->justastealthfile = true;
+                checkpfi(check->ubuffer);
             }
-            else if (lookslike360ss(ubuffer) || lookslikexbox1ss(ubuffer)) {
-                checkssbin = true;
-                memcpy(ss, ubuffer, 2048);
+            else if (lookslike360ss(check->ubuffer) || lookslikexbox1ss(check->ubuffer)) {
+                check->checkssbin = true;
+                memcpy(check->ss, check->ubuffer, 2048);
                 if (filecount > 1 && verbose) printf("%s", newline);
                 checkss();
-                if (fixedss) {
+                if (check->fixedss) {
                     if (verbose) printf("%s", newline);
-                    printf("Writing adjusted SS values to %s%s", isofilename, newline);
-                    fp = freopen(isofilename, "rb+", fp);
-                    if (fp == NULL) {
+                    printf("Writing adjusted SS values to %s%s", check->isofilename, newline);
+                    check->fp = freopen(check->isofilename, "rb+", check->fp);
+                    if (check->fp == NULL) {
                         color(red);
-                        printf("ERROR: Failed to reopen %s for writing! (%s) Unable to permanently adjust SS values!%s", isofilename, strerror(errno), newline);
+                        printf("ERROR: Failed to reopen %s for writing! (%s) Unable to permanently adjust SS values!%s", check->isofilename, strerror(errno), newline);
                         color(normal);
                       continue;
                     }
-                    if (trytowritestealthfile(ss, 1, 2048, fp, isofilename, 0) != 0) continue;
+                    if (trytowritestealthfile(check->ss, 1, 2048, check->fp, check->isofilename, 0) != 0) continue;
                 }
             }
             else {
                 color(yellow);
                 if (filecount > 1) printf("ERROR: filesize is 2KB but isn't recognized as DMI, PFI or SS!%s", newline);
-                else printf("ERROR: %s is 2KB but isn't recognized as DMI, PFI or SS!%s", isofilename, newline);
+                else printf("ERROR: %s is 2KB but isn't recognized as DMI, PFI or SS!%s", check->isofilename, newline);
                 color(normal);
                 if (verbose) {
                     printf("Displaying suspicious file in hex and ascii:%s", newline);
-                    hexdump(ubuffer, 0, 2048);
+                    hexdump(check->ubuffer, 0, 2048);
                 }
               continue;
             }
           continue;
         }
         
-        if (fpfilesize < 34816LL) {  // 34 KB (prevent EOF when trying to read possible video file)
+        if (check->fpfilesize < 34816LL) {  // 34 KB (prevent EOF when trying to read possible video file)
             color(yellow);
             if (filecount > 1) printf("ERROR: file isn't recognized as an XBOX 360 ISO or Stealth file!%s", newline);
-            else printf("ERROR: %s isn't recognized as an XBOX 360 ISO or Stealth file!%s", isofilename, newline);
+            else printf("ERROR: %s isn't recognized as an XBOX 360 ISO or Stealth file!%s", check->isofilename, newline);
             color(normal);
           continue;
         }
         
-        if (fpfilesize <= 265873408LL) {
+        if (check->fpfilesize <= 265873408LL) {
             // this is the maximum size of a video partition with padding data (pre-ap25 size so that older full XGD2 video partition rips will be detected)
             // check to see if this is a video file by seeking to sector 16 and looking for magic bytes
-            if (fseeko(fp, 32768, SEEK_SET) != 0) {
-                printseekerror(isofilename, "File identification check");
+            if (fseeko(check->fp, 32768, SEEK_SET) != 0) {
+                printseekerror(check->isofilename, "File identification check");
               continue;
             }
-            memset(buffer, 0, 2048);
+            memset(check->buffer, 0, 2048);
             initcheckread();
-            if (checkreadandprinterrors(buffer, 1, 2048, fp, 0, 32768, isofilename, "File identification check") != 0) continue;
-            donecheckread(isofilename);
-            if (memcmp(buffer+1, "CD001", 5) == 0) {
+            if (checkreadandprinterrors(check->buffer, 1, 2048, check->fp, 0, 32768, check->isofilename, "File identification check") != 0) continue;
+            donecheckread(check->isofilename);
+            if (memcmp(check->buffer+1, "CD001", 5) == 0) {
                 if (filecount > 1 && verbose) printf("%s", newline);
-                checkvideo(isofilename, fp, true, checkpadding);
+                checkvideo(check->isofilename, check->fp, true, checkpadding);
               continue;
             }
             else {
                 color(yellow);
                 if (filecount > 1) printf("ERROR: file isn't recognized as an XBOX 360 ISO or Stealth file!%s", newline);
-                else printf("ERROR: %s isn't recognized as an XBOX 360 ISO or Stealth file!%s", isofilename, newline);
+                else printf("ERROR: %s isn't recognized as an XBOX 360 ISO or Stealth file!%s", check->isofilename, newline);
                 color(normal);
               continue;
             }
@@ -4944,105 +5466,105 @@ int main(int argc, char *argv[]) {
         
         // make sure we will be able to read sector 32 in the game partition
         // (any game [xgd2/xgd3 with or without video] should be at least this big)
-        if (fpfilesize < 0xFDA0800LL /* 0xFD90000 (largest current video offset [xgd2]) + 33*2048 (to make sure we can read sector 32) */) {
+        if (check->fpfilesize < 0xFDA0800LL /* 0xFD90000 (largest current video offset [xgd2]) + 33*2048 (to make sure we can read sector 32) */) {
             color(yellow);
             if (filecount > 1) printf("ERROR: file isn't recognized as an XBOX 360 ISO or Stealth file!%s", newline);
-            else printf("ERROR: %s isn't recognized as an XBOX 360 ISO or Stealth file!%s", isofilename, newline);
+            else printf("ERROR: %s isn't recognized as an XBOX 360 ISO or Stealth file!%s", check->isofilename, newline);
             color(normal);
           continue;
         }
         // check to see if this is an xbox 360 iso by looking for magic bytes at sector 32
-        if (fseeko(fp, 65536, SEEK_SET) != 0) {
-            printseekerror(isofilename, "ISO check");
+        if (fseeko(check->fp, 65536, SEEK_SET) != 0) {
+            printseekerror(check->isofilename, "ISO check");
           continue;
         }
-        video = 0LL;
-        memset(ubuffer, 0, 2048);
+        check->video = 0LL;
+        memset(check->ubuffer, 0, 2048);
         initcheckread();
-        if (checkreadandprinterrors(ubuffer, 1, 2048, fp, 0, 65536LL, isofilename, "Reading Sector 32") != 0) continue;
-        donecheckread(isofilename);
+        if (checkreadandprinterrors(check->ubuffer, 1, 2048, check->fp, 0, 65536LL, check->isofilename, "Reading Sector 32") != 0) continue;
+        donecheckread(check->isofilename);
         if (debug) {
             printf("sector 32:%s", newline);
-            hexdump(ubuffer, 0, 2048);
+            hexdump(check->ubuffer, 0, 2048);
         }
-        if (memcmp(ubuffer, "MICROSOFT*XBOX*MEDIA", 20) != 0) {
+        if (memcmp(check->ubuffer, "MICROSOFT*XBOX*MEDIA", 20) != 0) {
             // proper backups should have the game partition starting at 0xFD90000 (XGD2) or 0x2080000 (XGD3)
-            video = 0xFD90000LL;
+            check->video = 0xFD90000LL;
             // read sector 32 + video
-            if (fseeko(fp, 65536+video, SEEK_SET) != 0) {
-                printseekerror(isofilename, "ISO check");
+            if (fseeko(check->fp, 65536+check->video, SEEK_SET) != 0) {
+                printseekerror(check->isofilename, "ISO check");
               continue;
             }
-            memset(ubuffer, 0, 2048);
+            memset(check->ubuffer, 0, 2048);
             initcheckread();
-            if (checkreadandprinterrors(ubuffer, 1, 2048, fp, 0, video+65536LL, isofilename, "Reading Sector 32") != 0) continue;
-            donecheckread(isofilename);
+            if (checkreadandprinterrors(check->ubuffer, 1, 2048, check->fp, 0, check->video+65536LL, check->isofilename, "Reading Sector 32") != 0) continue;
+            donecheckread(check->isofilename);
             if (debug) {
-                printf("sector 32 + video (%"LL"d):%s", video, newline);
-                hexdump(ubuffer, 0, 2048);
+                printf("sector 32 + video (%"LL"d):%s", check->video, newline);
+                hexdump(check->ubuffer, 0, 2048);
             }
-            if (memcmp(ubuffer, "MICROSOFT*XBOX*MEDIA", 20) != 0) {
-                video = 0x2080000LL;
+            if (memcmp(check->ubuffer, "MICROSOFT*XBOX*MEDIA", 20) != 0) {
+                check->video = 0x2080000LL;
                 // read sector 32 + video
-                if (fseeko(fp, 65536+video, SEEK_SET) != 0) {
-                    printseekerror(isofilename, "ISO check");
+                if (fseeko(check->fp, 65536+check->video, SEEK_SET) != 0) {
+                    printseekerror(check->isofilename, "ISO check");
                   continue;
                 }
-                memset(ubuffer, 0, 2048);
+                memset(check->ubuffer, 0, 2048);
                 initcheckread();
-                if (checkreadandprinterrors(ubuffer, 1, 2048, fp, 0, video+65536LL, isofilename, "Reading Sector 32") != 0) continue;
-                donecheckread(isofilename);
+                if (checkreadandprinterrors(check->ubuffer, 1, 2048, check->fp, 0, check->video+65536LL, check->isofilename, "Reading Sector 32") != 0) continue;
+                donecheckread(check->isofilename);
                 if (debug) {
-                    printf("sector 32 + video (%"LL"d):%s", video, newline);
-                    hexdump(ubuffer, 0, 2048);
+                    printf("sector 32 + video (%"LL"d):%s", check->video, newline);
+                    hexdump(check->ubuffer, 0, 2048);
                 }
-                if (memcmp(ubuffer, "MICROSOFT*XBOX*MEDIA", 20) != 0) {
+                if (memcmp(check->ubuffer, "MICROSOFT*XBOX*MEDIA", 20) != 0) {
                     // should have found this string by now
                     color(yellow);
                     if (filecount > 1) printf("ERROR: file isn't recognized as an XBOX 360 ISO or Stealth file!%s", newline);
-                    else printf("ERROR: %s isn't recognized as an XBOX 360 ISO or Stealth file!%s", isofilename, newline);
+                    else printf("ERROR: %s isn't recognized as an XBOX 360 ISO or Stealth file!%s", check->isofilename, newline);
                     color(normal);
                   continue;
                 }
-                else xgd3 = true;
+                else check->xgd3 = true;
             }
         }
         
         // get layerbreak from the alternate PFI in the SS
         // if the SS doesn't exist/isn't valid or if altpfi_endpsnL0 is less than 0x30000 or if altpfi_startpsnL0
         // doesn't correspond to the video offset, assume the layerbreak based solely on the video offset
-        layerbreak = -1;
-        if (video != 0) {
-            if (fseeko(fp, video - (xgd3 ? 0x8800 : 0x800), SEEK_SET) != 0) {
-                printseekerror(isofilename, "Checking alternate PFI");
+        check->layerbreak = -1;
+        if (check->video != 0) {
+            if (fseeko(check->fp, check->video - (check->xgd3 ? 0x8800 : 0x800), SEEK_SET) != 0) {
+                printseekerror(check->isofilename, "Checking alternate PFI");
               continue;
             }
-            memset(ubuffer, 0, 2048);
+            memset(check->ubuffer, 0, 2048);
             initcheckread();
-            if (checkreadandprinterrors(ubuffer, 1, 2048, fp, 0, video - (xgd3 ? 0x8800 : 0x800), isofilename, "Checking alternate PFI") != 0) continue;
-            donecheckread(isofilename);
-            if (lookslike360ss(ubuffer)) {
+            if (checkreadandprinterrors(check->ubuffer, 1, 2048, check->fp, 0, check->video - (check->xgd3 ? 0x8800 : 0x800), check->isofilename, "Checking alternate PFI") != 0) continue;
+            donecheckread(check->isofilename);
+            if (lookslike360ss(check->ubuffer)) {
                 // get End PSN of L0 Data Area
-                unsigned char altpfi_endpsnL0hex[4] = {ubuffer[15], ubuffer[14], ubuffer[13], 0x00};
+                unsigned char altpfi_endpsnL0hex[4] = {check->ubuffer[15], check->ubuffer[14], check->ubuffer[13], 0x00};
                 unsigned long altpfi_endpsnL0 = getuint(altpfi_endpsnL0hex);
                 // get Start PSN of L0 Data Area to check that it corresponds to the video offset
-                unsigned char altpfi_startpsnL0hex[4] = {ubuffer[7], ubuffer[6], ubuffer[5], 0x00};
+                unsigned char altpfi_startpsnL0hex[4] = {check->ubuffer[7], check->ubuffer[6], check->ubuffer[5], 0x00};
                 unsigned long altpfi_startpsnL0 = getuint(altpfi_startpsnL0hex);
                 if (debug) printf("about to take the layerbreak from the SS if these values are acceptable:%s"
                                   "altpfi_endpsnL0 = 0x%lX, altpfi_startpsnL0 = 0x%lX%s", newline, altpfi_endpsnL0, altpfi_startpsnL0, newline);
-                if (altpfi_endpsnL0 >= 0x30000 && altpfi_startpsnL0 >= 0x30000 && ((altpfi_startpsnL0 - 0x30000) * 2048 == video)) {
-                    layerbreak = (long) altpfi_endpsnL0 - 0x30000 + 1;
-                    if (debug) printf("layerbreak (%ld) taken from SS altpfi_endpsnL0 (0x%lX)%s", layerbreak, altpfi_endpsnL0, newline);
+                if (altpfi_endpsnL0 >= 0x30000 && altpfi_startpsnL0 >= 0x30000 && ((altpfi_startpsnL0 - 0x30000) * 2048 == check->video)) {
+                    check->layerbreak = (long) altpfi_endpsnL0 - 0x30000 + 1;
+                    if (debug) printf("layerbreak (%ld) taken from SS altpfi_endpsnL0 (0x%lX)%s", check->layerbreak, altpfi_endpsnL0, newline);
                 }
             }
             else if (debug) {
-                printf("the sector at video - 0x%X does not look like Xbox 360 SS:%s", (xgd3 ? 0x8800 : 0x800), newline);
-                hexdump(ubuffer, 0, 2048);
+                printf("the sector at video - 0x%X does not look like Xbox 360 SS:%s", (check->xgd3 ? 0x8800 : 0x800), newline);
+                hexdump(check->ubuffer, 0, 2048);
             }
-            if (layerbreak == -1) {
-                if      (video == 0xFD90000LL) layerbreak = 1913760;  // XGD2
-                else                           layerbreak = 2133520;  // XGD3 or unknown (we shouldn't get here though if video isn't either 0xFD90000 or 0x2080000)
-                if (debug) printf("layerbreak (%ld) assumed based on video offset (0x%"LL"X)%s", layerbreak, video, newline);
+            if (check->layerbreak == -1) {
+                if      (check->video == 0xFD90000LL) check->layerbreak = 1913760;  // XGD2
+                else                           check->layerbreak = 2133520;  // XGD3 or unknown (we shouldn't get here though if video isn't either 0xFD90000 or 0x2080000)
+                if (debug) printf("layerbreak (%ld) assumed based on video offset (0x%"LL"X)%s", check->layerbreak, check->video, newline);
             }
             #ifndef WIN32
                 if (blockdevice[fileloop]) {
@@ -5053,10 +5575,10 @@ int main(int argc, char *argv[]) {
         }
         
         if (checkdvdfile) {
-            if (video == 0) {
+            if (check->video == 0) {
                 if (!stealthcheck) {  // avoid redundant message when checking stealth
                     color(yellow);
-                    printf("ERROR: %s is just a game partition, don't burn it unless you want a coaster! (.dvd file check aborted)%s%s", isofilename, newline, newline);
+                    printf("ERROR: %s is just a game partition, don't burn it unless you want a coaster! (.dvd file check aborted)%s%s", check->isofilename, newline, newline);
                     color(normal);
                 }
             }
@@ -5072,9 +5594,9 @@ int main(int argc, char *argv[]) {
         #endif
         
         if (manualextract) {
-            if (video == 0) {
+            if (check->video == 0) {
                 color(yellow);
-                printf("ERROR: %s is just a game partition (no stealth files to extract)%s%s", isofilename, newline, newline);
+                printf("ERROR: %s is just a game partition (no stealth files to extract)%s%s", check->isofilename, newline, newline);
                 color(normal);
             }
             else domanualextraction(argv);
@@ -5082,24 +5604,24 @@ int main(int argc, char *argv[]) {
         
         checkgame();
         
-        if (layerbreak == -1) {
+        if (check->layerbreak == -1) {
             // this must have been just a game partition, so assume the layerbreak based on the existence of the disc
             // profile id so that we can properly parse offsets for pfi/alt pfi that will (hopefully) get patched later
             // we also need the layerbreak to be able to check/fix the .dvd file after the iso is rebuilt
             // note that if the xex was not found, layerbreak will default to the possibly incorrect value of 1913760
             // (but autofix will abort anyway if we didn't get the xex crc)
-            if (xgd3) layerbreak = 2133520;
-            else      layerbreak = 1913760;
-            if (debug) printf("layerbreak (%ld) assumed based on bool xgd3 (%s)%s", layerbreak, (xgd3 ? "true" : "false"), newline);
+            if (check->xgd3) check->layerbreak = 2133520;
+            else      check->layerbreak = 1913760;
+            if (debug) printf("layerbreak (%ld) assumed based on bool xgd3 (%s)%s", check->layerbreak, (check->xgd3 ? "true" : "false"), newline);
         }
         
         if (stealthcheck) {
             printf("%s", newline);
-            if (video == 0) {
+            if (check->video == 0) {
                 // means that "MICROSOFT*XBOX*MEDIA" was found at 0x10000
                 color(red);
                 printf("Stealth Failed!: Image is missing Video, PFI, DMI");
-                if (game_has_ap25) printf(", SS and topology data%s", newline);
+                if (check->game_has_ap25) printf(", SS and topology data%s", newline);
                 else               printf(" and SS%s", newline);
                 printf("%s %s (It's just a game partition and won't boot on ANY firmware!)%s", sp10, sp5, newline);
                 color(normal);
@@ -5118,7 +5640,7 @@ int main(int argc, char *argv[]) {
                     }
                 }
                 else if (manualpatch) domanualpatch(argv);
-                if (writefile && game_has_ap25 && (autofix || manualpatch)) {
+                if (check->writefile && check->game_has_ap25 && (autofix || manualpatch)) {
                     color(yellow);
                     printf("Note: You will need to run this ISO through abgx360 again in order to patch\n"
                            "topology data%s", newline);
@@ -5127,101 +5649,106 @@ int main(int argc, char *argv[]) {
               goto finishedstealthcheck;
             }
             
-            if (game_has_ap25) {
+            if (check->game_has_ap25) {
                 // check topology data
-                if (fseeko(fp, video - (xgd3 ? 0x10000 : 0x8000), SEEK_SET) != 0) {
-                    printseekerror(isofilename, "Stealth check");
+                if (fseeko(check->fp, check->video - (check->xgd3 ? 0x10000 : 0x8000), SEEK_SET) != 0) {
+                    printseekerror(check->isofilename, "Stealth check");
                   continue;
                 }
                 initcheckread();
-                if (checkreadandprinterrors(topology, 1, TOPOLOGY_SIZE, fp, 0, video - (xgd3 ? 0x10000 : 0x8000), isofilename,
+                if (checkreadandprinterrors(check->topology, 1, TOPOLOGY_SIZE, check->fp, 0, check->video - (check->xgd3 ? 0x10000 : 0x8000), check->isofilename,
                                             "Stealth check") != 0) continue;
-                donecheckread(isofilename);
+                donecheckread(check->isofilename);
                 checktopology();
-                if (fixedtopology) {
+                if (check->fixedtopology) {
                     if (verbose) printf("%s", newline);
                     printf("Writing fixed topology data to this ISO%s", newline);
-                    fp = freopen(isofilename, "rb+", fp);
-                    if (fp == NULL) {
+                    check->fp = freopen(check->isofilename, "rb+", check->fp);
+                    if (check->fp == NULL) {
                         color(red);
                         printf("ERROR: Failed to reopen %s%s%s for writing! (%s) Unable to fix topology data!%s",
-                               quotation, isofilename, quotation, strerror(errno), newline);
+                               quotation, check->isofilename, quotation, strerror(errno), newline);
                         color(normal);
-                        fp = fopen(isofilename, "rb");
-                        if (fp == NULL) {
+                        check->fp = fopen(check->isofilename, "rb");
+                        if (check->fp == NULL) {
                             color(red);
                             printf("ERROR: Failed to reopen %s%s%s for reading! (%s)%s",
-                                   quotation, isofilename, quotation, strerror(errno), newline);
+                                   quotation, check->isofilename, quotation, strerror(errno), newline);
                             color(normal);
                           continue;
                         }
                       continue;
                     }
-                    if (trytowritestealthfile(topology, 1, TOPOLOGY_SIZE, fp, isofilename, video - (xgd3 ? 0x10000 : 0x8000)) != 0) continue;
+                    if (trytowritestealthfile(check->topology, 1, TOPOLOGY_SIZE, check->fp, check->isofilename, check->video - (check->xgd3 ? 0x10000 : 0x8000)) != 0) continue;
                     color(green);
                     printf("Topology data was successfully fixed!%s", newline);
                     color(normal);
-                    topology_was_verified = true;
+                    check->topology_was_verified = true;
                 }
                 if (verbose) printf("%s", newline);
             }
             
             // check SS
-            if (fseeko(fp, video - (xgd3 ? 0x8800 : 0x800), SEEK_SET) != 0) {
-                printseekerror(isofilename, "Stealth check");
+            if (fseeko(check->fp, check->video - (check->xgd3 ? 0x8800 : 0x800), SEEK_SET) != 0) {
+                printseekerror(check->isofilename, "Stealth check");
               continue;
             }
             initcheckread();
-            if (checkreadandprinterrors(ss, 1, 2048, fp, 0, video - (xgd3 ? 0x8800 : 0x800), isofilename, "Stealth check") != 0) continue;
-            donecheckread(isofilename);
+            if (checkreadandprinterrors(check->ss, 1, 2048, check->fp, 0, check->video - (check->xgd3 ? 0x8800 : 0x800), check->isofilename, "Stealth check") != 0) continue;
+            donecheckread(check->isofilename);
             checkss();
-            if (ssv2) iso_has_ssv2 = true;
-            else iso_has_ssv2 = false;
-            if (fixedss) {
+            if (check->ssv2) check->iso_has_ssv2 = true;
+            else check->iso_has_ssv2 = false;
+            if (check->fixedss) {
                 if (verbose) printf("%s", newline);
-                printf("Writing adjusted SS values to %s%s", isofilename, newline);
-                fp = freopen(isofilename, "rb+", fp);
-                if (fp == NULL) {
+                printf("Writing adjusted SS values to %s%s", check->isofilename, newline);
+                check->fp = freopen(check->isofilename, "rb+", check->fp);
+                if (check->fp == NULL) {
                     color(red);
-                    printf("ERROR: Failed to reopen %s for writing! (%s) Unable to permanently adjust SS values!%s", isofilename, strerror(errno), newline);
+                    printf("ERROR: Failed to reopen %s for writing! (%s) Unable to permanently adjust SS values!%s", check->isofilename, strerror(errno), newline);
                     color(normal);
-                    fp = fopen(isofilename, "rb");
-                    if (fp == NULL) {
+                    check->fp = fopen(check->isofilename, "rb");
+                    if (check->fp == NULL) {
                         color(red);
-                        printf("ERROR: Failed to reopen %s for reading! (%s)%s", isofilename, strerror(errno), newline);
+                        printf("ERROR: Failed to reopen %s for reading! (%s)%s", check->isofilename, strerror(errno), newline);
                         color(normal);
                       continue;
                     }
                   continue;
                 }
-                if (trytowritestealthfile(ss, 1, 2048, fp, isofilename, video - (xgd3 ? 0x8800 : 0x800)) != 0) continue;
+                if (trytowritestealthfile(check->ss, 1, 2048, check->fp, check->isofilename, check->video - (check->xgd3 ? 0x8800 : 0x800)) != 0) continue;
             }
             
             // check DMI
-            if (fseeko(fp, video - (xgd3 ? 0x9000 : 0x1000), SEEK_SET) != 0) {
-                printseekerror(isofilename, "Stealth check");
+            if (fseeko(check->fp, check->video - (check->xgd3 ? 0x9000 : 0x1000), SEEK_SET) != 0) {
+                printseekerror(check->isofilename, "Stealth check");
               continue;
             }
             initcheckread();
-            if (checkreadandprinterrors(ubuffer, 1, 2048, fp, 0, video - (xgd3 ? 0x9000 : 0x1000), isofilename, "Stealth check") != 0) continue;
-            donecheckread(isofilename);
-            checkdmi(ubuffer);
+            if (checkreadandprinterrors(check->ubuffer, 1, 2048, check->fp, 0, check->video - (check->xgd3 ? 0x9000 : 0x1000), check->isofilename, "Stealth check") != 0) continue;
+            donecheckread(check->isofilename);
+            checkdmi(check->ubuffer);
             
             // check PFI
-            if (fseeko(fp, video - (xgd3 ? 0x9800 : 0x1800), SEEK_SET) != 0) {
-                printseekerror(isofilename, "Stealth check");
+            if (fseeko(check->fp, check->video - (check->xgd3 ? 0x9800 : 0x1800), SEEK_SET) != 0) {
+                printseekerror(check->isofilename, "Stealth check");
               continue;
             }
             initcheckread();
-            if (checkreadandprinterrors(ubuffer, 1, 2048, fp, 0, video - (xgd3 ? 0x9800 : 0x1800), isofilename, "Stealth check") != 0) continue;
-            donecheckread(isofilename);
-            checkpfi(ubuffer);
+            if (checkreadandprinterrors(check->ubuffer, 1, 2048, check->fp, 0, check->video - (check->xgd3 ? 0x9800 : 0x1800), check->isofilename, "Stealth check") != 0) continue;
+            donecheckread(check->isofilename);
+            checkpfi(check->ubuffer);
+            
+            #ifndef WIN32
+                // the SS and Xex CRCs are known, look up the verified inis while the Video and Game CRCs are computed
+                startprefetch();
+            #endif
             
             // check Video
             if (verbose) printf("%s", newline);
-            checkvideo(isofilename, fp, false, checkpadding);
+            checkvideo(check->isofilename, check->fp, false, checkpadding);
             
-            if (video_stealthfailed || pfi_stealthfailed || dmi_stealthfailed || ss_stealthfailed || stealthfailed) {
+            if (check->video_stealthfailed || check->pfi_stealthfailed || check->dmi_stealthfailed || check->ss_stealthfailed || check->stealthfailed) {
                 color(red);
                 printf("%sStealth check failed!%s", newline, newline);
                 color(normal);
@@ -5230,7 +5757,7 @@ int main(int argc, char *argv[]) {
                     if (returnvalue == 0) {
                         color(green);
                         printf("AutoFix was successful!%s", newline);
-                        if (game_has_ap25 && !topology_was_verified) {
+                        if (check->game_has_ap25 && !check->topology_was_verified) {
                             color(yellow);
                             printf("Note: Topology data was not verified%s", newline);
                         }
@@ -5245,24 +5772,24 @@ int main(int argc, char *argv[]) {
                 }
                 else if (manualpatch) domanualpatch(argv);
             }
-            else if (video_stealthuncertain || pfi_stealthuncertain || dmi_stealthuncertain || ss_stealthuncertain || stealthuncertain) {
+            else if (check->video_stealthuncertain || check->pfi_stealthuncertain || check->dmi_stealthuncertain || check->ss_stealthuncertain || check->stealthuncertain) {
                 color(yellow);
                 printf("%sStealth status is uncertain%s", newline, newline);
                 color(normal);
                 if (verify) {
                     returnvalue = doverify();
                     if (returnvalue == 0) {
-                        if (drtfucked) {
+                        if (check->drtfucked) {
                             color(yellow);
                             printf("Stealth and game data were verified but angle deviation cannot be verified%s", newline);
-                            if (game_has_ap25 && !topology_was_verified) {
+                            if (check->game_has_ap25 && !check->topology_was_verified) {
                                 printf("Note: Topology data wasn't verified either%s", newline);
                             }
                         }
                         else {
                             color(green);
                             printf("Verification was successful, Stealth passed!%s", newline);
-                            if (game_has_ap25 && !topology_was_verified) {
+                            if (check->game_has_ap25 && !check->topology_was_verified) {
                                 color(yellow);
                                 printf("Note: Topology data was not verified%s", newline);
                             }
@@ -5272,26 +5799,26 @@ int main(int argc, char *argv[]) {
                     else if (returnvalue == 2) {
                         color(yellow);
                         printf("Stealth was verified but game data wasn't%s", newline);
-                        if (drtfucked) printf("Angle deviation cannot be verified%s", newline);
-                        if (game_has_ap25 && !topology_was_verified) {
+                        if (check->drtfucked) printf("Angle deviation cannot be verified%s", newline);
+                        if (check->game_has_ap25 && !check->topology_was_verified) {
                             printf("Note: Topology data wasn't verified either%s", newline);
                         }
                         color(normal);
                     }
                     else {
-                        verifyfailed = true;
+                        check->verifyfailed = true;
                         color(yellow);
                         if (returnvalue == 3) printf("Game data was verified but stealth wasn't%s", newline);
                         printf("Verification failed%s", newline);
                         color(normal);
                     }
-                    if (verifyfailed || drtfucked) {
-                        if ((autofix && autofixuncertain) || (verify_found_bad_pfi_or_video && autofix)) {
+                    if (check->verifyfailed || check->drtfucked) {
+                        if ((autofix && autofixuncertain) || (check->verify_found_bad_pfi_or_video && autofix)) {
                             returnvalue = doautofix();
                             if (returnvalue == 0) {
                                 color(green);
                                 printf("AutoFix was successful!%s", newline);
-                                if (game_has_ap25 && !topology_was_verified) {
+                                if (check->game_has_ap25 && !check->topology_was_verified) {
                                     color(yellow);
                                     printf("Note: Topology data was not verified%s", newline);
                                 }
@@ -5319,7 +5846,7 @@ int main(int argc, char *argv[]) {
                     if (returnvalue == 0) {
                         color(green);
                         printf("Verification was successful!%s", newline);
-                        if (game_has_ap25 && !topology_was_verified) {
+                        if (check->game_has_ap25 && !check->topology_was_verified) {
                             color(yellow);
                             printf("Note: Topology data was not verified%s", newline);
                         }
@@ -5328,25 +5855,25 @@ int main(int argc, char *argv[]) {
                     else if (returnvalue == 2) {
                         color(yellow);
                         printf("Stealth was verified but game data wasn't%s", newline);
-                        if (game_has_ap25 && !topology_was_verified) {
+                        if (check->game_has_ap25 && !check->topology_was_verified) {
                             printf("Note: Topology data wasn't verified either%s", newline);
                         }
                         color(normal);
                     }
                     else {
-                        verifyfailed = true;
+                        check->verifyfailed = true;
                         color(yellow);
                         if (returnvalue == 3) printf("Game data was verified but stealth wasn't%s", newline);
                         printf("Verification failed%s", newline);
                         color(normal);
-                        if (verify_found_bad_pfi_or_video) {
+                        if (check->verify_found_bad_pfi_or_video) {
                             autoupload = false;  // should have been set to false already but it doesn't hurt to make sure
                             if (autofix) {
                                 returnvalue = doautofix();
                                 if (returnvalue == 0) {
                                     color(green);
                                     printf("AutoFix was successful!%s", newline);
-                                    if (game_has_ap25 && !topology_was_verified) {
+                                    if (check->game_has_ap25 && !check->topology_was_verified) {
                                         color(yellow);
                                         printf("Note: Topology data was not verified%s", newline);
                                     }
@@ -5366,12 +5893,12 @@ int main(int argc, char *argv[]) {
                                 if (manualpatch) domanualpatch(argv);
                             }
                         }
-                        else if (!autofixalways && !noxexiniavailable)
+                        else if (!autofixalways && !check->noxexiniavailable)
                             printf("%sSet AutoFix Threshold to Level 3 if you want to try and find a verified SS and%s"
                                    "Stealth files that match the Xex, and automatically patch them if found.%s",
                                    newline, newline, newline);
                         if (autoupload && !stayoffline && autouploaduserarg && autouploadpassarg) {
-                            if (fixedss) {
+                            if (check->fixedss) {
                                 color(red);
                                 printf("%sAutoUpload aborted because SS Challege / Response Data has been altered!%s"
                                        "DO NOT AutoUpload from this ISO! Delete it and rip again!%s%s",
@@ -5380,12 +5907,12 @@ int main(int argc, char *argv[]) {
                             }
                             else doautoupload(argv, false);
                         }
-                        if (!verify_found_bad_pfi_or_video && autofixalways) {
+                        if (!check->verify_found_bad_pfi_or_video && autofixalways) {
                             returnvalue = doautofix();
                             if (returnvalue == 0) {
                                 color(green);
                                 printf("AutoFix was successful!%s", newline);
-                                if (game_has_ap25 && !topology_was_verified) {
+                                if (check->game_has_ap25 && !check->topology_was_verified) {
                                     color(yellow);
                                     printf("Note: Topology data was not verified%s", newline);
                                 }
@@ -5401,14 +5928,14 @@ int main(int argc, char *argv[]) {
                         else if (manualpatch && patchifstealthpasses) domanualpatch(argv);
                     }
                     if ( (returnvalue == 0 || returnvalue == 2) &&
-                          autoupload && !stayoffline && autouploaduserarg && autouploadpassarg && iso_has_ssv2) {
+                          autoupload && !stayoffline && autouploaduserarg && autouploadpassarg && check->iso_has_ssv2) {
                         // autoupload an ssv2 even if stealth was verified and the existing ss in db is ssv1
                         printf("%sChecking to see if the existing SS file in the db is SSv1...%s", newline, newline);
                         if (valid_ssv2_exists_in_db()) {
                             if (verbose) printf("%s", newline);
                             printf("A valid SSv2 already exists in the db, no need to upload anything%s", newline);
                         }
-                        else if (fixedss) {
+                        else if (check->fixedss) {
                             color(red);
                             printf("%sAutoUpload aborted because SS Challege / Response Data has been altered!%s"
                                    "DO NOT AutoUpload from this ISO! Delete it and rip again!%s%s",
@@ -5418,23 +5945,23 @@ int main(int argc, char *argv[]) {
                         else if (!stayoffline) doautoupload(argv, true);  // true = upload_ss_only
                     }
                 }
-                else if (!verify_found_bad_pfi_or_video && manualpatch && patchifstealthpasses) domanualpatch(argv);
+                else if (!check->verify_found_bad_pfi_or_video && manualpatch && patchifstealthpasses) domanualpatch(argv);
             }
             finishedstealthcheck:
-            if (checkcorruption && game_crc32 == 0 && !checkgamecrcnever) {
+            if (checkcorruption && check->game_crc32 == 0 && !check->checkgamecrcnever) {
                 printf("%sChecking for AnyDVD style game data corruption while running CRC check...%s", newline, newline);
                 if (docheckgamecrc() == 0) {
-                    if (corruptionoffsetcount == 0) {
+                    if (check->corruptionoffsetcount == 0) {
                         color(green);
                         if (verbose) printf("%s", sp5);
                         printf("AnyDVD style corruption was not detected%s", newline);
                         color(normal);
                     }
-                    if (verbose) printf("%sGame CRC = %08lX%s%s", sp5, game_crc32, newline, newline);
+                    if (verbose) printf("%sGame CRC = %08lX%s%s", sp5, check->game_crc32, newline, newline);
                 }
                 else {
-                    checkgamecrcnever = true;
-                    if (!usercancelledgamecrc) gamecrcfailed = true;
+                    check->checkgamecrcnever = true;
+                    if (!check->usercancelledgamecrc) check->gamecrcfailed = true;
                 }
             }
         }
@@ -5442,6 +5969,8 @@ int main(int argc, char *argv[]) {
     #ifndef WIN32
         if (fileloop > 0 && blockdevice[fileloop-1]) resetdrivespeedifneeded();
         if (fd != -1) close(fd);
+        saveresultcache();
+        savemanifest();
     #endif
   return 0;
 }
@@ -5450,7 +5979,7 @@ int dotruncate(char *filename, long long filesize, long long truncatesize, bool
     char *action;
     if (truncatesize < filesize) action = "Truncating";
     else action = "Extending";
-    if (!writefile) {
+    if (!check->writefile) {
         color(yellow);
         printf("%s file aborted because writing is disabled%s", action, newline);
         color(normal);
@@ -5546,13 +6075,14 @@ unsigned long long assume_start_offset_of_L1_padding() {
     // this will allow us to check L1 padding even if ss is missing
     // todo: this will need to be updated if a new game partition start offset is used, and additional
     // measures will be needed if game partition size changes but an existing start offset is used
-    if (video == 0xFD90000LL) return 0x01C3610000LL;  // XGD2
-    if (video == 0x2080000LL) return 0x0206590000LL;  // XGD3
+    if (check->video == 0xFD90000LL) return 0x01C3610000LL;  // XGD2
+    if (check->video == 0x2080000LL) return 0x0206590000LL;  // XGD3
   return 0LL;  // calling functions should recognize this return value as invalid
 }
 
 void domanualextraction(char *argv[]) {
     unsigned long m;
+    int copyresult;
     char response[4];
     printf("Starting Manual Extraction%s", newline);
     if (extractvideoarg) {
@@ -5580,60 +6110,60 @@ void domanualextraction(char *argv[]) {
             }
         }
         // check pfi_sectorstotal to get the true size of video data
-        if (fseeko(fp, video - (xgd3 ? 0x9800 : 0x1800), SEEK_SET) != 0) {  // seek to pfi
-            printseekerror(isofilename, "Extracting Video");
+        if (fseeko(check->fp, check->video - (check->xgd3 ? 0x9800 : 0x1800), SEEK_SET) != 0) {  // seek to pfi
+            printseekerror(check->isofilename, "Extracting Video");
           goto endofextractvideo2;
         }
-        memset(ubuffer, 0, 2048);
+        memset(check->ubuffer, 0, 2048);
         initcheckread();
-        if (checkreadandprinterrors(ubuffer, 1, 2048, fp, 0, video - (xgd3 ? 0x9800 : 0x1800),
-                                    isofilename, "Extraction") != 0) goto endofextractvideo2;
-        donecheckread(isofilename);
-        if (getzeros(ubuffer, 0, 2047) == 2048) {
+        if (checkreadandprinterrors(check->ubuffer, 1, 2048, check->fp, 0, check->video - (check->xgd3 ? 0x9800 : 0x1800),
+                                    check->isofilename, "Extraction") != 0) goto endofextractvideo2;
+        donecheckread(check->isofilename);
+        if (zeroscan_allzeros(check->ubuffer, 2048)) {
             color(red);
             printf("PFI is blank! Unable to determine true Video size, Extracting Video aborted!%s", newline);
             color(normal);
           goto endofextractvideo2;
         }
         // get Starting PSN of Data Area
-        unsigned char pfi_startpsnL0hex[4] = {ubuffer[7], ubuffer[6], ubuffer[5], 0x00};
+        unsigned char pfi_startpsnL0hex[4] = {check->ubuffer[7], check->ubuffer[6], check->ubuffer[5], 0x00};
         unsigned long pfi_startpsnL0 = getuint(pfi_startpsnL0hex);
         // get End PSN of L0 Data Area
-        unsigned char pfi_endpsnL0hex[4] = {ubuffer[15], ubuffer[14], ubuffer[13], 0x00};
+        unsigned char pfi_endpsnL0hex[4] = {check->ubuffer[15], check->ubuffer[14], check->ubuffer[13], 0x00};
         unsigned long pfi_endpsnL0 = getuint(pfi_endpsnL0hex);
         // invert bits in End PSN of L0 Data Area to find Starting PSN of L1 Data Area
-        unsigned char pfi_startpsnL1hex[4] = {~ubuffer[15], ~ubuffer[14], ~ubuffer[13], 0x00};
+        unsigned char pfi_startpsnL1hex[4] = {~check->ubuffer[15], ~check->ubuffer[14], ~check->ubuffer[13], 0x00};
         unsigned long pfi_startpsnL1 = getuint(pfi_startpsnL1hex);
         // get End PSN of L1 Data Area
-        unsigned char pfi_endpsnL1hex[4] = {ubuffer[11], ubuffer[10], ubuffer[9], 0x00};
+        unsigned char pfi_endpsnL1hex[4] = {check->ubuffer[11], check->ubuffer[10], check->ubuffer[9], 0x00};
         unsigned long pfi_endpsnL1 = getuint(pfi_endpsnL1hex);
         // here be dragons
-        int32_t layerbreakpsn = ~((layerbreak - 1 + 0x030000) ^ 0xFF000000);
+        int32_t layerbreakpsn = ~((check->layerbreak - 1 + 0x030000) ^ 0xFF000000);
         unsigned long pfi_sectorsL0 = pfi_endpsnL0 - pfi_startpsnL0 + 1;
         unsigned long pfi_sectorsL1 = pfi_endpsnL1 - pfi_startpsnL1 + 1;
         unsigned long long pfi_offsetL0 = ((unsigned long long) pfi_startpsnL0 - 0x030000) * 2048;
-        unsigned long long pfi_offsetL1 = ((unsigned long long) pfi_startpsnL1 - (unsigned long long) layerbreakpsn) * 2048 + ((unsigned long long) layerbreak * 2048);
+        unsigned long long pfi_offsetL1 = ((unsigned long long) pfi_startpsnL1 - (unsigned long long) layerbreakpsn) * 2048 + ((unsigned long long) check->layerbreak * 2048);
         unsigned long long pfi_offsetL0end = (unsigned long long) (pfi_endpsnL0 - pfi_startpsnL0 + 1) * 2048 + pfi_offsetL0 - 1;
         unsigned long long pfi_offsetend = (unsigned long long) (pfi_endpsnL1 - pfi_startpsnL1 + 1) * 2048 + pfi_offsetL1 - 1;
         unsigned long pfi_sectorstotal = pfi_sectorsL0 + pfi_sectorsL1;
         // print that shit
         if (debug) printpfitable(pfi_startpsnL0, pfi_endpsnL0, pfi_startpsnL1, pfi_endpsnL1, pfi_sectorsL0, pfi_sectorsL1,
                                  pfi_offsetL0, pfi_offsetL0end, pfi_offsetL1, pfi_offsetend, pfi_sectorstotal);
-        if (pfi_offsetL0end >= video - (number_of_stealth_sectors+(xgd3 ? 16 : 0))*2048) {
+        if (pfi_offsetL0end >= check->video - (number_of_stealth_sectors+(check->xgd3 ? 16 : 0))*2048) {
             color(yellow);
             printf("PFI L0 Data Area overlaps Stealth sectors/game data! Extracting Video aborted!%s", newline);
             color(normal);
           goto endofextractvideo2;
         }
         // filesize should be at least [pfi_offsetL1 + pfi_sectorsL1*2048]
-        if ((unsigned long long) fpfilesize < pfi_offsetL1 + pfi_sectorsL1*2048) {
+        if ((unsigned long long) check->fpfilesize < pfi_offsetL1 + pfi_sectorsL1*2048) {
             color(yellow);
             printf("ISO size is too small to contain the L1 Video! Extracting Video aborted!%s", newline);
             color(normal);
           goto endofextractvideo2;
         }
         // open destination file for writing
-        extractvideofile = fopen(argv[extractvideoarg], "wb");
+        extractvideofile = openforwriting(argv[extractvideoarg]);
         if (extractvideofile == NULL) {
             color(red);
             printf("ERROR: Failed to open %s%s%s for writing! (%s) Extracting Video failed!%s",
@@ -5642,54 +6172,63 @@ void domanualextraction(char *argv[]) {
           goto endofextractvideo2;
         }
         // seek to the start of L0 Video and start extraction
-        if (fseeko(fp, 0, SEEK_SET) != 0) {
-            printseekerror(isofilename, "Extracting Video");
+        if (fseeko(check->fp, 0, SEEK_SET) != 0) {
+            printseekerror(check->isofilename, "Extracting Video");
           goto endofextractvideo;
         }
-        sizeoverbuffer = pfi_sectorsL0*2048 / BIGBUF_SIZE;
-        bufferremainder = pfi_sectorsL0*2048 % BIGBUF_SIZE;
+        check->sizeoverbuffer = pfi_sectorsL0*2048 / BIGBUF_SIZE;
+        check->bufferremainder = pfi_sectorsL0*2048 % BIGBUF_SIZE;
         initcheckread();
         initcheckwrite();
-        for (m=0; m<sizeoverbuffer; m++) {
-            if (checkreadandprinterrors(bigbuffer, 1, BIGBUF_SIZE, fp, m, 0,
-                                        isofilename, "Extraction") != 0)
+        // the loops below only run if the video couldn't be copied without going through bigbuffer
+        copyresult = copyfilerange(check->fp, check->isofilename, 0, extractvideofile, argv[extractvideoarg], 0,
+                                   (unsigned long long) pfi_sectorsL0*2048, "Extraction", false);
+        if (copyresult == 1) goto endofextractvideo;
+        if (copyresult == 0) check->sizeoverbuffer = check->bufferremainder = 0;
+        for (m=0; m<check->sizeoverbuffer; m++) {
+            if (checkreadandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, check->fp, m, 0,
+                                        check->isofilename, "Extraction") != 0)
                 goto endofextractvideo;
-            if (checkwriteandprinterrors(bigbuffer, 1, BIGBUF_SIZE, extractvideofile, m, 0,
+            if (checkwriteandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, extractvideofile, m, 0,
                                          argv[extractvideoarg], "Extraction") != 0)
                 goto endofextractvideo;
         }
-        if (bufferremainder) {
-            if (checkreadandprinterrors(bigbuffer, 1, bufferremainder, fp, 0, pfi_sectorsL0*2048 - bufferremainder,
-                                        isofilename, "Extraction") != 0)
+        if (check->bufferremainder) {
+            if (checkreadandprinterrors(check->bigbuffer, 1, check->bufferremainder, check->fp, 0, pfi_sectorsL0*2048 - check->bufferremainder,
+                                        check->isofilename, "Extraction") != 0)
                 goto endofextractvideo;
-            if (checkwriteandprinterrors(bigbuffer, 1, bufferremainder, extractvideofile, 0, pfi_sectorsL0*2048 - bufferremainder,
+            if (checkwriteandprinterrors(check->bigbuffer, 1, check->bufferremainder, extractvideofile, 0, pfi_sectorsL0*2048 - check->bufferremainder,
                                          argv[extractvideoarg], "Extraction") !=0)
                 goto endofextractvideo;
         }
         // seek to the start of L1 Video and continue extraction
-        if (fseeko(fp, pfi_offsetL1, SEEK_SET) != 0) {
-            printseekerror(isofilename, "Extracting Video");
+        if (fseeko(check->fp, pfi_offsetL1, SEEK_SET) != 0) {
+            printseekerror(check->isofilename, "Extracting Video");
           goto endofextractvideo;
         }
-        sizeoverbuffer = pfi_sectorsL1 * 2048 / BIGBUF_SIZE;
-        bufferremainder = pfi_sectorsL1 * 2048 % BIGBUF_SIZE;
-        for (m=0; m<sizeoverbuffer; m++) {
-            if (checkreadandprinterrors(bigbuffer, 1, BIGBUF_SIZE, fp, m, pfi_offsetL1,
-                                        isofilename, "Extraction") != 0)
+        check->sizeoverbuffer = pfi_sectorsL1 * 2048 / BIGBUF_SIZE;
+        check->bufferremainder = pfi_sectorsL1 * 2048 % BIGBUF_SIZE;
+        copyresult = copyfilerange(check->fp, check->isofilename, pfi_offsetL1, extractvideofile, argv[extractvideoarg],
+                                   (unsigned long long) pfi_sectorsL0*2048, (unsigned long long) pfi_sectorsL1*2048, "Extraction", false);
+        if (copyresult == 1) goto endofextractvideo;
+        if (copyresult == 0) check->sizeoverbuffer = check->bufferremainder = 0;
+        for (m=0; m<check->sizeoverbuffer; m++) {
+            if (checkreadandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, check->fp, m, pfi_offsetL1,
+                                        check->isofilename, "Extraction") != 0)
                 goto endofextractvideo;
-            if (checkwriteandprinterrors(bigbuffer, 1, BIGBUF_SIZE, extractvideofile, m, pfi_sectorsL0*2048,
+            if (checkwriteandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, extractvideofile, m, pfi_sectorsL0*2048,
                                          argv[extractvideoarg], "Extraction") != 0)
                 goto endofextractvideo;
         }
-        if (bufferremainder) {
-            if (checkreadandprinterrors(bigbuffer, 1, bufferremainder, fp, 0, pfi_offsetL1 + pfi_sectorsL1*2048 - bufferremainder,
-                                        isofilename, "Extraction") != 0)
+        if (check->bufferremainder) {
+            if (checkreadandprinterrors(check->bigbuffer, 1, check->bufferremainder, check->fp, 0, pfi_offsetL1 + pfi_sectorsL1*2048 - check->bufferremainder,
+                                        check->isofilename, "Extraction") != 0)
                 goto endofextractvideo;
-            if (checkwriteandprinterrors(bigbuffer, 1, bufferremainder, extractvideofile, 0, pfi_sectorstotal*2048 - bufferremainder,
+            if (checkwriteandprinterrors(check->bigbuffer, 1, check->bufferremainder, extractvideofile, 0, pfi_sectorstotal*2048 - check->bufferremainder,
                                          argv[extractvideoarg], "Extraction") !=0)
                 goto endofextractvideo;
         }
-        donecheckread(isofilename);
+        donecheckread(check->isofilename);
         donecheckwrite(argv[extractvideoarg]);
         color(green);
         printf("Extraction was successful%s", newline);
@@ -5726,7 +6265,7 @@ void domanualextraction(char *argv[]) {
             }
         }
         // ready to extract
-        extractpfifile = fopen(argv[extractpfiarg], "wb");
+        extractpfifile = openforwriting(argv[extractpfiarg]);
         if (extractpfifile == NULL) {
             color(red);
             printf("ERROR: Failed to open %s%s%s for writing! (%s) Extracting PFI failed!%s",
@@ -5734,16 +6273,16 @@ void domanualextraction(char *argv[]) {
             color(normal);
           goto endofextractpfi2;
         }
-        if (fseeko(fp, video - (xgd3 ? 0x9800 : 0x1800), SEEK_SET) != 0) {
-            printseekerror(isofilename, "Extracting PFI");
+        if (fseeko(check->fp, check->video - (check->xgd3 ? 0x9800 : 0x1800), SEEK_SET) != 0) {
+            printseekerror(check->isofilename, "Extracting PFI");
           goto endofextractpfi;
         }
-        memset(buffer, 0, 2048);
+        memset(check->buffer, 0, 2048);
         initcheckread();
-        if (checkreadandprinterrors(buffer, 1, 2048, fp, 0, video - (xgd3 ? 0x9800 : 0x1800),
-                                    isofilename, "Reading stealth file") != 0) goto endofextractpfi;
-        donecheckread(isofilename);
-        if (trytowritestealthfile(buffer, 1, 2048, extractpfifile, argv[extractpfiarg], 0) != 0) goto endofextractpfi;
+        if (checkreadandprinterrors(check->buffer, 1, 2048, check->fp, 0, check->video - (check->xgd3 ? 0x9800 : 0x1800),
+                                    check->isofilename, "Reading stealth file") != 0) goto endofextractpfi;
+        donecheckread(check->isofilename);
+        if (trytowritestealthfile(check->buffer, 1, 2048, extractpfifile, argv[extractpfiarg], 0) != 0) goto endofextractpfi;
         color(green);
         printf("Extraction was successful%s", newline);
         color(normal);
@@ -5779,7 +6318,7 @@ void domanualextraction(char *argv[]) {
             }
         }
         // ready to extract
-        extractdmifile = fopen(argv[extractdmiarg], "wb");
+        extractdmifile = openforwriting(argv[extractdmiarg]);
         if (extractdmifile == NULL) {
             color(red);
             printf("ERROR: Failed to open %s%s%s for writing! (%s) Extracting DMI failed!%s",
@@ -5787,16 +6326,16 @@ void domanualextraction(char *argv[]) {
             color(normal);
           goto endofextractdmi2;
         }
-        if (fseeko(fp, video - (xgd3 ? 0x9000 : 0x1000), SEEK_SET) != 0) {
-            printseekerror(isofilename, "Extracting DMI");
+        if (fseeko(check->fp, check->video - (check->xgd3 ? 0x9000 : 0x1000), SEEK_SET) != 0) {
+            printseekerror(check->isofilename, "Extracting DMI");
           goto endofextractdmi;
         }
-        memset(buffer, 0, 2048);
+        memset(check->buffer, 0, 2048);
         initcheckread();
-        if (checkreadandprinterrors(buffer, 1, 2048, fp, 0, video - (xgd3 ? 0x9000 : 0x1000),
-                                    isofilename, "Reading stealth file") != 0) goto endofextractdmi;
-        donecheckread(isofilename);
-        if (trytowritestealthfile(buffer, 1, 2048, extractdmifile, argv[extractdmiarg], 0) != 0) goto endofextractdmi;
+        if (checkreadandprinterrors(check->buffer, 1, 2048, check->fp, 0, check->video - (check->xgd3 ? 0x9000 : 0x1000),
+                                    check->isofilename, "Reading stealth file") != 0) goto endofextractdmi;
+        donecheckread(check->isofilename);
+        if (trytowritestealthfile(check->buffer, 1, 2048, extractdmifile, argv[extractdmiarg], 0) != 0) goto endofextractdmi;
         color(green);
         printf("Extraction was successful%s", newline);
         color(normal);
@@ -5832,7 +6371,7 @@ void domanualextraction(char *argv[]) {
             }
         }
         // ready to extract
-        extractssfile = fopen(argv[extractssarg], "wb");
+        extractssfile = openforwriting(argv[extractssarg]);
         if (extractssfile == NULL) {
             color(red);
             printf("ERROR: Failed to open %s%s%s for writing! (%s) Extracting SS failed!%s",
@@ -5840,16 +6379,16 @@ void domanualextraction(char *argv[]) {
             color(normal);
           goto endofextractss2;
         }
-        if (fseeko(fp, video - (xgd3 ? 0x8800 : 0x800), SEEK_SET) != 0) {
-            printseekerror(isofilename, "Extracting SS");
+        if (fseeko(check->fp, check->video - (check->xgd3 ? 0x8800 : 0x800), SEEK_SET) != 0) {
+            printseekerror(check->isofilename, "Extracting SS");
           goto endofextractss;
         }
-        memset(buffer, 0, 2048);
+        memset(check->buffer, 0, 2048);
         initcheckread();
-        if (checkreadandprinterrors(buffer, 1, 2048, fp, 0, video - (xgd3 ? 0x8800 : 0x800),
-                                    isofilename, "Reading stealth file") != 0) goto endofextractss;
-        donecheckread(isofilename);
-        if (trytowritestealthfile(buffer, 1, 2048, extractssfile, argv[extractssarg], 0) != 0) goto endofextractss;
+        if (checkreadandprinterrors(check->buffer, 1, 2048, check->fp, 0, check->video - (check->xgd3 ? 0x8800 : 0x800),
+                                    check->isofilename, "Reading stealth file") != 0) goto endofextractss;
+        donecheckread(check->isofilename);
+        if (trytowritestealthfile(check->buffer, 1, 2048, extractssfile, argv[extractssarg], 0) != 0) goto endofextractss;
         color(green);
         printf("Extraction was successful%s", newline);
         color(normal);
@@ -5863,7 +6402,8 @@ void domanualextraction(char *argv[]) {
 
 void domanualpatch(char *argv[]) {
     unsigned long m;
-    if (!writefile) {
+    int copyresult;
+    if (!check->writefile) {
         color(yellow);
         printf("%sAborting Manual Patch because writing is disabled%s", newline, newline);
         color(normal);
@@ -5871,36 +6411,36 @@ void domanualpatch(char *argv[]) {
     }
     printf("%sStarting Manual Patch%s", newline, newline);
     // reopen iso file for reading and writing
-    fp = freopen(isofilename, "rb+", fp);
-    if (fp == NULL) {
+    check->fp = freopen(check->isofilename, "rb+", check->fp);
+    if (check->fp == NULL) {
         color(red);
-        printf("ERROR: Failed to reopen %s for writing! (%s) Unable to patch Stealth files!%s", isofilename, strerror(errno), newline);
+        printf("ERROR: Failed to reopen %s for writing! (%s) Unable to patch Stealth files!%s", check->isofilename, strerror(errno), newline);
         color(normal);
-        fp = fopen(isofilename, "rb");
-        if (fp == NULL) {
+        check->fp = fopen(check->isofilename, "rb");
+        if (check->fp == NULL) {
             color(red);
-            printf("ERROR: Failed to reopen %s for reading! (%s) Game over man... Game over!%s", isofilename, strerror(errno), newline);
+            printf("ERROR: Failed to reopen %s for reading! (%s) Game over man... Game over!%s", check->isofilename, strerror(errno), newline);
             color(normal);
           exit(1);
         }
       return;
     }
-    if (video == 0) {  // just a game partition (iso needs to be rebuilt)
+    if (check->video == 0) {  // just a game partition (iso needs to be rebuilt)
         if (norebuild) {
             color(red);
             printf("ERROR: You have chosen not to rebuild ISOs, but this one needs to be rebuilt!%s", newline);
             color(normal);
           return;
         }
-        else if (rebuildfailed) {
+        else if (check->rebuildfailed) {
             color(red);
             printf("ERROR: This ISO needs to be rebuilt but a previous attempt failed!%s", newline);
             color(normal);
           return;
         }
         fprintf(stderr, "Image is just a game partition, rebuilding... ");
-        if (rebuildiso(isofilename) != 0) {
-            rebuildfailed = true;
+        if (rebuildiso(check->isofilename) != 0) {
+            check->rebuildfailed = true;
             color(red);
             printf("Rebuilding Failed!");
             if (rebuildlowspace) printf(" Your ISO is now probably corrupt!");
@@ -5909,7 +6449,7 @@ void domanualpatch(char *argv[]) {
           return;
         }
         else if (checkdvdfile) {
-            if (debug) printf("docheckdvdfile isofilename: %s%s", isofilename, newline);
+            if (debug) printf("docheckdvdfile isofilename: %s%s", check->isofilename, newline);
             printf("%s", newline);
             docheckdvdfile();
         }
@@ -5925,9 +6465,9 @@ void domanualpatch(char *argv[]) {
             goto endofpatchss2;
         }
         initcheckread();
-        if (checkreadandprinterrors(ss, 1, 2048, patchssfile, 0, 0, argv[patchssarg], "Patching") != 0) goto endofpatchss;
+        if (checkreadandprinterrors(check->ss, 1, 2048, patchssfile, 0, 0, argv[patchssarg], "Patching") != 0) goto endofpatchss;
         donecheckread(argv[patchssarg]);
-        if (getzeros(ss, 0, 2047) == 2048) {
+        if (zeroscan_allzeros(check->ss, 2048)) {
             // ss is blank
             if (patchvalidfilesonly) {
                 color(red);
@@ -5936,8 +6476,8 @@ void domanualpatch(char *argv[]) {
                 goto endofpatchss;
             }
             else {
-                ssv2 = false;
-                ss_stealthfailed = true;
+                check->ssv2 = false;
+                check->ss_stealthfailed = true;
                 color(red);
                 printf("Warning: This SS file is blank but you disabled the option to patch valid files only! I hope you know what you're doing!%s", newline);
                 color(normal);
@@ -5946,7 +6486,7 @@ void domanualpatch(char *argv[]) {
         else {
             if (verbose) printf("%s", newline);
             checkss();
-            if (ss_stealthfailed || ss_stealthuncertain) {
+            if (check->ss_stealthfailed || check->ss_stealthuncertain) {
                 // ss failed stealth check against the xex
                 if (patchvalidfilesonly) {
                     color(red);
@@ -5955,7 +6495,7 @@ void domanualpatch(char *argv[]) {
                     goto endofpatchss;
                 }
                 else {
-                    if (ss_stealthfailed) color(red);
+                    if (check->ss_stealthfailed) color(red);
                     else color(yellow);
                     printf("Warning: This SS file appears to be invalid but you disabled the option to patch valid files only! I hope you know what you're doing!%s", newline);
                     color(normal);
@@ -5963,14 +6503,14 @@ void domanualpatch(char *argv[]) {
             }
         }
         // patch it
-        if (trytowritestealthfile(ss, 1, 2048, fp, isofilename, video - (xgd3 ? 0x8800 : 0x800)) != 0) goto endofpatchss;
+        if (trytowritestealthfile(check->ss, 1, 2048, check->fp, check->isofilename, check->video - (check->xgd3 ? 0x8800 : 0x800)) != 0) goto endofpatchss;
         
         color(green);
         printf("Patching SS was successful%s", newline);
         color(normal);
         
-        if (ssv2) iso_has_ssv2 = true;
-        else iso_has_ssv2 = false;
+        if (check->ssv2) check->iso_has_ssv2 = true;
+        else check->iso_has_ssv2 = false;
         
         endofpatchss:
             fclose(patchssfile);
@@ -5988,9 +6528,9 @@ void domanualpatch(char *argv[]) {
             goto endofpatchdmi2;
         }
         initcheckread();
-        if (checkreadandprinterrors(ubuffer, 1, 2048, patchdmifile, 0, 0, argv[patchdmiarg], "Patching") != 0) goto endofpatchdmi;
+        if (checkreadandprinterrors(check->ubuffer, 1, 2048, patchdmifile, 0, 0, argv[patchdmiarg], "Patching") != 0) goto endofpatchdmi;
         donecheckread(argv[patchdmiarg]);
-        if (getzeros(ubuffer, 0, 2047) == 2048) {
+        if (zeroscan_allzeros(check->ubuffer, 2048)) {
             // dmi is blank
             if (patchvalidfilesonly) {
                 color(red);
@@ -5999,15 +6539,15 @@ void domanualpatch(char *argv[]) {
                 goto endofpatchdmi;
             }
             else {
-                dmi_stealthfailed = true;
+                check->dmi_stealthfailed = true;
                 color(red);
                 printf("Warning: This DMI file is blank but you disabled the option to patch valid files only! I hope you know what you're doing!%s", newline);
                 color(normal);
             }
         }
         else {
-            checkdmi(ubuffer);
-            if (dmi_stealthfailed || dmi_stealthuncertain) {
+            checkdmi(check->ubuffer);
+            if (check->dmi_stealthfailed || check->dmi_stealthuncertain) {
                 // dmi failed stealth check against the xex/ss
                 if (patchvalidfilesonly) {
                     color(red);
@@ -6016,7 +6556,7 @@ void domanualpatch(char *argv[]) {
                     goto endofpatchdmi;
                 }
                 else {
-                    if (dmi_stealthfailed) color(red);
+                    if (check->dmi_stealthfailed) color(red);
                     else color(yellow);
                     printf("Warning: This DMI file appears to be invalid but you disabled the option to patch valid files only! I hope you know what you're doing!%s", newline);
                     color(normal);
@@ -6024,7 +6564,7 @@ void domanualpatch(char *argv[]) {
             }
         }
         // patch it
-        if (trytowritestealthfile(ubuffer, 1, 2048, fp, isofilename, video - (xgd3 ? 0x9000 : 0x1000)) != 0) goto endofpatchdmi;
+        if (trytowritestealthfile(check->ubuffer, 1, 2048, check->fp, check->isofilename, check->video - (check->xgd3 ? 0x9000 : 0x1000)) != 0) goto endofpatchdmi;
         
         color(green);
         printf("Patching DMI was successful%s", newline);
@@ -6046,9 +6586,9 @@ void domanualpatch(char *argv[]) {
             goto endofpatchpfi2;
         }
         initcheckread();
-        if (checkreadandprinterrors(ubuffer, 1, 2048, patchpfifile, 0, 0, argv[patchpfiarg], "Patching") != 0) goto endofpatchpfi;
+        if (checkreadandprinterrors(check->ubuffer, 1, 2048, patchpfifile, 0, 0, argv[patchpfiarg], "Patching") != 0) goto endofpatchpfi;
         donecheckread(argv[patchpfiarg]);
-        if (getzeros(ubuffer, 0, 2047) == 2048) {
+        if (zeroscan_allzeros(check->ubuffer, 2048)) {
             // pfi is blank
             if (patchvalidfilesonly) {
                 color(red);
@@ -6057,15 +6597,15 @@ void domanualpatch(char *argv[]) {
                 goto endofpatchpfi;
             }
             else {
-                pfi_stealthfailed = true;
+                check->pfi_stealthfailed = true;
                 color(red);
                 printf("Warning: This PFI file is blank but you disabled the option to patch valid files only! I hope you know what you're doing!%s", newline);
                 color(normal);
             }
         }
         else {
-            checkpfi(ubuffer);
-            if (pfi_stealthfailed || pfi_stealthuncertain) {
+            checkpfi(check->ubuffer);
+            if (check->pfi_stealthfailed || check->pfi_stealthuncertain) {
                 // pfi failed stealth check
                 if (patchvalidfilesonly) {
                     color(red);
@@ -6074,7 +6614,7 @@ void domanualpatch(char *argv[]) {
                     goto endofpatchpfi;
                 }
                 else {
-                    if (pfi_stealthfailed) color(red);
+                    if (check->pfi_stealthfailed) color(red);
                     else color(yellow);
                     printf("Warning: This PFI file appears to be invalid but you disabled the option to patch valid files only! I hope you know what you're doing!%s", newline);
                     color(normal);
@@ -6082,7 +6622,7 @@ void domanualpatch(char *argv[]) {
             }
         }
         // patch it
-        if (trytowritestealthfile(ubuffer, 1, 2048, fp, isofilename, video - (xgd3 ? 0x9800 : 0x1800)) != 0) goto endofpatchpfi;
+        if (trytowritestealthfile(check->ubuffer, 1, 2048, check->fp, check->isofilename, check->video - (check->xgd3 ? 0x9800 : 0x1800)) != 0) goto endofpatchpfi;
         
         color(green);
         printf("Patching PFI was successful%s", newline);
@@ -6096,7 +6636,7 @@ void domanualpatch(char *argv[]) {
     if (patchvideoarg) {
         FILE *patchvideofile;
         printf("Patching Video from %s%s%s%s", quotation, argv[patchvideoarg], quotation, newline);
-        if (!pfi_foundsectorstotal) {
+        if (!check->pfi_foundsectorstotal) {
             // we need PFI to determine how to patch video
             color(red);
             printf("Patching was aborted because there is no PFI to describe the Video data areas!%s", newline);
@@ -6113,7 +6653,7 @@ void domanualpatch(char *argv[]) {
         }
         if (verbose) printf("%s", newline);
         checkvideo(argv[patchvideoarg], patchvideofile, true, false);
-        if (video_stealthfailed || video_stealthuncertain) {
+        if (check->video_stealthfailed || check->video_stealthuncertain) {
             // video failed stealth check
             if (patchvalidfilesonly) {
                 color(red);
@@ -6122,7 +6662,7 @@ void domanualpatch(char *argv[]) {
                 goto endofpatchvideo;
             }
             else {
-                if (video_stealthfailed) color(red);
+                if (check->video_stealthfailed) color(red);
                 else color(yellow);
                 printf("Warning: This Video file appears to be invalid but you disabled the option to\n"
                        "patch valid files only! I hope you know what you're doing!%s", newline);
@@ -6132,108 +6672,117 @@ void domanualpatch(char *argv[]) {
         // patch video
         long long videofilesize = getfilesize(patchvideofile);
         if (videofilesize == -1) goto endofpatchvideo;  // seek error
-        if (videofilesize < pfi_sectorstotal*2048) {
+        if (videofilesize < check->pfi_sectorstotal*2048) {
             // the supplied file is not large enough based on the pfi data area size
             color(red);
             printf("ERROR: %s%s%s (%"LL"d bytes) is smaller than the PFI data area size (%"LL"d bytes) Patching was aborted!%s",
-                   quotation, argv[patchvideoarg], quotation, videofilesize, (long long) pfi_sectorstotal*2048, newline);
+                   quotation, argv[patchvideoarg], quotation, videofilesize, (long long) check->pfi_sectorstotal*2048, newline);
             color(normal);
             goto endofpatchvideo;
         }
-        if (videofilesize > pfi_sectorstotal*2048) {
+        if (videofilesize > check->pfi_sectorstotal*2048) {
             // only patch the first pfi_sectorstotal*2048 bytes of the supplied file
             printf("Note: %s%s%s (%"LL"d bytes) is larger than necessary (this is normal for full XGD2 video partition files). "
                    "Only the first %"LL"d bytes will be patched.%s",
-                   quotation, argv[patchvideoarg], quotation, videofilesize, (long long) pfi_sectorstotal*2048, newline);
-            videofilesize = (long long) pfi_sectorstotal*2048;
+                   quotation, argv[patchvideoarg], quotation, videofilesize, (long long) check->pfi_sectorstotal*2048, newline);
+            videofilesize = (long long) check->pfi_sectorstotal*2048;
         }
         // iso size should be at least [pfi_offsetL1 + pfi_sectorsL1*2048]
-        if ((unsigned long long) fpfilesize < pfi_offsetL1 + pfi_sectorsL1*2048) {
+        if ((unsigned long long) check->fpfilesize < check->pfi_offsetL1 + check->pfi_sectorsL1*2048) {
             printf("ISO size is too small to contain the L1 Video, extending...%s", newline);
-            if (dotruncate(isofilename, fpfilesize, pfi_offsetL1 + pfi_sectorsL1*2048, false) != 0) goto endofpatchvideo;
+            if (dotruncate(check->isofilename, check->fpfilesize, check->pfi_offsetL1 + check->pfi_sectorsL1*2048, false) != 0) goto endofpatchvideo;
             // get the new filesize
-            fpfilesize = getfilesize(fp);
-            if (fpfilesize == -1) goto endofpatchvideo;  // seek error
+            check->fpfilesize = getfilesize(check->fp);
+            if (check->fpfilesize == -1) goto endofpatchvideo;  // seek error
         }
-        else if ((unsigned long long) fpfilesize > pfi_offsetL1 + pfi_sectorsL1*2048) {
+        else if ((unsigned long long) check->fpfilesize > check->pfi_offsetL1 + check->pfi_sectorsL1*2048) {
             // this really doesn't matter unless the image is too big to burn
             printf("ISO size is larger than necessary, truncating...%s", newline);
-            if (dotruncate(isofilename, fpfilesize, pfi_offsetL1 + pfi_sectorsL1*2048, false) != 0) goto endofpatchvideo;
+            if (dotruncate(check->isofilename, check->fpfilesize, check->pfi_offsetL1 + check->pfi_sectorsL1*2048, false) != 0) goto endofpatchvideo;
             // get the new filesize
-            fpfilesize = getfilesize(fp);
-            if (fpfilesize == -1) goto endofpatchvideo;  // seek error
+            check->fpfilesize = getfilesize(check->fp);
+            if (check->fpfilesize == -1) goto endofpatchvideo;  // seek error
         }
         // check that L0 data area does not overlap stealth files or game data
-        if (pfi_sectorsL0 > video/2048 - number_of_stealth_sectors - (xgd3 ? 16 : 0)) {
+        if (check->pfi_sectorsL0 > check->video/2048 - number_of_stealth_sectors - (check->xgd3 ? 16 : 0)) {
             color(yellow);
-            printf("PFI L0 Data Area is too large! (%lu sectors) Patching was aborted!%s", pfi_sectorsL0, newline);
+            printf("PFI L0 Data Area is too large! (%lu sectors) Patching was aborted!%s", check->pfi_sectorsL0, newline);
             color(normal);
             goto endofpatchvideo;
         }
         // seek to the start of L0 Video and start patching
-        if (fseeko(fp, 0, SEEK_SET) != 0) {
-            printseekerror(isofilename, "Patching video file");
+        if (fseeko(check->fp, 0, SEEK_SET) != 0) {
+            printseekerror(check->isofilename, "Patching video file");
             goto endofpatchvideo;
         }
         if (fseeko(patchvideofile, 0, SEEK_SET) != 0) {
             printseekerror(argv[patchvideoarg], "Patching video file");
             goto endofpatchvideo;
         }
-        sizeoverbuffer = pfi_sectorsL0*2048 / BIGBUF_SIZE;
-        bufferremainder = pfi_sectorsL0*2048 % BIGBUF_SIZE;
+        check->sizeoverbuffer = check->pfi_sectorsL0*2048 / BIGBUF_SIZE;
+        check->bufferremainder = check->pfi_sectorsL0*2048 % BIGBUF_SIZE;
         initcheckread();
         initcheckwrite();
-        for (m=0; m<sizeoverbuffer; m++) {
-            if (checkreadandprinterrors(bigbuffer, 1, BIGBUF_SIZE, patchvideofile, m, 0,
+        // the loops below only run if the video couldn't be copied without going through bigbuffer
+        copyresult = copyfilerange(patchvideofile, argv[patchvideoarg], 0, check->fp, check->isofilename, 0,
+                                   (unsigned long long) check->pfi_sectorsL0*2048, "Patching L0 Video", false);
+        if (copyresult == 1) goto endofpatchvideo;
+        if (copyresult == 0) check->sizeoverbuffer = check->bufferremainder = 0;
+        for (m=0; m<check->sizeoverbuffer; m++) {
+            if (checkreadandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, patchvideofile, m, 0,
                                         argv[patchvideoarg], "Patching L0 Video") != 0)
                 goto endofpatchvideo;
-            if (checkwriteandprinterrors(bigbuffer, 1, BIGBUF_SIZE, fp, m, 0,
-                                         isofilename, "Patching L0 Video") != 0)
+            if (checkwriteandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, check->fp, m, 0,
+                                         check->isofilename, "Patching L0 Video") != 0)
                 goto endofpatchvideo;
         }
-        if (bufferremainder) {
-            if (checkreadandprinterrors(bigbuffer, 1, bufferremainder, patchvideofile, 0, pfi_sectorsL0*2048 - bufferremainder,
+        if (check->bufferremainder) {
+            if (checkreadandprinterrors(check->bigbuffer, 1, check->bufferremainder, patchvideofile, 0, check->pfi_sectorsL0*2048 - check->bufferremainder,
                                         argv[patchvideoarg], "Patching L0 Video") != 0)
                 goto endofpatchvideo;
-            if (checkwriteandprinterrors(bigbuffer, 1, bufferremainder, fp, 0, pfi_sectorsL0*2048 - bufferremainder,
-                                         isofilename, "Patching L0 Video") != 0)
+            if (checkwriteandprinterrors(check->bigbuffer, 1, check->bufferremainder, check->fp, 0, check->pfi_sectorsL0*2048 - check->bufferremainder,
+                                         check->isofilename, "Patching L0 Video") != 0)
                 goto endofpatchvideo;
         }
         // seek to the start of L1 Video and continue patching
-        if (fseeko(fp, pfi_offsetL1, SEEK_SET) != 0) {
-            printseekerror(isofilename, "Patching video file");
+        if (fseeko(check->fp, check->pfi_offsetL1, SEEK_SET) != 0) {
+            printseekerror(check->isofilename, "Patching video file");
           goto endofpatchvideo;
         }
-        sizeoverbuffer = pfi_sectorsL1*2048 / BIGBUF_SIZE;
-        bufferremainder = pfi_sectorsL1*2048 % BIGBUF_SIZE;
-        for (m=0; m<sizeoverbuffer; m++) {
-            if (checkreadandprinterrors(bigbuffer, 1, BIGBUF_SIZE, patchvideofile, m, pfi_sectorsL0*2048,
+        check->sizeoverbuffer = check->pfi_sectorsL1*2048 / BIGBUF_SIZE;
+        check->bufferremainder = check->pfi_sectorsL1*2048 % BIGBUF_SIZE;
+        copyresult = copyfilerange(patchvideofile, argv[patchvideoarg], (unsigned long long) check->pfi_sectorsL0*2048, check->fp, check->isofilename,
+                                   check->pfi_offsetL1, (unsigned long long) check->pfi_sectorsL1*2048, "Patching L1 Video", false);
+        if (copyresult == 1) goto endofpatchvideo;
+        if (copyresult == 0) check->sizeoverbuffer = check->bufferremainder = 0;
+        for (m=0; m<check->sizeoverbuffer; m++) {
+            if (checkreadandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, patchvideofile, m, check->pfi_sectorsL0*2048,
                                         argv[patchvideoarg], "Patching L1 Video") != 0)
                 goto endofpatchvideo;
-            if (checkwriteandprinterrors(bigbuffer, 1, BIGBUF_SIZE, fp, m, pfi_offsetL1,
-                                         isofilename, "Patching L1 Video") != 0)
+            if (checkwriteandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, check->fp, m, check->pfi_offsetL1,
+                                         check->isofilename, "Patching L1 Video") != 0)
                 goto endofpatchvideo;
         }
-        if (bufferremainder) {
-            if (checkreadandprinterrors(bigbuffer, 1, bufferremainder, patchvideofile, 0, pfi_sectorstotal*2048 - bufferremainder,
+        if (check->bufferremainder) {
+            if (checkreadandprinterrors(check->bigbuffer, 1, check->bufferremainder, patchvideofile, 0, check->pfi_sectorstotal*2048 - check->bufferremainder,
                                         argv[patchvideoarg], "Patching L1 Video") != 0)
                 goto endofpatchvideo;
-            if (checkwriteandprinterrors(bigbuffer, 1, bufferremainder, fp, 0, pfi_offsetL1 + pfi_sectorsL1*2048 - bufferremainder,
-                                         isofilename, "Patching L1 Video") != 0)
+            if (checkwriteandprinterrors(check->bigbuffer, 1, check->bufferremainder, check->fp, 0, check->pfi_offsetL1 + check->pfi_sectorsL1*2048 - check->bufferremainder,
+                                         check->isofilename, "Patching L1 Video") != 0)
                 goto endofpatchvideo;
         }
         donecheckread(argv[patchvideoarg]);
-        donecheckwrite(isofilename);
+        donecheckwrite(check->isofilename);
         
         // pad L0 video
-        if (pfi_sectorsL0 == video/2048 - number_of_stealth_sectors - (xgd3 ? 16 : 0)) {
+        if (check->pfi_sectorsL0 == check->video/2048 - number_of_stealth_sectors - (check->xgd3 ? 16 : 0)) {
             // there is no L0 video padding
             if (verbose) printf("Skipped padding L0 Video because there is no padding needed%s", newline);
         }
         else {
             if (verbose) printf("Padding L0 Video... ");
-            if (padzeros(fp, isofilename, pfi_sectorsL0*2048,
-                         (long long) video - (number_of_stealth_sectors+(xgd3 ? 16 : 0))*2048) != 0) goto endofpatchvideo;
+            if (padzeros(check->fp, check->isofilename, check->pfi_sectorsL0*2048,
+                         (long long) check->video - (number_of_stealth_sectors+(check->xgd3 ? 16 : 0))*2048) != 0) goto endofpatchvideo;
             if (verbose) printf("Done%s", newline);
         }
         // pad L1 video
@@ -6244,17 +6793,17 @@ void domanualpatch(char *argv[]) {
             color(normal);
             goto endofpatchvideo;
         }
-        if (pfi_offsetL1 == padding_offsetL1start) {
+        if (check->pfi_offsetL1 == padding_offsetL1start) {
             // there is no L1 video padding
             if (verbose) printf("Skipped padding L1 Video because there is no padding needed%s", newline);
         }
-        else if (pfi_offsetL1 < padding_offsetL1start) {
+        else if (check->pfi_offsetL1 < padding_offsetL1start) {
             // L1 video overlaps game data
             if (verbose) printf("Skipped padding L1 Video because there is no padding needed (PFI L1 Data Area overlaps the game partition)%s", newline);
         }
         else {
             if (verbose) printf("Padding L1 Video... ");
-            if (padzeros(fp, isofilename, padding_offsetL1start, pfi_offsetL1) != 0) goto endofpatchvideo;
+            if (padzeros(check->fp, check->isofilename, padding_offsetL1start, check->pfi_offsetL1) != 0) goto endofpatchvideo;
             if (verbose) printf("Done%s", newline);
         }
         
@@ -6272,19 +6821,19 @@ int docheckdvdfile() {
     int i;
     size_t s;
     FILE *dvdfile;
-    char dvdfilename[strlen(isofilename) + 1];
-    char shortisofilename[strlen(isofilename) + 1];
+    char dvdfilename[strlen(check->isofilename) + 1];
+    char shortisofilename[strlen(check->isofilename) + 1];
     char layerbreakstring[22];
-    memset(dvdfilename, 0, strlen(isofilename) + 1);
-    memset(shortisofilename, 0, strlen(isofilename) + 1);
+    memset(dvdfilename, 0, strlen(check->isofilename) + 1);
+    memset(shortisofilename, 0, strlen(check->isofilename) + 1);
     memset(layerbreakstring, 0, 22);
-    sprintf(layerbreakstring, "LayerBreak=%ld", layerbreak);
+    sprintf(layerbreakstring, "LayerBreak=%ld", check->layerbreak);
     // copy isofilename to dvdfilename for editing
-    memcpy(dvdfilename, isofilename, strlen(isofilename));
+    memcpy(dvdfilename, check->isofilename, strlen(check->isofilename));
     // replace blah.xxx with blah.dvd
     if (memcmp(dvdfilename+strlen(dvdfilename)-4, ".", 1) == 0) {
         memcpy(dvdfilename+strlen(dvdfilename)-4, ".dvd", 4);
-        if (layerbreak <= 0) {
+        if (check->layerbreak <= 0) {
             color(yellow);
             printf("Unable to check/create .dvd file because the correct layerbreak to use could\nnot be determined!%s", newline);
             color(normal);
@@ -6293,9 +6842,9 @@ int docheckdvdfile() {
         }
         // isofilename might be something like "C:\My Documents\imgname.iso" and
         // we want a string with just imgname.iso to compare or put in the .dvd file
-        for (i=strlen(isofilename)-6;i>-1;i--) {  // work backwards to find the last slash
-            if (isofilename[i] == '\\' || isofilename[i] == '/') {
-                memcpy(shortisofilename, isofilename+i+1, strlen(isofilename)-i-1);  // copy the data after the slash to shortisofilename
+        for (i=strlen(check->isofilename)-6;i>-1;i--) {  // work backwards to find the last slash
+            if (check->isofilename[i] == '\\' || check->isofilename[i] == '/') {
+                memcpy(shortisofilename, check->isofilename+i+1, strlen(check->isofilename)-i-1);  // copy the data after the slash to shortisofilename
                 break;
             }
         }
@@ -6303,47 +6852,47 @@ int docheckdvdfile() {
         dvdfile = fopen(dvdfilename, "rb");
         if (dvdfile != NULL) {
             // it does, so we'll check to make sure it's valid
-            memset(buffer, 0, 2048);
-            if (fgets(buffer, 2048, dvdfile) == NULL) goto dvdfix;
-            if (strlen(buffer) != (strlen(layerbreakstring) + 1) && strlen(buffer) != (strlen(layerbreakstring) + 2)) goto dvdfix;
-            if (memcmp(buffer, layerbreakstring, strlen(layerbreakstring)) == 0) {  // first line of .dvd file must match this
+            memset(check->buffer, 0, 2048);
+            if (fgets(check->buffer, 2048, dvdfile) == NULL) goto dvdfix;
+            if (strlen(check->buffer) != (strlen(layerbreakstring) + 1) && strlen(check->buffer) != (strlen(layerbreakstring) + 2)) goto dvdfix;
+            if (memcmp(check->buffer, layerbreakstring, strlen(layerbreakstring)) == 0) {  // first line of .dvd file must match this
                 // rest of first line should be one newline
-                if (strlen(buffer) == (strlen(layerbreakstring) + 1)) {
-                    if (buffer[strlen(layerbreakstring)] != 0x0D && buffer[strlen(layerbreakstring)] != 0x0A) goto dvdfix;
+                if (strlen(check->buffer) == (strlen(layerbreakstring) + 1)) {
+                    if (check->buffer[strlen(layerbreakstring)] != 0x0D && check->buffer[strlen(layerbreakstring)] != 0x0A) goto dvdfix;
                 }
-                else if (memcmp(buffer+strlen(layerbreakstring), "\x0D\x0A", 2) != 0) goto dvdfix;
+                else if (memcmp(check->buffer+strlen(layerbreakstring), "\x0D\x0A", 2) != 0) goto dvdfix;
                 // read line 2
-                memset(buffer, 0, 2048);
-                if (fgets(buffer, 2048, dvdfile) == NULL) goto dvdfix;
+                memset(check->buffer, 0, 2048);
+                if (fgets(check->buffer, 2048, dvdfile) == NULL) goto dvdfix;
                 if (strlen(shortisofilename)) {
-                    if (memcmp(shortisofilename, buffer, strlen(shortisofilename)) == 0) {  // second line should match shortisofilename
+                    if (memcmp(shortisofilename, check->buffer, strlen(shortisofilename)) == 0) {  // second line should match shortisofilename
                         // rest of second line should be one newline (or nothing)
-                        if (strlen(buffer) == strlen(shortisofilename)) goto dvdmatch;
-                        if ((strlen(buffer) != strlen(shortisofilename) + 1) && (strlen(buffer) != strlen(shortisofilename) + 2)) goto dvdfix;
-                        if (strlen(buffer) == strlen(shortisofilename) + 1) {
-                            if (buffer[strlen(shortisofilename)] != 0x0D && buffer[strlen(shortisofilename)] != 0x0A) goto dvdfix;
+                        if (strlen(check->buffer) == strlen(shortisofilename)) goto dvdmatch;
+                        if ((strlen(check->buffer) != strlen(shortisofilename) + 1) && (strlen(check->buffer) != strlen(shortisofilename) + 2)) goto dvdfix;
+                        if (strlen(check->buffer) == strlen(shortisofilename) + 1) {
+                            if (check->buffer[strlen(shortisofilename)] != 0x0D && check->buffer[strlen(shortisofilename)] != 0x0A) goto dvdfix;
                         }
-                        else if (memcmp(buffer+strlen(shortisofilename), "\x0D\x0A", 2) != 0) goto dvdfix;
+                        else if (memcmp(check->buffer+strlen(shortisofilename), "\x0D\x0A", 2) != 0) goto dvdfix;
                         goto dvdmatch;
                     }
                     else goto dvdfix;
                 }
-                else if (memcmp(isofilename, buffer, strlen(isofilename)) == 0) {  // shortisofilename is blank - second line should match isofilename
+                else if (memcmp(check->isofilename, check->buffer, strlen(check->isofilename)) == 0) {  // shortisofilename is blank - second line should match isofilename
                     // rest of second line should be one newline (or nothing)
-                    if (strlen(buffer) == strlen(isofilename)) goto dvdmatch;
-                    if ((strlen(buffer) != strlen(isofilename) + 1) && (strlen(buffer) != strlen(isofilename) + 2)) goto dvdfix;
-                    if (strlen(buffer) == strlen(isofilename) + 1) {
-                        if (buffer[strlen(isofilename)] != 0x0D && buffer[strlen(isofilename)] != 0x0A) goto dvdfix;
+                    if (strlen(check->buffer) == strlen(check->isofilename)) goto dvdmatch;
+                    if ((strlen(check->buffer) != strlen(check->isofilename) + 1) && (strlen(check->buffer) != strlen(check->isofilename) + 2)) goto dvdfix;
+                    if (strlen(check->buffer) == strlen(check->isofilename) + 1) {
+                        if (check->buffer[strlen(check->isofilename)] != 0x0D && check->buffer[strlen(check->isofilename)] != 0x0A) goto dvdfix;
                     }
-                    else if (memcmp(buffer+strlen(isofilename), "\x0D\x0A", 2) != 0) goto dvdfix;
+                    else if (memcmp(check->buffer+strlen(check->isofilename), "\x0D\x0A", 2) != 0) goto dvdfix;
                     dvdmatch:
                     // rest of the file should be only newlines if anything
-                    memset(buffer, 0, 2048);
-                    while (fgets(buffer, 2048, dvdfile) != NULL) {
-                        for (s=0;s<strlen(buffer);s++) {
-                            if (buffer[s] != '\x0D' && buffer[s] != '\x0A') goto dvdfix;
+                    memset(check->buffer, 0, 2048);
+                    while (fgets(check->buffer, 2048, dvdfile) != NULL) {
+                        for (s=0;s<strlen(check->buffer);s++) {
+                            if (check->buffer[s] != '\x0D' && check->buffer[s] != '\x0A') goto dvdfix;
                         }
-                        memset(buffer, 0, 2048);
+                        memset(check->buffer, 0, 2048);
                     }
                     color(green);
                     printf("%s is valid%s%s", dvdfilename, newline, newline);
@@ -6353,7 +6902,7 @@ int docheckdvdfile() {
                 }
             }
             dvdfix:
-            if (!writefile) {
+            if (!check->writefile) {
                 color(yellow);
                 printf("%s needs to be fixed but writing is disabled!%s", dvdfilename, newline);
                 color(normal);
@@ -6372,15 +6921,15 @@ int docheckdvdfile() {
               return 1;
             }
             // write the correct .dvd file contents to buffer
-            memset(buffer, 0, 2048);
-            strcat(buffer, layerbreakstring);
-            strcat(buffer, "\x0D\x0A");
-            if (strlen(shortisofilename)) strcat(buffer, shortisofilename);
-            else strcat(buffer, isofilename);
-            strcat(buffer, "\x0D\x0A");
+            memset(check->buffer, 0, 2048);
+            strcat(check->buffer, layerbreakstring);
+            strcat(check->buffer, "\x0D\x0A");
+            if (strlen(shortisofilename)) strcat(check->buffer, shortisofilename);
+            else strcat(check->buffer, check->isofilename);
+            strcat(check->buffer, "\x0D\x0A");
             // write buffer contents to the file
             initcheckwrite();
-            if (checkwriteandprinterrors(buffer, 1, strlen(buffer), dvdfile, 0, 0, dvdfilename, "Fixing .dvd file") != 0) return 1;
+            if (checkwriteandprinterrors(check->buffer, 1, strlen(check->buffer), dvdfile, 0, 0, dvdfilename, "Fixing .dvd file") != 0) return 1;
             donecheckwrite(dvdfilename);
             color(green);
             printf("%s was fixed%s%s", dvdfilename, newline, newline);
@@ -6389,7 +6938,7 @@ int docheckdvdfile() {
           return 0;
         }
         else {
-            if (!writefile) {
+            if (!check->writefile) {
                 color(yellow);
                 printf("%s needs to be created but writing is disabled!%s", dvdfilename, newline);
                 color(normal);
@@ -6408,15 +6957,15 @@ int docheckdvdfile() {
               return 1;
             }
             // write the correct .dvd file contents to buffer
-            memset(buffer, 0, 2048);
-            strcat(buffer, layerbreakstring);
-            strcat(buffer, "\x0D\x0A");
-            if (strlen(shortisofilename)) strcat(buffer, shortisofilename);
-            else strcat(buffer, isofilename);
-            strcat(buffer, "\x0D\x0A");
+            memset(check->buffer, 0, 2048);
+            strcat(check->buffer, layerbreakstring);
+            strcat(check->buffer, "\x0D\x0A");
+            if (strlen(shortisofilename)) strcat(check->buffer, shortisofilename);
+            else strcat(check->buffer, check->isofilename);
+            strcat(check->buffer, "\x0D\x0A");
             // write buffer contents to the file
             initcheckwrite();
-            if (checkwriteandprinterrors(buffer, 1, strlen(buffer), dvdfile, 0, 0, dvdfilename, "Creating .dvd file") != 0) return 1;
+            if (checkwriteandprinterrors(check->buffer, 1, strlen(check->buffer), dvdfile, 0, 0, dvdfilename, "Creating .dvd file") != 0) return 1;
             donecheckwrite(dvdfilename);
             color(green);
             printf("%s was created%s%s", dvdfilename, newline, newline);
@@ -6425,7 +6974,7 @@ int docheckdvdfile() {
           return 0;
         }
     }
-    if (debug) printf("docheckdvdfile r1 - isofilename: %s, strlen(isofilename) = %u, dvdfilename: %s, strlen(dvdfilename) = %u%s", isofilename, (unsigned int) strlen(isofilename), dvdfilename, (unsigned int) strlen(dvdfilename), newline);
+    if (debug) printf("docheckdvdfile r1 - isofilename: %s, strlen(isofilename) = %u, dvdfilename: %s, strlen(dvdfilename) = %u%s", check->isofilename, (unsigned int) strlen(check->isofilename), dvdfilename, (unsigned int) strlen(dvdfilename), newline);
   return 1;  // isofilename does not end with .xxx, it could be a device like /dev/cdrom so we won't make a .dvd file
 }
 
@@ -6490,6 +7039,20 @@ void deletestealthfile(char *stealthfilename, char *localdir, bool videofile) {
         else printf("deleting stealth file '%s' from localdir '%s' (fullpath: '%s')%s", stealthfilename, localdir, fullpath, newline);
     }
     remove(fullpath);
+    #ifndef WIN32
+        if (videofile) {
+            // it may have been a packed one
+            strcat(fullpath, VIDEOPACK_SUFFIX);
+            remove(fullpath);
+        }
+        if (strlen(stealthfilename) > 4 && strcasecmp(stealthfilename + strlen(stealthfilename) - 4, ".ini") == 0) invalidateiniindex();
+        forgetprefetched(stealthfilename);
+        if (!homeless) {
+            memset(fullpath, 0, 2048);
+            strcat(fullpath, homedir); strcat(fullpath, abgxdir); strcat(fullpath, localdir);
+            stealthstore_forget(fullpath, stealthfilename);
+        }
+    #endif
   return;
 }
 
@@ -6500,8 +7063,17 @@ int openinifromxexini() {
     unsigned long sscrcsfromxexini[20];
     char line[11];  // 8 chars in crc + up to 2 newline chars and terminating null
     memset(line, 0, 11);
+    #ifndef WIN32
+        // already parsed when the ini index was built
+        if (check->xexiniindexed) {
+            for (i=0;i<(int) check->xexinientry.count && num_sscrcsfromxexini < 20;i++) {
+                sscrcsfromxexini[num_sscrcsfromxexini] = check->xexinientry.crcs[i];
+                num_sscrcsfromxexini++;
+            }
+        }
+    #endif
     // get a random SS crc out of the ini
-    while (fgets(line, 11, xexinifile) != NULL && num_sscrcsfromxexini < 20) {
+    while (check->xexinifile != NULL && fgets(line, 11, check->xexinifile) != NULL && num_sscrcsfromxexini < 20) {
         if (debug) printf("openinifromxexini - xex line: %s%s", line, newline);
         // valid characters are 0-9, A-F, a-f
         invalidline = false;
@@ -6521,41 +7093,39 @@ int openinifromxexini() {
     if (debug) printf("num_sscrcsfromxexini = %d%s", num_sscrcsfromxexini, newline);
     if (num_sscrcsfromxexini == 0) {
         color(yellow);
-        printf("ERROR: Failed to find a valid SS CRC in '%s'%s", xexinifilename, newline);
+        printf("ERROR: Failed to find a valid SS CRC in '%s'%s", check->xexinifilename, newline);
         color(normal);
         // delete the xex ini
-        fclose(xexinifile);
-        deletestealthfile(xexinifilename, stealthdir, false);
+        closeini(&check->xexinifile);
+        deletestealthfile(check->xexinifilename, stealthdir, false);
       return 1;
     }
     int randomxexinicrc = randomnumber(0, num_sscrcsfromxexini - 1);
     if (num_sscrcsfromxexini > 1 && verbose) {
-        printf("%s'%s' contains %d SS CRCs, randomly picked %s%d%s", sp5, xexinifilename, num_sscrcsfromxexini, numbersign, randomxexinicrc + 1, newline);
-    }
-    fix_ss_crc32 = sscrcsfromxexini[randomxexinicrc];
-    memset(inifilename, 0, 24);
-    sprintf(inifilename, "%08lX%08lX.ini", fix_ss_crc32, xex_crc32);
-    inifile = NULL;
-    inifile = openstealthfile(inifilename, stealthdir, webinidir, SSXEX_INI_FROM_XEX_INI, "the online verified database");
-    if (inifile == NULL && num_sscrcsfromxexini > 1) {
+        printf("%s'%s' contains %d SS CRCs, randomly picked %s%d%s", sp5, check->xexinifilename, num_sscrcsfromxexini, numbersign, randomxexinicrc + 1, newline);
+    }
+    check->fix_ss_crc32 = sscrcsfromxexini[randomxexinicrc];
+    memset(check->inifilename, 0, 24);
+    sprintf(check->inifilename, "%08lX%08lX.ini", check->fix_ss_crc32, check->xex_crc32);
+    bool notfound = openini(check->inifilename, webinidir, SSXEX_INI_FROM_XEX_INI, "the online verified database") != 0;
+    if (notfound && num_sscrcsfromxexini > 1) {
         // get a different ss crc out of the ini
         for (i=0;i<num_sscrcsfromxexini;i++) {
             if (i == randomxexinicrc) continue;
-            if (verbose) printf("%sFailed to find or open '%s', trying SS CRC %s%d...%s", sp5, inifilename, numbersign, i + 1, newline);
-            fix_ss_crc32 = sscrcsfromxexini[i];
-            memset(inifilename, 0, 24);
-            sprintf(inifilename, "%08lX%08lX.ini", fix_ss_crc32, xex_crc32);
-            inifile = openstealthfile(inifilename, stealthdir, webinidir, SSXEX_INI_FROM_XEX_INI, "the online verified database");
-            if (inifile != NULL) return 0;
+            if (verbose) printf("%sFailed to find or open '%s', trying SS CRC %s%d...%s", sp5, check->inifilename, numbersign, i + 1, newline);
+            check->fix_ss_crc32 = sscrcsfromxexini[i];
+            memset(check->inifilename, 0, 24);
+            sprintf(check->inifilename, "%08lX%08lX.ini", check->fix_ss_crc32, check->xex_crc32);
+            if (openini(check->inifilename, webinidir, SSXEX_INI_FROM_XEX_INI, "the online verified database") == 0) return 0;
         }
     }
-    if (inifile == NULL) {
+    if (notfound) {
         color(yellow);
         printf("Failed to find or open a verified Xex/SS ini file%s", newline);
         color(normal);
         // delete the xex ini
-        fclose(xexinifile);
-        deletestealthfile(xexinifilename, stealthdir, false);
+        closeini(&check->xexinifile);
+        deletestealthfile(check->xexinifilename, stealthdir, false);
       return 1;
     }
   return 0;
@@ -6565,15 +7135,28 @@ int openinifromxexini() {
 
 void parseini() {
     int i;
-    long long inifilesize = getfilesize(inifile);
+    long long inifilesize;
     char line[200];
     int linesread = 0;
-    ini_dmi_count = 0; ini_ss = 0; ini_pfi = 0; ini_video = 0; ini_rawss = 0; ini_v0 = 0; ini_v1 = 0; ini_game = 0; ini_xexhash = 0;
+    check->ini_dmi_count = 0; check->ini_ss = 0; check->ini_pfi = 0; check->ini_video = 0; check->ini_rawss = 0; check->ini_v0 = 0; check->ini_v1 = 0; check->ini_game = 0; check->ini_xexhash = 0;
     for (i=0;i<30;i++) {
-        ini_dmi[i] = 0;
+        check->ini_dmi[i] = 0;
     }
+    #ifndef WIN32
+        if (check->iniindexed) {
+            // already parsed when the ini index was built
+            check->ini_dmi_count = (int) check->inientry.count;
+            for (i=0;i<check->ini_dmi_count;i++) check->ini_dmi[i] = check->inientry.crcs[i];
+            check->ini_ss = check->inientry.ini_ss; check->ini_pfi = check->inientry.pfi; check->ini_video = check->inientry.video;
+            check->ini_rawss = check->inientry.rawss; check->ini_v0 = check->inientry.v0; check->ini_v1 = check->inientry.v1;
+            check->ini_game = check->inientry.game; check->ini_xexhash = check->inientry.xexhash;
+            if (verbose) printf("%s%sUsing %s (%lu bytes)%s", newline, sp5, check->inifilename, (unsigned long) check->inientry.filesize, newline);
+          return;
+        }
+    #endif
+    inifilesize = getfilesize(check->inifile);
     if (verbose) {
-        printf("%s%sUsing %s (%"LL"d bytes)", newline, sp5, inifilename, inifilesize);
+        printf("%s%sUsing %s (%"LL"d bytes)", newline, sp5, check->inifilename, inifilesize);
     }
     if (extraverbose) {
         printf(":%s%s", newline, newline);
@@ -6581,25 +7164,25 @@ void parseini() {
     }
     else if (verbose) printf("%s", newline);
     memset(line, 0, 200);
-    while (fgets(line, 200, inifile) != NULL && linesread < MAX_INI_LINES) {
+    while (fgets(line, 200, check->inifile) != NULL && linesread < MAX_INI_LINES) {
         if (extraverbose) {
             printf("%s", line);
             if (html) printf("<br>");
         }
         for (i=2;i<12;i++) {  // shortest field is 'SS=', longest field is 'RegionFlags='
             if (line[i] == '=') {
-                if (memcmp(line, "DMI", i) == 0 && ini_dmi_count < 30) {
-                    ini_dmi[ini_dmi_count] = strtoul(line+i+1, NULL, 16);
-                    ini_dmi_count++;
-                }
-                else if (memcmp(line, "SS", i) == 0) ini_ss = strtoul(line+i+1, NULL, 16);
-                else if (memcmp(line, "PFI", i) == 0) ini_pfi = strtoul(line+i+1, NULL, 16);
-                else if (memcmp(line, "Video", i) == 0) ini_video = strtoul(line+i+1, NULL, 16);
-                else if (memcmp(line, "RawSS", i) == 0) ini_rawss = strtoul(line+i+1, NULL, 16);
-                else if (memcmp(line, "V0", i) == 0) ini_v0 = strtoul(line+i+1, NULL, 16);
-                else if (memcmp(line, "V1", i) == 0) ini_v1 = strtoul(line+i+1, NULL, 16);
-                else if (memcmp(line, "Game", i) == 0) ini_game = strtoul(line+i+1, NULL, 16);
-                else if (memcmp(line, "XexHash", i) == 0) ini_xexhash = strtoul(line+i+1, NULL, 16);
+                if (memcmp(line, "DMI", i) == 0 && check->ini_dmi_count < 30) {
+                    check->ini_dmi[check->ini_dmi_count] = strtoul(line+i+1, NULL, 16);
+                    check->ini_dmi_count++;
+                }
+                else if (memcmp(line, "SS", i) == 0) check->ini_ss = strtoul(line+i+1, NULL, 16);
+                else if (memcmp(line, "PFI", i) == 0) check->ini_pfi = strtoul(line+i+1, NULL, 16);
+                else if (memcmp(line, "Video", i) == 0) check->ini_video = strtoul(line+i+1, NULL, 16);
+                else if (memcmp(line, "RawSS", i) == 0) check->ini_rawss = strtoul(line+i+1, NULL, 16);
+                else if (memcmp(line, "V0", i) == 0) check->ini_v0 = strtoul(line+i+1, NULL, 16);
+                else if (memcmp(line, "V1", i) == 0) check->ini_v1 = strtoul(line+i+1, NULL, 16);
+                else if (memcmp(line, "Game", i) == 0) check->ini_game = strtoul(line+i+1, NULL, 16);
+                else if (memcmp(line, "XexHash", i) == 0) check->ini_xexhash = strtoul(line+i+1, NULL, 16);
 /*              else if (memcmp(line, "RegionFlags", i) == 0) memcpy(ini_regionflags, line+i+1, 8);
                 else if (memcmp(line, "MediaID", i) == 0) memcpy(ini_mediaid, line+i+1, 33); */
             }
@@ -6611,115 +7194,619 @@ void parseini() {
         printf("%s", newline);
         color(normal);
     }
-    if (debug && linesread >= MAX_INI_LINES && fgets(line, 200, inifile) != NULL) {
+    if (debug && linesread >= MAX_INI_LINES && fgets(line, 200, check->inifile) != NULL) {
         color(yellow);
-        printf("Warning: %s was longer than %d lines, is it a valid ini?%s", inifilename, MAX_INI_LINES, newline);
+        printf("Warning: %s was longer than %d lines, is it a valid ini?%s", check->inifilename, MAX_INI_LINES, newline);
         color(normal);
     }
   return;
 }
 
-FILE *openstealthfile(char *stealthfilename, char *localdir, char *webdir, int type, char *location) {
-    memset(installdirvideofilepath, 0, 2048);
-    FILE *stealthfile = NULL;
-    char fullpath[2048];
-    if (type == STEALTH_FILE || type == SMALL_VIDEO_FILE || type == GIANT_VIDEO_FILE || localonly || stayoffline) goto checklocally;
-    else goto checkonline;  // check for updated inis, ss files or topology files
-    checklocally:
-    // look for the stealth file locally
-    #ifdef WIN32
-        if (!useinstalldir && (type == SMALL_VIDEO_FILE || type == GIANT_VIDEO_FILE)) {
-            // check in the old installdir/StealthFiles folder first
-            // load the abgx360 install directory from the windows registry (written by the installer)
-            memset(fullpath, 0, 2048);
-            HKEY hkResult;
-            DWORD pcbData = sizeof(fullpath);
-            longreturnvalue = RegOpenKeyEx(HKEY_LOCAL_MACHINE, "SOFTWARE\\abgx360", 0, KEY_READ, &hkResult);
-            if (debug) printf("RegOpenKeyEx returned %ld, pcbData = %ld%s", longreturnvalue, pcbData, newline);
-            if (longreturnvalue == ERROR_SUCCESS) {
-                longreturnvalue = RegQueryValueEx(hkResult, "Install_Dir", NULL, NULL, fullpath, &pcbData);
-                if (debug) printf("ReqQueryValueEx returned %ld, pcbData = %ld%s", longreturnvalue, pcbData, newline);
-                if (longreturnvalue == ERROR_SUCCESS && strlen(fullpath)) {
-                    if (fullpath[strlen(fullpath) - 1] != '\\' && fullpath[strlen(fullpath) - 1] != '/') strcat(fullpath, "\\");
-                    strcat(fullpath, localdir);
-                    strcat(fullpath, stealthfilename);
-                    stealthfile = fopen(fullpath, "rb");
-                    if (stealthfile != NULL) {
-                        strncpy(installdirvideofilepath, fullpath, 2047);  // necessary if we need to delete the file if it's bad
-                        return stealthfile;
-                    }
-                }
-            }
+int openini(char *inifilename, char *webdir, int type, char *location) {
+    // open an ini for parseini() (or a xex ini for openinifromxexini()), or take it from the ini index if we'd only be
+    // looking for it locally anyway; returns 0 if it was found
+    FILE **inifile = (type == XEX_INI ? &check->xexinifile : &check->inifile);
+    #ifndef WIN32
+        bool *indexed = (type == XEX_INI ? &check->xexiniindexed : &check->iniindexed);
+        *indexed = false;
+        if (findindexedini(inifilename, type, type == XEX_INI ? &check->xexinientry : &check->inientry)) {
+            *inifile = NULL;
+            *indexed = true;
+          return 0;
         }
     #endif
-    memset(fullpath, 0, 2048);
-    if (!homeless) {
-        strcat(fullpath, homedir); strcat(fullpath, abgxdir); strcat(fullpath, localdir);
+    *inifile = openstealthfile(inifilename, stealthdir, webdir, type, location);
+    if (*inifile == NULL) return 1;
+  return 0;
+}
+
+void closeini(FILE **inifile) {
+    // inis that came from the ini index weren't opened
+    if (*inifile != NULL) fclose(*inifile);
+    *inifile = NULL;
+  return;
+}
+
+#ifndef WIN32
+bool findindexedini(char *inifilename, int type, struct iniindex_entry *entry) {
+    // the index only stands in for lookups openstealthfile() would do locally, and it doesn't have the ini text
+    // that extraverbose shows
+    unsigned long ss = 0, xex = 0;
+    int number = 0;
+    uint32_t kind;
+    char dir[2048];
+    bool stale = false;
+    const struct iniindex_entry *found;
+    if (!useiniindex || homeless || extraverbose || !(localonly || stayoffline)) return false;
+    if (type == XEX_INI) {
+        if (sscanf(inifilename, "Xex_%8lX.ini", &xex) != 1) return false;
+        kind = INIINDEX_XEX;
+    }
+    else if (type == UNVERIFIED_INI) {
+        if (sscanf(inifilename, "%8lX%8lX_%d.ini", &ss, &xex, &number) != 3) return false;
+        kind = INIINDEX_UNVERIFIED;
     }
-    strcat(fullpath, stealthfilename);
-    stealthfile = fopen(fullpath, "rb");
-    if (type == GIANT_VIDEO_FILE || localonly || stayoffline) return stealthfile;
-    checkonline:
-    if (stealthfile == NULL && !stayoffline) {
-        // try to find the stealth file online, this will also check locally whether the file is downloaded or not
-        printf("%sLooking for %s in %s%s", sp5, stealthfilename, location, newline);
-        memset(curlerrorbuffer, 0, CURL_ERROR_SIZE+1);
-        char fullurl[strlen(webdir) + strlen(stealthfilename) + 1];
-        sprintf(fullurl, "%s%s", webdir, stealthfilename);
-        char progressdata[13 + strlen(stealthfilename)];
-        sprintf(progressdata, "Downloading %s", stealthfilename);
-        curl_easy_reset(curl);
-        if (type == SS_FILE || type == SS_FILE_OK_IF_MISSING || type == STEALTH_FILE || type == SMALL_VIDEO_FILE || type == TOP_BIN_FILE) {
-            // gzip actually increases bandwidth usage for very small files like xex inis or topology hash files, and not really worth it for
-            // ss+xex inis due to small bandwidth savings and increased latency
-            curl_easy_setopt(curl, CURLOPT_ENCODING, "");  // If a zero-length string is set, then an Accept-Encoding: header containing
-                                                           // all supported encodings is sent.
-        }
-        curl_easy_setopt(curl, CURLOPT_USERAGENT, curluseragent);
-        curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, curlerrorbuffer);
-        curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1);
-        curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1);
-        curl_easy_setopt(curl, CURLOPT_MAXREDIRS, 0);  // refuse redirects (account is probably suspended or something and we don't
-                                                       // want to retrieve the error page as a file)
-        curl_easy_setopt(curl, CURLOPT_URL, fullurl);
-        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, connectiontimeout);
-        curl_easy_setopt(curl, CURLOPT_PROGRESSFUNCTION, (curl_progress_callback) curlprogress);
-        curl_easy_setopt(curl, CURLOPT_PROGRESSDATA, &progressdata);
-        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0);
-        if (extraverbose) curl_easy_setopt(curl, CURLOPT_VERBOSE, 1);
-        memset(fullpath, 0, 2048);
-        if (!homeless) {
-            strcat(fullpath, homedir); strcat(fullpath, abgxdir); strcat(fullpath, localdir);
-        }
-        strcat(fullpath, stealthfilename);
-        struct MyCurlFile curlstealthfile = {fullpath, NULL};
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, my_curl_write);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *) &curlstealthfile);
-        if (stat(fullpath, &buf) == 0) {
-            curl_easy_setopt(curl, CURLOPT_TIMECONDITION, 1);
-            curl_easy_setopt(curl, CURLOPT_TIMEVALUE, buf.st_mtime);
-            if (debug) printf("%s: buf.st_mtime = %ld%s", fullpath, (long) buf.st_mtime, newline);
-        }
-        else {
-            curl_easy_setopt(curl, CURLOPT_TIMECONDITION, 0);
-            if (debug) printf("stat failed for %s (%s)%s", fullpath, strerror(errno), newline);
-        }
-        curlheaderprinted = false;
-        if (extraverbose) fprintf(stderr, "\n");
+    else {
+        if (sscanf(inifilename, "%8lX%8lX.ini", &ss, &xex) != 2) return false;
+        kind = INIINDEX_SSXEX;
+    }
+    pthread_mutex_lock(&iniindexlock);
+    if (!iniindexopened) {
+        iniindexopened = true;
+        buildiniindex(false);
+    }
+    found = iniindex_find(&iniindex, kind, (uint32_t) ss, (uint32_t) xex, (uint32_t) number);
+    if (found != NULL) {
+        // an ini that was rewritten in place (by something other than us) doesn't make the whole index stale, so
+        // make sure this one is still what was indexed
+        snprintf(dir, sizeof(dir), "%s%s%s", homedir, abgxdir, stealthdir);
+        if (iniindex_current(found, dir)) *entry = *found;
+        else stale = true;
+    }
+    pthread_mutex_unlock(&iniindexlock);
+    if (stale) {
+        if (debug) printf("%s changed since it was indexed, the ini index will be rebuilt%s", inifilename, newline);
+        invalidateiniindex();
+      return false;
+    }
+    if (debug) printf("%s was %sfound in the ini index%s", inifilename, found == NULL ? "not " : "", newline);
+  return found != NULL;
+}
+
+int buildiniindex(bool force) {
+    // open the ini index, rebuilding it first if it's missing, the StealthFiles folder changed since it was built or force is true
+    // (inis rewritten in place are caught when they're looked up, see findindexedini)
+    char filename[2048], dir[2048];
+    unsigned long count;
+    snprintf(filename, sizeof(filename), "%s%s%s", homedir, abgxdir, iniindexfilename);
+    snprintf(dir, sizeof(dir), "%s%s%s", homedir, abgxdir, stealthdir);
+    iniindex_close(&iniindex);
+    if (!force && iniindex_open(&iniindex, filename, dir) == 0) return 0;
+    if (iniindex_build(filename, dir, &count) != 0) {
+        color(yellow);
+        printf("Failed to build the ini index '%s' (%s)%s", filename, strerror(errno), newline);
+        color(normal);
+      return 1;
+    }
+    if (force) printf("Rebuilt the ini index with %lu inis from '%s'%s", count, dir, newline);
+    else if (debug) printf("Rebuilt the ini index with %lu inis from '%s'%s", count, dir, newline);
+    if (iniindex_open(&iniindex, filename, dir) != 0) {
+        // the folder changed again while we were reading it, the next check will try again
+        if (debug) printf("The ini index is already out of date%s", newline);
+        iniindexopened = false;
+      return 1;
+    }
+  return 0;
+}
+
+void invalidateiniindex() {
+    // an ini was downloaded, updated or deleted (updating one doesn't change the folder's mtime), so the index needs
+    // to be rebuilt before it's used again
+    char filename[2048];
+    if (homeless) return;
+    snprintf(filename, sizeof(filename), "%s%s%s", homedir, abgxdir, iniindexfilename);
+    pthread_mutex_lock(&iniindexlock);
+    iniindex_close(&iniindex);
+    iniindexopened = false;
+    remove(filename);
+    pthread_mutex_unlock(&iniindexlock);
+  return;
+}
+
+void addtostealthstore(char *stealthfilename, char *localdir) {
+    // AutoFix has just verified this stealth file, keep it in the store so it can be trusted next time without being
+    // verified again (and shares one copy with any identical file that's already there)
+    char dir[2048];
+    int result;
+    if (!usestealthstore || homeless) return;
+    snprintf(dir, sizeof(dir), "%s%s%s", homedir, abgxdir, localdir);
+    lockshared();
+    result = stealthstore_insert(dir, stealthfilename);
+    unlockshared();
+    if (result == -1) {
+        if (debug) printf("Failed to add %s to the stealth file store (%s)%s", stealthfilename, strerror(errno), newline);
+      return;
+    }
+    if (debug) printf("stealthstore_insert(%s) returned %d%s", stealthfilename, result, newline);
+    if (verbose && result == STEALTHSTORE_DEDUPLICATED) printf("%s%s is identical to a file already in the stealth file store, they now share one copy%s", sp5, stealthfilename, newline);
+  return;
+}
+
+bool stealthfiletrusted(char *stealthfilename, char *localdir, FILE *stream) {
+    // true if stream is still the object this stealth file was verified as when addtostealthstore() stored it
+    char dir[2048];
+    if (!usestealthstore || homeless || stream == NULL) return false;
+    snprintf(dir, sizeof(dir), "%s%s%s", homedir, abgxdir, localdir);
+  return stealthstore_trusted(dir, stealthfilename, fileno(stream));
+}
+
+int dogcstealthfiles() {
+    char dir[2048];
+    struct stealthstore_gcstats stats;
+    snprintf(dir, sizeof(dir), "%s%s%s", homedir, abgxdir, stealthdir);
+    printf("Cleaning up the stealth file store in '%s'...%s", dir, newline);
+    if (stealthstore_gc(dir, &stats) != 0) {
+        color(yellow);
+        printf("ERROR: Failed to clean up the stealth file store (%s)%s", strerror(errno), newline);
+        color(normal);
+      return 1;
+    }
+    printf("Removed %lu unused stealth file%s and %lu stale name%s, deduplicated %lu file%s, %.1f MB reclaimed%s",
+           stats.objectsremoved, stats.objectsremoved == 1 ? "" : "s", stats.stalenames, stats.stalenames == 1 ? "" : "s",
+           stats.filesdeduplicated, stats.filesdeduplicated == 1 ? "" : "s", (double) stats.bytesreclaimed / 1048576, newline);
+  return 0;
+}
+
+FILE *openpackedvideofile(char *fullpath) {
+    // open the packed copy of a video file that isn't there (errno is left as it was if there's no packed copy either)
+    char packedpath[2048+sizeof(VIDEOPACK_SUFFIX)];
+    int error = errno;
+    FILE *stream;
+    snprintf(packedpath, sizeof(packedpath), "%s%s", fullpath, VIDEOPACK_SUFFIX);
+    stream = videopack_fopen(packedpath, 0);
+    if (stream == NULL) {
+        if (errno != ENOENT) {
+            color(yellow);
+            printf("ERROR: Failed to open '%s' (%s)%s", packedpath, strerror(errno), newline);
+            color(normal);
+        }
+        errno = error;
+      return NULL;
+    }
+    if (debug) printf("opened packed video file '%s'%s", packedpath, newline);
+  return stream;
+}
+
+int dopackvideofiles() {
+    // compress every Video_XXXXXXXX.iso in the StealthFiles folder into a packed file that openstealthfile() opens
+    // in its place
+    char dir[2048], path[2048+32], packedpath[2048+32+sizeof(VIDEOPACK_SUFFIX)];
+    unsigned long long originalsize, packedsize, totaloriginal = 0, totalpacked = 0;
+    unsigned long crc;
+    int packed = 0, failed = 0;
+    struct dirent *ep;
+    DIR *dp;
+    snprintf(dir, sizeof(dir), "%s%s%s", homedir, abgxdir, stealthdir);
+    dp = opendir(dir);
+    if (dp == NULL) {
+        color(yellow);
+        printf("ERROR: Failed to open '%s' (%s)%s", dir, strerror(errno), newline);
+        color(normal);
+      return 1;
+    }
+    while ((ep = readdir(dp)) != NULL) {
+        if (strlen(ep->d_name) != 18 || strncmp(ep->d_name, "Video_", 6) != 0 || strcasecmp(ep->d_name + 14, ".iso") != 0) continue;
+        snprintf(path, sizeof(path), "%s%s", dir, ep->d_name);
+        snprintf(packedpath, sizeof(packedpath), "%s%s", path, VIDEOPACK_SUFFIX);
+        if (videopack_pack(path, packedpath, 0, Z_DEFAULT_COMPRESSION, &originalsize, &packedsize, &crc) != 0) {
+            color(yellow);
+            printf("ERROR: Failed to pack %s (%s)%s", ep->d_name, strerror(errno), newline);
+            color(normal);
+            failed++;
+          continue;
+        }
+        // the packed file was read back and checked against the original before it replaced anything
+        remove(path);
+        stealthstore_forget(dir, ep->d_name);
+        printf("Packed %s: %.1f MB -> %.1f MB%s", ep->d_name, (double) originalsize / 1048576, (double) packedsize / 1048576, newline);
+        totaloriginal += originalsize;
+        totalpacked += packedsize;
+        packed++;
+    }
+    closedir(dp);
+    if (packed) printf("Packed %d Video file%s, %.1f MB reclaimed%s", packed, packed == 1 ? "" : "s",
+                       (double) (totaloriginal - totalpacked) / 1048576, newline);
+    else if (!failed) printf("There are no Video files to pack in '%s'%s", dir, newline);
+  return failed ? 1 : 0;
+}
+
+#define MAX_PREFETCH_FILES 64  // per batch
+
+// one run of the prefetch, which startprefetch() lets go on in the background while the image is being read, so it
+// only uses what the check knew when it started and keeps its results to itself until waitforprefetch()
+struct prefetchjob {
+    struct prefetch *pf;
+    unsigned long ss_crc32, xex_crc32, dmi_crc32, pfi_crc32, video_crc32;  // video_crc32 is 0 if it wasn't known yet
+    bool nukedmi, drtfucked, autofix;
+    struct prefetch_file *results;  // the answers the server gave
+    int numresults;
+};
+
+struct prefetch_file *findprefetchresult(struct prefetch_file *results, int numresults, char *stealthfilename) {
+    int i;
+    for (i=0;i<numresults;i++) {
+        if (strcmp(results[i].name, stealthfilename) == 0) return &results[i];
+    }
+  return NULL;
+}
+
+struct prefetch_file *findprefetched(char *stealthfilename) {
+    // only the results of a job that's finished (openstealthfile() can run while one is still going)
+  return findprefetchresult(check->prefetched, check->numprefetched, stealthfilename);
+}
+
+void forgetprefetched(char *stealthfilename) {
+    // the file is being deleted, so openstealthfile() has to ask the server for it again next time
+    struct prefetch_file *found = findprefetched(stealthfilename);
+    if (found == NULL) return;
+    check->numprefetched--;
+    if (found != &check->prefetched[check->numprefetched]) *found = check->prefetched[check->numprefetched];
+  return;
+}
+
+bool addprefetchfile(struct prefetchjob *job, struct prefetch_file *files, int *numfiles, char *stealthfilename, char *webdir,
+                     bool compressed, bool onlyifmissing) {
+    // add stealthfilename to the batch unless it's already in it or was already prefetched, or it's one of the files
+    // openstealthfile() only downloads when they're missing (onlyifmissing) and we already have it
+    struct prefetch_file *file;
+    if (*numfiles == MAX_PREFETCH_FILES || findprefetchresult(job->results, job->numresults, stealthfilename) != NULL ||
+        findprefetchresult(files, *numfiles, stealthfilename) != NULL) return false;
+    file = &files[*numfiles];
+    memset(file, 0, sizeof(struct prefetch_file));
+    strncpy(file->name, stealthfilename, sizeof(file->name) - 1);
+    snprintf(file->url, sizeof(file->url), "%s%s", webdir, stealthfilename);
+    if (homeless) snprintf(file->path, sizeof(file->path), "%s", stealthfilename);
+    else snprintf(file->path, sizeof(file->path), "%s%s%s%s", homedir, abgxdir, stealthdir, stealthfilename);
+    if (onlyifmissing && stat(file->path, &buf) == 0) return false;
+    if (onlyifmissing && strncmp(stealthfilename, "Video_", 6) == 0) {
+        // or a packed copy of it
+        char packedpath[sizeof(file->path) + sizeof(VIDEOPACK_SUFFIX)];
+        snprintf(packedpath, sizeof(packedpath), "%s%s", file->path, VIDEOPACK_SUFFIX);
+        if (stat(packedpath, &buf) == 0) return false;
+    }
+    file->compressed = compressed;
+    (*numfiles)++;
+  return true;
+}
+
+int runprefetch(struct prefetchjob *job, struct prefetch_file *files, int numfiles) {
+    // download a batch at once and keep the answers the server gave, returns 1 if none of the files got an answer
+    struct prefetch_file *grown;
+    int i, answered = 0;
+    bool newini = false;
+    unsigned long startmsecs;
+    int result;
+    if (numfiles == 0) return 0;
+    startmsecs = getmsecs();
+    lockshared();
+    result = prefetch_run(job->pf, files, numfiles, curluseragent, connectiontimeout, extraverbose);
+    unlockshared();
+    if (result == -1) {
+        if (debug) printf("prefetch_run failed to set up cURL%s", newline);
+      return 1;
+    }
+    grown = (struct prefetch_file *) realloc(job->results, (job->numresults + numfiles) * sizeof(struct prefetch_file));
+    if (grown == NULL) return 1;
+    job->results = grown;
+    for (i=0;i<numfiles;i++) {
+        if (debug) printf("prefetch %s: result = %d, curlcode = %d, httpcode = %ld, error = '%s'%s",
+                          files[i].url, files[i].result, (int) files[i].curlcode, files[i].httpcode, files[i].error, newline);
+        // no answer at all (couldn't connect, timed out...) is left for openstealthfile() to find out again, it's what
+        // disables online functions when the db is down
+        if (files[i].curlcode != CURLE_OK && files[i].curlcode != CURLE_HTTP_RETURNED_ERROR) continue;
+        if (files[i].result == PREFETCH_DOWNLOADED && strlen(files[i].name) > 4 &&
+            strcasecmp(files[i].name + strlen(files[i].name) - 4, ".ini") == 0) newini = true;
+        job->results[job->numresults++] = files[i];
+        answered++;
+    }
+    // a new or updated ini means the ini index is out of date
+    if (newini) invalidateiniindex();
+    if (debug) printf("prefetched %d of %d files in %lu ms%s", answered, numfiles, getmsecs() - startmsecs, newline);
+  return answered == 0;
+}
+
+void runprefetchjob(struct prefetchjob *job) {
+    // ask the server for what doverify() and doautofix() are going to open with openstealthfile() in a few batches of
+    // concurrent requests instead of one request after another: the SS/Xex and Xex inis, then the SS/Xex inis listed in
+    // the Xex ini, then (if AutoFix could run) the stealth files AutoFix would take from those inis
+    struct prefetch_file *files, *found;
+    struct iniindex_entry xexentry, entry;
+    char inifilename[40], xexinifilename[32], stealthfilename[32];
+    int i, j, numfiles = 0;
+    unsigned long m;
+    bool keepdmi;
+    files = (struct prefetch_file *) calloc(MAX_PREFETCH_FILES, sizeof(struct prefetch_file));
+    if (files == NULL) return;
+    if (job->ss_crc32 != 0) {
+        sprintf(inifilename, "%08lX%08lX.ini", job->ss_crc32, job->xex_crc32);
+        addprefetchfile(job, files, &numfiles, inifilename, webinidir, false, false);
+    }
+    sprintf(xexinifilename, "Xex_%08lX.ini", job->xex_crc32);
+    addprefetchfile(job, files, &numfiles, xexinifilename, webinidir, false, false);
+    if (runprefetch(job, files, numfiles) != 0) goto done;
+    found = findprefetchresult(job->results, job->numresults, xexinifilename);
+    if (found == NULL || found->result == PREFETCH_FAILED || iniindex_parsefile(found->path, INIINDEX_XEX, &xexentry) != 0) goto done;
+    numfiles = 0;
+    for (i=0;i<(int) xexentry.count;i++) {
+        sprintf(inifilename, "%08lX%08lX.ini", (unsigned long) xexentry.crcs[i], job->xex_crc32);
+        addprefetchfile(job, files, &numfiles, inifilename, webinidir, false, false);
+    }
+    if (runprefetch(job, files, numfiles) != 0 || !job->autofix) goto done;
+    // same conditions doautofix() uses to decide which stealth files it needs
+    numfiles = 0;
+    for (i=0;i<(int) xexentry.count;i++) {
+        sprintf(inifilename, "%08lX%08lX.ini", (unsigned long) xexentry.crcs[i], job->xex_crc32);
+        found = findprefetchresult(job->results, job->numresults, inifilename);
+        if (found == NULL || found->result == PREFETCH_FAILED || iniindex_parsefile(found->path, INIINDEX_SSXEX, &entry) != 0) continue;
+        if ((job->nukedmi || entry.ini_ss != job->ss_crc32 || job->drtfucked) && entry.ini_ss != 0) {
+            sprintf(stealthfilename, "SS_%08lX.bin", (unsigned long) entry.ini_ss);
+            addprefetchfile(job, files, &numfiles, stealthfilename, webstealthdir, true, false);
+        }
+        keepdmi = false;
+        if (!job->nukedmi) {
+            for (j=0;j<(int) entry.count;j++) {
+                if (entry.crcs[j] == job->dmi_crc32) keepdmi = true;
+            }
+        }
+        if (!keepdmi) {
+            // AutoFix picks one of them at random
+            for (j=0;j<(int) entry.count;j++) {
+                if (entry.crcs[j] == 0) continue;
+                sprintf(stealthfilename, "DMI_%08lX.bin", (unsigned long) entry.crcs[j]);
+                addprefetchfile(job, files, &numfiles, stealthfilename, webstealthdir, true, true);
+            }
+        }
+        if (entry.pfi != 0 && entry.pfi != job->pfi_crc32) {
+            sprintf(stealthfilename, "PFI_%08lX.bin", (unsigned long) entry.pfi);
+            addprefetchfile(job, files, &numfiles, stealthfilename, webstealthdir, true, true);
+        }
+        if (job->video_crc32 != 0 && entry.video != 0 && entry.video != job->video_crc32) {
+            // only the small video files are hosted
+            for (m=0;m<num_videoentries;m++) {
+                if (entry.video == mostrecentvideoentries[m].crc) {
+                    if (mostrecentvideoentries[m].hosted) {
+                        sprintf(stealthfilename, "Video_%08lX.iso", (unsigned long) entry.video);
+                        addprefetchfile(job, files, &numfiles, stealthfilename, webstealthdir, true, true);
+                    }
+                  break;
+                }
+            }
+        }
+    }
+    runprefetch(job, files, numfiles);
+    
+    done:
+    free(files);
+  return;
+}
+
+void *prefetchthread(void *arg) {
+    runprefetchjob((struct prefetchjob *) arg);
+  return NULL;
+}
+
+struct prefetchjob *newprefetchjob() {
+    // returns NULL if there's nothing to prefetch for this check (or it was already done)
+    struct prefetchjob *job;
+    if (check->prefetchdone || check->prefetchjob != NULL || !stealthprefetch || localonly || stayoffline || check->xex_crc32 == 0) return NULL;
+    job = (struct prefetchjob *) calloc(1, sizeof(struct prefetchjob));
+    if (job == NULL) return NULL;
+    job->pf = &prefetcher;
+    job->ss_crc32 = check->ss_crc32; job->xex_crc32 = check->xex_crc32; job->dmi_crc32 = check->dmi_crc32;
+    job->pfi_crc32 = check->pfi_crc32; job->video_crc32 = check->video_crc32;
+    job->nukedmi = should_nuke_dmi(); job->drtfucked = check->drtfucked;
+    job->autofix = autofix && check->writefile;
+    check->prefetchdone = true;
+  return job;
+}
+
+void startprefetch() {
+    // start the lookups for Verification/AutoFix now (the SS and Xex CRCs are known) and let them run while the Video
+    // and Game CRCs are being computed, doverify() and doautofix() wait for them in prefetchstealthfiles()
+    struct prefetchjob *job;
+    if (!verify && !autofix) return;
+    job = newprefetchjob();
+    if (job == NULL) return;
+    if (pthread_create(&check->prefetchthread, NULL, prefetchthread, (void *) job) != 0) {
+        // they'll just be done later instead
+        if (debug) printf("startprefetch - pthread_create failed (%s)%s", strerror(errno), newline);
+        free(job);
+        check->prefetchdone = false;
+      return;
+    }
+    check->prefetchjob = job;
+  return;
+}
+
+void finishprefetchjob(struct prefetchjob *job) {
+    // hand the results over to openstealthfile()
+    struct prefetch_file *grown;
+    if (job->numresults) {
+        grown = (struct prefetch_file *) realloc(check->prefetched, (check->numprefetched + job->numresults) * sizeof(struct prefetch_file));
+        if (grown != NULL) {
+            check->prefetched = grown;
+            memcpy(check->prefetched + check->numprefetched, job->results, job->numresults * sizeof(struct prefetch_file));
+            check->numprefetched += job->numresults;
+        }
+    }
+    free(job->results);
+    free(job);
+  return;
+}
+
+void waitforprefetch() {
+    // join the background prefetch if there is one
+    struct prefetchjob *job = check->prefetchjob;
+    unsigned long startmsecs;
+    if (job == NULL) return;
+    startmsecs = getmsecs();
+    pthread_join(check->prefetchthread, NULL);
+    if (debug) printf("waited %lu ms for the prefetch to finish%s", getmsecs() - startmsecs, newline);
+    check->prefetchjob = NULL;
+    finishprefetchjob(job);
+  return;
+}
+
+void prefetchstealthfiles() {
+    // called before doverify() and doautofix() open anything: wait for the background prefetch if startprefetch()
+    // started one, otherwise do it now
+    struct prefetchjob *job;
+    if (check->prefetchjob != NULL) {
+        waitforprefetch();
+      return;
+    }
+    job = newprefetchjob();
+    if (job == NULL) return;
+    runprefetchjob(job);
+    finishprefetchjob(job);
+  return;
+}
+#endif
+
+FILE *openstealthfile(char *stealthfilename, char *localdir, char *webdir, int type, char *location) {
+    memset(installdirvideofilepath, 0, 2048);
+    FILE *stealthfile = NULL;
+    char fullpath[2048];
+    if (type == STEALTH_FILE || type == SMALL_VIDEO_FILE || type == GIANT_VIDEO_FILE || localonly || stayoffline) goto checklocally;
+    else goto checkonline;  // check for updated inis, ss files or topology files
+    checklocally:
+    // look for the stealth file locally
+    #ifdef WIN32
+        if (!useinstalldir && (type == SMALL_VIDEO_FILE || type == GIANT_VIDEO_FILE)) {
+            // check in the old installdir/StealthFiles folder first
+            // load the abgx360 install directory from the windows registry (written by the installer)
+            memset(fullpath, 0, 2048);
+            HKEY hkResult;
+            DWORD pcbData = sizeof(fullpath);
+            longreturnvalue = RegOpenKeyEx(HKEY_LOCAL_MACHINE, "SOFTWARE\\abgx360", 0, KEY_READ, &hkResult);
+            if (debug) printf("RegOpenKeyEx returned %ld, pcbData = %ld%s", longreturnvalue, pcbData, newline);
+            if (longreturnvalue == ERROR_SUCCESS) {
+                longreturnvalue = RegQueryValueEx(hkResult, "Install_Dir", NULL, NULL, fullpath, &pcbData);
+                if (debug) printf("ReqQueryValueEx returned %ld, pcbData = %ld%s", longreturnvalue, pcbData, newline);
+                if (longreturnvalue == ERROR_SUCCESS && strlen(fullpath)) {
+                    if (fullpath[strlen(fullpath) - 1] != '\\' && fullpath[strlen(fullpath) - 1] != '/') strcat(fullpath, "\\");
+                    strcat(fullpath, localdir);
+                    strcat(fullpath, stealthfilename);
+                    stealthfile = fopen(fullpath, "rb");
+                    if (stealthfile != NULL) {
+                        strncpy(installdirvideofilepath, fullpath, 2047);  // necessary if we need to delete the file if it's bad
+                        return stealthfile;
+                    }
+                }
+            }
+        }
+    #endif
+    memset(fullpath, 0, 2048);
+    if (!homeless) {
+        strcat(fullpath, homedir); strcat(fullpath, abgxdir); strcat(fullpath, localdir);
+    }
+    strcat(fullpath, stealthfilename);
+    stealthfile = fopen(fullpath, "rb");
+    #ifndef WIN32
+        if (stealthfile == NULL && (type == SMALL_VIDEO_FILE || type == GIANT_VIDEO_FILE)) stealthfile = openpackedvideofile(fullpath);
+    #endif
+    if (type == GIANT_VIDEO_FILE || localonly || stayoffline) return stealthfile;
+    checkonline:
+    if (stealthfile == NULL && !stayoffline) {
+        // try to find the stealth file online, this will also check locally whether the file is downloaded or not
+        printf("%sLooking for %s in %s%s", sp5, stealthfilename, location, newline);
+        memset(curlerrorbuffer, 0, CURL_ERROR_SIZE+1);
+        char fullurl[strlen(webdir) + strlen(stealthfilename) + 1];
+        sprintf(fullurl, "%s%s", webdir, stealthfilename);
+        char progressdata[13 + strlen(stealthfilename)];
+        sprintf(progressdata, "Downloading %s", stealthfilename);
+        memset(fullpath, 0, 2048);
+        if (!homeless) {
+            strcat(fullpath, homedir); strcat(fullpath, abgxdir); strcat(fullpath, localdir);
+        }
+        strcat(fullpath, stealthfilename);
+        struct MyCurlFile curlstealthfile = {fullpath, NULL};
+        #ifndef WIN32
+            // prefetchstealthfiles() already asked the server for this file
+            struct prefetch_file *prefetchedfile = findprefetched(stealthfilename);
+            if (prefetchedfile != NULL) {
+                if (debug) printf("%s was prefetched (result = %d)%s", stealthfilename, prefetchedfile->result, newline);
+                check->curlheaderprinted = false;
+                res = prefetchedfile->curlcode;
+                if (res == CURLE_OK) {
+                    color(normal);
+                    if (prefetchedfile->result == PREFETCH_NOTMODIFIED) printf("%sServer file %s no newer than local file - not retrieving%s", sp5, stealthfilename, newline);
+                    else printf("%s%s was downloaded successfully%s", sp5, stealthfilename, newline);
+                  goto prefetched;
+                }
+                strncpy(curlerrorbuffer, prefetchedfile->error, CURL_ERROR_SIZE);
+              goto prefetchfailed;
+            }
+            // another batch job could be downloading the same file
+            lockshared();
+        #endif
+        curl_easy_reset(curl);
+        if (type == SS_FILE || type == SS_FILE_OK_IF_MISSING || type == STEALTH_FILE || type == SMALL_VIDEO_FILE || type == TOP_BIN_FILE) {
+            // gzip actually increases bandwidth usage for very small files like xex inis or topology hash files, and not really worth it for
+            // ss+xex inis due to small bandwidth savings and increased latency
+            curl_easy_setopt(curl, CURLOPT_ENCODING, "");  // If a zero-length string is set, then an Accept-Encoding: header containing
+                                                           // all supported encodings is sent.
+        }
+        curl_easy_setopt(curl, CURLOPT_USERAGENT, curluseragent);
+        curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, curlerrorbuffer);
+        curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1);
+        curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1);
+        curl_easy_setopt(curl, CURLOPT_MAXREDIRS, 0);  // refuse redirects (account is probably suspended or something and we don't
+                                                       // want to retrieve the error page as a file)
+        curl_easy_setopt(curl, CURLOPT_URL, fullurl);
+        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, connectiontimeout);
+        curl_easy_setopt(curl, CURLOPT_PROGRESSFUNCTION, (curl_progress_callback) curlprogress);
+        curl_easy_setopt(curl, CURLOPT_PROGRESSDATA, &progressdata);
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0);
+        if (extraverbose) curl_easy_setopt(curl, CURLOPT_VERBOSE, 1);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, my_curl_write);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *) &curlstealthfile);
+        if (stat(fullpath, &buf) == 0) {
+            curl_easy_setopt(curl, CURLOPT_TIMECONDITION, 1);
+            curl_easy_setopt(curl, CURLOPT_TIMEVALUE, buf.st_mtime);
+            if (debug) printf("%s: buf.st_mtime = %ld%s", fullpath, (long) buf.st_mtime, newline);
+        }
+        else {
+            curl_easy_setopt(curl, CURLOPT_TIMECONDITION, 0);
+            if (debug) printf("stat failed for %s (%s)%s", fullpath, strerror(errno), newline);
+        }
+        check->curlheaderprinted = false;
+        if (extraverbose) fprintf(stderr, "\n");
         printstderr = true;
         color(blue);
         curlprogressstartmsecs = getmsecs();
         res = curl_easy_perform(curl);
         color(normal);
         printstderr = false;
-        if (extraverbose || curlheaderprinted) fprintf(stderr, "\n");
+        if (extraverbose || check->curlheaderprinted) fprintf(stderr, "\n");
+        if (curlstealthfile.stream != NULL) {
+            fclose(curlstealthfile.stream);
+            #ifndef WIN32
+                // a new or updated ini means the ini index is out of date
+                if (type == XEX_INI || type == SSXEX_INI || type == SSXEX_INI_FROM_XEX_INI || type == UNVERIFIED_INI) invalidateiniindex();
+            #endif
+        }
+        #ifndef WIN32
+            unlockshared();
+            prefetchfailed:
+        #endif
         if (res != CURLE_OK) {  // error occurred
             if (res == CURLE_HTTP_RETURNED_ERROR) {
                 if (strstr(curlerrorbuffer, "404") != NULL) {
                     if (type == XEX_INI) {
                         // verified xex.ini that may or may not exist
                         color(yellow);
-                        printf("%sThere is no verified rip of Xex CRC %08lX in the online database%s", sp5, xex_crc32, newline);
+                        printf("%sThere is no verified rip of Xex CRC %08lX in the online database%s", sp5, check->xex_crc32, newline);
                     }
                     else if (type == SSXEX_INI) {
                         // verified ss+xex.ini that may or may not exist
@@ -6777,10 +7864,12 @@ FILE *openstealthfile(char *stealthfilename, char *localdir, char *webdir, int t
             color(normal);
             printcurlinfo(curl, stealthfilename);
         }
-        if (curlstealthfile.stream != NULL) fclose(curlstealthfile.stream);
         if (extraverbose) {
             curl_easy_setopt(curl, CURLOPT_VERBOSE, 0);  // reset to avoid annoying "Closing Connection ..." atexit
         }
+        #ifndef WIN32
+            prefetched:
+        #endif
         color(normal);
         
         if (type == SS_FILE_OK_IF_MISSING && res != CURLE_OK) stealthfile = NULL;  // we were just checking to see if an ss.bin exists in the db
@@ -6821,27 +7910,27 @@ int trytoreadstealthfile(void *ptr, size_t size, size_t nmemb, FILE *stream, cha
     }
     if (fread(ptr, size, nmemb, stream) < nmemb) {
         charsprinted = 0;
-        readerrorstotal = 0;
+        check->readerrorstotal = 0;
         printstderr = true;
         color(yellow);
         for (i=0;i<readretries;i++) {
-            readerrorstotal++;
+            check->readerrorstotal++;
             resetstderr();
-            charsprinted = fprintf(stderr, "ERROR: Read error while reading %s [%lu retries]", filename, readerrorstotal);
+            charsprinted = fprintf(stderr, "ERROR: Read error while reading %s [%lu retries]", filename, check->readerrorstotal);
             if (fseeko(stream, offset, SEEK_SET) != 0) {
                 printseekerror(filename, "Reading stealth file");
               return 1;
             }
             if (fread(ptr, size, nmemb, stream) == nmemb) {
                 closestderr();
-                printf("%s read error recovered [%lu retries]%s", filename, readerrorstotal, newline);
+                printf("%s read error recovered [%lu retries]%s", filename, check->readerrorstotal, newline);
               return 0;
             }
         }
         // unrecovered error
         closestderr();
         color(red);
-        printf("ERROR: Unrecoverable read error while reading %s! [%lu retries]%s", filename, readerrorstotal, newline);
+        printf("ERROR: Unrecoverable read error while reading %s! [%lu retries]%s", filename, check->readerrorstotal, newline);
         color(normal);
       return 1;
     }
@@ -6856,13 +7945,13 @@ int trytowritestealthfile(const void *ptr, size_t size, size_t nmemb, FILE *stre
     }
     if (fwrite(ptr, size, nmemb, stream) < nmemb) {
         charsprinted = 0;
-        writeerrorstotal = 0;
+        check->writeerrorstotal = 0;
         printstderr = true;
         color(yellow);
         for (i=0;i<readretries;i++) {
-            writeerrorstotal++;
+            check->writeerrorstotal++;
             resetstderr();
-            charsprinted = fprintf(stderr, "ERROR: Write error while writing %s [%lu retries]", filename, writeerrorstotal);
+            charsprinted = fprintf(stderr, "ERROR: Write error while writing %s [%lu retries]", filename, check->writeerrorstotal);
             if (fseeko(stream, offset, SEEK_SET) != 0) {
                 printstderr = false;
                 printseekerror(filename, "Writing stealth file");
@@ -6870,14 +7959,14 @@ int trytowritestealthfile(const void *ptr, size_t size, size_t nmemb, FILE *stre
             }
             if (fwrite(ptr, size, nmemb, stream) == nmemb) {
                 closestderr();
-                printf("%s write error recovered [%lu retries]%s", filename, writeerrorstotal, newline);
+                printf("%s write error recovered [%lu retries]%s", filename, check->writeerrorstotal, newline);
               return 0;
             }
         }
         // unrecovered error
         closestderr();
         color(red);
-        printf("ERROR: Unrecoverable write error while writing %s! [%lu retries]%s", filename, writeerrorstotal, newline);
+        printf("ERROR: Unrecoverable write error while writing %s! [%lu retries]%s", filename, check->writeerrorstotal, newline);
         color(normal);
       return 1;
     }
@@ -6886,51 +7975,51 @@ int trytowritestealthfile(const void *ptr, size_t size, size_t nmemb, FILE *stre
 
 void initcheckread() {
     charsprinted = 0;
-    readerrorstotal = 0;
-    readerrorsrecovered = 0;
+    check->readerrorstotal = 0;
+    check->readerrorsrecovered = 0;
   return;
 }
 
 void initcheckwrite() {
     charsprinted = 0;
-    writeerrorstotal = 0;
-    writeerrorsrecovered = 0;
+    check->writeerrorstotal = 0;
+    check->writeerrorsrecovered = 0;
   return;
 }
 
 void donecheckread(char *name) {
-    if (readerrorstotal > 0) {
+    if (check->readerrorstotal > 0) {
         closestderr();
         if (filecount > 1) {
-            if (readerrorstotal == 1) printf("%s read error was recovered [%lu recovered / 1 retry]%s",
-                                              name, readerrorsrecovered, newline);
+            if (check->readerrorstotal == 1) printf("%s read error was recovered [%lu recovered / 1 retry]%s",
+                                              name, check->readerrorsrecovered, newline);
             else printf("%s read errors were recovered [%lu recovered / %lu retries]%s",
-                         name, readerrorsrecovered, readerrorstotal, newline);
+                         name, check->readerrorsrecovered, check->readerrorstotal, newline);
         }
         else {
-            if (readerrorstotal == 1) printf("A read error was recovered [%lu recovered / 1 retry]%s",
-                                              readerrorsrecovered, newline);
+            if (check->readerrorstotal == 1) printf("A read error was recovered [%lu recovered / 1 retry]%s",
+                                              check->readerrorsrecovered, newline);
             else printf("Read errors were recovered [%lu recovered / %lu retries]%s",
-                         readerrorsrecovered, readerrorstotal, newline);
+                         check->readerrorsrecovered, check->readerrorstotal, newline);
         }
     }
   return;
 }
 
 void donecheckwrite(char *name) {
-    if (writeerrorstotal > 0) {
+    if (check->writeerrorstotal > 0) {
         closestderr();
         if (filecount > 1) {
-            if (writeerrorstotal == 1) printf("%s write error was recovered [%lu recovered / 1 retry]%s",
-                                               name, writeerrorsrecovered, newline);
+            if (check->writeerrorstotal == 1) printf("%s write error was recovered [%lu recovered / 1 retry]%s",
+                                               name, check->writeerrorsrecovered, newline);
             else printf("%s write errors were recovered [%lu recovered / %lu retries]%s",
-                         name, writeerrorsrecovered, writeerrorstotal, newline);
+                         name, check->writeerrorsrecovered, check->writeerrorstotal, newline);
         }
         else {
-            if (writeerrorstotal == 1) printf("A write error was recovered [%lu recovered / 1 retry]%s",
-                                               writeerrorsrecovered, newline);
+            if (check->writeerrorstotal == 1) printf("A write error was recovered [%lu recovered / 1 retry]%s",
+                                               check->writeerrorsrecovered, newline);
             else printf("Write errors were recovered [%lu recovered / %lu retries]%s",
-                         writeerrorsrecovered, writeerrorstotal, newline);
+                         check->writeerrorsrecovered, check->writeerrorstotal, newline);
         }
     }
   return;
@@ -7012,22 +8101,22 @@ int checkreadandprinterrors(void *ptr, size_t size, size_t nmemb, FILE *stream,
                 cdb[7] = (unsigned char) (transferlength >> 8);
                 cdb[8] = (unsigned char) (transferlength & 0x000000FFL);
                 if (sendcdb(DATA_IN, newptr, transferlength*2048, cdb, 10, true)) {
-                    if (readerrorstotal == 0) {
+                    if (check->readerrorstotal == 0) {
                         printstderr = true;
                         color(yellow);
                     }
                     int i;
                     for (i=0;i<readretries;i++) {
-                        readerrorstotal++;
+                        check->readerrorstotal++;
                         resetstderr();
                         charsprinted = fprintf(stderr, "ERROR: Error reading DVD [%lu recovered / %lu retries]",
-                                                        readerrorsrecovered, readerrorstotal);
+                                                        check->readerrorsrecovered, check->readerrorstotal);
                         if (sendcdb(DATA_IN, newptr, transferlength*2048, cdb, 10, true) == 0) {
                             // recovered error
-                            readerrorsrecovered++;
+                            check->readerrorsrecovered++;
                             resetstderr();
                             charsprinted = fprintf(stderr, "ERROR: Error reading DVD [%lu recovered / %lu retries]",
-                                                            readerrorsrecovered, readerrorstotal);
+                                                            check->readerrorsrecovered, check->readerrorstotal);
                             if (nmemb < 2048 || transferlengthremainder) {
                                 memcpy(ptr, newptr, nmemb);
                                 free(newptr);
@@ -7060,7 +8149,7 @@ int checkreadandprinterrors(void *ptr, size_t size, size_t nmemb, FILE *stream,
     else {
         if (fread(ptr, size, nmemb, stream) == nmemb) return 0;
         else {
-            if (readerrorstotal == 0) {
+            if (check->readerrorstotal == 0) {
                 printstderr = true;
                 color(yellow);
             }
@@ -7074,10 +8163,10 @@ int checkreadandprinterrors(void *ptr, size_t size, size_t nmemb, FILE *stream,
             unsigned long long readoffset = (unsigned long long) loop * nmemb + startoffset;
             int i;
             for (i=0;i<readretries;i++) {
-                readerrorstotal++;
+                check->readerrorstotal++;
                 resetstderr();
                 charsprinted = fprintf(stderr, "ERROR: Error reading Input [%lu recovered / %lu retries]",
-                                                readerrorsrecovered, readerrorstotal);
+                                                check->readerrorsrecovered, check->readerrorstotal);
                 if (fseeko(stream, readoffset, SEEK_SET) != 0) {
                     closestderr();
                     printseekerror(name, action);
@@ -7085,10 +8174,10 @@ int checkreadandprinterrors(void *ptr, size_t size, size_t nmemb, FILE *stream,
                 }
                 if (fread(ptr, size, nmemb, stream) == nmemb) {
                     // recovered error
-                    readerrorsrecovered++;
+                    check->readerrorsrecovered++;
                     resetstderr();
                     charsprinted = fprintf(stderr, "ERROR: Error reading Input [%lu recovered / %lu retries]",
-                                                    readerrorsrecovered, readerrorstotal);
+                                                    check->readerrorsrecovered, check->readerrorstotal);
                   return 0;
                 }
             }
@@ -7107,7 +8196,7 @@ int checkwriteandprinterrors(const void *ptr, size_t size, size_t nmemb, FILE *s
                              char *name, char *action) {
     if (fwrite(ptr, size, nmemb, stream) == nmemb) return 0;
     else {
-        if (writeerrorstotal == 0) {
+        if (check->writeerrorstotal == 0) {
             printstderr = true;
             color(yellow);
         }
@@ -7121,19 +8210,19 @@ int checkwriteandprinterrors(const void *ptr, size_t size, size_t nmemb, FILE *s
         unsigned long long writeoffset = (unsigned long long) loop * nmemb + startoffset;
         int i;
         for (i=0;i<readretries;i++) {
-            writeerrorstotal++;
+            check->writeerrorstotal++;
             resetstderr();
-            charsprinted = fprintf(stderr, "ERROR: Error writing %s [%lu recovered / %lu retries]", name, writeerrorsrecovered, writeerrorstotal);
+            charsprinted = fprintf(stderr, "ERROR: Error writing %s [%lu recovered / %lu retries]", name, check->writeerrorsrecovered, check->writeerrorstotal);
             if (fseeko(stream, writeoffset, SEEK_SET) != 0) {
                 closestderr();
                 printseekerror(name, action);
               return 1;
             }
             if (fwrite(ptr, size, nmemb, stream) == nmemb) {  // recovered error
-                writeerrorsrecovered++;
+                check->writeerrorsrecovered++;
                 resetstderr();
                 charsprinted = fprintf(stderr, "ERROR: Error writing %s [%lu recovered / %lu retries]",
-                                                name, writeerrorsrecovered, writeerrorstotal);
+                                                name, check->writeerrorsrecovered, check->writeerrorstotal);
               return 0;
             }
         }
@@ -7149,25 +8238,26 @@ int checkwriteandprinterrors(const void *ptr, size_t size, size_t nmemb, FILE *s
 int padzeros(FILE *stream, char *filename, long long startoffset, long long endoffset) {
     unsigned long m, padzeros_sizeoverbuffer, padzeros_bufferremainder;
     if (startoffset == -1) return 1;  // seek error
-    if (!writefile) {
+    if (!check->writefile) {
         color(yellow);
         printf("Aborting Padding because writing is disabled%s", newline);
         color(normal);
       return 1;
     }
+    if (punchzeros(stream, startoffset, endoffset) == 0) return 0;
     if (endoffset - startoffset < BIGBUF_SIZE) {
-        memset(bigbuffer, 0, endoffset - startoffset);
+        memset(check->bigbuffer, 0, endoffset - startoffset);
         if (fseeko(stream, startoffset, SEEK_SET) != 0) {
             printseekerror(filename, "Padding");
           return 1;
         }
         initcheckwrite();
-        if (checkwriteandprinterrors(bigbuffer, 1, endoffset - startoffset, stream, 0, startoffset, filename, "Padding") != 0) return 1;
+        if (checkwriteandprinterrors(check->bigbuffer, 1, endoffset - startoffset, stream, 0, startoffset, filename, "Padding") != 0) return 1;
         donecheckwrite(filename);
       return 0;
     }
     else {
-        memset(bigbuffer, 0, BIGBUF_SIZE);
+        memset(check->bigbuffer, 0, BIGBUF_SIZE);
         if (fseeko(stream, startoffset, SEEK_SET) != 0) {
             printseekerror(filename, "Padding");
           return 1;
@@ -7181,11 +8271,11 @@ int padzeros(FILE *stream, char *filename, long long startoffset, long long endo
             printf("padzeros_bufferremainder = %lu%s", padzeros_bufferremainder, newline);
         }
         for (m=0;m<padzeros_sizeoverbuffer;m++) {
-            if (checkwriteandprinterrors(bigbuffer, 1, BIGBUF_SIZE, stream, m, startoffset,
+            if (checkwriteandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, stream, m, startoffset,
                                          filename, "Padding") != 0) return 1;
         }
         if (padzeros_bufferremainder) {
-            if (checkwriteandprinterrors(bigbuffer, 1, padzeros_bufferremainder, stream, 0, endoffset - padzeros_bufferremainder,
+            if (checkwriteandprinterrors(check->bigbuffer, 1, padzeros_bufferremainder, stream, 0, endoffset - padzeros_bufferremainder,
                                          filename, "Padding") != 0) return 1;
         }
         donecheckwrite(filename);
@@ -7193,6 +8283,98 @@ int padzeros(FILE *stream, char *filename, long long startoffset, long long endo
     }
 }
 
+// zero bytes [startoffset, endoffset) by punching a hole there (or having the filesystem zero the range) instead of
+// writing zeroes, returns 0 if that worked and leaves the stream at endoffset, or 1 if the zeroes have to be written
+int punchzeros(FILE *stream, unsigned long long startoffset, unsigned long long endoffset) {
+    #if !defined(WIN32) && defined(FALLOC_FL_PUNCH_HOLE)
+        struct stat st;
+        int fd = fileno(stream), result = -1;
+        if (endoffset <= startoffset) return 1;
+        if (fflush(stream) != 0 || fstat(fd, &st) != 0) return 1;
+        // a hole can't extend the file, so ranges that run past the end need zero range (which can)
+        if (endoffset <= (unsigned long long) st.st_size)
+            result = fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, (off_t) startoffset, (off_t) (endoffset - startoffset));
+        #ifdef FALLOC_FL_ZERO_RANGE
+            if (result == -1)
+                result = fallocate(fd, FALLOC_FL_ZERO_RANGE, (off_t) startoffset, (off_t) (endoffset - startoffset));
+        #endif
+        if (result == -1) {
+            if (debug) printf("fallocate failed to zero 0x%"LL"X-0x%"LL"X: %s%s", startoffset, endoffset, strerror(errno), newline);
+          return 1;
+        }
+        if (debug) printf("zeroed 0x%"LL"X-0x%"LL"X with fallocate%s", startoffset, endoffset, newline);
+        // also drops anything stdio had buffered from before
+        if (fseeko(stream, endoffset, SEEK_SET) != 0) return 1;
+      return 0;
+    #else
+        (void) stream;
+        (void) startoffset;
+        (void) endoffset;
+      return 1;
+    #endif
+}
+
+#ifndef WIN32
+void copyprogress(void *arg, unsigned long long bytesdone, unsigned long long bytestotal) {
+    unsigned long *lastpercent = (unsigned long *) arg;
+    unsigned long percent = (unsigned long) (bytesdone * 100 / bytestotal);
+    if (percent != *lastpercent) {
+        *lastpercent = percent;
+        resetstderr();
+        charsprinted = fprintf(stderr, "%lu%% done", percent);
+    }
+  return;
+}
+#endif
+
+// copy length bytes from inoffset in instream to outoffset in outstream without going through bigbuffer
+// (reflink, copy_file_range or sendfile), returns 0 if it was copied, 1 on error, or 2 if it wasn't copied
+// and the caller has to do it the old way (the streams are left at inoffset and outoffset for that), which
+// is also what happens after a read error so that the old way can retry it
+// on success the streams are left where they would be after reading and writing the data with stdio
+int copyfilerange(FILE *instream, char *infilename, unsigned long long inoffset, FILE *outstream, char *outfilename,
+                  unsigned long long outoffset, unsigned long long length, char *action, bool showprogress) {
+    #ifdef WIN32
+        (void) instream; (void) infilename; (void) inoffset; (void) outstream; (void) outfilename;
+        (void) outoffset; (void) length; (void) action; (void) showprogress;
+      return 2;
+    #else
+        const char *method;
+        unsigned long lastpercent = 101;
+        int result;
+        // a packed video file has no file descriptor to copy from
+        if (fileno(instream) == -1 || fileno(outstream) == -1) return 2;
+        if (fflush(instream) != 0 || fflush(outstream) != 0) return 2;
+        result = filecopy_range(fileno(instream), inoffset, fileno(outstream), outoffset, length,
+                                showprogress ? copyprogress : NULL, &lastpercent, &method);
+        if (result == FILECOPY_ERROR) {
+            printf("%s", newline);
+            color(red);
+            printf("ERROR: Failed to copy %"LL"u bytes from %s%s%s to %s%s%s! (%s) %s failed!%s", length,
+                   quotation, infilename, quotation, quotation, outfilename, quotation, strerror(errno), action, newline);
+            color(normal);
+          return 1;
+        }
+        if (result == FILECOPY_OK && debug) printf("%s: copied %"LL"u bytes with %s%s", action, length, method, newline);
+        if (result == FILECOPY_UNSUPPORTED && debug) printf("%s: no in-kernel copy available, using buffered i/o%s", action, newline);
+        if (result == FILECOPY_FAILED && debug) printf("%s: in-kernel copy failed (%s), starting over with buffered i/o%s",
+                                                       action, strerror(errno), newline);
+        if (result == FILECOPY_OK) {
+            inoffset += length;
+            outoffset += length;
+        }
+        if (fseeko(instream, inoffset, SEEK_SET) != 0) {
+            printseekerror(infilename, action);
+          return 1;
+        }
+        if (fseeko(outstream, outoffset, SEEK_SET) != 0) {
+            printseekerror(outfilename, action);
+          return 1;
+        }
+      return result == FILECOPY_OK ? 0 : 2;
+    #endif
+}
+
 void printseekerror(char *filename, char *action) {
     color(red);
     printf("ERROR: Failed to seek to new file position in %s%s%s! (%s) %s failed!%s",
@@ -7201,18 +8383,65 @@ void printseekerror(char *filename, char *action) {
   return;
 }
 
+// try to make room for the video partition and stealth files by inserting gamestartoffset bytes at the
+// start of the iso with FALLOC_FL_INSERT_RANGE, which only moves extents around (ext4 and xfs support it)
+// returns 0 if the iso was rebuilt in place, 1 if it failed after the insert (the iso is shifted but
+// may not be the right size), or 2 if the filesystem can't do it and one of the copying methods should be used
+int insertrangerebuild(char *filename, long long gamepartitionsize, unsigned long long gamestartoffset) {
+    #if !defined(WIN32) && defined(FALLOC_FL_INSERT_RANGE)
+        long long startingfilesize = getfilesize(check->fp);
+        if (startingfilesize == -1) return 1;  // seek error
+        // the insert has to start inside the file
+        if (startingfilesize == 0) return 2;
+        fflush(check->fp);
+        if (fallocate(fileno(check->fp), FALLOC_FL_INSERT_RANGE, 0, (off_t) gamestartoffset) == -1) {
+            // the iso is untouched when this fails (EOPNOTSUPP on most filesystems, EINVAL if gamestartoffset
+            // isn't a multiple of the block size), so just fall back to copying
+            if (debug) printf("fallocate(FALLOC_FL_INSERT_RANGE) failed: %s%s", strerror(errno), newline);
+          return 2;
+        }
+        // drop anything stdio had buffered from before the insert
+        if (fseeko(check->fp, 0, SEEK_SET) != 0) {
+            printseekerror(filename, "Rebuilding");
+          return 1;
+        }
+        if (debug) printf("inserted 0x%"LL"X bytes at the start of the iso with FALLOC_FL_INSERT_RANGE%s", gamestartoffset, newline);
+        // anything past the game partition is dropped and a short game partition is extended, same as copying would
+        if (startingfilesize != gamepartitionsize) {
+            if (dotruncate(filename, startingfilesize + gamestartoffset, gamepartitionsize + gamestartoffset, true) != 0) return 1;
+        }
+        // set video (game partition offset) now that the iso is rebuilt
+        // (the inserted range reads back as zeroes so there's no need to pad it)
+        check->video = gamestartoffset;
+      return 0;
+    #else
+        (void) filename;
+        (void) gamepartitionsize;
+        (void) gamestartoffset;
+      return 2;
+    #endif
+}
+
 int rebuildiso(char *filename) {
     int i;
     unsigned long m, n;
     if (debug) printf("rebuildiso - filename: %s%s", filename, newline);
-    if (isotoosmall) {
+    // anything the single pass scan read is about to move
+    memset(&check->onepassresults, 0, sizeof(struct onepassresults));
+    #ifndef WIN32
+        // and so is everything the result cache and chunk manifest know about
+        check->cachehit = false;
+        check->cacheenabled = false;
+        chunkmanifest_free(&check->manifest);
+    #endif
+    if (check->isotoosmall) {
         fprintf(stderr, "\n");
         color(red);
         printf("ERROR: ISO size is too small, Rebuilding was aborted!%s", newline);
         color(normal);
       return 1;
     }
-    if (!writefile) {
+    if (!check->writefile) {
         color(yellow);
         printf("Rebuilding was aborted because writing is disabled%s", newline);
         color(normal);
@@ -7220,7 +8449,7 @@ int rebuildiso(char *filename) {
     }
     long long freespace, freespacerequired, targetfilesize, gamepartitionsize;
     unsigned long long gamestartoffset;
-    if (xgd3) {
+    if (check->xgd3) {
         gamepartitionsize = 8662351872LL;
         gamestartoffset = 0x2080000;
     }
@@ -7234,8 +8463,17 @@ int rebuildiso(char *filename) {
                       "gamestartoffset = 0x%"LL"X%s"
                       "targetfilesize = %"LL"d%s",
                       BIGBUF_SIZE, newline, gamepartitionsize, newline, gamestartoffset, newline, targetfilesize, newline);
+    // both methods end up replacing the original iso unless it's being kept, so try the instant in-place method first
+    if (rebuildlowspace || !keeporiginaliso) {
+        i = insertrangerebuild(filename, gamepartitionsize, gamestartoffset);
+        if (i == 0) {
+            fprintf(stderr, "Done\n");
+          return 0;
+        }
+        else if (i == 1) return 1;
+    }
     if (rebuildlowspace) {  // minimal disk space usage rebuilding method
-        long long startingfilesize = getfilesize(fp);
+        long long startingfilesize = getfilesize(check->fp);
         if (startingfilesize == -1) return 1;  // seek error
         freespacerequired = targetfilesize - startingfilesize;
         if (debug) printf("freespacerequired: %"LL"d Bytes, startingfilesize = %"LL"d Bytes%s", freespacerequired, startingfilesize, newline);
@@ -7259,7 +8497,7 @@ int rebuildiso(char *filename) {
         // start shifting all of the data down gamestartoffset bytes to make room for the L0 video partition and stealth files
         initcheckread();
         initcheckwrite();
-        memset(bigbuffer, 0, BIGBUF_SIZE);
+        memset(check->bigbuffer, 0, BIGBUF_SIZE);
         long long blockreadoffset = gamepartitionsize;
         unsigned long major_iterations           = (unsigned long) (gamepartitionsize / gamestartoffset);
         unsigned long major_iterations_remainder = (unsigned long) (gamepartitionsize % gamestartoffset);
@@ -7275,23 +8513,23 @@ int rebuildiso(char *filename) {
             blockreadoffset -= gamestartoffset;
             n = 0;  // just making sure in case this doesn't get set by the for loop if minor_iterations == 0
             for (n=0;n<minor_iterations;n++) {
-                if (fseeko(fp, blockreadoffset + (n * BIGBUF_SIZE), SEEK_SET) != 0) {
+                if (fseeko(check->fp, blockreadoffset + (n * BIGBUF_SIZE), SEEK_SET) != 0) {
                     printf("%s", newline);
                     printseekerror(filename, "Rebuilding");
                   return 1;
                 }
-                if (checkreadandprinterrors(bigbuffer, 1, BIGBUF_SIZE, fp, 0, blockreadoffset + (n * BIGBUF_SIZE),
+                if (checkreadandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, check->fp, 0, blockreadoffset + (n * BIGBUF_SIZE),
                                             filename, "Rebuilding") != 0) return 1;
                 // use SEEK_CUR to seek ahead gamestartoffset bytes
                 // (subtracting BIGBUF_SIZE because we just advanced the position by BIGBUF_SIZE bytes by doing the read)
                 // but don't bother seeking if gamestartoffset happens to be equal to BIGBUF_SIZE
                 // btw, we wouldn't get here if gamestartoffset was less than BIGBUF_SIZE (minor_iterations would be 0)
-                if (gamestartoffset > BIGBUF_SIZE && fseeko(fp, gamestartoffset - BIGBUF_SIZE, SEEK_CUR) != 0) {
+                if (gamestartoffset > BIGBUF_SIZE && fseeko(check->fp, gamestartoffset - BIGBUF_SIZE, SEEK_CUR) != 0) {
                     printf("%s", newline);
                     printseekerror(filename, "Rebuilding");
                   return 1;
                 }
-                if (checkwriteandprinterrors(bigbuffer, 1, BIGBUF_SIZE, fp, 0, blockreadoffset + (n * BIGBUF_SIZE) + gamestartoffset,
+                if (checkwriteandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, check->fp, 0, blockreadoffset + (n * BIGBUF_SIZE) + gamestartoffset,
                                              filename, "Rebuilding") != 0) return 1;
                 if (gamepartitionsize / BIGBUF_SIZE >= 100 && (m * minor_iterations + n) % (gamepartitionsize / BIGBUF_SIZE / 100) == 0) {
                     resetstderr();
@@ -7299,12 +8537,12 @@ int rebuildiso(char *filename) {
                 }
             }
             if (minor_iterations_remainder) {
-                if (fseeko(fp, blockreadoffset + (n * BIGBUF_SIZE), SEEK_SET) != 0) {
+                if (fseeko(check->fp, blockreadoffset + (n * BIGBUF_SIZE), SEEK_SET) != 0) {
                     printf("%s", newline);
                     printseekerror(filename, "Rebuilding");
                   return 1;
                 }
-                if (checkreadandprinterrors(bigbuffer, 1, minor_iterations_remainder, fp, 0, blockreadoffset + (n * BIGBUF_SIZE),
+                if (checkreadandprinterrors(check->bigbuffer, 1, minor_iterations_remainder, check->fp, 0, blockreadoffset + (n * BIGBUF_SIZE),
                                             filename, "Rebuilding") != 0) return 1;
                 // use SEEK_CUR to seek ahead gamestartoffset bytes
                 // (subtracting minor_iterations_remainder because we just advanced the position by
@@ -7313,12 +8551,12 @@ int rebuildiso(char *filename) {
                 // btw, it is impossible for gamestartoffset to be less than minor_iterations_remainder:
                 // for all X [gamestartoffset] % Y [BIGBUF_SIZE] = Z [minor_iterations_remainder], Z must be <= X
                 if (gamestartoffset > minor_iterations_remainder &&
-                    fseeko(fp, gamestartoffset - minor_iterations_remainder, SEEK_CUR) != 0) {
+                    fseeko(check->fp, gamestartoffset - minor_iterations_remainder, SEEK_CUR) != 0) {
                     printf("%s", newline);
                     printseekerror(filename, "Rebuilding");
                   return 1;
                 }
-                if (checkwriteandprinterrors(bigbuffer, 1, minor_iterations_remainder, fp, 0, blockreadoffset + (n * BIGBUF_SIZE) + gamestartoffset,
+                if (checkwriteandprinterrors(check->bigbuffer, 1, minor_iterations_remainder, check->fp, 0, blockreadoffset + (n * BIGBUF_SIZE) + gamestartoffset,
                                              filename, "Rebuilding") != 0) return 1;
                 if (minor_iterations == 0 && gamepartitionsize / minor_iterations_remainder >= 100 &&
                     m % (gamepartitionsize / minor_iterations_remainder / 100) == 0) {
@@ -7336,12 +8574,12 @@ int rebuildiso(char *filename) {
                               major_iterations_remainder_sizeoverbuffer, newline, major_iterations_remainder_bufferremainder, newline);
             m = 0;  // just making sure in case this doesn't get set by the for loop if major_iterations_remainder_sizeoverbuffer == 0
             for (m=0;m<major_iterations_remainder_sizeoverbuffer;m++) {
-                if (fseeko(fp, m * BIGBUF_SIZE, SEEK_SET) != 0) {
+                if (fseeko(check->fp, m * BIGBUF_SIZE, SEEK_SET) != 0) {
                     printf("%s", newline);
                     printseekerror(filename, "Rebuilding");
                   return 1;
                 }
-                if (checkreadandprinterrors(bigbuffer, 1, BIGBUF_SIZE, fp, 0, m * BIGBUF_SIZE,
+                if (checkreadandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, check->fp, 0, m * BIGBUF_SIZE,
                                             filename, "Rebuilding") != 0) return 1;
                 // use SEEK_CUR to seek ahead gamestartoffset bytes
                 // (subtracting BIGBUF_SIZE because we just advanced the position by BIGBUF_SIZE bytes by doing the read)
@@ -7350,12 +8588,12 @@ int rebuildiso(char *filename) {
                 // major_iterations_remainder must be > BIGBUF_SIZE, so
                 // (gamepartitionsize % gamestartoffset) must be > BIGBUF_SIZE, and
                 // for all X [gamepartitionsize] % Y [gamestartoffset] > Z [BIGBUF_SIZE], Y must be > Z
-                if (fseeko(fp, gamestartoffset - BIGBUF_SIZE, SEEK_CUR) != 0) {
+                if (fseeko(check->fp, gamestartoffset - BIGBUF_SIZE, SEEK_CUR) != 0) {
                     printf("%s", newline);
                     printseekerror(filename, "Rebuilding");
                   return 1;
                 }
-                if (checkwriteandprinterrors(bigbuffer, 1, BIGBUF_SIZE, fp, 0, m * BIGBUF_SIZE + gamestartoffset,
+                if (checkwriteandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, check->fp, 0, m * BIGBUF_SIZE + gamestartoffset,
                                              filename, "Rebuilding") != 0) return 1;
                 if (gamepartitionsize / BIGBUF_SIZE >= 100 &&
                     (major_iterations * minor_iterations + m) % (gamepartitionsize / BIGBUF_SIZE / 100) == 0) {
@@ -7364,12 +8602,12 @@ int rebuildiso(char *filename) {
                 }
             }
             if (major_iterations_remainder_bufferremainder) {
-                if (fseeko(fp, m * BIGBUF_SIZE, SEEK_SET) != 0) {
+                if (fseeko(check->fp, m * BIGBUF_SIZE, SEEK_SET) != 0) {
                     printf("%s", newline);
                     printseekerror(filename, "Rebuilding");
                   return 1;
                 }
-                if (checkreadandprinterrors(bigbuffer, 1, major_iterations_remainder_bufferremainder, fp, 0, m * BIGBUF_SIZE,
+                if (checkreadandprinterrors(check->bigbuffer, 1, major_iterations_remainder_bufferremainder, check->fp, 0, m * BIGBUF_SIZE,
                                             filename, "Rebuilding") != 0) return 1;
                 // use SEEK_CUR to seek ahead gamestartoffset bytes
                 // (subtracting major_iterations_remainder_bufferremainder because we just advanced the position by
@@ -7377,12 +8615,12 @@ int rebuildiso(char *filename) {
                 // btw, we wouldn't get here if gamestartoffset was less than or equal to major_iterations_remainder_bufferremainder:
                 // for all X [gamepartitionsize] % Y [gamestartoffset] % Z [BIGBUF_SIZE] = T [major_iterations_remainder_bufferremainder],
                 // Y must be > T
-                if (fseeko(fp, gamestartoffset - major_iterations_remainder_bufferremainder, SEEK_CUR) != 0) {
+                if (fseeko(check->fp, gamestartoffset - major_iterations_remainder_bufferremainder, SEEK_CUR) != 0) {
                     printf("%s", newline);
                     printseekerror(filename, "Rebuilding");
                   return 1;
                 }
-                if (checkwriteandprinterrors(bigbuffer, 1, major_iterations_remainder_bufferremainder, fp, 0, m * BIGBUF_SIZE + gamestartoffset,
+                if (checkwriteandprinterrors(check->bigbuffer, 1, major_iterations_remainder_bufferremainder, check->fp, 0, m * BIGBUF_SIZE + gamestartoffset,
                                              filename, "Rebuilding") != 0) return 1;
             }
         }
@@ -7391,10 +8629,10 @@ int rebuildiso(char *filename) {
         donecheckread(filename);
         donecheckwrite(filename);
         // set video (game partition offset) now that the iso is rebuilt
-        video = gamestartoffset;
+        check->video = gamestartoffset;
         // clear everything before the game partition
         fprintf(stderr, "Padding Game Data... ");
-        if (padzeros(fp, filename, 0, gamestartoffset) != 0) return 1;
+        if (padzeros(check->fp, filename, 0, gamestartoffset) != 0) return 1;
         fprintf(stderr, "Done\n");
       return 0;
     }
@@ -7467,7 +8705,7 @@ int rebuildiso(char *filename) {
             color(normal);
           return 1;
         }
-        memset(bigbuffer, 0, BIGBUF_SIZE);
+        memset(check->bigbuffer, 0, BIGBUF_SIZE);
         // extend rebuilt iso filesize to [gamestartoffset + 1] bytes
         if (dotruncate(rebuiltisofilename, 0, gamestartoffset + 1, true) != 0) return 1;
         // seek to gamestartoffset in rebuiltisofile
@@ -7477,7 +8715,7 @@ int rebuildiso(char *filename) {
           return 1;
         }
         // seek to 0 in input file
-        if (fseeko(fp, 0, SEEK_SET) != 0) {
+        if (fseeko(check->fp, 0, SEEK_SET) != 0) {
             printf("%s", newline);
             printseekerror(filename, "Rebuilding");
           return 1;
@@ -7485,22 +8723,27 @@ int rebuildiso(char *filename) {
         // copy first gamepartitionsize bytes from input file to rebuiltisofile
         initcheckread();
         initcheckwrite();
-        sizeoverbuffer  = (unsigned long) (gamepartitionsize / BIGBUF_SIZE);
-        bufferremainder = (unsigned long) (gamepartitionsize % BIGBUF_SIZE);
-        for (m=0;m<sizeoverbuffer;m++) {
-            if (checkreadandprinterrors(bigbuffer, 1, BIGBUF_SIZE, fp, m, 0,
+        check->sizeoverbuffer  = (unsigned long) (gamepartitionsize / BIGBUF_SIZE);
+        check->bufferremainder = (unsigned long) (gamepartitionsize % BIGBUF_SIZE);
+        // a reflink or in-kernel copy makes the loops below unnecessary
+        i = copyfilerange(check->fp, filename, 0, rebuiltisofile, rebuiltisofilename, gamestartoffset,
+                          (unsigned long long) gamepartitionsize, "Rebuilding", true);
+        if (i == 1) return 1;
+        if (i == 0) check->sizeoverbuffer = check->bufferremainder = 0;
+        for (m=0;m<check->sizeoverbuffer;m++) {
+            if (checkreadandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, check->fp, m, 0,
                                         filename, "Rebuilding") != 0) return 1;
-            if (checkwriteandprinterrors(bigbuffer, 1, BIGBUF_SIZE, rebuiltisofile, m, gamestartoffset,
+            if (checkwriteandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, rebuiltisofile, m, gamestartoffset,
                                          rebuiltisofilename, "Rebuilding") != 0) return 1;
-            if (sizeoverbuffer >= 100 && m % (sizeoverbuffer / 100) == 0) {
+            if (check->sizeoverbuffer >= 100 && m % (check->sizeoverbuffer / 100) == 0) {
                 resetstderr();
-                charsprinted = fprintf(stderr, "%lu%% done", m * 100 / sizeoverbuffer);
+                charsprinted = fprintf(stderr, "%lu%% done", m * 100 / check->sizeoverbuffer);
             }
         }
-        if (bufferremainder) {
-            if (checkreadandprinterrors(bigbuffer, 1, bufferremainder, fp, 0, gamepartitionsize - bufferremainder,
+        if (check->bufferremainder) {
+            if (checkreadandprinterrors(check->bigbuffer, 1, check->bufferremainder, check->fp, 0, gamepartitionsize - check->bufferremainder,
                                         filename, "Rebuilding") != 0) return 1;
-            if (checkwriteandprinterrors(bigbuffer, 1, bufferremainder, rebuiltisofile, 0, gamestartoffset + gamepartitionsize - bufferremainder,
+            if (checkwriteandprinterrors(check->bigbuffer, 1, check->bufferremainder, rebuiltisofile, 0, gamestartoffset + gamepartitionsize - check->bufferremainder,
                                          rebuiltisofilename, "Rebuilding") != 0) return 1;
         }
         clearstderr();
@@ -7508,7 +8751,7 @@ int rebuildiso(char *filename) {
         donecheckread(filename);
         donecheckwrite(rebuiltisofilename);
         // set video (game partition offset) now that the iso is rebuilt
-        video = gamestartoffset;
+        check->video = gamestartoffset;
         // clear everything before the game partition
         fprintf(stderr, "Padding Game Data... ");
         if (padzeros(rebuiltisofile, rebuiltisofilename, 0, gamestartoffset) != 0) return 1;
@@ -7517,29 +8760,29 @@ int rebuildiso(char *filename) {
         void *unusedptr;
         if (!keeporiginaliso) {
             // close original iso file and delete it
-            if (fp != NULL) fclose(fp);
+            if (check->fp != NULL) fclose(check->fp);
             if (remove(filename)) {
                 color(yellow);
                 printf("ERROR: Removing %s%s%s failed! (%s) However, your ISO has been successfully rebuilt to %s%s%s%s",
                        quotation, filename, quotation, strerror(errno), quotation, rebuiltisofilename, quotation, newline);
                 color(normal);
-                unusedptr = realloc(isofilename, (strlen(rebuiltisofilename) + 1) * sizeof(char));
-                if (isofilename == NULL) {
+                unusedptr = realloc(check->isofilename, (strlen(rebuiltisofilename) + 1) * sizeof(char));
+                if (check->isofilename == NULL) {
                     color(red);
                     printf("ERROR: Failed to reallocate memory for isofilename! Game over man... Game over!%s", newline);
                     color(normal);
                   exit(1);
                 }
-                strcpy(isofilename, rebuiltisofilename);
+                strcpy(check->isofilename, rebuiltisofilename);
                 if (rebuiltisofile != NULL) fclose(rebuiltisofile);
-                fp = fopen(rebuiltisofilename, "rb+");
-                if (fp == NULL) {
+                check->fp = fopen(rebuiltisofilename, "rb+");
+                if (check->fp == NULL) {
                     color(red);
                     printf("ERROR: Failed to reopen %s%s%s for writing! (%s) Unable to patch stealth files!%s",
                            quotation, rebuiltisofilename, quotation, strerror(errno), newline);
                     color(normal);
-                    fp = fopen(rebuiltisofilename, "rb");
-                    if (fp == NULL) {
+                    check->fp = fopen(rebuiltisofilename, "rb");
+                    if (check->fp == NULL) {
                         color(red);
                         printf("ERROR: Failed to reopen %s%s%s for reading! (%s) Game over man... Game over!%s", 
                                quotation, rebuiltisofilename, quotation, strerror(errno), newline);
@@ -7559,22 +8802,22 @@ int rebuildiso(char *filename) {
                        quotation, rebuiltisofilename, quotation, quotation, filename, quotation, strerror(errno),
                        quotation, rebuiltisofilename, quotation, newline);
                 color(normal);
-                unusedptr = realloc(isofilename, (strlen(rebuiltisofilename) + 1) * sizeof(char));
-                if (isofilename == NULL) {
+                unusedptr = realloc(check->isofilename, (strlen(rebuiltisofilename) + 1) * sizeof(char));
+                if (check->isofilename == NULL) {
                     color(red);
                     printf("ERROR: Failed to reallocate memory for isofilename! Game over man... Game over!%s", newline);
                     color(normal);
                   exit(1);
                 }
-                strcpy(isofilename, rebuiltisofilename);
-                fp = fopen(rebuiltisofilename, "rb+");
-                if (fp == NULL) {
+                strcpy(check->isofilename, rebuiltisofilename);
+                check->fp = fopen(rebuiltisofilename, "rb+");
+                if (check->fp == NULL) {
                     color(red);
                     printf("ERROR: Failed to reopen %s%s%s for writing! (%s) Unable to patch stealth files!%s",
                            quotation, rebuiltisofilename, quotation, strerror(errno), newline);
                     color(normal);
-                    fp = fopen(rebuiltisofilename, "rb");
-                    if (fp == NULL) {
+                    check->fp = fopen(rebuiltisofilename, "rb");
+                    if (check->fp == NULL) {
                         color(red);
                         printf("ERROR: Failed to reopen %s%s%s for reading! (%s) Game over man... Game over!%s", 
                                quotation, rebuiltisofilename, quotation, strerror(errno), newline);
@@ -7586,14 +8829,14 @@ int rebuildiso(char *filename) {
               return 0;
             }
             // reopen it as fp
-            fp = fopen(filename, "rb+");
-            if (fp == NULL) {
+            check->fp = fopen(filename, "rb+");
+            if (check->fp == NULL) {
                 color(red);
                 printf("ERROR: Failed to reopen %s%s%s for writing! (%s) Unable to patch stealth files!%s",
                        quotation, filename, quotation, strerror(errno), newline);
                 color(normal);
-                fp = fopen(filename, "rb");
-                if (fp == NULL) {
+                check->fp = fopen(filename, "rb");
+                if (check->fp == NULL) {
                     color(red);
                     printf("ERROR: Failed to reopen %s%s%s for reading! (%s) Game over man... Game over!%s", 
                            quotation, filename, quotation, strerror(errno), newline);
@@ -7608,24 +8851,24 @@ int rebuildiso(char *filename) {
         }
         else {
             // keep original iso, just change isofilename and fp to the rebuilt iso
-            if (fp != NULL) fclose(fp);
+            if (check->fp != NULL) fclose(check->fp);
             if (rebuiltisofile != NULL) fclose(rebuiltisofile);
-            unusedptr = realloc(isofilename, (strlen(rebuiltisofilename) + 1) * sizeof(char));
-            if (isofilename == NULL) {
+            unusedptr = realloc(check->isofilename, (strlen(rebuiltisofilename) + 1) * sizeof(char));
+            if (check->isofilename == NULL) {
                 color(red);
                 printf("ERROR: Failed to reallocate memory for isofilename! Game over man... Game over!%s", newline);
                 color(normal);
               exit(1);
             }
-            strcpy(isofilename, rebuiltisofilename);
-            fp = fopen(rebuiltisofilename, "rb+");
-            if (fp == NULL) {
+            strcpy(check->isofilename, rebuiltisofilename);
+            check->fp = fopen(rebuiltisofilename, "rb+");
+            if (check->fp == NULL) {
                 color(red);
                 printf("ERROR: Failed to reopen %s%s%s for writing! (%s) Unable to patch stealth files!%s",
                        quotation, rebuiltisofilename, quotation, strerror(errno), newline);
                 color(normal);
-                fp = fopen(rebuiltisofilename, "rb");
-                if (fp == NULL) {
+                check->fp = fopen(rebuiltisofilename, "rb");
+                if (check->fp == NULL) {
                     color(red);
                     printf("ERROR: Failed to reopen %s%s%s for reading! (%s) Game over man... Game over!%s", 
                            quotation, rebuiltisofilename, quotation, strerror(errno), newline);
@@ -7640,7 +8883,7 @@ int rebuildiso(char *filename) {
             color(normal);
         }
         if (debug) printf("rebuildiso r0 - isofilename: %s, strlen(isofilename) = %u, filename: %s, strlen(filename) = %u%s",
-                          isofilename, (unsigned int) strlen(isofilename), filename, (unsigned int) strlen(filename), newline);
+                          check->isofilename, (unsigned int) strlen(check->isofilename), filename, (unsigned int) strlen(filename), newline);
       return 0;
     }
 }
@@ -7685,13 +8928,13 @@ int doextendedsscr(char *forced_cr_drive, unsigned char *median_ss) {
             }
         }
     #endif
-    if (ss_num_angles != 4 || ss_num_targets != 4) {
+    if (check->ss_num_angles != 4 || check->ss_num_targets != 4) {
         color(yellow);
         printf("ERROR: Unable to do extended C/R because this version of abgx360 expects to see exactly 4 angle challenge/response types%s", newline);
         color(normal);
       return 1;
     }
-    if (ss_staticcrc32 == 0) {
+    if (check->ss_staticcrc32 == 0) {
         color(red);
         printf("ERROR: Failed to get the 'static' SS CRC for some reason%s", newline);
         color(normal);
@@ -7699,8 +8942,8 @@ int doextendedsscr(char *forced_cr_drive, unsigned char *median_ss) {
     }
     
     // is this necessary? (used in dvdarg routine)
-    writefile = false;
-    fp = NULL;
+    check->writefile = false;
+    check->fp = NULL;
     
     unsigned char ssbuffer[2048], ss_overwritten[2048], ss_overwritten2[2048];
     unsigned long ssbuffer_crc32, ss_overwritten2_staticcrc32;
@@ -7732,20 +8975,20 @@ int doextendedsscr(char *forced_cr_drive, unsigned char *median_ss) {
                         closedeviceifopen();
                       continue;
                     }
-                    if (debug) printf("Checking drive: %s%s", isofilename, newline);
+                    if (debug) printf("Checking drive: %s%s", check->isofilename, newline);
                     // check that this is a recognized ripping drive
-                    if (!isanxbox360rippingdrive(isofilename, false)) {
+                    if (!isanxbox360rippingdrive(check->isofilename, false)) {
                         if (debug) printf("This is not a recognized Xbox 360 ripping drive%s", newline);
                         closedeviceifopen();
                       continue;
                     }
                     // get size of media in bytes
-                    fpfilesize = getdisccapacity(true, false);  // if the latter is false then it won't print errors unless --debug
-                    if (fpfilesize == -1LL) {
+                    check->fpfilesize = getdisccapacity(true, false);  // if the latter is false then it won't print errors unless --debug
+                    if (check->fpfilesize == -1LL) {
                         closedeviceifopen();
                       continue;
                     }
-                    if (debug) printf("Media Size: %"LL"d Bytes%s", fpfilesize, newline);
+                    if (debug) printf("Media Size: %"LL"d Bytes%s", check->fpfilesize, newline);
                     // try and read the ss without c/r data
                     memset(ssbuffer, 0, 2048);
                     memset(cdb, 0, 12);
@@ -7764,15 +9007,15 @@ int doextendedsscr(char *forced_cr_drive, unsigned char *median_ss) {
                     }
                     memcpy(ss_overwritten, ssbuffer, 2048);
                     // calculate SS crc32 with the replay table set as 0xFF
-                    memset(ss_overwritten+ss_replay_table_offset, 0xFF, ss_replay_table_length);
-                    ssbuffer_crc32 = crc32(0, ss_overwritten, 2048);
+                    memset(ss_overwritten+check->ss_replay_table_offset, 0xFF, check->ss_replay_table_length);
+                    ssbuffer_crc32 = crc32_fast(0, ss_overwritten, 2048);
                     if (debug) {
                         printf("ssbuffer_crc32 = %08lX%s"
-                               "ss_crc32 %s = %08lX%s", ssbuffer_crc32, newline, sp5, ss_crc32, newline);
+                               "ss_crc32 %s = %08lX%s", ssbuffer_crc32, newline, sp5, check->ss_crc32, newline);
                         hexdump(ss_overwritten, 0, 2048);
                     }
                     // make sure this ripped ss matches the one in our iso
-                    if (ssbuffer_crc32 != ss_crc32) {
+                    if (ssbuffer_crc32 != check->ss_crc32) {
                         if (debug) printf("SS from original disc does not match the SS in this ISO%s", newline);
                         closedeviceifopen();
                       continue;
@@ -7812,12 +9055,12 @@ int doextendedsscr(char *forced_cr_drive, unsigned char *median_ss) {
             foundoriginaldisc:
             if (verbose) {
                 printf("%sUsing Drive: ", newline);
-                if (strlen(isofilename) > 66 && strlen(isofilename) < 80) printf("%s", newline);  // just looks nicer in a cli window this way
-                printf("%s%s", isofilename, newline);
+                if (strlen(check->isofilename) > 66 && strlen(check->isofilename) < 80) printf("%s", newline);  // just looks nicer in a cli window this way
+                printf("%s%s", check->isofilename, newline);
                 printf("Media Size:");
-                if (strlen(isofilename) > 66 && strlen(isofilename) < 80) printf(" ");
+                if (strlen(check->isofilename) > 66 && strlen(check->isofilename) < 80) printf(" ");
                 else printf("%s ", sp1);  // just looks nicer this way
-                printf("%"LL"d Bytes%s%s", fpfilesize, newline, newline);
+                printf("%"LL"d Bytes%s%s", check->fpfilesize, newline, newline);
             }
         #else
             // todo: support auto detection of drives on non-WIN32
@@ -7838,11 +9081,11 @@ int doextendedsscr(char *forced_cr_drive, unsigned char *median_ss) {
         }
         if (verbose) {
             printf("%sUsing Drive: ", newline);
-            if (strlen(isofilename) > 66 && strlen(isofilename) < 80) printf("%s", newline);  // just looks nicer in a cli window this way
-            printf("%s%s", isofilename, newline);
+            if (strlen(check->isofilename) > 66 && strlen(check->isofilename) < 80) printf("%s", newline);  // just looks nicer in a cli window this way
+            printf("%s%s", check->isofilename, newline);
         }
         // check that this is a recognized ripping drive
-        if (!isanxbox360rippingdrive(isofilename, false)) {
+        if (!isanxbox360rippingdrive(check->isofilename, false)) {
             color(yellow);
             printf("This is not a recognized Xbox 360 ripping drive! Extended C/R aborted!%s", newline);
             color(normal);
@@ -7851,16 +9094,16 @@ int doextendedsscr(char *forced_cr_drive, unsigned char *median_ss) {
           return 1;
         }
         // get size of media in bytes
-        fpfilesize = getdisccapacity(true, true);
-        if (fpfilesize == -1LL) {
+        check->fpfilesize = getdisccapacity(true, true);
+        if (check->fpfilesize == -1LL) {
             closedeviceifopen();
             goto prompttoretryforced;
         }
         if (verbose) {
             printf("Media Size:");
-            if (strlen(isofilename) > 66 && strlen(isofilename) < 80) printf(" ");
+            if (strlen(check->isofilename) > 66 && strlen(check->isofilename) < 80) printf(" ");
             else printf("%s ", sp1);  // just looks nicer this way
-            printf("%"LL"d Bytes%s%s", fpfilesize, newline, newline);
+            printf("%"LL"d Bytes%s%s", check->fpfilesize, newline, newline);
         }
         // try and read the ss without c/r data
         memset(ssbuffer, 0, 2048);
@@ -7882,15 +9125,15 @@ int doextendedsscr(char *forced_cr_drive, unsigned char *median_ss) {
         }
         memcpy(ss_overwritten, ssbuffer, 2048);
         // calculate SS crc32 with the replay table set as 0xFF
-        memset(ss_overwritten+ss_replay_table_offset, 0xFF, ss_replay_table_length);
-        ssbuffer_crc32 = crc32(0, ss_overwritten, 2048);
+        memset(ss_overwritten+check->ss_replay_table_offset, 0xFF, check->ss_replay_table_length);
+        ssbuffer_crc32 = crc32_fast(0, ss_overwritten, 2048);
         if (debug) {
             printf("ssbuffer_crc32 = %08lX%s"
-                   "ss_crc32 %s = %08lX%s", ssbuffer_crc32, newline, sp5, ss_crc32, newline);
+                   "ss_crc32 %s = %08lX%s", ssbuffer_crc32, newline, sp5, check->ss_crc32, newline);
             hexdump(ss_overwritten, 0, 2048);
         }
         // make sure this ripped ss matches the one in our iso
-        if (ssbuffer_crc32 != ss_crc32) {
+        if (ssbuffer_crc32 != check->ss_crc32) {
             color(yellow);
             printf("SS from original disc does not match the SS in this ISO!%s", newline);
             color(normal);
@@ -7992,21 +9235,21 @@ int doextendedsscr(char *forced_cr_drive, unsigned char *median_ss) {
         if (checking_static_crc) {
             // check the static crc to make sure other c/r data hasn't changed
             memcpy(ss_overwritten2, ssbuffer, 2048);
-            memset(ss_overwritten2+ss_angleaddresses[0],   0xFF, 2);  // v1
-            memset(ss_overwritten2+ss_angleaddresses[0]+3, 0xFF, 2);  // v2
-            memset(ss_overwritten2+ss_angleaddresses[1],   0xFF, 2);  // v1
-            memset(ss_overwritten2+ss_angleaddresses[1]+3, 0xFF, 2);  // v2
-            memset(ss_overwritten2+ss_angleaddresses[2],   0xFF, 2);  // v1
-            memset(ss_overwritten2+ss_angleaddresses[2]+3, 0xFF, 2);  // v2
-            memset(ss_overwritten2+ss_angleaddresses[3],   0xFF, 2);  // v1
-            memset(ss_overwritten2+ss_angleaddresses[3]+3, 0xFF, 2);  // v2
-            ss_overwritten2_staticcrc32 = crc32(0, ss_overwritten2, 2048);
+            memset(ss_overwritten2+check->ss_angleaddresses[0],   0xFF, 2);  // v1
+            memset(ss_overwritten2+check->ss_angleaddresses[0]+3, 0xFF, 2);  // v2
+            memset(ss_overwritten2+check->ss_angleaddresses[1],   0xFF, 2);  // v1
+            memset(ss_overwritten2+check->ss_angleaddresses[1]+3, 0xFF, 2);  // v2
+            memset(ss_overwritten2+check->ss_angleaddresses[2],   0xFF, 2);  // v1
+            memset(ss_overwritten2+check->ss_angleaddresses[2]+3, 0xFF, 2);  // v2
+            memset(ss_overwritten2+check->ss_angleaddresses[3],   0xFF, 2);  // v1
+            memset(ss_overwritten2+check->ss_angleaddresses[3]+3, 0xFF, 2);  // v2
+            ss_overwritten2_staticcrc32 = crc32_fast(0, ss_overwritten2, 2048);
             if (debug) printf("ss_overwritten2_staticcrc32 = %08lX%s", ss_overwritten2_staticcrc32, newline);
-            if (ss_overwritten2_staticcrc32 != ss_staticcrc32) {
+            if (ss_overwritten2_staticcrc32 != check->ss_staticcrc32) {
                 color(yellow);
                 printf("Error: Looks like this drive returned different (probably bad) C/R data%s", newline);
                 color(normal);
-                if (debug) hexdump(ss_overwritten2+ss_replay_table_offset, 0, ss_replay_table_length);
+                if (debug) hexdump(ss_overwritten2+check->ss_replay_table_offset, 0, check->ss_replay_table_length);
               continue;
             }
             else {
@@ -8016,39 +9259,39 @@ int doextendedsscr(char *forced_cr_drive, unsigned char *median_ss) {
         }
         else {
             // make sure CD matches for the angle response types (drive errors usually cause 00000000 CD and 0 degree angles)
-            if (memcmp(median_ss+ss_angleaddresses[0]-4, ssbuffer+ss_angleaddresses[0]-4, 4) != 0 ||
-                memcmp(median_ss+ss_angleaddresses[1]-4, ssbuffer+ss_angleaddresses[1]-4, 4) != 0 ||
-                memcmp(median_ss+ss_angleaddresses[2]-4, ssbuffer+ss_angleaddresses[2]-4, 4) != 0 ||
-                memcmp(median_ss+ss_angleaddresses[3]-4, ssbuffer+ss_angleaddresses[3]-4, 4) != 0) {
+            if (memcmp(median_ss+check->ss_angleaddresses[0]-4, ssbuffer+check->ss_angleaddresses[0]-4, 4) != 0 ||
+                memcmp(median_ss+check->ss_angleaddresses[1]-4, ssbuffer+check->ss_angleaddresses[1]-4, 4) != 0 ||
+                memcmp(median_ss+check->ss_angleaddresses[2]-4, ssbuffer+check->ss_angleaddresses[2]-4, 4) != 0 ||
+                memcmp(median_ss+check->ss_angleaddresses[3]-4, ssbuffer+check->ss_angleaddresses[3]-4, 4) != 0) {
                 color(yellow);
                 printf("Error: CD does not match for one or more angle response types%s", newline);
                 color(normal);
-                if (debug) hexdump(ssbuffer+ss_replay_table_offset, 0, ss_replay_table_length);
+                if (debug) hexdump(ssbuffer+check->ss_replay_table_offset, 0, check->ss_replay_table_length);
               continue;
             }
         }
         
         // the ss v1 angles should match the ss v2 angles
-        if (memcmp(ssbuffer+ss_angleaddresses[0], ssbuffer+ss_angleaddresses[0]+3, 2) != 0 ||
-            memcmp(ssbuffer+ss_angleaddresses[1], ssbuffer+ss_angleaddresses[1]+3, 2) != 0 ||
-            memcmp(ssbuffer+ss_angleaddresses[2], ssbuffer+ss_angleaddresses[2]+3, 2) != 0 ||
-            memcmp(ssbuffer+ss_angleaddresses[3], ssbuffer+ss_angleaddresses[3]+3, 2) != 0) {
+        if (memcmp(ssbuffer+check->ss_angleaddresses[0], ssbuffer+check->ss_angleaddresses[0]+3, 2) != 0 ||
+            memcmp(ssbuffer+check->ss_angleaddresses[1], ssbuffer+check->ss_angleaddresses[1]+3, 2) != 0 ||
+            memcmp(ssbuffer+check->ss_angleaddresses[2], ssbuffer+check->ss_angleaddresses[2]+3, 2) != 0 ||
+            memcmp(ssbuffer+check->ss_angleaddresses[3], ssbuffer+check->ss_angleaddresses[3]+3, 2) != 0) {
             color(yellow);
             printf("Error: One or more SS v1 angles do not match their SS v2 counterparts%s", newline);
             color(normal);
-            if (debug) hexdump(ssbuffer+ss_replay_table_offset, 0, ss_replay_table_length);
+            if (debug) hexdump(ssbuffer+check->ss_replay_table_offset, 0, check->ss_replay_table_length);
           continue;
         }
         
         // store the angles
-        anglesanddevs1[num_angles].angle  = (unsigned int) ssbuffer[ss_angleaddresses[0]+1] << 8;
-        anglesanddevs1[num_angles].angle |= (unsigned int) ssbuffer[ss_angleaddresses[0]];
-        anglesanddevs2[num_angles].angle  = (unsigned int) ssbuffer[ss_angleaddresses[1]+1] << 8;
-        anglesanddevs2[num_angles].angle |= (unsigned int) ssbuffer[ss_angleaddresses[1]];
-        anglesanddevs3[num_angles].angle  = (unsigned int) ssbuffer[ss_angleaddresses[2]+1] << 8;
-        anglesanddevs3[num_angles].angle |= (unsigned int) ssbuffer[ss_angleaddresses[2]];
-        anglesanddevs4[num_angles].angle  = (unsigned int) ssbuffer[ss_angleaddresses[3]+1] << 8;
-        anglesanddevs4[num_angles].angle |= (unsigned int) ssbuffer[ss_angleaddresses[3]];
+        anglesanddevs1[num_angles].angle  = (unsigned int) ssbuffer[check->ss_angleaddresses[0]+1] << 8;
+        anglesanddevs1[num_angles].angle |= (unsigned int) ssbuffer[check->ss_angleaddresses[0]];
+        anglesanddevs2[num_angles].angle  = (unsigned int) ssbuffer[check->ss_angleaddresses[1]+1] << 8;
+        anglesanddevs2[num_angles].angle |= (unsigned int) ssbuffer[check->ss_angleaddresses[1]];
+        anglesanddevs3[num_angles].angle  = (unsigned int) ssbuffer[check->ss_angleaddresses[2]+1] << 8;
+        anglesanddevs3[num_angles].angle |= (unsigned int) ssbuffer[check->ss_angleaddresses[2]];
+        anglesanddevs4[num_angles].angle  = (unsigned int) ssbuffer[check->ss_angleaddresses[3]+1] << 8;
+        anglesanddevs4[num_angles].angle |= (unsigned int) ssbuffer[check->ss_angleaddresses[3]];
         // make sure angles are valid
         if (anglesanddevs1[num_angles].angle > 359 ||
             anglesanddevs2[num_angles].angle > 359 ||
@@ -8062,10 +9305,10 @@ int doextendedsscr(char *forced_cr_drive, unsigned char *median_ss) {
           continue;
         }
         // calculate and store deviations from the iso's ss ccrt targets
-        anglesanddevs1[num_angles].dev = getangledeviation(anglesanddevs1[num_angles].angle, (int) ss_targets[0]);
-        anglesanddevs2[num_angles].dev = getangledeviation(anglesanddevs2[num_angles].angle, (int) ss_targets[1]);
-        anglesanddevs3[num_angles].dev = getangledeviation(anglesanddevs3[num_angles].angle, (int) ss_targets[2]);
-        anglesanddevs4[num_angles].dev = getangledeviation(anglesanddevs4[num_angles].angle, (int) ss_targets[3]);
+        anglesanddevs1[num_angles].dev = getangledeviation(anglesanddevs1[num_angles].angle, (int) check->ss_targets[0]);
+        anglesanddevs2[num_angles].dev = getangledeviation(anglesanddevs2[num_angles].angle, (int) check->ss_targets[1]);
+        anglesanddevs3[num_angles].dev = getangledeviation(anglesanddevs3[num_angles].angle, (int) check->ss_targets[2]);
+        anglesanddevs4[num_angles].dev = getangledeviation(anglesanddevs4[num_angles].angle, (int) check->ss_targets[3]);
         // make sure deviation is within tolerance
         // todo: use tolerance value from CCRT instead of hardcoded SS_TOLERANCE
         if (abs(anglesanddevs1[num_angles].dev) >= SS_TOLERANCE ||
@@ -8281,25 +9524,25 @@ int doextendedsscr(char *forced_cr_drive, unsigned char *median_ss) {
     }
     printf("%s", newline);
     
-    median_ss[ss_angleaddresses[0]]   = (unsigned char)   (medianangle[0] & 0x000000FF);
-    median_ss[ss_angleaddresses[0]+1] = (unsigned char) ( (medianangle[0] & 0x0000FF00) >> 8);
-    median_ss[ss_angleaddresses[0]+3] = (unsigned char)   (medianangle[0] & 0x000000FF);
-    median_ss[ss_angleaddresses[0]+4] = (unsigned char) ( (medianangle[0] & 0x0000FF00) >> 8);
+    median_ss[check->ss_angleaddresses[0]]   = (unsigned char)   (medianangle[0] & 0x000000FF);
+    median_ss[check->ss_angleaddresses[0]+1] = (unsigned char) ( (medianangle[0] & 0x0000FF00) >> 8);
+    median_ss[check->ss_angleaddresses[0]+3] = (unsigned char)   (medianangle[0] & 0x000000FF);
+    median_ss[check->ss_angleaddresses[0]+4] = (unsigned char) ( (medianangle[0] & 0x0000FF00) >> 8);
     
-    median_ss[ss_angleaddresses[1]]   = (unsigned char)   (medianangle[1] & 0x000000FF);
-    median_ss[ss_angleaddresses[1]+1] = (unsigned char) ( (medianangle[1] & 0x0000FF00) >> 8);
-    median_ss[ss_angleaddresses[1]+3] = (unsigned char)   (medianangle[1] & 0x000000FF);
-    median_ss[ss_angleaddresses[1]+4] = (unsigned char) ( (medianangle[1] & 0x0000FF00) >> 8);
+    median_ss[check->ss_angleaddresses[1]]   = (unsigned char)   (medianangle[1] & 0x000000FF);
+    median_ss[check->ss_angleaddresses[1]+1] = (unsigned char) ( (medianangle[1] & 0x0000FF00) >> 8);
+    median_ss[check->ss_angleaddresses[1]+3] = (unsigned char)   (medianangle[1] & 0x000000FF);
+    median_ss[check->ss_angleaddresses[1]+4] = (unsigned char) ( (medianangle[1] & 0x0000FF00) >> 8);
     
-    median_ss[ss_angleaddresses[2]]   = (unsigned char)   (medianangle[2] & 0x000000FF);
-    median_ss[ss_angleaddresses[2]+1] = (unsigned char) ( (medianangle[2] & 0x0000FF00) >> 8);
-    median_ss[ss_angleaddresses[2]+3] = (unsigned char)   (medianangle[2] & 0x000000FF);
-    median_ss[ss_angleaddresses[2]+4] = (unsigned char) ( (medianangle[2] & 0x0000FF00) >> 8);
+    median_ss[check->ss_angleaddresses[2]]   = (unsigned char)   (medianangle[2] & 0x000000FF);
+    median_ss[check->ss_angleaddresses[2]+1] = (unsigned char) ( (medianangle[2] & 0x0000FF00) >> 8);
+    median_ss[check->ss_angleaddresses[2]+3] = (unsigned char)   (medianangle[2] & 0x000000FF);
+    median_ss[check->ss_angleaddresses[2]+4] = (unsigned char) ( (medianangle[2] & 0x0000FF00) >> 8);
     
-    median_ss[ss_angleaddresses[3]]   = (unsigned char)   (medianangle[3] & 0x000000FF);
-    median_ss[ss_angleaddresses[3]+1] = (unsigned char) ( (medianangle[3] & 0x0000FF00) >> 8);
-    median_ss[ss_angleaddresses[3]+3] = (unsigned char)   (medianangle[3] & 0x000000FF);
-    median_ss[ss_angleaddresses[3]+4] = (unsigned char) ( (medianangle[3] & 0x0000FF00) >> 8);
+    median_ss[check->ss_angleaddresses[3]]   = (unsigned char)   (medianangle[3] & 0x000000FF);
+    median_ss[check->ss_angleaddresses[3]+1] = (unsigned char) ( (medianangle[3] & 0x0000FF00) >> 8);
+    median_ss[check->ss_angleaddresses[3]+3] = (unsigned char)   (medianangle[3] & 0x000000FF);
+    median_ss[check->ss_angleaddresses[3]+4] = (unsigned char) ( (medianangle[3] & 0x0000FF00) >> 8);
     
   return 0;
 }
@@ -8312,25 +9555,25 @@ bool valid_ssv2_exists_in_db() {
     
     // save the original global values so we can reset them after checkss()
     // be sure to update this function (not just the part under this comment) if new global vars are used in checkss()
-    bool real_ss_stealthfailed =               ss_stealthfailed;
-    bool real_ss_stealthuncertain =            ss_stealthuncertain;
-    bool real_ss_foundtimestamp =              ss_foundtimestamp;
-    bool real_fixedss =                        fixedss;
-    bool real_drtfucked =                      drtfucked;
-    bool real_ssv2 =                           ssv2;
-    unsigned int real_ss_replay_table_offset = ss_replay_table_offset;
-    unsigned int real_ss_replay_table_length = ss_replay_table_length;
-    unsigned long real_ss_crc32 =              ss_crc32;
-    unsigned long real_ss_rawcrc32 =           ss_rawcrc32;
-    unsigned long long real_ss_authored =      ss_authored;
-    unsigned long real_ss_staticcrc32 =        ss_staticcrc32;
-    unsigned int real_ss_num_angles =          ss_num_angles;
-    unsigned int real_ss_num_targets =         ss_num_targets;
+    bool real_ss_stealthfailed =               check->ss_stealthfailed;
+    bool real_ss_stealthuncertain =            check->ss_stealthuncertain;
+    bool real_ss_foundtimestamp =              check->ss_foundtimestamp;
+    bool real_fixedss =                        check->fixedss;
+    bool real_drtfucked =                      check->drtfucked;
+    bool real_ssv2 =                           check->ssv2;
+    unsigned int real_ss_replay_table_offset = check->ss_replay_table_offset;
+    unsigned int real_ss_replay_table_length = check->ss_replay_table_length;
+    unsigned long real_ss_crc32 =              check->ss_crc32;
+    unsigned long real_ss_rawcrc32 =           check->ss_rawcrc32;
+    unsigned long long real_ss_authored =      check->ss_authored;
+    unsigned long real_ss_staticcrc32 =        check->ss_staticcrc32;
+    unsigned int real_ss_num_angles =          check->ss_num_angles;
+    unsigned int real_ss_num_targets =         check->ss_num_targets;
     unsigned int real_ss_angleaddresses[4];
     unsigned int real_ss_targets[4];
     for (i=0;i<4;i++) {
-        real_ss_angleaddresses[i] = ss_angleaddresses[i];
-        real_ss_targets[i] =        ss_targets[i];
+        real_ss_angleaddresses[i] = check->ss_angleaddresses[i];
+        real_ss_targets[i] =        check->ss_targets[i];
     }
     
     memset(ssfilename, 0, 16);
@@ -8339,7 +9582,7 @@ bool valid_ssv2_exists_in_db() {
     if (ssfile == NULL) {
       return false;
     }
-    memset(ss, 0, 2048);
+    memset(check->ss, 0, 2048);
     // make sure that ssfile is 2048 bytes before reading it
     long long stealthfilesize = getfilesize(ssfile);
     if (stealthfilesize == -1) {  // seek error
@@ -8351,55 +9594,55 @@ bool valid_ssv2_exists_in_db() {
         deletestealthfile(ssfilename, stealthdir, false);
       return false;
     }
-    if (trytoreadstealthfile(ss, 1, 2048, ssfile, ssfilename, 0) != 0) {
+    if (trytoreadstealthfile(check->ss, 1, 2048, ssfile, ssfilename, 0) != 0) {
         fclose(ssfile);
         deletestealthfile(ssfilename, stealthdir, false);
       return false;
     }
     fclose(ssfile);
-    if (getzeros(ss, 0, 2047) == 2048) {
+    if (zeroscan_allzeros(check->ss, 2048)) {
         // blank
         deletestealthfile(ssfilename, stealthdir, false);
       return false;
     }
     if (verbose) printf("%s", newline);
     checkss();
-    if (ss_stealthfailed || ss_stealthuncertain) {
+    if (check->ss_stealthfailed || check->ss_stealthuncertain) {
         // ss failed stealth check against the xex
         delete_ss_and_return_false = true;
     }
-    if (real_ss_crc32 != ss_crc32) {
+    if (real_ss_crc32 != check->ss_crc32) {
         // file has the wrong crc
         delete_ss_and_return_false = true;
     }
-    ss_stealthfailed =       real_ss_stealthfailed;
-    ss_stealthuncertain =    real_ss_stealthuncertain;
-    ss_foundtimestamp =      real_ss_foundtimestamp;
-    fixedss =                real_fixedss;
-    drtfucked =              real_drtfucked;
-    ss_replay_table_offset = real_ss_replay_table_offset;
-    ss_replay_table_length = real_ss_replay_table_length;
-    ss_crc32 =               real_ss_crc32;
-    ss_rawcrc32 =            real_ss_rawcrc32;
-    ss_authored =            real_ss_authored;
-    ss_staticcrc32 =         real_ss_staticcrc32;
-    ss_num_angles =          real_ss_num_angles;
-    ss_num_targets =         real_ss_num_targets;
+    check->ss_stealthfailed =       real_ss_stealthfailed;
+    check->ss_stealthuncertain =    real_ss_stealthuncertain;
+    check->ss_foundtimestamp =      real_ss_foundtimestamp;
+    check->fixedss =                real_fixedss;
+    check->drtfucked =              real_drtfucked;
+    check->ss_replay_table_offset = real_ss_replay_table_offset;
+    check->ss_replay_table_length = real_ss_replay_table_length;
+    check->ss_crc32 =               real_ss_crc32;
+    check->ss_rawcrc32 =            real_ss_rawcrc32;
+    check->ss_authored =            real_ss_authored;
+    check->ss_staticcrc32 =         real_ss_staticcrc32;
+    check->ss_num_angles =          real_ss_num_angles;
+    check->ss_num_targets =         real_ss_num_targets;
     for (i=0;i<4;i++) {
-        ss_angleaddresses[i] = real_ss_angleaddresses[i];
-        ss_targets[i]        = real_ss_targets[i];
+        check->ss_angleaddresses[i] = real_ss_angleaddresses[i];
+        check->ss_targets[i]        = real_ss_targets[i];
     }
     if (delete_ss_and_return_false) {
-        ssv2 = real_ssv2;
+        check->ssv2 = real_ssv2;
         deletestealthfile(ssfilename, stealthdir, false);
       return false;
     }
-    else if (ssv2) {
-        ssv2 = real_ssv2;
+    else if (check->ssv2) {
+        check->ssv2 = real_ssv2;
       return true;
     }
     else {
-        ssv2 = real_ssv2;
+        check->ssv2 = real_ssv2;
       return false;
     }
 }
@@ -8422,35 +9665,35 @@ int doautoupload(char *argv[], bool upload_ss_only) {
     char *drive_used_for_extended_cr = NULL;
     unsigned char median_ss[2048];
     printf("%sStarting AutoUpload%s", newline, newline);
-    if (xex_crc32 == 0 || ss_crc32 == 0 || ss_rawcrc32 == 0 || pfi_crc32 == 0 || dmi_crc32 == 0 || video_crc32 == 0 || videoL0_crc32 == 0 || videoL1_crc32 == 0) {
+    if (check->xex_crc32 == 0 || check->ss_crc32 == 0 || check->ss_rawcrc32 == 0 || check->pfi_crc32 == 0 || check->dmi_crc32 == 0 || check->video_crc32 == 0 || check->videoL0_crc32 == 0 || check->videoL1_crc32 == 0) {
         color(yellow);
         printf("One or more CRC requirements for AutoUpload were not met, cannot continue%s", newline);
         color(normal);
       return 1;
     }
-    if (!xex_foundmediaid || !foundregioncode) {
+    if (!check->xex_foundmediaid || !check->foundregioncode) {
         color(yellow);
         printf("Xex media id and/or region code were not found, AutoUpload cannot continue%s", newline);
         color(normal);
       return 1;
     }
     
-    if (game_crc32 == 0 && !checkgamecrcnever) {
+    if (check->game_crc32 == 0 && !check->checkgamecrcnever) {
         if (docheckgamecrc() == 0) {
-            if (corruptionoffsetcount == 0) {
+            if (check->corruptionoffsetcount == 0) {
                 color(green);
                 if (verbose) printf("%s", sp5);
                 printf("AnyDVD style corruption was not detected%s", newline);
                 color(normal);
             }
-            if (verbose) printf("%sGame CRC = %08lX%s%s", sp5, game_crc32, newline, newline);
+            if (verbose) printf("%sGame CRC = %08lX%s%s", sp5, check->game_crc32, newline, newline);
         }
         else {
-            checkgamecrcnever = true;
-            if (!usercancelledgamecrc) gamecrcfailed = true;
+            check->checkgamecrcnever = true;
+            if (!check->usercancelledgamecrc) check->gamecrcfailed = true;
         }
     }
-    if (game_crc32 == 0) {
+    if (check->game_crc32 == 0) {
         color(yellow);
         printf("Game partition CRC is required for AutoUpload, cannot continue%s", newline);
         color(normal);
@@ -8468,7 +9711,7 @@ int doautoupload(char *argv[], bool upload_ss_only) {
     }
     
     // todo: test this on non-WIN32
-    if (iso_has_ssv2) {
+    if (check->iso_has_ssv2) {
         if (upload_ss_only) {
             // iso is verified but there is no ssv2 in the db, so do a bunch of c/r to get the median angle deviations and upload that ss
             printf("Doing extended SS C/R to get the most accurate angles...%s", newline);
@@ -8480,22 +9723,22 @@ int doautoupload(char *argv[], bool upload_ss_only) {
                     struct cam_device *real_cam_dev = cam_dev;
                 #endif
             #endif
-            char *real_isofilename =                  isofilename;
-            bool real_writefile =                     writefile;
-            FILE *real_fp =                           fp;
-            long long real_fpfilesize =               fpfilesize;
+            char *real_isofilename =                  check->isofilename;
+            bool real_writefile =                     check->writefile;
+            FILE *real_fp =                           check->fp;
+            long long real_fpfilesize =               check->fpfilesize;
             bool real_drive_speed_needs_to_be_reset = drive_speed_needs_to_be_reset;
             if (origarg) {  // origarg means the user supplied the drive letter (windows) or device name (other systems) of the drive they want to do c/r on
                 if (doextendedsscr(argv[origarg], median_ss) == 0) {
                     have_median_ss = true;
-                    drive_used_for_extended_cr = isofilename;
+                    drive_used_for_extended_cr = check->isofilename;
                 }
                 else printextendedsscrfailedmessage();
             }
             else if (doextendedsscr(NULL, median_ss) == 0) {
                 // the drive with the game will be automatically searched for
                 have_median_ss = true;
-                drive_used_for_extended_cr = isofilename;
+                drive_used_for_extended_cr = check->isofilename;
             }
             else printextendedsscrfailedmessage();
             #ifdef WIN32
@@ -8506,10 +9749,10 @@ int doautoupload(char *argv[], bool upload_ss_only) {
                     cam_dev =               real_cam_dev;
                 #endif
             #endif
-            isofilename =                   real_isofilename;
-            writefile =                     real_writefile;
-            fp =                            real_fp;
-            fpfilesize =                    real_fpfilesize;
+            check->isofilename =                   real_isofilename;
+            check->writefile =                     real_writefile;
+            check->fp =                            real_fp;
+            check->fpfilesize =                    real_fpfilesize;
             drive_speed_needs_to_be_reset = real_drive_speed_needs_to_be_reset;
         }
         else {
@@ -8531,22 +9774,22 @@ int doautoupload(char *argv[], bool upload_ss_only) {
                         struct cam_device *real_cam_dev = cam_dev;
                     #endif
                 #endif
-                char *real_isofilename =                  isofilename;
-                bool real_writefile =                     writefile;
-                FILE *real_fp =                           fp;
-                long long real_fpfilesize =               fpfilesize;
+                char *real_isofilename =                  check->isofilename;
+                bool real_writefile =                     check->writefile;
+                FILE *real_fp =                           check->fp;
+                long long real_fpfilesize =               check->fpfilesize;
                 bool real_drive_speed_needs_to_be_reset = drive_speed_needs_to_be_reset;
                 if (origarg) {  // origarg means the user supplied the drive letter (windows) or device name (other systems) of the drive they want to do c/r on
                     if (doextendedsscr(argv[origarg], median_ss) == 0) {
                         have_median_ss = true;
-                        drive_used_for_extended_cr = isofilename;
+                        drive_used_for_extended_cr = check->isofilename;
                     }
                     else printextendedsscrfailedmessage();
                 }
                 else if (doextendedsscr(NULL, median_ss) == 0) {
                     // the drive with the game will be automatically searched for
                     have_median_ss = true;
-                    drive_used_for_extended_cr = isofilename;
+                    drive_used_for_extended_cr = check->isofilename;
                 }
                 else printextendedsscrfailedmessage();
                 #ifdef WIN32
@@ -8557,10 +9800,10 @@ int doautoupload(char *argv[], bool upload_ss_only) {
                         cam_dev =               real_cam_dev;
                     #endif
                 #endif
-                isofilename =                   real_isofilename;
-                writefile =                     real_writefile;
-                fp =                            real_fp;
-                fpfilesize =                    real_fpfilesize;
+                check->isofilename =                   real_isofilename;
+                check->writefile =                     real_writefile;
+                check->fp =                            real_fp;
+                check->fpfilesize =                    real_fpfilesize;
                 drive_speed_needs_to_be_reset = real_drive_speed_needs_to_be_reset;
             }
         }
@@ -8595,13 +9838,13 @@ int doautoupload(char *argv[], bool upload_ss_only) {
     readstdin(ini_gamertag, 151);
     if (!strlen(ini_gamertag)) strncpy(ini_gamertag, argv[autouploaduserarg], 150);
 
-    if (foundgamename) {
-        fprintf(stderr, "\nEnter Game Name for %s\n[%s]: ", isofilename, gamename);
+    if (check->foundgamename) {
+        fprintf(stderr, "\nEnter Game Name for %s\n[%s]: ", check->isofilename, check->gamename);
         readstdin(ini_gamename, 151);
-        if (!strlen(ini_gamename)) strcpy(ini_gamename, gamename);
+        if (!strlen(ini_gamename)) strcpy(ini_gamename, check->gamename);
     }
     else while (!strlen(ini_gamename)) {
-        fprintf(stderr, "\nEnter Game Name for %s\n: ", isofilename);
+        fprintf(stderr, "\nEnter Game Name for %s\n: ", check->isofilename);
         readstdin(ini_gamename, 151);
     }
     
@@ -8867,8 +10110,8 @@ int doautoupload(char *argv[], bool upload_ss_only) {
     if (!homeless) userstealthpathlength = strlen(homedir) + strlen(abgxdir) + strlen(userstealthdir);
     char autouploadinifilename[userstealthpathlength + 21];  // ini is 20 chars + 1 for null byte
     memset(autouploadinifilename, 0, userstealthpathlength + 21);
-    if (!homeless) sprintf(autouploadinifilename, "%s%s%s%08lX%08lX.ini", homedir, abgxdir, userstealthdir, ss_crc32, xex_crc32);
-    else sprintf(autouploadinifilename, "%08lX%08lX.ini", ss_crc32, xex_crc32);
+    if (!homeless) sprintf(autouploadinifilename, "%s%s%s%08lX%08lX.ini", homedir, abgxdir, userstealthdir, check->ss_crc32, check->xex_crc32);
+    else sprintf(autouploadinifilename, "%08lX%08lX.ini", check->ss_crc32, check->xex_crc32);
     if (writeini(autouploadinifilename, ini_discsource, ini_gamename, ini_gamertag, ini_drivename, ini_drivefw, ini_notes) != 0) {
         color(yellow);
         printf("AutoUpload Aborted%s", newline);
@@ -8878,9 +10121,9 @@ int doautoupload(char *argv[], bool upload_ss_only) {
     // extract pfi
     char autouploadpfifilename[userstealthpathlength + 17];  // 16 + 1
     memset(autouploadpfifilename, 0, userstealthpathlength + 17);
-    if (!homeless) sprintf(autouploadpfifilename, "%s%s%sPFI_%08lX.bin", homedir, abgxdir, userstealthdir, pfi_crc32);
-    else sprintf(autouploadpfifilename, "PFI_%08lX.bin", pfi_crc32);
-    if (extractstealthfile(fp, isofilename, video - (xgd3 ? 0x9800 : 0x1800), "PFI", autouploadpfifilename) != 0) {
+    if (!homeless) sprintf(autouploadpfifilename, "%s%s%sPFI_%08lX.bin", homedir, abgxdir, userstealthdir, check->pfi_crc32);
+    else sprintf(autouploadpfifilename, "PFI_%08lX.bin", check->pfi_crc32);
+    if (extractstealthfile(check->fp, check->isofilename, check->video - (check->xgd3 ? 0x9800 : 0x1800), "PFI", autouploadpfifilename) != 0) {
         color(yellow);
         printf("AutoUpload Aborted%s", newline);
         color(normal);
@@ -8889,9 +10132,9 @@ int doautoupload(char *argv[], bool upload_ss_only) {
     // extract dmi
     char autouploaddmifilename[userstealthpathlength + 17];  // 16 + 1
     memset(autouploaddmifilename, 0, userstealthpathlength + 17);
-    if (!homeless) sprintf(autouploaddmifilename, "%s%s%sDMI_%08lX.bin", homedir, abgxdir, userstealthdir, dmi_crc32);
-    else sprintf(autouploaddmifilename, "DMI_%08lX.bin", dmi_crc32);
-    if (extractstealthfile(fp, isofilename, video - (xgd3 ? 0x9000 : 0x1000), "DMI", autouploaddmifilename) != 0) {
+    if (!homeless) sprintf(autouploaddmifilename, "%s%s%sDMI_%08lX.bin", homedir, abgxdir, userstealthdir, check->dmi_crc32);
+    else sprintf(autouploaddmifilename, "DMI_%08lX.bin", check->dmi_crc32);
+    if (extractstealthfile(check->fp, check->isofilename, check->video - (check->xgd3 ? 0x9000 : 0x1000), "DMI", autouploaddmifilename) != 0) {
         color(yellow);
         printf("AutoUpload Aborted%s", newline);
         color(normal);
@@ -8900,8 +10143,8 @@ int doautoupload(char *argv[], bool upload_ss_only) {
     // extract ss (or preferably use median ss created from extended c/r routines)
     char autouploadssfilename[userstealthpathlength + 16];  // 15 + 1
     memset(autouploadssfilename, 0, userstealthpathlength + 16);
-    if (!homeless) sprintf(autouploadssfilename, "%s%s%sSS_%08lX.bin", homedir, abgxdir, userstealthdir, ss_crc32);
-    else sprintf(autouploadssfilename, "SS_%08lX.bin", ss_crc32);
+    if (!homeless) sprintf(autouploadssfilename, "%s%s%sSS_%08lX.bin", homedir, abgxdir, userstealthdir, check->ss_crc32);
+    else sprintf(autouploadssfilename, "SS_%08lX.bin", check->ss_crc32);
     if (have_median_ss) {
         printf("Saving Median SS to %s%s%s%s", quotation, autouploadssfilename, quotation, newline);
         FILE *medianssfile = fopen(autouploadssfilename, "wb");
@@ -8925,7 +10168,7 @@ int doautoupload(char *argv[], bool upload_ss_only) {
         color(normal);
         fclose(medianssfile);
     }
-    else if (extractstealthfile(fp, isofilename, video - (xgd3 ? 0x8800 : 0x800), "SS", autouploadssfilename) != 0) {
+    else if (extractstealthfile(check->fp, check->isofilename, check->video - (check->xgd3 ? 0x8800 : 0x800), "SS", autouploadssfilename) != 0) {
         color(yellow);
         printf("AutoUpload Aborted%s", newline);
         color(normal);
@@ -8971,10 +10214,14 @@ int doautoupload(char *argv[], bool upload_ss_only) {
     curl_formadd(&formpost, &lastptr, CURLFORM_COPYNAME, "uploadedpfi", CURLFORM_FILE, autouploadpfifilename, CURLFORM_CONTENTTYPE, "application/octet-stream", CURLFORM_END);
     curl_formadd(&formpost, &lastptr, CURLFORM_COPYNAME, "uploadeddmi", CURLFORM_FILE, autouploaddmifilename, CURLFORM_CONTENTTYPE, "application/octet-stream", CURLFORM_END);
     curl_easy_setopt(curl, CURLOPT_HTTPPOST, formpost);
-    curlheaderprinted = false;
+    #ifndef WIN32
+        // the reply goes to curl.txt, which is the same file for every batch job
+        lockshared();
+    #endif
+    check->curlheaderprinted = false;
     curlprogressstartmsecs = getmsecs();
     res = curl_easy_perform(curl);
-    if (curlheaderprinted && !extraverbose) fprintf(stderr, "\n");
+    if (check->curlheaderprinted && !extraverbose) fprintf(stderr, "\n");
     if (res != CURLE_OK && !extraverbose) {  // error occurred and hasn't already been displayed
         color(yellow);
         fprintf(stderr, "ERROR: %s", curlerrorbuffer);
@@ -8998,52 +10245,58 @@ int doautoupload(char *argv[], bool upload_ss_only) {
         color(yellow);
         printf("ERROR: Failed to open cURL output file (%s), result of AutoUpload is unknown%s", strerror(errno), newline);
         color(normal);
+        #ifndef WIN32
+            unlockshared();
+        #endif
         goto prompttoretryupload;
     }
     else {
-        memset(buffer, 0, 2048);
-        dontcare = fread(buffer, 1, 2047, curloutput);
+        memset(check->buffer, 0, 2048);
+        dontcare = fread(check->buffer, 1, 2047, curloutput);
         fclose(curloutput);
         remove(curloutputfilename);
-        if (debug) printf("curloutput: %s%s", buffer, newline);
-        if (strlen(buffer) > 0) {
-            if (memcmp(buffer, "ffffff", 6) == 0) {
+        #ifndef WIN32
+            unlockshared();
+        #endif
+        if (debug) printf("curloutput: %s%s", check->buffer, newline);
+        if (strlen(check->buffer) > 0) {
+            if (memcmp(check->buffer, "ffffff", 6) == 0) {
                 color(yellow);
                 printf("Server replied: An unspecified error occurred!%s", newline);
                 color(normal);
                 goto prompttoretryupload;
             }
             else {
-                if (strlen(buffer) != 4) {
+                if (strlen(check->buffer) != 4) {
                     color(yellow);
                     printf("ERROR: Server reply is invalid, result of AutoUpload is unknown%s", newline);
                     color(normal);
-                    if (extraverbose) printf("Server reply: %s%s", buffer, newline);
+                    if (extraverbose) printf("Server reply: %s%s", check->buffer, newline);
                     goto prompttoretryupload;
                 }
-                if      (buffer[0] == '1') { color(green);  printf("Server replied: DMI uploaded perfectly%s", newline);                                          color(normal); }
-                else if (buffer[0] == '2') { color(yellow); printf("Server replied: DMI file has a different checksum to that in the ini, rejected%s", newline);  color(normal); }
-                else if (buffer[0] == '3')                  printf("Server replied: DMI file already exists, ignored%s", newline);
-                else if (buffer[0] == '4') { color(yellow); printf("Server replied: Unspecified error in DMI upload%s", newline);                                 color(normal); }
-                if      (buffer[1] == '1') { color(green);  printf("Server replied: PFI uploaded perfectly%s", newline);                                          color(normal); }
-                else if (buffer[1] == '2') { color(yellow); printf("Server replied: PFI file has a different checksum to that in the ini, rejected%s", newline);  color(normal); }
-                else if (buffer[1] == '3')                  printf("Server replied: PFI file already exists, ignored%s", newline);
-                else if (buffer[1] == '4') { color(yellow); printf("Server replied: Unspecified error in PFI upload%s", newline);                                 color(normal); }
-                if      (buffer[2] == '1') { color(green);  printf("Server replied: SS uploaded perfectly%s", newline);                                           color(normal); }
-                else if (buffer[2] == '2') { color(yellow); printf("Server replied: SS file has a different checksum to that in the ini, rejected%s", newline);   color(normal); }
-                else if (buffer[2] == '3')                  printf("Server replied: SS file already exists, ignored%s", newline);
-                else if (buffer[2] == '4') { color(yellow); printf("Server replied: Unspecified error in SS upload%s", newline);                                  color(normal); }
-                if      (buffer[3] == '0') { color(yellow); printf("Server replied: Ini file too large!%s", newline);                                             color(normal); }
-                else if (buffer[3] == '1') { color(green);  printf("Server replied: Files match! Verification completed successfully!\n"
+                if      (check->buffer[0] == '1') { color(green);  printf("Server replied: DMI uploaded perfectly%s", newline);                                          color(normal); }
+                else if (check->buffer[0] == '2') { color(yellow); printf("Server replied: DMI file has a different checksum to that in the ini, rejected%s", newline);  color(normal); }
+                else if (check->buffer[0] == '3')                  printf("Server replied: DMI file already exists, ignored%s", newline);
+                else if (check->buffer[0] == '4') { color(yellow); printf("Server replied: Unspecified error in DMI upload%s", newline);                                 color(normal); }
+                if      (check->buffer[1] == '1') { color(green);  printf("Server replied: PFI uploaded perfectly%s", newline);                                          color(normal); }
+                else if (check->buffer[1] == '2') { color(yellow); printf("Server replied: PFI file has a different checksum to that in the ini, rejected%s", newline);  color(normal); }
+                else if (check->buffer[1] == '3')                  printf("Server replied: PFI file already exists, ignored%s", newline);
+                else if (check->buffer[1] == '4') { color(yellow); printf("Server replied: Unspecified error in PFI upload%s", newline);                                 color(normal); }
+                if      (check->buffer[2] == '1') { color(green);  printf("Server replied: SS uploaded perfectly%s", newline);                                           color(normal); }
+                else if (check->buffer[2] == '2') { color(yellow); printf("Server replied: SS file has a different checksum to that in the ini, rejected%s", newline);   color(normal); }
+                else if (check->buffer[2] == '3')                  printf("Server replied: SS file already exists, ignored%s", newline);
+                else if (check->buffer[2] == '4') { color(yellow); printf("Server replied: Unspecified error in SS upload%s", newline);                                  color(normal); }
+                if      (check->buffer[3] == '0') { color(yellow); printf("Server replied: Ini file too large!%s", newline);                                             color(normal); }
+                else if (check->buffer[3] == '1') { color(green);  printf("Server replied: Files match! Verification completed successfully!\n"
                                                                    "A new DMI was also found and has been added to the existing verified ini%s", newline);        color(normal); }
-                else if (buffer[3] == '2') { color(green);  printf("Server replied: Ini already exists and has been verified, nothing to do here%s", newline);    color(normal); }
-                else if (buffer[3] == '3') { color(yellow); printf("Server replied: Files do not match! Verification unsuccessful%s", newline);                   color(normal); }
-                else if (buffer[3] == '4') { color(green);  printf("Server replied: Files match! Verification completed successfully!%s", newline);               color(normal); }
-                else if (buffer[3] == '5')                  printf("Server replied: Ini added to unverified folder, awaiting verification upload%s", newline);
-                else if (buffer[3] == '6')                  printf("Server replied: Raw SS matches. File may be duplicate, rejected%s", newline);
-                else if (buffer[3] == '7') { color(yellow); printf("Server replied: Game data checksum is invalid! Perhaps you forgot to check it%s", newline);   color(normal); }
-                else if (buffer[3] == '8') { color(yellow); printf("Server replied: Ini file is invalid or could not be loaded%s", newline);                      color(normal); }
-                else if (buffer[3] == '9') { color(yellow); printf("Server replied: Possible exception to authoring rules (rejected), tell Seacrest%s", newline); color(normal); }
+                else if (check->buffer[3] == '2') { color(green);  printf("Server replied: Ini already exists and has been verified, nothing to do here%s", newline);    color(normal); }
+                else if (check->buffer[3] == '3') { color(yellow); printf("Server replied: Files do not match! Verification unsuccessful%s", newline);                   color(normal); }
+                else if (check->buffer[3] == '4') { color(green);  printf("Server replied: Files match! Verification completed successfully!%s", newline);               color(normal); }
+                else if (check->buffer[3] == '5')                  printf("Server replied: Ini added to unverified folder, awaiting verification upload%s", newline);
+                else if (check->buffer[3] == '6')                  printf("Server replied: Raw SS matches. File may be duplicate, rejected%s", newline);
+                else if (check->buffer[3] == '7') { color(yellow); printf("Server replied: Game data checksum is invalid! Perhaps you forgot to check it%s", newline);   color(normal); }
+                else if (check->buffer[3] == '8') { color(yellow); printf("Server replied: Ini file is invalid or could not be loaded%s", newline);                      color(normal); }
+                else if (check->buffer[3] == '9') { color(yellow); printf("Server replied: Possible exception to authoring rules (rejected), tell Seacrest%s", newline); color(normal); }
             }
         }
         else {
@@ -9077,43 +10330,43 @@ int writeini(char *inifilename, char *ini_discsource, char *ini_gamename, char *
              char *ini_drivefw, char *ini_notes) {
     unsigned int u;
     printf("Writing ini to %s%s%s%s", quotation, inifilename, quotation, newline);
-    FILE *inifile = fopen(inifilename, "wb");
+    FILE *inifile = openforwriting(inifilename);
     if (inifile == NULL) {
         color(red);
         printf("ERROR: Failed to open %s%s%s for writing! (%s)%s", quotation, inifilename, quotation, strerror(errno), newline);
         color(normal);
       return 1;
     }
-    memset(buffer, 0, 2048);
-    sprintf(buffer, "[%08lX%08lX]\r\nSS=%08lX\r\nRawSS=%08lX\r\nPFI=%08lX\r\nDMI=%08lX\r\nRegionFlags=%02X%02X%02X%02X\r\n"
+    memset(check->buffer, 0, 2048);
+    sprintf(check->buffer, "[%08lX%08lX]\r\nSS=%08lX\r\nRawSS=%08lX\r\nPFI=%08lX\r\nDMI=%08lX\r\nRegionFlags=%02X%02X%02X%02X\r\n"
                     "V0=%08lX\r\nV1=%08lX\r\nVideo=%08lX\r\nGame=%08lX\r\nXexHash=%08lX\r\n"
                     "MediaID=%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X-%02X%02X%02X%02X\r\n"
                     "DiscSource=%s\r\nGameName=%s\r\nGamerTag=%s\r\nDriveName=%s\r\nDriveFW=%s\r\nNotes=%s\r\n",
-                    ss_crc32, xex_crc32, ss_crc32, ss_rawcrc32, pfi_crc32, dmi_crc32, regioncode[0], regioncode[1], regioncode[2], regioncode[3],
-                    videoL0_crc32, videoL1_crc32, video_crc32, game_crc32, xex_crc32,
-                    xex_mediaid[0], xex_mediaid[1], xex_mediaid[2], xex_mediaid[3], xex_mediaid[4], xex_mediaid[5], xex_mediaid[6], xex_mediaid[7],
-                    xex_mediaid[8], xex_mediaid[9], xex_mediaid[10], xex_mediaid[11], xex_mediaid[12], xex_mediaid[13], xex_mediaid[14], xex_mediaid[15],
+                    check->ss_crc32, check->xex_crc32, check->ss_crc32, check->ss_rawcrc32, check->pfi_crc32, check->dmi_crc32, check->regioncode[0], check->regioncode[1], check->regioncode[2], check->regioncode[3],
+                    check->videoL0_crc32, check->videoL1_crc32, check->video_crc32, check->game_crc32, check->xex_crc32,
+                    check->xex_mediaid[0], check->xex_mediaid[1], check->xex_mediaid[2], check->xex_mediaid[3], check->xex_mediaid[4], check->xex_mediaid[5], check->xex_mediaid[6], check->xex_mediaid[7],
+                    check->xex_mediaid[8], check->xex_mediaid[9], check->xex_mediaid[10], check->xex_mediaid[11], check->xex_mediaid[12], check->xex_mediaid[13], check->xex_mediaid[14], check->xex_mediaid[15],
                     ini_discsource, ini_gamename, ini_gamertag, ini_drivename, ini_drivefw, ini_notes);
     printf("%s", newline);
     if (extraverbose) {
         // print ini
         color(blue);
         if (html) {
-            for (u=0;u<strlen(buffer);u++) {
-                if (buffer[u] == '\r') {
+            for (u=0;u<strlen(check->buffer);u++) {
+                if (check->buffer[u] == '\r') {
                     printf("%s", newline);
                     u++;
                 }
-                else printf("%c", buffer[u]);
+                else printf("%c", check->buffer[u]);
             }
         }
-        else printf("%s", buffer);
+        else printf("%s", check->buffer);
         color(normal);
         printf("%s", newline);
     }
     
     initcheckwrite();
-    if (checkwriteandprinterrors(buffer, 1, strlen(buffer), inifile, 0, 0, inifilename, "Writing ini") != 0) {
+    if (checkwriteandprinterrors(check->buffer, 1, strlen(check->buffer), inifile, 0, 0, inifilename, "Writing ini") != 0) {
         fclose(inifile);
         remove(inifilename);
       return 1;
@@ -9125,22 +10378,22 @@ int writeini(char *inifilename, char *ini_discsource, char *ini_gamename, char *
 
 int extractstealthfile(FILE *isofile, char *isofilename, long long offset, char *name, char *stealthfilename) {
     printf("Extracting %s to %s%s%s%s", name, quotation, stealthfilename, quotation, newline);
-    FILE *extractstealthfile = fopen(stealthfilename, "wb");
+    FILE *extractstealthfile = openforwriting(stealthfilename);
     if (extractstealthfile == NULL) {
         color(red);
         printf("ERROR: Failed to open %s%s%s for writing! (%s) Extraction was aborted!%s", quotation, stealthfilename, quotation, strerror(errno), newline);
         color(normal);
       return 1;
     }
-    memset(buffer, 0, 2048);
+    memset(check->buffer, 0, 2048);
     if (fseeko(isofile, offset, SEEK_SET) != 0) {
         printseekerror(isofilename, "Extracting stealth file");
       return 1;
     }
     initcheckread();
-    if (checkreadandprinterrors(buffer, 1, 2048, isofile, 0, offset, isofilename, "Extracting stealth file") != 0) return 1;
+    if (checkreadandprinterrors(check->buffer, 1, 2048, isofile, 0, offset, isofilename, "Extracting stealth file") != 0) return 1;
     donecheckread(isofilename);
-    if (trytowritestealthfile(buffer, 1, 2048, extractstealthfile, stealthfilename, 0) != 0) return 1;
+    if (trytowritestealthfile(check->buffer, 1, 2048, extractstealthfile, stealthfilename, 0) != 0) return 1;
     color(green);
     printf("Extraction was successful%s", newline);
     color(normal);
@@ -9155,29 +10408,28 @@ bool unverifiediniexists() {
     int loop;
     for (loop=1;loop<100;loop++) {
         dmi_matches = false;
-        memset(inifilename, 0, 24);
-        sprintf(inifilename, "%08lX%08lX_%d.ini", ss_crc32, xex_crc32, loop);
-        if (debug) printf("unverifiediniexists - about to open inifilename: %s%s", inifilename, newline);
-        inifile = openstealthfile(inifilename, stealthdir, webunverifiedinidir, UNVERIFIED_INI, "the online unverified dir");
-        if (inifile == NULL) {
-            if (debug) printf("unverifiediniexists - inifile was NULL, infilename: %s%s", inifilename, newline);
+        memset(check->inifilename, 0, 24);
+        sprintf(check->inifilename, "%08lX%08lX_%d.ini", check->ss_crc32, check->xex_crc32, loop);
+        if (debug) printf("unverifiediniexists - about to open inifilename: %s%s", check->inifilename, newline);
+        if (openini(check->inifilename, webunverifiedinidir, UNVERIFIED_INI, "the online unverified dir") != 0) {
+            if (debug) printf("unverifiediniexists - inifile was NULL, infilename: %s%s", check->inifilename, newline);
           return false;
         }
-        if (debug) printf("unverifiediniexists - about to parse inifilename: %s%s", inifilename, newline);
+        if (debug) printf("unverifiediniexists - about to parse inifilename: %s%s", check->inifilename, newline);
         parseini();
         // delete it
-        fclose(inifile);
-        deletestealthfile(inifilename, stealthdir, false);
-        if (ini_rawss == 0 || ini_dmi[0] == 0 || ini_pfi == 0 || ini_video == 0 || ini_v0 == 0 || ini_v1 == 0 || ini_game == 0) {
+        closeini(&check->inifile);
+        deletestealthfile(check->inifilename, stealthdir, false);
+        if (check->ini_rawss == 0 || check->ini_dmi[0] == 0 || check->ini_pfi == 0 || check->ini_video == 0 || check->ini_v0 == 0 || check->ini_v1 == 0 || check->ini_game == 0) {
             if (debug) printf("unverifiediniexists - one or more ini values were zero: ini_rawss = %lu, ini_dmi[0] = %lu, ini_pfi = %lu, ini_video = %lu, ini_v0 = %lu, ini_v1 = %lu, ini_game = %lu%s",
-                               ini_rawss, ini_dmi[0], ini_pfi, ini_video, ini_v0, ini_v1, ini_game, newline);
+                               check->ini_rawss, check->ini_dmi[0], check->ini_pfi, check->ini_video, check->ini_v0, check->ini_v1, check->ini_game, newline);
             continue;
         }
-        for (i=0;i<ini_dmi_count;i++) {
-            if (ini_dmi[i] == dmi_crc32) dmi_matches = true;
+        for (i=0;i<check->ini_dmi_count;i++) {
+            if (check->ini_dmi[i] == check->dmi_crc32) dmi_matches = true;
         }
-        if (dmi_matches && ini_rawss == ss_rawcrc32 && ini_pfi == pfi_crc32 && ini_game == game_crc32 &&
-            ini_video == video_crc32 && ini_v0 == videoL0_crc32 && ini_v1 == videoL1_crc32) {
+        if (dmi_matches && check->ini_rawss == check->ss_rawcrc32 && check->ini_pfi == check->pfi_crc32 && check->ini_game == check->game_crc32 &&
+            check->ini_video == check->video_crc32 && check->ini_v0 == check->videoL0_crc32 && check->ini_v1 == check->videoL1_crc32) {
           return true;
         }
     }
@@ -9185,90 +10437,91 @@ bool unverifiediniexists() {
 }
 
 int doverify() {
-    verify_found_bad_pfi_or_video = false;
+    check->verify_found_bad_pfi_or_video = false;
     int i;
     bool printextraline = true;
     bool verified_dmi = false;
     printf("%sStarting Verification%s", newline, newline);
-    if ((stayoffline || localonly) && !offlinewarningprinted) {
+    if ((stayoffline || localonly) && !check->offlinewarningprinted) {
         color(yellow);
         //if (verbose) printf("%s", newline);
         printf("You need to enable online functions (assuming your connection works and the db%s"
                "is up) if you want to check for the latest files in the online database.%s", newline, newline);
         color(normal);
-        offlinewarningprinted = true;
+        check->offlinewarningprinted = true;
     }
-    if (xex_crc32 == 0 || ss_crc32 == 0 || ss_rawcrc32 == 0 || pfi_crc32 == 0 || dmi_crc32 == 0 || video_crc32 == 0 || videoL0_crc32 == 0 || videoL1_crc32 == 0) {
+    if (check->xex_crc32 == 0 || check->ss_crc32 == 0 || check->ss_rawcrc32 == 0 || check->pfi_crc32 == 0 || check->dmi_crc32 == 0 || check->video_crc32 == 0 || check->videoL0_crc32 == 0 || check->videoL1_crc32 == 0) {
         color(yellow);
         printf("One or more CRC requirements for Verification were not met, cannot continue%s", newline);
         color(normal);
       return 1;
     }
-    memset(inifilename, 0, 24);
-    sprintf(inifilename, "%08lX%08lX.ini", ss_crc32, xex_crc32);
-    inifile = openstealthfile(inifilename, stealthdir, webinidir, SSXEX_INI, "the online verified database");
-    if (inifile == NULL) {
+    #ifndef WIN32
+        prefetchstealthfiles();
+    #endif
+    memset(check->inifilename, 0, 24);
+    sprintf(check->inifilename, "%08lX%08lX.ini", check->ss_crc32, check->xex_crc32);
+    if (openini(check->inifilename, webinidir, SSXEX_INI, "the online verified database") != 0) {
         printf("Failed to find a verified ini file for this Xex/SS combination%s", newline);
-        if (dvdarg || !writefile || !autofixalways || !autofixuncertain) {
+        if (dvdarg || !check->writefile || !autofixalways || !autofixuncertain) {
             // if we won't be autofixing we'll try to find any ini for the xex and verify pfi, video and game data
             printf("Attempting to at least verify the PFI, Video and game data%s", newline);
-            memset(xexinifilename, 0, 17);
-            sprintf(xexinifilename, "Xex_%08lX.ini", xex_crc32);
-            xexinifile = openstealthfile(xexinifilename, stealthdir, webinidir, XEX_INI, "the online verified database");
-            if (xexinifile == NULL) {
+            memset(check->xexinifilename, 0, 17);
+            sprintf(check->xexinifilename, "Xex_%08lX.ini", check->xex_crc32);
+            if (openini(check->xexinifilename, webinidir, XEX_INI, "the online verified database") != 0) {
                 printf("Failed to find a verified ini file for this Xex%s", newline);
-                noxexiniavailable = true;
+                check->noxexiniavailable = true;
               return 1;
             }
             if (openinifromxexini() != 0) return 1;
             parseini();
-            if (ini_pfi == 0) {
+            if (check->ini_pfi == 0) {
                 color(red);
-                printf("ERROR: Failed to find a PFI CRC in '%s', deleting it%s", inifilename, newline);
+                printf("ERROR: Failed to find a PFI CRC in '%s', deleting it%s", check->inifilename, newline);
                 color(normal);
                 // delete it
-                fclose(inifile);
-                deletestealthfile(inifilename, stealthdir, false);
+                closeini(&check->inifile);
+                deletestealthfile(check->inifilename, stealthdir, false);
               return 1;
             }
-            if (ini_video == 0) {
+            if (check->ini_video == 0) {
                 color(red);
-                printf("ERROR: Failed to find a Video CRC in '%s', deleting it%s", inifilename, newline);
+                printf("ERROR: Failed to find a Video CRC in '%s', deleting it%s", check->inifilename, newline);
                 color(normal);
                 // delete it
-                fclose(inifile);
-                deletestealthfile(inifilename, stealthdir, false);
+                closeini(&check->inifile);
+                deletestealthfile(check->inifilename, stealthdir, false);
               return 1;
             }
-            if (ini_v0 == 0) {
+            if (check->ini_v0 == 0) {
                 color(red);
-                printf("ERROR: Failed to find a V0 CRC in '%s', deleting it%s", inifilename, newline);
+                printf("ERROR: Failed to find a V0 CRC in '%s', deleting it%s", check->inifilename, newline);
                 color(normal);
                 // delete it
-                fclose(inifile);
-                deletestealthfile(inifilename, stealthdir, false);
+                closeini(&check->inifile);
+                deletestealthfile(check->inifilename, stealthdir, false);
               return 1;
             }
-            if (ini_v1 == 0) {
+            if (check->ini_v1 == 0) {
                 color(red);
-                printf("ERROR: Failed to find a V1 CRC in '%s', deleting it%s", inifilename, newline);
+                printf("ERROR: Failed to find a V1 CRC in '%s', deleting it%s", check->inifilename, newline);
                 color(normal);
                 // delete it
-                fclose(inifile);
-                deletestealthfile(inifilename, stealthdir, false);
+                closeini(&check->inifile);
+                deletestealthfile(check->inifilename, stealthdir, false);
               return 1;
             }
-            if (ini_game == 0 && !checkgamecrcnever) {
+            if (check->ini_game == 0 && !check->checkgamecrcnever) {
                 color(red);
-                printf("ERROR: Failed to find a Game CRC in '%s', deleting it%s", inifilename, newline);
+                printf("ERROR: Failed to find a Game CRC in '%s', deleting it%s", check->inifilename, newline);
                 color(normal);
                 // delete it
-                fclose(inifile);
-                deletestealthfile(inifilename, stealthdir, false);
+                closeini(&check->inifile);
+                deletestealthfile(check->inifilename, stealthdir, false);
               return 1;
             }
             // check that video matches
-            if (ini_video == video_crc32) {
+            if (check->ini_video == check->video_crc32) {
                 if (verbose) {
                     color(green);
                     printf("%sVideo CRC matches%s", sp5, newline);
@@ -9279,11 +10532,11 @@ int doverify() {
                 color(red);
                 printf("%sVideo CRC does not match!%s", sp5, newline);
                 color(normal);
-                verify_found_bad_pfi_or_video = true;
+                check->verify_found_bad_pfi_or_video = true;
                 autoupload = false;
             }
             // check that v0 matches
-            if (ini_v0 == videoL0_crc32) {
+            if (check->ini_v0 == check->videoL0_crc32) {
                 if (verbose) {
                     color(green);
                     printf("%sV0 %s CRC matches%s", sp5, sp2, newline);
@@ -9294,11 +10547,11 @@ int doverify() {
                 color(red);
                 printf("%sV0 %s CRC does not match!%s", sp5, sp2, newline);
                 color(normal);
-                verify_found_bad_pfi_or_video = true;
+                check->verify_found_bad_pfi_or_video = true;
                 autoupload = false;
             }
             // check that v1 matches
-            if (ini_v1 == videoL1_crc32) {
+            if (check->ini_v1 == check->videoL1_crc32) {
                 if (verbose) {
                     color(green);
                     printf("%sV1 %s CRC matches%s", sp5, sp2, newline);
@@ -9309,11 +10562,11 @@ int doverify() {
                 color(red);
                 printf("%sV1 %s CRC does not match!%s", sp5, sp2, newline);
                 color(normal);
-                verify_found_bad_pfi_or_video = true;
+                check->verify_found_bad_pfi_or_video = true;
                 autoupload = false;
             }
             // check that pfi matches
-            if (ini_pfi == pfi_crc32) {
+            if (check->ini_pfi == check->pfi_crc32) {
                 if (verbose) {
                     color(green);
                     printf("%sPFI %s CRC matches%s", sp5, sp1, newline);
@@ -9324,15 +10577,15 @@ int doverify() {
                 color(red);
                 printf("%sPFI %s CRC does not match!%s", sp5, sp1, newline);
                 color(normal);
-                verify_found_bad_pfi_or_video = true;
+                check->verify_found_bad_pfi_or_video = true;
                 autoupload = false;
             }
             // make the splitvid check possible (obsolete, but doing this isn't a bad idea anyway...)
-            if (video_stealthuncertain && ini_video == video_crc32 && ini_v0 == videoL0_crc32 && ini_v1 == videoL1_crc32) {
-                video_stealthuncertain = false;
+            if (check->video_stealthuncertain && check->ini_video == check->video_crc32 && check->ini_v0 == check->videoL0_crc32 && check->ini_v1 == check->videoL1_crc32) {
+                check->video_stealthuncertain = false;
             }
-            if (pfi_stealthuncertain && ini_pfi == pfi_crc32) {
-                pfi_stealthuncertain = false;
+            if (check->pfi_stealthuncertain && check->ini_pfi == check->pfi_crc32) {
+                check->pfi_stealthuncertain = false;
             }
             color(yellow);
             printf("%sDMI is unverified%s", sp5, newline);
@@ -9344,8 +10597,8 @@ int doverify() {
                 printf("%sXex %s CRC matches%s", sp5, sp1, newline);
                 color(normal);
             }
-            if (game_crc32 != 0) {
-                if (ini_game != game_crc32) {
+            if (check->game_crc32 != 0) {
+                if (check->ini_game != check->game_crc32) {
                     printbadgamecrcerror();
                     autoupload = false;
                   return 1;
@@ -9357,17 +10610,17 @@ int doverify() {
                 }
               return 3;
             }
-            else if (!checkgamecrcnever) {
+            else if (!check->checkgamecrcnever) {
                 if (docheckgamecrc() == 0) {
-                    if (corruptionoffsetcount == 0) {
+                    if (check->corruptionoffsetcount == 0) {
                         color(green);
                         if (verbose) printf("%s", sp5);
                         printf("AnyDVD style corruption was not detected%s", newline);
                         color(normal);
                     }
                     if (verbose) {
-                        printf("%sGame CRC = %08lX", sp5, game_crc32);
-                        if (ini_game == game_crc32) {
+                        printf("%sGame CRC = %08lX", sp5, check->game_crc32);
+                        if (check->ini_game == check->game_crc32) {
                             color(green);
                             printf(" (matches)%s%s", newline, newline);
                             color(normal);
@@ -9376,7 +10629,7 @@ int doverify() {
                             printf("%s%s", newline, newline);
                         }
                     }
-                    if (ini_game != game_crc32) {
+                    if (check->ini_game != check->game_crc32) {
                         printbadgamecrcerror();
                         autoupload = false;
                       return 1;
@@ -9384,7 +10637,7 @@ int doverify() {
                   return 3;
                 }
                 else {
-                    if (usercancelledgamecrc) {
+                    if (check->usercancelledgamecrc) {
                         if (verbose) printf("%s", newline);
                         color(yellow);
                         printf("Game CRC was skipped%s", newline);
@@ -9393,10 +10646,10 @@ int doverify() {
                         if (verbose) printf("%s", newline);
                         color(red);
                         printf("Error occurred while checking the Game CRC%s", newline);
-                        gamecrcfailed = true;
+                        check->gamecrcfailed = true;
                     }
                     color(normal);
-                    checkgamecrcnever = true;
+                    check->checkgamecrcnever = true;
                   return 1;
                 }
             }
@@ -9413,66 +10666,66 @@ int doverify() {
     }
     // verify using the ini (xex and ss are already verified)
     parseini();
-    if (ini_dmi[0] == 0) {
+    if (check->ini_dmi[0] == 0) {
         color(yellow);
-        printf("ERROR: Failed to find a DMI CRC in '%s'%s", inifilename, newline);
+        printf("ERROR: Failed to find a DMI CRC in '%s'%s", check->inifilename, newline);
         color(normal);
         // delete it
-        fclose(inifile);
-        deletestealthfile(inifilename, stealthdir, false);
+        closeini(&check->inifile);
+        deletestealthfile(check->inifilename, stealthdir, false);
       return 1;
     }
-    if (ini_pfi == 0) {
+    if (check->ini_pfi == 0) {
         color(yellow);
-        printf("ERROR: Failed to find a PFI CRC in '%s'%s", inifilename, newline);
+        printf("ERROR: Failed to find a PFI CRC in '%s'%s", check->inifilename, newline);
         color(normal);
         // delete it
-        fclose(inifile);
-        deletestealthfile(inifilename, stealthdir, false);
+        closeini(&check->inifile);
+        deletestealthfile(check->inifilename, stealthdir, false);
       return 1;
     }
-    if (ini_video == 0) {
+    if (check->ini_video == 0) {
         color(yellow);
-        printf("ERROR: Failed to find a Video CRC in '%s'%s", inifilename, newline);
+        printf("ERROR: Failed to find a Video CRC in '%s'%s", check->inifilename, newline);
         color(normal);
         // delete it
-        fclose(inifile);
-        deletestealthfile(inifilename, stealthdir, false);
+        closeini(&check->inifile);
+        deletestealthfile(check->inifilename, stealthdir, false);
       return 1;
     }
-    if (ini_v0 == 0) {
+    if (check->ini_v0 == 0) {
         color(yellow);
-        printf("ERROR: Failed to find a V0 CRC in '%s'%s", inifilename, newline);
+        printf("ERROR: Failed to find a V0 CRC in '%s'%s", check->inifilename, newline);
         color(normal);
         // delete it
-        fclose(inifile);
-        deletestealthfile(inifilename, stealthdir, false);
+        closeini(&check->inifile);
+        deletestealthfile(check->inifilename, stealthdir, false);
       return 1;
     }
-    if (ini_v1 == 0) {
+    if (check->ini_v1 == 0) {
         color(yellow);
-        printf("ERROR: Failed to find a V1 CRC in '%s'%s", inifilename, newline);
+        printf("ERROR: Failed to find a V1 CRC in '%s'%s", check->inifilename, newline);
         color(normal);
         // delete it
-        fclose(inifile);
-        deletestealthfile(inifilename, stealthdir, false);
+        closeini(&check->inifile);
+        deletestealthfile(check->inifilename, stealthdir, false);
       return 1;
     }
-    if (ini_game == 0 && !checkgamecrcnever) {
+    if (check->ini_game == 0 && !check->checkgamecrcnever) {
         color(yellow);
-        printf("ERROR: Failed to find a Game CRC in '%s'%s", inifilename, newline);
+        printf("ERROR: Failed to find a Game CRC in '%s'%s", check->inifilename, newline);
         color(normal);
         // delete it
-        fclose(inifile);
-        deletestealthfile(inifilename, stealthdir, false);
+        closeini(&check->inifile);
+        deletestealthfile(check->inifilename, stealthdir, false);
       return 1;
     }
     // check for any matching dmi
-    for (i=0;i<ini_dmi_count;i++) {
-        if (ini_dmi[i] == dmi_crc32) verified_dmi = true;
+    for (i=0;i<check->ini_dmi_count;i++) {
+        if (check->ini_dmi[i] == check->dmi_crc32) verified_dmi = true;
     }
     // check that video matches
-    if (ini_video == video_crc32) {
+    if (check->ini_video == check->video_crc32) {
         if (verbose) {
             color(green);
             printf("%sVideo CRC matches%s", sp5, newline);
@@ -9483,11 +10736,11 @@ int doverify() {
         color(red);
         printf("%sVideo CRC does not match!%s", sp5, newline);
         color(normal);
-        verify_found_bad_pfi_or_video = true;
+        check->verify_found_bad_pfi_or_video = true;
         autoupload = false;
     }
     // check that v0 matches
-    if (ini_v0 == videoL0_crc32) {
+    if (check->ini_v0 == check->videoL0_crc32) {
         if (verbose) {
             color(green);
             printf("%sV0 %s CRC matches%s", sp5, sp2, newline);
@@ -9498,11 +10751,11 @@ int doverify() {
         color(red);
         printf("%sV0 %s CRC does not match!%s", sp5, sp2, newline);
         color(normal);
-        verify_found_bad_pfi_or_video = true;
+        check->verify_found_bad_pfi_or_video = true;
         autoupload = false;
     }
     // check that v1 matches
-    if (ini_v1 == videoL1_crc32) {
+    if (check->ini_v1 == check->videoL1_crc32) {
         if (verbose) {
             color(green);
             printf("%sV1 %s CRC matches%s", sp5, sp2, newline);
@@ -9513,11 +10766,11 @@ int doverify() {
         color(red);
         printf("%sV1 %s CRC does not match!%s", sp5, sp2, newline);
         color(normal);
-        verify_found_bad_pfi_or_video = true;
+        check->verify_found_bad_pfi_or_video = true;
         autoupload = false;
     }
     // check that pfi matches
-    if (ini_pfi == pfi_crc32) {
+    if (check->ini_pfi == check->pfi_crc32) {
         if (verbose) {
             color(green);
             printf("%sPFI %s CRC matches%s", sp5, sp1, newline);
@@ -9528,15 +10781,15 @@ int doverify() {
         color(red);
         printf("%sPFI %s CRC does not match!%s", sp5, sp1, newline);
         color(normal);
-        verify_found_bad_pfi_or_video = true;
+        check->verify_found_bad_pfi_or_video = true;
         autoupload = false;
     }
     // make the splitvid check possible (obsolete, but doing this isn't a bad idea anyway...)
-    if (video_stealthuncertain && ini_video == video_crc32 && ini_v0 == videoL0_crc32 && ini_v1 == videoL1_crc32) {
-        video_stealthuncertain = false;
+    if (check->video_stealthuncertain && check->ini_video == check->video_crc32 && check->ini_v0 == check->videoL0_crc32 && check->ini_v1 == check->videoL1_crc32) {
+        check->video_stealthuncertain = false;
     }
-    if (pfi_stealthuncertain && ini_pfi == pfi_crc32) {
-        pfi_stealthuncertain = false;
+    if (check->pfi_stealthuncertain && check->ini_pfi == check->pfi_crc32) {
+        check->pfi_stealthuncertain = false;
     }
     // display results of our check for any matching dmi
     if (verified_dmi) {
@@ -9558,8 +10811,8 @@ int doverify() {
                "%sXex %s CRC matches%s", sp5, sp2, newline, sp5, sp1, newline);
         color(normal);
     }
-    if (game_crc32 != 0) {
-        if (ini_game != game_crc32) {
+    if (check->game_crc32 != 0) {
+        if (check->ini_game != check->game_crc32) {
             printbadgamecrcerror();
             autoupload = false;
         }
@@ -9569,17 +10822,17 @@ int doverify() {
             color(normal);
         }
     }
-    else if (!checkgamecrcnever) {
+    else if (!check->checkgamecrcnever) {
         if (docheckgamecrc() == 0) {
-            if (corruptionoffsetcount == 0) {
+            if (check->corruptionoffsetcount == 0) {
                 color(green);
                 if (verbose) printf("%s", sp5);
                 printf("AnyDVD style corruption was not detected%s", newline);
                 color(normal);
             }
             if (verbose) {
-                printf("%sGame CRC = %08lX", sp5, game_crc32);
-                if (ini_game == game_crc32) {
+                printf("%sGame CRC = %08lX", sp5, check->game_crc32);
+                if (check->ini_game == check->game_crc32) {
                     color(green);
                     printf(" (matches)%s%s", newline, newline);
                     color(normal);
@@ -9589,29 +10842,29 @@ int doverify() {
                 }
                 printextraline = false;
             }
-            if (ini_game != game_crc32) {
+            if (check->ini_game != check->game_crc32) {
                 printbadgamecrcerror();
                 autoupload = false;
             }
         }
         else {
-            checkgamecrcnever = true;
-            if (!usercancelledgamecrc) gamecrcfailed = true;
+            check->checkgamecrcnever = true;
+            if (!check->usercancelledgamecrc) check->gamecrcfailed = true;
         }
     }
     if (verbose && printextraline) printf("%s", newline);
-    if (verified_dmi && ini_pfi == pfi_crc32 && ini_video == video_crc32 && ini_v0 == videoL0_crc32 && ini_v1 == videoL1_crc32) {
-        if (game_crc32 == 0) {  // stealth crcs are good but never got the game crc for whatever reason
+    if (verified_dmi && check->ini_pfi == check->pfi_crc32 && check->ini_video == check->video_crc32 && check->ini_v0 == check->videoL0_crc32 && check->ini_v1 == check->videoL1_crc32) {
+        if (check->game_crc32 == 0) {  // stealth crcs are good but never got the game crc for whatever reason
             color(green);
             printf("All Stealth CRCs match");
-            if (usercancelledgamecrc) {
+            if (check->usercancelledgamecrc) {
                 // all good (skipped game crc)
                 color(yellow);
                 printf(" (Game CRC was skipped)%s", newline);
                 color(normal);
               return 2;
             }
-            else if (gamecrcfailed) {
+            else if (check->gamecrcfailed) {
                 // there was an error checking the game crc
                 color(red);
                 printf(" (Error occurred while checking the Game CRC)%s", newline);
@@ -9627,7 +10880,7 @@ int doverify() {
             }
         }
         else {  // successfully got the game crc
-            if (ini_game == game_crc32) {
+            if (check->ini_game == check->game_crc32) {
                 // all good
                 color(green);
                 printf("All CRCs match%s", newline);
@@ -9653,19 +10906,19 @@ int doautofix() {
     char pfifilename[17], dmifilename[17], ssfilename[16], videofilename[19];
     FILE *pfifile = NULL, *dmifile = NULL, *ssfile = NULL, *videofile = NULL;
     bool fixss = false, fixpfi = false, fixvideo = false, keepdmi = false;
-    if (xex_crc32 == 0) {
+    if (check->xex_crc32 == 0) {
         color(yellow);
         printf("%sMinimum requirement for AutoFix (Xex CRC) not met, cannot continue%s", newline, newline);
         color(normal);
       return 1;
     }
-    if (noxexiniavailable) {
+    if (check->noxexiniavailable) {
         color(yellow);
         printf("%sAborting AutoFix because there is no Xex ini available%s", newline, newline);
         color(normal);
       return 1;
     }
-    if (!writefile) {
+    if (!check->writefile) {
         color(yellow);
         printf("%sAborting AutoFix because writing is disabled%s", newline, newline);
         color(normal);
@@ -9673,18 +10926,20 @@ int doautofix() {
     }
     int randomdmicrc = 0;
     printf("%sStarting AutoFix%s", newline, newline);
-    if ((stayoffline || localonly) && !offlinewarningprinted) {
+    if ((stayoffline || localonly) && !check->offlinewarningprinted) {
         color(yellow);
         printf("You need to enable online functions (assuming your connection works and the db%s"
                "is up) if you want to check for the latest files in the online database.%s", newline, newline);
         color(normal);
-        offlinewarningprinted = true;
+        check->offlinewarningprinted = true;
     }
+    #ifndef WIN32
+        prefetchstealthfiles();
+    #endif
     // try to autofix using an ss crc out of the Xex_<xex_crc32>.ini
-    memset(xexinifilename, 0, 17);
-    sprintf(xexinifilename, "Xex_%08lX.ini", xex_crc32);
-    xexinifile = openstealthfile(xexinifilename, stealthdir, webinidir, XEX_INI, "the online verified database");
-    if (xexinifile == NULL) {
+    memset(check->xexinifilename, 0, 17);
+    sprintf(check->xexinifilename, "Xex_%08lX.ini", check->xex_crc32);
+    if (openini(check->xexinifilename, webinidir, XEX_INI, "the online verified database") != 0) {
         color(yellow);
         printf("Failed to find a verified ini file for this Xex%s", newline);
         color(normal);
@@ -9696,20 +10951,20 @@ int doautofix() {
     // autofix using the ini
     parseini();
     // get/open the required stealth files
-    if (should_nuke_dmi() || ini_ss != ss_crc32 || drtfucked) {
+    if (should_nuke_dmi() || check->ini_ss != check->ss_crc32 || check->drtfucked) {
         fixss = true;
-        if (ini_ss == 0) {
-            printf("ERROR: Failed to find an SS CRC in '%s'%s", inifilename, newline);
+        if (check->ini_ss == 0) {
+            printf("ERROR: Failed to find an SS CRC in '%s'%s", check->inifilename, newline);
           return 1;
         }
         memset(ssfilename, 0, 16);
-        sprintf(ssfilename, "SS_%08lX.bin", ini_ss);
+        sprintf(ssfilename, "SS_%08lX.bin", check->ini_ss);
         ssfile = openstealthfile(ssfilename, stealthdir, webstealthdir, SS_FILE, "the online verified database");
         if (ssfile == NULL) {
             printf("ERROR: Failed to find or open '%s' (%s)%s", ssfilename, strerror(errno), newline);
           return 1;
         }
-        memset(ss, 0, 2048);
+        memset(check->ss, 0, 2048);
         // make sure that ssfile is 2048 bytes before reading it
         stealthfilesize = getfilesize(ssfile);
         if (stealthfilesize == -1) {  // seek error
@@ -9724,7 +10979,7 @@ int doautofix() {
             deletestealthfile(ssfilename, stealthdir, false);
             return 1;
         }
-        if (trytoreadstealthfile(ss, 1, 2048, ssfile, ssfilename, 0) != 0) {
+        if (trytoreadstealthfile(check->ss, 1, 2048, ssfile, ssfilename, 0) != 0) {
             fclose(ssfile);
             deletestealthfile(ssfilename, stealthdir, false);
           return 1;
@@ -9732,7 +10987,7 @@ int doautofix() {
         fclose(ssfile);
         // check to see if autofix ss is valid for this game
         printf("%sVerifying %s is valid before using it for AutoFix%s", sp5, ssfilename, newline);
-        if (getzeros(ss, 0, 2047) == 2048) {
+        if (zeroscan_allzeros(check->ss, 2048)) {
             color(red);
             printf("ERROR: %s is blank! AutoFix was aborted!%s", ssfilename, newline);
             color(normal);
@@ -9742,7 +10997,7 @@ int doautofix() {
         if (verbose) printf("%s", newline);
         checkss();
         if (verbose) printf("%s", newline);
-        if (ss_stealthfailed || ss_stealthuncertain) {
+        if (check->ss_stealthfailed || check->ss_stealthuncertain) {
             // ss failed stealth check against the xex
             color(red);
             printf("ERROR: %s appears to be invalid! AutoFix was aborted!%s", ssfilename, newline);
@@ -9751,40 +11006,43 @@ int doautofix() {
           return 1;
         }
         // check to see if autofix ss matches ini crc
-        if (ini_ss != ss_crc32) {
+        if (check->ini_ss != check->ss_crc32) {
             color(red);
-            printf("ERROR: %s has an incorrect CRC! (it was %08lX and should have been %08lX) AutoFix was aborted!%s", ssfilename, ss_crc32, ini_ss, newline);
+            printf("ERROR: %s has an incorrect CRC! (it was %08lX and should have been %08lX) AutoFix was aborted!%s", ssfilename, check->ss_crc32, check->ini_ss, newline);
             color(normal);
             deletestealthfile(ssfilename, stealthdir, false);
           return 1;
         }
+        #ifndef WIN32
+            addtostealthstore(ssfilename, stealthdir);
+        #endif
     }
     if (!should_nuke_dmi()) {
-    for (i=0;i<ini_dmi_count;i++) {  // keep the current dmi if it matches any of the verified dmis for this xex/ss
-        if (ini_dmi[i] == dmi_crc32) keepdmi = true;
+    for (i=0;i<check->ini_dmi_count;i++) {  // keep the current dmi if it matches any of the verified dmis for this xex/ss
+        if (check->ini_dmi[i] == check->dmi_crc32) keepdmi = true;
     }
   }
     if (!keepdmi) {
-        if (ini_dmi_count == 0 || ini_dmi[0] == 0) {
-            printf("ERROR: Failed to find a DMI CRC in '%s'%s", inifilename, newline);
+        if (check->ini_dmi_count == 0 || check->ini_dmi[0] == 0) {
+            printf("ERROR: Failed to find a DMI CRC in '%s'%s", check->inifilename, newline);
           return 1;
         }
-        else if (ini_dmi_count > 1) {
-            randomdmicrc = randomnumber(0, ini_dmi_count - 1);
-            if (ini_dmi[randomdmicrc] == 0) {
-                for(i=0;i<ini_dmi_count;i++) {
-                    if (ini_dmi[i] != 0) randomdmicrc = i;
+        else if (check->ini_dmi_count > 1) {
+            randomdmicrc = randomnumber(0, check->ini_dmi_count - 1);
+            if (check->ini_dmi[randomdmicrc] == 0) {
+                for(i=0;i<check->ini_dmi_count;i++) {
+                    if (check->ini_dmi[i] != 0) randomdmicrc = i;
                 }
-                if (ini_dmi[randomdmicrc] == 0) {
-                    printf("ERROR: Failed to find a valid DMI CRC in '%s'%s", inifilename, newline);
+                if (check->ini_dmi[randomdmicrc] == 0) {
+                    printf("ERROR: Failed to find a valid DMI CRC in '%s'%s", check->inifilename, newline);
                   return 1;
                 }
             }
             if (verbose) printf("%s'%s' contains %d DMI crcs, randomly picked %s%d%s",
-                                 sp5, inifilename, ini_dmi_count, numbersign, randomdmicrc + 1, newline);
+                                 sp5, check->inifilename, check->ini_dmi_count, numbersign, randomdmicrc + 1, newline);
         }
         memset(dmifilename, 0, 17);
-        sprintf(dmifilename, "DMI_%08lX.bin", ini_dmi[randomdmicrc]);
+        sprintf(dmifilename, "DMI_%08lX.bin", check->ini_dmi[randomdmicrc]);
         dmifile = openstealthfile(dmifilename, stealthdir, webstealthdir, STEALTH_FILE, "the online verified database");
         if (dmifile == NULL) {
             printf("ERROR: Failed to find or open '%s' (%s)%s", dmifilename, strerror(errno), newline);
@@ -9814,7 +11072,7 @@ int doautofix() {
         fclose(dmifile);
         // check to see if autofix dmi is valid for this game
         printf("%sVerifying %s is valid before using it for AutoFix%s", sp5, dmifilename, newline);
-        if (getzeros(autofix_dmi, 0, 2047) == 2048) {
+        if (zeroscan_allzeros(autofix_dmi, 2048)) {
             color(red);
             printf("ERROR: %s is blank! AutoFix was aborted!%s", dmifilename, newline);
             color(normal);
@@ -9823,7 +11081,7 @@ int doautofix() {
         }
         checkdmi(autofix_dmi);
         if (verbose) printf("%s", newline);
-        if (dmi_stealthfailed || dmi_stealthuncertain) {
+        if (check->dmi_stealthfailed || check->dmi_stealthuncertain) {
             // dmi failed stealth check against the xex/ss
             color(red);
             printf("ERROR: %s appears to be invalid! AutoFix was aborted!%s", dmifilename, newline);
@@ -9832,22 +11090,25 @@ int doautofix() {
           return 1;
         }
         // check to see if autofix dmi matches ini crc
-        if (ini_dmi[randomdmicrc] != dmi_crc32) {
+        if (check->ini_dmi[randomdmicrc] != check->dmi_crc32) {
             color(red);
-            printf("ERROR: %s has an incorrect CRC! (it was %08lX and should have been %08lX) AutoFix was aborted!%s", dmifilename, dmi_crc32, ini_dmi[randomdmicrc], newline);
+            printf("ERROR: %s has an incorrect CRC! (it was %08lX and should have been %08lX) AutoFix was aborted!%s", dmifilename, check->dmi_crc32, check->ini_dmi[randomdmicrc], newline);
             color(normal);
             deletestealthfile(dmifilename, stealthdir, false);
           return 1;
         }
+        #ifndef WIN32
+            addtostealthstore(dmifilename, stealthdir);
+        #endif
     }
-    if (ini_pfi != pfi_crc32) {
+    if (check->ini_pfi != check->pfi_crc32) {
         fixpfi = true;
-        if (ini_pfi == 0) {
-            printf("ERROR: Failed to find a PFI CRC in '%s'%s", inifilename, newline);
+        if (check->ini_pfi == 0) {
+            printf("ERROR: Failed to find a PFI CRC in '%s'%s", check->inifilename, newline);
           return 1;
         }
         memset(pfifilename, 0, 17);
-        sprintf(pfifilename, "PFI_%08lX.bin", ini_pfi);
+        sprintf(pfifilename, "PFI_%08lX.bin", check->ini_pfi);
         pfifile = openstealthfile(pfifilename, stealthdir, webstealthdir, STEALTH_FILE, "the online verified database");
         if (pfifile == NULL) {
             printf("ERROR: Failed to find or open '%s' (%s)%s", pfifilename, strerror(errno), newline);
@@ -9876,7 +11137,7 @@ int doautofix() {
         fclose(pfifile);
         // check to see if autofix pfi is valid for this game
         printf("%sVerifying %s is valid before using it for AutoFix%s", sp5, pfifilename, newline);
-        if (getzeros(autofix_pfi, 0, 2047) == 2048) {
+        if (zeroscan_allzeros(autofix_pfi, 2048)) {
             color(red);
             printf("ERROR: %s is blank! AutoFix was aborted!%s", pfifilename, newline);
             color(normal);
@@ -9885,7 +11146,7 @@ int doautofix() {
         }
         checkpfi(autofix_pfi);
         if (verbose) printf("%s", newline);
-        if (pfi_stealthfailed || pfi_stealthuncertain) {
+        if (check->pfi_stealthfailed || check->pfi_stealthuncertain) {
             // pfi failed stealth check
             color(red);
             printf("ERROR: %s appears to be invalid! AutoFix was aborted!%s", pfifilename, newline);
@@ -9894,27 +11155,30 @@ int doautofix() {
           return 1;
         }
         // check to see if autofix pfi matches ini crc
-        if (ini_pfi != pfi_crc32) {
+        if (check->ini_pfi != check->pfi_crc32) {
             color(red);
-            printf("ERROR: %s has an incorrect CRC! (it was %08lX and should have been %08lX) AutoFix was aborted!%s", pfifilename, pfi_crc32, ini_pfi, newline);
+            printf("ERROR: %s has an incorrect CRC! (it was %08lX and should have been %08lX) AutoFix was aborted!%s", pfifilename, check->pfi_crc32, check->ini_pfi, newline);
             color(normal);
             deletestealthfile(pfifilename, stealthdir, false);
           return 1;
         }
+        #ifndef WIN32
+            addtostealthstore(pfifilename, stealthdir);
+        #endif
     }
-    if (ini_video != video_crc32) {
+    if (check->ini_video != check->video_crc32) {
         fixvideo = true;
-        if (ini_video == 0) {
-            printf("ERROR: Failed to find a Video CRC in '%s'%s", inifilename, newline);
-            fclose(inifile);
-            deletestealthfile(inifilename, stealthdir, false);
+        if (check->ini_video == 0) {
+            printf("ERROR: Failed to find a Video CRC in '%s'%s", check->inifilename, newline);
+            closeini(&check->inifile);
+            deletestealthfile(check->inifilename, stealthdir, false);
           return 1;
         }
         memset(videofilename, 0, 19);
-        sprintf(videofilename, "Video_%08lX.iso", ini_video);
+        sprintf(videofilename, "Video_%08lX.iso", check->ini_video);
         bool video_file_is_hosted = false;
         for (m=0;m<num_videoentries;m++) {
-            if (ini_video == mostrecentvideoentries[m].crc) {
+            if (check->ini_video == mostrecentvideoentries[m].crc) {
                 if (mostrecentvideoentries[m].hosted) video_file_is_hosted = true;
               break;
             }
@@ -9928,7 +11192,7 @@ int doautofix() {
                        "This is a very large video partition that isn't hosted on the database, so%s"
                        "you'll have to find it elsewhere and put it in your StealthFiles folder --%s",
                        videofilename, strerror(errno), newline, newline, newline);
-                if (layerbreak == 2133520) {
+                if (check->layerbreak == 2133520) {
                     printf("Since XGD3 video partitions are unique for every game, you probably won't find%s"
                            "it online and will have to rip another copy of the game instead%s", newline, newline);
                 }
@@ -9938,12 +11202,24 @@ int doautofix() {
             color(normal);
           return 1;
         }
+        #ifndef WIN32
+            if (stealthfiletrusted(videofilename, stealthdir, videofile)) {
+                // it's the same file that passed these checks when it went into the stealth file store
+                printf("%s%s was already verified, skipping the Video check%s", sp5, videofilename, newline);
+                check->video_crc32 = check->ini_video;
+                check->videoL0_crc32 = check->ini_v0;
+                check->videoL1_crc32 = check->ini_v1;
+                check->video_stealthfailed = false;
+                check->video_stealthuncertain = false;
+              goto videoverified;
+            }
+        #endif
         // check to see if autofix video is valid for this game
         printf("%sVerifying %s is valid before using it for AutoFix%s", sp5, videofilename, newline);
         if (verbose) printf("%s", newline);
         checkvideo(videofilename, videofile, true, false);
         if (verbose) printf("%s", newline);
-        if (video_stealthfailed || video_stealthuncertain) {
+        if (check->video_stealthfailed || check->video_stealthuncertain) {
             // video failed stealth check
             color(red);
             printf("ERROR: %s appears to be invalid! AutoFix was aborted!%s", videofilename, newline);
@@ -9953,32 +11229,36 @@ int doautofix() {
           return 1;
         }
         // check to see if autofix video matches ini crc
-        if (ini_video != video_crc32) {
+        if (check->ini_video != check->video_crc32) {
             color(red);
-            printf("ERROR: %s has an incorrect CRC! (it was %08lX and should have been %08lX) AutoFix was aborted!%s", videofilename, video_crc32, ini_video, newline);
+            printf("ERROR: %s has an incorrect CRC! (it was %08lX and should have been %08lX) AutoFix was aborted!%s", videofilename, check->video_crc32, check->ini_video, newline);
             color(normal);
             fclose(videofile);
             deletestealthfile(videofilename, stealthdir, true);
           return 1;
         }
+        #ifndef WIN32
+            videoverified:
+            addtostealthstore(videofilename, stealthdir);
+        #endif
     }
     printf("%sAutomatically patching stealth files...%s", sp5, newline);
     // reopen iso file for reading and writing
-    fp = freopen(isofilename, "rb+", fp);
-    if (fp == NULL) {
+    check->fp = freopen(check->isofilename, "rb+", check->fp);
+    if (check->fp == NULL) {
         color(yellow);
-        printf("ERROR: Failed to reopen %s for writing. (%s)%s", isofilename, strerror(errno), newline);
+        printf("ERROR: Failed to reopen %s for writing. (%s)%s", check->isofilename, strerror(errno), newline);
         color(normal);
-        fp = fopen(isofilename, "rb");
-        if (fp == NULL) {
+        check->fp = fopen(check->isofilename, "rb");
+        if (check->fp == NULL) {
             color(red);
-            printf("ERROR: Failed to reopen %s for reading! (%s) Game over man... Game over!%s", isofilename, strerror(errno), newline);
+            printf("ERROR: Failed to reopen %s for reading! (%s) Game over man... Game over!%s", check->isofilename, strerror(errno), newline);
             color(normal);
           exit(1);
         }
       return 1;
     }
-    if (video == 0) {
+    if (check->video == 0) {
         // just a game partition (iso needs to be rebuilt)
         if (norebuild) {
             color(yellow);
@@ -9986,15 +11266,15 @@ int doautofix() {
             color(normal);
           return 1;
         }
-        else if (rebuildfailed) {
+        else if (check->rebuildfailed) {
             color(yellow);
             printf("ERROR: This ISO needs to be rebuilt but a previous attempt failed!%s", newline);
             color(normal);
           return 1;
         }
         fprintf(stderr, "Image is just a game partition, rebuilding... ");
-        if (rebuildiso(isofilename) != 0) {
-            rebuildfailed = true;
+        if (rebuildiso(check->isofilename) != 0) {
+            check->rebuildfailed = true;
             color(red);
             printf("Rebuilding Failed!");
             if (rebuildlowspace) printf(" Your ISO is now probably corrupt!");
@@ -10003,7 +11283,7 @@ int doautofix() {
           return 1;
         }
         else if (checkdvdfile) {
-            if (debug) printf("docheckdvdfile isofilename: %s%s", isofilename, newline);
+            if (debug) printf("docheckdvdfile isofilename: %s%s", check->isofilename, newline);
             printf("%s", newline);
             docheckdvdfile();
         }
@@ -10011,7 +11291,7 @@ int doautofix() {
     if (fixvideo) {
         // patch video
         if (verbose) printf("%sPatching Video from %s%s", sp5, videofilename, newline);
-        if (!pfi_foundsectorstotal) {
+        if (!check->pfi_foundsectorstotal) {
             // we need PFI to determine how to patch video
             // shouldn't get here though... if pfi was bad, a valid one would have had to have been checked by this function already
             color(red);
@@ -10025,63 +11305,63 @@ int doautofix() {
             fclose(videofile);
           return 1;
         }
-        if (videofilesize < pfi_sectorstotal*2048) {
+        if (videofilesize < check->pfi_sectorstotal*2048) {
             // the supplied file is not large enough based on the pfi data area size
             color(red);
             printf("ERROR: %s%s%s (%"LL"d bytes) is smaller than the PFI data area size (%"LL"d bytes) Patching was aborted!%s",
-                   quotation, videofilename, quotation, videofilesize, (long long) pfi_sectorstotal*2048, newline);
+                   quotation, videofilename, quotation, videofilesize, (long long) check->pfi_sectorstotal*2048, newline);
             color(normal);
             fclose(videofile);
           return 1;
         }
-        if (videofilesize > pfi_sectorstotal*2048) {
+        if (videofilesize > check->pfi_sectorstotal*2048) {
             // should not happen
             color(red);
             printf("ERROR: %s%s%s (%"LL"d bytes) is larger than the PFI data area size (%"LL"d bytes) Patching was aborted!%s",
-                   quotation, videofilename, quotation, videofilesize, (long long) pfi_sectorstotal*2048, newline);
+                   quotation, videofilename, quotation, videofilesize, (long long) check->pfi_sectorstotal*2048, newline);
             color(normal);
             fclose(videofile);
           return 1;
         }
         // iso size should be at least [pfi_offsetL1 + pfi_sectorsL1*2048]
-        if ((unsigned long long) fpfilesize < pfi_offsetL1 + pfi_sectorsL1*2048) {
+        if ((unsigned long long) check->fpfilesize < check->pfi_offsetL1 + check->pfi_sectorsL1*2048) {
             printf("ISO size is too small to contain the L1 Video, extending...%s", newline);
-            if (dotruncate(isofilename, fpfilesize, pfi_offsetL1 + pfi_sectorsL1*2048, false) != 0) {
+            if (dotruncate(check->isofilename, check->fpfilesize, check->pfi_offsetL1 + check->pfi_sectorsL1*2048, false) != 0) {
                 fclose(videofile);
               return 1;
             }
             // get the new filesize
-            fpfilesize = getfilesize(fp);
-            if (fpfilesize == -1) {  // seek error
+            check->fpfilesize = getfilesize(check->fp);
+            if (check->fpfilesize == -1) {  // seek error
                 fclose(videofile);
               return 1;
             }
         }
-        else if ((unsigned long long) fpfilesize > pfi_offsetL1 + pfi_sectorsL1*2048) {
+        else if ((unsigned long long) check->fpfilesize > check->pfi_offsetL1 + check->pfi_sectorsL1*2048) {
             // this really doesn't matter unless the image is too big to burn
             printf("ISO size is larger than necessary, truncating...%s", newline);
-            if (dotruncate(isofilename, fpfilesize, pfi_offsetL1 + pfi_sectorsL1*2048, false) != 0) {
+            if (dotruncate(check->isofilename, check->fpfilesize, check->pfi_offsetL1 + check->pfi_sectorsL1*2048, false) != 0) {
                 fclose(videofile);
               return 1;
             }
             // get the new filesize
-            fpfilesize = getfilesize(fp);
-            if (fpfilesize == -1) {  // seek error
+            check->fpfilesize = getfilesize(check->fp);
+            if (check->fpfilesize == -1) {  // seek error
                 fclose(videofile);
               return 1;
             }
         }
         // check that L0 data area does not overlap stealth files or game data
-        if (pfi_sectorsL0 > video/2048 - number_of_stealth_sectors - (xgd3 ? 16 : 0)) {
+        if (check->pfi_sectorsL0 > check->video/2048 - number_of_stealth_sectors - (check->xgd3 ? 16 : 0)) {
             color(yellow);
-            printf("PFI L0 Data Area is too large! (%lu sectors) Patching was aborted!%s", pfi_sectorsL0, newline);
+            printf("PFI L0 Data Area is too large! (%lu sectors) Patching was aborted!%s", check->pfi_sectorsL0, newline);
             color(normal);
             fclose(videofile);
           return 1;
         }
         // seek to the start of L0 Video and start patching
-        if (fseeko(fp, 0, SEEK_SET) != 0) {
-            printseekerror(isofilename, "Patching video file");
+        if (fseeko(check->fp, 0, SEEK_SET) != 0) {
+            printseekerror(check->isofilename, "Patching video file");
             fclose(videofile);
           return 1;
         }
@@ -10090,79 +11370,94 @@ int doautofix() {
             fclose(videofile);
           return 1;
         }
-        sizeoverbuffer = pfi_sectorsL0*2048 / BIGBUF_SIZE;
-        bufferremainder = pfi_sectorsL0*2048 % BIGBUF_SIZE;
+        check->sizeoverbuffer = check->pfi_sectorsL0*2048 / BIGBUF_SIZE;
+        check->bufferremainder = check->pfi_sectorsL0*2048 % BIGBUF_SIZE;
         initcheckread();
         initcheckwrite();
-        for (m=0; m<sizeoverbuffer; m++) {
-            if (checkreadandprinterrors(bigbuffer, 1, BIGBUF_SIZE, videofile, m, 0,
+        // the loops below only run if the video couldn't be copied without going through bigbuffer
+        i = copyfilerange(videofile, videofilename, 0, check->fp, check->isofilename, 0,
+                          (unsigned long long) check->pfi_sectorsL0*2048, "Patching L0 Video", false);
+        if (i == 1) {
+            fclose(videofile);
+          return 1;
+        }
+        if (i == 0) check->sizeoverbuffer = check->bufferremainder = 0;
+        for (m=0; m<check->sizeoverbuffer; m++) {
+            if (checkreadandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, videofile, m, 0,
                                         videofilename, "Patching L0 Video") != 0) {
                 fclose(videofile);
               return 1;
             }
-            if (checkwriteandprinterrors(bigbuffer, 1, BIGBUF_SIZE, fp, m, 0,
-                                         isofilename, "Patching L0 Video") != 0) {
+            if (checkwriteandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, check->fp, m, 0,
+                                         check->isofilename, "Patching L0 Video") != 0) {
                 fclose(videofile);
               return 1;
             }
         }
-        if (bufferremainder) {
-            if (checkreadandprinterrors(bigbuffer, 1, bufferremainder, videofile, 0, pfi_sectorsL0*2048 - bufferremainder,
+        if (check->bufferremainder) {
+            if (checkreadandprinterrors(check->bigbuffer, 1, check->bufferremainder, videofile, 0, check->pfi_sectorsL0*2048 - check->bufferremainder,
                                         videofilename, "Patching L0 Video") != 0) {
                 fclose(videofile);
               return 1;
             }
-            if (checkwriteandprinterrors(bigbuffer, 1, bufferremainder, fp, 0, pfi_sectorsL0*2048 - bufferremainder,
-                                         isofilename, "Patching L0 Video") != 0) {
+            if (checkwriteandprinterrors(check->bigbuffer, 1, check->bufferremainder, check->fp, 0, check->pfi_sectorsL0*2048 - check->bufferremainder,
+                                         check->isofilename, "Patching L0 Video") != 0) {
                 fclose(videofile);
               return 1;
             }
         }
         // seek to the start of L1 Video and continue patching
-        if (fseeko(fp, pfi_offsetL1, SEEK_SET) != 0) {
-            printseekerror(isofilename, "Patching video file");
+        if (fseeko(check->fp, check->pfi_offsetL1, SEEK_SET) != 0) {
+            printseekerror(check->isofilename, "Patching video file");
+            fclose(videofile);
+          return 1;
+        }
+        check->sizeoverbuffer = check->pfi_sectorsL1*2048 / BIGBUF_SIZE;
+        check->bufferremainder = check->pfi_sectorsL1*2048 % BIGBUF_SIZE;
+        i = copyfilerange(videofile, videofilename, (unsigned long long) check->pfi_sectorsL0*2048, check->fp, check->isofilename,
+                          check->pfi_offsetL1, (unsigned long long) check->pfi_sectorsL1*2048, "Patching L1 Video", false);
+        if (i == 1) {
             fclose(videofile);
           return 1;
         }
-        sizeoverbuffer = pfi_sectorsL1*2048 / BIGBUF_SIZE;
-        bufferremainder = pfi_sectorsL1*2048 % BIGBUF_SIZE;
-        for (m=0; m<sizeoverbuffer; m++) {
-            if (checkreadandprinterrors(bigbuffer, 1, BIGBUF_SIZE, videofile, m, pfi_sectorsL0*2048,
+        if (i == 0) check->sizeoverbuffer = check->bufferremainder = 0;
+        for (m=0; m<check->sizeoverbuffer; m++) {
+            if (checkreadandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, videofile, m, check->pfi_sectorsL0*2048,
                                         videofilename, "Patching L1 Video") != 0) {
                 fclose(videofile);
               return 1;
             }
-            if (checkwriteandprinterrors(bigbuffer, 1, BIGBUF_SIZE, fp, m, pfi_offsetL1,
-                                         isofilename, "Patching L1 Video") != 0) {
+            if (checkwriteandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, check->fp, m, check->pfi_offsetL1,
+                                         check->isofilename, "Patching L1 Video") != 0) {
                 fclose(videofile);
               return 1;
             }
         }
-        if (bufferremainder) {
-            if (checkreadandprinterrors(bigbuffer, 1, bufferremainder, videofile, 0, pfi_sectorstotal*2048 - bufferremainder,
+        if (check->bufferremainder) {
+            if (checkreadandprinterrors(check->bigbuffer, 1, check->bufferremainder, videofile, 0, check->pfi_sectorstotal*2048 - check->bufferremainder,
                                         videofilename, "Patching L1 Video") != 0) {
                 fclose(videofile);
               return 1;
             }
-            if (checkwriteandprinterrors(bigbuffer, 1, bufferremainder, fp, 0, pfi_offsetL1 + pfi_sectorsL1*2048 - bufferremainder,
-                                         isofilename, "Patching L1 Video") != 0) {
+            if (checkwriteandprinterrors(check->bigbuffer, 1, check->bufferremainder, check->fp, 0, check->pfi_offsetL1 + check->pfi_sectorsL1*2048 - check->bufferremainder,
+                                         check->isofilename, "Patching L1 Video") != 0) {
                 fclose(videofile);
               return 1;
             }
         }
         donecheckread(videofilename);
-        donecheckwrite(isofilename);
+        donecheckwrite(check->isofilename);
         fclose(videofile);
         
         // pad L0 video
-        if (pfi_sectorsL0 == video/2048 - number_of_stealth_sectors - (xgd3 ? 16 : 0)) {
+        if (check->pfi_sectorsL0 == check->video/2048 - number_of_stealth_sectors - (check->xgd3 ? 16 : 0)) {
             // there is no L0 video padding
             if (verbose) printf("Skipped padding L0 Video because there is no padding needed%s", newline);
         }
         else {
             if (verbose) printf("%sPadding L0 Video... ", sp5);
-            if (padzeros(fp, isofilename, pfi_sectorsL0*2048,
-                         (long long) video - (number_of_stealth_sectors+(xgd3 ? 16 : 0))*2048) != 0) return 1;
+            if (padzeros(check->fp, check->isofilename, check->pfi_sectorsL0*2048,
+                         (long long) check->video - (number_of_stealth_sectors+(check->xgd3 ? 16 : 0))*2048) != 0) return 1;
             if (verbose) printf("Done%s", newline);
         }
         // pad L1 video
@@ -10173,34 +11468,34 @@ int doautofix() {
             color(normal);
           return 1;
         }
-        if (pfi_offsetL1 == padding_offsetL1start) {
+        if (check->pfi_offsetL1 == padding_offsetL1start) {
             // there is no L1 video padding
             if (verbose) printf("Skipped padding L1 Video because there is no padding needed%s", newline);
         }
-        else if (pfi_offsetL1 < padding_offsetL1start) {
+        else if (check->pfi_offsetL1 < padding_offsetL1start) {
             // L1 video overlaps game data
             if (verbose) printf("Skipped padding L1 Video because there is no padding needed (PFI L1 Data Area overlaps the game partition)%s", newline);
         }
         else {
             if (verbose) printf("%sPadding L1 Video... ", sp5);
-            if (padzeros(fp, isofilename, padding_offsetL1start, pfi_offsetL1) != 0) return 1;
+            if (padzeros(check->fp, check->isofilename, padding_offsetL1start, check->pfi_offsetL1) != 0) return 1;
             if (verbose) printf("Done%s", newline);
         }
     }
     if (fixpfi) {  // patch pfi
         if (verbose) printf("%sPatching PFI from %s%s", sp5, pfifilename, newline);
-        if (trytowritestealthfile(autofix_pfi, 1, 2048, fp, isofilename, video - (xgd3 ? 0x9800 : 0x1800)) != 0) return 1;
+        if (trytowritestealthfile(autofix_pfi, 1, 2048, check->fp, check->isofilename, check->video - (check->xgd3 ? 0x9800 : 0x1800)) != 0) return 1;
     }
     if (!keepdmi) {  // patch dmi
         if (verbose) printf("%sPatching DMI from %s%s", sp5, dmifilename, newline);
-        if (trytowritestealthfile(autofix_dmi, 1, 2048, fp, isofilename, video - (xgd3 ? 0x9000 : 0x1000)) != 0) return 1;
+        if (trytowritestealthfile(autofix_dmi, 1, 2048, check->fp, check->isofilename, check->video - (check->xgd3 ? 0x9000 : 0x1000)) != 0) return 1;
     }
-    if (do_blank_ss || fixss) {  // patch ss
+    if (check->do_blank_ss || fixss) {  // patch ss
         if (verbose) printf("%sPatching SS from %s%s", sp5, ssfilename, newline);
-        if (trytowritestealthfile(ss, 1, 2048, fp, isofilename, video - (xgd3 ? 0x8800 : 0x800)) != 0) return 1;
+        if (trytowritestealthfile(check->ss, 1, 2048, check->fp, check->isofilename, check->video - (check->xgd3 ? 0x8800 : 0x800)) != 0) return 1;
         else {
-            if (ssv2) iso_has_ssv2 = true;
-            else iso_has_ssv2 = false;
+            if (check->ssv2) check->iso_has_ssv2 = true;
+            else check->iso_has_ssv2 = false;
         }
     }
     
@@ -10208,28 +11503,28 @@ int doautofix() {
     printf("Stealth files patched successfully!%s", newline);
     color(normal);
     
-    if (ini_game != 0 && game_crc32 != 0 && ini_game == game_crc32) {
+    if (check->ini_game != 0 && check->game_crc32 != 0 && check->ini_game == check->game_crc32) {
         color(green);
         printf("Game partition CRC matches the verified ini!%s", newline);
         color(normal);
     }
     else {
-        if (ini_game == 0 && !checkgamecrcnever) {
+        if (check->ini_game == 0 && !check->checkgamecrcnever) {
             color(yellow);
-            printf("ERROR: Failed to find a Game CRC in '%s', unable to verify game data!%s", inifilename, newline);
+            printf("ERROR: Failed to find a Game CRC in '%s', unable to verify game data!%s", check->inifilename, newline);
             color(normal);
           return 2;
         }
-        if (game_crc32 == 0 && !checkgamecrcnever) {
+        if (check->game_crc32 == 0 && !check->checkgamecrcnever) {
             if (docheckgamecrc() == 0) {
-                if (corruptionoffsetcount == 0) {
+                if (check->corruptionoffsetcount == 0) {
                     color(green);
                     if (verbose) printf("%s", sp5);
                     printf("AnyDVD style corruption was not detected%s", newline);
                     color(normal);
                 }
-                if (verbose) printf("%sGame CRC = %08lX%s%s", sp5, game_crc32, newline, newline);
-                if (ini_game == game_crc32) {
+                if (verbose) printf("%sGame CRC = %08lX%s%s", sp5, check->game_crc32, newline, newline);
+                if (check->ini_game == check->game_crc32) {
                     color(green);
                     printf("Game partition CRC matches the verified ini!%s", newline);
                     color(normal);
@@ -10240,18 +11535,18 @@ int doautofix() {
                 }
             }
             else {
-                checkgamecrcnever = true;
-                if (!usercancelledgamecrc) gamecrcfailed = true;
+                check->checkgamecrcnever = true;
+                if (!check->usercancelledgamecrc) check->gamecrcfailed = true;
             }
         }
-        if (game_crc32 == 0) {
-            if (usercancelledgamecrc) {
+        if (check->game_crc32 == 0) {
+            if (check->usercancelledgamecrc) {
                 // user skipped game crc
                 color(yellow);
                 printf("Stealth now matches the verified ini but checking the Game CRC was cancelled%s", newline);
                 color(normal);
             }
-            else if (gamecrcfailed) {
+            else if (check->gamecrcfailed) {
                 // there was an error checking the game crc
                 color(red);
                 printf("Stealth now matches the verified ini but an error occurred while checking the Game CRC%s", newline);
@@ -10265,7 +11560,7 @@ int doautofix() {
             }
           return 2;
         }
-        if (game_crc32 != 0 && ini_game != game_crc32) {
+        if (check->game_crc32 != 0 && check->ini_game != check->game_crc32) {
             printbadgamecrcerror();
           return 3;
         }
@@ -10542,6 +11837,13 @@ char *readstdin(char *dest, int size) {
         dest[0] = 0x0;
       return dest;
     }
+    #ifndef WIN32
+        if (batchchild) {
+            // stdin isn't ours in a batch job, so every question gets answered no
+            strncpy(dest, "n", size);
+          return dest;
+        }
+    #endif
     int readchar = 0;
     int charsread = 1;
     readchar = fgetc(stdin);
@@ -10855,7 +12157,7 @@ void makedat() {
         // next entry here (don't forget to update datentries at the top of this function)
         
         // store crc of everything at end of file
-        unsigned long datfile_crc32 = crc32(0, datfilebuffer, n);
+        unsigned long datfile_crc32 = crc32_fast(0, datfilebuffer, n);
         datfilebuffer[n] =   (unsigned char) ((datfile_crc32 & 0xFF000000) >> 24);
         datfilebuffer[n+1] = (unsigned char) ((datfile_crc32 & 0x00FF0000) >> 16);
         datfilebuffer[n+2] = (unsigned char) ((datfile_crc32 & 0x0000FF00) >> 8);
@@ -10928,7 +12230,7 @@ void checkdat() {
             remove(datpathbuffer);
           return;
         }
-        if (crc32(0, datfilebuffer, datfilesize - 4) != getuintmsb(datfilebuffer+datfilesize-4)) { // embedded crc check
+        if (crc32_fast(0, datfilebuffer, datfilesize - 4) != getuintmsb(datfilebuffer+datfilesize-4)) { // embedded crc check
             if (debug) {
                 printf("crc32 is bad for abgx360.dat, file is invalid:%s", newline);
                 hexdump(datfilebuffer, 0, datfilesize);
@@ -11370,37 +12672,37 @@ void getinivalue(char *buffer, int bufferstart, char *nameofvalue, int value, ch
 }
 
 void checkini() {
-    memset(buffer, 0, 2048);
+    memset(check->buffer, 0, 2048);
     if (!homeless) {
-        strcat(buffer, homedir);
-        strcat(buffer, abgxdir);
+        strcat(check->buffer, homedir);
+        strcat(check->buffer, abgxdir);
     }
-    strcat(buffer, "abgx360.ini");
-    FILE *inifile = fopen(buffer, "rb");
+    strcat(check->buffer, "abgx360.ini");
+    FILE *inifile = fopen(check->buffer, "rb");
     if (inifile != NULL) {
         unsigned long m = 0;
-        memset(buffer, 0, 2048);
-        while (fgets(buffer, 2048, inifile) != NULL && m < 2000) {  // 2000 lines limit
-            if      (memcmp(buffer, "web_inidir:", 11) == 0) {
-                getinivalue(buffer, 11, "webinidir",            WEB_INIDIR,           "http://abgx360.net/Apps/verified/");
+        memset(check->buffer, 0, 2048);
+        while (fgets(check->buffer, 2048, inifile) != NULL && m < 2000) {  // 2000 lines limit
+            if      (memcmp(check->buffer, "web_inidir:", 11) == 0) {
+                getinivalue(check->buffer, 11, "webinidir",            WEB_INIDIR,           "http://abgx360.net/Apps/verified/");
             }
-            else if (memcmp(buffer, "web_stealthdir:", 15) == 0) {
-                getinivalue(buffer, 15, "webstealthdir",        WEB_STEALTHDIR,       "http://abgx360.net/Apps/StealthFiles/");
+            else if (memcmp(check->buffer, "web_stealthdir:", 15) == 0) {
+                getinivalue(check->buffer, 15, "webstealthdir",        WEB_STEALTHDIR,       "http://abgx360.net/Apps/StealthFiles/");
             }
-            else if (memcmp(buffer, "web_csv:", 8) == 0) {
-                getinivalue(buffer, 8, "webcsv",                WEB_CSV,              "http://abgx360.net/Apps/Stealth360/GameNameLookup.csv");
+            else if (memcmp(check->buffer, "web_csv:", 8) == 0) {
+                getinivalue(check->buffer, 8, "webcsv",                WEB_CSV,              "http://abgx360.net/Apps/Stealth360/GameNameLookup.csv");
             }
-            else if (memcmp(buffer, "web_dat:", 8) == 0) {
-                getinivalue(buffer, 8, "webdat",                WEB_DAT,              "http://abgx360.net/Apps/Stealth360/abgx360.dat");
+            else if (memcmp(check->buffer, "web_dat:", 8) == 0) {
+                getinivalue(check->buffer, 8, "webdat",                WEB_DAT,              "http://abgx360.net/Apps/Stealth360/abgx360.dat");
             }
-            else if (memcmp(buffer, "web_topology:", 13) == 0) {
-                getinivalue(buffer, 13, "webtopology",          WEB_TOPOLOGY,         "http://abgx360.net/Apps/topology.php");
+            else if (memcmp(check->buffer, "web_topology:", 13) == 0) {
+                getinivalue(check->buffer, 13, "webtopology",          WEB_TOPOLOGY,         "http://abgx360.net/Apps/topology.php");
             }
-            else if (memcmp(buffer, "web_autoupload:", 15) == 0) {
-                getinivalue(buffer, 15, "autouploadwebaddress", WEB_AUTOUPLOAD,       "http://abgx360.net/Apps/Control/AutoUpload.php");
+            else if (memcmp(check->buffer, "web_autoupload:", 15) == 0) {
+                getinivalue(check->buffer, 15, "autouploadwebaddress", WEB_AUTOUPLOAD,       "http://abgx360.net/Apps/Control/AutoUpload.php");
             }
-            else if (memcmp(buffer, "web_unverifiedinidir:", 21) == 0) {
-                getinivalue(buffer, 21, "webunverifiedinidir",  WEB_UNVERIFIEDINIDIR, "http://abgx360.net/Apps/unverified/");
+            else if (memcmp(check->buffer, "web_unverifiedinidir:", 21) == 0) {
+                getinivalue(check->buffer, 21, "webunverifiedinidir",  WEB_UNVERIFIEDINIDIR, "http://abgx360.net/Apps/unverified/");
             }
             /*
             else if (memcmp(buffer, "web_ap25autoupload:", 19) == 0) {
@@ -11410,7 +12712,7 @@ void checkini() {
                 getinivalue(buffer, 8, "webdae",                    WEB_DAE,          "http://abgx360.net/Apps/Stealth360/dae.bin");
             }
             */
-            memset(buffer, 0, 2048);
+            memset(check->buffer, 0, 2048);
             m++;
         }
         fclose(inifile);
@@ -11420,13 +12722,27 @@ void checkini() {
 
 void checkcsv(unsigned char* mediaid) {
     int i, a, c;
-    memset(buffer, 0, 2048);
-    memset(gamename, 0, 151);
-    if (!homeless) { strcat(buffer, homedir); strcat(buffer, abgxdir); }
-    strcat(buffer, "GameNameLookup.csv");
-    csvfile = fopen(buffer, "rb");
-    if (csvfile == NULL) {
-        if (debug) printf("checkcsv - failed to open %s%s%s for reading%s", quotation, buffer, quotation, newline);
+    memset(check->buffer, 0, 2048);
+    memset(check->gamename, 0, 151);
+    if (!homeless) { strcat(check->buffer, homedir); strcat(check->buffer, abgxdir); }
+    strcat(check->buffer, "GameNameLookup.csv");
+    #ifndef WIN32
+        // look the media id up in the csv index, the csv only has to be scanned if the index can't be used
+        i = findcsvgamename(check->buffer, mediaid, check->gamename);
+        if (i == 1) return;
+        if (i == 0) {
+            if (verbose) printf("%s", newline);
+            color(white);
+            printf("%s", check->gamename);
+            check->foundgamename = true;
+            printf("%s", newline); color(normal);
+            if (!verbose || check->checkssbin || check->justastealthfile) printf("%s", newline);
+          return;
+        }
+    #endif
+    check->csvfile = fopen(check->buffer, "rb");
+    if (check->csvfile == NULL) {
+        if (debug) printf("checkcsv - failed to open %s%s%s for reading%s", quotation, check->buffer, quotation, newline);
       return;
     }
     // convert 16 byte media id into 32 byte ascii hex representation for comparison to csv values
@@ -11455,7 +12771,7 @@ void checkcsv(unsigned char* mediaid) {
     // check each line of the csv for a matching media id and print the name of the game if found
     char line[2048];
     memset(line, 0, 2048);
-    while (fgets(line, 2048, csvfile) != NULL) {
+    while (fgets(line, 2048, check->csvfile) != NULL) {
         for (i=0;i<2016;i++) {
             if (line[i] == 0x2C && memcmp(mediaidhex, line+i+1, 32) == 0) {    // 0x2C = comma
                 if (debug) {
@@ -11471,21 +12787,76 @@ void checkcsv(unsigned char* mediaid) {
                 color(white);
                 while (line[a] != 0x2C && a < 79) {
                     printf("%c", line[a]);
-                    gamename[a] = line[a];
+                    check->gamename[a] = line[a];
                     a++;
                 }
-                foundgamename = true;
+                check->foundgamename = true;
                 printf("%s", newline); color(normal);
-                if (!verbose || checkssbin || justastealthfile) printf("%s", newline);
-                fclose(csvfile);
+                if (!verbose || check->checkssbin || check->justastealthfile) printf("%s", newline);
+                fclose(check->csvfile);
               return;
             }
         }
-        memset(line, 0, 2048);
+        memset(line, 0, 2048);
+    }
+    fclose(check->csvfile);
+  return;
+}
+
+#ifndef WIN32
+int findcsvgamename(char *csvfilename, unsigned char *mediaid, char *gamename) {
+    // returns 0 if the media id was found in the csv index (gamename is filled in), 1 if it isn't in the csv, or -1 if
+    // the index can't be used and the csv has to be scanned instead
+    char filename[2048];
+    unsigned long count;
+    const struct csvindex_entry *found = NULL;
+    int c, ret = -1;
+    if (homeless) return -1;
+    snprintf(filename, sizeof(filename), "%s%s%s", homedir, abgxdir, csvindexfilename);
+    pthread_mutex_lock(&csvindexlock);
+    if (!csvindexopened) {
+        // only try once per run, if the index can't be built every check just scans the csv like before
+        csvindexopened = true;
+        if (csvindex_open(&csvindex, filename, csvfilename) != 0) {
+            if (csvindex_build(filename, csvfilename, &count) != 0) {
+                if (debug || errno != ENOENT) {
+                    color(yellow);
+                    printf("Failed to build the csv index '%s' (%s)%s", filename, strerror(errno), newline);
+                    color(normal);
+                }
+            }
+            else {
+                if (debug) printf("Rebuilt the csv index with %lu media ids from '%s'%s", count, csvfilename, newline);
+                if (csvindex_open(&csvindex, filename, csvfilename) != 0 && debug) printf("The csv index is already out of date%s", newline);
+            }
+        }
     }
-    fclose(csvfile);
+    if (csvindex.map != NULL) {
+        found = csvindex_find(&csvindex, mediaid);
+        if (found != NULL) {
+            strcpy(gamename, found->name);
+            ret = 0;
+        }
+        else ret = 1;
+    }
+    pthread_mutex_unlock(&csvindexlock);
+    if (debug && ret != -1) {
+        printf("checkcsv - media id ");
+        for (c=0;c<16;c++) printf("%02X", mediaid[c]);
+        printf(" was %sfound in the csv index%s", found == NULL ? "not " : "", newline);
+    }
+  return ret;
+}
+
+void invalidatecsvindex() {
+    // GameNameLookup.csv was updated, the index will be rebuilt the next time it's needed
+    pthread_mutex_lock(&csvindexlock);
+    csvindex_close(&csvindex);
+    csvindexopened = false;
+    pthread_mutex_unlock(&csvindexlock);
   return;
 }
+#endif
 
 void printwin32filetime(unsigned long long win32filetime) {
     int month, leap, year = 1601;
@@ -11586,13 +12957,13 @@ void printunixfiletime(unsigned long seconds) {
 
 void printwtfhexcolor() {
     color(wtfhexcolor);
-    wtfhex = true;
+    check->wtfhex = true;
   return;
 }
 
 void printwtfcharcolor() {
     color(wtfcharcolor);
-    wtfhex = true;
+    check->wtfhex = true;
   return;
 }
 
@@ -11657,9 +13028,9 @@ void hexdump(unsigned char* ptr, int stealthtype, int bytes) {
                     if (foundusbcorruption && c >= 0x7FC) printwtfhexcolor();
                 }
                 printf("%02X ", ptr[c]);
-                if (wtfhex) {
+                if (check->wtfhex) {
                     color(normal);
-                    wtfhex = false;
+                    check->wtfhex = false;
                 }
             }  
             // print them again in ascii
@@ -11693,9 +13064,9 @@ void hexdump(unsigned char* ptr, int stealthtype, int bytes) {
                     if (html) printf("&#%d;", ptr[c]);
                     else printf("%c", ptr[c]);
                 }
-                if (wtfhex) {
+                if (check->wtfhex) {
                     color(normal);
-                    wtfhex = false;
+                    check->wtfhex = false;
                 }
             }
         }
@@ -11754,59 +13125,59 @@ int checkgame() {
     unsigned long long rootsector, rootaddress, defaultxexaddress, defaultxexsector = 0;
     if (verbose) printf("Checking Game%s", newline);
     // seek to sector 32 of the game partition and read it into ubuffer
-    if (fseeko(fp, 32*2048+video, SEEK_SET) != 0) {
-        printseekerror(isofilename, "Checking sector 32");
+    if (fseeko(check->fp, 32*2048+check->video, SEEK_SET) != 0) {
+        printseekerror(check->isofilename, "Checking sector 32");
       return 1;
     }
-    memset(ubuffer, 0, 2048);
+    memset(check->ubuffer, 0, 2048);
     initcheckread();
-    if (checkreadandprinterrors(ubuffer, 1, 2048, fp, 0, 32*2048+video, isofilename, "Checking sector 32") != 0) return 1;
-    donecheckread(isofilename);
+    if (checkreadandprinterrors(check->ubuffer, 1, 2048, check->fp, 0, 32*2048+check->video, check->isofilename, "Checking sector 32") != 0) return 1;
+    donecheckread(check->isofilename);
     // get the location and size of the rootsector
-    rootsector = getuint(ubuffer+20);
-    rootaddress = rootsector*2048+video;
-    rootsize = getuint(ubuffer+24);
+    rootsector = getuint(check->ubuffer+20);
+    rootaddress = rootsector*2048+check->video;
+    rootsize = getuint(check->ubuffer+24);
     // show the input file/drive name and size if verbose, and show the layerbreak if it's a dvd
-    if (verbose || L0capacity != -1) {
-        if (verbose) printf("%sISO: %s%s%s%s", sp5, quotation, isofilename, quotation, newline);
-        if (L0capacity != -1) {
-            if (L0capacity == 0) {
+    if (verbose || check->L0capacity != -1) {
+        if (verbose) printf("%sISO: %s%s%s%s", sp5, quotation, check->isofilename, quotation, newline);
+        if (check->L0capacity != -1) {
+            if (check->L0capacity == 0) {
                 color(yellow);
                 if (verbose) printf("%s", sp5);
                 printf("Layerbreak: Unknown%s", newline);
             }
             else {
-                if (L0capacity == layerbreak) color(green);
-                else if (L0capacity == 2086912 && layerbreak == 2133520) color(yellow);
+                if (check->L0capacity == check->layerbreak) color(green);
+                else if (check->L0capacity == 2086912 && check->layerbreak == 2133520) color(yellow);
                 else color(red);
                 if (verbose) printf("%s", sp5);
-                printf("Layerbreak: %"LL"d", L0capacity);
-                if (L0capacity != layerbreak) printf(" (should have been %ld)", layerbreak);
+                printf("Layerbreak: %"LL"d", check->L0capacity);
+                if (check->L0capacity != check->layerbreak) printf(" (should have been %ld)", check->layerbreak);
                 printf("%s", newline);
             }
             color(normal);
         }
-        if (verbose) printf("%sSize: %"LL"d bytes", sp5, fpfilesize);
+        if (verbose) printf("%sSize: %"LL"d bytes", sp5, check->fpfilesize);
     }
     // make sure the input filesize isn't too small -- we'll use isotoosmall to abort rebuilding and checking the game crc
-    if (video != 0 && (fpfilesize < (xgd3 ? 8662351872LL : 7307001856LL) + (long long) video)) {
+    if (check->video != 0 && (check->fpfilesize < (check->xgd3 ? 8662351872LL : 7307001856LL) + (long long) check->video)) {
         color(red);
         if (verbose) printf(" (filesize too small!)%s", newline);
         printf("Warning: This ISO is short %"LL"d bytes! Part of the game data is missing!%s"
                "%s(should have been at least %"LL"d bytes)%s",
-               (xgd3 ? 8662351872LL : 7307001856LL) + video - fpfilesize, newline, sp9, (xgd3 ? 8662351872LL : 7307001856LL) + video, newline);
+               (check->xgd3 ? 8662351872LL : 7307001856LL) + check->video - check->fpfilesize, newline, sp9, (check->xgd3 ? 8662351872LL : 7307001856LL) + check->video, newline);
         color(normal);
-        isotoosmall = true;
+        check->isotoosmall = true;
     }
     else if (verbose) printf("%s", newline);
-    else if (isotoosmall) printf("%s", newline);
+    else if (check->isotoosmall) printf("%s", newline);
     if (extraverbose) {
-        printf("%sGame partition offset: 0x%"LL"X%s", sp5, video, newline);
+        printf("%sGame partition offset: 0x%"LL"X%s", sp5, check->video, newline);
         printf("%sRoot sector: %"LL"u (0x%"LL"X), %lu bytes%s", sp5, rootsector, rootaddress, rootsize, newline);
     }
     // seek to the rootsector
-    if (fseeko(fp, rootaddress, SEEK_SET) != 0) {
-        printseekerror(isofilename, "Checking the root sector");
+    if (fseeko(check->fp, rootaddress, SEEK_SET) != 0) {
+        printseekerror(check->isofilename, "Checking the root sector");
       return 1;
     }
     // create a buffer for the rootsector with the correct size (max 5000 sectors)
@@ -11832,16 +13203,16 @@ int checkgame() {
     }
     // read the rootsector into the buffer
     initcheckread();
-    if (checkreadandprinterrors(rootbuffer, 1, rootsize, fp, 0, rootaddress, isofilename, "Checking the root sector") != 0) {
+    if (checkreadandprinterrors(rootbuffer, 1, rootsize, check->fp, 0, rootaddress, check->isofilename, "Checking the root sector") != 0) {
         free(rootbuffer);
       return 1;
     }
-    donecheckread(isofilename);
+    donecheckread(check->isofilename);
     if (debug) {
         printf("1st sector of rootsector:%s", newline);
         hexdump((unsigned char*) rootbuffer, 0, 2048);
     }
-    if (getzeros((unsigned char*) rootbuffer, 0, rootsize - 1) == rootsize) {
+    if (zeroscan_allzeros((unsigned char*) rootbuffer, rootsize)) {
         color(red);
         printf("ERROR: The root sector is blank!%s", newline);
         color(normal);
@@ -11866,7 +13237,7 @@ int checkgame() {
         color(normal);
       return 1;
     }
-    defaultxexaddress = defaultxexsector * 2048 + video;
+    defaultxexaddress = defaultxexsector * 2048 + check->video;
     if (extraverbose) printf("%sdefault.xex sector: %"LL"u (0x%"LL"X), %lu bytes%s",
                               sp5, defaultxexsector, defaultxexaddress, defaultxexsize, newline);
     if (!dontparsefs) {
@@ -11881,210 +13252,210 @@ int checkgame() {
             color(normal);
           goto skipparsingfs;
         }
-        bufferlevels = MIN_DIR_LEVELS;
-        buffermaxdir = converttosectors(rootsize) > MIN_DIR_SECTORS ? converttosectors(rootsize) : MIN_DIR_SECTORS;
-        fsbuffer = (char *) calloc(bufferlevels*buffermaxdir*2048, sizeof(char));
-        if (fsbuffer == NULL) {
+        check->bufferlevels = MIN_DIR_LEVELS;
+        check->buffermaxdir = converttosectors(rootsize) > MIN_DIR_SECTORS ? converttosectors(rootsize) : MIN_DIR_SECTORS;
+        check->fsbuffer = (char *) calloc(check->bufferlevels*check->buffermaxdir*2048, sizeof(char));
+        if (check->fsbuffer == NULL) {
             color(red);
             printf("ERROR: Memory allocation for fsbuffer failed! Game over man... Game over!%s", newline);
             color(normal);
           exit(1);
         }
-        memset(dirprefix, 0, 2048);
+        memset(check->dirprefix, 0, 2048);
         // read rootsector into fsbuffer
-        if (readblock(isofilename, "Parsing filesystem and checking random padding", fp, rootsector, (unsigned char*) fsbuffer, converttosectors(rootsize))) {
-            free(fsbuffer);
+        if (readblock(check->isofilename, "Parsing filesystem and checking random padding", check->fp, rootsector, (unsigned char*) check->fsbuffer, converttosectors(rootsize))) {
+            free(check->fsbuffer);
           goto skipparsingfs;
         }
         while (1) {
             // see if filesystem can be parsed with current buffer size or if it needs to be increased (don't display files)
-            if (parse(isofilename, "Parsing filesystem and checking random padding", 0, 0, 0, fp, true, false, dirprefix) == 2) {
+            if (parse(check->isofilename, "Parsing filesystem and checking random padding", 0, 0, 0, check->fp, true, false, check->dirprefix) == 2) {
                 if (debugfs) {
                     color(yellow);
-                    printf("parse returned 2: buffermaxdir=%d, bufferlevels=%d%s", buffermaxdir, bufferlevels, newline);
+                    printf("parse returned 2: buffermaxdir=%d, bufferlevels=%d%s", check->buffermaxdir, check->bufferlevels, newline);
                     color(normal);
                 }
-                if (buffermaxdir > MAX_DIR_SECTORS) {
-                    parsingfsfailed = true;
+                if (check->buffermaxdir > MAX_DIR_SECTORS) {
+                    check->parsingfsfailed = true;
                     if (verbose) printf("%s", sp5);
                     color(yellow);
                     printf("Unable to parse filesystem because a directory is %d sectors long!%s"
-                           "Unable to check random padding!%s", buffermaxdir, newline, newline);
+                           "Unable to check random padding!%s", check->buffermaxdir, newline, newline);
                     if (debug) printf("MAX_DIR_SECTORS = %d%s", MAX_DIR_SECTORS, newline);
                     color(normal);
                   break;
                 }
-                if (bufferlevels >= MAX_DIR_LEVELS) {
-                    parsingfsfailed = true;
+                if (check->bufferlevels >= MAX_DIR_LEVELS) {
+                    check->parsingfsfailed = true;
                     if (verbose) printf("%s", sp5);
                     color(yellow);
                     printf("Unable to parse filesystem because a directory is %d levels deep!%s"
-                           "Unable to check random padding!%s", bufferlevels, newline, newline);
+                           "Unable to check random padding!%s", check->bufferlevels, newline, newline);
                     if (debug) printf("MAX_DIR_LEVELS = %d%s", MAX_DIR_LEVELS, newline);
                     color(normal);
                   break;
                 }
-                fsbuffer = realloc(fsbuffer, bufferlevels*buffermaxdir*2048*sizeof(char));
-                if (fsbuffer == NULL) {
+                check->fsbuffer = realloc(check->fsbuffer, check->bufferlevels*check->buffermaxdir*2048*sizeof(char));
+                if (check->fsbuffer == NULL) {
                     color(red);
                     printf("ERROR: Memory reallocation for fsbuffer failed! Game over man... Game over!%s", newline);
                     color(normal);
                   exit(1);
                 }
-                totalfiles = 0;
-                totaldirectories = 0;
-                totalbytes = 0;
-                memset(fsbuffer, 0, bufferlevels*buffermaxdir*2048);
-                memset(dirprefix, 0, 2048);
+                check->totalfiles = 0;
+                check->totaldirectories = 0;
+                check->totalbytes = 0;
+                memset(check->fsbuffer, 0, check->bufferlevels*check->buffermaxdir*2048);
+                memset(check->dirprefix, 0, 2048);
                 // read rootsector again
-                if (readblock(isofilename, "Parsing filesystem and checking random padding", fp, rootsector,
-                              (unsigned char*) fsbuffer, converttosectors(rootsize))) {
-                    free(fsbuffer);
+                if (readblock(check->isofilename, "Parsing filesystem and checking random padding", check->fp, rootsector,
+                              (unsigned char*) check->fsbuffer, converttosectors(rootsize))) {
+                    free(check->fsbuffer);
                     goto skipparsingfs;
                 }
             }
             else break;
         }
-        if (showfiles && !parsingfsfailed) {
-            totalfiles = 0;
-            totaldirectories = 0;
-            totalbytes = 0;
+        if (showfiles && !check->parsingfsfailed) {
+            check->totalfiles = 0;
+            check->totaldirectories = 0;
+            check->totalbytes = 0;
             color(blue);
             printf("%sDisplaying Filesystem%s", sp5, newline);
             printf("%sSector %s Bytes %s Filename%s", sp5, sp7, sp1, newline);
             printf("%s--------------------------------------------------------------------------%s", sp5, newline);
             // display files
-            parse(isofilename, "Parsing filesystem", 0, 0, 0, fp, false, false, dirprefix);
+            parse(check->isofilename, "Parsing filesystem", 0, 0, 0, check->fp, false, false, check->dirprefix);
             printf("%s--------------------------------------------------------------------------%s", sp5, newline);
             color(normal);
         }
-        if (verbose && !parsingfsfailed) {
-            printf("%sFiles in ISO: %lu, Folders in ISO: %lu%s", sp5, totalfiles, totaldirectories, newline);
+        if (verbose && !check->parsingfsfailed) {
+            printf("%sFiles in ISO: %lu, Folders in ISO: %lu%s", sp5, check->totalfiles, check->totaldirectories, newline);
             // Note: the percentage of total bytes used will be incorrect if this is just an xgd3 game partition (video == 0)
             // we would have to check the xex first for the disc profile id to determine if this is an xgd3 game...
             // but it's not really important since this is just superfluous information
-            printf("%sTotal bytes used: %"LL"u (%.2f%%)%s", sp5, totalbytes, (double) totalbytes/(xgd3 ? 86623477.76 : 72986091.52), newline);
+            printf("%sTotal bytes used: %"LL"u (%.2f%%)%s", sp5, check->totalbytes, (double) check->totalbytes/(check->xgd3 ? 86623477.76 : 72986091.52), newline);
         }
-        if (!parsingfsfailed) {
+        if (!check->parsingfsfailed) {
             // check for random padding
             bool randompadding = false;
             int sectorschecked = 0;
             unsigned long holecount = 0L;
             // struct filesys { unsigned long datasector, datalength; } *filesystem, *holes;
-            filesystem = calloc(totalfiles + totaldirectories + 4, sizeof(struct filesys));
-            if (filesystem != NULL) {
-                totalfiles = 0;
-                totaldirectories = 0;
-                totalbytes = 0;
-                memset(fsbuffer, 0, bufferlevels*buffermaxdir*2048);
-                memset(dirprefix, 0, 2048);
-                if (readblock(isofilename, "Parsing filesystem and checking random padding", fp, rootsector,
-                              (unsigned char*) fsbuffer, converttosectors(rootsize))) {
-                    free(fsbuffer);
+            check->filesystem = calloc(check->totalfiles + check->totaldirectories + 4, sizeof(struct filesys));
+            if (check->filesystem != NULL) {
+                check->totalfiles = 0;
+                check->totaldirectories = 0;
+                check->totalbytes = 0;
+                memset(check->fsbuffer, 0, check->bufferlevels*check->buffermaxdir*2048);
+                memset(check->dirprefix, 0, 2048);
+                if (readblock(check->isofilename, "Parsing filesystem and checking random padding", check->fp, rootsector,
+                              (unsigned char*) check->fsbuffer, converttosectors(rootsize))) {
+                    free(check->fsbuffer);
                   goto skipparsingfs;
                 }
                 // dont' display files but add to filesystem structure
-                parse(isofilename, "Parsing filesystem and checking random padding", 0, 0, 0, fp, true, true, dirprefix);
+                parse(check->isofilename, "Parsing filesystem and checking random padding", 0, 0, 0, check->fp, true, true, check->dirprefix);
                 // add data sectors that aren't specified by the filesystem
                 // sector 32 has data (it tells us where the rootsector is)
-                filesystem[totalfiles + totaldirectories].datasector = 32L;
-                filesystem[totalfiles + totaldirectories].datalength = 1L;
+                check->filesystem[check->totalfiles + check->totaldirectories].datasector = 32L;
+                check->filesystem[check->totalfiles + check->totaldirectories].datalength = 1L;
                 // don't forget to add the rootsector
-                filesystem[totalfiles + totaldirectories + 1].datasector = rootsector;
-                filesystem[totalfiles + totaldirectories + 1].datalength = converttosectors(rootsize);
+                check->filesystem[check->totalfiles + check->totaldirectories + 1].datasector = rootsector;
+                check->filesystem[check->totalfiles + check->totaldirectories + 1].datalength = converttosectors(rootsize);
                 // add the very last sector that only exists if the image has L1 video (doesn't matter, this is just for hole calculation)
                 // Note: the latter (3567872L) will incorrectly be used if this is just an xgd3 game partition (video == 0)
                 // we would have to check the xex first for the disc profile id to determine if this is an xgd3 game...
                 // but it's not really important since there should still be holes available to check
-                filesystem[totalfiles + totaldirectories + 2].datasector = (xgd3 ? 4229664L : 3567872L);
-                filesystem[totalfiles + totaldirectories + 2].datalength = 0L;
-                if (!xgd3) {
+                check->filesystem[check->totalfiles + check->totaldirectories + 2].datasector = (check->xgd3 ? 4229664L : 3567872L);
+                check->filesystem[check->totalfiles + check->totaldirectories + 2].datalength = 0L;
+                if (!check->xgd3) {
                     // XGD2 sectors 48 - 4143 are reserved for storage of data hashes used by the kernel during disc authentication
                     // Note: this will incorrectly be added if this is just an xgd3 game partition (video == 0)
                     // we would have to check the xex first for the disc profile id to determine if this is an xgd3 game...
                     // but it's not really important since there should still be holes available to check
-                    filesystem[totalfiles + totaldirectories + 3].datasector = 48L;
-                    filesystem[totalfiles + totaldirectories + 3].datalength = 4096L;
+                    check->filesystem[check->totalfiles + check->totaldirectories + 3].datasector = 48L;
+                    check->filesystem[check->totalfiles + check->totaldirectories + 3].datalength = 4096L;
                 }
                 if (debugfs) {
                     printf("filesystem:%s", newline);
-                    for (m=0;m<totalfiles + totaldirectories + (xgd3 ? 3 : 4);m++) {
-                        printf("%lu: %lu, %lu%s", m, filesystem[m].datasector, filesystem[m].datalength, newline);
+                    for (m=0;m<check->totalfiles + check->totaldirectories + (check->xgd3 ? 3 : 4);m++) {
+                        printf("%lu: %lu, %lu%s", m, check->filesystem[m].datasector, check->filesystem[m].datalength, newline);
                     }
                 }
                 // sort datasectors
-                qsort(filesystem, totalfiles + totaldirectories + (xgd3 ? 3 : 4), sizeof(struct filesys), compfilesys);
+                qsort(check->filesystem, check->totalfiles + check->totaldirectories + (check->xgd3 ? 3 : 4), sizeof(struct filesys), compfilesys);
                 if (debugfs) {
                     printf("filesystem (sorted):%s", newline);
-                    for (m=0;m<totalfiles + totaldirectories + (xgd3 ? 3 : 4);m++) {
-                        printf("%lu: %lu, %lu%s", m, filesystem[m].datasector, filesystem[m].datalength, newline);
+                    for (m=0;m<check->totalfiles + check->totaldirectories + (check->xgd3 ? 3 : 4);m++) {
+                        printf("%lu: %lu, %lu%s", m, check->filesystem[m].datasector, check->filesystem[m].datalength, newline);
                     }
                 }
-                holes = calloc(totalfiles + totaldirectories + (xgd3 ? 3 : 4), sizeof(struct filesys));
-                if (holes != NULL) {
+                check->holes = calloc(check->totalfiles + check->totaldirectories + (check->xgd3 ? 3 : 4), sizeof(struct filesys));
+                if (check->holes != NULL) {
                     unsigned long holesector = 0L;
-                    for (m=0;m<totalfiles + totaldirectories + (xgd3 ? 3 : 4);m++) {
-                        if (filesystem[m].datasector > holesector) {
-                            holes[holecount].datasector = holesector;
-                            holes[holecount].datalength = filesystem[m].datasector - holesector;
+                    for (m=0;m<check->totalfiles + check->totaldirectories + (check->xgd3 ? 3 : 4);m++) {
+                        if (check->filesystem[m].datasector > holesector) {
+                            check->holes[holecount].datasector = holesector;
+                            check->holes[holecount].datalength = check->filesystem[m].datasector - holesector;
                             holecount++;
                         }
-                        holesector = filesystem[m].datasector + filesystem[m].datalength;
+                        holesector = check->filesystem[m].datasector + check->filesystem[m].datalength;
                     }
                     if (debugfs) {
                         printf("holes:%s", newline);
                         for (m=0;m<holecount;m++) printf("%3lu: %7lu, %7lu, 0x%09"LL"X - 0x%09"LL"X%s",
-                                                         m, holes[m].datasector, holes[m].datalength,
-                                                         (unsigned long long) holes[m].datasector * 2048 + video,
-                                                         (unsigned long long) (holes[m].datasector + holes[m].datalength) * 2048 + video - 1,
+                                                         m, check->holes[m].datasector, check->holes[m].datalength,
+                                                         (unsigned long long) check->holes[m].datasector * 2048 + check->video,
+                                                         (unsigned long long) (check->holes[m].datasector + check->holes[m].datalength) * 2048 + check->video - 1,
                                                          newline);
                     }
                     // search the first and last sector of all holes up to a maximum of 20 holes for random padding
                     for (m=0;m<(holecount <= 20 ? holecount : 20);m++) {
-                        if (fseeko(fp, (unsigned long long) holes[m].datasector * 2048 + video, SEEK_SET) != 0) {
-                            printseekerror(isofilename, "Random padding check");
+                        if (fseeko(check->fp, (unsigned long long) check->holes[m].datasector * 2048 + check->video, SEEK_SET) != 0) {
+                            printseekerror(check->isofilename, "Random padding check");
                           break;
                         }
                         initcheckread();
-                        if (checkreadandprinterrors(ubuffer, 1, 2048, fp, 0, (unsigned long long) holes[m].datasector * 2048 + video,
-                                                    isofilename, "Random padding check") != 0) break;
-                        donecheckread(isofilename);
+                        if (checkreadandprinterrors(check->ubuffer, 1, 2048, check->fp, 0, (unsigned long long) check->holes[m].datasector * 2048 + check->video,
+                                                    check->isofilename, "Random padding check") != 0) break;
+                        donecheckread(check->isofilename);
                         sectorschecked++;
                         if (debugfs) {
                             printf("first hole sector (0x%"LL"X, %lu zeros):%s",
-                                    (unsigned long long) holes[m].datasector * 2048 + video, getzeros(ubuffer, 0, 2047), newline);
-                            hexdump(ubuffer, 0, 2048);
+                                    (unsigned long long) check->holes[m].datasector * 2048 + check->video, getzeros(check->ubuffer, 0, 2047), newline);
+                            hexdump(check->ubuffer, 0, 2048);
                         }
-                        if (getzeros(ubuffer, 0, 2047) != 2048) {
+                        if (!zeroscan_allzeros(check->ubuffer, 2048)) {
                             randompadding = true;
                           break;
                         }
                         
-                        if (holes[m].datalength > 1) {
-                            if (fseeko(fp, (unsigned long long)
-                                       (holes[m].datasector + holes[m].datalength - 1) * 2048 + video, SEEK_SET) != 0) {
-                                printseekerror(isofilename, "Random padding check");
+                        if (check->holes[m].datalength > 1) {
+                            if (fseeko(check->fp, (unsigned long long)
+                                       (check->holes[m].datasector + check->holes[m].datalength - 1) * 2048 + check->video, SEEK_SET) != 0) {
+                                printseekerror(check->isofilename, "Random padding check");
                               break;
                             }
                             initcheckread();
-                            if (checkreadandprinterrors(ubuffer, 1, 2048, fp, 0, (unsigned long long)
-                                                        (holes[m].datasector + holes[m].datalength - 1) * 2048 + video,
-                                                        isofilename, "Random padding check") != 0) break;
-                            donecheckread(isofilename);
+                            if (checkreadandprinterrors(check->ubuffer, 1, 2048, check->fp, 0, (unsigned long long)
+                                                        (check->holes[m].datasector + check->holes[m].datalength - 1) * 2048 + check->video,
+                                                        check->isofilename, "Random padding check") != 0) break;
+                            donecheckread(check->isofilename);
                             sectorschecked++;
                             if (debugfs) {
                                 printf("last hole sector (0x%"LL"X, %lu zeros):%s", (unsigned long long)
-                                        (holes[m].datasector + holes[m].datalength - 1) * 2048 + video,
-                                        getzeros(ubuffer, 0, 2047), newline);
-                                hexdump(ubuffer, 0, 2048);
+                                        (check->holes[m].datasector + check->holes[m].datalength - 1) * 2048 + check->video,
+                                        getzeros(check->ubuffer, 0, 2047), newline);
+                                hexdump(check->ubuffer, 0, 2048);
                             }
-                            if (getzeros(ubuffer, 0, 2047) != 2048) {
+                            if (!zeroscan_allzeros(check->ubuffer, 2048)) {
                                 randompadding = true;
                               break;
                             }
                         }
                     }
-                    free(holes);
+                    free(check->holes);
                 }
                 else {
                     color(red);
@@ -12092,7 +13463,7 @@ int checkgame() {
                     color(normal);
                   exit(1);
                 }
-                free(filesystem);
+                free(check->filesystem);
             }
             else {
                 color(red);
@@ -12117,16 +13488,15 @@ int checkgame() {
                 if (!verbose) printf("%s", newline);
             }
         }
-        free(fsbuffer);
+        free(check->fsbuffer);
     }
     skipparsingfs:
     if (verbose) printf("%s", newline);
     // seek to the default.xex
-    if (fseeko(fp, defaultxexaddress, SEEK_SET) != 0) {
-        printseekerror(isofilename, "Checking the default.xex");
+    if (fseeko(check->fp, defaultxexaddress, SEEK_SET) != 0) {
+        printseekerror(check->isofilename, "Checking the default.xex");
       return 1;
     }
-    // allocate a buffer for it
     if (defaultxexsize < 24) {
         // definitely way too small
         color(red);
@@ -12134,69 +13504,45 @@ int checkgame() {
         color(normal);
       return 1;
     }
-    if (defaultxexsize > WOW_THATS_A_LOT_OF_RAM) {
-        if (debug) {
-            color(yellow);
-            printf("defaultxexsize (%lu) is a lot of ram!%s", defaultxexsize, newline);
-            color(normal);
-        }
-        fprintf(stderr, "Warning: Checking the default.xex will require %.1f MBs of RAM...\n", (float) defaultxexsize/1048576);
-        char response[4];
-        memset(response, 0, 4);
-        while (response[0] != 'y' && response[0] != 'n' && response[0] != 'Y' && response[0] != 'N') {
-            fprintf(stderr, "Do you want to continue? (y/n) ");
-            readstdin(response, 4);
-            if (debug) printf("response[0] = %c (0x%02X)%s", response[0], response[0], newline);
-        }
-        if (response[0] == 'n' || response[0] == 'N') {
-            printf("default.xex check was aborted as requested%s", newline);
-          return 1;
-        }
-    }
-    unsigned char *defaultxexbuffer = malloc(defaultxexsize * sizeof(char));
-    if (defaultxexbuffer == NULL) {
-        color(red);
-        printf("ERROR: Memory allocation for defaultxexbuffer failed! Game over man... Game over!%s", newline);
-        color(normal);
-      exit(1);
-    }
-    // read the default.xex into the buffer (already seeked to it)
+    // look for XEX magic bytes in the 1st sector (already seeked to it)
     initcheckread();
-    if (checkreadandprinterrors(defaultxexbuffer, 1, defaultxexsize, fp, 0, defaultxexaddress,
-                                isofilename, "Checking the default.xex") != 0) {
-        free(defaultxexbuffer);
+    memset(check->ubuffer, 0, 2048);
+    if (checkreadandprinterrors(check->ubuffer, 1, defaultxexsize < 2048 ? defaultxexsize : 2048, check->fp, 0, defaultxexaddress,
+                                check->isofilename, "Checking the default.xex") != 0) {
       return 1;
     }
-    donecheckread(isofilename);
     if (debug) {
         printf("default.xex 1st sector:%s", newline);
-        hexdump(defaultxexbuffer, 0, 2048);
+        hexdump(check->ubuffer, 0, 2048);
     }
-    // look for XEX magic bytes
-    if (memcmp(defaultxexbuffer, "XEX2", 4) != 0) {
+    if (memcmp(check->ubuffer, "XEX2", 4) != 0) {
         color(red);
         printf("ERROR: %sXEX2%s magic was not found at the start of default.xex!%s", quotation, quotation, newline);
         color(normal);
-        free(defaultxexbuffer);
       return 1;
     }
+    // only the header is read in here, checkdefaultxex() reads the rest a window at a time
+    unsigned char *defaultxexbuffer = readxexheader(check->ubuffer, defaultxexsize, check->fp, defaultxexaddress,
+                                                    check->isofilename, "Checking the default.xex");
+    if (defaultxexbuffer == NULL) return 1;
     // check the default.xex
     if (verbose) printf("Checking default.xex%s", newline);
-    if (checkdefaultxex(defaultxexbuffer, defaultxexsize) != 0) {
+    if (checkdefaultxex(defaultxexbuffer, defaultxexsize, check->fp, defaultxexaddress,
+                        check->isofilename, "Checking the default.xex") != 0) {
         free(defaultxexbuffer);
       return 1;
     }
     free(defaultxexbuffer);
     // had to copy this to after the xex is checked since we need to check for the existence of the
     // disc profile id if there is no video partition in order to determine if this is an xgd3 game
-    if (video == 0) {  // just a game partition
-        if (fpfilesize < (xgd3 ? 8662351872LL : 7307001856LL)) {
+    if (check->video == 0) {  // just a game partition
+        if (check->fpfilesize < (check->xgd3 ? 8662351872LL : 7307001856LL)) {
             color(red);
             printf("%sWarning: This ISO is short %"LL"d bytes! Part of the game data is missing!%s"
                    "%s(should have been exactly %"LL"d bytes)%s", newline,
-                   (xgd3 ? 8662351872LL : 7307001856LL) - fpfilesize, newline, sp9, (xgd3 ? 8662351872LL : 7307001856LL), newline);
+                   (check->xgd3 ? 8662351872LL : 7307001856LL) - check->fpfilesize, newline, sp9, (check->xgd3 ? 8662351872LL : 7307001856LL), newline);
             color(normal);
-            isotoosmall = true;
+            check->isotoosmall = true;
         }
     }
   return 0;
@@ -13268,13 +14614,13 @@ void parsetitleidresource(unsigned char *resourcebuffer, unsigned long resources
                 }
                 else {
                     resource.titletype = getuintmsb(resourcebuffer+resource.XTHD_offset+16);
-                    if (!foundtitleid) {
+                    if (!check->foundtitleid) {
                         // this should only happen when checking a .spa file because checkdefaultxex() would have had to find a title id before getting to the point where it could call this function
-                        memcpy(titleid, resourcebuffer+resource.XTHD_offset+12, 4);
-                        foundtitleid = true;
-                        if (debug || testing) printf("missing titleid was replaced with XTHD titleid: %02X%02X%02X%02X%s", titleid[0], titleid[1], titleid[2], titleid[3], newline);
+                        memcpy(check->titleid, resourcebuffer+resource.XTHD_offset+12, 4);
+                        check->foundtitleid = true;
+                        if (debug || testing) printf("missing titleid was replaced with XTHD titleid: %02X%02X%02X%02X%s", check->titleid[0], check->titleid[1], check->titleid[2], check->titleid[3], newline);
                     }
-                    else if (debug || testing) printf("this titleid was already found and will be used: %02X%02X%02X%02X%s", titleid[0], titleid[1], titleid[2], titleid[3], newline);
+                    else if (debug || testing) printf("this titleid was already found and will be used: %02X%02X%02X%02X%s", check->titleid[0], check->titleid[1], check->titleid[2], check->titleid[3], newline);
                     if (debug || testing) printf("found XTHD: titleid: %02X%02X%02X%02X (%c%c-%u), titletype: %lu%s", resourcebuffer[resource.XTHD_offset+12], resourcebuffer[resource.XTHD_offset+13],
                                                   resourcebuffer[resource.XTHD_offset+14], resourcebuffer[resource.XTHD_offset+15], resourcebuffer[resource.XTHD_offset+12],
                                                   resourcebuffer[resource.XTHD_offset+13], getwordmsb(resourcebuffer+resource.XTHD_offset+14), resource.titletype, newline);
@@ -13348,21 +14694,21 @@ void parsetitleidresource(unsigned char *resourcebuffer, unsigned long resources
     }
     char imagedirpath[2048] = {0};
     struct imagestruct embedable_images[resource.num_images];
-    if (extractimages) {
+    if (check->extractimages) {
         if (imagedirmissing || homeless) {
             color(yellow);
             printf("ERROR: Unable to extract images because the Image directory is missing or can't be found%s", newline);
             color(normal);
-            extractimages = false;
+            check->extractimages = false;
         }
-        else if (!foundtitleid) {
+        else if (!check->foundtitleid) {
             color(yellow);
             printf("ERROR: Unable to extract images because the Title ID was not found%s", newline);
             color(normal);
-            extractimages = false;
+            check->extractimages = false;
         }
         else if (resource.num_images) {
-            if (embedimages) {
+            if (check->embedimages) {
                 x = 0;
                 if (showachievements) x = resource.num_achievements;
                 if (showavatarawards) x += resource.num_avatarawards;
@@ -13371,7 +14717,7 @@ void parsetitleidresource(unsigned char *resourcebuffer, unsigned long resources
                     color(yellow);
                     printf("ERROR: Unwilling to embed images because there are over 500 achievements/avatar awards%s", newline);
                     color(normal);
-                    embedimages = false;
+                    check->embedimages = false;
                 }
             }
             char fullimagename[2048];
@@ -13400,26 +14746,26 @@ void parsetitleidresource(unsigned char *resourcebuffer, unsigned long resources
                         }
                     }
                     else {
-                        sprintf(fullimagename, "%s%02X%02X%02X%02X-%08lX.png", imagedirpath, titleid[0], titleid[1], titleid[2], titleid[3], imageid);
+                        sprintf(fullimagename, "%s%02X%02X%02X%02X-%08lX.png", imagedirpath, check->titleid[0], check->titleid[1], check->titleid[2], check->titleid[3], imageid);
                         imagefile = fopen(fullimagename, "wb");
                         if (imagefile == NULL) {
                             color(red);
                             printf("ERROR: Failed to open %s%s%s for writing! (%s) Failed to extract images!%s",
                                     quotation, fullimagename, quotation, strerror(errno), newline);
                             color(normal);
-                            extractimages = false;
+                            check->extractimages = false;
                           break;
                         }
                         initcheckwrite();
                         if (checkwriteandprinterrors(resourcebuffer+imageoffset, 1, imagesize, imagefile, 0, 0, fullimagename, "Extracting images") != 0) {
                             fclose(imagefile);
-                            extractimages = false;
+                            check->extractimages = false;
                           break;
                         }
                         donecheckwrite(fullimagename);
                         fclose(imagefile);
                         if (debug) printf("successfully extracted: %s%s", fullimagename, newline);
-                        if (embedimages && imagesize <= 32768) {
+                        if (check->embedimages && imagesize <= 32768) {
                             // Max 32 KB is important for browser compatibility and SIZE_OF_EMBEDDEDIMAGEBUFFER
                             embedable_images[resource.num_embedable].imageid = imageid;
                             embedable_images[resource.num_embedable].offset = imageoffset;
@@ -13430,7 +14776,7 @@ void parsetitleidresource(unsigned char *resourcebuffer, unsigned long resources
                 }
             }
         }
-        else extractimages = false;  // this is so we don't add a bad imagedirpath to html source or something else stupid
+        else check->extractimages = false;  // this is so we don't add a bad imagedirpath to html source or something else stupid
     }
     
     if (resource.xlastgz_offset && resource.xlastgz_size && resource.xlastsize) {
@@ -14303,13 +15649,13 @@ void parsetitleidresource(unsigned char *resourcebuffer, unsigned long resources
         }
     }
     
-    if (html && extractimages) {
+    if (html && check->extractimages) {
         // need to convert backslashes to forward slashes for html source
         for (i=0;i<(int)strlen(imagedirpath);i++) {
             if (imagedirpath[i] == '\\') imagedirpath[i] = '/';
         }
         printf("%s<img src=\"", sp5);
-        if (embedimages) {
+        if (check->embedimages) {
             for (m=0;m<resource.num_embedable;m++) {
                 if (embedable_images[m].imageid == 0x8000) {
                     base64encode(resourcebuffer+embedable_images[m].offset, embedable_images[m].size, embeddedimagebuffer);
@@ -14318,7 +15664,7 @@ void parsetitleidresource(unsigned char *resourcebuffer, unsigned long resources
                 }
             }
         }
-        else printf("file:///%s%02X%02X%02X%02X-00008000.png", imagedirpath, titleid[0], titleid[1], titleid[2], titleid[3]);
+        else printf("file:///%s%02X%02X%02X%02X-00008000.png", imagedirpath, check->titleid[0], check->titleid[1], check->titleid[2], check->titleid[3]);
         printf("\" alt=\"title icon\" width=64 height=64><br>\n");
     }
     long long displaylanguageindex = -1LL;
@@ -14547,11 +15893,11 @@ void parsetitleidresource(unsigned char *resourcebuffer, unsigned long resources
             for (m=0;m<resource.num_avatarawards;m++) {
                 if (html) {
                     printf("<tr id=a_r%02lu style=\"cursor:pointer\" onClick=\"sh('a_u%02lu','a_a%02lu','a_r%02lu','a_c%02lu')\">", m+1, m+1, m+1, m+1, m+1);
-                    if (extractimages) {
+                    if (check->extractimages) {
                         if (avataraward[m].imageid == 0xFFFFFFFFL) printf("<td class=sp><!-- no img -->&nbsp;&nbsp;</td>");  // in case we need to figure out why no image is displayed
                         else {
                             printf("<td><img src=\"");
-                            if (embedimages) printf("data:image/png;base64,"
+                            if (check->embedimages) printf("data:image/png;base64,"
                                 "iVBORw0KGgoAAAANSUhEUgAAACAAAABACAYAAAB7jnWuAAAC8UlEQVR42uxYz2sTQRR+m22iYs2h"
                                 "RQxEPBUUwatQMKcQ8SCKRfHHSdBTQejFP6AntVIQFIonQTBQlIIiCErxoIIIUbQoBkVRbA3Gn22a"
                                 "6Kbt+M3b52bTCNrsJrnMwLfzdmZ3v2/ee/MjsZRS1MkSoQ4XI8AIMAKMACPACDACjACLAh6IVMAP"
@@ -14569,7 +15915,7 @@ void parsetitleidresource(unsigned char *resourcebuffer, unsigned long resources
                                 "AAAAAElFTkSuQmCC");
                             else printf("file:///%schecked.png", imagedirpath);
                             printf("\" alt=\"checked\" width=32 height=64 id=a_c%02lu style=\"visibility:hidden\"><img src=\"", m+1);
-                            if (embedimages) {
+                            if (check->embedimages) {
                                 for (x=0;x<resource.num_embedable;x++) {
                                     if (embedable_images[x].imageid == avataraward[m].imageid) {
                                         base64encode(resourcebuffer+embedable_images[x].offset, embedable_images[x].size, embeddedimagebuffer);
@@ -14578,7 +15924,7 @@ void parsetitleidresource(unsigned char *resourcebuffer, unsigned long resources
                                     }
                                 }
                             }
-                            else printf("file:///%s%02X%02X%02X%02X-%08lX.png", imagedirpath, titleid[0], titleid[1], titleid[2], titleid[3], avataraward[m].imageid);
+                            else printf("file:///%s%02X%02X%02X%02X-%08lX.png", imagedirpath, check->titleid[0], check->titleid[1], check->titleid[2], check->titleid[3], avataraward[m].imageid);
                             printf("\" alt=\"AA icon %02lu\" width=64 height=64></td>", m+1);
                         }
                     }
@@ -14658,10 +16004,10 @@ void parsetitleidresource(unsigned char *resourcebuffer, unsigned long resources
             for (m=0;m<resource.num_achievements;m++) {
                 if (html) {
                     printf("<tr id=r%02lu style=\"cursor:pointer\" onClick=\"sh('u%02lu','a%02lu','r%02lu','c%02lu')\">", m+1, m+1, m+1, m+1, m+1);
-                    if (extractimages) {
+                    if (check->extractimages) {
                         if (hidesecretachievements && (achievement[m].type >= 1 && achievement[m].type <=7)) {
                             printf("<td><img src=\"");
-                            if (embedimages) printf("data:image/png;base64,"
+                            if (check->embedimages) printf("data:image/png;base64,"
                                 "iVBORw0KGgoAAAANSUhEUgAAACAAAABACAYAAAB7jnWuAAAC8UlEQVR42uxYz2sTQRR+m22iYs2h"
                                 "RQxEPBUUwatQMKcQ8SCKRfHHSdBTQejFP6AntVIQFIonQTBQlIIiCErxoIIIUbQoBkVRbA3Gn22a"
                                 "6Kbt+M3b52bTCNrsJrnMwLfzdmZ3v2/ee/MjsZRS1MkSoQ4XI8AIMAKMACPACDACjACLAh6IVMAP"
@@ -14679,7 +16025,7 @@ void parsetitleidresource(unsigned char *resourcebuffer, unsigned long resources
                                 "AAAAAElFTkSuQmCC");
                             else printf("file:///%schecked.png", imagedirpath);
                             printf("\" alt=\"checked\" width=32 height=64 id=c%02lu style=\"visibility:hidden\"><img src=\"", m+1);
-                            if (embedimages) printf("data:image/png;base64,"
+                            if (check->embedimages) printf("data:image/png;base64,"
                                 "iVBORw0KGgoAAAANSUhEUgAAAEAAAABACAMAAACdt4HsAAAAGFBMVEX+/v6Pj486OjoyMjIlJSVb"
                                 "W1vHx8fe3t6Fwq2EAAABCElEQVR42uyX6xKEIAiFQUDf/43Xyku1aSzuzDY7nn9mfCkeqIDcmIBp"
                                 "SI8BsE0VYMtfBbgJ+G+ARNkBGGBVQDEACGEnLx8DAhyFHwLO8VeEDoA8vEvOpdwGkJS9+7oUrwdw"
@@ -14694,7 +16040,7 @@ void parsetitleidresource(unsigned char *resourcebuffer, unsigned long resources
                             if (achievement[m].imageid == 0xFFFFFFFFL) printf("<td class=sp><!-- no img -->&nbsp;&nbsp;</td>");  // in case we need to figure out why no image is displayed
                             else {
                                 printf("<td><img src=\"");
-                                if (embedimages) printf("data:image/png;base64,"
+                                if (check->embedimages) printf("data:image/png;base64,"
                                     "iVBORw0KGgoAAAANSUhEUgAAACAAAABACAYAAAB7jnWuAAAC8UlEQVR42uxYz2sTQRR+m22iYs2h"
                                     "RQxEPBUUwatQMKcQ8SCKRfHHSdBTQejFP6AntVIQFIonQTBQlIIiCErxoIIIUbQoBkVRbA3Gn22a"
                                     "6Kbt+M3b52bTCNrsJrnMwLfzdmZ3v2/ee/MjsZRS1MkSoQ4XI8AIMAKMACPACDACjACLAh6IVMAP"
@@ -14712,7 +16058,7 @@ void parsetitleidresource(unsigned char *resourcebuffer, unsigned long resources
                                     "AAAAAElFTkSuQmCC");
                                 else printf("file:///%schecked.png", imagedirpath);
                                 printf("\" alt=\"checked\" width=32 height=64 id=c%02lu style=\"visibility:hidden\"><img src=\"", m+1);
-                                if (embedimages) {
+                                if (check->embedimages) {
                                     for (x=0;x<resource.num_embedable;x++) {
                                         if (embedable_images[x].imageid == achievement[m].imageid) {
                                             base64encode(resourcebuffer+embedable_images[x].offset, embedable_images[x].size, embeddedimagebuffer);
@@ -14721,7 +16067,7 @@ void parsetitleidresource(unsigned char *resourcebuffer, unsigned long resources
                                         }
                                     }
                                 }
-                                else printf("file:///%s%02X%02X%02X%02X-%08lX.png", imagedirpath, titleid[0], titleid[1], titleid[2], titleid[3], achievement[m].imageid);
+                                else printf("file:///%s%02X%02X%02X%02X-%08lX.png", imagedirpath, check->titleid[0], check->titleid[1], check->titleid[2], check->titleid[3], achievement[m].imageid);
                                 printf("\" alt=\"Ach icon %02lu\" width=64 height=64></td>", m+1);
                             }
                         }
@@ -14960,11 +16306,327 @@ void parsetitleidresource(unsigned char *resourcebuffer, unsigned long resources
   return;
 }
 
-int checkdefaultxex(unsigned char *defaultxexbuffer, unsigned long defaultxexsize) {
+unsigned char *readxexheader(unsigned char *firstsector, unsigned long defaultxexsize, FILE *fp, unsigned long long defaultxexaddress,
+                             char *filename, char *action) {
+    // read the Xex header (everything before the code, which is all checkdefaultxex() keeps in memory) into a buffer
+    // with a sector of zeros after it, returns NULL if it can't be read
+    unsigned long codeoffset = getuintmsb(firstsector+0x08);
+    unsigned long headersize;
+    unsigned char *headerbuffer;
+    // checkdefaultxex() will complain about a codeoffset that's too big
+    if (codeoffset > defaultxexsize) codeoffset = defaultxexsize;
+    // round up to the end of the sector so the code can keep being read a sector at a time
+    headersize = (codeoffset + 2047) & ~2047UL;
+    if (headersize == 0) headersize = 2048;
+    if (headersize > defaultxexsize) headersize = defaultxexsize;
+    if ((unsigned long long) headersize + 2048 + XEX_WINDOWSLACK + XEX_MINWINDOWSIZE > (unsigned long long) xexmemory * 1048576) {
+        color(red);
+        printf("ERROR: The Xex header is %lu bytes, that doesn't leave enough of the %d MB allowed by --xexmemory to check the rest of it!%s",
+                codeoffset, xexmemory, newline);
+        color(normal);
+      return NULL;
+    }
+    headerbuffer = (unsigned char *) calloc(headersize + 2048, sizeof(char));
+    if (headerbuffer == NULL) {
+        color(red);
+        printf("ERROR: Memory allocation for the Xex header failed! Game over man... Game over!%s", newline);
+        color(normal);
+      exit(1);
+    }
+    if (fseeko(fp, defaultxexaddress, SEEK_SET) != 0) {
+        printseekerror(filename, action);
+        free(headerbuffer);
+      return NULL;
+    }
+    if (checkreadandprinterrors(headerbuffer, 1, headersize, fp, 0, defaultxexaddress, filename, action) != 0) {
+        free(headerbuffer);
+      return NULL;
+    }
+  return headerbuffer;
+}
+
+void openxexstream(struct xexstream *xs, FILE *fp, unsigned long long defaultxexaddress, unsigned long defaultxexsize,
+                   unsigned long codeoffset, unsigned long windowsize, const unsigned char *sessionkey, char *filename, char *action) {
+    memset(xs, 0, sizeof(struct xexstream));
+    xs->fp = fp;
+    xs->filename = filename;
+    xs->action = action;
+    xs->address = defaultxexaddress;
+    xs->size = defaultxexsize;
+    xs->codeoffset = codeoffset;
+    xs->windowsize = windowsize;
+    xs->window = (unsigned char *) malloc((windowsize + XEX_WINDOWSLACK) * sizeof(char));
+    if (xs->window == NULL) {
+        color(red);
+        printf("ERROR: Memory allocation for the Xex window failed! Game over man... Game over!%s", newline);
+        color(normal);
+      exit(1);
+    }
+    // start reading at the sector the code starts in (what's before it in that sector was read with the header and
+    // has already been added to the crc by the caller)
+    xs->windowstart = xs->windowend = codeoffset & ~2047UL;
+    xs->readyend = codeoffset;
+    if (sessionkey != NULL) {
+        xs->encrypted = true;
+        memcpy(xs->sessionkey, sessionkey, 16);
+    }
+    if (fseeko(fp, defaultxexaddress + xs->windowend, SEEK_SET) != 0) {
+        printseekerror(filename, action);
+        xs->failed = true;
+    }
+  return;
+}
+
+unsigned char *getxexstream(struct xexstream *xs, unsigned long offset, unsigned long len) {
+    // return a pointer to bytes offset through offset+len-1 of the Xex (decrypted), reading as far past them as the
+    // window has room for.  offset can never go backwards because anything before it is thrown away to make room,
+    // returns NULL if it's out of bounds or couldn't be read (the read error has been printed)
+    unsigned long keep, chunk, n, crcstart;
+    unsigned char *ready, nextivec[16];
+    bool firstread;
+    if (xs->failed || offset < xs->windowstart || len > xs->windowsize || offset > xs->size || len > xs->size - offset) return NULL;
+    while (offset + len > xs->readyend) {
+        // drop what's before offset, or what's before readyend if it hasn't even been decrypted that far yet
+        keep = offset < xs->readyend ? offset : xs->readyend;
+        if (keep > xs->windowend) keep = xs->windowend;
+        if (keep > xs->windowstart) {
+            memmove(xs->window, xs->window + (keep - xs->windowstart), (size_t) (xs->windowend - keep));
+            xs->windowstart = keep;
+        }
+        // fill up the rest of the window, windowend stays on a sector boundary until it gets to the end (reading
+        // from a dvd drive needs that)
+        chunk = (xs->windowsize + XEX_WINDOWSLACK - (xs->windowend - xs->windowstart)) & ~2047UL;
+        if (chunk > xs->size - xs->windowend) chunk = xs->size - xs->windowend;
+        if (checkreadandprinterrors(xs->window + (xs->windowend - xs->windowstart), 1, chunk, xs->fp, 0, xs->address + xs->windowend,
+                                    xs->filename, xs->action) != 0) {
+            xs->failed = true;
+          return NULL;
+        }
+        crcstart = xs->windowend > xs->codeoffset ? xs->windowend : xs->codeoffset;
+        xs->windowend += chunk;
+        if (xs->windowend > crcstart)
+            xs->crc = crc32_fast(xs->crc, xs->window + (crcstart - xs->windowstart), xs->windowend - crcstart);
+        if (xs->windowend <= xs->readyend) continue;
+        // decrypt whole aes blocks only, except at the end where any remainder is just left the way it is
+        n = xs->windowend - xs->readyend;
+        if (xs->windowend < xs->size) n &= ~15UL;
+        ready = xs->window + (xs->readyend - xs->windowstart);
+        if (xs->encrypted && n >= 16) {
+            firstread = xs->readyend == xs->codeoffset;
+            if (debug && firstread) {
+                printf("1st 2048 bytes of code to decrypt:%s", newline);
+                hexdump(ready, 0, n > 2048 ? 2048 : (int) n);
+            }
+            // cbc carries on from the last encrypted block of this chunk
+            memcpy(nextivec, ready + (n & ~15UL) - 16, 16);
+            aescbc_decrypt128(xs->sessionkey, xs->ivec, ready, (size_t) n, 0);
+            memcpy(xs->ivec, nextivec, 16);
+            if (debug && firstread) {
+                printf("1st 2048 bytes of decrypted code:%s", newline);
+                hexdump(ready, 0, n > 2048 ? 2048 : (int) n);
+            }
+        }
+        // should use proper error checking but this for debug so doesn't matter that much
+        if (xs->defaultdec != NULL) dontcare = fwrite(ready, 1, (size_t) n, xs->defaultdec);
+        xs->readyend += n;
+    }
+  return xs->window + (offset - xs->windowstart);
+}
+
+void closexexstream(struct xexstream *xs) {
+    free(xs->window);
+    xs->window = NULL;
+    if (xs->defaultdec != NULL) {
+        fclose(xs->defaultdec);
+        xs->defaultdec = NULL;
+    }
+  return;
+}
+
+struct xexgather {
+    struct xexstream *xs;
+    struct xexhash xh;
+    int threads;
+    bool hashing;
+    // the blocks that are in the window right now (blocknumber is the number of the first one, counting from 1)
+    struct xexhash_block *blocks;
+    unsigned long maxblocks, numblocks, nextblock, blocknumber;
+    // where the chain goes next
+    unsigned long address, size;
+    uchar hash[20];
+    // the walk stopped at a block that doesn't fit, which gets reported once every block before it checks out
+    bool badsize;
+    bool failed;
+};
+
+void walkxexblocks(struct xexgather *gather) {
+    // move the window up to the next block in the chain and start hashing every block that's in it
+    struct xexhash_block *grownblocks;
+    unsigned char *p;
+    unsigned long firstaddress;
+    if (gather->hashing) {
+        xexhash_finish(&gather->xh);
+        gather->hashing = false;
+    }
+    gather->blocknumber += gather->numblocks;
+    gather->numblocks = gather->nextblock = 0;
+    if (gather->size == 0) return;  // end of the chain
+    if (gather->size > gather->xs->windowsize && gather->address + gather->size <= gather->xs->size && gather->size >= 24) {
+        gather->failed = true;
+        color(red);
+        printf("ERROR: Compressed block #%lu (%lu bytes) is too big to check with the %d MB allowed by --xexmemory! Failed to decompress the Xex!%s",
+                gather->blocknumber + 1, gather->size, xexmemory, newline);
+        color(normal);
+      return;
+    }
+    firstaddress = gather->address;
+    while (1) {
+        if (gather->address + gather->size > gather->xs->size || gather->size < 24) {
+            // the block would be extending past the end of the default.xex!
+            gather->badsize = true;
+          break;
+        }
+        if (gather->address + gather->size > gather->xs->windowstart + gather->xs->windowsize) {
+            // this one will have to wait for the next window
+            if (gather->numblocks) break;
+        }
+        else if (gather->numblocks && gather->address + gather->size > gather->xs->readyend) break;
+        p = getxexstream(gather->xs, gather->address, gather->size);
+        if (p == NULL) {
+            gather->failed = true;
+          return;
+        }
+        if (gather->numblocks == gather->maxblocks) {
+            gather->maxblocks = gather->maxblocks ? gather->maxblocks * 2 : 256;
+            grownblocks = (struct xexhash_block *) realloc(gather->blocks, gather->maxblocks * sizeof(struct xexhash_block));
+            if (grownblocks == NULL) {
+                color(red);
+                printf("ERROR: memory allocation for xexblocks failed! Game over man... Game over!%s", newline);
+                color(normal);
+              exit(1);
+            }
+            gather->blocks = grownblocks;
+        }
+        gather->blocks[gather->numblocks].data = p;
+        gather->blocks[gather->numblocks].size = (size_t) gather->size;
+        memcpy(gather->blocks[gather->numblocks].expected, gather->hash, 20);
+        gather->numblocks++;
+        // get info about the next block
+        memcpy(gather->hash, p+4, 20);
+        gather->address += gather->size;
+        gather->size = getuintmsb(p);
+        if (gather->size == 0) break;
+    }
+    if (gather->numblocks) {
+        xexhash_start(&gather->xh, gather->blocks, gather->numblocks, gather->threads);
+        gather->hashing = true;
+    }
+    if (debug) {
+        printf("hashing compressed blocks #%lu to #%lu (0x%07lX to 0x%07lX) on %d thread%s%s",
+                gather->blocknumber + 1, gather->blocknumber + gather->numblocks, firstaddress, gather->address,
+                gather->xh.numthreads + 1, gather->xh.numthreads ? "s" : "", newline);
+    }
+  return;
+}
+
+int gatherxexblock(struct memspack_buffer *lzxcompressed) {
+    // memspack more() callback: wait for the next compressed block to be verified and put its segments in the lzx
+    // input, printing the same errors the blocks would have gotten when they were checked one after another
+    struct xexgather *gather = (struct xexgather *) lzxcompressed->morearg;
+    struct xexhash_block *block;
+    unsigned long m, n, p, compressedblock_realsize = 0;
+    unsigned short s;
+    int i;
+    if (gather->failed) return 0;
+    if (gather->nextblock == gather->numblocks && !gather->badsize) walkxexblocks(gather);
+    if (gather->failed) return 0;
+    m = gather->blocknumber + gather->nextblock + 1;
+    if (gather->nextblock == gather->numblocks) {
+        if (gather->badsize) {
+            gather->failed = true;
+            color(red);
+            printf("ERROR: Compressed block #%lu is reporting an incorrect size! Failed to decompress the Xex!%s", m, newline);
+            if (debug) {
+                printf("start address: 0x%lX%s", gather->address, newline);
+                printf("block size: %lu (0x%lX)%s", gather->size, gather->size, newline);
+                printf("defaultxexsize: %lu (0x%lX)%s", gather->xs->size, gather->xs->size, newline);
+                printf("hash expected: ");
+                for (i=0;i<20;i++) printf("%02X", gather->hash[i]);
+                printf("%s", newline);
+            }
+            color(normal);
+        }
+      return 0;
+    }
+    block = &gather->blocks[gather->nextblock];
+    // the window doesn't move while its blocks are being gathered
+    n = (unsigned long) (block->data - gather->xs->window) + gather->xs->windowstart;
+    if (xexhash_wait(&gather->xh, gather->nextblock) == XEXHASH_CORRUPT) {
+        // expected hash doesn't match the calculated one
+        gather->failed = true;
+        color(red);
+        printf("ERROR: Compressed block #%lu is corrupt! Failed to decompress the Xex!%s", m, newline);
+        if (debug) {
+            printf("start address: 0x%lX%s", n, newline);
+            printf("block size: %lu (0x%lX)%s", (unsigned long) block->size, (unsigned long) block->size, newline);
+            printf("hash expected: %s", sp2);
+            for (i=0;i<20;i++) printf("%02X", block->expected[i]);
+            printf("%shash calculated: ", newline);
+            for (i=0;i<20;i++) printf("%02X", block->calculated[i]);
+            printf("%s", newline);
+        }
+        color(normal);
+      return 0;
+    }
+    else if (debug) {
+        printf("compressed block #%03lu is valid, address = 0x%07lX, size = %06lu (0x%06lX)%s",
+                m, n, (unsigned long) block->size, (unsigned long) block->size, newline);
+    }
+    p = 24;
+    i = 0;
+    while(1) {
+        i++;
+        // the segments (and the 0 after them) have to be in the block, nothing past it is in the window
+        s = p + 2 > block->size ? 0 : getwordmsb((unsigned char *) block->data+p);
+        if (s == 0) break;
+        else if (debug) printf("block segment #%02d size = %05u%s", i, s, newline);
+        compressedblock_realsize += s;
+        if (compressedblock_realsize > block->size) {
+            // should never happen
+            gather->failed = true;
+            color(red);
+            printf("ERROR: Compressed block #%lu has invalid parsing data! Failed to decompress the Xex!%s",
+                    m, newline);
+            color(normal);
+          break;
+        }
+        if (p + 2 + s > block->size || lzxcompressed->size + s > lzxcompressed->capacity) {
+            // should never happen either
+            gather->failed = true;
+            color(red);
+            printf("ERROR: Compressed block #%lu has a segment that extends past the end of the block! Failed to decompress the Xex!%s",
+                    m, newline);
+            color(normal);
+          break;
+        }
+        memcpy(lzxcompressed->data + lzxcompressed->size, block->data+p+2, (size_t) s);
+        lzxcompressed->size += (size_t) s;
+        p += s+2;
+    }
+    if (debug) printf("compressed block #%03lu real size = %06lu (0x%06lX)%s%s",
+                       m, compressedblock_realsize, compressedblock_realsize, newline, newline);
+    if (gather->failed) return 0;
+    gather->nextblock++;
+  return 1;
+}
+
+int checkdefaultxex(unsigned char *defaultxexbuffer, unsigned long defaultxexsize, FILE *fp, unsigned long long defaultxexaddress,
+                    char *filename, char *action) {
+    // defaultxexbuffer only has the header (see readxexheader), the code is read from fp through an xexstream
     char *spx;
     int i;
     unsigned long m, n;
-    xex_crc32 = 0;
+    check->xex_crc32 = 0;
     //memset(xex_sha1, 0, 20);
     // get the starting address of code from 0x08 in the xex
     unsigned long codeoffset = getuintmsb(defaultxexbuffer+0x08);
@@ -15030,7 +16692,7 @@ int checkdefaultxex(unsigned char *defaultxexbuffer, unsigned long defaultxexsiz
         else if (memcmp(defaultxexbuffer+n, discprofileid_tableflags, 4) == 0) {
             discprofileid_address = getuintmsb(defaultxexbuffer+n+4);
             // if this was just a game partition, we will assume it needs to be rebuilt with xgd3 offsets if the xex has a disc profile id
-            if (video == 0) xgd3 = true;
+            if (check->video == 0) check->xgd3 = true;
         }
         else if (memcmp(defaultxexbuffer+n, basefiletimestamp_tableflags, 4) == 0) {
             basefiletimestamp_address = getuintmsb(defaultxexbuffer+n+4);
@@ -15047,7 +16709,7 @@ int checkdefaultxex(unsigned char *defaultxexbuffer, unsigned long defaultxexsiz
         else if (memcmp(defaultxexbuffer+n, systemflags_tableflags, 4) == 0) {
             foundsystemflags = true;
             systemflags = getuintmsb(defaultxexbuffer+n+4);
-            if (systemflags & 0x00020000) game_has_ap25 = true;
+            if (systemflags & 0x00020000) check->game_has_ap25 = true;
         }
     }
     if (debug) {
@@ -15063,6 +16725,19 @@ int checkdefaultxex(unsigned char *defaultxexbuffer, unsigned long defaultxexsiz
         else printf("%sdid not find systemflags%s", sp5, newline);
         printf("%s", newline);
     }
+    // everything the info table points to is supposed to be in the header, and that's all of the xex that's in memory
+    unsigned long *infotable_address[8] = {&resourceinfo_address, &compressioninfo_address, &executioninfo_address, &discprofileid_address,
+                                           &basefiletimestamp_address, &originalname_address, &ratings_address, &importlibs_address};
+    for (i=0;i<8;i++) {
+        if (*infotable_address[i] >= codeoffset) {
+            if (debug || testing) {
+                color(yellow);
+                printf("info table address 0x%lX is past the start of the code, it will be ignored%s", *infotable_address[i], newline);
+                color(normal);
+            }
+            *infotable_address[i] = 0L;
+        }
+    }
     if (extraverbose || (foundsystemflags && (systemflags & 0x00020000))) {
         unsigned long moduleflags = getuintmsb(defaultxexbuffer+4);
         if (moduleflags == 0) printf("%sNo Module Flags%s", sp5, newline);
@@ -15148,13 +16823,13 @@ int checkdefaultxex(unsigned char *defaultxexbuffer, unsigned long defaultxexsiz
         else printf("%sNo System Flags%s", sp5, newline);
     }
     if (discprofileid_address) {
-        memcpy(xex_discprofileid, defaultxexbuffer+discprofileid_address, 16);
-        xex_founddiscprofileid = true;
-        if (!game_has_ap25) {
+        memcpy(check->xex_discprofileid, defaultxexbuffer+discprofileid_address, 16);
+        check->xex_founddiscprofileid = true;
+        if (!check->game_has_ap25) {
             // check disc profile id against list of ap25 disc profile ids
             for (m=0;m<num_ap25discprofileids;m++) {
                 if (memcmp(defaultxexbuffer+discprofileid_address+12, mostrecentap25discprofileids[m].mediaid, 4) == 0) {
-                    game_has_ap25 = true;
+                    check->game_has_ap25 = true;
                     break;
                 }
             }
@@ -15177,26 +16852,26 @@ int checkdefaultxex(unsigned char *defaultxexbuffer, unsigned long defaultxexsiz
     unsigned long titleidresource_size = 0L;
     unsigned int disc_num = 0;
     unsigned int num_discs = 0;
-    memset(titleid, 0, 4);
+    memset(check->titleid, 0, 4);
     if (executioninfo_address) {
         disc_num = (unsigned int) defaultxexbuffer[executioninfo_address+18];
         num_discs = (unsigned int) defaultxexbuffer[executioninfo_address+19];
         unsigned char titleidhex[9], cmp;
-        memcpy(titleid, defaultxexbuffer+executioninfo_address+12, 4);
-        foundtitleid = true;
-        if (extraverbose || extractimages) {
+        memcpy(check->titleid, defaultxexbuffer+executioninfo_address+12, 4);
+        check->foundtitleid = true;
+        if (extraverbose || check->extractimages) {
             if (verbose) printf("%s", sp5);
             printf("Title ID: ");
             if (verbose) printf("%s ", sp12);
-            printf("%02X%02X%02X%02X", titleid[0], titleid[1], titleid[2], titleid[3]);
-            if ((titleid[0] < 0x20 || (titleid[0] > 0x7E && titleid[0] < 0xA1)) || (titleid[1] < 0x20 || (titleid[1] > 0x7E && titleid[1] < 0xA1))) printf("%s", newline);
-            else printf(" (%c%c-%u)%s", titleid[0], titleid[1], getwordmsb(titleid+2), newline);
+            printf("%02X%02X%02X%02X", check->titleid[0], check->titleid[1], check->titleid[2], check->titleid[3]);
+            if ((check->titleid[0] < 0x20 || (check->titleid[0] > 0x7E && check->titleid[0] < 0xA1)) || (check->titleid[1] < 0x20 || (check->titleid[1] > 0x7E && check->titleid[1] < 0xA1))) printf("%s", newline);
+            else printf(" (%c%c-%u)%s", check->titleid[0], check->titleid[1], getwordmsb(check->titleid+2), newline);
         }
-        if (!game_has_ap25) {
+        if (!check->game_has_ap25) {
             // check title id against list of title ids for ap25 discs with no ap25 xex flag
             for (m=0;m<num_ap25titleids;m++) {
-                if (memcmp(titleid, mostrecentap25titleids[m].mediaid, 4) == 0) {
-                    game_has_ap25 = true;
+                if (memcmp(check->titleid, mostrecentap25titleids[m].mediaid, 4) == 0) {
+                    check->game_has_ap25 = true;
                     break;
                 }
             }
@@ -15204,8 +16879,8 @@ int checkdefaultxex(unsigned char *defaultxexbuffer, unsigned long defaultxexsiz
         // convert 4 byte title id into 8 byte ascii hex representation for comparison to resource names
         memset(titleidhex, 0, 9);
         for (i=0; i<8; i++) {
-            if (i%2 == 0) cmp =  titleid[i/2] & 0xF0;
-            else          cmp = (titleid[i/2] & 0x0F) << 4;       
+            if (i%2 == 0) cmp =  check->titleid[i/2] & 0xF0;
+            else          cmp = (check->titleid[i/2] & 0x0F) << 4;       
             if      (cmp == 0xF0) titleidhex[i] = 'F';
             else if (cmp == 0xE0) titleidhex[i] = 'E';
             else if (cmp == 0xD0) titleidhex[i] = 'D';
@@ -15234,6 +16909,11 @@ int checkdefaultxex(unsigned char *defaultxexbuffer, unsigned long defaultxexsiz
                 color(normal);
                 if (debug) hexdump(defaultxexbuffer+resourceinfo_address, 0, 2048);
             }
+            else if (resourceinfo_size > codeoffset - resourceinfo_address) {
+                color(yellow);
+                printf("ERROR: Resource info extends past the end of the Xex header!%s", newline);
+                color(normal);
+            }
             else {
                 if (debug && ((resourceinfo_size - 4) % 16)) {
                     // shouldn't happen so we'll print a message in debug mode but otherwise we'll just ignore any leftover partial entries
@@ -15661,7 +17341,6 @@ int checkdefaultxex(unsigned char *defaultxexbuffer, unsigned long defaultxexsiz
     bool xex_is_compressed_delta = false;
     bool xex_is_compressed_unknown = false;
     uchar compressedblock_hash[20] = {0};
-    uchar compressedblock_hash_calculated[20] = {0};
     unsigned long compressioninfo_size = 0L;
     unsigned long compressedblock_size = 0L;
     unsigned long compressionwindow = 0L;
@@ -15714,6 +17393,11 @@ int checkdefaultxex(unsigned char *defaultxexbuffer, unsigned long defaultxexsiz
                 xex_is_compressed_basic = false;
                 xex_is_compressed_unknown = true;
             }
+            else if (compressioninfo_size > codeoffset - compressioninfo_address) {
+                if (debug || testing) printf("xex_is_compressed_basic but compressioninfo_size (%lu) extends past the end of the header%s", compressioninfo_size, newline);
+                xex_is_compressed_basic = false;
+                xex_is_compressed_unknown = true;
+            }
             else if (compressioninfo_size > 8) {
                 int basiccompressionentries = (int) (compressioninfo_size - 8) / 8;
                 struct { unsigned long address, paddingsize; } basiccompressioninfo[basiccompressionentries];
@@ -15814,16 +17498,14 @@ int checkdefaultxex(unsigned char *defaultxexbuffer, unsigned long defaultxexsiz
         for (i=0; i<16; i++) printf("%02X", (unsigned char) xex_sessionkey[i]);
         printf("%s", newline);
     }
-    // calculate xex crc
-    xex_crc32 = crc32(0, defaultxexbuffer, defaultxexsize);
     // get default.xex media id (at certoffset + 0x140)
-    memcpy(xex_mediaid, defaultxexbuffer+(certoffset+0x140), 16);
-    xex_foundmediaid = true;
-    if (!game_has_ap25) {
+    memcpy(check->xex_mediaid, defaultxexbuffer+(certoffset+0x140), 16);
+    check->xex_foundmediaid = true;
+    if (!check->game_has_ap25) {
         // check media id against list of ap25 media ids for discs with no ap25 xex flag
         for (m=0;m<num_ap25mediaids;m++) {
-            if (memcmp(xex_mediaid+12, mostrecentap25mediaids[m].mediaid, 4) == 0) {
-                game_has_ap25 = true;
+            if (memcmp(check->xex_mediaid+12, mostrecentap25mediaids[m].mediaid, 4) == 0) {
+                check->game_has_ap25 = true;
                 break;
             }
         }
@@ -15840,14 +17522,46 @@ int checkdefaultxex(unsigned char *defaultxexbuffer, unsigned long defaultxexsiz
         printf("%s", newline);
     }
 */
-    if (xex_is_encrypted) {
-        // decrypt it
-        if (debug) {
-            printf("1st 2048 bytes of code to decrypt:%s", newline);
-            hexdump(defaultxexbuffer+codeoffset, 0, 2048);
+    // the code is only read in a window at a time, make it as big as it can be without going over --xexmemory when
+    // the header, the title id resource and (for lzx) the compressed segments of a window and lzxd's own window and
+    // input buffer are added to it
+    unsigned long long xexmemorylimit = (unsigned long long) xexmemory * 1048576;
+    unsigned long long xexmemoryneeded = (unsigned long long) ((codeoffset + 2047) & ~2047UL) + 2048 + XEX_WINDOWSLACK;
+    unsigned long xexwindowsize = XEX_WINDOWSIZE;
+    int xexwindows = 1;
+    if (xex_is_compressed) {
+        xexwindows = 2;
+        if (compressionwindow_bits) xexmemoryneeded += (unsigned long long) compressionwindow + 32768;
+    }
+    if (titleidresource_relativeaddress) {
+        if (xexmemoryneeded + titleidresource_size + (unsigned long long) xexwindows * XEX_MINWINDOWSIZE > xexmemorylimit) {
+            color(yellow);
+            printf("ERROR: The Title ID Resource (%lu bytes) is too big to check with the %d MB allowed by --xexmemory!%s",
+                    titleidresource_size, xexmemory, newline);
+            color(normal);
+            titleidresource_relativeaddress = 0L;
         }
-        u8 ivec[16], pt[16], ct[16];
-        memset(ivec, 0, 16);
+        else xexmemoryneeded += titleidresource_size;
+    }
+    if (xexmemoryneeded + (unsigned long long) xexwindows * XEX_MINWINDOWSIZE > xexmemorylimit) {
+        color(red);
+        printf("ERROR: Checking the Xex needs more than the %d MB allowed by --xexmemory!%s", xexmemory, newline);
+        color(normal);
+      return 1;
+    }
+    if (xexmemoryneeded + (unsigned long long) xexwindows * XEX_WINDOWSIZE > xexmemorylimit)
+        xexwindowsize = (unsigned long) ((xexmemorylimit - xexmemoryneeded) / xexwindows) & ~2047UL;
+    if (debug) printf("%sXex window size = %lu (%"LL"u bytes needed besides the window%s)%s", sp5, xexwindowsize,
+                      xexmemoryneeded, xexwindows > 1 ? "s" : "", newline);
+    // and start reading it (the crc of the header was left for now because it's in the same sector as the start of
+    // the code, and that sector gets read again)
+    struct xexstream xs;
+    unsigned char *xexpiece;
+    openxexstream(&xs, fp, defaultxexaddress, defaultxexsize, codeoffset, xexwindowsize,
+                  xex_is_encrypted ? xex_sessionkey : NULL, filename, action);
+    xs.crc = crc32_fast(0, defaultxexbuffer, codeoffset);
+    if (xex_is_encrypted) {
+        // it gets decrypted as it's read
         if (debug && ((defaultxexsize - codeoffset) % 16)) {
             // code to decrypt is not an even multiple of 16 (the aes block size)
             // this probably shouldn't happen so we'll print a message (in debug mode only)
@@ -15856,317 +17570,213 @@ int checkdefaultxex(unsigned char *defaultxexbuffer, unsigned long defaultxexsiz
             printf("(defaultxexsize - codeoffset) %% 16 = %lu%s", (defaultxexsize - codeoffset) % 16, newline);
             color(normal);
         }
-        Nr = rijndaelKeySetupDec(rk, xex_sessionkey, 128);
-        n = (defaultxexsize - codeoffset) / 16;
-        for (m=0;m<n;m++) {
-            memcpy(ct, defaultxexbuffer+codeoffset+m*16, 16);
-            rijndaelDecrypt(rk, Nr, ct, pt);
-            for (i=0;i<16;i++) pt[i] ^= ivec[i];
-            memcpy(ivec, ct, 16);
-            memcpy(defaultxexbuffer+codeoffset+m*16, pt, 16);
-        }
-        if (debug) {
-            printf("1st 2048 bytes of decrypted code:%s", newline);
-            hexdump(defaultxexbuffer+codeoffset, 0, 2048);
-        }
+        if (debug) printf("AES implementation: %s%s", aescbc_implementation(), newline);
         if (debug) {
-            FILE *defaultdec = NULL;
             char defaultdecpath[2048];
             memset(defaultdecpath, 0, 2048);
             if (!homeless) {
                 strcat(defaultdecpath, homedir); strcat(defaultdecpath, abgxdir);
             }
             strcat(defaultdecpath, "default.dec");
-            defaultdec = fopen(defaultdecpath, "wb");
-            if (defaultdec == NULL) {
+            xs.defaultdec = fopen(defaultdecpath, "wb");
+            if (xs.defaultdec == NULL) {
                 printf("ERROR: Failed to open %s%s%s for writing! (%s)%s", quotation, defaultdecpath, quotation, strerror(errno), newline);
             }
-            else {
-                // should use proper error checking but this for debug so doesn't matter that much
-                dontcare = fwrite(defaultxexbuffer+codeoffset, 1, defaultxexsize-codeoffset, defaultdec);
-                fclose(defaultdec);
-            }
         }
     }
     if (xex_is_compressed_basic) {
         if (titleidresource_relativeaddress) {
-            if (memcmp(defaultxexbuffer+codeoffset+titleidresource_relativeaddress, "XDBF", 4) != 0) {
-                if (debug || testing) {
-                    color(red);
-                    printf("\"XDBF\" was not found at the start of the title id resource:%s", newline);
-                    color(normal);
-                    hexdump(defaultxexbuffer+codeoffset+titleidresource_relativeaddress, 0, 2048);
-                }
+            // copy the title id resource out of the window, a window at a time if it has to be
+            unsigned char *resourcebuffer = (unsigned char *) calloc(titleidresource_size + 4, sizeof(char));
+            if (resourcebuffer == NULL) {
+                color(red);
+                printf("ERROR: Memory allocation for resourcebuffer failed! Game over man... Game over!%s", newline);
+                color(normal);
+              exit(1);
             }
-            else {
-                foundtitleidresource = true;
-                if (debug) {
-                    printf("1st 2048 bytes of the title id resource:%s", newline);
-                    hexdump(defaultxexbuffer+codeoffset+titleidresource_relativeaddress, 0, titleidresource_size > 2048 ? 2048 : titleidresource_size);
+            for (m=0;m<titleidresource_size;m+=n) {
+                n = titleidresource_size - m;
+                if (n > xexwindowsize) n = xexwindowsize;
+                xexpiece = getxexstream(&xs, codeoffset+titleidresource_relativeaddress+m, n);
+                if (xexpiece == NULL) break;
+                memcpy(resourcebuffer+m, xexpiece, (size_t) n);
+            }
+            if (!xs.failed) {
+                if (memcmp(resourcebuffer, "XDBF", 4) != 0) {
+                    if (debug || testing) {
+                        color(red);
+                        printf("\"XDBF\" was not found at the start of the title id resource:%s", newline);
+                        color(normal);
+                        hexdump(resourcebuffer, 0, titleidresource_size > 2048 ? 2048 : titleidresource_size);
+                    }
+                }
+                else {
+                    foundtitleidresource = true;
+                    if (debug) {
+                        printf("1st 2048 bytes of the title id resource:%s", newline);
+                        hexdump(resourcebuffer, 0, titleidresource_size > 2048 ? 2048 : titleidresource_size);
+                    }
+                    parsetitleidresource(resourcebuffer, titleidresource_size);
                 }
-                parsetitleidresource(defaultxexbuffer+codeoffset+titleidresource_relativeaddress, titleidresource_size);
             }
+            free(resourcebuffer);
         }
     }
     else if (xex_is_compressed) {
         // decompress it
-        m = 0;
-        n = codeoffset;
-        unsigned long compressedblock_realsize = 0;
-        unsigned short s = 0;
-        unsigned long p = 0;
-        unsigned long long defaultcab_totalsize = 0;
-        FILE *defaultcab = NULL, *defaultpe = NULL;
-        char defaultcabpath[2048], defaultpepath[2048];
-        memset(defaultcabpath, 0, 2048);
-        memset(defaultpepath, 0, 2048);
-        if (!homeless) {
-            strcat(defaultcabpath, homedir); strcat(defaultcabpath, abgxdir);
-            strcat(defaultpepath, homedir); strcat(defaultpepath, abgxdir);
-        }
-        strcat(defaultcabpath, "default.cab");
-        strcat(defaultpepath, "default.pe");
-        initcheckwrite();
-        defaultcab = fopen(defaultcabpath, "wb");
-        if (defaultcab == NULL) {
-            decompressionfailed = true;
+        struct memspack_buffer lzxcompressed, lzxdecompressed;
+        struct xexgather gather;
+        memset(&gather, 0, sizeof(struct xexgather));
+        gather.xs = &xs;
+        gather.threads = 1;
+        gather.address = codeoffset;
+        gather.size = compressedblock_size;
+        memcpy(gather.hash, compressedblock_hash, 20);
+        memset(&lzxcompressed, 0, sizeof(struct memspack_buffer));
+        memset(&lzxdecompressed, 0, sizeof(struct memspack_buffer));
+        // the lzx input only has to hold the segments of one block at a time, and a block has to fit in the window
+        lzxcompressed.capacity = (size_t) xexwindowsize;
+        lzxcompressed.data = (unsigned char *) malloc(lzxcompressed.capacity);
+        if (lzxcompressed.data == NULL) {
             color(red);
-            printf("ERROR: Failed to open %s%s%s for writing! (%s) Failed to decompress the Xex!%s",
-                    quotation, defaultcabpath, quotation, strerror(errno), newline);
+            printf("ERROR: memory allocation for lzxcompressed failed! Game over man... Game over!%s", newline);
             color(normal);
+          exit(1);
         }
-        else if (compressionwindow_bits == 0) {
+        if (compressionwindow_bits == 0) {
             decompressionfailed = true;
             color(red);
             printf("ERROR: Compression window size (%.3f KB) is invalid! Failed to decompress the Xex!%s",
                     (float) compressionwindow / 1024, newline);
             color(normal);
         }
-        else while(compressedblock_size) {
-            m++;
-            if (n + compressedblock_size > defaultxexsize) {
-                // the block would be extending past the end of the default.xex!
-                decompressionfailed = true;
-                color(red);
-                printf("ERROR: Compressed block #%lu is reporting an incorrect size! Failed to decompress the Xex!%s", m, newline);
-                if (debug) {
-                    printf("start address: 0x%lX%s", n, newline);
-                    printf("block size: %lu (0x%lX)%s", compressedblock_size, compressedblock_size, newline);
-                    printf("defaultxexsize: %lu (0x%lX)%s", defaultxexsize, defaultxexsize, newline);
-                    printf("hash expected: ");
-                    for (i=0;i<20;i++) printf("%02X", compressedblock_hash[i]);
-                    printf("%s", newline);
-                }
-                color(normal);
-              break;
-            }
-            sha1_starts(&ctx);
-            sha1_update(&ctx, defaultxexbuffer+n, compressedblock_size);
-            sha1_finish(&ctx, compressedblock_hash_calculated);
-            if (memcmp(compressedblock_hash, compressedblock_hash_calculated, 20) != 0) {
-                // expected hash doesn't match the calculated one
-                decompressionfailed = true;
-                color(red);
-                printf("ERROR: Compressed block #%lu is corrupt! Failed to decompress the Xex!%s", m, newline);
-                if (debug) {
-                    printf("start address: 0x%lX%s", n, newline);
-                    printf("block size: %lu (0x%lX)%s", compressedblock_size, compressedblock_size, newline);
-                    printf("hash expected: %s", sp2);
-                    for (i=0;i<20;i++) printf("%02X", compressedblock_hash[i]);
-                    printf("%shash calculated: ", newline);
-                    for (i=0;i<20;i++) printf("%02X", compressedblock_hash_calculated[i]);
-                    printf("%s", newline);
-                }
-                color(normal);
-              break;
-            }
-            else if (debug) {
-                printf("compressed block #%03lu is valid, address = 0x%07lX, size = %06lu (0x%06lX)%s",
-                        m, n, compressedblock_size, compressedblock_size, newline);
-            }
-            // write compressed data to default.cab
-            compressedblock_realsize = 0;
-            p = n+24;
-            i = 0;
-            while(1) {
-                i++;
-                s = getwordmsb(defaultxexbuffer+p);
-                if (s == 0) break;
-                else if (debug) printf("block segment #%02d size = %05u%s", i, s, newline);
-                compressedblock_realsize += s;
-                if (compressedblock_realsize > compressedblock_size) {
-                    // should never happen
-                    decompressionfailed = true;
-                    color(red);
-                    printf("ERROR: Compressed block #%lu has invalid parsing data! Failed to decompress the Xex!%s",
-                            m, newline);
-                    color(normal);
-                  break;
-                }
-                if (checkwriteandprinterrors(defaultxexbuffer+p+2, 1, (size_t) s, defaultcab, 0, defaultcab_totalsize, "default.cab", "Decompressing the Xex") != 0) {
-                    decompressionfailed = true;
-                  break;
-                }
-                p += s+2;
-                defaultcab_totalsize += (unsigned long long) s;
-            }
-            if (debug) printf("compressed block #%03lu real size = %06lu (0x%06lX)%s%s",
-                               m, compressedblock_realsize, compressedblock_realsize, newline, newline);
-            if (decompressionfailed) break;
-            // get info about the next block
-            memcpy(compressedblock_hash, defaultxexbuffer+n+4, 20);
-            n += compressedblock_size;
-            compressedblock_size = getuintmsb(defaultxexbuffer+n-compressedblock_size);
-        }
-        if (defaultcab != NULL) {
-            if (debug) printf("flushing defaultcab%s", newline);
-            fflush(defaultcab);
-        }
         if (!decompressionfailed) {
-            donecheckwrite("default.cab");
-            // decompress default.cab
-            struct mspack_system *sys = mspack_default_system;
+            // decompress lzxcompressed into lzxdecompressed, the blocks are walked a window at a time and their hashes
+            // are checked on the way into lzxcompressed (see gatherxexblock) while the ones at the front are already
+            // being decompressed
+            struct mspack_system *sys = memspack_system;
             struct mspack_file *lzxinput = NULL;
             struct mspack_file *lzxoutput = NULL;
             struct lzxd_stream *lzxd = NULL;
-            if (debug) printf("decompressing %s%s", defaultcabpath, newline);
-            lzxinput = sys->open(sys, defaultcabpath, MSPACK_SYS_OPEN_READ);
-            if (lzxinput == NULL) {
+            #ifndef WIN32
+                // the blocks are independent so use every cpu unless --crcthreads says otherwise
+                gather.threads = crcthreadsarg ? crcthreads : (int) sysconf(_SC_NPROCESSORS_ONLN);
+                if (gather.threads < 1) gather.threads = 1;
+            #endif
+            lzxcompressed.more = gatherxexblock;
+            lzxcompressed.morearg = &gather;
+            if (debug) printf("decompressing into %lu bytes with up to %d hashing thread%s%s", basefile_size,
+                              gather.threads, gather.threads > 1 ? "s" : "", newline);
+            // only the title id resource is kept out of the decompressed PE
+            lzxdecompressed.window = 1;
+            lzxdecompressed.offset = (size_t) titleidresource_relativeaddress;
+            lzxdecompressed.capacity = titleidresource_relativeaddress ? (size_t) titleidresource_size : 0;
+            lzxdecompressed.data = (unsigned char *) calloc(lzxdecompressed.capacity + 4, sizeof(char));
+            if (lzxdecompressed.data == NULL) {
+                color(red);
+                printf("ERROR: memory allocation for lzxdecompressed failed! Game over man... Game over!%s", newline);
+                color(normal);
+              exit(1);
+            }
+            if ((lzxinput = sys->open(sys, (char *) &lzxcompressed, MSPACK_SYS_OPEN_READ)) == NULL ||
+                (lzxoutput = sys->open(sys, (char *) &lzxdecompressed, MSPACK_SYS_OPEN_WRITE)) == NULL) {
                 decompressionfailed = true;
                 color(red);
-                printf("ERROR: libmspack failed to open %s%s%s for reading! (%s) Failed to decompress the Xex!%s",
-                       quotation, defaultcabpath, quotation, strerror(errno), newline);
+                printf("ERROR: libmspack failed to open the Xex buffers! Failed to decompress the Xex!%s", newline);
                 color(normal);
             }
             else {
-                lzxoutput = sys->open(sys, defaultpepath, MSPACK_SYS_OPEN_WRITE);
-                if (lzxoutput == NULL) {
+                lzxd = lzxd_init(sys, lzxinput, lzxoutput, compressionwindow_bits, 0, 32768, (off_t) basefile_size);
+                if (lzxd == NULL) {
                     decompressionfailed = true;
                     color(red);
-                    printf("ERROR: libmspack failed to open %s%s%s for writing! (%s) Failed to decompress the Xex!%s",
-                           quotation, defaultpepath, quotation, strerror(errno), newline);
+                    printf("ERROR: Initializing LZX decompression state failed! (%s) Failed to decompress the Xex!%s", strerror(errno), newline);
                     color(normal);
                 }
                 else {
-                    lzxd = lzxd_init(sys, lzxinput, lzxoutput, compressionwindow_bits, 0, 32768, (off_t) basefile_size);
-                    if (lzxd == NULL) {
+                    i = lzxd_decompress(lzxd, (off_t) basefile_size);
+                    // lzxd can be done before it has read every block, but they all still have to check out
+                    do lzxcompressed.size = 0; while (gatherxexblock(&lzxcompressed));
+                    if (gather.failed) {
+                        // and if one didn't, that's what lzxd ran out of input because of (and it's been explained)
+                        decompressionfailed = true;
+                    }
+                    else if (i != MSPACK_ERR_OK) {
                         decompressionfailed = true;
                         color(red);
-                        printf("ERROR: Initializing LZX decompression state failed! (%s) Failed to decompress the Xex!%s", strerror(errno), newline);
+                        if (debug) printf("lzxd_decompress returned: %d%s", i, newline);
+                        printf("ERROR: LZX decompression failed! (%s) Failed to decompress the Xex!%s", lzxstrerror(i), newline);
                         color(normal);
                     }
                     else {
-                        i = lzxd_decompress(lzxd, (off_t) basefile_size);
-                        if (i != MSPACK_ERR_OK) {
-                            decompressionfailed = true;
+                        if (debug) printf("decompression was successful%s", newline);
+                        unsigned long long defaultpesize = (unsigned long long) lzxdecompressed.size;
+                        if (debug) printf("defaultpesize = %"LL"u%s", defaultpesize, newline);
+                        if (defaultpesize != (unsigned long long) basefile_size) {
                             color(red);
-                            if (debug) printf("lzxd_decompress returned: %d%s", i, newline);
-                            printf("ERROR: LZX decompression failed! (%s) Failed to decompress the Xex!%s", lzxstrerror(i), newline);
+                            printf("ERROR: Decompressed PE filesize does not match the expected basefile size!%s", newline);
                             color(normal);
                         }
-                        else {
-                            if (debug) printf("decompression was successful%s", newline);
-                            // open default.pe and allocate memory for the title id resource
-                            defaultpe = fopen(defaultpepath, "rb");
-                            if (defaultpe == NULL) {
+                        else if (titleidresource_relativeaddress) {
+                            if ((unsigned long long) titleidresource_relativeaddress + titleidresource_size > defaultpesize) {
                                 color(red);
-                                printf("ERROR: Failed to open %s%s%s for reading! (%s) Failed to read the title id resource!%s",
-                                        quotation, defaultpepath, quotation, strerror(errno), newline);
+                                printf("ERROR: The Title ID Resource has an invalid address and/or size!%s", newline);
                                 color(normal);
                             }
-                            else {
-                                long long defaultpesize = getfilesize(defaultpe);
-                                if (debug) printf("defaultpesize = %"LL"d%s", defaultpesize, newline);
-                                if (defaultpesize != (long long) basefile_size) {
-                                    if (defaultpesize != -1) {
+                            else if (titleidresource_size >= 4) {
+                                // lzxdecompressed only kept the resource
+                                unsigned char *resourcebuffer = lzxdecompressed.data;
+                                if (memcmp(resourcebuffer, "XDBF", 4) != 0) {
+                                    if (debug || testing) {
                                         color(red);
-                                        printf("ERROR: Decompressed PE filesize does not match the expected basefile size!%s", newline);
+                                        printf("\"XDBF\" was not found at the start of the title id resource:%s", newline);
                                         color(normal);
+                                        hexdump(resourcebuffer, 0, titleidresource_size > 2048 ? 2048 : titleidresource_size);
                                     }
-                                    // if defaultpesize == -1 it's a seek error and error message has already been printed
                                 }
-                                else if (titleidresource_relativeaddress) {
-                                    if ((long long) (titleidresource_relativeaddress + titleidresource_size) > defaultpesize) {
-                                        color(red);
-                                        printf("ERROR: The Title ID Resource has an invalid address and/or size!%s", newline);
-                                        color(normal);
-                                    }
-                                    else {
-                                        if (fseeko(defaultpe, titleidresource_relativeaddress, SEEK_SET) != 0) {
-                                            printseekerror(defaultpepath, "Reading Title ID resource");
-                                        }
-                                        else if (titleidresource_size >= 4) {
-                                            unsigned char *resourcebuffer = malloc(titleidresource_size * sizeof(char));
-                                            if (resourcebuffer == NULL) {
-                                                color(red);
-                                                printf("ERROR: memory allocation for resourcebuffer failed! Game over man... Game over!%s", newline);
-                                                color(normal);
-                                              exit(1);
-                                            }
-                                            initcheckread();
-                                            if (checkreadandprinterrors(resourcebuffer, 1, titleidresource_size, defaultpe,
-                                                                        0, titleidresource_relativeaddress, defaultpepath,
-                                                                        "Reading Title ID resource") == 0) {
-                                                donecheckread(defaultpepath);
-                                                if (memcmp(resourcebuffer, "XDBF", 4) != 0) {
-                                                    if (debug || testing) {
-                                                        color(red);
-                                                        printf("\"XDBF\" was not found at the start of the title id resource:%s", newline);
-                                                        color(normal);
-                                                        hexdump(resourcebuffer, 0, 2048);
-                                                    }
-                                                }
-                                                else {
-                                                    foundtitleidresource = true;
-                                                    if (debug) {
-                                                        printf("1st 2048 bytes of the title id resource:%s", newline);
-                                                        hexdump(resourcebuffer, 0, titleidresource_size > 2048 ? 2048 : titleidresource_size);
-                                                    }
-                                                    parsetitleidresource(resourcebuffer, titleidresource_size);
-                                                }
-                                            }
-                                            free(resourcebuffer);
-                                        }
-                                        else if (debug || testing) {
-                                            color(yellow);
-                                            printf("ERROR: Title ID resource is only %lu bytes%s", titleidresource_size, newline);
-                                            color(normal);
-                                        }
+                                else {
+                                    foundtitleidresource = true;
+                                    if (debug) {
+                                        printf("1st 2048 bytes of the title id resource:%s", newline);
+                                        hexdump(resourcebuffer, 0, titleidresource_size > 2048 ? 2048 : titleidresource_size);
                                     }
+                                    parsetitleidresource(resourcebuffer, titleidresource_size);
                                 }
                             }
+                            else if (debug || testing) {
+                                color(yellow);
+                                printf("ERROR: Title ID resource is only %lu bytes%s", titleidresource_size, newline);
+                                color(normal);
+                            }
                         }
                     }
-                    if (lzxd != NULL) {
-                        if (debug) printf("freeing lzxd%s", newline);
-                        lzxd_free(lzxd);
-                    }
                 }
-                if (lzxoutput != NULL) {
-                    if (debug) printf("closing lzxoutput%s", newline);
-                    sys->close(lzxoutput);
+                if (lzxd != NULL) {
+                    if (debug) printf("freeing lzxd%s", newline);
+                    lzxd_free(lzxd);
                 }
             }
-            if (lzxinput != NULL) {
-                if (debug) printf("closing lzxinput%s", newline);
-                sys->close(lzxinput);
-            }
-        }
-        if (defaultcab != NULL) {
-            if (debug) printf("closing and removing default.cab%s", newline);
-            fclose(defaultcab);
-            remove(defaultcabpath);
-        }
-        if (defaultpe != NULL) {
-            if (debug) printf("closing and removing default.pe%s", newline);
-            fclose(defaultpe);
-            remove(defaultpepath);
+            if (lzxoutput != NULL) sys->close(lzxoutput);
+            if (lzxinput != NULL) sys->close(lzxinput);
+            // report any bad blocks even if decompression never got started
+            do lzxcompressed.size = 0; while (gatherxexblock(&lzxcompressed));
+            if (gather.failed) decompressionfailed = true;
+            if (gather.hashing) xexhash_finish(&gather.xh);
         }
+        free(gather.blocks);
+        free(lzxcompressed.data);
+        free(lzxdecompressed.data);
     }
+    // whatever wasn't needed still has to be read for the crc
+    getxexstream(&xs, defaultxexsize, 0);
+    closexexstream(&xs);
+    if (xs.failed) return 1;
+    donecheckread(filename);
+    check->xex_crc32 = xs.crc;
     if (verbose) {
-        printf("%sXEX CRC = %08lX%s", sp5, xex_crc32, newline);
+        printf("%sXEX CRC = %08lX%s", sp5, check->xex_crc32, newline);
         printf("%sXEX Media ID: ", sp5);
-        printmediaid(xex_mediaid);
+        printmediaid(check->xex_mediaid);
         printf("%s", newline);
     }
     if (!foundtitleidresource && (debug || testing)) {
@@ -16175,34 +17785,34 @@ int checkdefaultxex(unsigned char *defaultxexbuffer, unsigned long defaultxexsiz
         color(normal);
     }
 
-    if (checkgamecrcalways && !checkgamecrcnever) {
+    if (check->checkgamecrcalways && !check->checkgamecrcnever) {
         if (docheckgamecrc() == 0) {
-            if (corruptionoffsetcount == 0) {
+            if (check->corruptionoffsetcount == 0) {
                 color(green);
                 if (verbose) printf("%s", sp5);
                 printf("AnyDVD style corruption was not detected%s", newline);
                 color(normal);
             }
-            if (verbose) printf("%sGame CRC = %08lX%s", sp5, game_crc32, newline);
+            if (verbose) printf("%sGame CRC = %08lX%s", sp5, check->game_crc32, newline);
         }
         else {
-            checkgamecrcnever = true;
-            if (!usercancelledgamecrc) gamecrcfailed = true;
+            check->checkgamecrcnever = true;
+            if (!check->usercancelledgamecrc) check->gamecrcfailed = true;
         }
         if (!verbose) printf("%s", newline);
     }
     
     // display game name if a match is found in GameNameLookup.csv
-    checkcsv(xex_mediaid);
+    checkcsv(check->xex_mediaid);
     
     // the region code is at certoffset + 0x178
     if (debug) printf("%sdefault.xex region code address: 0x%lX%s", sp5, certoffset+0x178, newline);
-    for (i=0;i<4;i++) regioncode[i] = defaultxexbuffer[certoffset+0x178+i];
-    unsigned long regioncodelong = getuintmsb(regioncode) & 0xFFFFFFFF;
-    foundregioncode = true;
+    for (i=0;i<4;i++) check->regioncode[i] = defaultxexbuffer[certoffset+0x178+i];
+    unsigned long regioncodelong = getuintmsb(check->regioncode) & 0xFFFFFFFF;
+    check->foundregioncode = true;
     if (debug) printf("regioncode: 0x%02X%02X%02X%02X (unsigned chars), 0x%08lX (unsigned long)%s"
                       "userregion: 0x%08lX%s",
-                       regioncode[0], regioncode[1], regioncode[2], regioncode[3], regioncodelong, newline, userregion, newline);
+                       check->regioncode[0], check->regioncode[1], check->regioncode[2], check->regioncode[3], regioncodelong, newline, userregion, newline);
     if (verbose) printf("%s", newline);
     
     // highlight region code in green or red if user supplied their own region code
@@ -16246,118 +17856,136 @@ int checkdefaultxex(unsigned char *defaultxexbuffer, unsigned long defaultxexsiz
       return 0;
     }
     
-    if (regioncode[1] == 0xFF) {
+    if (check->regioncode[1] == 0xFF) {
         if (userregion) {
             if (userregion_ausnz || userregion_eur) color(green);
             else color(white);
         }
         printf("%sPAL%s", sp5, newline);
     }
-    else if (regioncode[1] == 0xFE) {
+    else if (check->regioncode[1] == 0xFE) {
         if (userregion) {
             if (userregion_eur) color(green);
             else color(white);
         }
         printf("%sPAL (Excludes AUS/NZ)%s", sp5, newline);
     }
-    else if (regioncode[1] == 0x01) {
+    else if (check->regioncode[1] == 0x01) {
         if (userregion) {
             if (userregion_ausnz) color(green);
             else color(white);
         }
         printf("%sPAL (AUS/NZ Only)%s", sp5, newline);
     }
-    else if (regioncode[1] != 0x00) {
+    else if (check->regioncode[1] != 0x00) {
         if (userregion) color(white);
-        printf("%sPAL (Unknown code: 0x%02X)%s", sp5, regioncode[1], newline);
+        printf("%sPAL (Unknown code: 0x%02X)%s", sp5, check->regioncode[1], newline);
     }
     
-    if (regioncode[2] == 0xFF) {
+    if (check->regioncode[2] == 0xFF) {
         if (userregion) {
             if (userregion_jpn || userregion_china || userregion_asia) color(green);
             else color(white);
         }
         printf("%sNTSC/J%s", sp5, newline);
     }
-    else if (regioncode[2] == 0xFD) {
+    else if (check->regioncode[2] == 0xFD) {
         if (userregion) {
             if (userregion_jpn || userregion_asia) color(green);
             else color(white);
         }
         printf("%sNTSC/J (Excludes China)%s", sp5, newline);
     }
-    else if (regioncode[2] == 0xFE) {
+    else if (check->regioncode[2] == 0xFE) {
         if (userregion) {
             if (userregion_china || userregion_asia) color(green);
             else color(white);
         }
         printf("%sNTSC/J (Excludes Japan)%s", sp5, newline);
     }
-    else if (regioncode[2] == 0xFC) {
+    else if (check->regioncode[2] == 0xFC) {
         if (userregion) {
             if (userregion_asia) color(green);
             else color(white);
         }
         printf("%sNTSC/J (Excludes Japan and China)%s", sp5, newline);
     }
-    else if (regioncode[2] == 0x01) {
+    else if (check->regioncode[2] == 0x01) {
         if (userregion) {
             if (userregion_jpn) color(green);
             else color(white);
         }
         printf("%sNTSC/J (Japan Only)%s", sp5, newline);
     }
-    else if (regioncode[2] == 0x02) {
+    else if (check->regioncode[2] == 0x02) {
         if (userregion) {
             if (userregion_china) color(green);
             else color(white);
         }
         printf("%sNTSC/J (China Only)%s", sp5, newline);
     }
-    else if (regioncode[2] == 0x03) {
+    else if (check->regioncode[2] == 0x03) {
         if (userregion) {
             if (userregion_jpn || userregion_china) color(green);
             else color(white);
         }
         printf("%sNTSC/J (Japan and China Only)%s", sp5, newline);
     }
-    else if (regioncode[2] != 0x00) {
+    else if (check->regioncode[2] != 0x00) {
         if (userregion) color(white);
-        printf("%sNTSC/J (Unknown code: 0x%02X)%s", sp5, regioncode[2], newline);
+        printf("%sNTSC/J (Unknown code: 0x%02X)%s", sp5, check->regioncode[2], newline);
     }
     
-    if (regioncode[3] == 0xFF) {
+    if (check->regioncode[3] == 0xFF) {
         if (userregion) {
             if (userregion_ntscu) color(green);
             else color(white);
         }
         printf("%sNTSC/U%s", sp5, newline);
     }
-    else if (regioncode[3] != 0x00) {
+    else if (check->regioncode[3] != 0x00) {
         if (userregion) color(white);
-        printf("%sNTSC/U (Unknown code: 0x%02X)%s", sp5, regioncode[3], newline);
+        printf("%sNTSC/U (Unknown code: 0x%02X)%s", sp5, check->regioncode[3], newline);
     }
     
-    if (regioncode[0] == 0xFF) {
+    if (check->regioncode[0] == 0xFF) {
         if (userregion) {
             if (userregion_other) color(green);
             else color(white);
         }
         printf("%sOther%s", sp5, newline);
     }
-    else if (regioncode[0] != 0x00) {
+    else if (check->regioncode[0] != 0x00) {
         if (userregion) color(white);
-        printf("%sOther (Unknown code: 0x%02X)%s", sp5, regioncode[0], newline);
+        printf("%sOther (Unknown code: 0x%02X)%s", sp5, check->regioncode[0], newline);
     }
     color(normal);
   return 0;
 }
 
+#ifndef WIN32
+// AnyDVD style corruption offsets found by one shard of a sharded game crc check
+struct shardcorruption {unsigned long long offset[100]; int count;};
+
+void findshardcorruption(void *arg, int shard, const unsigned char *data, size_t length, unsigned long long offset) {
+    struct shardcorruption *found = (struct shardcorruption *) arg + shard;
+    size_t n;
+    // same search as docheckgamecrc() does: "DVDVIDEO-" at the start of every sector
+    for (n=0;n+9<=length;n+=2048) {
+        if (memcmp(data+n, "DVDVIDEO-", 9) == 0 && found->count < 100) {
+            found->offset[found->count] = offset + n;
+            found->count++;
+        }
+    }
+  return;
+}
+#endif
+
 int docheckgamecrc() {
     int i, a;
     char letter;
     unsigned long m, n;
-    if (isotoosmall) {
+    if (check->isotoosmall) {
         color(red);
         printf("ERROR: ISO size is too small, Game CRC Check aborted!%s", newline);
         color(normal);
@@ -16365,15 +17993,30 @@ int docheckgamecrc() {
     }
     // check Game crc32
     // assume game partition size based on whether this is an xgd3 game
-    const unsigned long long gamesize = (xgd3 ? 8662351872LL : 7307001856LL);
+    const unsigned long long gamesize = (check->xgd3 ? 8662351872LL : 7307001856LL);
     const unsigned long gamesizeoverbuffer = (unsigned long) (gamesize / BIGBUF_SIZE);
-    game_crc32 = 0;
-    if (fseeko(fp, video, SEEK_SET) != 0) {
+    check->game_crc32 = 0;
+    #ifndef WIN32
+        loadresultcache();
+    #endif
+    if (!dvdarg && onepasshasrange(&check->onepassresults.game, check->video, check->video + gamesize)) {
+        // the single pass scan (or the result cache) already read the game partition
+        check->game_crc32 = check->onepassresults.game.crc;
+        check->corruptionoffsetcount = check->onepassresults.corruptionoffsetcount;
+        memcpy(check->corruptionoffset, check->onepassresults.corruptionoffset, sizeof(check->corruptionoffset));
+        #ifndef WIN32
+            cachegameresult(check->video, check->video + gamesize);
+        #endif
+        printcorruptionoffsets();
+      return 0;
+    }
+    if (fseeko(check->fp, check->video, SEEK_SET) != 0) {
         color(red);
         printf("ERROR: Failed to seek to new file position! (%s) Game CRC Check failed!%s", strerror(errno), newline);
         color(normal);
       return 1;
     }
+    if (debug) printf("CRC-32 implementation: %s%s", crc32_implementation(), newline);
     printstderr = true; color(white);
     if (verbose) fprintf(stderr, "\n");
     fprintf(stderr, "Checking Game CRC...");
@@ -16417,15 +18060,53 @@ int docheckgamecrc() {
         struct timeval currenttime;
         gettimeofday(&starttime, NULL);
         unsigned long startmsecs = starttime.tv_sec * 1000 + starttime.tv_usec / 1000;
+        // a reader thread fills a ring of large buffers while we do the crc and corruption scan on this thread,
+        // or if --crcthreads was used, shard threads do all of the reading and hashing and we just follow their progress
+        struct readahead ra;
+        struct readahead_block *rablock = NULL;
+        size_t rapos = 0;
+        struct shardcrc sc;
+        struct shardcorruption *shardcorruption = NULL;
+        struct shardcrc_shard *failedshard = NULL;
+        // chunk CRCs for --manifest are built here instead of the game crc (which is then combined from them),
+        // the shards would each need to start on a chunk boundary so --crcthreads isn't used for this
+        struct chunkmanifest_region *gamechunks = startmanifestregion("game", check->fp, check->video, check->video + gamesize);
+        bool sharded = (crcthreads > 1 && !dvdarg && gamechunks == NULL), shardsdone = false;
+        unsigned long long shardbytesdone = 0;
+        unsigned long shardretries = 0, shardrecovered = 0;
+        memset(&ra, 0, sizeof(struct readahead));
+        if (sharded) {
+            shardcorruption = (struct shardcorruption *) calloc(crcthreads, sizeof(struct shardcorruption));
+            if (shardcorruption == NULL) {
+                color(normal); printstderr = false;
+                color(red); printf("ERROR: Memory allocation for shardcorruption failed! Game over man... Game over!%s", newline); color(normal);
+              exit(1);
+            }
+            returnvalue = shardcrc_start(&sc, fileno(check->fp), check->video, gamesize, crcthreads, BIGBUF_SIZE, readretries,
+                                         findshardcorruption, shardcorruption);
+        }
+        else returnvalue = readahead_start(&ra, fileno(check->fp), check->video, gamesize, BIGBUF_SIZE, readretries, &check->readsettings);
+        if (returnvalue != 0) {
+            fprintf(stderr, "\n");
+            color(normal); printstderr = false;
+            color(red); printf("ERROR: Failed to start reading the game partition! Game CRC Check failed!%s", newline); color(normal);
+            free(shardcorruption);
+            close_keyboard();
+          return 1;
+        }
+        if (debug && !sharded) printf("Reading with %s, queue depth %d%s", readahead_backend(&ra), ra.queuedepth, newline);
     #endif
-    corruptionoffsetcount = 0;
-    for (i=0;i<100;i++) corruptionoffset[i] = 0;
+    unsigned char *gamebuffer = check->bigbuffer;
+    check->corruptionoffsetcount = 0;
+    for (i=0;i<100;i++) check->corruptionoffset[i] = 0;
     if (verbose) charsprinted = fprintf(stderr, "                                                           ");
     else charsprinted = 0;
-    readerrorcharsprinted = 0;
+    check->readerrorcharsprinted = 0;
     unsigned long long totalbytesread = 0LL;
     unsigned long long lasttotalbytesread = 0LL;
-    unsigned long long gamecrcoffset;
+    #ifdef WIN32
+        unsigned long long gamecrcoffset;
+    #endif
     float MBpsavg = 0, MBpscur = 0, MBpsrunningavg = 0;
     unsigned long etasecs, elapsedsecs = 0, leftsecs;
     unsigned long gamereaderrorstotal = 0, gamereaderrorsrecovered = 0;
@@ -16442,11 +18123,16 @@ int docheckgamecrc() {
                 fprintf(stderr, "\n");
                 color(normal);
                 printstderr = false;
-                game_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
+                check->game_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
                 #ifndef WIN32
+                    if (sharded) {
+                        shardcrc_cancel(&sc);
+                        free(shardcorruption);
+                    }
+                    else readahead_stop(&ra);
                     close_keyboard();
                 #endif
-                usercancelledgamecrc = true;
+                check->usercancelledgamecrc = true;
               return 1;
             }
         }
@@ -16474,8 +18160,8 @@ int docheckgamecrc() {
             etasecs = (currentmsecs - startmsecs) / 1000 + (unsigned long) ( (gamesize - totalbytesread) / 1048576 / MBpsrunningavg );
             elapsedsecs = (currentmsecs - startmsecs) / 1000;
             leftsecs = etasecs - elapsedsecs;
-            for (i=0;i<charsprinted+readerrorcharsprinted;i++) fprintf(stderr, "\b");
-            if (readerrorcharsprinted) color(white);
+            for (i=0;i<charsprinted+check->readerrorcharsprinted;i++) fprintf(stderr, "\b");
+            if (check->readerrorcharsprinted) color(white);
             if (verbose) {
                 if (leftsecs / 60 > 999) // not enough space for time left
                     charsprinted = fprintf(stderr, "    %3lu%% %5lu:%02lu %7lu:%02lu ???:?? %6.1f MB/s %6.1f MB/s",
@@ -16492,22 +18178,22 @@ int docheckgamecrc() {
                                                    MBpsavg, MBpscur);
             }
             else {
-                for (i=0;i<charsprinted+readerrorcharsprinted;i++) fprintf(stderr, " ");
-                for (i=0;i<charsprinted+readerrorcharsprinted;i++) fprintf(stderr, "\b");
+                for (i=0;i<charsprinted+check->readerrorcharsprinted;i++) fprintf(stderr, " ");
+                for (i=0;i<charsprinted+check->readerrorcharsprinted;i++) fprintf(stderr, "\b");
                 charsprinted = fprintf(stderr, "%3lu%% Done, Current Speed: %.1f MB/s, Time Left: %lu:%02lu",
                                                 m / (gamesizeoverbuffer / 100), MBpscur, leftsecs / 60, leftsecs % 60);
             }
-            readerrorcharsprinted = 0;
+            check->readerrorcharsprinted = 0;
             lastmsecs = currentmsecs;
             lasttotalbytesread = totalbytesread;
         }
         if (dvdarg) {
             #ifdef WIN32
-                gamecrcoffset = (unsigned long long) m * BIGBUF_SIZE + video;
+                gamecrcoffset = (unsigned long long) m * BIGBUF_SIZE + check->video;
                 if (gamecrcoffset % 2048) {  // don't think this would ever happen (would have been caught earlier) but check anyway
                     fprintf(stderr, "\n");
                     color(normal); printstderr = false;
-                    game_crc32 = 0;  // reset to 0 so we don't try to verify a bad crc
+                    check->game_crc32 = 0;  // reset to 0 so we don't try to verify a bad crc
                     color(red); printf("ERROR: gamecrcoffset does not fall on the start of a sector%s", newline); color(normal);
                   return 1;
                 }
@@ -16520,19 +18206,19 @@ int docheckgamecrc() {
                 cdb[4] = (UCHAR) ((LBA & 0x0000FF00L) >> 8);
                 cdb[5] = (UCHAR) (LBA & 0x000000FFL);
                 // 7-8 = transfer length (blocks) MSB-LSB (set earlier)
-                if (sendcdb(DATA_IN, bigbuffer, BIGBUF_SIZE, cdb, 10, true)) {
+                if (sendcdb(DATA_IN, check->bigbuffer, BIGBUF_SIZE, cdb, 10, true)) {
                     color(yellow);
                     for (i=0;i<readretries;i++) {
                         gamereaderrorstotal++;
                         if (verbose) {
-                            for(a=0;a<readerrorcharsprinted;a++) fprintf(stderr, "\b");
-                            readerrorcharsprinted = fprintf(stderr, "   %8lu %8lu", gamereaderrorsrecovered, gamereaderrorstotal);
+                            for(a=0;a<check->readerrorcharsprinted;a++) fprintf(stderr, "\b");
+                            check->readerrorcharsprinted = fprintf(stderr, "   %8lu %8lu", gamereaderrorsrecovered, gamereaderrorstotal);
                         }
-                        if (sendcdb(DATA_IN, bigbuffer, BIGBUF_SIZE, cdb, 10, true) == 0) {
+                        if (sendcdb(DATA_IN, check->bigbuffer, BIGBUF_SIZE, cdb, 10, true) == 0) {
                             gamereaderrorsrecovered++;
                             if (verbose) {
-                                for(a=0;a<readerrorcharsprinted;a++) fprintf(stderr, "\b");
-                                readerrorcharsprinted = fprintf(stderr, "   %8lu %8lu", gamereaderrorsrecovered, gamereaderrorstotal);
+                                for(a=0;a<check->readerrorcharsprinted;a++) fprintf(stderr, "\b");
+                                check->readerrorcharsprinted = fprintf(stderr, "   %8lu %8lu", gamereaderrorsrecovered, gamereaderrorstotal);
                             }
                             goto gamecrc1;
                         }
@@ -16540,7 +18226,7 @@ int docheckgamecrc() {
                     // unrecovered error
                     color(normal); printstderr = false;
                     color(red); printf("%sERROR: Unrecoverable read error while checking the Game CRC!%s", newline, newline); color(normal);
-                    game_crc32 = 0;  // reset to 0 so we don't try to verify a bad crc
+                    check->game_crc32 = 0;  // reset to 0 so we don't try to verify a bad crc
                   return 1;
                 }
             #else
@@ -16548,42 +18234,38 @@ int docheckgamecrc() {
                 color(normal); printstderr = false;
                 color(red); printf("ERROR: WTF? WIN32 not defined but somehow dvdarg was set?%s", newline); color(normal);
                 if (debug) printf("dvdarg = %d%s", dvdarg, newline);
-                game_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
+                check->game_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
+                readahead_stop(&ra);
                 close_keyboard();
               return 1;
             #endif
         }
-        else if (fread(bigbuffer, 1, BIGBUF_SIZE, fp) < BIGBUF_SIZE) {
+        #ifdef WIN32
+        else if (fread(check->bigbuffer, 1, BIGBUF_SIZE, check->fp) < BIGBUF_SIZE) {
             color(yellow);
-            if (feof(fp)) {
+            if (feof(check->fp)) {
                 color(normal); printstderr = false;
                 color(red); printf("%sERROR: End of File reached while checking the Game CRC, operation aborted!%s", newline, newline); color(normal);
-                game_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
-                #ifndef WIN32
-                    close_keyboard();
-                #endif
+                check->game_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
               return 1;
             }
-            gamecrcoffset = (unsigned long long) m * BIGBUF_SIZE + video;
+            gamecrcoffset = (unsigned long long) m * BIGBUF_SIZE + check->video;
             for (i=0;i<readretries;i++) {
                 gamereaderrorstotal++;
                 if (verbose) {
-                    for(a=0;a<readerrorcharsprinted;a++) fprintf(stderr, "\b");
-                    readerrorcharsprinted = fprintf(stderr, "   %8lu %8lu", gamereaderrorsrecovered, gamereaderrorstotal);
+                    for(a=0;a<check->readerrorcharsprinted;a++) fprintf(stderr, "\b");
+                    check->readerrorcharsprinted = fprintf(stderr, "   %8lu %8lu", gamereaderrorsrecovered, gamereaderrorstotal);
                 }
-                if (fseeko(fp, gamecrcoffset, SEEK_SET) != 0) {
+                if (fseeko(check->fp, gamecrcoffset, SEEK_SET) != 0) {
                     color(red); printf("ERROR: Failed to seek to new file position! (%s) Game CRC Check failed!%s", strerror(errno), newline); color(normal);
-                    game_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
-                    #ifndef WIN32
-                        close_keyboard();
-                    #endif
+                    check->game_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
                   return 1;
                 }
-                if (fread(bigbuffer, 1, BIGBUF_SIZE, fp) == BIGBUF_SIZE) {
+                if (fread(check->bigbuffer, 1, BIGBUF_SIZE, check->fp) == BIGBUF_SIZE) {
                     gamereaderrorsrecovered++;
                     if (verbose) {
-                        for(a=0;a<readerrorcharsprinted;a++) fprintf(stderr, "\b");
-                        readerrorcharsprinted = fprintf(stderr, "   %8lu %8lu", gamereaderrorsrecovered, gamereaderrorstotal);
+                        for(a=0;a<check->readerrorcharsprinted;a++) fprintf(stderr, "\b");
+                        check->readerrorcharsprinted = fprintf(stderr, "   %8lu %8lu", gamereaderrorsrecovered, gamereaderrorstotal);
                     }
                     goto gamecrc1;
                 }
@@ -16591,21 +18273,82 @@ int docheckgamecrc() {
             // unrecovered error
             color(normal); printstderr = false;
             color(red); printf("%sERROR: Unrecoverable read error while checking the Game CRC!%s", newline, newline); color(normal);
-            game_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
-            #ifndef WIN32
-                close_keyboard();
-            #endif
+            check->game_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
           return 1;
         }
+        #else
+        else if (sharded) {
+            // wait until the shards have read at least as much as we've counted so far
+            while ((unsigned long long) (m + 1) * BIGBUF_SIZE > shardbytesdone && !shardsdone) {
+                shardsdone = shardcrc_wait(&sc, 50, &shardbytesdone, &shardretries, &shardrecovered);
+                if (shardretries != gamereaderrorstotal) {
+                    color(yellow);
+                    gamereaderrorstotal = shardretries;
+                    gamereaderrorsrecovered = shardrecovered;
+                    if (verbose) {
+                        for(a=0;a<check->readerrorcharsprinted;a++) fprintf(stderr, "\b");
+                        check->readerrorcharsprinted = fprintf(stderr, "   %8lu %8lu", gamereaderrorsrecovered, gamereaderrorstotal);
+                    }
+                }
+            }
+            // a shard stopped early because of an error, shardcrc_finish() below will tell us which one
+            if ((unsigned long long) (m + 1) * BIGBUF_SIZE > shardbytesdone) break;
+          continue;
+        }
+        else {
+            // take the next BIGBUF_SIZE bytes from the read-ahead ring
+            if (rablock == NULL || rapos == rablock->length) {
+                if (rablock != NULL) readahead_release(&ra);
+                rablock = readahead_next(&ra);
+                rapos = 0;
+                if (rablock != NULL && rablock->retries) {
+                    color(yellow);
+                    gamereaderrorstotal += rablock->retries;
+                    gamereaderrorsrecovered += rablock->recovered;
+                    if (verbose) {
+                        for(a=0;a<check->readerrorcharsprinted;a++) fprintf(stderr, "\b");
+                        check->readerrorcharsprinted = fprintf(stderr, "   %8lu %8lu", gamereaderrorsrecovered, gamereaderrorstotal);
+                    }
+                }
+            }
+            if (rablock == NULL || rapos + BIGBUF_SIZE > rablock->length) {
+                color(normal); printstderr = false;
+                if (rablock == NULL || rablock->status == READAHEAD_EOF) {
+                    color(red); printf("%sERROR: End of File reached while checking the Game CRC, operation aborted!%s", newline, newline); color(normal);
+                }
+                else {
+                    color(red); printf("%sERROR: Unrecoverable read error while checking the Game CRC!%s", newline, newline); color(normal);
+                    if (debug) printf("read error at 0x%"LL"X (%s)%s", rablock->offset + rablock->length, strerror(rablock->error), newline);
+                }
+                check->game_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
+                readahead_stop(&ra);
+                close_keyboard();
+              return 1;
+            }
+            gamebuffer = rablock->hole ? NULL : rablock->data + rapos;
+            rapos += BIGBUF_SIZE;
+        }
+        #endif
+        #ifdef WIN32
         gamecrc1:
-        game_crc32 = crc32(game_crc32, bigbuffer, BIGBUF_SIZE);
+            check->game_crc32 = crc32_fast(check->game_crc32, gamebuffer, BIGBUF_SIZE);
+        #else
+            if (gamebuffer == NULL) {
+                // a hole in a sparse file is all zeroes, nothing to read or search
+                if (gamechunks != NULL) chunkmanifest_update(gamechunks, NULL, BIGBUF_SIZE);
+                else check->game_crc32 = crc32_zeros(check->game_crc32, BIGBUF_SIZE);
+              continue;
+            }
+            if (gamechunks != NULL) chunkmanifest_update(gamechunks, gamebuffer, BIGBUF_SIZE);
+            else check->game_crc32 = crc32_fast(check->game_crc32, gamebuffer, BIGBUF_SIZE);
+        #endif
         // AnyDVD and other apps insert dvd video files into unreadable sectors to defeat sony arccos protection
         // so we'll search for "DVDVIDEO-" (DVDVIDEO-VTS and DVDVIDEO-VMG have been observed) at the start of every sector in the game data
         for (n=0;n<BIGBUF_SIZE - 9;n+=2048) {
-            if (memcmp(bigbuffer+n, "DVDVIDEO-", 9) == 0) {
-                if (corruptionoffsetcount < 100) {
-                    corruptionoffset[corruptionoffsetcount] = (unsigned long long) m * BIGBUF_SIZE + (unsigned long long) video + (unsigned long long) n;
-                    corruptionoffsetcount++;
+            if (memcmp(gamebuffer+n, "DVDVIDEO-", 9) == 0) {
+                if (check->corruptionoffsetcount < 100) {
+                    check->corruptionoffset[check->corruptionoffsetcount] = (unsigned long long) m * BIGBUF_SIZE + (unsigned long long) check->video + (unsigned long long) n;
+                    check->corruptionoffsetcount++;
                 }
             }
         }
@@ -16615,34 +18358,72 @@ int docheckgamecrc() {
 /*  if (gamesize % BIGBUF_SIZE > 0) {
         unsigned long gameremainder = gamesize % BIGBUF_SIZE;
         fread(bigbuffer, 1, gameremainder, fp);
-        game_crc32 = crc32(game_crc32, bigbuffer, gameremainder);
+        game_crc32 = crc32_fast(game_crc32, bigbuffer, gameremainder);
     }  */
+    #ifndef WIN32
+        if (sharded) {
+            returnvalue = shardcrc_finish(&sc, &check->game_crc32, &failedshard);
+            if (returnvalue != READAHEAD_OK) {
+                color(normal); printstderr = false;
+                if (returnvalue == READAHEAD_EOF) {
+                    color(red); printf("%sERROR: End of File reached while checking the Game CRC, operation aborted!%s", newline, newline); color(normal);
+                }
+                else {
+                    color(red); printf("%sERROR: Unrecoverable read error while checking the Game CRC!%s", newline, newline); color(normal);
+                    if (debug) printf("read error at 0x%"LL"X (%s)%s", failedshard->erroroffset, strerror(failedshard->error), newline);
+                }
+                check->game_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
+                free(shardcorruption);
+                close_keyboard();
+              return 1;
+            }
+            // the shards are in file order so their corruption offsets are too
+            for (i=0;i<sc.numshards;i++) {
+                for (a=0;a<shardcorruption[i].count && check->corruptionoffsetcount < 100;a++) {
+                    check->corruptionoffset[check->corruptionoffsetcount] = shardcorruption[i].offset[a];
+                    check->corruptionoffsetcount++;
+                }
+            }
+            free(shardcorruption);
+        }
+        else readahead_stop(&ra);
+        if (gamechunks != NULL) check->game_crc32 = chunkmanifest_crc(gamechunks);
+    #endif
     fprintf(stderr, "\n");
     color(normal); printstderr = false; color(normal);
-    if (corruptionoffsetcount) {
+    #ifndef WIN32
+        cachegameresult(check->video, check->video + gamesize);
+    #endif
+    printcorruptionoffsets();
+    #ifndef WIN32
+        close_keyboard();
+    #endif
+  return 0;
+}
+
+void printcorruptionoffsets() {
+    int i;
+    if (check->corruptionoffsetcount) {
         if (verbose) printf("%s", newline);
         color(red);
-        printf("Found AnyDVD style game data corruption starting at %d", corruptionoffsetcount);
-        if (corruptionoffsetcount > 1) printf(" different offsets!");
+        printf("Found AnyDVD style game data corruption starting at %d", check->corruptionoffsetcount);
+        if (check->corruptionoffsetcount > 1) printf(" different offsets!");
         else printf(" offset!");
-        if (corruptionoffsetcount > 99) printf(" (stopped counting at 100)");
+        if (check->corruptionoffsetcount > 99) printf(" (stopped counting at 100)");
         color(normal);
         printf("%s", newline);
         if (verbose) {
             printf("AnyDVD style corruption was found at: ");
-            for (i=0;i<corruptionoffsetcount;i++) {
-                printf("0x%09"LL"X", corruptionoffset[i]);
-                if (i+2 < corruptionoffsetcount) printf(", ");
-                else if (i+1 < corruptionoffsetcount) printf(" and ");
+            for (i=0;i<check->corruptionoffsetcount;i++) {
+                printf("0x%09"LL"X", check->corruptionoffset[i]);
+                if (i+2 < check->corruptionoffsetcount) printf(", ");
+                else if (i+1 < check->corruptionoffsetcount) printf(" and ");
             }
             printf("%s%s", newline, newline);
         }
     }
     else if (verbose) fprintf(stderr, "\n");
-    #ifndef WIN32
-        close_keyboard();
-    #endif
-  return 0;
+  return;
 }
 
 bool lookslike360ss(unsigned char *ss) {
@@ -16714,61 +18495,61 @@ int checkss() {
     int foundangle359_count = 0;
     
     // make sure to update valid_ssv2_exists_in_db() if you add more global vars to this function so that the original values can be preserved
-    ss_stealthfailed = false;
-    ss_stealthuncertain = false;
-    ss_foundtimestamp = false;
-    fixedss = false;
-    drtfucked = false;
-    ssv2 = false;
-    ss_replay_table_offset = 0;
-    ss_replay_table_length = 0;
-    ss_crc32 = 0;
-    ss_rawcrc32 = 0;
-    ss_authored = 0;
-    ss_staticcrc32 = 0;
-    ss_num_angles = 0;
-    ss_num_targets = 0;
+    check->ss_stealthfailed = false;
+    check->ss_stealthuncertain = false;
+    check->ss_foundtimestamp = false;
+    check->fixedss = false;
+    check->drtfucked = false;
+    check->ssv2 = false;
+    check->ss_replay_table_offset = 0;
+    check->ss_replay_table_length = 0;
+    check->ss_crc32 = 0;
+    check->ss_rawcrc32 = 0;
+    check->ss_authored = 0;
+    check->ss_staticcrc32 = 0;
+    check->ss_num_angles = 0;
+    check->ss_num_targets = 0;
     for (i=0;i<4;i++) {
-        ss_angleaddresses[i] = 0;
-        ss_targets[i] = 0;
+        check->ss_angleaddresses[i] = 0;
+        check->ss_targets[i] = 0;
     }
     
     if (verbose && !minimal) printf("Checking SS%s", newline);
     // make sure ss isn't blank
-    if (getzeros(ss, 0, 2047) == 2048) {
-        ss_stealthfailed = true;
+    if (zeroscan_allzeros(check->ss, 2048)) {
+        check->ss_stealthfailed = true;
         color(red);
         printf("SS is blank!%s", newline);
         color(normal);
       return 1;
     }
-    if (!lookslike360ss(ss)) {
-        if (lookslikexbox1ss(ss)) {
-            stealthuncertain = true;
-            ss_stealthuncertain = true;
+    if (!lookslike360ss(check->ss)) {
+        if (lookslikexbox1ss(check->ss)) {
+            check->stealthuncertain = true;
+            check->ss_stealthuncertain = true;
             color(yellow);
             printf("This looks like an original Xbox SS!%s", newline);
             color(normal);
           return 2;
         }
         else {
-            ss_stealthfailed = true;
+            check->ss_stealthfailed = true;
             color(red);
             printf("SS is not recognized as an Xbox 360 or even an original Xbox SS!%s", newline);
             color(normal);
             if (verbose) {
                 printf("Displaying suspicious data in hex and ascii:%s", newline);
-                hexdump(ss, 0, 2048);
+                hexdump(check->ss, 0, 2048);
             }
           return 1;
         }
     }
     
-    if      (memcmp(ss, "\xE1\x0F\x31\x10\x00\x04\xFB\x20\x00\xFB\x04\xDF\x00\x20\x33\x9F", 16) == 0) ss_replay_table_offset = 0x200; // XGD2
-    else if (memcmp(ss, "\xE1\x0F\x31\x10\x00\x03\x41\x00\x00\xFC\xAE\xFF\x00\x23\x8E\x0F", 16) == 0) ss_replay_table_offset = 0x20;  // XGD3
+    if      (memcmp(check->ss, "\xE1\x0F\x31\x10\x00\x04\xFB\x20\x00\xFB\x04\xDF\x00\x20\x33\x9F", 16) == 0) check->ss_replay_table_offset = 0x200; // XGD2
+    else if (memcmp(check->ss, "\xE1\x0F\x31\x10\x00\x03\x41\x00\x00\xFC\xAE\xFF\x00\x23\x8E\x0F", 16) == 0) check->ss_replay_table_offset = 0x20;  // XGD3
     else {
         // unknown XGD type
-        ss_replay_table_offset = 0x20; // have to use something... there will be obvious c/r data errors if this is wrong
+        check->ss_replay_table_offset = 0x20; // have to use something... there will be obvious c/r data errors if this is wrong
         if (debug) {
             color(red);
             printf("ERROR: Unknown XGD type!%s", newline);
@@ -16776,37 +18557,37 @@ int checkss() {
         }
     }
     
-    if (layerbreak == -1) {
+    if (check->layerbreak == -1) {
         // we're probably checking just an ss.bin
         // assume the layerbreak based on replay table offset
-        if (ss_replay_table_offset == 0x200) layerbreak = 1913760;
-        else                                 layerbreak = 2133520;
-        if (debug) printf("layerbreak (%ld) assumed based on ss_replay_table_offset (0x%X)%s", layerbreak, ss_replay_table_offset, newline);
+        if (check->ss_replay_table_offset == 0x200) check->layerbreak = 1913760;
+        else                                 check->layerbreak = 2133520;
+        if (debug) printf("layerbreak (%ld) assumed based on ss_replay_table_offset (0x%X)%s", check->layerbreak, check->ss_replay_table_offset, newline);
     }
     
     // get Starting PSN of Data Area
-    unsigned char ss_startpsnL0hex[4] = {ss[7], ss[6], ss[5], 0x00};
+    unsigned char ss_startpsnL0hex[4] = {check->ss[7], check->ss[6], check->ss[5], 0x00};
     unsigned long ss_startpsnL0 = getuint(ss_startpsnL0hex);
 
     // get End PSN of L0 Data Area
-    unsigned char ss_endpsnL0hex[4] = {ss[15], ss[14], ss[13], 0x00};
+    unsigned char ss_endpsnL0hex[4] = {check->ss[15], check->ss[14], check->ss[13], 0x00};
     unsigned long ss_endpsnL0 = getuint(ss_endpsnL0hex);
 
     // invert bits in End PSN of L0 Data Area to find Starting PSN of L1 Data Area
-    unsigned char ss_startpsnL1hex[4] = {~ss[15], ~ss[14], ~ss[13], 0x00};
+    unsigned char ss_startpsnL1hex[4] = {~check->ss[15], ~check->ss[14], ~check->ss[13], 0x00};
     unsigned long ss_startpsnL1 = getuint(ss_startpsnL1hex);
 
     // get End PSN of L1 Data Area
-    unsigned char ss_endpsnL1hex[4] = {ss[11], ss[10], ss[9], 0x00};
+    unsigned char ss_endpsnL1hex[4] = {check->ss[11], check->ss[10], check->ss[9], 0x00};
     unsigned long ss_endpsnL1 = getuint(ss_endpsnL1hex);
 
     // here be dragons
-    int32_t layerbreakpsn = ~((layerbreak - 1 + 0x030000) ^ 0xFF000000);
+    int32_t layerbreakpsn = ~((check->layerbreak - 1 + 0x030000) ^ 0xFF000000);
     unsigned long ss_sectorsL0 = ss_endpsnL0 - ss_startpsnL0 + 1;
     unsigned long ss_sectorsL1 = ss_endpsnL1 - ss_startpsnL1 + 1;
     unsigned long long ss_offsetL0 = ((unsigned long long) ss_startpsnL0 - 0x030000) * 2048;
     unsigned long long ss_offsetL1 = ((unsigned long long) ss_startpsnL1 - (unsigned long long) layerbreakpsn) * 2048 +
-                                     ((unsigned long long) layerbreak * 2048);
+                                     ((unsigned long long) check->layerbreak * 2048);
     unsigned long long ss_offsetL0end = (unsigned long long) (ss_endpsnL0 - ss_startpsnL0 + 1) * 2048 + ss_offsetL0 - 1;
     unsigned long long ss_offsetend = (unsigned long long) (ss_endpsnL1 - ss_startpsnL1 + 1) * 2048 + ss_offsetL1 - 1;
     unsigned long ss_sectorstotal = ss_sectorsL0 + ss_sectorsL1;
@@ -16817,53 +18598,46 @@ int checkss() {
     
     // check for BCA (Burst Cutting Area) flag which indicates a unique barcode is
     // burned onto the original disc (but would any xbox 360 drives be able to read it?)
-    if ((ss[16] & 0x80) == 0x80) {
-        stealthuncertain = true;
+    if ((check->ss[16] & 0x80) == 0x80) {
+        check->stealthuncertain = true;
         color(yellow);
         printf("SS BCA flag is on!%s", newline);
         color(normal);
     }
 
     // get timestamps of authoring and mastering
-    ss_authored = getuint64(ss+0x49F);
-    unsigned long long ss_mastered = getuint64(ss+0x5DF);
-    ss_foundtimestamp = true;
+    check->ss_authored = getuint64(check->ss+0x49F);
+    unsigned long long ss_mastered = getuint64(check->ss+0x5DF);
+    check->ss_foundtimestamp = true;
     if (verbose) {
         printf("%sTimestamp of Authoring: ", sp5);
-        printwin32filetime(ss_authored);
+        printwin32filetime(check->ss_authored);
         printf("%s%sTimestamp of Mastering: ", newline, sp5);
         printwin32filetime(ss_mastered);
         printf("%s", newline);
     }
     // decrypt the crypted challenge response table (ccrt) and store it as dcrt
-    int num_entries = (int) ss[0x301];
+    int num_entries = (int) check->ss[0x301];
     if (debug) printf("num_entries = %d%s", num_entries, newline);
     if (num_entries != 21) {
         color(yellow);
         printf("WTF? CCRT reports %d entries, expected 21! CCRT decryption might be incorrect!%s", num_entries, newline);
         color(normal);
     }
-    int j, Nr;
+    int j;
     unsigned char dcrt[252];
     memset(dcrt, 0, 252);
-    u32 rk[4*(MAXNR + 1)];
     const u8 cipherKey[16] = {0xD1,0xE3,0xB3,0x3A,0x6C,0x1E,0xF7,0x70,0x5F,0x6D,0xE9,0x3B,0xB6,0xC0,0xDC,0x71};
-    u8 ct[16], pt[16], ivec[16];
+    u8 ivec[16];
     memset(ivec, 0, 16);
-    Nr = rijndaelKeySetupDec(rk, cipherKey, 128);
-    for (i=0;i<15;i++) {
-        memcpy(ct, ss+(0x304+(i*16)), 16);
-        rijndaelDecrypt(rk, Nr, ct, pt);
-        for (j=0;j<16;j++) pt[j] ^= ivec[j];
-        memcpy(ivec, ct, 16);
-        memcpy(dcrt+(i*16), pt, 16);
-    }
-    memcpy(dcrt+240, ss+0x3F4, 12);
+    memcpy(dcrt, check->ss+0x304, 240);
+    aescbc_decrypt128(cipherKey, ivec, dcrt, 240, 1);
+    memcpy(dcrt+240, check->ss+0x3F4, 12);
     if (debug) {
         printf("ccrt:");
         for (i=0x304;i<0x400;i++) {
             if ((i-0x304) % 12 == 0) printf("%s", newline);
-            printf("%02X", ss[i]);
+            printf("%02X", check->ss[i]);
         }
         printf("%s", newline);
         printf("dcrt:");
@@ -16910,16 +18684,16 @@ int checkss() {
     struct {unsigned char RT, CID, Mod, Data[6], CD[4], Response[5]; unsigned int angle, angle2; int deviation, deviation2, deviation3;}
         driveentry[21];
     for (i=0;i<21;i++) {
-        driveentry[i].RT = ss[0x730+i*9];
-        driveentry[i].CID = ss[0x730+i*9+1];
-        driveentry[i].Mod = ss[0x730+i*9+2];
-        memcpy(driveentry[i].Data, ss+0x730+i*9+3, 6);
-        memcpy(driveentry[i].CD, ss+ss_replay_table_offset+i*9, 4);
-        memcpy(driveentry[i].Response, ss+ss_replay_table_offset+i*9+4, 5);
-        driveentry[i].angle   = (unsigned int) ss[ss_replay_table_offset+i*9+5] << 8;
-        driveentry[i].angle  |= (unsigned int) ss[ss_replay_table_offset+i*9+4];
-        driveentry[i].angle2  = (unsigned int) ss[ss_replay_table_offset+i*9+8] << 8;
-        driveentry[i].angle2 |= (unsigned int) ss[ss_replay_table_offset+i*9+7];
+        driveentry[i].RT = check->ss[0x730+i*9];
+        driveentry[i].CID = check->ss[0x730+i*9+1];
+        driveentry[i].Mod = check->ss[0x730+i*9+2];
+        memcpy(driveentry[i].Data, check->ss+0x730+i*9+3, 6);
+        memcpy(driveentry[i].CD, check->ss+check->ss_replay_table_offset+i*9, 4);
+        memcpy(driveentry[i].Response, check->ss+check->ss_replay_table_offset+i*9+4, 5);
+        driveentry[i].angle   = (unsigned int) check->ss[check->ss_replay_table_offset+i*9+5] << 8;
+        driveentry[i].angle  |= (unsigned int) check->ss[check->ss_replay_table_offset+i*9+4];
+        driveentry[i].angle2  = (unsigned int) check->ss[check->ss_replay_table_offset+i*9+8] << 8;
+        driveentry[i].angle2 |= (unsigned int) check->ss[check->ss_replay_table_offset+i*9+7];
         driveentry[i].deviation = 0;
         driveentry[i].deviation2 = 0;
         driveentry[i].deviation3 = 0;
@@ -16932,15 +18706,15 @@ int checkss() {
         if (driveentry[i].RT == 0x07 || driveentry[i].RT == 0x05) {
             for (j=0;j<21;j++) {
                 if (dcrtentry[j].CID == driveentry[i].CID) {
-                    if (ss_num_targets < 4) {
-                        ss_targets[ss_num_targets] = dcrtentry[j].angle;
-                        ss_angleaddresses[ss_num_targets] = ss_replay_table_offset+i*9+4;
+                    if (check->ss_num_targets < 4) {
+                        check->ss_targets[check->ss_num_targets] = dcrtentry[j].angle;
+                        check->ss_angleaddresses[check->ss_num_targets] = check->ss_replay_table_offset+i*9+4;
                     }
-                    ss_num_targets++;
+                    check->ss_num_targets++;
                     break;
                 }
             }
-            ss_num_angles++;
+            check->ss_num_angles++;
         }
     }
     if (debug) for (i=0;i<21;i++) {
@@ -16979,11 +18753,11 @@ int checkss() {
         // assuming ss v2 if at least one of the challenge types 24/25 have a non-zero second angle
         // (ignoring unmatched or multiple matched dcrt entries)
         if (dcrtentry[i].matches == 1 && (dcrtentry[i].CT == 0x24 || dcrtentry[i].CT == 0x25) && driveentry[dcrtentry[i].drtmatch].angle2 != 0) {
-            ssv2 = true;
+            check->ssv2 = true;
             break;
         }
     }
-    g_ssv2 = ssv2;
+    check->g_ssv2 = check->ssv2;
     // detect bad shit - struct badshit {unsigned char c[21], d[21], data[21]; int count; char* explanation;};
     struct badshit unmatcheddcrtentry, multiplematcheddcrtentry, CTRTmismatch, badCD, badResponse, weirdCDResponse,
                    unrecognizedCT, badcpr_mai, type0dataresponsemismatch,
@@ -17153,7 +18927,7 @@ int checkss() {
                         weirdCDResponse.data[weirdCDResponse.count] = dcrtentry[i].CID;
                         weirdCDResponse.count++;
                     }
-                    if (ssv2) {
+                    if (check->ssv2) {
                         // angles should be 0-359
                         if (dcrtentry[i].angle > 359 || driveentry[dcrtentry[i].drtmatch].angle > 359 || driveentry[dcrtentry[i].drtmatch].angle2 > 359) {
                             if (dcrtentry[i].angle > 359) {
@@ -17313,7 +19087,7 @@ int checkss() {
                     }
                     // cpr_mai bytes should match dcrt CD unless there are multiple entries with conflicting CD
                     // in that case we wouldn't know what cpr_mai should be
-                    else if (memcmp(dcrtentry[i].CD, ss+ss_replay_table_offset+0xD0, 4) != 0) {
+                    else if (memcmp(dcrtentry[i].CD, check->ss+check->ss_replay_table_offset+0xD0, 4) != 0) {
                         badcpr_mai.c[badcpr_mai.count] = i;
                         badcpr_mai.d[badcpr_mai.count] = dcrtentry[i].drtmatch;
                         badcpr_mai.data[badcpr_mai.count] = dcrtentry[i].CID;
@@ -17346,65 +19120,65 @@ int checkss() {
         highangledev3.count || mediumangledev3.count || userangledev3.count))
             printf("%s", newline);
     if (CT01conflictingCD.count) {
-        ss_stealthfailed = true;
+        check->ss_stealthfailed = true;
         printbadshit(CT01conflictingCD, red);
     }
     if (unmatcheddcrtentry.count) {
-        ss_stealthfailed = true;
+        check->ss_stealthfailed = true;
         printbadshit(unmatcheddcrtentry, red);
     }
     if (multiplematcheddcrtentry.count) {
-        ss_stealthfailed = true;
+        check->ss_stealthfailed = true;
         printbadshit(multiplematcheddcrtentry, red);
     }
     if (CTRTmismatch.count) {
-        ss_stealthfailed = true;
+        check->ss_stealthfailed = true;
         printbadshit(CTRTmismatch, red);
     }
     if (badCD.count) {
-        if (ssv2 || !fixDRT || !writefile) { ss_stealthfailed = true; drtfucked = true; }
+        if (check->ssv2 || !fixDRT || !check->writefile) { check->ss_stealthfailed = true; check->drtfucked = true; }
         printbadshit(badCD, red);
     }
     if (badResponse.count) {
-        if (ssv2 || !fixDRT || !writefile) { ss_stealthfailed = true; drtfucked = true; }
+        if (check->ssv2 || !fixDRT || !check->writefile) { check->ss_stealthfailed = true; check->drtfucked = true; }
         printbadshit(badResponse, red);
     }
     if (weirdCDResponse.count) {
-        ss_stealthfailed = true;
+        check->ss_stealthfailed = true;
         printbadshit(weirdCDResponse, red);
     }
     if (unrecognizedCT.count) {
-        ss_stealthuncertain = true;
+        check->ss_stealthuncertain = true;
         printbadshit(unrecognizedCT, yellow);
     }
     if (badcpr_mai.count) {
-        if (ssv2 || !fixDRT || !writefile) { ss_stealthfailed = true; drtfucked = true; }
+        if (check->ssv2 || !fixDRT || !check->writefile) { check->ss_stealthfailed = true; check->drtfucked = true; }
         printbadshit(badcpr_mai, red);
     }
     if (type0dataresponsemismatch.count) {
-        ss_stealthfailed = true;
+        check->ss_stealthfailed = true;
         printbadshit(type0dataresponsemismatch, red);
     }
     if (baddcrtangle.count) {
-        ss_stealthfailed = true;
+        check->ss_stealthfailed = true;
         printbadshit(baddcrtangle, red);
     }
     if (baddriveangle.count) {
-        if (ssv2 || !fixDRT || !writefile) { ss_stealthfailed = true; drtfucked = true; }
+        if (check->ssv2 || !fixDRT || !check->writefile) { check->ss_stealthfailed = true; check->drtfucked = true; }
         printbadshit(baddriveangle, red);
     }
     if (baddriveangle2.count) {
-        ss_stealthfailed = true;
-        drtfucked = true;
+        check->ss_stealthfailed = true;
+        check->drtfucked = true;
         printbadshit(baddriveangle2, red);
     }
     // SS v1 angle deviation from CCRT
     if (highangledev.count) {
-        if (ssv2 || !fixdeviation || !writefile) { ss_stealthfailed = true; drtfucked = true; }
+        if (check->ssv2 || !fixdeviation || !check->writefile) { check->ss_stealthfailed = true; check->drtfucked = true; }
         printbadshit(highangledev, red);
     }
     if (mediumangledev.count) {
-        if (ssv2 || !fixdeviation || !writefile) { ss_stealthuncertain = true; drtfucked = true; }
+        if (check->ssv2 || !fixdeviation || !check->writefile) { check->ss_stealthuncertain = true; check->drtfucked = true; }
         printbadshit(mediumangledev, yellow);
     }
     if (userangledev.count) {
@@ -17412,13 +19186,13 @@ int checkss() {
     }
     // SS v2 angle deviation from CCRT (for when we don't trust ss v2 angles)
     if (highangledev2.count) {
-        ss_stealthfailed = true;
-        drtfucked = true;
+        check->ss_stealthfailed = true;
+        check->drtfucked = true;
         printbadshit(highangledev2, red);
     }
     if (mediumangledev2.count) {
-        ss_stealthuncertain = true;
-        drtfucked = true;
+        check->ss_stealthuncertain = true;
+        check->drtfucked = true;
         printbadshit(mediumangledev2, yellow);
     }
     if (userangledev2.count) {
@@ -17426,13 +19200,13 @@ int checkss() {
     }
     // SS v1 angle deviation from v2 (for when we trust ss v2 angles)
     if (highangledev3.count) {
-        ss_stealthfailed = true;
-        drtfucked = true;
+        check->ss_stealthfailed = true;
+        check->drtfucked = true;
         printbadshit(highangledev3, red);
     }
     if (mediumangledev3.count) {
-        ss_stealthuncertain = true;
-        drtfucked = true;
+        check->ss_stealthuncertain = true;
+        check->drtfucked = true;
         printbadshit(mediumangledev3, yellow);
     }
     if (userangledev3.count) {
@@ -17453,7 +19227,7 @@ int checkss() {
         highangledev.count || mediumangledev.count || userangledev.count ||
         highangledev2.count || mediumangledev2.count || userangledev2.count ||
         highangledev3.count || mediumangledev3.count || userangledev3.count))) {
-        if (ssv2) {
+        if (check->ssv2) {
             printf("%sSS Version: 2", sp5);
             if (trustssv2angles) printf(" (trusted)%s", newline);
             else printf(" (not trusted)%s", newline);
@@ -17599,7 +19373,7 @@ int checkss() {
                             color(normal);
                             break;
                         }
-                if (ssv2) {
+                if (check->ssv2) {
                     if (dcrtentry[i].CT == 0x24 || dcrtentry[i].CT == 0x25) {  // corresponds to RT 7/5 in the DRT
                         printf("%s %s %s v1 deviation from CCRT %s ", newline, sp21, sp3, sp10);
                         if (driveentry[dcrtentry[i].drtmatch].angle > 359) color(red);
@@ -17757,7 +19531,7 @@ int checkss() {
         color(normal);
     }
     else if (verbose) {
-        if (ssv2) {
+        if (check->ssv2) {
             printf("%sSS Version: 2", sp5);
             if (trustssv2angles) printf(" (trusted)%s", newline);
             else                 printf(" (not trusted)%s", newline);
@@ -17767,17 +19541,17 @@ int checkss() {
     if (extraverbose || debug || (verbose && badcpr_mai.count)) {
         printf("%sCPR_MAI: ", sp5);
         if (badcpr_mai.count) color(red);
-        for (u = ss_replay_table_offset+0xD0; u < ss_replay_table_offset+0xD4; u++) printf("%02X", ss[u]);
+        for (u = check->ss_replay_table_offset+0xD0; u < check->ss_replay_table_offset+0xD4; u++) printf("%02X", check->ss[u]);
         if (badcpr_mai.count) color(normal);
         printf("%s", newline);
     }
     bool triedtofix = false;
-    if (ssv2) {
+    if (check->ssv2) {
         if (foundangle359_count && fixangle359) {
             // the only thing we are willing to 'fix' in ss v2
             triedtofix = true;
             if (verbose) printf("%s", newline);
-            if (!writefile) {
+            if (!check->writefile) {
                 printf("Unable to fix the following item(s) because writing is disabled:%s", newline);
                 color(yellow);
                 printf("Found a 359 degree SS v1 angle%s", newline);
@@ -17786,10 +19560,10 @@ int checkss() {
             else {
                 for (i=0;i<21;i++) {
                     if (driveentry[i].RT == 0x07 || driveentry[i].RT == 0x05) {
-                        if (ss[ss_replay_table_offset+i*9+4] == 0x67 && ss[ss_replay_table_offset+i*9+5] == 0x01) {
-                            ss[ss_replay_table_offset+i*9+4] = 0x0;
-                            ss[ss_replay_table_offset+i*9+5] = 0x0;
-                            fixedss = true;
+                        if (check->ss[check->ss_replay_table_offset+i*9+4] == 0x67 && check->ss[check->ss_replay_table_offset+i*9+5] == 0x01) {
+                            check->ss[check->ss_replay_table_offset+i*9+4] = 0x0;
+                            check->ss[check->ss_replay_table_offset+i*9+5] = 0x0;
+                            check->fixedss = true;
                         }
                     }
                 }
@@ -17808,7 +19582,7 @@ int checkss() {
         triedtofix = true;
         if (verbose) printf("%s", newline);
         printf("Fixing SS Challenge / Response Data...%s", newline);
-        if (!writefile) {
+        if (!check->writefile) {
             printf("Unable to fix the following item(s) because writing is disabled:%s", newline);
             if (fixDRT && (badCD.count || badResponse.count || badcpr_mai.count || baddriveangle.count)) {
                 if (badCD.count) printbadshit(badCD, red);
@@ -17829,42 +19603,42 @@ int checkss() {
             if (fixDRT) {
                 if (badCD.count) {
                     for (i=0;i<badCD.count;i++) {
-                        memcpy(ss+ss_replay_table_offset+badCD.d[i]*9, dcrtentry[badCD.c[i]].CD, 4);
+                        memcpy(check->ss+check->ss_replay_table_offset+badCD.d[i]*9, dcrtentry[badCD.c[i]].CD, 4);
                     }
-                    fixedss = true;
+                    check->fixedss = true;
                     printfixedshit(badCD);
                 }
                 if (badResponse.count) {
                     for (i=0;i<badResponse.count;i++) {
-                        memcpy(ss+ss_replay_table_offset+badResponse.d[i]*9+4, dcrtentry[badResponse.c[i]].Response, 4);
+                        memcpy(check->ss+check->ss_replay_table_offset+badResponse.d[i]*9+4, dcrtentry[badResponse.c[i]].Response, 4);
                     }
-                    fixedss = true;
+                    check->fixedss = true;
                     printfixedshit(badResponse);
                 }
                 if (badcpr_mai.count) {
-                    memcpy(ss+ss_replay_table_offset+0xD0, dcrtentry[badcpr_mai.c[0]].CD, 4);
-                    fixedss = true;
+                    memcpy(check->ss+check->ss_replay_table_offset+0xD0, dcrtentry[badcpr_mai.c[0]].CD, 4);
+                    check->fixedss = true;
                     printfixedshit(badcpr_mai);
                 }
                 if (baddriveangle.count) {
                     int fixedbaddriveangle_count = 0;
                     for (i=0;i<baddriveangle.count;i++) {
                         if (fixangle359 && dcrtentry[baddriveangle.c[i]].angle == 359) {
-                            ss[ss_replay_table_offset+baddriveangle.d[i]*9+4] = 0x0;
-                            ss[ss_replay_table_offset+baddriveangle.d[i]*9+5] = 0x0;
-                            fixedss = true;
+                            check->ss[check->ss_replay_table_offset+baddriveangle.d[i]*9+4] = 0x0;
+                            check->ss[check->ss_replay_table_offset+baddriveangle.d[i]*9+5] = 0x0;
+                            check->fixedss = true;
                             fixedbaddriveangle_count++;
                         }
                         else if (dcrtentry[baddriveangle.c[i]].angle < 360) {
-                            ss[ss_replay_table_offset+baddriveangle.d[i]*9+4] = dcrtentry[baddriveangle.c[i]].Response[3];
-                            ss[ss_replay_table_offset+baddriveangle.d[i]*9+5] = dcrtentry[baddriveangle.c[i]].Response[2];
-                            fixedss = true;
+                            check->ss[check->ss_replay_table_offset+baddriveangle.d[i]*9+4] = dcrtentry[baddriveangle.c[i]].Response[3];
+                            check->ss[check->ss_replay_table_offset+baddriveangle.d[i]*9+5] = dcrtentry[baddriveangle.c[i]].Response[2];
+                            check->fixedss = true;
                             fixedbaddriveangle_count++;
                         }
                         else {
                             // replace a bad angle with a bad angle?
-                            ss_stealthfailed = true;
-                            drtfucked = true;
+                            check->ss_stealthfailed = true;
+                            check->drtfucked = true;
                         }
                     }
                     if (fixedbaddriveangle_count == baddriveangle.count) printfixedshit(baddriveangle);
@@ -17888,19 +19662,19 @@ int checkss() {
                         if (abs(driveentry[highangledev.d[i]].deviation) > fixangledev_value) {
                             //if (foundangle359_count && driveentry[highangledev.d[i]].angle == 359) foundangle359_count--;
                             fixedhighangledev_count++;
-                            fixedss = true;
+                            check->fixedss = true;
                             if (fixangle359 && dcrtentry[highangledev.c[i]].angle == 359) {
-                                ss[ss_replay_table_offset+highangledev.d[i]*9+4] = 0x0;
-                                ss[ss_replay_table_offset+highangledev.d[i]*9+5] = 0x0;
+                                check->ss[check->ss_replay_table_offset+highangledev.d[i]*9+4] = 0x0;
+                                check->ss[check->ss_replay_table_offset+highangledev.d[i]*9+5] = 0x0;
                             }
                             else {
-                                ss[ss_replay_table_offset+highangledev.d[i]*9+4] = dcrtentry[highangledev.c[i]].Response[3];
-                                ss[ss_replay_table_offset+highangledev.d[i]*9+5] = dcrtentry[highangledev.c[i]].Response[2];
+                                check->ss[check->ss_replay_table_offset+highangledev.d[i]*9+4] = dcrtentry[highangledev.c[i]].Response[3];
+                                check->ss[check->ss_replay_table_offset+highangledev.d[i]*9+5] = dcrtentry[highangledev.c[i]].Response[2];
                             }
                         }
                         else {
-                            ss_stealthfailed = true;
-                            drtfucked = true;
+                            check->ss_stealthfailed = true;
+                            check->drtfucked = true;
                         }
                     }
                     if (fixedhighangledev_count == highangledev.count) printfixedshit(highangledev);
@@ -17923,19 +19697,19 @@ int checkss() {
                         if (abs(driveentry[mediumangledev.d[i]].deviation) > fixangledev_value) {
                             //if (foundangle359_count && driveentry[mediumangledev.d[i]].angle == 359) foundangle359_count--;
                             fixedmediumangledev_count++;
-                            fixedss = true;
+                            check->fixedss = true;
                             if (fixangle359 && dcrtentry[mediumangledev.c[i]].angle == 359) {
-                                ss[ss_replay_table_offset+mediumangledev.d[i]*9+4] = 0x0;
-                                ss[ss_replay_table_offset+mediumangledev.d[i]*9+5] = 0x0;
+                                check->ss[check->ss_replay_table_offset+mediumangledev.d[i]*9+4] = 0x0;
+                                check->ss[check->ss_replay_table_offset+mediumangledev.d[i]*9+5] = 0x0;
                             }
                             else {
-                                ss[ss_replay_table_offset+mediumangledev.d[i]*9+4] = dcrtentry[mediumangledev.c[i]].Response[3];
-                                ss[ss_replay_table_offset+mediumangledev.d[i]*9+5] = dcrtentry[mediumangledev.c[i]].Response[2];
+                                check->ss[check->ss_replay_table_offset+mediumangledev.d[i]*9+4] = dcrtentry[mediumangledev.c[i]].Response[3];
+                                check->ss[check->ss_replay_table_offset+mediumangledev.d[i]*9+5] = dcrtentry[mediumangledev.c[i]].Response[2];
                             }
                         }
                         else {
-                            ss_stealthuncertain = true;
-                            drtfucked = true;
+                            check->ss_stealthuncertain = true;
+                            check->drtfucked = true;
                         }
                     }
                     if (fixedmediumangledev_count == mediumangledev.count) printfixedshit(mediumangledev);
@@ -17955,14 +19729,14 @@ int checkss() {
                 if (userangledev.count) {
                     for (i=0;i<userangledev.count;i++) {
                         //if (foundangle359_count && driveentry[userangledev.d[i]].angle == 359) foundangle359_count--;
-                        fixedss = true;
+                        check->fixedss = true;
                         if (fixangle359 && dcrtentry[userangledev.c[i]].angle == 359) {
-                            ss[ss_replay_table_offset+userangledev.d[i]*9+4] = 0x0;
-                            ss[ss_replay_table_offset+userangledev.d[i]*9+5] = 0x0;
+                            check->ss[check->ss_replay_table_offset+userangledev.d[i]*9+4] = 0x0;
+                            check->ss[check->ss_replay_table_offset+userangledev.d[i]*9+5] = 0x0;
                         }
                         else {
-                            ss[ss_replay_table_offset+userangledev.d[i]*9+4] = dcrtentry[userangledev.c[i]].Response[3];
-                            ss[ss_replay_table_offset+userangledev.d[i]*9+5] = dcrtentry[userangledev.c[i]].Response[2];
+                            check->ss[check->ss_replay_table_offset+userangledev.d[i]*9+4] = dcrtentry[userangledev.c[i]].Response[3];
+                            check->ss[check->ss_replay_table_offset+userangledev.d[i]*9+5] = dcrtentry[userangledev.c[i]].Response[2];
                         }
                     }
                     printfixedshit(userangledev);
@@ -17971,10 +19745,10 @@ int checkss() {
             if (foundangle359_count && fixangle359) {
                 for (i=0;i<21;i++) {
                     if (driveentry[i].RT == 0x07 || driveentry[i].RT == 0x05) {
-                        if (ss[ss_replay_table_offset+i*9+4] == 0x67 && ss[ss_replay_table_offset+i*9+5] == 0x01) {
-                            ss[ss_replay_table_offset+i*9+4] = 0x0;
-                            ss[ss_replay_table_offset+i*9+5] = 0x0;
-                            fixedss = true;
+                        if (check->ss[check->ss_replay_table_offset+i*9+4] == 0x67 && check->ss[check->ss_replay_table_offset+i*9+5] == 0x01) {
+                            check->ss[check->ss_replay_table_offset+i*9+4] = 0x0;
+                            check->ss[check->ss_replay_table_offset+i*9+5] = 0x0;
+                            check->fixedss = true;
                         }
                     }
                 }
@@ -18013,47 +19787,47 @@ int checkss() {
     }
     
     unsigned char ss_overwritten[2048];
-    memcpy(ss_overwritten, ss, 2048);
+    memcpy(ss_overwritten, check->ss, 2048);
     // ss_replay_table_length = 0xD4 including cpr_mai but we have always used 0x100 for XGD2
-    ss_replay_table_length = 0xD4;
-    if (memcmp(ss, "\xE1\x0F\x31\x10\x00\x04\xFB\x20\x00\xFB\x04\xDF\x00\x20\x33\x9F", 16) == 0) ss_replay_table_length = 0x100; // this is longer than the actual replay table but this is how the database has always done it for XGD2
+    check->ss_replay_table_length = 0xD4;
+    if (memcmp(check->ss, "\xE1\x0F\x31\x10\x00\x04\xFB\x20\x00\xFB\x04\xDF\x00\x20\x33\x9F", 16) == 0) check->ss_replay_table_length = 0x100; // this is longer than the actual replay table but this is how the database has always done it for XGD2
     // calculate static SS crc32 with all possible angles set to 0xFF (so we can make sure ss files ripped during extended c/r
     // match the existing c/r [with the exception of changing angle deviation] by simply comparing with this 'static' crc)
-    if ( ss_num_angles == 4 && ss_num_targets == 4 &&
-        (ss_angleaddresses[0] >= ss_replay_table_offset && ss_angleaddresses[0] < ss_replay_table_offset + ss_replay_table_length - 5) &&
-        (ss_angleaddresses[1] >= ss_replay_table_offset && ss_angleaddresses[1] < ss_replay_table_offset + ss_replay_table_length - 5) &&
-        (ss_angleaddresses[2] >= ss_replay_table_offset && ss_angleaddresses[2] < ss_replay_table_offset + ss_replay_table_length - 5) &&
-        (ss_angleaddresses[3] >= ss_replay_table_offset && ss_angleaddresses[3] < ss_replay_table_offset + ss_replay_table_length - 5) ) {
-        memset(ss_overwritten+ss_angleaddresses[0],   0xFF, 2);  // v1
-        memset(ss_overwritten+ss_angleaddresses[0]+3, 0xFF, 2);  // v2
-        memset(ss_overwritten+ss_angleaddresses[1],   0xFF, 2);  // v1
-        memset(ss_overwritten+ss_angleaddresses[1]+3, 0xFF, 2);  // v2
-        memset(ss_overwritten+ss_angleaddresses[2],   0xFF, 2);  // v1
-        memset(ss_overwritten+ss_angleaddresses[2]+3, 0xFF, 2);  // v2
-        memset(ss_overwritten+ss_angleaddresses[3],   0xFF, 2);  // v1
-        memset(ss_overwritten+ss_angleaddresses[3]+3, 0xFF, 2);  // v2
-        ss_staticcrc32 = crc32(0, ss_overwritten, 2048);
-        if (debug) printf("Static SS CRC = %08lX%s", ss_staticcrc32, newline);
+    if ( check->ss_num_angles == 4 && check->ss_num_targets == 4 &&
+        (check->ss_angleaddresses[0] >= check->ss_replay_table_offset && check->ss_angleaddresses[0] < check->ss_replay_table_offset + check->ss_replay_table_length - 5) &&
+        (check->ss_angleaddresses[1] >= check->ss_replay_table_offset && check->ss_angleaddresses[1] < check->ss_replay_table_offset + check->ss_replay_table_length - 5) &&
+        (check->ss_angleaddresses[2] >= check->ss_replay_table_offset && check->ss_angleaddresses[2] < check->ss_replay_table_offset + check->ss_replay_table_length - 5) &&
+        (check->ss_angleaddresses[3] >= check->ss_replay_table_offset && check->ss_angleaddresses[3] < check->ss_replay_table_offset + check->ss_replay_table_length - 5) ) {
+        memset(ss_overwritten+check->ss_angleaddresses[0],   0xFF, 2);  // v1
+        memset(ss_overwritten+check->ss_angleaddresses[0]+3, 0xFF, 2);  // v2
+        memset(ss_overwritten+check->ss_angleaddresses[1],   0xFF, 2);  // v1
+        memset(ss_overwritten+check->ss_angleaddresses[1]+3, 0xFF, 2);  // v2
+        memset(ss_overwritten+check->ss_angleaddresses[2],   0xFF, 2);  // v1
+        memset(ss_overwritten+check->ss_angleaddresses[2]+3, 0xFF, 2);  // v2
+        memset(ss_overwritten+check->ss_angleaddresses[3],   0xFF, 2);  // v1
+        memset(ss_overwritten+check->ss_angleaddresses[3]+3, 0xFF, 2);  // v2
+        check->ss_staticcrc32 = crc32_fast(0, ss_overwritten, 2048);
+        if (debug) printf("Static SS CRC = %08lX%s", check->ss_staticcrc32, newline);
     }
     
     // calculate SS crc32 with entire replay table set as 0xFF
-    memset(ss_overwritten+ss_replay_table_offset, 0xFF, ss_replay_table_length);
-    ss_crc32 = crc32(0, ss_overwritten, 2048);
-    if (verbose) printf("%sSS CRC = %08lX", sp5, ss_crc32);
+    memset(ss_overwritten+check->ss_replay_table_offset, 0xFF, check->ss_replay_table_length);
+    check->ss_crc32 = crc32_fast(0, ss_overwritten, 2048);
+    if (verbose) printf("%sSS CRC = %08lX", sp5, check->ss_crc32);
 
     // calculate raw SS crc32
-    ss_rawcrc32 = crc32(0, ss, 2048);
-    if (verbose) printf(" (RawSS = %08lX)%s", ss_rawcrc32, newline);
+    check->ss_rawcrc32 = crc32_fast(0, check->ss, 2048);
+    if (verbose) printf(" (RawSS = %08lX)%s", check->ss_rawcrc32, newline);
 
     // copy the media id from 0x460 and compare to the xex
-    memcpy(ss_mediaid, ss+0x460, 16);
+    memcpy(check->ss_mediaid, check->ss+0x460, 16);
     if (verbose) {
         printf("%sSS Media ID: ", sp5);
-        printmediaid(ss_mediaid);
+        printmediaid(check->ss_mediaid);
     }
-    if (xex_foundmediaid) {
-        if (memcmp(xex_mediaid, ss_mediaid, 16) != 0) {
-            ss_stealthfailed = true;
+    if (check->xex_foundmediaid) {
+        if (memcmp(check->xex_mediaid, check->ss_mediaid, 16) != 0) {
+            check->ss_stealthfailed = true;
             if (verbose) printf("%s", newline);
             color(red); printf("SS media id does not match this game!%s", newline); color(normal);
         }
@@ -18061,21 +19835,21 @@ int checkss() {
     }
     else {
         if (verbose) printf("%s", newline);
-        if (!checkssbin) {
-            stealthuncertain = true;
-            ss_stealthuncertain = true;
+        if (!check->checkssbin) {
+            check->stealthuncertain = true;
+            check->ss_stealthuncertain = true;
             color(yellow); printf("SS media id could not be compared to the Xex%s", newline); color(normal);
         }
-        else checkcsv(ss_mediaid);
+        else checkcsv(check->ss_mediaid);
     }
 
-    if (!ss_stealthfailed && !ss_stealthuncertain) {
+    if (!check->ss_stealthfailed && !check->ss_stealthuncertain) {
         color(green);
         printf("SS looks valid%s", newline);
         color(normal);
     }
     if (should_nuke_dmi()) {
-            ss_stealthfailed = true;
+            check->ss_stealthfailed = true;
     	return 1;
 }
   return 0;
@@ -18190,6 +19964,10 @@ int doap25autoupload(char *argv[], unsigned char *median_ap25) {
     curl_formadd(&formpost, &lastptr, CURLFORM_COPYNAME, "drivename", CURLFORM_COPYCONTENTS, isofilename,             CURLFORM_END);
     curl_formadd(&formpost, &lastptr, CURLFORM_COPYNAME, "uploadedap25", CURLFORM_FILE, autouploadap25filename, CURLFORM_CONTENTTYPE, "application/octet-stream", CURLFORM_END);
     curl_easy_setopt(curl, CURLOPT_HTTPPOST, formpost);
+    #ifndef WIN32
+        // the reply goes to curl.txt, which is the same file for every batch job
+        lockshared();
+    #endif
     curlheaderprinted = false;
     curlprogressstartmsecs = getmsecs();
     res = curl_easy_perform(curl);
@@ -18217,6 +19995,9 @@ int doap25autoupload(char *argv[], unsigned char *median_ap25) {
         color(yellow);
         printf("ERROR: Failed to open cURL output file (%s), result of AutoUpload is unknown%s", strerror(errno), newline);
         color(normal);
+        #ifndef WIN32
+            unlockshared();
+        #endif
       return 1;
     }
     else {
@@ -18224,6 +20005,9 @@ int doap25autoupload(char *argv[], unsigned char *median_ap25) {
         dontcare = fread(replybuffer, sizeof(char), 1023, curloutput);
         fclose(curloutput);
         remove(curloutputfilename);
+        #ifndef WIN32
+            unlockshared();
+        #endif
         if (debug) printf("curloutput: %s%s", replybuffer, newline);
         if (strlen(replybuffer) > 0) {
             if (strlen(replybuffer) == 5 && memcmp(replybuffer, "ERROR", 5) == 0) {
@@ -18407,6 +20191,10 @@ int doextendedap25cr(char *forced_cr_drive, unsigned char *median_ap25) {
     struct MyCurlFile curlwebdae = {daepathbuffer, NULL};
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *) &curlwebdae);
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, my_curl_write);
+    #ifndef WIN32
+        // another batch job could be updating dae.bin too
+        lockshared();
+    #endif
     if (stat(daepathbuffer, &buf) == 0) {
         curl_easy_setopt(curl, CURLOPT_TIMECONDITION, 1);
         curl_easy_setopt(curl, CURLOPT_TIMEVALUE, buf.st_mtime);
@@ -18454,6 +20242,9 @@ int doextendedap25cr(char *forced_cr_drive, unsigned char *median_ap25) {
         printcurlinfo(curl, "dae.bin");
     }
     if (curlwebdae.stream != NULL) fclose(curlwebdae.stream);
+    #ifndef WIN32
+        unlockshared();
+    #endif
     if (extraverbose) {
         curl_easy_setopt(curl, CURLOPT_VERBOSE, 0);  // reset to avoid annoying "Closing Connection ..." atexit
     }
@@ -19236,7 +21027,7 @@ void checkap25(char *argv[]) {
     unsigned char median_ap25[2048];
     bool have_median_ap25 = false, ourap25isinvalid = false;
     if (verbose && !minimal) printf("Checking AP25 replay sector%s", newline);
-    if (getzeros(ap25, 0, 2047) == 2048) {
+    if (zeroscan_allzeros(ap25, 2048)) {
         color(red);
         printf("AP25 replay sector is blank!%s", newline);
         color(normal);
@@ -19296,7 +21087,7 @@ void checkap25(char *argv[]) {
             }
             fclose(ap25hashfile);
             // make sure the file isn't corrupt by checking the crc of the hash against the embedded crc at the end of the file
-            if (crc32(0, ap25hashfilebuffer, 20) != getuintmsb(ap25hashfilebuffer+20)) {
+            if (crc32_fast(0, ap25hashfilebuffer, 20) != getuintmsb(ap25hashfilebuffer+20)) {
                 color(red);
                 printf("ERROR: %s appears to be corrupt! (deleting it)%s", ap25hashfilename, newline);
                 color(normal);
@@ -19516,7 +21307,7 @@ void checkap25(char *argv[]) {
         }
         fclose(ap25hashfile);
         // make sure the file isn't corrupt by checking the crc of the hash against the embedded crc at the end of the file
-        if (crc32(0, ap25hashfilebuffer, 20) != getuintmsb(ap25hashfilebuffer+20)) {
+        if (crc32_fast(0, ap25hashfilebuffer, 20) != getuintmsb(ap25hashfilebuffer+20)) {
             color(red);
             printf("ERROR: %s appears to be corrupt! (deleting it)%s", ap25hashfilename, newline);
             color(normal);
@@ -19778,39 +21569,39 @@ void checkap25(char *argv[]) {
 */
 
 void checktopology() {
-    fixedtopology = false;
-    topology_was_verified = false;
+    check->fixedtopology = false;
+    check->topology_was_verified = false;
     uchar top_sha1[20] = {0}, top_verified_sha1[20] = {0}, top_binfile_sha1[20] = {0};
     int i;
     if (verbose && !minimal) printf("Checking topology data%s", newline);
-    if (getzeros(topology, 0, TOPOLOGY_SIZE - 1) == TOPOLOGY_SIZE) {
+    if (zeroscan_allzeros(check->topology, TOPOLOGY_SIZE)) {
         color(red);
         printf("Topology data is blank!%s", newline);
         color(normal);
     }
-    else if (TOPOLOGY_SIZE >= 4096 && TOPOLOGY_SIZE % 2048 == 0 && getzeros(topology, 0, TOPOLOGY_SIZE - 2049) == TOPOLOGY_SIZE - 2048) {
+    else if (TOPOLOGY_SIZE >= 4096 && TOPOLOGY_SIZE % 2048 == 0 && zeroscan_allzeros(check->topology, TOPOLOGY_SIZE - 2048)) {
         // all but the last sector is blank (the last sector is where we stored old AP25 replay data)
         color(red);
         printf("The first %d sectors of topology data are blank!%s", TOPOLOGY_SIZE / 2048 - 1, newline);
         color(normal);
     }
     // calculate topology sha-1
-    sha1_starts(&ctx);
-    sha1_update(&ctx, topology, TOPOLOGY_SIZE);
-    sha1_finish(&ctx, top_sha1);
+    sha1_starts(&check->ctx);
+    sha1_update(&check->ctx, check->topology, TOPOLOGY_SIZE);
+    sha1_finish(&check->ctx, top_sha1);
     if (extraverbose) {
         printf("%sTopology data SHA-1 = ", sp5);
         for (i=0; i<20; i++) printf("%02X", top_sha1[i]);
         printf("%s", newline);
     }
     if (verify) {
-        if (!xex_foundmediaid) {
+        if (!check->xex_foundmediaid) {
             color(red);
             printf("Unable to verify topology data because the Xex Media ID could not be found%s", newline);
             color(normal);
           return;
         }
-        if (!foundtitleid) {
+        if (!check->foundtitleid) {
             color(red);
             printf("Unable to verify topology data because the Title ID could not be found%s", newline);
             color(normal);
@@ -19836,21 +21627,21 @@ void checktopology() {
         strcat(webpathbuffer, webtopology);
         strcat(webpathbuffer, "?m=");
         sprintf(id, "%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X-%02X%02X%02X%02X",
-                xex_mediaid[0], xex_mediaid[1], xex_mediaid[2], xex_mediaid[3], xex_mediaid[4],
-                xex_mediaid[5], xex_mediaid[6], xex_mediaid[7], xex_mediaid[8], xex_mediaid[9],
-                xex_mediaid[10], xex_mediaid[11], xex_mediaid[12], xex_mediaid[13], xex_mediaid[14],
-                xex_mediaid[15]);
+                check->xex_mediaid[0], check->xex_mediaid[1], check->xex_mediaid[2], check->xex_mediaid[3], check->xex_mediaid[4],
+                check->xex_mediaid[5], check->xex_mediaid[6], check->xex_mediaid[7], check->xex_mediaid[8], check->xex_mediaid[9],
+                check->xex_mediaid[10], check->xex_mediaid[11], check->xex_mediaid[12], check->xex_mediaid[13], check->xex_mediaid[14],
+                check->xex_mediaid[15]);
         strcat(webpathbuffer, id);
         strcat(webpathbuffer, "&t=");
-        sprintf(id, "%02X%02X%02X%02X", titleid[0], titleid[1], titleid[2], titleid[3]);
+        sprintf(id, "%02X%02X%02X%02X", check->titleid[0], check->titleid[1], check->titleid[2], check->titleid[3]);
         strcat(webpathbuffer, id);
-        if (xex_founddiscprofileid) {
+        if (check->xex_founddiscprofileid) {
             strcat(webpathbuffer, "&d=");
             sprintf(id, "%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X%02X-%02X%02X%02X%02X",
-                    xex_discprofileid[0], xex_discprofileid[1], xex_discprofileid[2], xex_discprofileid[3], xex_discprofileid[4],
-                    xex_discprofileid[5], xex_discprofileid[6], xex_discprofileid[7], xex_discprofileid[8], xex_discprofileid[9],
-                    xex_discprofileid[10], xex_discprofileid[11], xex_discprofileid[12], xex_discprofileid[13], xex_discprofileid[14],
-                    xex_discprofileid[15]);
+                    check->xex_discprofileid[0], check->xex_discprofileid[1], check->xex_discprofileid[2], check->xex_discprofileid[3], check->xex_discprofileid[4],
+                    check->xex_discprofileid[5], check->xex_discprofileid[6], check->xex_discprofileid[7], check->xex_discprofileid[8], check->xex_discprofileid[9],
+                    check->xex_discprofileid[10], check->xex_discprofileid[11], check->xex_discprofileid[12], check->xex_discprofileid[13], check->xex_discprofileid[14],
+                    check->xex_discprofileid[15]);
             strcat(webpathbuffer, id);
         }
         memset(curlerrorbuffer, 0, CURL_ERROR_SIZE+1);
@@ -19876,7 +21667,11 @@ void checktopology() {
         curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *) &curlwebtopology);
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, my_curl_write);
         curl_easy_setopt(curl, CURLOPT_TIMECONDITION, 0);
-        curlheaderprinted = false;
+        #ifndef WIN32
+            // topology.txt is the same file for every batch job
+            lockshared();
+        #endif
+        check->curlheaderprinted = false;
         if (extraverbose) fprintf(stderr, "\n");
         printstderr = true;
         color(blue);
@@ -19884,7 +21679,7 @@ void checktopology() {
         res = curl_easy_perform(curl);
         color(normal);
         printstderr = false;
-        if (extraverbose || curlheaderprinted) fprintf(stderr, "\n");
+        if (extraverbose || check->curlheaderprinted) fprintf(stderr, "\n");
         if (res != CURLE_OK) {  // error occurred
             color(yellow);
             if (res == CURLE_HTTP_RETURNED_ERROR) {
@@ -19924,12 +21719,18 @@ void checktopology() {
             color(yellow);
             printf("ERROR: Failed to find or open '%s' (%s)%s", localpathbuffer, strerror(errno), newline);
             color(normal);
+            #ifndef WIN32
+                unlockshared();
+            #endif
           return;
         }
         char topologytxtbuffer[2048] = {0};
         dontcare = fread(topologytxtbuffer, 1, 2047, topologyfile);
         fclose(topologyfile);
         remove(localpathbuffer);
+        #ifndef WIN32
+            unlockshared();
+        #endif
         // make sure data is long enough to contain the prefix, suffix and at least one character in between
         if (strlen(topologytxtbuffer) < 12) {
             color(red);
@@ -20018,7 +21819,7 @@ void checktopology() {
         }
         fclose(tophashfile);
         // make sure the file isn't corrupt by checking the crc of the hash against the embedded crc at the end of the file
-        if (crc32(0, tophashfilebuffer, 20) != getuintmsb(tophashfilebuffer+20)) {
+        if (crc32_fast(0, tophashfilebuffer, 20) != getuintmsb(tophashfilebuffer+20)) {
             color(red);
             printf("ERROR: %s appears to be corrupt! (deleting it)%s", tophashfilename, newline);
             color(normal);
@@ -20031,7 +21832,7 @@ void checktopology() {
             color(green);
             printf("Topology data is currently verified%s", newline);
             color(normal);
-            topology_was_verified = true;
+            check->topology_was_verified = true;
           return;
         }
         color(yellow);
@@ -20039,7 +21840,7 @@ void checktopology() {
         color(normal);
         if (autofix) {
             printf("Attempting to fix the topology data%s", newline);
-            if (!writefile) {
+            if (!check->writefile) {
                 color(yellow);
                 printf("Aborting fix because writing is disabled%s", newline);
                 color(normal);
@@ -20079,9 +21880,9 @@ void checktopology() {
             }
             fclose(topbinfile);
             // make sure the file isn't corrupt by checking the sha-1 of the file against top_verified_sha1
-            sha1_starts(&ctx);
-            sha1_update(&ctx, topbinfilebuffer, TOPOLOGY_SIZE);
-            sha1_finish(&ctx, top_binfile_sha1);
+            sha1_starts(&check->ctx);
+            sha1_update(&check->ctx, topbinfilebuffer, TOPOLOGY_SIZE);
+            sha1_finish(&check->ctx, top_binfile_sha1);
             if (extraverbose) {
                 printf("%sTopology data SHA-1 = ", sp5);
                 for (i=0; i<20; i++) printf("%02X", top_binfile_sha1[i]);
@@ -20095,8 +21896,8 @@ void checktopology() {
               return;
             }
             // overwrite topology buffer with downloaded bin file contents and set fixedtopology = true so it will try to get patched
-            memcpy(topology, topbinfilebuffer, TOPOLOGY_SIZE);
-            fixedtopology = true;
+            memcpy(check->topology, topbinfilebuffer, TOPOLOGY_SIZE);
+            check->fixedtopology = true;
           return;
         }
         else {
@@ -20122,13 +21923,13 @@ bool isacontrolchar(unsigned char character) {
 }
 
 void checkdmi(unsigned char *dmi) {
-    dmi_stealthfailed = false;
-    dmi_stealthuncertain = false;
-    dmi_crc32 = 0;
+    check->dmi_stealthfailed = false;
+    check->dmi_stealthuncertain = false;
+    check->dmi_crc32 = 0;
     int i;
     if (verbose && !minimal) printf("%sChecking DMI%s", newline, newline);
-    if (getzeros(dmi, 0, 2047) == 2048) {
-        dmi_stealthfailed = true;
+    if (zeroscan_allzeros(dmi, 2048)) {
+        check->dmi_stealthfailed = true;
         color(red);
         printf("DMI is blank!%s", newline);
         color(normal);
@@ -20140,9 +21941,9 @@ void checkdmi(unsigned char *dmi) {
         printf("%sTimestamp of Authoring: ", sp5);
         printwin32filetime(dmi_authored);
     }
-    if (ss_foundtimestamp) {
-        if (ss_authored != dmi_authored) {
-            dmi_stealthfailed = true;
+    if (check->ss_foundtimestamp) {
+        if (check->ss_authored != dmi_authored) {
+            check->dmi_stealthfailed = true;
             if (verbose) printf("%s", newline);
             color(red);
             printf("DMI timestamp of authoring does not match SS!%s", newline);
@@ -20152,9 +21953,9 @@ void checkdmi(unsigned char *dmi) {
     }
     else {
         if (verbose) printf("%s", newline);
-        if (!justastealthfile) {
-            stealthuncertain = true;
-            dmi_stealthuncertain = true;
+        if (!check->justastealthfile) {
+            check->stealthuncertain = true;
+            check->dmi_stealthuncertain = true;
             color(yellow);
             printf("DMI timestamp of authoring could not be compared to the SS%s", newline);
             color(normal);
@@ -20187,27 +21988,27 @@ void checkdmi(unsigned char *dmi) {
     }
     
     // calculate DMI crc32
-    dmi_crc32 = crc32(0, dmi, 2048);
-    if (verbose) printf("%sDMI CRC = %08lX%s", sp5, dmi_crc32, newline);
+    check->dmi_crc32 = crc32_fast(0, dmi, 2048);
+    if (verbose) printf("%sDMI CRC = %08lX%s", sp5, check->dmi_crc32, newline);
     
     if (lookslikexbox1dmi(dmi)) {
         color(yellow);
         printf("Looks like Xbox 1 DMI%s", newline);
         color(normal);
-        stealthuncertain = true;
-        dmi_stealthuncertain = true;
+        check->stealthuncertain = true;
+        check->dmi_stealthuncertain = true;
       return;
     }
     
     // get the DMI media id
-    memcpy(dmi_mediaid, dmi+0x20, 16);
+    memcpy(check->dmi_mediaid, dmi+0x20, 16);
     if (verbose) {
         printf("%sDMI Media ID: ", sp5);
-        printmediaid(dmi_mediaid);
+        printmediaid(check->dmi_mediaid);
     }
-    if (xex_foundmediaid) {
-        if (memcmp(xex_mediaid, dmi_mediaid, 16) != 0) {
-            dmi_stealthfailed = true;
+    if (check->xex_foundmediaid) {
+        if (memcmp(check->xex_mediaid, check->dmi_mediaid, 16) != 0) {
+            check->dmi_stealthfailed = true;
             if (verbose) printf("%s", newline);
             color(red);
             printf("DMI media id does not match this game!%s", newline);
@@ -20217,10 +22018,10 @@ void checkdmi(unsigned char *dmi) {
     }
     else {
         if (verbose) printf("%s", newline);
-        if (justastealthfile) checkcsv(dmi_mediaid);
+        if (check->justastealthfile) checkcsv(check->dmi_mediaid);
         else {
-            stealthuncertain = true;
-            dmi_stealthuncertain = true;
+            check->stealthuncertain = true;
+            check->dmi_stealthuncertain = true;
             color(yellow);
             printf("DMI media id could not be compared to the Xex%s", newline);
             color(normal);
@@ -20228,8 +22029,8 @@ void checkdmi(unsigned char *dmi) {
     }
     // check a few things that seem to be true for all xbox 360 dmi sectors
     if (!lookslike360dmi(dmi)) {
-        stealthuncertain = true;
-        dmi_stealthuncertain = true;
+        check->stealthuncertain = true;
+        check->dmi_stealthuncertain = true;
         color(yellow);
         printf("DMI does not look valid%s", newline);
         color(normal);
@@ -20239,7 +22040,7 @@ void checkdmi(unsigned char *dmi) {
         }
     }
     else if (memcmp(dmi+0x7FC, "\xFF\xFF\xFF\xFF", 4) == 0) {  // check for corruption that seems to be related to a certain sata->usb adapter
-        dmi_stealthuncertain = true;
+        check->dmi_stealthuncertain = true;
         color(yellow);
         printf("DMI appears to be corrupt!%s", newline);
         color(normal);
@@ -20248,7 +22049,7 @@ void checkdmi(unsigned char *dmi) {
             hexdump(dmi, DMI_HEX, 2048);
         }
     }
-    else if (!dmi_stealthfailed && !dmi_stealthuncertain) {
+    else if (!check->dmi_stealthfailed && !check->dmi_stealthuncertain) {
         color(green);
         printf("DMI looks valid%s", newline);
         color(normal);
@@ -20259,12 +22060,12 @@ void checkdmi(unsigned char *dmi) {
 bool lookslike360dmi(unsigned char* dmi) {
     if ((dmi[0] != 0x02) ||
         (memcmp(dmi+0x7E8, "XBOX", 4) != 0) ||
-        (getzeros(dmi, 0x50, 0x633) != 1508)) return false;
+        !zeroscan_allzeros(dmi+0x50, 1508)) return false;
   return true;
 }
 
 bool lookslikexbox1dmi(unsigned char* dmi) {
-    if ((dmi[0] != 0x01) || (getzeros(dmi, 0x8, 0xF) != 0) || (getzeros(dmi, 0x10, 0x17) == 8)) return false;
+    if ((dmi[0] != 0x01) || (getzeros(dmi, 0x8, 0xF) != 0) || zeroscan_allzeros(dmi+0x10, 8)) return false;
   return true;
 } 
 
@@ -20272,14 +22073,14 @@ void checkpfi(unsigned char *pfi) {
     int i;
     unsigned long m;
     bool pfirecognized = false;
-    pfi_crc32 = 0;
-    pfi_stealthfailed = false;
-    pfi_stealthuncertain = false;
-    pfi_foundsectorstotal = false;
-    pfi_alreadydumped = false;
+    check->pfi_crc32 = 0;
+    check->pfi_stealthfailed = false;
+    check->pfi_stealthuncertain = false;
+    check->pfi_foundsectorstotal = false;
+    check->pfi_alreadydumped = false;
     if (verbose && !minimal) printf("%sChecking PFI%s", newline, newline);
-    if (getzeros(pfi, 0, 2047) == 2048) {
-        pfi_stealthfailed = true;
+    if (zeroscan_allzeros(pfi, 2048)) {
+        check->pfi_stealthfailed = true;
         color(red);
         printf("PFI is blank!%s", newline);
         color(normal);
@@ -20287,30 +22088,30 @@ void checkpfi(unsigned char *pfi) {
     }
     
     // calculate PFI crc32
-    pfi_crc32 = crc32(0, pfi, 2048);
+    check->pfi_crc32 = crc32_fast(0, pfi, 2048);
     
-    if (layerbreak == -1) {
+    if (check->layerbreak == -1) {
         // we're probably checking just a pfi.bin so assume the layerbreak based on the existence
         // of "XGD3" at the beginning of the friendly name (assuming this PFI crc is recognized)
         for (m=0;m<num_pfientries;m++) {
-            if (pfi_crc32 == mostrecentpfientries[m].crc) {
+            if (check->pfi_crc32 == mostrecentpfientries[m].crc) {
                 if (strlen(mostrecentpfientries[m].description) >= 4 && memcmp(mostrecentpfientries[m].description, "XGD3", 4) == 0)
-                     layerbreak = 2133520;
-                else layerbreak = 1913760;
+                     check->layerbreak = 2133520;
+                else check->layerbreak = 1913760;
                 if (debug) printf("layerbreak (%ld) assumed based on PFI friendly name (%s)%s",
-                                  layerbreak, mostrecentpfientries[m].description, newline);
+                                  check->layerbreak, mostrecentpfientries[m].description, newline);
                 break;
             }
         }
         // assume this is a new XGD3 wave if the PFI crc is not recognized (or use the Xbox 1 layerbreak if it matches xbox1pficrc)
-        if (layerbreak == -1) {
-            if (pfi_crc32 == xbox1pficrc) {
-                layerbreak = 1913776;
-                if (debug) printf("Xbox 1 layerbreak (%ld) assumed since PFI matches xbox1pficrc%s", layerbreak, newline);
+        if (check->layerbreak == -1) {
+            if (check->pfi_crc32 == xbox1pficrc) {
+                check->layerbreak = 1913776;
+                if (debug) printf("Xbox 1 layerbreak (%ld) assumed since PFI matches xbox1pficrc%s", check->layerbreak, newline);
             }
             else {
-                layerbreak = 2133520;
-                if (debug) printf("XGD3 layerbreak (%ld) assumed since the PFI CRC was not recognized%s", layerbreak, newline);
+                check->layerbreak = 2133520;
+                if (debug) printf("XGD3 layerbreak (%ld) assumed since the PFI CRC was not recognized%s", check->layerbreak, newline);
             }
         }
     }
@@ -20332,62 +22133,62 @@ void checkpfi(unsigned char *pfi) {
     unsigned long pfi_endpsnL1 = getuint(pfi_endpsnL1hex);
     
     // here be dragons
-    int32_t layerbreakpsn = ~((layerbreak - 1 + 0x030000) ^ 0xFF000000);
-    pfi_sectorsL0 = pfi_endpsnL0 - pfi_startpsnL0 + 1;
-    pfi_sectorsL1 = pfi_endpsnL1 - pfi_startpsnL1 + 1;
+    int32_t layerbreakpsn = ~((check->layerbreak - 1 + 0x030000) ^ 0xFF000000);
+    check->pfi_sectorsL0 = pfi_endpsnL0 - pfi_startpsnL0 + 1;
+    check->pfi_sectorsL1 = pfi_endpsnL1 - pfi_startpsnL1 + 1;
     unsigned long long pfi_offsetL0 = ((unsigned long long) pfi_startpsnL0 - 0x030000) * 2048;
-    pfi_offsetL1 = ((unsigned long long) pfi_startpsnL1 - (unsigned long long) layerbreakpsn) * 2048 + ((unsigned long long) layerbreak * 2048);
-    pfi_offsetL0end = (unsigned long long) (pfi_endpsnL0 - pfi_startpsnL0 + 1) * 2048 + pfi_offsetL0 - 1;
-    unsigned long long pfi_offsetend = (unsigned long long) (pfi_endpsnL1 - pfi_startpsnL1 + 1) * 2048 + pfi_offsetL1 - 1;
-    pfi_sectorstotal = pfi_sectorsL0 + pfi_sectorsL1;
-    pfi_foundsectorstotal = true;
+    check->pfi_offsetL1 = ((unsigned long long) pfi_startpsnL1 - (unsigned long long) layerbreakpsn) * 2048 + ((unsigned long long) check->layerbreak * 2048);
+    check->pfi_offsetL0end = (unsigned long long) (pfi_endpsnL0 - pfi_startpsnL0 + 1) * 2048 + pfi_offsetL0 - 1;
+    unsigned long long pfi_offsetend = (unsigned long long) (pfi_endpsnL1 - pfi_startpsnL1 + 1) * 2048 + check->pfi_offsetL1 - 1;
+    check->pfi_sectorstotal = check->pfi_sectorsL0 + check->pfi_sectorsL1;
+    check->pfi_foundsectorstotal = true;
 
     // print that shit
-    if (extraverbose) printpfitable(pfi_startpsnL0, pfi_endpsnL0, pfi_startpsnL1, pfi_endpsnL1, pfi_sectorsL0, pfi_sectorsL1,
-                                           pfi_offsetL0, pfi_offsetL0end, pfi_offsetL1, pfi_offsetend, pfi_sectorstotal);
+    if (extraverbose) printpfitable(pfi_startpsnL0, pfi_endpsnL0, pfi_startpsnL1, pfi_endpsnL1, check->pfi_sectorsL0, check->pfi_sectorsL1,
+                                           pfi_offsetL0, check->pfi_offsetL0end, check->pfi_offsetL1, pfi_offsetend, check->pfi_sectorstotal);
     // check that the L0 data area doesn't overlap stealth files or game data
-    if (pfi_sectorsL0 > (video/2048 - number_of_stealth_sectors - (xgd3 ? 16 : 0))) {
-        pfi_stealthuncertain = true;
-        stealthuncertain = true;
+    if (check->pfi_sectorsL0 > (check->video/2048 - number_of_stealth_sectors - (check->xgd3 ? 16 : 0))) {
+        check->pfi_stealthuncertain = true;
+        check->stealthuncertain = true;
         color(yellow);
         printf("PFI L0 Data Area is more than %"LL"u sectors! This overlaps stealth files and/or game data!%s",
-               video/2048 - number_of_stealth_sectors - (xgd3 ? 16 : 0), newline);
+               check->video/2048 - number_of_stealth_sectors - (check->xgd3 ? 16 : 0), newline);
         color(normal);
     }
     
     // check for BCA (Burst Cutting Area) flag which indicates a unique barcode is burned onto the original disc
     // (but would any xbox 360 drives be able to read it?)
     if ((pfi[16] & 0x80) == 0x80) {
-        stealthuncertain = true;
+        check->stealthuncertain = true;
         color(yellow);
         printf("PFI BCA flag is on!%s", newline);
         color(normal);
     }
     
     // show PFI crc32
-    if (verbose) printf("%sPFI CRC = %08lX%s", sp5, pfi_crc32, newline);
+    if (verbose) printf("%sPFI CRC = %08lX%s", sp5, check->pfi_crc32, newline);
     if (debug) {
         // calculate PFI sha-1
-        sha1_starts(&ctx);
-        sha1_update(&ctx, pfi, 2048);
-        sha1_finish(&ctx, pfi_sha1);
+        sha1_starts(&check->ctx);
+        sha1_update(&check->ctx, pfi, 2048);
+        sha1_finish(&check->ctx, check->pfi_sha1);
         printf("%sPFI SHA-1 = ", sp5);
-        for (i=0; i<20; i++) printf("%02X", pfi_sha1[i]);
+        for (i=0; i<20; i++) printf("%02X", check->pfi_sha1[i]);
         printf("%s", newline);
     }
     
     for (m=0;m<num_pfientries;m++) {
-        if (pfi_crc32 == mostrecentpfientries[m].crc) {
+        if (check->pfi_crc32 == mostrecentpfientries[m].crc) {
             printf("PFI matches known data (%s)%s", mostrecentpfientries[m].description, newline);
             pfirecognized = true;
             break;
         }
     }
     if (!pfirecognized) {
-        pfi_stealthuncertain = true;
+        check->pfi_stealthuncertain = true;
         color(yellow);
-        if (pfi_crc32 == xbox1pficrc) printf("PFI matches known data (Xbox 1)%s", newline);
-        else if (ss_foundtimestamp && ss_authored <= lastknownwave) printf("PFI does not match known data (almost certainly corrupt)%s", newline);
+        if (check->pfi_crc32 == xbox1pficrc) printf("PFI matches known data (Xbox 1)%s", newline);
+        else if (check->ss_foundtimestamp && check->ss_authored <= lastknownwave) printf("PFI does not match known data (almost certainly corrupt)%s", newline);
         else printf("PFI does not match known data (probably corrupt but might be a brand new wave\n"
                     "if this is a new game and abgx360.dat hasn't been updated yet)%s", newline);
         color(normal);
@@ -20410,10 +22211,417 @@ bool lookslikepfi(unsigned char* pfi) {
     // these 3 bytes should be zero
     if ((pfi[0x4] != 0) || (pfi[0x8] != 0) || (pfi[0xC] != 0)) return false;
     // as well as all of these
-    if (getzeros(pfi, 0x11, 0x7FF) != 2031) return false;
+    if (!zeroscan_allzeros(pfi+0x11, 2031)) return false;
   return true;
 }
 
+bool onepasshasrange(struct onepassrange *range, unsigned long long start, unsigned long long end) {
+  return range->valid && range->start == start && range->end == end;
+}
+
+#ifndef WIN32
+void onepasscrc(void *arg, const unsigned char *data, size_t length, unsigned long long offset) {
+    struct onepassrange *range = (struct onepassrange *) arg;
+    (void) offset;
+    if (range->chunks != NULL) chunkmanifest_update(range->chunks, data, length);
+    else if (data == NULL) range->crc = crc32_zeros(range->crc, length);
+    else range->crc = crc32_fast(range->crc, data, length);
+  return;
+}
+
+void onepasszeros(void *arg, const unsigned char *data, size_t length, unsigned long long offset) {
+    struct onepassrange *range = (struct onepassrange *) arg;
+    size_t n;
+    if (range->founddata || data == NULL) return;
+    n = zeroscan_firstnonzero(data, length);
+    if (n < length) {
+        range->founddata = true;
+        range->firstdata = offset + n;
+    }
+  return;
+}
+
+void onepassgame(void *arg, const unsigned char *data, size_t length, unsigned long long offset) {
+    struct onepassrange *range = (struct onepassrange *) arg;
+    size_t n;
+    if (range->chunks != NULL) {
+        chunkmanifest_update(range->chunks, data, length);
+        if (data == NULL) return;
+    }
+    else if (data == NULL) {
+        range->crc = crc32_zeros(range->crc, length);
+      return;
+    }
+    else range->crc = crc32_fast(range->crc, data, length);
+    // same search as docheckgamecrc() does: "DVDVIDEO-" at the start of every sector
+    n = (size_t) ((2048 - (offset - range->start) % 2048) % 2048);
+    for (;n+9<=length;n+=2048) {
+        if (memcmp(data+n, "DVDVIDEO-", 9) == 0 && check->onepassresults.corruptionoffsetcount < 100) {
+            check->onepassresults.corruptionoffset[check->onepassresults.corruptionoffsetcount] = offset + n;
+            check->onepassresults.corruptionoffsetcount++;
+        }
+    }
+  return;
+}
+
+void onepassprogress(void *arg, unsigned long long bytesdone, unsigned long long bytestotal) {
+    unsigned long *lastpercent = (unsigned long *) arg;
+    unsigned long percent = (unsigned long) (bytesdone * 100 / bytestotal);
+    if (percent != *lastpercent) {
+        *lastpercent = percent;
+        resetstderr();
+        charsprinted = fprintf(stderr, "Scanning ISO... %2lu%% ", percent);
+    }
+  return;
+}
+
+void onepassadd(struct fusedscan *fs, struct onepassrange *range, unsigned long long start, unsigned long long end,
+                fusedscan_func func) {
+    if (onepasshasrange(range, start, end)) return;  // already known from the result cache
+    memset(range, 0, sizeof(struct onepassrange));
+    range->valid = true;
+    range->start = start;
+    range->end = end;
+    fusedscan_add(fs, start, end, func, range);
+  return;
+}
+
+int onepassreadpadding(char *isofilename, FILE *stream, struct onepassrange *range, unsigned long sizeoverbuffer,
+                       unsigned long bufferremainder, long *dataloop, char *name) {
+    // the padding check loops leave the BIGBUF_SIZE chunk where data was first found in bigbuffer (and its index in dataloop,
+    // or -1 for the remainder) for the code that shows and zeroes it, so do the same for the chunk the single pass scan found
+    unsigned long long chunkoffset;
+    unsigned long chunksize;
+    unsigned long m = (unsigned long) ((range->firstdata - range->start) / BIGBUF_SIZE);
+    if (m < sizeoverbuffer) {
+        *dataloop = (long) m;
+        chunkoffset = range->start + (unsigned long long) m * BIGBUF_SIZE;
+        chunksize = BIGBUF_SIZE;
+    }
+    else {
+        *dataloop = -1;
+        chunkoffset = range->end - bufferremainder;
+        chunksize = bufferremainder;
+    }
+    if (debug) printf("data found at 0x%"LL"X, dataloop = %ld%s", range->firstdata, *dataloop, newline);
+    if (fseeko(stream, chunkoffset, SEEK_SET) != 0) {
+        printseekerror(isofilename, "Checking zero padding");
+      return 1;
+    }
+    if (checkreadandprinterrors(check->bigbuffer, 1, chunksize, stream, 0, chunkoffset, name, "Checking zero padding") != 0) return 1;
+  return 0;
+}
+
+void doonepassscan(char *isofilename, FILE *stream, bool checkvideopadding) {
+    // read the video partition, video padding and game partition in one forward sweep so that checkvideo() and
+    // docheckgamecrc() can use the results instead of seeking around the ISO and reading each of them separately
+    struct fusedscan fs;
+    unsigned long lastpercent = 0;
+    unsigned long long L0paddingend = check->video - (number_of_stealth_sectors+(check->xgd3 ? 16 : 0))*2048;
+    unsigned long long L1paddingstart = assume_start_offset_of_L1_padding();
+    // same as docheckgamecrc()
+    unsigned long long gamesize = (check->xgd3 ? 8662351872LL : 7307001856LL);
+    int status;
+    clearonepassresults();
+    if (!check->pfi_foundsectorstotal) return;
+    fusedscan_init(&fs);
+    // only ranges that pass the same sanity checks checkvideo() and docheckgamecrc() make before reading them
+    if ((unsigned long long) check->pfi_sectorsL0*2048 <= L0paddingend &&
+        (unsigned long long) check->fpfilesize >= check->pfi_offsetL1 + check->pfi_sectorsL1 * 2048) {
+        onepassadd(&fs, &check->onepassresults.videoL0, 0, (unsigned long long) check->pfi_sectorsL0*2048, onepasscrc);
+        onepassadd(&fs, &check->onepassresults.videoL1, check->pfi_offsetL1, check->pfi_offsetL1 + check->pfi_sectorsL1 * 2048, onepasscrc);
+        check->onepassresults.videoL0.chunks = startmanifestregion("videoL0", stream, 0, (unsigned long long) check->pfi_sectorsL0*2048);
+        check->onepassresults.videoL1.chunks = startmanifestregion("videoL1", stream, check->pfi_offsetL1,
+                                                                   check->pfi_offsetL1 + check->pfi_sectorsL1 * 2048);
+    }
+    if (checkvideopadding) {
+        if ((unsigned long long) check->pfi_sectorsL0*2048 < L0paddingend)
+            onepassadd(&fs, &check->onepassresults.paddingL0, (unsigned long long) check->pfi_sectorsL0*2048, L0paddingend, onepasszeros);
+        if (L1paddingstart && check->pfi_offsetL1 > L1paddingstart && check->pfi_offsetL1 % 2048 == 0 && L1paddingstart % 2048 == 0 &&
+            (unsigned long long) check->fpfilesize >= check->pfi_offsetL1)
+            onepassadd(&fs, &check->onepassresults.paddingL1, L1paddingstart, check->pfi_offsetL1, onepasszeros);
+    }
+    if (!check->checkgamecrcnever && !check->isotoosmall && (unsigned long long) check->fpfilesize >= check->video + gamesize) {
+        onepassadd(&fs, &check->onepassresults.game, check->video, check->video + gamesize, onepassgame);
+        check->onepassresults.game.chunks = startmanifestregion("game", stream, check->video, check->video + gamesize);
+    }
+    if (fs.numconsumers == 0) {
+        clearonepassresults();
+      return;
+    }
+    initcheckread();
+    charsprinted = 0;
+    status = fusedscan_run(&fs, fileno(stream), BIGBUF_SIZE, readretries, &check->readsettings, onepassprogress, &lastpercent);
+    check->readerrorstotal += fs.retries;
+    check->readerrorsrecovered += fs.recovered;
+    clearstderr();
+    if (status != READAHEAD_OK) {
+        clearonepassresults();
+        color(yellow);
+        if (status == READAHEAD_EOF)
+            printf("Single pass scan reached End of File at 0x%"LL"X, checking everything separately instead%s",
+                   fs.erroroffset, newline);
+        else if (status == READAHEAD_READERROR)
+            printf("Single pass scan failed at 0x%"LL"X (%s), checking everything separately instead%s",
+                   fs.erroroffset, strerror(fs.error), newline);
+        else printf("Single pass scan could not be started, checking everything separately instead%s", newline);
+        color(normal);
+      return;
+    }
+    donecheckread(isofilename);
+    if (check->onepassresults.videoL0.chunks != NULL) check->onepassresults.videoL0.crc = chunkmanifest_crc(check->onepassresults.videoL0.chunks);
+    if (check->onepassresults.videoL1.chunks != NULL) check->onepassresults.videoL1.crc = chunkmanifest_crc(check->onepassresults.videoL1.chunks);
+    if (check->onepassresults.game.chunks != NULL) check->onepassresults.game.crc = chunkmanifest_crc(check->onepassresults.game.chunks);
+    if (debug) printf("Single pass scan read %"LL"u bytes for %d ranges%s", fs.bytesdone, fs.numconsumers, newline);
+  return;
+}
+
+struct onepassrange *cachedrange(int index) {
+    switch (index) {
+        case RESULTCACHE_VIDEOL0:   return &check->onepassresults.videoL0;
+        case RESULTCACHE_VIDEOL1:   return &check->onepassresults.videoL1;
+        case RESULTCACHE_PADDINGL0: return &check->onepassresults.paddingL0;
+        case RESULTCACHE_PADDINGL1: return &check->onepassresults.paddingL1;
+        default:                    return &check->onepassresults.game;
+    }
+}
+
+void applyresultcache() {
+    // hand everything the cache knows about to the single pass results so checkvideo and docheckgamecrc skip those reads
+    int i;
+    struct onepassrange *range;
+    if (!check->cachehit) return;
+    for (i=0;i<RESULTCACHE_NUMRANGES;i++) {
+        if (!check->cache.ranges[i].valid) continue;
+        range = cachedrange(i);
+        range->valid = true;
+        range->start = check->cache.ranges[i].start;
+        range->end = check->cache.ranges[i].end;
+        range->crc = check->cache.ranges[i].crc;
+        range->founddata = check->cache.ranges[i].founddata;
+        range->firstdata = check->cache.ranges[i].firstdata;
+    }
+    if (check->cache.ranges[RESULTCACHE_GAME].valid) {
+        check->onepassresults.corruptionoffsetcount = check->cache.corruptionoffsetcount;
+        memcpy(check->onepassresults.corruptionoffset, check->cache.corruptionoffset, sizeof(check->onepassresults.corruptionoffset));
+    }
+  return;
+}
+
+void clearonepassresults() {
+    memset(&check->onepassresults, 0, sizeof(struct onepassresults));
+    applyresultcache();
+  return;
+}
+
+void loadresultcache() {
+    struct resultcache_key key;
+    unsigned long long stealthstart;
+    size_t stealthsize;
+    unsigned char *stealthbuffer;
+    char dir[2048];
+    if (check->cacheloaded) return;
+    check->cacheloaded = true;
+    // a manifest can only be built from the reads a cache hit would skip
+    if (!resultcache || makemanifest || homeless || check->fp == NULL || check->video == 0) return;
+    if (resultcache_getkey(fileno(check->fp), &key) != 0) {
+        if (debug) printf("Not using the result cache for this image (%s)%s", strerror(errno), newline);
+      return;
+    }
+    // the stealth sectors go into the key too so a file that was rewritten in place with its mtime restored
+    // still won't match unless the stealth files are the same
+    stealthsize = (number_of_stealth_sectors + (check->xgd3 ? 16 : 0)) * 2048;
+    if (check->video < stealthsize) return;
+    stealthstart = check->video - stealthsize;
+    stealthbuffer = malloc(stealthsize);
+    if (stealthbuffer == NULL) return;
+    fflush(check->fp);
+    if (pread(fileno(check->fp), stealthbuffer, stealthsize, (off_t) stealthstart) != (ssize_t) stealthsize) {
+        free(stealthbuffer);
+      return;
+    }
+    key.stealthcrc = crc32_fast(0, stealthbuffer, stealthsize);
+    free(stealthbuffer);
+    snprintf(dir, sizeof(dir), "%s%s%s", homedir, abgxdir, resultcachedir);
+    resultcache_filename(check->cachefilename, sizeof(check->cachefilename), dir, &key);
+    check->cacheenabled = true;
+    check->cachedirty = false;
+    check->cachetime = time(NULL);
+    if (resultcache_load(check->cachefilename, &key, &check->cache) == 0) {
+        check->cachehit = true;
+        if (verbose) printf("%sUsing the results cached the last time this image was checked%s", sp5, newline);
+        applyresultcache();
+    }
+    else if (debug) printf("No cached results for this image in '%s'%s", check->cachefilename, newline);
+  return;
+}
+
+void cacheresult(int index, unsigned long long start, unsigned long long end, unsigned long crc, bool founddata, unsigned long long firstdata) {
+    struct resultcache_range *range;
+    if (!check->cacheenabled) return;
+    range = &check->cache.ranges[index];
+    if (range->valid && range->start == start && range->end == end && range->crc == crc &&
+        range->founddata == founddata && range->firstdata == firstdata) return;
+    range->valid = true;
+    range->start = start;
+    range->end = end;
+    range->crc = crc;
+    range->founddata = founddata;
+    range->firstdata = firstdata;
+    check->cachedirty = true;
+  return;
+}
+
+void cachegameresult(unsigned long long start, unsigned long long end) {
+    int count;
+    if (!check->cacheenabled) return;
+    count = check->corruptionoffsetcount;
+    if (count > RESULTCACHE_MAXCORRUPTIONOFFSETS) count = RESULTCACHE_MAXCORRUPTIONOFFSETS;
+    if (check->cache.corruptionoffsetcount != count ||
+        memcmp(check->cache.corruptionoffset, check->corruptionoffset, count * sizeof(unsigned long long)) != 0) {
+        check->cache.corruptionoffsetcount = count;
+        memcpy(check->cache.corruptionoffset, check->corruptionoffset, count * sizeof(unsigned long long));
+        check->cachedirty = true;
+    }
+    cacheresult(RESULTCACHE_GAME, start, end, check->game_crc32, false, 0);
+  return;
+}
+
+void saveresultcache() {
+    struct resultcache_key key;
+    if (!check->cacheenabled) return;
+    check->cacheenabled = false;
+    if (check->cache.ss_crc32 != check->ss_crc32 || check->cache.dmi_crc32 != check->dmi_crc32 ||
+        check->cache.pfi_crc32 != check->pfi_crc32 || check->cache.xex_crc32 != check->xex_crc32) {
+        check->cache.ss_crc32 = check->ss_crc32;
+        check->cache.dmi_crc32 = check->dmi_crc32;
+        check->cache.pfi_crc32 = check->pfi_crc32;
+        check->cache.xex_crc32 = check->xex_crc32;
+        check->cachedirty = true;
+    }
+    if (!check->cachedirty || check->fp == NULL) return;
+    // don't save anything if the image changed while it was being checked, or so recently that
+    // another change within the same mtime tick wouldn't be noticed
+    if (resultcache_getkey(fileno(check->fp), &key) != 0 || !resultcache_samefile(&key, &check->cache.key)) {
+        if (debug) printf("Not caching results, the image changed while it was being checked%s", newline);
+      return;
+    }
+    if (key.mtime_sec >= (long long) check->cachetime - 1) {
+        if (debug) printf("Not caching results, the image was modified too recently%s", newline);
+      return;
+    }
+    lockshared();
+    if (resultcache_save(check->cachefilename, &check->cache) != 0) {
+        if (debug) printf("Failed to save the result cache to '%s' (%s)%s", check->cachefilename, strerror(errno), newline);
+    }
+    unlockshared();
+  return;
+}
+
+struct chunkmanifest_region *startmanifestregion(const char *name, FILE *stream, unsigned long long start, unsigned long long end) {
+    // returns the region to build the chunk CRCs of [start, end) into for --manifest, or NULL to just do the usual crc
+    struct chunkmanifest_region *region;
+    struct stat st;
+    if (!makemanifest || stream != check->fp) return NULL;
+    // the manifest is saved next to the image, a disc in a drive doesn't have a "next to"
+    if (fstat(fileno(stream), &st) != 0 || !S_ISREG(st.st_mode)) return NULL;
+    if (check->manifest.chunksize == 0) chunkmanifest_init(&check->manifest, (unsigned long long) check->fpfilesize, CHUNKMANIFEST_CHUNKSIZE);
+    region = chunkmanifest_addregion(&check->manifest, name, start, end);
+    if (region == NULL && debug) printf("Failed to start the %s region of the chunk manifest%s", name, newline);
+  return region;
+}
+
+void savemanifest() {
+    char filename[2048];
+    if (!makemanifest || check->isofilename == NULL || check->manifest.numregions == 0) return;
+    snprintf(filename, sizeof(filename), "%s.chunks", check->isofilename);
+    returnvalue = chunkmanifest_save(&check->manifest, filename);
+    if (returnvalue == -1) {
+        color(yellow);
+        printf("Failed to save the chunk manifest to '%s' (%s)%s", filename, strerror(errno), newline);
+        color(normal);
+    }
+    else if (returnvalue == 0 && verbose) printf("Saved the chunk manifest to '%s'%s", filename, newline);
+    else if (returnvalue == 1 && debug) printf("No complete regions to save to the chunk manifest%s", newline);
+    chunkmanifest_free(&check->manifest);
+  return;
+}
+
+void reverifyprogress(void *arg, unsigned long long bytesdone, unsigned long long bytestotal) {
+    unsigned long *lastpercent = (unsigned long *) arg;
+    unsigned long percent = bytestotal ? (unsigned long) (bytesdone * 100 / bytestotal) : 100;
+    if (percent != *lastpercent) {
+        *lastpercent = percent;
+        resetstderr();
+        charsprinted = fprintf(stderr, "Reverifying... %2lu%% ", percent);
+    }
+  return;
+}
+
+int doreverify() {
+    // reread the image against the chunk manifest --manifest saved next to it, stopping at the first chunk that changed
+    char filename[2048];
+    struct chunkmanifest cm;
+    struct chunkmanifest_mismatch mismatches[16];
+    struct chunkmanifest_region *region;
+    unsigned long lastpercent = 0, numchunks = 0;
+    long found;
+    int i, threads = crcthreads;
+    snprintf(filename, sizeof(filename), "%s.chunks", check->isofilename);
+    if (chunkmanifest_load(&cm, filename) != 0) {
+        color(red);
+        printf("ERROR: Failed to load the chunk manifest '%s' (%s)%s", filename, strerror(errno), newline);
+        color(normal);
+      return 1;
+    }
+    if (cm.filesize != (unsigned long long) check->fpfilesize) {
+        color(yellow);
+        printf("Image size has changed since the chunk manifest was saved (was %"LL"u bytes, now %"LL"d bytes)%s",
+               cm.filesize, check->fpfilesize, newline);
+        color(normal);
+    }
+    // the chunks are independent so use every cpu unless --crcthreads says otherwise
+    if (!crcthreadsarg) threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads < 1) threads = 1;
+    for (i=0;i<cm.numregions;i++) numchunks += cm.regions[i].numchunks;
+    if (verbose) printf("Reverifying %lu chunks of %"LL"u MB on %d thread%s%s", numchunks, cm.chunksize / 1048576, threads,
+                        threads == 1 ? "" : "s", newline);
+    initcheckread();
+    charsprinted = 0;
+    found = chunkmanifest_verify(&cm, fileno(check->fp), threads, 2048, readretries, true, mismatches, 16,
+                                 reverifyprogress, &lastpercent);
+    clearstderr();
+    if (found == -1) {
+        color(red);
+        printf("ERROR: Failed to start reverifying (%s)%s", strerror(errno), newline);
+        color(normal);
+        chunkmanifest_free(&cm);
+      return 1;
+    }
+    if (found == 0) {
+        color(green);
+        printf("All %lu chunks match the chunk manifest%s", numchunks, newline);
+        color(normal);
+        chunkmanifest_free(&cm);
+      return 0;
+    }
+    color(red);
+    printf("Found %ld chunk%s that changed since the chunk manifest was saved (stopped at the first one)%s",
+           found, found == 1 ? "" : "s", newline);
+    color(normal);
+    for (i=0;i<found && i<16;i++) {
+        region = &cm.regions[mismatches[i].region];
+        printf("%s%s sectors %"LL"u-%"LL"u (0x%09"LL"X-0x%09"LL"X): ", sp5, region->name,
+               mismatches[i].start / 2048, (mismatches[i].end - 1) / 2048, mismatches[i].start, mismatches[i].end - 1);
+        if (mismatches[i].status == READAHEAD_EOF) printf("End of File reached%s", newline);
+        else if (mismatches[i].status == READAHEAD_READERROR) printf("unrecoverable read error (%s)%s", strerror(mismatches[i].error), newline);
+        else printf("CRC = %08lX, expected %08lX%s", mismatches[i].crc, region->crcs[mismatches[i].chunk], newline);
+    }
+    chunkmanifest_free(&cm);
+  return 1;
+}
+#endif
+
 void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkvideopadding) {
     int i, j, b;
     unsigned long m;
@@ -20421,61 +22629,61 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
     bool videorecognized = false;
     unsigned char spaces[128];
     memset(spaces, 0x20, 128);
-    video_crc32 = 0;
-    videoL0_crc32 = 0;
-    videoL1_crc32 = 0;
-    video_stealthfailed = false;
-    video_stealthuncertain = false;
+    check->video_crc32 = 0;
+    check->videoL0_crc32 = 0;
+    check->videoL1_crc32 = 0;
+    check->video_stealthfailed = false;
+    check->video_stealthuncertain = false;
     // seek to sector 16 and look for a video partition
     if (fseeko(stream, 32768, SEEK_SET) != 0) {
         printseekerror(isofilename, "Checking Video");
-        video_stealthuncertain = true;
+        check->video_stealthuncertain = true;
       return;
     }
-    memset(buffer, 0, 2048);
+    memset(check->buffer, 0, 2048);
     initcheckread();
-    if (checkreadandprinterrors(buffer, 1, 2048, stream, 0, 32768, isofilename, "Video check") != 0) {
-        video_stealthuncertain = true;
+    if (checkreadandprinterrors(check->buffer, 1, 2048, stream, 0, 32768, isofilename, "Video check") != 0) {
+        check->video_stealthuncertain = true;
       return;
     }
     donecheckread(isofilename);
-    if (getzeros((unsigned char*) buffer, 0, 2047) == 2048) {
-        video_stealthfailed = true;
+    if (zeroscan_allzeros((unsigned char*) check->buffer, 2048)) {
+        check->video_stealthfailed = true;
         color(red);
         printf("Video partition sector 16 is blank! (most likely the rest is too)%s", newline);
         color(normal);
       return;
     }
-    if (memcmp(buffer+1, "CD001", 5) != 0) {
+    if (memcmp(check->buffer+1, "CD001", 5) != 0) {
         // "CD001" was not found at sector 16
-        video_stealthfailed = true;
+        check->video_stealthfailed = true;
         color(red);
         printf("Video partition Standard Identifier not found!%s", newline);
         color(normal);
       return;
     }
-    unsigned long videosize = getint(buffer+80);
+    unsigned long videosize = getint(check->buffer+80);
     if (verbose) printf("Video partition found%s", newline);
     if (extraverbose) {
         // print the volume identifier (omitting control codes and stopping at trailing space(s) or a null byte)
         printf("%sVolume ID: %s", sp5, quotation);
         for (b=40; b<72; b++) {
-            if (memcmp(buffer+b, spaces, 72-b) == 0) break;
-            if (buffer[b] == 0) break;
-            if (buffer[b] < 0x20) continue;
-            printf("%c", buffer[b]);
+            if (memcmp(check->buffer+b, spaces, 72-b) == 0) break;
+            if (check->buffer[b] == 0) break;
+            if (check->buffer[b] < 0x20) continue;
+            printf("%c", check->buffer[b]);
         }
         printf("%s%s", quotation, newline);
         // print the volume space size
         printf("%sVolume space size: %lu sectors (%lu bytes)%s", sp5, videosize, videosize*2048, newline);
         // print the volume creation date and time
         printf("%sVolume creation date %s time: ", sp5, ampersand);
-        int timezonehrs = buffer[829]*15/60;
-        int timezonemins = buffer[829]*15%60;
+        int timezonehrs = check->buffer[829]*15/60;
+        int timezonemins = check->buffer[829]*15%60;
         printf("%c%c%c%c/%c%c/%c%c %c%c:%c%c:%c%c (GMT",
-                buffer[813], buffer[814], buffer[815], buffer[816], buffer[817],
-                buffer[818], buffer[819], buffer[820], buffer[821], buffer[822],
-                buffer[823], buffer[824], buffer[825], buffer[826]);
+                check->buffer[813], check->buffer[814], check->buffer[815], check->buffer[816], check->buffer[817],
+                check->buffer[818], check->buffer[819], check->buffer[820], check->buffer[821], check->buffer[822],
+                check->buffer[823], check->buffer[824], check->buffer[825], check->buffer[826]);
         if ((timezonehrs < 0) || (timezonemins < 0)) printf("-");
         else printf("+");
         if (timezonemins < 0) timezonemins = timezonemins * -1;
@@ -20493,24 +22701,33 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
         printf("%s%s", quotation, newline);
         */
     }
+    #ifndef WIN32
+        if (!justavideoiso && stream == check->fp) loadresultcache();
+        if (onepass && !justavideoiso) doonepassscan(isofilename, stream, checkvideopadding);
+    #endif
     if (checkvideopadding && !justavideoiso) {
         long dataloop = 0;
         bool openforwriting = false;
         unsigned long long padding_offsetL1start = 0;
-        if (!pfi_foundsectorstotal) {
+        #ifndef WIN32
+            // holes in sparse images are known to be zeroes, so the padding loops skip them without reading
+            struct sparsemap sparse;
+            sparse_init(&sparse, fileno(stream));
+        #endif
+        if (!check->pfi_foundsectorstotal) {
             color(yellow);
             printf("Cannot check Video padding because PFI is missing%s", newline);
             color(normal);
             goto skipvideopadding;
         }
         // check L0 video padding
-        if (pfi_sectorsL0 == video/2048 - (number_of_stealth_sectors+(xgd3 ? 16 : 0))) {
+        if (check->pfi_sectorsL0 == check->video/2048 - (number_of_stealth_sectors+(check->xgd3 ? 16 : 0))) {
             // there is no L0 video padding
             if (verbose) printf("%s", sp5);
             printf("Skipped checking L0 Video padding because there is none%s", newline);
             goto skipL0videopadding;
         }
-        if (pfi_sectorsL0 > video/2048 - (number_of_stealth_sectors+(xgd3 ? 16 : 0))) {
+        if (check->pfi_sectorsL0 > check->video/2048 - (number_of_stealth_sectors+(check->xgd3 ? 16 : 0))) {
             // there isn't even enough room for L0 video
             color(red);
             printf("Cannot check L0 Video padding because the PFI L0 Data Area is too large!%s", newline);
@@ -20518,52 +22735,73 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
             goto skipL0videopadding;
         }
         // (video/2048 - (number_of_stealth_sectors+(xgd3 ? 16 : 0)) - pfi_sectorsL0) sectors should be blank starting at offset pfi_sectorsL0*2048
-        if (fseeko(stream, (unsigned long long) pfi_sectorsL0*2048, SEEK_SET) != 0) {
+        if (fseeko(stream, (unsigned long long) check->pfi_sectorsL0*2048, SEEK_SET) != 0) {
             printseekerror(isofilename, "Checking L0 Video padding");
             goto skipL0videopadding;
         }
-        memset(bigbuffer, 0, BIGBUF_SIZE);
-        sizeoverbuffer =  (unsigned long) ( (video - (number_of_stealth_sectors+(xgd3 ? 16 : 0))*2048 - pfi_sectorsL0*2048) / BIGBUF_SIZE );
-        bufferremainder = (unsigned long) ( (video - (number_of_stealth_sectors+(xgd3 ? 16 : 0))*2048 - pfi_sectorsL0*2048) % BIGBUF_SIZE );
+        memset(check->bigbuffer, 0, BIGBUF_SIZE);
+        check->sizeoverbuffer =  (unsigned long) ( (check->video - (number_of_stealth_sectors+(check->xgd3 ? 16 : 0))*2048 - check->pfi_sectorsL0*2048) / BIGBUF_SIZE );
+        check->bufferremainder = (unsigned long) ( (check->video - (number_of_stealth_sectors+(check->xgd3 ? 16 : 0))*2048 - check->pfi_sectorsL0*2048) % BIGBUF_SIZE );
         initcheckread();
         bool videoL0zeropadding = true;
         dataloop = 0;
         if (verbose) printf("%s", sp5);
+        #ifndef WIN32
+            if (onepasshasrange(&check->onepassresults.paddingL0, (unsigned long long) check->pfi_sectorsL0*2048,
+                                check->video - (number_of_stealth_sectors+(check->xgd3 ? 16 : 0))*2048)) {
+                // the single pass scan already checked it, just read the buffer where the data starts (if any) like the loop below would have
+                if (check->onepassresults.paddingL0.founddata) {
+                    videoL0zeropadding = false;
+                    if (onepassreadpadding(isofilename, stream, &check->onepassresults.paddingL0, check->sizeoverbuffer, check->bufferremainder, &dataloop, "L0 Video padding") != 0)
+                        goto skipL0videopadding;
+                }
+                goto skipL0remainder;
+            }
+        #endif
         fprintf(stderr, "Checking L0 Video padding... ");
         charsprinted = 0;
-        for (m=0;m<sizeoverbuffer;m++) {
-            if (m && sizeoverbuffer >= 100 && m % (sizeoverbuffer / 100) == 0 && roundf(((float) m / ((float) sizeoverbuffer / 100))) <= 100.0) {
+        for (m=0;m<check->sizeoverbuffer;m++) {
+            if (m && check->sizeoverbuffer >= 100 && m % (check->sizeoverbuffer / 100) == 0 && roundf(((float) m / ((float) check->sizeoverbuffer / 100))) <= 100.0) {
                 resetstderr();
-                charsprinted = fprintf(stderr, "%2lu%% ", (unsigned long) roundf(((float) m / ((float) sizeoverbuffer / 100))));
+                charsprinted = fprintf(stderr, "%2lu%% ", (unsigned long) roundf(((float) m / ((float) check->sizeoverbuffer / 100))));
             }
-            if (checkreadandprinterrors(bigbuffer, 1, BIGBUF_SIZE, stream, m,
-                                        (unsigned long long) pfi_sectorsL0*2048,
+            #ifndef WIN32
+                if (sparse_iszero(&sparse, (unsigned long long) m*BIGBUF_SIZE + check->pfi_sectorsL0*2048, BIGBUF_SIZE)) {
+                    if (fseeko(stream, (unsigned long long) (m+1)*BIGBUF_SIZE + check->pfi_sectorsL0*2048, SEEK_SET) != 0) {
+                        printseekerror(isofilename, "Checking L0 Video padding");
+                        goto skipL0videopadding;
+                    }
+                  continue;
+                }
+            #endif
+            if (checkreadandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, stream, m,
+                                        (unsigned long long) check->pfi_sectorsL0*2048,
                                         "L0 Video padding", "Checking zero padding") != 0) {
                 goto skipL0videopadding;
             }
-            if (getzeros(bigbuffer, 0, BIGBUF_SIZE - 1) != BIGBUF_SIZE) {
+            if (!zeroscan_allzeros(check->bigbuffer, BIGBUF_SIZE)) {
                 videoL0zeropadding = false;
                 dataloop = m;
                 if (debug) {
                     printf("data found at 0x%"LL"X, current offset: 0x%"LL"X, dataloop = %ld%s",
-                            (unsigned long long) m*BIGBUF_SIZE + pfi_sectorsL0*2048,
+                            (unsigned long long) m*BIGBUF_SIZE + check->pfi_sectorsL0*2048,
                             (unsigned long long) ftello(stream), dataloop, newline);
                 }
                 goto skipL0remainder;
             }
         }
-        if (bufferremainder) {
-            if (checkreadandprinterrors(bigbuffer, 1, bufferremainder, stream, 0,
-                                        video - (number_of_stealth_sectors+(xgd3 ? 16 : 0))*2048 - bufferremainder,
+        if (check->bufferremainder) {
+            if (checkreadandprinterrors(check->bigbuffer, 1, check->bufferremainder, stream, 0,
+                                        check->video - (number_of_stealth_sectors+(check->xgd3 ? 16 : 0))*2048 - check->bufferremainder,
                                         "L0 Video padding", "Checking zero padding") != 0) {
                 goto skipL0videopadding;
             }
-            if (getzeros(bigbuffer, 0, bufferremainder - 1) != bufferremainder) {
+            if (!zeroscan_allzeros(check->bigbuffer, check->bufferremainder)) {
                 videoL0zeropadding = false;
                 dataloop = -1;  // identify that data was found in the bufferremainder
                 if (debug) {
                     printf("data found at 0x%"LL"X, current offset: 0x%"LL"X, dataloop = %ld%s",
-                            video - (number_of_stealth_sectors+(xgd3 ? 16 : 0))*2048 - bufferremainder,
+                            check->video - (number_of_stealth_sectors+(check->xgd3 ? 16 : 0))*2048 - check->bufferremainder,
                             (unsigned long long) ftello(stream), dataloop, newline);
                 }
                 goto skipL0remainder;
@@ -20572,13 +22810,20 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
         clearstderr();
         skipL0remainder:
         donecheckread("L0 Video padding");
+        #ifndef WIN32
+            if (stream == check->fp)
+                cacheresult(RESULTCACHE_PADDINGL0, (unsigned long long) check->pfi_sectorsL0*2048,
+                            check->video - (number_of_stealth_sectors+(check->xgd3 ? 16 : 0))*2048, 0, !videoL0zeropadding,
+                            dataloop == -1 ? check->video - (number_of_stealth_sectors+(check->xgd3 ? 16 : 0))*2048 - check->bufferremainder :
+                                             (unsigned long long) dataloop*BIGBUF_SIZE + check->pfi_sectorsL0*2048);
+        #endif
         if (videoL0zeropadding) {
             color(green);
             printf("L0 Video is zero padded%s", newline);
             color(normal);
             goto skipL0videopadding;
         }
-        if (!xgd3 && !padL0) {
+        if (!check->xgd3 && !padL0) {
             fprintf(stderr, "\n");
             color(yellow);
             printf("-------------------------------------------------------------------------------%s"
@@ -20598,7 +22843,7 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
             color(normal);
             goto skipL0videopadding;
         }
-        if (!writefile) {
+        if (!check->writefile) {
             color(yellow);
             printf("L0 Video padding contains data but it won't be zeroed because writing is disabled%s", newline);
             color(normal);
@@ -20606,20 +22851,20 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
         }
         printf("L0 Video padding contains data, overwriting it with zeroes...%s", newline);
         if (extraverbose) {
-            if (dataloop == -1) memset(bigbuffer+bufferremainder, 0, BIGBUF_SIZE - bufferremainder);
+            if (dataloop == -1) memset(check->bigbuffer+check->bufferremainder, 0, BIGBUF_SIZE - check->bufferremainder);
             sectoroffset = 0;
             for (i=0;i<(BIGBUF_SIZE/2048);i++) {
                 if (debug) printf("%d: %lu zeros%s", i,
-                                   getzeros(bigbuffer, (unsigned long) i*2048, (unsigned long) i*2048+2047), newline);
-                if (getzeros(bigbuffer, (unsigned long) i*2048, (unsigned long) i*2048+2047) != 2048) {
+                                   getzeros(check->bigbuffer, (unsigned long) i*2048, (unsigned long) i*2048+2047), newline);
+                if (!zeroscan_allzeros(check->bigbuffer + i*2048, 2048)) {
                     sectoroffset = (unsigned long) i*2048;
                   break;
                 }
             }
             printf("Showing first sector of padding data (at 0x%"LL"X) in hex and ascii:%s",
-                    dataloop == -1 ? (video - (number_of_stealth_sectors+(xgd3 ? 16 : 0))*2048 - bufferremainder + sectoroffset) :
-                                     ((unsigned long long) dataloop*BIGBUF_SIZE + pfi_sectorsL0*2048 + sectoroffset), newline);
-            hexdump(bigbuffer+sectoroffset, 0, 2048);
+                    dataloop == -1 ? (check->video - (number_of_stealth_sectors+(check->xgd3 ? 16 : 0))*2048 - check->bufferremainder + sectoroffset) :
+                                     ((unsigned long long) dataloop*BIGBUF_SIZE + check->pfi_sectorsL0*2048 + sectoroffset), newline);
+            hexdump(check->bigbuffer+sectoroffset, 0, 2048);
             printf("%s", newline);
         }
         if (!openforwriting) {
@@ -20642,41 +22887,45 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
             openforwriting = true;
         }
         if (dataloop == -1) {
-            if (fseeko(stream, video - (number_of_stealth_sectors+(xgd3 ? 16 : 0))*2048 - bufferremainder, SEEK_SET) != 0) {
+            if (fseeko(stream, check->video - (number_of_stealth_sectors+(check->xgd3 ? 16 : 0))*2048 - check->bufferremainder, SEEK_SET) != 0) {
                 printseekerror(isofilename, "Zero padding");
               goto skipL0videopadding;
             }
         }
-        else if (fseeko(stream, (unsigned long long) dataloop*BIGBUF_SIZE + pfi_sectorsL0*2048, SEEK_SET) != 0 ) {
+        else if (fseeko(stream, (unsigned long long) dataloop*BIGBUF_SIZE + check->pfi_sectorsL0*2048, SEEK_SET) != 0 ) {
             printseekerror(isofilename, "Zero padding");
           goto skipL0videopadding;
         }
         if (debug) printf("Current offset: 0x%"LL"X%s", (unsigned long long) ftello(stream), newline);
         initcheckwrite();
-        memset(bigbuffer, 0, BIGBUF_SIZE);
+        // deallocating the padding is much quicker than writing zeroes over it (and keeps sparse images sparse)
+        if (punchzeros(stream, (unsigned long long) ftello(stream), check->video - (number_of_stealth_sectors+(check->xgd3 ? 16 : 0))*2048) == 0)
+            goto zeroedL0videopadding;
+        memset(check->bigbuffer, 0, BIGBUF_SIZE);
         if (dataloop == -1) {
-            if (checkwriteandprinterrors(bigbuffer, 1, bufferremainder, stream, 0,
-                                         video - (number_of_stealth_sectors+(xgd3 ? 16 : 0))*2048 - bufferremainder,
+            if (checkwriteandprinterrors(check->bigbuffer, 1, check->bufferremainder, stream, 0,
+                                         check->video - (number_of_stealth_sectors+(check->xgd3 ? 16 : 0))*2048 - check->bufferremainder,
                                          "L0 Video padding", "Zero padding") != 0) {
                 goto skipL0videopadding;
             }
         }
         else {
-            for (m=0;m<sizeoverbuffer - dataloop;m++) {
-                if (checkwriteandprinterrors(bigbuffer, 1, BIGBUF_SIZE, stream, m,
-                                             (unsigned long long) dataloop*BIGBUF_SIZE + pfi_sectorsL0*2048,
+            for (m=0;m<check->sizeoverbuffer - dataloop;m++) {
+                if (checkwriteandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, stream, m,
+                                             (unsigned long long) dataloop*BIGBUF_SIZE + check->pfi_sectorsL0*2048,
                                              "L0 Video padding", "Zero padding") != 0) {
                     goto skipL0videopadding;
                 }
             }
-            if (bufferremainder) {
-                if (checkwriteandprinterrors(bigbuffer, 1, bufferremainder, stream, 0,
-                                             video - (number_of_stealth_sectors+(xgd3 ? 16 : 0))*2048 - bufferremainder,
+            if (check->bufferremainder) {
+                if (checkwriteandprinterrors(check->bigbuffer, 1, check->bufferremainder, stream, 0,
+                                             check->video - (number_of_stealth_sectors+(check->xgd3 ? 16 : 0))*2048 - check->bufferremainder,
                                              "L0 Video padding", "Zero padding") != 0) {
                     goto skipL0videopadding;
                 }
             }
         }
+        zeroedL0videopadding:
         donecheckwrite("L0 Video Padding");
         color(green);
         if (verbose) printf("%s", sp5);
@@ -20692,19 +22941,19 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
             color(normal);
             goto skipvideopadding;
         }
-        if (pfi_offsetL1 == padding_offsetL1start) {
+        if (check->pfi_offsetL1 == padding_offsetL1start) {
             // there is no L1 video padding
             if (verbose) printf("%s", sp5);
             printf("Skipped checking L1 Video padding because there is none%s", newline);
             goto skipvideopadding;
         }
-        if (pfi_offsetL1 < padding_offsetL1start) {
+        if (check->pfi_offsetL1 < padding_offsetL1start) {
             // L1 video overlaps game data
             if (verbose) printf("%s", sp5);
             printf("Skipped checking L1 Video padding because there is none (PFI L1 Data Area overlaps the game partition)%s", newline);
             goto skipvideopadding;
         }
-        if (pfi_offsetL1 % 2048 || padding_offsetL1start % 2048) {
+        if (check->pfi_offsetL1 % 2048 || padding_offsetL1start % 2048) {
             // this shouldn't happen
             color(yellow);
             printf("Cannot check L1 Video padding because there is something wrong with the offsets for L1 padding and/or video data%s", newline);
@@ -20712,7 +22961,7 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
             goto skipvideopadding;
         }
         // filesize should be at least pfi_offsetL1
-        if ((unsigned long long) fpfilesize < pfi_offsetL1) {
+        if ((unsigned long long) check->fpfilesize < check->pfi_offsetL1) {
             color(yellow);
             printf("Cannot check L1 Video padding because the ISO size is too small to contain it%s", newline);
             color(normal);
@@ -20723,26 +22972,45 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
             printseekerror(isofilename, "Checking L1 Video padding");
             goto skipvideopadding;
         }
-        memset(bigbuffer, 0, BIGBUF_SIZE);
-        sizeoverbuffer =  (unsigned long) ( (pfi_offsetL1 - padding_offsetL1start) / BIGBUF_SIZE );
-        bufferremainder = (unsigned long) ( (pfi_offsetL1 - padding_offsetL1start) % BIGBUF_SIZE );
+        memset(check->bigbuffer, 0, BIGBUF_SIZE);
+        check->sizeoverbuffer =  (unsigned long) ( (check->pfi_offsetL1 - padding_offsetL1start) / BIGBUF_SIZE );
+        check->bufferremainder = (unsigned long) ( (check->pfi_offsetL1 - padding_offsetL1start) % BIGBUF_SIZE );
         initcheckread();
         bool videoL1zeropadding = true;
         dataloop = 0;
         if (verbose) printf("%s", sp5);
+        #ifndef WIN32
+            if (onepasshasrange(&check->onepassresults.paddingL1, padding_offsetL1start, check->pfi_offsetL1)) {
+                if (check->onepassresults.paddingL1.founddata) {
+                    videoL1zeropadding = false;
+                    if (onepassreadpadding(isofilename, stream, &check->onepassresults.paddingL1, check->sizeoverbuffer, check->bufferremainder, &dataloop, "L1 Video padding") != 0)
+                        goto skipvideopadding;
+                }
+                goto skipL1remainder;
+            }
+        #endif
         fprintf(stderr, "Checking L1 Video padding... ");
         charsprinted = 0;
-        for (m=0;m<sizeoverbuffer;m++) {
-            if (m && sizeoverbuffer >= 100 && m % (sizeoverbuffer / 100) == 0 && roundf(((float) m / ((float) sizeoverbuffer / 100))) <= 100.0) {
+        for (m=0;m<check->sizeoverbuffer;m++) {
+            if (m && check->sizeoverbuffer >= 100 && m % (check->sizeoverbuffer / 100) == 0 && roundf(((float) m / ((float) check->sizeoverbuffer / 100))) <= 100.0) {
                 resetstderr();
-                charsprinted = fprintf(stderr, "%2lu%% ", (unsigned long) roundf(((float) m / ((float) sizeoverbuffer / 100))));
+                charsprinted = fprintf(stderr, "%2lu%% ", (unsigned long) roundf(((float) m / ((float) check->sizeoverbuffer / 100))));
             }
-            if (checkreadandprinterrors(bigbuffer, 1, BIGBUF_SIZE, stream, m,
+            #ifndef WIN32
+                if (sparse_iszero(&sparse, (unsigned long long) m*BIGBUF_SIZE + padding_offsetL1start, BIGBUF_SIZE)) {
+                    if (fseeko(stream, (unsigned long long) (m+1)*BIGBUF_SIZE + padding_offsetL1start, SEEK_SET) != 0) {
+                        printseekerror(isofilename, "Checking L1 Video padding");
+                        goto skipvideopadding;
+                    }
+                  continue;
+                }
+            #endif
+            if (checkreadandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, stream, m,
                                         padding_offsetL1start,
                                         "L1 Video padding", "Checking zero padding") != 0) {
                 goto skipvideopadding;
             }
-            if (getzeros(bigbuffer, 0, BIGBUF_SIZE - 1) != BIGBUF_SIZE) {
+            if (!zeroscan_allzeros(check->bigbuffer, BIGBUF_SIZE)) {
                 videoL1zeropadding = false;
                 dataloop = m;
                 if (debug) {
@@ -20753,18 +23021,18 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
                 goto skipL1remainder;
             }
         }
-        if (bufferremainder) {
-            if (checkreadandprinterrors(bigbuffer, 1, bufferremainder, stream, 0,
-                                        pfi_offsetL1 - bufferremainder,
+        if (check->bufferremainder) {
+            if (checkreadandprinterrors(check->bigbuffer, 1, check->bufferremainder, stream, 0,
+                                        check->pfi_offsetL1 - check->bufferremainder,
                                         "L1 Video padding", "Checking zero padding") != 0) {
                 goto skipvideopadding;
             }
-            if (getzeros(bigbuffer, 0, bufferremainder - 1) != bufferremainder) {
+            if (!zeroscan_allzeros(check->bigbuffer, check->bufferremainder)) {
                 videoL1zeropadding = false;
                 dataloop = -1;  // identify that data was found in the bufferremainder
                 if (debug) {
                     printf("data found at 0x%"LL"X, current offset: 0x%"LL"X, dataloop = %ld%s",
-                            pfi_offsetL1 - bufferremainder,
+                            check->pfi_offsetL1 - check->bufferremainder,
                             (unsigned long long) ftello(stream), dataloop, newline);
                 }
                 goto skipL1remainder;
@@ -20773,13 +23041,19 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
         clearstderr();
         skipL1remainder:
         donecheckread("L1 Video padding");
+        #ifndef WIN32
+            if (stream == check->fp)
+                cacheresult(RESULTCACHE_PADDINGL1, padding_offsetL1start, check->pfi_offsetL1, 0, !videoL1zeropadding,
+                            dataloop == -1 ? check->pfi_offsetL1 - check->bufferremainder :
+                                             (unsigned long long) dataloop*BIGBUF_SIZE + padding_offsetL1start);
+        #endif
         if (videoL1zeropadding) {
             color(green);
             printf("L1 Video is zero padded%s", newline);
             color(normal);
             goto skipvideopadding;
         }
-        if (!writefile) {
+        if (!check->writefile) {
             color(yellow);
             printf("L1 Video padding contains data but it won't be zeroed because writing is disabled%s", newline);
             color(normal);
@@ -20787,20 +23061,20 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
         }
         printf("L1 Video padding contains data, overwriting it with zeroes...%s", newline);
         if (extraverbose) {
-            if (dataloop == -1) memset(bigbuffer+bufferremainder, 0, BIGBUF_SIZE - bufferremainder);
+            if (dataloop == -1) memset(check->bigbuffer+check->bufferremainder, 0, BIGBUF_SIZE - check->bufferremainder);
             sectoroffset = 0;
             for (i=0;i<(BIGBUF_SIZE/2048);i++) {
                 if (debug) printf("%d: %lu zeros%s", i,
-                                   getzeros(bigbuffer, (unsigned long) i*2048, (unsigned long) i*2048+2047), newline);
-                if (getzeros(bigbuffer, (unsigned long) i*2048, (unsigned long) i*2048+2047) != 2048) {
+                                   getzeros(check->bigbuffer, (unsigned long) i*2048, (unsigned long) i*2048+2047), newline);
+                if (!zeroscan_allzeros(check->bigbuffer + i*2048, 2048)) {
                     sectoroffset = (unsigned long) i*2048;
                   break;
                 }
             }
             printf("Showing first sector of padding data (at 0x%"LL"X) in hex and ascii:%s",
-                    dataloop == -1 ? (pfi_offsetL1 - bufferremainder + sectoroffset) :
+                    dataloop == -1 ? (check->pfi_offsetL1 - check->bufferremainder + sectoroffset) :
                                      ((unsigned long long) dataloop*BIGBUF_SIZE + padding_offsetL1start + sectoroffset), newline);
-            hexdump(bigbuffer+sectoroffset, 0, 2048);
+            hexdump(check->bigbuffer+sectoroffset, 0, 2048);
             printf("%s", newline);
         }
         if (!openforwriting) {
@@ -20823,7 +23097,7 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
             openforwriting = true;
         }
         if (dataloop == -1) {
-            if (fseeko(stream, pfi_offsetL1 - bufferremainder, SEEK_SET) != 0) {
+            if (fseeko(stream, check->pfi_offsetL1 - check->bufferremainder, SEEK_SET) != 0) {
                 printseekerror(isofilename, "Zero padding");
               goto skipvideopadding;
             }
@@ -20834,30 +23108,32 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
         }
         if (debug) printf("Current offset: 0x%"LL"X%s", (unsigned long long) ftello(stream), newline);
         initcheckwrite();
-        memset(bigbuffer, 0, BIGBUF_SIZE);
+        if (punchzeros(stream, (unsigned long long) ftello(stream), check->pfi_offsetL1) == 0) goto zeroedL1videopadding;
+        memset(check->bigbuffer, 0, BIGBUF_SIZE);
         if (dataloop == -1) {
-            if (checkwriteandprinterrors(bigbuffer, 1, bufferremainder, stream, 0,
-                                         pfi_offsetL1 - bufferremainder,
+            if (checkwriteandprinterrors(check->bigbuffer, 1, check->bufferremainder, stream, 0,
+                                         check->pfi_offsetL1 - check->bufferremainder,
                                          "L1 Video padding", "Zero padding") != 0) {
                 goto skipvideopadding;
             }
         }
         else {
-            for (m=0;m<sizeoverbuffer - dataloop;m++) {
-                if (checkwriteandprinterrors(bigbuffer, 1, BIGBUF_SIZE, stream, m,
+            for (m=0;m<check->sizeoverbuffer - dataloop;m++) {
+                if (checkwriteandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, stream, m,
                                              (unsigned long long) dataloop*BIGBUF_SIZE + padding_offsetL1start,
                                              "L1 Video padding", "Zero padding") != 0) {
                     goto skipvideopadding;
                 }
             }
-            if (bufferremainder) {
-                if (checkwriteandprinterrors(bigbuffer, 1, bufferremainder, stream, 0,
-                                             pfi_offsetL1 - bufferremainder,
+            if (check->bufferremainder) {
+                if (checkwriteandprinterrors(check->bigbuffer, 1, check->bufferremainder, stream, 0,
+                                             check->pfi_offsetL1 - check->bufferremainder,
                                              "L1 Video padding", "Zero padding") != 0) {
                     goto skipvideopadding;
                 }
             }
         }
+        zeroedL1videopadding:
         donecheckwrite("L1 Video Padding");
         color(green);
         if (verbose) printf("%s", sp5);
@@ -20865,7 +23141,7 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
         color(normal);
         
         skipvideopadding:
-        if (xgd3) {
+        if (check->xgd3) {
             // check xgd3 stealth padding based on xgd3_stealth_padding_bitfield
             if (debug) printf("xgd3_stealth_padding_bitfield = 0x%04X%s", xgd3_stealth_padding_bitfield, newline);
             if (xgd3_stealth_padding_bitfield == 0) {
@@ -20880,11 +23156,11 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
                 color(normal);
                 goto skippadding;
             }
-            if (fseeko(stream, video - 32768, SEEK_SET) != 0) {
+            if (fseeko(stream, check->video - 32768, SEEK_SET) != 0) {
                 printseekerror(isofilename, "Checking XGD3 Stealth padding");
                 goto skippadding;
             }
-            memset(bigbuffer, 0, BIGBUF_SIZE);
+            memset(check->bigbuffer, 0, BIGBUF_SIZE);
             initcheckread();
             bool xgd3stealthzeropadding = true;
             unsigned short bit;
@@ -20893,8 +23169,8 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
             fprintf(stderr, "Checking XGD3 Stealth padding... ");
             if (debug) fprintf(stderr, "\n");
             // make sure bigbuffer isn't written to between now and the time the padding sectors are blanked out if they contain data
-            if (checkreadandprinterrors(bigbuffer, 1, 32768, stream, 0,
-                                        video - 32768,
+            if (checkreadandprinterrors(check->bigbuffer, 1, 32768, stream, 0,
+                                        check->video - 32768,
                                         "XGD3 Stealth padding", "Checking zero padding") != 0) {
                 goto skippadding;
             }
@@ -20904,12 +23180,12 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
                 bit = (unsigned short) pow(2.0, (double) j);
                 if (xgd3_stealth_padding_bitfield & bit) {
                     if (debug) printf("checking for data in XGD3 Stealth padding: i=%2d, j=%2d, bit=0x%04X%s", i, j, bit, newline);
-                    if (getzeros(bigbuffer, (unsigned long) i*2048, (unsigned long) i*2048+2047) != 2048) {
+                    if (!zeroscan_allzeros(check->bigbuffer + i*2048, 2048)) {
                         xgd3stealthzeropadding = false;
                         dataloop = (long) i;
                         if (debug) {
                             printf("data found at 0x%"LL"X, current offset: 0x%"LL"X, dataloop = %ld%s",
-                                    video - 32768 + i*2048,
+                                    check->video - 32768 + i*2048,
                                     (unsigned long long) ftello(stream), dataloop, newline);
                         }
                         break;
@@ -20923,7 +23199,7 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
                 color(normal);
                 goto skippadding;
             }
-            if (!writefile) {
+            if (!check->writefile) {
                 color(yellow);
                 printf("XGD3 Stealth padding contains data but it won't be zeroed because writing is disabled%s", newline);
                 color(normal);
@@ -20932,8 +23208,8 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
             printf("XGD3 Stealth padding contains data, overwriting it with zeroes...%s", newline);
             if (extraverbose) {
                 printf("Showing first sector of padding data (at 0x%"LL"X) in hex and ascii:%s",
-                        video - 32768 + dataloop*2048, newline);
-                hexdump(bigbuffer+(dataloop*2048), 0, 2048);
+                        check->video - 32768 + dataloop*2048, newline);
+                hexdump(check->bigbuffer+(dataloop*2048), 0, 2048);
                 printf("%s", newline);
             }
             if (!openforwriting) {
@@ -20955,7 +23231,7 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
                 }
                 openforwriting = true;
             }
-            if (fseeko(stream, video - 32768, SEEK_SET) != 0 ) {
+            if (fseeko(stream, check->video - 32768, SEEK_SET) != 0 ) {
                 printseekerror(isofilename, "Zero padding");
               goto skippadding;
             }
@@ -20966,13 +23242,13 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
                 j = abs(i - 15); // example i,j -- 0,15 1,14 2,13 ... 13,2 14,1 15,0
                 bit = (unsigned short) pow(2.0, (double) j);
                 if (xgd3_stealth_padding_bitfield & bit) {
-                    memset(bigbuffer+(i*2048), 0, 2048);
+                    memset(check->bigbuffer+(i*2048), 0, 2048);
                 }
             }
             // write the 16 sectors we read earlier (with all padding sectors blanked out) back to the file
             initcheckwrite();
-            if (checkwriteandprinterrors(bigbuffer, 1, 32768, stream, 0,
-                                         video - 32768,
+            if (checkwriteandprinterrors(check->bigbuffer, 1, 32768, stream, 0,
+                                         check->video - 32768,
                                          "XGD3 Stealth padding", "Zero padding") != 0) {
                 goto skippadding;
             }
@@ -20986,131 +23262,184 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
     
     skippadding:
     // check video crc32
-    if (pfi_foundsectorstotal) {
+    if (check->pfi_foundsectorstotal) {
         // check that the L0 data area doesn't overlap stealth files or game data
-        if (pfi_sectorsL0 > (video/2048 - number_of_stealth_sectors - (xgd3 ? 16 : 0))) {
-            stealthuncertain = true;
-            video_stealthuncertain = true;
+        if (check->pfi_sectorsL0 > (check->video/2048 - number_of_stealth_sectors - (check->xgd3 ? 16 : 0))) {
+            check->stealthuncertain = true;
+            check->video_stealthuncertain = true;
             color(yellow);
-            printf("PFI L0 Data Area is too large! (%lu sectors) Video CRC check was aborted%s", pfi_sectorsL0, newline);
+            printf("PFI L0 Data Area is too large! (%lu sectors) Video CRC check was aborted%s", check->pfi_sectorsL0, newline);
             color(normal);
           goto endofvideocrc;
         }
         // iso size should be at least [pfi_offsetL1 + pfi_sectorsL1 * 2048] for a normal iso and [pfi_sectorstotal * 2048] for justavideoiso
-        if ((unsigned long long) fpfilesize < (justavideoiso ? (unsigned long long) pfi_sectorstotal * 2048 : pfi_offsetL1 + pfi_sectorsL1 * 2048)) {
-            video_stealthfailed = true;
+        if ((unsigned long long) check->fpfilesize < (justavideoiso ? (unsigned long long) check->pfi_sectorstotal * 2048 : check->pfi_offsetL1 + check->pfi_sectorsL1 * 2048)) {
+            check->video_stealthfailed = true;
             color(red);
             printf("ISO size is too small to contain the L1 Video! Video CRC check was aborted%s", newline);
             color(normal);
           goto endofvideocrc;
         }
+        #ifndef WIN32
+            if (onepasshasrange(&check->onepassresults.videoL0, 0, (unsigned long long) check->pfi_sectorsL0*2048) &&
+                onepasshasrange(&check->onepassresults.videoL1, check->pfi_offsetL1, check->pfi_offsetL1 + check->pfi_sectorsL1 * 2048)) {
+                // the single pass scan already read both layers
+                check->videoL0_crc32 = check->onepassresults.videoL0.crc;
+                check->videoL1_crc32 = check->onepassresults.videoL1.crc;
+                check->video_crc32 = crc32_combine(check->videoL0_crc32, check->videoL1_crc32, (z_off_t) check->pfi_sectorsL1 * 2048);
+                goto onepassvideocrc;
+            }
+        #endif
         // seek to L0 Video
         if (fseeko(stream, 0, SEEK_SET) != 0) {
             printseekerror(isofilename, "Checking Video CRC");
-            video_stealthuncertain = true;
+            check->video_stealthuncertain = true;
           return;
         }
         initcheckread();
-        unsigned long totalsizeoverbuffer = pfi_sectorstotal * 2048 / BIGBUF_SIZE;
-        sizeoverbuffer = pfi_sectorsL0 * 2048 / BIGBUF_SIZE;
-        unsigned long firstsizeoverbuffer = sizeoverbuffer;
-        bufferremainder = pfi_sectorsL0 * 2048 % BIGBUF_SIZE;
-        for (m=0; m<sizeoverbuffer; m++) {
+        #ifndef WIN32
+            // for --manifest each layer's chunk CRCs are built instead of the layer crc, which is then combined from them
+            struct chunkmanifest_region *L0chunks = NULL, *L1chunks = NULL;
+            if (!justavideoiso) {
+                L0chunks = startmanifestregion("videoL0", stream, 0, (unsigned long long) check->pfi_sectorsL0*2048);
+                L1chunks = startmanifestregion("videoL1", stream, check->pfi_offsetL1, check->pfi_offsetL1 + check->pfi_sectorsL1 * 2048);
+            }
+        #endif
+        unsigned long totalsizeoverbuffer = check->pfi_sectorstotal * 2048 / BIGBUF_SIZE;
+        check->sizeoverbuffer = check->pfi_sectorsL0 * 2048 / BIGBUF_SIZE;
+        unsigned long firstsizeoverbuffer = check->sizeoverbuffer;
+        check->bufferremainder = check->pfi_sectorsL0 * 2048 % BIGBUF_SIZE;
+        for (m=0; m<check->sizeoverbuffer; m++) {
             if (totalsizeoverbuffer >= 100 && m && (m % (totalsizeoverbuffer / 100) == 0) && (m / (totalsizeoverbuffer / 100) <= 100)) {
                 resetstderr();
                 charsprinted = fprintf(stderr, "Checking Video CRC... %2lu%% ", m / (totalsizeoverbuffer / 100));
             }
-            if (checkreadandprinterrors(bigbuffer, 1, BIGBUF_SIZE, stream, m, 0, "Video", "CRC check") != 0) {
-                video_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
+            if (checkreadandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, stream, m, 0, "Video", "CRC check") != 0) {
+                check->video_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
                 goto endofvideocrc;
             }
-            video_crc32 = crc32(video_crc32, bigbuffer, BIGBUF_SIZE);
+            #ifndef WIN32
+                if (L0chunks != NULL) {
+                    chunkmanifest_update(L0chunks, check->bigbuffer, BIGBUF_SIZE);
+                  continue;
+                }
+            #endif
+            check->video_crc32 = crc32_fast(check->video_crc32, check->bigbuffer, BIGBUF_SIZE);
         }
-        if (bufferremainder) {
-            if (checkreadandprinterrors(bigbuffer, 1, bufferremainder, stream, 0, pfi_sectorsL0 * 2048 - bufferremainder,
+        if (check->bufferremainder) {
+            if (checkreadandprinterrors(check->bigbuffer, 1, check->bufferremainder, stream, 0, check->pfi_sectorsL0 * 2048 - check->bufferremainder,
                                         "Video", "CRC check") != 0) {
-                video_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
+                check->video_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
                 goto endofvideocrc;
             }
-            video_crc32 = crc32(video_crc32, bigbuffer, bufferremainder);
+            check->video_crc32 = crc32_fast(check->video_crc32, check->bigbuffer, check->bufferremainder);
+            #ifndef WIN32
+                if (L0chunks != NULL) chunkmanifest_update(L0chunks, check->bigbuffer, check->bufferremainder);
+            #endif
         }
-        videoL0_crc32 = video_crc32;
-        sizeoverbuffer = pfi_sectorsL1 * 2048 / BIGBUF_SIZE;
-        bufferremainder = pfi_sectorsL1 * 2048 % BIGBUF_SIZE;
+        #ifndef WIN32
+            if (L0chunks != NULL) check->video_crc32 = chunkmanifest_crc(L0chunks);
+        #endif
+        check->videoL0_crc32 = check->video_crc32;
+        check->sizeoverbuffer = check->pfi_sectorsL1 * 2048 / BIGBUF_SIZE;
+        check->bufferremainder = check->pfi_sectorsL1 * 2048 % BIGBUF_SIZE;
         if (!justavideoiso) {
             // seek to L1 Video
-            if (fseeko(stream, pfi_offsetL1, SEEK_SET) != 0) {
+            if (fseeko(stream, check->pfi_offsetL1, SEEK_SET) != 0) {
                 printseekerror(isofilename, "Checking Video CRC");
-                video_stealthuncertain = true;
-                video_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
+                check->video_stealthuncertain = true;
+                check->video_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
               return;
             }
         }
-        for (m=0; m<sizeoverbuffer; m++) {
+        for (m=0; m<check->sizeoverbuffer; m++) {
             if (totalsizeoverbuffer >= 100 && m && ((m + firstsizeoverbuffer) % (totalsizeoverbuffer / 100) == 0) &&
                 ((m + firstsizeoverbuffer) / (totalsizeoverbuffer / 100) <= 100)) {
                 resetstderr();
                 charsprinted = fprintf(stderr, "Checking Video CRC... %2lu%% ", (m + firstsizeoverbuffer) / (totalsizeoverbuffer / 100));
             }
-            if (checkreadandprinterrors(bigbuffer, 1, BIGBUF_SIZE, stream, m,
-                                        (justavideoiso ? (unsigned long long) pfi_sectorsL0 * 2048 : pfi_offsetL1),
+            if (checkreadandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, stream, m,
+                                        (justavideoiso ? (unsigned long long) check->pfi_sectorsL0 * 2048 : check->pfi_offsetL1),
                                         "Video", "CRC check") != 0) {
-                video_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
-                videoL1_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
+                check->video_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
+                check->videoL1_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
                 goto endofvideocrc;
             }
-            video_crc32 = crc32(video_crc32, bigbuffer, BIGBUF_SIZE);
-            videoL1_crc32 = crc32(videoL1_crc32, bigbuffer, BIGBUF_SIZE);
+            #ifndef WIN32
+                if (L1chunks != NULL) {
+                    chunkmanifest_update(L1chunks, check->bigbuffer, BIGBUF_SIZE);
+                  continue;
+                }
+            #endif
+            check->video_crc32 = crc32_fast(check->video_crc32, check->bigbuffer, BIGBUF_SIZE);
+            check->videoL1_crc32 = crc32_fast(check->videoL1_crc32, check->bigbuffer, BIGBUF_SIZE);
         }
-        if (bufferremainder) {
-            if (checkreadandprinterrors(bigbuffer, 1, bufferremainder, stream, 0,
-                                        (justavideoiso ? (unsigned long long) pfi_sectorstotal * 2048 - bufferremainder :
-                                         pfi_offsetL1 + pfi_sectorsL1 * 2048 - bufferremainder),
+        if (check->bufferremainder) {
+            if (checkreadandprinterrors(check->bigbuffer, 1, check->bufferremainder, stream, 0,
+                                        (justavideoiso ? (unsigned long long) check->pfi_sectorstotal * 2048 - check->bufferremainder :
+                                         check->pfi_offsetL1 + check->pfi_sectorsL1 * 2048 - check->bufferremainder),
                                         "Video", "CRC check") != 0) {
-                video_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
-                videoL1_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
+                check->video_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
+                check->videoL1_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
                 goto endofvideocrc;
             }
-            video_crc32 = crc32(video_crc32, bigbuffer, bufferremainder);
-            videoL1_crc32 = crc32(videoL1_crc32, bigbuffer, bufferremainder);
+            check->video_crc32 = crc32_fast(check->video_crc32, check->bigbuffer, check->bufferremainder);
+            check->videoL1_crc32 = crc32_fast(check->videoL1_crc32, check->bigbuffer, check->bufferremainder);
+            #ifndef WIN32
+                if (L1chunks != NULL) chunkmanifest_update(L1chunks, check->bigbuffer, check->bufferremainder);
+            #endif
         }
+        #ifndef WIN32
+            if (L1chunks != NULL) {
+                check->videoL1_crc32 = chunkmanifest_crc(L1chunks);
+                check->video_crc32 = crc32_combine(check->videoL0_crc32, check->videoL1_crc32, (z_off_t) check->pfi_sectorsL1 * 2048);
+            }
+        #endif
         clearstderr();
         donecheckread("Video");
+        #ifndef WIN32
+            onepassvideocrc:
+            if (!justavideoiso && stream == check->fp) {
+                cacheresult(RESULTCACHE_VIDEOL0, 0, (unsigned long long) check->pfi_sectorsL0*2048, check->videoL0_crc32, false, 0);
+                cacheresult(RESULTCACHE_VIDEOL1, check->pfi_offsetL1, check->pfi_offsetL1 + check->pfi_sectorsL1 * 2048,
+                            check->videoL1_crc32, false, 0);
+            }
+        #endif
     }
     else if (justavideoiso) {
         // seek to L0 Video
         if (fseeko(stream, 0, SEEK_SET) != 0) {
             printseekerror(isofilename, "Checking Video CRC");
-            video_stealthuncertain = true;
+            check->video_stealthuncertain = true;
           return;
         }
         initcheckread();
-        sizeoverbuffer = videosize * 2048 / BIGBUF_SIZE;
-        bufferremainder = videosize * 2048 % BIGBUF_SIZE;
-        for (m=0; m<sizeoverbuffer; m++) {
-            if (sizeoverbuffer >= 100 && m && (m % (sizeoverbuffer / 100) == 0) && (m / (sizeoverbuffer / 100) <= 100)) {
+        check->sizeoverbuffer = videosize * 2048 / BIGBUF_SIZE;
+        check->bufferremainder = videosize * 2048 % BIGBUF_SIZE;
+        for (m=0; m<check->sizeoverbuffer; m++) {
+            if (check->sizeoverbuffer >= 100 && m && (m % (check->sizeoverbuffer / 100) == 0) && (m / (check->sizeoverbuffer / 100) <= 100)) {
                 resetstderr();
-                charsprinted = fprintf(stderr, "Checking Video CRC... %2lu%% ", m / (sizeoverbuffer / 100));
+                charsprinted = fprintf(stderr, "Checking Video CRC... %2lu%% ", m / (check->sizeoverbuffer / 100));
             }
-            if (checkreadandprinterrors(bigbuffer, 1, BIGBUF_SIZE, stream, m, 0, "Video", "CRC check") != 0) {
-                video_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
+            if (checkreadandprinterrors(check->bigbuffer, 1, BIGBUF_SIZE, stream, m, 0, "Video", "CRC check") != 0) {
+                check->video_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
                 goto endofvideocrc;
             }
-            video_crc32 = crc32(video_crc32, bigbuffer, BIGBUF_SIZE);
+            check->video_crc32 = crc32_fast(check->video_crc32, check->bigbuffer, BIGBUF_SIZE);
         }
-        if (bufferremainder) {
-            if (checkreadandprinterrors(bigbuffer, 1, bufferremainder, stream, 0, videosize * 2048 - bufferremainder, "Video", "CRC check") != 0) {
-                video_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
+        if (check->bufferremainder) {
+            if (checkreadandprinterrors(check->bigbuffer, 1, check->bufferremainder, stream, 0, videosize * 2048 - check->bufferremainder, "Video", "CRC check") != 0) {
+                check->video_crc32 = 0;  // reset to 0 so we don't try to autofix or verify a bad crc
                 goto endofvideocrc;
             }
-            video_crc32 = crc32(video_crc32, bigbuffer, bufferremainder);
+            check->video_crc32 = crc32_fast(check->video_crc32, check->bigbuffer, check->bufferremainder);
         }
         clearstderr();
         donecheckread("Video");
     }
     else {
         // not justavideoiso and no pfi to describe the size of L0 and L1 data areas
-        video_stealthuncertain = true;
+        check->video_stealthuncertain = true;
         color(yellow);
         printf("Unable to check the Video CRC because there is no PFI to describe the L0 and L1\n"
                "Video data areas. CRC check was aborted.%s", newline);
@@ -21119,9 +23448,9 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
     }
     
     if (verbose) {
-        printf("%sVideo CRC = %08lX", sp5, video_crc32);
-        if (pfi_foundsectorstotal) {
-            printf(" (V0 = %08lX, V1 = %08lX)%s", videoL0_crc32, videoL1_crc32, newline);
+        printf("%sVideo CRC = %08lX", sp5, check->video_crc32);
+        if (check->pfi_foundsectorstotal) {
+            printf(" (V0 = %08lX, V1 = %08lX)%s", check->videoL0_crc32, check->videoL1_crc32, newline);
         }
         else if (justavideoiso) {
             printf("%s%sCRC might not be correct - PFI is needed to know the full Data Area size%s", newline, sp5, newline);
@@ -21130,27 +23459,27 @@ void checkvideo(char *isofilename, FILE *stream, bool justavideoiso, bool checkv
     
     endofvideocrc:
     for (m=0;m<num_videoentries;m++) {
-        if (video_crc32 == mostrecentvideoentries[m].crc) {
+        if (check->video_crc32 == mostrecentvideoentries[m].crc) {
             printf("Video partition matches known data (%s)%s", mostrecentvideoentries[m].description, newline);
             videorecognized = true;
             break;
         }
     }
     if (!videorecognized) {
-        if (video_crc32 == 0) {
-            video_stealthuncertain = true;
+        if (check->video_crc32 == 0) {
+            check->video_stealthuncertain = true;
           return;
         }
-        if (xgd3) {
+        if (check->xgd3) {
             // XGD3 games all have unique video data
           return;
         }
         else {
-            video_stealthuncertain = true;
+            check->video_stealthuncertain = true;
             color(yellow);
-            if (video_crc32 == xbox1videocrc) printf("Video partition matches known data (Xbox 1)%s", newline);
-            else if (pfi_foundsectorstotal) {
-                if (ss_foundtimestamp && ss_authored <= lastknownwave)
+            if (check->video_crc32 == xbox1videocrc) printf("Video partition matches known data (Xbox 1)%s", newline);
+            else if (check->pfi_foundsectorstotal) {
+                if (check->ss_foundtimestamp && check->ss_authored <= lastknownwave)
                      printf("Video partition does not match known data (almost certainly corrupt)%s", newline);
                 else printf("Video partition does not match known data (probably corrupt but might be a\n"
                             "brand new wave if this is a new game and abgx360.dat hasn't been updated yet)%s", newline);
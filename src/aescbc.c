@@ -0,0 +1,307 @@
+/*
+ *  aescbc.c - AES-128-CBC decryption with runtime cpu dispatch for abgx360
+ *
+ *  The round keys come from rijndaelKeySetupEnc() serialized back into bytes, the decryption keys are the
+ *  "equivalent inverse cipher" ones (the middle encryption keys run through InvMixColumns in reverse order) that
+ *  AESDEC on x86 and AESD+AESIMC on ARMv8 expect.  Both kernels decrypt eight blocks at once so the AES units stay
+ *  busy, and keep the ciphertext they need for the XOR in registers so the buffer can be decrypted in place.  Split
+ *  across threads, every segment starts with the last ciphertext block of the one before it as its iv, which is
+ *  saved before any of them start overwriting the buffer.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#ifndef _WIN32
+    #include <pthread.h>
+    #include <unistd.h>
+#endif
+
+#include "rijndael-alg-fst.h"
+#include "aescbc.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define AESCBC_X86
+    #include <cpuid.h>
+    #include <immintrin.h>
+#endif
+#if defined(__GNUC__) && defined(__aarch64__) && defined(__linux__)
+    #define AESCBC_ARMV8
+    #include <sys/auxv.h>
+    #include <asm/hwcap.h>
+    #include <arm_neon.h>
+    #ifdef __clang__
+        #define AESCBC_ARMV8_TARGET __attribute__((target("aes")))
+    #else
+        #define AESCBC_ARMV8_TARGET __attribute__((target("+crypto")))
+    #endif
+#endif
+
+#define AESCBC_TTABLES 0
+#define AESCBC_AESNI   1
+#define AESCBC_ARMV8_AES 2
+
+static int aescbc_impl = -1;
+
+struct aescbc_key {
+    u32 rk[4*(MAXNR + 1)];                           // T-table decryption schedule
+    int Nr;
+    unsigned char __attribute__((aligned(16))) dk[11][16];  // equivalent inverse cipher round keys
+};
+
+struct aescbc_segment {
+    const struct aescbc_key *key;
+    unsigned char iv[16];
+    unsigned char *buf;
+    size_t numblocks;
+};
+
+static void aescbc_ttables(const struct aescbc_key *key, const unsigned char *iv, unsigned char *buf, size_t numblocks) {
+    unsigned char prev[16], ct[16], pt[16];
+    size_t m;
+    int i;
+    memcpy(prev, iv, 16);
+    for (m=0;m<numblocks;m++) {
+        memcpy(ct, buf+m*16, 16);
+        rijndaelDecrypt(key->rk, key->Nr, ct, pt);
+        for (i=0;i<16;i++) buf[m*16+i] = pt[i] ^ prev[i];
+        memcpy(prev, ct, 16);
+    }
+  return;
+}
+
+#ifdef AESCBC_X86
+__attribute__((target("aes,sse2")))
+static void aescbc_aesnikeys(struct aescbc_key *key, unsigned char ek[11][16]) {
+    int r;
+    _mm_store_si128((__m128i *) key->dk[0], _mm_loadu_si128((const __m128i *) ek[10]));
+    for (r=1;r<10;r++) _mm_store_si128((__m128i *) key->dk[r], _mm_aesimc_si128(_mm_loadu_si128((const __m128i *) ek[10-r])));
+    _mm_store_si128((__m128i *) key->dk[10], _mm_loadu_si128((const __m128i *) ek[0]));
+  return;
+}
+
+__attribute__((target("aes,sse2")))
+static void aescbc_aesni(const struct aescbc_key *key, const unsigned char *iv, unsigned char *buf, size_t numblocks) {
+    __m128i rk[11], prev, c0, c1, c2, c3, c4, c5, c6, c7, b0, b1, b2, b3, b4, b5, b6, b7;
+    int r;
+    for (r=0;r<11;r++) rk[r] = _mm_load_si128((const __m128i *) key->dk[r]);
+    prev = _mm_loadu_si128((const __m128i *) iv);
+    while (numblocks >= 8) {
+        c0 = _mm_loadu_si128((const __m128i *) (buf + 0x00));
+        c1 = _mm_loadu_si128((const __m128i *) (buf + 0x10));
+        c2 = _mm_loadu_si128((const __m128i *) (buf + 0x20));
+        c3 = _mm_loadu_si128((const __m128i *) (buf + 0x30));
+        c4 = _mm_loadu_si128((const __m128i *) (buf + 0x40));
+        c5 = _mm_loadu_si128((const __m128i *) (buf + 0x50));
+        c6 = _mm_loadu_si128((const __m128i *) (buf + 0x60));
+        c7 = _mm_loadu_si128((const __m128i *) (buf + 0x70));
+        b0 = _mm_xor_si128(c0, rk[0]); b1 = _mm_xor_si128(c1, rk[0]);
+        b2 = _mm_xor_si128(c2, rk[0]); b3 = _mm_xor_si128(c3, rk[0]);
+        b4 = _mm_xor_si128(c4, rk[0]); b5 = _mm_xor_si128(c5, rk[0]);
+        b6 = _mm_xor_si128(c6, rk[0]); b7 = _mm_xor_si128(c7, rk[0]);
+        for (r=1;r<10;r++) {
+            b0 = _mm_aesdec_si128(b0, rk[r]); b1 = _mm_aesdec_si128(b1, rk[r]);
+            b2 = _mm_aesdec_si128(b2, rk[r]); b3 = _mm_aesdec_si128(b3, rk[r]);
+            b4 = _mm_aesdec_si128(b4, rk[r]); b5 = _mm_aesdec_si128(b5, rk[r]);
+            b6 = _mm_aesdec_si128(b6, rk[r]); b7 = _mm_aesdec_si128(b7, rk[r]);
+        }
+        b0 = _mm_aesdeclast_si128(b0, rk[10]); b1 = _mm_aesdeclast_si128(b1, rk[10]);
+        b2 = _mm_aesdeclast_si128(b2, rk[10]); b3 = _mm_aesdeclast_si128(b3, rk[10]);
+        b4 = _mm_aesdeclast_si128(b4, rk[10]); b5 = _mm_aesdeclast_si128(b5, rk[10]);
+        b6 = _mm_aesdeclast_si128(b6, rk[10]); b7 = _mm_aesdeclast_si128(b7, rk[10]);
+        _mm_storeu_si128((__m128i *) (buf + 0x00), _mm_xor_si128(b0, prev));
+        _mm_storeu_si128((__m128i *) (buf + 0x10), _mm_xor_si128(b1, c0));
+        _mm_storeu_si128((__m128i *) (buf + 0x20), _mm_xor_si128(b2, c1));
+        _mm_storeu_si128((__m128i *) (buf + 0x30), _mm_xor_si128(b3, c2));
+        _mm_storeu_si128((__m128i *) (buf + 0x40), _mm_xor_si128(b4, c3));
+        _mm_storeu_si128((__m128i *) (buf + 0x50), _mm_xor_si128(b5, c4));
+        _mm_storeu_si128((__m128i *) (buf + 0x60), _mm_xor_si128(b6, c5));
+        _mm_storeu_si128((__m128i *) (buf + 0x70), _mm_xor_si128(b7, c6));
+        prev = c7;
+        buf += 128;
+        numblocks -= 8;
+    }
+    while (numblocks) {
+        c0 = _mm_loadu_si128((const __m128i *) buf);
+        b0 = _mm_xor_si128(c0, rk[0]);
+        for (r=1;r<10;r++) b0 = _mm_aesdec_si128(b0, rk[r]);
+        b0 = _mm_aesdeclast_si128(b0, rk[10]);
+        _mm_storeu_si128((__m128i *) buf, _mm_xor_si128(b0, prev));
+        prev = c0;
+        buf += 16;
+        numblocks--;
+    }
+  return;
+}
+#endif
+
+#ifdef AESCBC_ARMV8
+AESCBC_ARMV8_TARGET
+static void aescbc_armv8keys(struct aescbc_key *key, unsigned char ek[11][16]) {
+    int r;
+    vst1q_u8(key->dk[0], vld1q_u8(ek[10]));
+    for (r=1;r<10;r++) vst1q_u8(key->dk[r], vaesimcq_u8(vld1q_u8(ek[10-r])));
+    vst1q_u8(key->dk[10], vld1q_u8(ek[0]));
+  return;
+}
+
+// AESD is AddRoundKey+InvShiftRows+InvSubBytes, so the first nine keys go in with AESD and the last is a plain XOR
+#define AESCBC_ARMV8_ROUND(b, k) b = vaesimcq_u8(vaesdq_u8(b, k))
+
+AESCBC_ARMV8_TARGET
+static void aescbc_armv8(const struct aescbc_key *key, const unsigned char *iv, unsigned char *buf, size_t numblocks) {
+    uint8x16_t rk[11], prev, c0, c1, c2, c3, c4, c5, c6, c7, b0, b1, b2, b3, b4, b5, b6, b7;
+    int r;
+    for (r=0;r<11;r++) rk[r] = vld1q_u8(key->dk[r]);
+    prev = vld1q_u8(iv);
+    while (numblocks >= 8) {
+        c0 = vld1q_u8(buf + 0x00); c1 = vld1q_u8(buf + 0x10);
+        c2 = vld1q_u8(buf + 0x20); c3 = vld1q_u8(buf + 0x30);
+        c4 = vld1q_u8(buf + 0x40); c5 = vld1q_u8(buf + 0x50);
+        c6 = vld1q_u8(buf + 0x60); c7 = vld1q_u8(buf + 0x70);
+        b0 = c0; b1 = c1; b2 = c2; b3 = c3; b4 = c4; b5 = c5; b6 = c6; b7 = c7;
+        for (r=0;r<9;r++) {
+            AESCBC_ARMV8_ROUND(b0, rk[r]); AESCBC_ARMV8_ROUND(b1, rk[r]);
+            AESCBC_ARMV8_ROUND(b2, rk[r]); AESCBC_ARMV8_ROUND(b3, rk[r]);
+            AESCBC_ARMV8_ROUND(b4, rk[r]); AESCBC_ARMV8_ROUND(b5, rk[r]);
+            AESCBC_ARMV8_ROUND(b6, rk[r]); AESCBC_ARMV8_ROUND(b7, rk[r]);
+        }
+        b0 = veorq_u8(vaesdq_u8(b0, rk[9]), rk[10]); b1 = veorq_u8(vaesdq_u8(b1, rk[9]), rk[10]);
+        b2 = veorq_u8(vaesdq_u8(b2, rk[9]), rk[10]); b3 = veorq_u8(vaesdq_u8(b3, rk[9]), rk[10]);
+        b4 = veorq_u8(vaesdq_u8(b4, rk[9]), rk[10]); b5 = veorq_u8(vaesdq_u8(b5, rk[9]), rk[10]);
+        b6 = veorq_u8(vaesdq_u8(b6, rk[9]), rk[10]); b7 = veorq_u8(vaesdq_u8(b7, rk[9]), rk[10]);
+        vst1q_u8(buf + 0x00, veorq_u8(b0, prev)); vst1q_u8(buf + 0x10, veorq_u8(b1, c0));
+        vst1q_u8(buf + 0x20, veorq_u8(b2, c1)); vst1q_u8(buf + 0x30, veorq_u8(b3, c2));
+        vst1q_u8(buf + 0x40, veorq_u8(b4, c3)); vst1q_u8(buf + 0x50, veorq_u8(b5, c4));
+        vst1q_u8(buf + 0x60, veorq_u8(b6, c5)); vst1q_u8(buf + 0x70, veorq_u8(b7, c6));
+        prev = c7;
+        buf += 128;
+        numblocks -= 8;
+    }
+    while (numblocks) {
+        c0 = vld1q_u8(buf);
+        b0 = c0;
+        for (r=0;r<9;r++) AESCBC_ARMV8_ROUND(b0, rk[r]);
+        b0 = veorq_u8(vaesdq_u8(b0, rk[9]), rk[10]);
+        vst1q_u8(buf, veorq_u8(b0, prev));
+        prev = c0;
+        buf += 16;
+        numblocks--;
+    }
+  return;
+}
+#endif
+
+void aescbc_init(void) {
+    aescbc_impl = AESCBC_TTABLES;
+    #ifdef AESCBC_X86
+    {
+        unsigned int eax, ebx, ecx, edx;
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_AES) && (edx & bit_SSE2))
+            aescbc_impl = AESCBC_AESNI;
+    }
+    #endif
+    #ifdef AESCBC_ARMV8
+        if (getauxval(AT_HWCAP) & HWCAP_AES) aescbc_impl = AESCBC_ARMV8_AES;
+    #endif
+  return;
+}
+
+static void aescbc_setup(struct aescbc_key *key, const unsigned char cipherkey[16]) {
+    #if defined(AESCBC_X86) || defined(AESCBC_ARMV8)
+        u32 erk[4*(MAXNR + 1)];
+        unsigned char ek[11][16];
+        int i;
+    #endif
+    memset(key, 0, sizeof(struct aescbc_key));
+    key->Nr = rijndaelKeySetupDec(key->rk, cipherkey, 128);
+    if (aescbc_impl == AESCBC_TTABLES) return;
+    #if defined(AESCBC_X86) || defined(AESCBC_ARMV8)
+        // rijndaelKeySetupEnc() keeps the round keys as big endian words
+        rijndaelKeySetupEnc(erk, cipherkey, 128);
+        for (i=0;i<44;i++) {
+            ek[i/4][(i%4)*4+0] = (unsigned char) (erk[i] >> 24);
+            ek[i/4][(i%4)*4+1] = (unsigned char) (erk[i] >> 16);
+            ek[i/4][(i%4)*4+2] = (unsigned char) (erk[i] >> 8);
+            ek[i/4][(i%4)*4+3] = (unsigned char) erk[i];
+        }
+    #endif
+    #ifdef AESCBC_X86
+        if (aescbc_impl == AESCBC_AESNI) aescbc_aesnikeys(key, ek);
+    #endif
+    #ifdef AESCBC_ARMV8
+        if (aescbc_impl == AESCBC_ARMV8_AES) aescbc_armv8keys(key, ek);
+    #endif
+  return;
+}
+
+static void *aescbc_segmentthread(void *arg) {
+    struct aescbc_segment *segment = (struct aescbc_segment *) arg;
+    #ifdef AESCBC_X86
+        if (aescbc_impl == AESCBC_AESNI) {
+            aescbc_aesni(segment->key, segment->iv, segment->buf, segment->numblocks);
+          return NULL;
+        }
+    #endif
+    #ifdef AESCBC_ARMV8
+        if (aescbc_impl == AESCBC_ARMV8_AES) {
+            aescbc_armv8(segment->key, segment->iv, segment->buf, segment->numblocks);
+          return NULL;
+        }
+    #endif
+    aescbc_ttables(segment->key, segment->iv, segment->buf, segment->numblocks);
+  return NULL;
+}
+
+void aescbc_decrypt128(const unsigned char key[16], const unsigned char iv[16], unsigned char *buf, size_t len, int threads) {
+    struct aescbc_key k;
+    struct aescbc_segment segments[AESCBC_MAXTHREADS];
+    size_t numblocks = len / 16, perthread, done = 0;
+    int numthreads, t;
+    #ifndef _WIN32
+        pthread_t threadids[AESCBC_MAXTHREADS];
+        int started;
+    #endif
+    if (numblocks == 0) return;
+    if (aescbc_impl < 0) aescbc_init();
+    aescbc_setup(&k, key);
+    #ifdef _WIN32
+        (void) threads;
+        numthreads = 1;
+    #else
+        if (threads <= 0) threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+        if (threads < 1) threads = 1;
+        if (threads > AESCBC_MAXTHREADS) threads = AESCBC_MAXTHREADS;
+        numthreads = (int) (len / AESCBC_MINTHREADBYTES);
+        if (numthreads > threads) numthreads = threads;
+        if (numthreads < 1) numthreads = 1;
+    #endif
+    perthread = numblocks / numthreads;
+    for (t=0;t<numthreads;t++) {
+        segments[t].key = &k;
+        segments[t].buf = buf + done * 16;
+        segments[t].numblocks = t == numthreads - 1 ? numblocks - done : perthread;
+        // the iv of every segment but the first is ciphertext that the segment before it is about to overwrite
+        if (t == 0) memcpy(segments[t].iv, iv, 16);
+        else memcpy(segments[t].iv, buf + (done - 1) * 16, 16);
+        done += segments[t].numblocks;
+    }
+    #ifdef _WIN32
+        aescbc_segmentthread(&segments[0]);
+    #else
+        // the calling thread does the first segment itself, and any segment a thread couldn't be started for
+        for (started=1;started<numthreads;started++) {
+            if (pthread_create(&threadids[started], NULL, aescbc_segmentthread, &segments[started]) != 0) break;
+        }
+        for (t=started;t<numthreads;t++) aescbc_segmentthread(&segments[t]);
+        aescbc_segmentthread(&segments[0]);
+        for (t=1;t<started;t++) pthread_join(threadids[t], NULL);
+    #endif
+  return;
+}
+
+const char *aescbc_implementation(void) {
+    if (aescbc_impl < 0) aescbc_init();
+    if (aescbc_impl == AESCBC_AESNI) return "aes-ni";
+    if (aescbc_impl == AESCBC_ARMV8_AES) return "armv8-aes";
+  return "t-tables";
+}
@@ -0,0 +1,24 @@
+#ifndef _AESCBC_H
+#define _AESCBC_H
+
+// bulk AES-128-CBC decryption with the fastest implementation this cpu supports picked at runtime: AES-NI on x86 or
+// the ARMv8 AES instructions, eight blocks at a time, or the T-tables in rijndael-alg-fst.c everywhere else.  Every
+// block only needs its own ciphertext and the one before it, so a big buffer can also be split across threads
+
+#include <stddef.h>
+
+#define AESCBC_MINTHREADBYTES 4194304  // don't give a thread less than 4 MB
+#define AESCBC_MAXTHREADS 64
+
+// pick an implementation, call this once before any threads are started
+// (aescbc_decrypt128() will call it if you forget, but that isn't thread safe)
+void aescbc_init(void);
+
+// decrypt the whole 16 byte blocks of buf in place (a remainder is left as it is) with key and iv, on up to threads
+// threads (0 = one per cpu) when there's enough to go around
+void aescbc_decrypt128(const unsigned char key[16], const unsigned char iv[16], unsigned char *buf, size_t len, int threads);
+
+// name of the implementation aescbc_init() picked ("aes-ni", "armv8-aes" or "t-tables")
+const char *aescbc_implementation(void);
+
+#endif /* aescbc.h */
@@ -0,0 +1,338 @@
+/*
+ *  chunkmanifest.c - per-chunk CRC manifests and chunked reverification for abgx360
+ *
+ *  Chunk CRCs are built from the same bytes the region CRCs are computed from, and the region CRC is
+ *  merged from them with crc32_combine() so nothing is hashed twice.  The manifest is a few lines of text
+ *  per region: a header line with its name, offsets and CRC followed by one CRC per chunk.  Reverifying
+ *  hands the chunks to worker threads lowest offset first so the first damaged chunk is found early.
+ */
+
+#define _LARGEFILE_SOURCE
+#define _LARGEFILE64_SOURCE
+#define _FILE_OFFSET_BITS 64
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include <zlib.h>
+
+#include "crc32.h"
+#include "readahead.h"
+#include "chunkmanifest.h"
+
+#define CHUNKMANIFEST_HEADER "abgx360 chunk manifest 1"
+
+void chunkmanifest_init(struct chunkmanifest *cm, unsigned long long filesize, unsigned long long chunksize) {
+    memset(cm, 0, sizeof(struct chunkmanifest));
+    cm->filesize = filesize;
+    cm->chunksize = chunksize;
+  return;
+}
+
+void chunkmanifest_free(struct chunkmanifest *cm) {
+    int i;
+    for (i=0;i<cm->numregions;i++) free(cm->regions[i].crcs);
+    memset(cm->regions, 0, sizeof(cm->regions));
+    cm->numregions = 0;
+  return;
+}
+
+struct chunkmanifest_region *chunkmanifest_addregion(struct chunkmanifest *cm, const char *name,
+                                                     unsigned long long start, unsigned long long end) {
+    int i;
+    struct chunkmanifest_region *region = NULL;
+    if (cm->chunksize == 0 || end < start) return NULL;
+    for (i=0;i<cm->numregions;i++) {
+        if (strcmp(cm->regions[i].name, name) == 0) {
+            region = &cm->regions[i];
+            free(region->crcs);
+            break;
+        }
+    }
+    if (region == NULL) {
+        if (cm->numregions == CHUNKMANIFEST_MAXREGIONS) return NULL;
+        region = &cm->regions[cm->numregions++];
+    }
+    memset(region, 0, sizeof(struct chunkmanifest_region));
+    snprintf(region->name, sizeof(region->name), "%s", name);
+    region->start = start;
+    region->end = end;
+    region->chunksize = cm->chunksize;
+    region->numchunks = (unsigned long) ((end - start + cm->chunksize - 1) / cm->chunksize);
+    region->crcs = (unsigned long *) calloc(region->numchunks ? region->numchunks : 1, sizeof(unsigned long));
+    if (region->crcs == NULL) {
+        // take it back out so the manifest never has a region without chunks
+        *region = cm->regions[--cm->numregions];
+        memset(&cm->regions[cm->numregions], 0, sizeof(struct chunkmanifest_region));
+      return NULL;
+    }
+  return region;
+}
+
+void chunkmanifest_update(struct chunkmanifest_region *region, const unsigned char *data, size_t length) {
+    unsigned long chunk;
+    unsigned long long pos, n;
+    while (length && region->fed < region->end - region->start) {
+        chunk = (unsigned long) (region->fed / region->chunksize);
+        pos = region->fed % region->chunksize;
+        n = region->chunksize - pos;
+        if (n > region->end - region->start - region->fed) n = region->end - region->start - region->fed;
+        if (n > length) n = length;
+        if (data == NULL) region->crcs[chunk] = crc32_zeros(region->crcs[chunk], n);
+        else {
+            region->crcs[chunk] = crc32_fast(region->crcs[chunk], data, (size_t) n);
+            data += n;
+        }
+        region->fed += n;
+        length -= (size_t) n;
+    }
+  return;
+}
+
+bool chunkmanifest_complete(const struct chunkmanifest_region *region) {
+  return region->crcs != NULL && region->fed == region->end - region->start;
+}
+
+static unsigned long long chunkmanifest_chunklength(const struct chunkmanifest_region *region, unsigned long chunk) {
+    unsigned long long offset = (unsigned long long) chunk * region->chunksize;
+    if (region->end - region->start - offset < region->chunksize) return region->end - region->start - offset;
+  return region->chunksize;
+}
+
+unsigned long chunkmanifest_crc(const struct chunkmanifest_region *region) {
+    unsigned long i, crc = 0;
+    unsigned long long length, fed = region->fed;
+    for (i=0;i<region->numchunks && fed;i++) {
+        length = chunkmanifest_chunklength(region, i);
+        if (length > fed) length = fed;
+        crc = crc32_combine(crc, region->crcs[i], (z_off_t) length);
+        fed -= length;
+    }
+  return crc;
+}
+
+int chunkmanifest_save(const struct chunkmanifest *cm, const char *filename) {
+    FILE *stream;
+    char tmpfilename[2048];
+    int i, complete = 0, error = 0;
+    unsigned long c;
+    for (i=0;i<cm->numregions;i++) if (chunkmanifest_complete(&cm->regions[i])) complete++;
+    if (!complete) return 1;
+    snprintf(tmpfilename, sizeof(tmpfilename), "%s.%ld", filename, (long) getpid());
+    stream = fopen(tmpfilename, "w");
+    if (stream == NULL) return -1;
+    fprintf(stream, "%s\n", CHUNKMANIFEST_HEADER);
+    fprintf(stream, "size %llu chunksize %llu\n", cm->filesize, cm->chunksize);
+    for (i=0;i<cm->numregions;i++) {
+        if (!chunkmanifest_complete(&cm->regions[i])) continue;
+        fprintf(stream, "region %s %llu %llu %lu %08lX\n", cm->regions[i].name, cm->regions[i].start, cm->regions[i].end,
+                cm->regions[i].numchunks, chunkmanifest_crc(&cm->regions[i]));
+        for (c=0;c<cm->regions[i].numchunks;c++) fprintf(stream, "%08lX\n", cm->regions[i].crcs[c]);
+    }
+    if (ferror(stream)) error = errno ? errno : EIO;
+    if (fclose(stream) != 0 && !error) error = errno;
+    if (!error && rename(tmpfilename, filename) != 0) error = errno;
+    if (error) {
+        remove(tmpfilename);
+        errno = error;
+      return -1;
+    }
+  return 0;
+}
+
+int chunkmanifest_load(struct chunkmanifest *cm, const char *filename) {
+    FILE *stream;
+    char line[256], name[16];
+    unsigned long long filesize, chunksize, start, end;
+    unsigned long numchunks, crc, c;
+    struct chunkmanifest_region *region;
+    chunkmanifest_init(cm, 0, 0);
+    stream = fopen(filename, "r");
+    if (stream == NULL) return -1;
+    if (fgets(line, sizeof(line), stream) == NULL || strncmp(line, CHUNKMANIFEST_HEADER, strlen(CHUNKMANIFEST_HEADER)) != 0) goto invalid;
+    if (fgets(line, sizeof(line), stream) == NULL || sscanf(line, "size %llu chunksize %llu", &filesize, &chunksize) != 2 ||
+        chunksize == 0 || chunksize % 2048) goto invalid;
+    chunkmanifest_init(cm, filesize, chunksize);
+    while (fgets(line, sizeof(line), stream) != NULL) {
+        if (sscanf(line, "region %15s %llu %llu %lu %lX", name, &start, &end, &numchunks, &crc) != 5) goto invalid;
+        region = chunkmanifest_addregion(cm, name, start, end);
+        if (region == NULL || region->numchunks != numchunks) goto invalid;
+        for (c=0;c<numchunks;c++) {
+            if (fgets(line, sizeof(line), stream) == NULL || sscanf(line, "%lX", &region->crcs[c]) != 1) goto invalid;
+        }
+        region->fed = end - start;
+        if (chunkmanifest_crc(region) != crc) goto invalid;
+    }
+    fclose(stream);
+    if (cm->numregions == 0) {
+        errno = EINVAL;
+      return -1;
+    }
+  return 0;
+
+    invalid:
+    fclose(stream);
+    chunkmanifest_free(cm);
+    errno = EINVAL;
+  return -1;
+}
+
+struct chunkmanifest_job {
+    int region;
+    unsigned long chunk;
+    unsigned long long start, end;
+};
+
+struct chunkmanifest_verifier {
+    const struct chunkmanifest *cm;
+    int fd;
+    size_t unitsize;
+    int retries;
+    bool stopatfirst;
+    struct chunkmanifest_job *jobs;
+    unsigned long numjobs, nextjob;
+    struct chunkmanifest_mismatch *found;
+    long numfound;
+    unsigned long long bytesdone;
+    int running;
+    bool failed;
+    pthread_mutex_t lock;
+    pthread_cond_t finished;
+};
+
+static int chunkmanifest_compare(const void *a, const void *b) {
+    unsigned long long x = ((const struct chunkmanifest_job *) a)->start, y = ((const struct chunkmanifest_job *) b)->start;
+  return x < y ? -1 : x > y ? 1 : 0;
+}
+
+static int chunkmanifest_comparemismatch(const void *a, const void *b) {
+    unsigned long long x = ((const struct chunkmanifest_mismatch *) a)->start, y = ((const struct chunkmanifest_mismatch *) b)->start;
+  return x < y ? -1 : x > y ? 1 : 0;
+}
+
+static void *chunkmanifest_thread(void *arg) {
+    struct chunkmanifest_verifier *v = (struct chunkmanifest_verifier *) arg;
+    struct chunkmanifest_job *job;
+    struct chunkmanifest_mismatch *mismatch;
+    struct readahead_block block;
+    struct sparsemap sparse;
+    unsigned long long pos;
+    unsigned long crc;
+    size_t length;
+    sparse_init(&sparse, v->fd);
+    block.data = (unsigned char *) malloc(CHUNKMANIFEST_BLOCKSIZE);
+    pthread_mutex_lock(&v->lock);
+    if (block.data == NULL) v->failed = true;
+    while (!v->failed && v->nextjob < v->numjobs) {
+        job = &v->jobs[v->nextjob++];
+        pthread_mutex_unlock(&v->lock);
+        crc = 0;
+        block.status = READAHEAD_OK;
+        block.error = 0;
+        for (pos=job->start;pos<job->end;pos+=length) {
+            length = job->end - pos < CHUNKMANIFEST_BLOCKSIZE ? (size_t) (job->end - pos) : CHUNKMANIFEST_BLOCKSIZE;
+            readahead_readblock(v->fd, &block, pos, length, v->unitsize, v->retries, &sparse);
+            if (block.hole) crc = crc32_zeros(crc, block.length);
+            else crc = crc32_fast(crc, block.data, block.length);
+            pthread_mutex_lock(&v->lock);
+            v->bytesdone += block.length;
+            pthread_mutex_unlock(&v->lock);
+            if (block.status != READAHEAD_OK) break;
+        }
+        pthread_mutex_lock(&v->lock);
+        if (block.status != READAHEAD_OK || crc != v->cm->regions[job->region].crcs[job->chunk]) {
+            mismatch = &v->found[v->numfound++];
+            mismatch->region = job->region;
+            mismatch->chunk = job->chunk;
+            mismatch->start = job->start;
+            mismatch->end = job->end;
+            mismatch->crc = crc;
+            mismatch->status = block.status;
+            mismatch->error = block.error;
+            // chunks at lower offsets that are already being read still finish
+            if (v->stopatfirst) v->nextjob = v->numjobs;
+        }
+    }
+    v->running--;
+    pthread_cond_broadcast(&v->finished);
+    pthread_mutex_unlock(&v->lock);
+    free(block.data);
+  return NULL;
+}
+
+long chunkmanifest_verify(const struct chunkmanifest *cm, int fd, int numthreads, size_t unitsize, int retries,
+                          bool stopatfirst, struct chunkmanifest_mismatch *mismatches, int maxmismatches,
+                          chunkmanifest_progressfunc progress, void *progressarg) {
+    struct chunkmanifest_verifier v;
+    pthread_t threads[CHUNKMANIFEST_MAXTHREADS];
+    struct timeval now;
+    struct timespec until;
+    unsigned long long bytestotal = 0;
+    unsigned long c;
+    int i, started = 0;
+    long numfound;
+    memset(&v, 0, sizeof(struct chunkmanifest_verifier));
+    v.cm = cm;
+    v.fd = fd;
+    v.unitsize = unitsize;
+    v.retries = retries;
+    v.stopatfirst = stopatfirst;
+    for (i=0;i<cm->numregions;i++) v.numjobs += cm->regions[i].numchunks;
+    v.jobs = (struct chunkmanifest_job *) calloc(v.numjobs ? v.numjobs : 1, sizeof(struct chunkmanifest_job));
+    v.found = (struct chunkmanifest_mismatch *) calloc(v.numjobs ? v.numjobs : 1, sizeof(struct chunkmanifest_mismatch));
+    if (v.jobs == NULL || v.found == NULL) {
+        free(v.jobs);
+        free(v.found);
+      return -1;
+    }
+    v.numjobs = 0;
+    for (i=0;i<cm->numregions;i++) {
+        for (c=0;c<cm->regions[i].numchunks;c++) {
+            v.jobs[v.numjobs].region = i;
+            v.jobs[v.numjobs].chunk = c;
+            v.jobs[v.numjobs].start = cm->regions[i].start + (unsigned long long) c * cm->regions[i].chunksize;
+            v.jobs[v.numjobs].end = v.jobs[v.numjobs].start + chunkmanifest_chunklength(&cm->regions[i], c);
+            bytestotal += v.jobs[v.numjobs].end - v.jobs[v.numjobs].start;
+            v.numjobs++;
+        }
+    }
+    // regions aren't necessarily in file order (L1 video comes after the game partition)
+    qsort(v.jobs, v.numjobs, sizeof(struct chunkmanifest_job), chunkmanifest_compare);
+    if (numthreads < 1) numthreads = 1;
+    if (numthreads > CHUNKMANIFEST_MAXTHREADS) numthreads = CHUNKMANIFEST_MAXTHREADS;
+    pthread_mutex_init(&v.lock, NULL);
+    pthread_cond_init(&v.finished, NULL);
+    pthread_mutex_lock(&v.lock);
+    for (i=0;i<numthreads;i++) {
+        if (pthread_create(&threads[i], NULL, chunkmanifest_thread, &v) != 0) {
+            v.failed = true;
+            break;
+        }
+        v.running++;
+        started++;
+    }
+    while (v.running) {
+        gettimeofday(&now, NULL);
+        until.tv_sec = now.tv_sec + (now.tv_usec >= 500000 ? 1 : 0);
+        until.tv_nsec = (long) ((now.tv_usec + 500000) % 1000000) * 1000;
+        pthread_cond_timedwait(&v.finished, &v.lock, &until);
+        if (progress != NULL) progress(progressarg, v.bytesdone, bytestotal);
+    }
+    pthread_mutex_unlock(&v.lock);
+    for (i=0;i<started;i++) pthread_join(threads[i], NULL);
+    pthread_mutex_destroy(&v.lock);
+    pthread_cond_destroy(&v.finished);
+    numfound = v.failed ? -1 : v.numfound;
+    if (!v.failed) {
+        qsort(v.found, (size_t) v.numfound, sizeof(struct chunkmanifest_mismatch), chunkmanifest_comparemismatch);
+        for (i=0;i<maxmismatches && i<v.numfound;i++) mismatches[i] = v.found[i];
+    }
+    free(v.jobs);
+    free(v.found);
+  return numfound;
+}
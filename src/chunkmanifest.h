@@ -0,0 +1,81 @@
+#ifndef _CHUNKMANIFEST_H
+#define _CHUNKMANIFEST_H
+
+// chunk manifest: the CRC-32 of every fixed size chunk of a few regions of an image (the video layers and the
+// game partition), built while those regions are read for their CRCs and saved next to the image, so that the image
+// can be reverified later a chunk at a time and any damage narrowed down to the chunks that changed
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#define CHUNKMANIFEST_CHUNKSIZE 16777216  // 16 MB
+#define CHUNKMANIFEST_MAXREGIONS 4
+#define CHUNKMANIFEST_BLOCKSIZE 2097152   // 2 MB per read when reverifying
+#define CHUNKMANIFEST_MAXTHREADS 64
+
+struct chunkmanifest_region {
+    char name[16];
+    unsigned long long start, end;
+    unsigned long long chunksize;
+    unsigned long numchunks;
+    unsigned long *crcs;
+    unsigned long long fed;           // bytes passed to chunkmanifest_update() so far
+};
+
+struct chunkmanifest {
+    unsigned long long filesize, chunksize;
+    int numregions;
+    struct chunkmanifest_region regions[CHUNKMANIFEST_MAXREGIONS];
+};
+
+// a chunk that didn't match when reverifying (status is READAHEAD_OK if it was read but its CRC is different,
+// otherwise READAHEAD_EOF or READAHEAD_READERROR and error has the errno)
+struct chunkmanifest_mismatch {
+    int region;
+    unsigned long chunk;
+    unsigned long long start, end;
+    unsigned long crc;
+    int status;
+    int error;
+};
+
+// called about twice a second while reverifying with the number of bytes checked so far out of the total
+typedef void (*chunkmanifest_progressfunc)(void *arg, unsigned long long bytesdone, unsigned long long bytestotal);
+
+void chunkmanifest_init(struct chunkmanifest *cm, unsigned long long filesize, unsigned long long chunksize);
+
+// free every region (cm can be reused after chunkmanifest_init())
+void chunkmanifest_free(struct chunkmanifest *cm);
+
+// start a region covering bytes [start, end) of the image, replacing any region with the same name
+// returns NULL if there are already CHUNKMANIFEST_MAXREGIONS regions or memory allocation failed
+struct chunkmanifest_region *chunkmanifest_addregion(struct chunkmanifest *cm, const char *name,
+                                                     unsigned long long start, unsigned long long end);
+
+// hash the next length bytes of the region into its chunk CRCs (data NULL means length zero bytes)
+void chunkmanifest_update(struct chunkmanifest_region *region, const unsigned char *data, size_t length);
+
+// true once the whole region has been passed to chunkmanifest_update()
+bool chunkmanifest_complete(const struct chunkmanifest_region *region);
+
+// CRC of everything passed to chunkmanifest_update() so far, combined from the chunk CRCs
+// (identical to one crc32() over the same bytes)
+unsigned long chunkmanifest_crc(const struct chunkmanifest_region *region);
+
+// save the complete regions to filename through a temp file and rename(), returns 0, 1 if there were no complete
+// regions to save, or -1 (errno set)
+int chunkmanifest_save(const struct chunkmanifest *cm, const char *filename);
+
+// load a manifest saved by chunkmanifest_save() into cm (which is initialized first)
+// returns 0, or -1 if it couldn't be opened (errno set) or it isn't a valid manifest (errno = EINVAL)
+int chunkmanifest_load(struct chunkmanifest *cm, const char *filename);
+
+// reread every chunk of every region from fd on numthreads threads (lowest offsets first) and compare the CRCs
+// read errors are retried unitsize bytes at a time (up to retries times); if stopatfirst is true no more chunks are
+// started once one doesn't match, otherwise everything is checked; up to maxmismatches mismatches are stored in
+// file order and the total number found is returned, or -1 if memory allocation or thread creation failed
+long chunkmanifest_verify(const struct chunkmanifest *cm, int fd, int numthreads, size_t unitsize, int retries,
+                          bool stopatfirst, struct chunkmanifest_mismatch *mismatches, int maxmismatches,
+                          chunkmanifest_progressfunc progress, void *progressarg);
+
+#endif /* chunkmanifest.h */
@@ -0,0 +1,236 @@
+/*
+ *  crc32.c - CRC-32 with runtime cpu dispatch for abgx360
+ *
+ *  The PCLMULQDQ kernel folds 64 bytes per iteration as described in Intel's "Fast CRC Computation
+ *  for Generic Polynomials Using PCLMULQDQ Instruction" (the constants are the bit-reflected ones
+ *  for the zlib polynomial, as used by Chromium's zlib).  The ARMv8 kernel uses the CRC32X/CRC32B
+ *  instructions.  Both fall back to slice-by-16 for short buffers and tails, which is also what
+ *  cpus without either get for everything.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "crc32.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define CRC32_X86
+    #include <cpuid.h>
+    #include <immintrin.h>
+#endif
+#if defined(__GNUC__) && defined(__aarch64__) && defined(__linux__)
+    #define CRC32_ARMV8
+    #include <sys/auxv.h>
+    #include <asm/hwcap.h>
+    #include <arm_acle.h>
+    #ifdef __clang__
+        #define CRC32_ARMV8_TARGET __attribute__((target("crc")))
+    #else
+        #define CRC32_ARMV8_TARGET __attribute__((target("+crc")))
+    #endif
+#endif
+
+#define CRC32_SLICE_BY_16 0
+#define CRC32_PCLMUL      1
+#define CRC32_ARMV8_CRC   2
+
+static uint32_t crc32_table[16][256];
+static int crc32_impl = -1;
+
+static uint32_t crc32_slice16(uint32_t crc, const unsigned char *buf, size_t len) {
+    while (len >= 16) {
+        crc ^= (uint32_t) buf[0] | (uint32_t) buf[1] << 8 | (uint32_t) buf[2] << 16 | (uint32_t) buf[3] << 24;
+        crc = crc32_table[15][crc & 0xff] ^ crc32_table[14][(crc >> 8) & 0xff] ^
+              crc32_table[13][(crc >> 16) & 0xff] ^ crc32_table[12][crc >> 24] ^
+              crc32_table[11][buf[4]] ^ crc32_table[10][buf[5]] ^ crc32_table[9][buf[6]] ^ crc32_table[8][buf[7]] ^
+              crc32_table[7][buf[8]] ^ crc32_table[6][buf[9]] ^ crc32_table[5][buf[10]] ^ crc32_table[4][buf[11]] ^
+              crc32_table[3][buf[12]] ^ crc32_table[2][buf[13]] ^ crc32_table[1][buf[14]] ^ crc32_table[0][buf[15]];
+        buf += 16;
+        len -= 16;
+    }
+    while (len--) crc = crc32_table[0][(crc ^ *buf++) & 0xff] ^ (crc >> 8);
+  return crc;
+}
+
+#ifdef CRC32_X86
+// len must be a multiple of 16 and at least 64, crc is the pre-inverted running value
+__attribute__((target("pclmul,sse4.1")))
+static uint32_t crc32_pclmul(uint32_t crc, const unsigned char *buf, size_t len) {
+    static const uint64_t __attribute__((aligned(16))) k1k2[] = {0x0154442bd4ULL, 0x01c6e41596ULL};
+    static const uint64_t __attribute__((aligned(16))) k3k4[] = {0x01751997d0ULL, 0x00ccaa009eULL};
+    static const uint64_t __attribute__((aligned(16))) k5k0[] = {0x0163cd6124ULL, 0x0000000000ULL};
+    static const uint64_t __attribute__((aligned(16))) poly[] = {0x01db710641ULL, 0x01f7011641ULL};
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+    x1 = _mm_loadu_si128((const __m128i *) (buf + 0x00));
+    x2 = _mm_loadu_si128((const __m128i *) (buf + 0x10));
+    x3 = _mm_loadu_si128((const __m128i *) (buf + 0x20));
+    x4 = _mm_loadu_si128((const __m128i *) (buf + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int) crc));
+    x0 = _mm_load_si128((const __m128i *) k1k2);
+    buf += 64;
+    len -= 64;
+
+    // fold 4 x 128 bits in parallel
+    while (len >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+        y5 = _mm_loadu_si128((const __m128i *) (buf + 0x00));
+        y6 = _mm_loadu_si128((const __m128i *) (buf + 0x10));
+        y7 = _mm_loadu_si128((const __m128i *) (buf + 0x20));
+        y8 = _mm_loadu_si128((const __m128i *) (buf + 0x30));
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+        buf += 64;
+        len -= 64;
+    }
+
+    // fold the 4 lanes into one
+    x0 = _mm_load_si128((const __m128i *) k3k4);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    // fold any remaining 16 byte blocks
+    while (len >= 16) {
+        x2 = _mm_loadu_si128((const __m128i *) buf);
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+        buf += 16;
+        len -= 16;
+    }
+
+    // 128 bits down to 64
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+    x0 = _mm_loadl_epi64((const __m128i *) k5k0);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // barrett reduction down to 32
+    x0 = _mm_load_si128((const __m128i *) poly);
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+  return (uint32_t) _mm_extract_epi32(x1, 1);
+}
+#endif
+
+#ifdef CRC32_ARMV8
+CRC32_ARMV8_TARGET
+static uint32_t crc32_armv8(uint32_t crc, const unsigned char *buf, size_t len) {
+    uint64_t word;
+    while (len && ((uintptr_t) buf & 7)) {
+        crc = __crc32b(crc, *buf++);
+        len--;
+    }
+    while (len >= 32) {
+        memcpy(&word, buf, 8);      crc = __crc32d(crc, word);
+        memcpy(&word, buf + 8, 8);  crc = __crc32d(crc, word);
+        memcpy(&word, buf + 16, 8); crc = __crc32d(crc, word);
+        memcpy(&word, buf + 24, 8); crc = __crc32d(crc, word);
+        buf += 32;
+        len -= 32;
+    }
+    while (len >= 8) {
+        memcpy(&word, buf, 8);
+        crc = __crc32d(crc, word);
+        buf += 8;
+        len -= 8;
+    }
+    while (len--) crc = __crc32b(crc, *buf++);
+  return crc;
+}
+#endif
+
+void crc32_init(void) {
+    uint32_t c;
+    int i, k;
+    for (i=0;i<256;i++) {
+        c = (uint32_t) i;
+        for (k=0;k<8;k++) c = c & 1 ? 0xedb88320UL ^ (c >> 1) : c >> 1;
+        crc32_table[0][i] = c;
+    }
+    for (i=0;i<256;i++) {
+        c = crc32_table[0][i];
+        for (k=1;k<16;k++) {
+            c = crc32_table[0][c & 0xff] ^ (c >> 8);
+            crc32_table[k][i] = c;
+        }
+    }
+    crc32_impl = CRC32_SLICE_BY_16;
+    #ifdef CRC32_X86
+    {
+        unsigned int eax, ebx, ecx, edx;
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_PCLMUL) && (ecx & bit_SSE4_1))
+            crc32_impl = CRC32_PCLMUL;
+    }
+    #endif
+    #ifdef CRC32_ARMV8
+        if (getauxval(AT_HWCAP) & HWCAP_CRC32) crc32_impl = CRC32_ARMV8_CRC;
+    #endif
+  return;
+}
+
+unsigned long crc32_fast(unsigned long crc, const unsigned char *buf, size_t len) {
+    uint32_t c;
+    #ifdef CRC32_X86
+        size_t chunk;
+    #endif
+    if (buf == NULL) return 0;  // zlib returns the initial value for crc32(x, Z_NULL, 0)
+    if (crc32_impl < 0) crc32_init();
+    c = ~(uint32_t) crc;
+    #ifdef CRC32_X86
+        if (crc32_impl == CRC32_PCLMUL && len >= 64) {
+            chunk = len & ~(size_t) 15;
+            c = crc32_pclmul(c, buf, chunk);
+            buf += chunk;
+            len -= chunk;
+        }
+    #endif
+    #ifdef CRC32_ARMV8
+        if (crc32_impl == CRC32_ARMV8_CRC) return (unsigned long) ~crc32_armv8(c, buf, len);
+    #endif
+  return (unsigned long) ~crc32_slice16(c, buf, len);
+}
+
+unsigned long crc32_zeros(unsigned long crc, unsigned long long len) {
+    // crc32_combine(x, 0, n) is x shifted through n zero bytes without the pre and post inversion, so
+    // ~shift(~crc) = shift(crc) ^ ~shift(0xffffffff) is what running crc over n zero bytes gives
+    unsigned long n;
+    while (len) {
+        n = len > 0x40000000 ? 0x40000000 : (unsigned long) len;  // keep it within any z_off_t
+        crc = (crc32_combine(crc, 0, (z_off_t) n) ^ ~crc32_combine(0xffffffffUL, 0, (z_off_t) n)) & 0xffffffffUL;
+        len -= n;
+    }
+  return crc;
+}
+
+const char *crc32_implementation(void) {
+    if (crc32_impl < 0) crc32_init();
+    if (crc32_impl == CRC32_PCLMUL) return "pclmul";
+    if (crc32_impl == CRC32_ARMV8_CRC) return "armv8";
+  return "slice-by-16";
+}
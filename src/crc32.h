@@ -0,0 +1,23 @@
+#ifndef _CRC32_H
+#define _CRC32_H
+
+// CRC-32 (the same polynomial, reflection and pre/post conditioning as zlib's crc32()) with the fastest
+// implementation this cpu supports picked at runtime: PCLMULQDQ folding on x86, the CRC32 instructions
+// on ARMv8, or slice-by-16 tables everywhere else
+
+#include <stddef.h>
+
+// pick an implementation and build the tables, call this once before any threads are started
+// (crc32_fast() will call it if you forget, but that isn't thread safe)
+void crc32_init(void);
+
+// drop-in replacement for zlib's crc32(crc, buf, len): continue crc over len bytes of buf
+unsigned long crc32_fast(unsigned long crc, const unsigned char *buf, size_t len);
+
+// continue crc over len zero bytes without touching any data (for holes in sparse files)
+unsigned long crc32_zeros(unsigned long crc, unsigned long long len);
+
+// name of the implementation crc32_init() picked ("pclmul", "armv8" or "slice-by-16")
+const char *crc32_implementation(void);
+
+#endif /* crc32.h */
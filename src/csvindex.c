@@ -0,0 +1,215 @@
+/*
+ *  csvindex.c - compiled index of GameNameLookup.csv for abgx360
+ *
+ *  The index file is a header followed by a power of two sized table of fixed size entries with linear probing,
+ *  so it can be mapped and searched in place.  The csv is read with the same rules checkcsv() used to scan it with
+ *  (2048 byte lines, any comma followed by 32 uppercase hex digits is a media id, the name is everything before the
+ *  first comma) and the first line that has a media id wins.  The header keeps the size and mtime of the csv, so an
+ *  updated csv makes the index stale.
+ */
+
+#define _LARGEFILE_SOURCE
+#define _LARGEFILE64_SOURCE
+#define _FILE_OFFSET_BITS 64
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "csvindex.h"
+
+#define CSVINDEX_MAGIC "abgxcsv1"
+
+static void csvindex_filestamp(const struct stat *st, int64_t *size, int64_t *sec, int64_t *nsec) {
+    *size = (int64_t) st->st_size;
+    *sec = (int64_t) st->st_mtime;
+    #if defined(__APPLE__)
+        *nsec = (int64_t) st->st_mtimespec.tv_nsec;
+    #else
+        *nsec = (int64_t) st->st_mtim.tv_nsec;
+    #endif
+  return;
+}
+
+static uint32_t csvindex_hash(const unsigned char *mediaid) {
+    // FNV-1a
+    uint32_t h = 0x811C9DC5U;
+    int i;
+    for (i=0;i<16;i++) {
+        h ^= mediaid[i];
+        h *= 0x01000193U;
+    }
+  return h;
+}
+
+int csvindex_open(struct csvindex *index, const char *filename, const char *csvfilename) {
+    struct stat st;
+    int64_t size, sec, nsec;
+    int fd;
+    memset(index, 0, sizeof(struct csvindex));
+    fd = open(filename, O_RDONLY);
+    if (fd == -1) return errno == ENOENT ? 1 : -1;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+      return -1;
+    }
+    if ((size_t) st.st_size < sizeof(struct csvindex_header)) {
+        close(fd);
+      return 1;
+    }
+    index->mapsize = (size_t) st.st_size;
+    index->map = mmap(NULL, index->mapsize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (index->map == MAP_FAILED) {
+        index->map = NULL;
+      return -1;
+    }
+    index->header = (const struct csvindex_header *) index->map;
+    index->slots = (const struct csvindex_entry *) ((const char *) index->map + sizeof(struct csvindex_header));
+    if (memcmp(index->header->magic, CSVINDEX_MAGIC, 8) != 0 || index->header->numslots == 0 ||
+        (index->header->numslots & (index->header->numslots - 1)) != 0 ||
+        index->mapsize != sizeof(struct csvindex_header) + (size_t) index->header->numslots * sizeof(struct csvindex_entry)) goto stale;
+    if (stat(csvfilename, &st) != 0) goto stale;
+    csvindex_filestamp(&st, &size, &sec, &nsec);
+    if (size != index->header->csvsize || sec != index->header->csvmtime_sec || nsec != index->header->csvmtime_nsec) goto stale;
+  return 0;
+
+    stale:
+    csvindex_close(index);
+  return 1;
+}
+
+void csvindex_close(struct csvindex *index) {
+    if (index->map != NULL) munmap(index->map, index->mapsize);
+    memset(index, 0, sizeof(struct csvindex));
+  return;
+}
+
+const struct csvindex_entry *csvindex_find(const struct csvindex *index, const unsigned char *mediaid) {
+    uint32_t mask, slot;
+    const struct csvindex_entry *entry;
+    if (index->map == NULL) return NULL;
+    mask = index->header->numslots - 1;
+    for (slot=csvindex_hash(mediaid) & mask;;slot=(slot + 1) & mask) {
+        entry = &index->slots[slot];
+        if (!entry->used) return NULL;
+        if (memcmp(entry->mediaid, mediaid, 16) == 0) return entry;
+    }
+}
+
+static int csvindex_hexdigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+static bool csvindex_parsemediaid(const char *s, unsigned char *mediaid) {
+    int i, hi, lo;
+    for (i=0;i<16;i++) {
+        hi = csvindex_hexdigit(s[i*2]);
+        lo = csvindex_hexdigit(s[i*2+1]);
+        if (hi < 0 || lo < 0) return false;
+        mediaid[i] = (unsigned char) (hi << 4 | lo);
+    }
+  return true;
+}
+
+static int csvindex_insert(struct csvindex_entry *slots, uint32_t numslots, const struct csvindex_entry *entry) {
+    // returns 1 if the media id was already there (an earlier line wins, like it did when the csv was scanned)
+    uint32_t mask = numslots - 1, slot;
+    for (slot=csvindex_hash(entry->mediaid) & mask;slots[slot].used;slot=(slot + 1) & mask) {
+        if (memcmp(slots[slot].mediaid, entry->mediaid, 16) == 0) return 1;
+    }
+    slots[slot] = *entry;
+  return 0;
+}
+
+int csvindex_build(const char *filename, const char *csvfilename, unsigned long *count) {
+    struct stat st;
+    struct csvindex_header header;
+    struct csvindex_entry entry, *entries = NULL, *grown, *slots;
+    unsigned long numentries = 0, maxentries = 0, i;
+    uint32_t numslots = 16;
+    char line[2048], tmpfilename[2048];
+    int a, c, error = 0;
+    FILE *stream;
+    *count = 0;
+    memset(&header, 0, sizeof(struct csvindex_header));
+    memcpy(header.magic, CSVINDEX_MAGIC, 8);
+    stream = fopen(csvfilename, "rb");
+    if (stream == NULL) return -1;
+    // take the stamp before reading so a csv that changes while we're reading it makes the index stale again
+    if (fstat(fileno(stream), &st) != 0) {
+        fclose(stream);
+      return -1;
+    }
+    csvindex_filestamp(&st, &header.csvsize, &header.csvmtime_sec, &header.csvmtime_nsec);
+    memset(line, 0, 2048);
+    while (fgets(line, 2048, stream) != NULL) {
+        for (c=0;c<2016;c++) {
+            if (line[c] != 0x2C) continue;  // 0x2C = comma
+            memset(&entry, 0, sizeof(struct csvindex_entry));
+            if (!csvindex_parsemediaid(line+c+1, entry.mediaid)) continue;
+            entry.used = 1;
+            for (a=0;line[a] != 0x2C && a < CSVINDEX_MAXNAME;a++) entry.name[a] = line[a];
+            if (numentries == maxentries) {
+                maxentries = maxentries ? maxentries * 2 : 1024;
+                grown = (struct csvindex_entry *) realloc(entries, maxentries * sizeof(struct csvindex_entry));
+                if (grown == NULL) {
+                    fclose(stream);
+                    free(entries);
+                    errno = ENOMEM;
+                  return -1;
+                }
+                entries = grown;
+            }
+            entries[numentries++] = entry;
+        }
+        memset(line, 0, 2048);
+    }
+    if (ferror(stream)) error = errno ? errno : EIO;
+    fclose(stream);
+    if (error) {
+        free(entries);
+        errno = error;
+      return -1;
+    }
+    // keep the table at most half full so probes stay short
+    while ((unsigned long) numslots < numentries * 2) numslots <<= 1;
+    slots = (struct csvindex_entry *) calloc(numslots, sizeof(struct csvindex_entry));
+    if (slots == NULL) {
+        free(entries);
+        errno = ENOMEM;
+      return -1;
+    }
+    for (i=0;i<numentries;i++) {
+        if (csvindex_insert(slots, numslots, &entries[i]) == 0) header.numentries++;
+    }
+    free(entries);
+    header.numslots = numslots;
+    snprintf(tmpfilename, sizeof(tmpfilename), "%s.%ld", filename, (long) getpid());
+    stream = fopen(tmpfilename, "wb");
+    if (stream == NULL) {
+        free(slots);
+      return -1;
+    }
+    if (fwrite(&header, sizeof(struct csvindex_header), 1, stream) != 1 ||
+        fwrite(slots, sizeof(struct csvindex_entry), numslots, stream) != numslots) error = errno ? errno : EIO;
+    free(slots);
+    if (fclose(stream) != 0 && !error) error = errno;
+    if (!error && rename(tmpfilename, filename) != 0) error = errno;
+    if (error) {
+        remove(tmpfilename);
+        errno = error;
+      return -1;
+    }
+    *count = header.numentries;
+  return 0;
+}
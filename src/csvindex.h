@@ -0,0 +1,45 @@
+#ifndef _CSVINDEX_H
+#define _CSVINDEX_H
+
+// csv index: the game names in GameNameLookup.csv parsed once into a memory-mappable hash table keyed by the binary
+// 16 byte media id, so looking up the name of a game doesn't have to scan the whole csv for every image
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CSVINDEX_MAXNAME 79  // checkcsv() shows at most 79 characters of the name
+
+struct csvindex_entry {
+    uint32_t used;
+    unsigned char mediaid[16];
+    char name[CSVINDEX_MAXNAME+1];
+};
+
+struct csvindex_header {
+    char magic[8];
+    uint32_t numslots, numentries;
+    int64_t csvsize, csvmtime_sec, csvmtime_nsec;  // size and mtime of the csv when the index was built
+};
+
+struct csvindex {
+    void *map;
+    size_t mapsize;
+    const struct csvindex_header *header;
+    const struct csvindex_entry *slots;
+};
+
+// map the index saved in filename, returns 0, 1 if it's missing, invalid or csvfilename has changed since it was
+// built (so it needs to be rebuilt), or -1 if it couldn't be mapped (errno set)
+int csvindex_open(struct csvindex *index, const char *filename, const char *csvfilename);
+
+void csvindex_close(struct csvindex *index);
+
+// parse csvfilename and save the index to filename through a temp file and rename(), returns 0 (*count is the number
+// of media ids indexed) or -1 (errno set)
+int csvindex_build(const char *filename, const char *csvfilename, unsigned long *count);
+
+// find a media id in an open index, returns NULL if it isn't there
+const struct csvindex_entry *csvindex_find(const struct csvindex *index, const unsigned char *mediaid);
+
+#endif /* csvindex.h */
@@ -0,0 +1,142 @@
+/*
+ *  filecopy.c - in-kernel file to file copies for abgx360
+ *
+ *  Every method is tried in turn from wherever the last one stopped.  If a method copied part of the
+ *  range and none of the later ones can continue, the rest goes through a read/write loop here so
+ *  the caller never has to pick up a half finished copy.  An i/o error doesn't end the copy here
+ *  though: the caller is told to redo the range with its own reads, which know about --retries.
+ */
+
+#define _LARGEFILE_SOURCE
+#define _LARGEFILE64_SOURCE
+#define _FILE_OFFSET_BITS 64
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+    #include <sys/ioctl.h>
+    #include <sys/sendfile.h>
+    #include <linux/fs.h>
+#endif
+
+#include "filecopy.h"
+
+#if defined(__linux__)
+// errors that mean this method can't be used for these files (rather than an i/o error)
+static int filecopy_unsupported(int error) {
+  return error == EXDEV || error == EINVAL || error == ENOSYS || error == EOPNOTSUPP || error == ENOTSUP || error == EBADF;
+}
+
+static int filecopy_readwrite(int infd, unsigned long long inoffset, int outfd, unsigned long long outoffset,
+                              unsigned long long length, unsigned long long *done,
+                              filecopy_progressfunc progress, void *progressarg) {
+    unsigned char *buffer;
+    size_t n;
+    ssize_t r, w;
+    buffer = malloc(1048576);
+    if (buffer == NULL) return FILECOPY_ERROR;
+    while (*done < length) {
+        n = length - *done > 1048576 ? 1048576 : (size_t) (length - *done);
+        r = pread(infd, buffer, n, (off_t) (inoffset + *done));
+        if (r == -1 && errno == EINTR) continue;
+        if (r <= 0) {
+            if (r == 0) errno = EIO;  // the source ended early
+            free(buffer);
+          return FILECOPY_FAILED;
+        }
+        w = pwrite(outfd, buffer, (size_t) r, (off_t) (outoffset + *done));
+        if (w == -1 && errno == EINTR) continue;
+        if (w != r) {
+            if (w >= 0) errno = ENOSPC;
+            free(buffer);
+          return FILECOPY_ERROR;
+        }
+        *done += (unsigned long long) w;
+        if (progress != NULL) progress(progressarg, *done, length);
+    }
+    free(buffer);
+  return FILECOPY_OK;
+}
+#endif
+
+int filecopy_range(int infd, unsigned long long inoffset, int outfd, unsigned long long outoffset, unsigned long long length,
+                   filecopy_progressfunc progress, void *progressarg, const char **method) {
+    #if defined(__linux__)
+        unsigned long long done = 0;
+        size_t chunk;
+        ssize_t n;
+        loff_t inpos, outpos;
+        off_t sendpos;
+        #ifdef FICLONERANGE
+            struct stat st;
+            struct file_clone_range clone;
+            unsigned long long blocksize;
+        #endif
+        *method = NULL;
+        if (length == 0) return FILECOPY_OK;
+        #ifdef FICLONERANGE
+            // reflinks have to start on a block boundary and cover whole blocks, any tail is copied below
+            if (fstat(outfd, &st) == 0 && st.st_blksize > 0) {
+                blocksize = (unsigned long long) st.st_blksize;
+                if (inoffset % blocksize == 0 && outoffset % blocksize == 0 && length >= blocksize) {
+                    clone.src_fd = infd;
+                    clone.src_offset = inoffset;
+                    clone.src_length = length - length % blocksize;
+                    clone.dest_offset = outoffset;
+                    if (ioctl(outfd, FICLONERANGE, &clone) == 0) {
+                        done = clone.src_length;
+                        *method = "reflink";
+                        if (progress != NULL) progress(progressarg, done, length);
+                    }
+                }
+            }
+        #endif
+        while (done < length) {
+            chunk = length - done > FILECOPY_CHUNK ? FILECOPY_CHUNK : (size_t) (length - done);
+            inpos = (loff_t) (inoffset + done);
+            outpos = (loff_t) (outoffset + done);
+            n = copy_file_range(infd, &inpos, outfd, &outpos, chunk, 0);
+            if (n == -1 && errno == EINTR) continue;
+            if (n == -1 && filecopy_unsupported(errno)) break;
+            if (n == -1) return FILECOPY_FAILED;
+            if (n == 0) break;  // the source ended early, let the read/write loop report it
+            done += (unsigned long long) n;
+            if (*method == NULL) *method = "copy_file_range";
+            if (progress != NULL) progress(progressarg, done, length);
+        }
+        // sendfile writes at the file position of outfd
+        if (done < length && lseek(outfd, (off_t) (outoffset + done), SEEK_SET) != -1) {
+            while (done < length) {
+                chunk = length - done > FILECOPY_CHUNK ? FILECOPY_CHUNK : (size_t) (length - done);
+                sendpos = (off_t) (inoffset + done);
+                n = sendfile(outfd, infd, &sendpos, chunk);
+                if (n == -1 && errno == EINTR) continue;
+                if (n == -1 && filecopy_unsupported(errno)) break;
+                if (n == -1) return FILECOPY_FAILED;
+                if (n == 0) break;
+                done += (unsigned long long) n;
+                if (*method == NULL) *method = "sendfile";
+                if (progress != NULL) progress(progressarg, done, length);
+            }
+        }
+        if (done == length) return FILECOPY_OK;
+        if (done == 0) return FILECOPY_UNSUPPORTED;
+        if (*method == NULL) *method = "read/write";
+      return filecopy_readwrite(infd, inoffset, outfd, outoffset, length, &done, progress, progressarg);
+    #else
+        (void) infd;
+        (void) inoffset;
+        (void) outfd;
+        (void) outoffset;
+        (void) length;
+        (void) progress;
+        (void) progressarg;
+        *method = NULL;
+      return FILECOPY_UNSUPPORTED;
+    #endif
+}
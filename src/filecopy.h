@@ -0,0 +1,23 @@
+#ifndef _FILECOPY_H
+#define _FILECOPY_H
+
+// bulk copies between two files that stay inside the kernel: a reflink (FICLONERANGE) when both files are on
+// the same filesystem and it can share extents, otherwise copy_file_range() or sendfile()
+
+#define FILECOPY_OK          0
+#define FILECOPY_ERROR       1  // errno says why
+#define FILECOPY_UNSUPPORTED 2  // nothing was copied, copy it through user space instead
+#define FILECOPY_FAILED      3  // a read (or an error the kernel doesn't pin on either file) failed partway, errno says
+                                 // why, copy the whole range through user space instead so the reads can be retried
+
+#define FILECOPY_CHUNK 67108864  // bytes per copy_file_range/sendfile call, so there's progress to report
+
+// called after every chunk with the number of bytes copied so far
+typedef void (*filecopy_progressfunc)(void *arg, unsigned long long bytesdone, unsigned long long bytestotal);
+
+// copy bytes [inoffset, inoffset+length) of infd to outoffset in outfd, the file position of outfd is undefined afterwards
+// method is set to the name of whatever did the copying ("reflink", "copy_file_range", "sendfile" or "read/write")
+int filecopy_range(int infd, unsigned long long inoffset, int outfd, unsigned long long outoffset, unsigned long long length,
+                   filecopy_progressfunc progress, void *progressarg, const char **method);
+
+#endif /* filecopy.h */
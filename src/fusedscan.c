@@ -0,0 +1,105 @@
+/*
+ *  fusedscan.c - single forward sweep over a file for several consumers at once (for abgx360)
+ *
+ *  The consumer ranges are sorted and merged into extents (ranges closer together than
+ *  FUSEDSCAN_MAXGAP are merged so the gap is read through rather than seeked over), and
+ *  every extent is read once through the read-ahead ring.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "readahead.h"
+#include "fusedscan.h"
+
+struct fusedscan_extent {
+    unsigned long long start, end;
+};
+
+void fusedscan_init(struct fusedscan *fs) {
+    memset(fs, 0, sizeof(struct fusedscan));
+  return;
+}
+
+int fusedscan_add(struct fusedscan *fs, unsigned long long start, unsigned long long end, fusedscan_func func, void *arg) {
+    if (fs->numconsumers == FUSEDSCAN_MAXCONSUMERS) return 1;
+    if (end <= start) return 0;  // nothing to read
+    fs->consumers[fs->numconsumers].start = start;
+    fs->consumers[fs->numconsumers].end = end;
+    fs->consumers[fs->numconsumers].func = func;
+    fs->consumers[fs->numconsumers].arg = arg;
+    fs->numconsumers++;
+  return 0;
+}
+
+// sort the consumer ranges by start offset and merge them into as few extents as possible
+static int fusedscan_plan(struct fusedscan *fs, struct fusedscan_extent *extents) {
+    struct fusedscan_extent sorted[FUSEDSCAN_MAXCONSUMERS], tmp;
+    int i, j, numextents = 0;
+    for (i=0;i<fs->numconsumers;i++) {
+        sorted[i].start = fs->consumers[i].start;
+        sorted[i].end = fs->consumers[i].end;
+        for (j=i;j>0 && sorted[j-1].start > sorted[j].start;j--) {
+            tmp = sorted[j-1];
+            sorted[j-1] = sorted[j];
+            sorted[j] = tmp;
+        }
+    }
+    for (i=0;i<fs->numconsumers;i++) {
+        if (numextents && sorted[i].start <= extents[numextents-1].end + FUSEDSCAN_MAXGAP) {
+            if (sorted[i].end > extents[numextents-1].end) extents[numextents-1].end = sorted[i].end;
+        }
+        else extents[numextents++] = sorted[i];
+    }
+  return numextents;
+}
+
+int fusedscan_run(struct fusedscan *fs, int fd, size_t unitsize, int retries, const struct readahead_settings *settings,
+                  fusedscan_progressfunc progress, void *progressarg) {
+    struct fusedscan_extent extents[FUSEDSCAN_MAXCONSUMERS];
+    struct fusedscan_consumer *consumer;
+    struct readahead ra;
+    struct readahead_block *block;
+    unsigned long long start, end, extentdone;
+    int i, e, numextents;
+    numextents = fusedscan_plan(fs, extents);
+    fs->bytesdone = 0;
+    fs->bytestotal = 0;
+    fs->status = READAHEAD_OK;
+    for (e=0;e<numextents;e++) fs->bytestotal += extents[e].end - extents[e].start;
+    for (e=0;e<numextents && fs->status == READAHEAD_OK;e++) {
+        if (readahead_start(&ra, fd, extents[e].start, extents[e].end - extents[e].start, unitsize, retries, settings) != 0) return -1;
+        extentdone = 0;
+        while ((block = readahead_next(&ra)) != NULL) {
+            for (i=0;i<fs->numconsumers;i++) {
+                consumer = &fs->consumers[i];
+                start = block->offset > consumer->start ? block->offset : consumer->start;
+                end = block->offset + block->length < consumer->end ? block->offset + block->length : consumer->end;
+                if (start < end) consumer->func(consumer->arg, block->hole ? NULL : block->data + (start - block->offset),
+                                                (size_t) (end - start), start);
+            }
+            fs->bytesdone += block->length;
+            extentdone += block->length;
+            fs->retries += block->retries;
+            fs->recovered += block->recovered;
+            if (block->status != READAHEAD_OK) {
+                fs->status = block->status;
+                fs->error = block->error;
+                fs->erroroffset = block->offset + block->length;
+                readahead_release(&ra);
+              break;
+            }
+            readahead_release(&ra);
+            if (progress != NULL) progress(progressarg, fs->bytesdone, fs->bytestotal);
+        }
+        readahead_stop(&ra);
+        // the reader stopped early without saying why, so the consumers didn't see all of their ranges (an OK result
+        // always means bytesdone == bytestotal)
+        if (fs->status == READAHEAD_OK && extentdone != extents[e].end - extents[e].start) {
+            fs->status = READAHEAD_READERROR;
+            fs->error = EIO;
+            fs->erroroffset = extents[e].start + extentdone;
+        }
+    }
+  return fs->status;
+}
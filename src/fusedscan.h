@@ -0,0 +1,50 @@
+#ifndef _FUSEDSCAN_H
+#define _FUSEDSCAN_H
+
+// fused scan: several consumers register the byte ranges of a file they want to see, the scan plans one
+// forward sweep over all of them and hands every block it reads to each consumer whose range it overlaps
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "readahead.h"
+
+#define FUSEDSCAN_MAXCONSUMERS 16
+#define FUSEDSCAN_MAXGAP 4194304  // gaps between ranges smaller than this are read through instead of seeking
+
+// called with the part of each block that falls inside the consumer's range, offset is the file offset of data[0]
+// data is NULL if that part is a hole in a sparse file (all zeroes, so it wasn't read)
+typedef void (*fusedscan_func)(void *arg, const unsigned char *data, size_t length, unsigned long long offset);
+
+// called after every block with the number of bytes read so far out of the total the sweep will read
+typedef void (*fusedscan_progressfunc)(void *arg, unsigned long long bytesdone, unsigned long long bytestotal);
+
+struct fusedscan_consumer {
+    unsigned long long start, end;
+    fusedscan_func func;
+    void *arg;
+};
+
+struct fusedscan {
+    int numconsumers;
+    struct fusedscan_consumer consumers[FUSEDSCAN_MAXCONSUMERS];
+    unsigned long long bytesdone, bytestotal;
+    unsigned long retries, recovered;
+    int status;                     // READAHEAD_OK, READAHEAD_EOF or READAHEAD_READERROR
+    int error;
+    unsigned long long erroroffset;
+};
+
+void fusedscan_init(struct fusedscan *fs);
+
+// add a consumer for bytes [start, end) of the file, returns 1 if there are already FUSEDSCAN_MAXCONSUMERS
+int fusedscan_add(struct fusedscan *fs, unsigned long long start, unsigned long long end, fusedscan_func func, void *arg);
+
+// read every range once in file order with readahead settings (NULL for the defaults), read errors are retried
+// unitsize bytes at a time (up to retries times)
+// returns READAHEAD_OK, READAHEAD_EOF or READAHEAD_READERROR (fs->erroroffset has where it happened),
+// or -1 if the reader could not be started
+int fusedscan_run(struct fusedscan *fs, int fd, size_t unitsize, int retries, const struct readahead_settings *settings,
+                  fusedscan_progressfunc progress, void *progressarg);
+
+#endif /* fusedscan.h */
@@ -0,0 +1,296 @@
+/*
+ *  iniindex.c - compiled index of the local verified/unverified inis for abgx360
+ *
+ *  The index file is a header followed by a power of two sized table of fixed size entries with linear probing,
+ *  so it can be mapped and searched in place.  Inis are parsed with the same rules as parseini() and
+ *  openinifromxexini() (first 60 lines, 30 DMI CRCs, 20 SS CRCs).  The header keeps the mtime of the
+ *  StealthFiles directory, adding, removing or renaming an ini there makes the index stale.  An ini that's
+ *  rewritten in place doesn't change the directory, so every entry also keeps the size and mtime of its ini
+ *  and iniindex_current() checks them for the entries that are actually looked up (checking all of them on
+ *  every open would cost a stat per ini per image).
+ */
+
+#define _LARGEFILE_SOURCE
+#define _LARGEFILE64_SOURCE
+#define _FILE_OFFSET_BITS 64
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "iniindex.h"
+
+#define INIINDEX_MAGIC "abgxidx2"
+
+static void iniindex_mtime(const struct stat *st, int64_t *sec, int64_t *nsec) {
+    *sec = (int64_t) st->st_mtime;
+    #if defined(__APPLE__)
+        *nsec = (int64_t) st->st_mtimespec.tv_nsec;
+    #else
+        *nsec = (int64_t) st->st_mtim.tv_nsec;
+    #endif
+  return;
+}
+
+// the name an entry was indexed under, the inverse of iniindex_nameentry()
+static void iniindex_entryname(const struct iniindex_entry *entry, char *name, size_t size) {
+    if (entry->kind == INIINDEX_XEX) snprintf(name, size, "Xex_%08X.ini", (unsigned int) entry->xex);
+    else if (entry->kind == INIINDEX_UNVERIFIED) snprintf(name, size, "%08X%08X_%u.ini", (unsigned int) entry->ss,
+                                                          (unsigned int) entry->xex, (unsigned int) entry->number);
+    else snprintf(name, size, "%08X%08X.ini", (unsigned int) entry->ss, (unsigned int) entry->xex);
+  return;
+}
+
+bool iniindex_current(const struct iniindex_entry *entry, const char *dir) {
+    struct stat st;
+    int64_t sec, nsec;
+    char path[2048], name[32];
+    iniindex_entryname(entry, name, sizeof(name));
+    snprintf(path, sizeof(path), "%s%s", dir, name);
+    if (stat(path, &st) != 0 || (uint32_t) st.st_size != entry->filesize) return false;
+    iniindex_mtime(&st, &sec, &nsec);
+  return sec == entry->mtime_sec && nsec == entry->mtime_nsec;
+}
+
+static uint32_t iniindex_hash(uint32_t kind, uint32_t ss, uint32_t xex, uint32_t number) {
+    uint32_t h = kind * 0x9E3779B1U;
+    h ^= ss + 0x7F4A7C15U + (h << 6) + (h >> 2);
+    h ^= xex + 0x7F4A7C15U + (h << 6) + (h >> 2);
+    h ^= number + 0x7F4A7C15U + (h << 6) + (h >> 2);
+  return h;
+}
+
+int iniindex_open(struct iniindex *index, const char *filename, const char *dir) {
+    struct stat st;
+    int64_t sec, nsec;
+    int fd;
+    memset(index, 0, sizeof(struct iniindex));
+    fd = open(filename, O_RDONLY);
+    if (fd == -1) return errno == ENOENT ? 1 : -1;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+      return -1;
+    }
+    if ((size_t) st.st_size < sizeof(struct iniindex_header)) {
+        close(fd);
+      return 1;
+    }
+    index->mapsize = (size_t) st.st_size;
+    index->map = mmap(NULL, index->mapsize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (index->map == MAP_FAILED) {
+        index->map = NULL;
+      return -1;
+    }
+    index->header = (const struct iniindex_header *) index->map;
+    index->slots = (const struct iniindex_entry *) ((const char *) index->map + sizeof(struct iniindex_header));
+    if (memcmp(index->header->magic, INIINDEX_MAGIC, 8) != 0 || index->header->numslots == 0 ||
+        (index->header->numslots & (index->header->numslots - 1)) != 0 ||
+        index->mapsize != sizeof(struct iniindex_header) + (size_t) index->header->numslots * sizeof(struct iniindex_entry)) goto stale;
+    if (stat(dir, &st) != 0) goto stale;
+    iniindex_mtime(&st, &sec, &nsec);
+    if (sec != index->header->dirmtime_sec || nsec != index->header->dirmtime_nsec) goto stale;
+  return 0;
+
+    stale:
+    iniindex_close(index);
+  return 1;
+}
+
+void iniindex_close(struct iniindex *index) {
+    if (index->map != NULL) munmap(index->map, index->mapsize);
+    memset(index, 0, sizeof(struct iniindex));
+  return;
+}
+
+const struct iniindex_entry *iniindex_find(const struct iniindex *index, uint32_t kind, uint32_t ss, uint32_t xex, uint32_t number) {
+    uint32_t mask, slot;
+    const struct iniindex_entry *entry;
+    if (index->map == NULL) return NULL;
+    if (kind != INIINDEX_UNVERIFIED) number = 0;
+    mask = index->header->numslots - 1;
+    for (slot=iniindex_hash(kind, ss, xex, number) & mask;;slot=(slot + 1) & mask) {
+        entry = &index->slots[slot];
+        if (entry->kind == 0) return NULL;
+        if (entry->kind == kind && entry->ss == ss && entry->xex == xex && entry->number == number) return entry;
+    }
+}
+
+static bool iniindex_ishex(const char *s, int n) {
+    int i;
+    for (i=0;i<n;i++) if (!((s[i] >= '0' && s[i] <= '9') || (s[i] >= 'A' && s[i] <= 'F'))) return false;
+  return true;
+}
+
+static void iniindex_parseini(FILE *stream, struct iniindex_entry *entry) {
+    // same fields and limits as parseini()
+    char line[200];
+    int i, linesread = 0;
+    memset(line, 0, 200);
+    while (fgets(line, 200, stream) != NULL && linesread < INIINDEX_MAXLINES) {
+        for (i=2;i<12;i++) {
+            if (line[i] == '=') {
+                if (memcmp(line, "DMI", i) == 0 && entry->count < INIINDEX_MAXCRCS) entry->crcs[entry->count++] = (uint32_t) strtoul(line+i+1, NULL, 16);
+                else if (memcmp(line, "SS", i) == 0) entry->ini_ss = (uint32_t) strtoul(line+i+1, NULL, 16);
+                else if (memcmp(line, "PFI", i) == 0) entry->pfi = (uint32_t) strtoul(line+i+1, NULL, 16);
+                else if (memcmp(line, "Video", i) == 0) entry->video = (uint32_t) strtoul(line+i+1, NULL, 16);
+                else if (memcmp(line, "RawSS", i) == 0) entry->rawss = (uint32_t) strtoul(line+i+1, NULL, 16);
+                else if (memcmp(line, "V0", i) == 0) entry->v0 = (uint32_t) strtoul(line+i+1, NULL, 16);
+                else if (memcmp(line, "V1", i) == 0) entry->v1 = (uint32_t) strtoul(line+i+1, NULL, 16);
+                else if (memcmp(line, "Game", i) == 0) entry->game = (uint32_t) strtoul(line+i+1, NULL, 16);
+                else if (memcmp(line, "XexHash", i) == 0) entry->xexhash = (uint32_t) strtoul(line+i+1, NULL, 16);
+            }
+        }
+        memset(line, 0, 200);
+        linesread++;
+    }
+  return;
+}
+
+static void iniindex_parsexexini(FILE *stream, struct iniindex_entry *entry) {
+    // same as openinifromxexini(): one 8 digit SS CRC per line, anything else is skipped
+    char line[11];
+    int i;
+    bool invalidline;
+    memset(line, 0, 11);
+    while (fgets(line, 11, stream) != NULL && entry->count < INIINDEX_MAXSSCRCS) {
+        invalidline = false;
+        for (i=0;i<8;i++) if (line[i] < 0x30 || (line[i] > 0x39 && line[i] < 0x41) || (line[i] > 0x46 && line[i] < 0x61) || line[i] > 0x66) invalidline = true;
+        if (invalidline || (line[8] != 0x0A && line[8] != 0x0D)) continue;
+        entry->crcs[entry->count++] = (uint32_t) strtoul(line, NULL, 16);
+    }
+  return;
+}
+
+int iniindex_parsefile(const char *path, uint32_t kind, struct iniindex_entry *entry) {
+    FILE *stream;
+    memset(entry, 0, sizeof(struct iniindex_entry));
+    entry->kind = kind;
+    stream = fopen(path, "rb");
+    if (stream == NULL) return -1;
+    if (kind == INIINDEX_XEX) iniindex_parsexexini(stream, entry);
+    else iniindex_parseini(stream, entry);
+    fclose(stream);
+  return 0;
+}
+
+static int iniindex_nameentry(const char *name, struct iniindex_entry *entry) {
+    // returns 0 and fills in the key if name is one of the ini names abgx360 uses
+    char crc[9];
+    size_t len = strlen(name);
+    unsigned long number;
+    char *end;
+    memset(entry, 0, sizeof(struct iniindex_entry));
+    if (len == 16 && strncmp(name, "Xex_", 4) == 0 && strcmp(name+12, ".ini") == 0 && iniindex_ishex(name+4, 8)) {
+        entry->kind = INIINDEX_XEX;
+        entry->xex = (uint32_t) strtoul(name+4, NULL, 16);
+      return 0;
+    }
+    if (len < 20 || !iniindex_ishex(name, 16) || strcmp(name+len-4, ".ini") != 0) return 1;
+    if (len == 20) entry->kind = INIINDEX_SSXEX;
+    else if (name[16] == '_' && len <= 23 && name[17] >= '1' && name[17] <= '9') {
+        number = strtoul(name+17, &end, 10);
+        if (end != name+len-4) return 1;
+        entry->kind = INIINDEX_UNVERIFIED;
+        entry->number = (uint32_t) number;
+    }
+    else return 1;
+    memcpy(crc, name, 8); crc[8] = 0;
+    entry->ss = (uint32_t) strtoul(crc, NULL, 16);
+    memcpy(crc, name+8, 8); crc[8] = 0;
+    entry->xex = (uint32_t) strtoul(crc, NULL, 16);
+  return 0;
+}
+
+int iniindex_build(const char *filename, const char *dir, unsigned long *count) {
+    DIR *dp;
+    struct dirent *ep;
+    struct stat st;
+    struct iniindex_header header;
+    struct iniindex_entry entry, *entries = NULL, *grown, *slots;
+    unsigned long numentries = 0, maxentries = 0, i;
+    uint32_t numslots = 16, mask, slot;
+    char path[2048], tmpfilename[2048];
+    FILE *stream;
+    int error = 0;
+    *count = 0;
+    memset(&header, 0, sizeof(struct iniindex_header));
+    memcpy(header.magic, INIINDEX_MAGIC, 8);
+    // take the mtime first so anything that changes while we're reading makes the index stale again
+    if (stat(dir, &st) != 0) return -1;
+    iniindex_mtime(&st, &header.dirmtime_sec, &header.dirmtime_nsec);
+    dp = opendir(dir);
+    if (dp == NULL) return -1;
+    while ((ep = readdir(dp)) != NULL) {
+        if (iniindex_nameentry(ep->d_name, &entry) != 0) continue;
+        snprintf(path, sizeof(path), "%s%s", dir, ep->d_name);
+        stream = fopen(path, "rb");
+        if (stream == NULL) continue;
+        if (fstat(fileno(stream), &st) != 0 || !S_ISREG(st.st_mode)) {
+            fclose(stream);
+          continue;
+        }
+        // taken before parsing for the same reason as the directory mtime
+        entry.filesize = (uint32_t) st.st_size;
+        iniindex_mtime(&st, &entry.mtime_sec, &entry.mtime_nsec);
+        if (entry.kind == INIINDEX_XEX) iniindex_parsexexini(stream, &entry);
+        else iniindex_parseini(stream, &entry);
+        fclose(stream);
+        if (numentries == maxentries) {
+            maxentries = maxentries ? maxentries * 2 : 1024;
+            grown = (struct iniindex_entry *) realloc(entries, maxentries * sizeof(struct iniindex_entry));
+            if (grown == NULL) {
+                closedir(dp);
+                free(entries);
+                errno = ENOMEM;
+              return -1;
+            }
+            entries = grown;
+        }
+        entries[numentries++] = entry;
+    }
+    closedir(dp);
+    // keep the table at most half full so probes stay short
+    while ((unsigned long) numslots < numentries * 2) numslots <<= 1;
+    slots = (struct iniindex_entry *) calloc(numslots, sizeof(struct iniindex_entry));
+    if (slots == NULL) {
+        free(entries);
+        errno = ENOMEM;
+      return -1;
+    }
+    mask = numslots - 1;
+    for (i=0;i<numentries;i++) {
+        for (slot=iniindex_hash(entries[i].kind, entries[i].ss, entries[i].xex, entries[i].number) & mask;
+             slots[slot].kind != 0;slot=(slot + 1) & mask);
+        slots[slot] = entries[i];
+    }
+    free(entries);
+    header.numslots = numslots;
+    header.numentries = (uint32_t) numentries;
+    snprintf(tmpfilename, sizeof(tmpfilename), "%s.%ld", filename, (long) getpid());
+    stream = fopen(tmpfilename, "wb");
+    if (stream == NULL) {
+        free(slots);
+      return -1;
+    }
+    if (fwrite(&header, sizeof(struct iniindex_header), 1, stream) != 1 ||
+        fwrite(slots, sizeof(struct iniindex_entry), numslots, stream) != numslots) error = errno ? errno : EIO;
+    free(slots);
+    if (fclose(stream) != 0 && !error) error = errno;
+    if (!error && rename(tmpfilename, filename) != 0) error = errno;
+    if (error) {
+        remove(tmpfilename);
+        errno = error;
+      return -1;
+    }
+    *count = numentries;
+  return 0;
+}
@@ -0,0 +1,64 @@
+#ifndef _INIINDEX_H
+#define _INIINDEX_H
+
+// ini index: every verified and unverified ini in the StealthFiles directory parsed once into a memory-mappable
+// hash table keyed by (ss crc, xex crc) or by the xex crc alone, so local lookups don't have to open and parse
+// an ini file each time
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// entry kinds
+#define INIINDEX_SSXEX      1  // <ss crc><xex crc>.ini
+#define INIINDEX_XEX        2  // Xex_<xex crc>.ini, crcs[] holds its SS CRCs
+#define INIINDEX_UNVERIFIED 3  // <ss crc><xex crc>_<number>.ini
+
+#define INIINDEX_MAXCRCS 30    // DMI CRCs per ini (parseini() keeps 30)
+#define INIINDEX_MAXSSCRCS 20  // SS CRCs per xex ini (openinifromxexini() keeps 20)
+#define INIINDEX_MAXLINES 60   // same as MAX_INI_LINES
+
+struct iniindex_entry {
+    uint32_t kind, ss, xex, number;
+    uint32_t filesize;
+    uint32_t ini_ss, pfi, video, rawss, v0, v1, game, xexhash;
+    uint32_t count;            // number of DMI CRCs (or SS CRCs for INIINDEX_XEX) in crcs[]
+    uint32_t crcs[INIINDEX_MAXCRCS];
+    int64_t mtime_sec, mtime_nsec;  // mtime of the ini when it was parsed (filesize is its size then)
+};
+
+struct iniindex_header {
+    char magic[8];
+    uint32_t numslots, numentries;
+    int64_t dirmtime_sec, dirmtime_nsec;  // mtime of the directory when the index was built
+};
+
+struct iniindex {
+    void *map;
+    size_t mapsize;
+    const struct iniindex_header *header;
+    const struct iniindex_entry *slots;
+};
+
+// map the index saved in filename, returns 0, 1 if it's missing, invalid or older than the last change to dir
+// (so it needs to be rebuilt), or -1 if it couldn't be mapped (errno set)
+int iniindex_open(struct iniindex *index, const char *filename, const char *dir);
+
+void iniindex_close(struct iniindex *index);
+
+// parse every ini in dir (which needs to end with a directory separator) and save the index to filename through
+// a temp file and rename(), returns 0 (*count is the number of inis indexed) or -1 (errno set)
+int iniindex_build(const char *filename, const char *dir, unsigned long *count);
+
+// parse a single ini the way the index does (kind INIINDEX_XEX for a Xex_ ini, anything else for an SS/Xex ini),
+// only the values are filled in, returns 0 or -1 if it couldn't be opened (errno set)
+int iniindex_parsefile(const char *path, uint32_t kind, struct iniindex_entry *entry);
+
+// find an entry in an open index, returns NULL if it isn't there (number is only used for INIINDEX_UNVERIFIED)
+const struct iniindex_entry *iniindex_find(const struct iniindex *index, uint32_t kind, uint32_t ss, uint32_t xex, uint32_t number);
+
+// true if the ini an entry came from (in dir, which needs to end with a directory separator) still has the size
+// and mtime it had when it was parsed, false if it was rewritten in place or is gone
+bool iniindex_current(const struct iniindex_entry *entry, const char *dir);
+
+#endif /* iniindex.h */
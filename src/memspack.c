@@ -0,0 +1,149 @@
+/*
+ *  memspack.c - in-memory mspack_system for abgx360
+ *
+ *  Opening for reading starts at the beginning of the buffer's data, opening for writing truncates it to nothing and
+ *  then appends up to its capacity.  Seeking works the same as on a file except that it can't go past the end of the
+ *  data.  A reader that catches up with the data can ask the buffer's more() for the rest of it, so the input can
+ *  still be arriving while it's being decompressed; what has already been read is dropped first, so the buffer only
+ *  ever has to hold one piece of it.  A window buffer being written to keeps just the part of the output it was
+ *  asked for.  Allocation and messages go through the standard C library like
+ *  mspack_default_system.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "memspack.h"
+
+struct memspack_file {
+    struct memspack_buffer *buffer;
+    size_t position;
+    size_t dropped;  // bytes that more() has already thrown away in front of data
+};
+
+static struct mspack_file *memspack_open(struct mspack_system *this, char *filename, int mode) {
+    struct memspack_buffer *buffer = (struct memspack_buffer *) filename;
+    struct memspack_file *fh;
+    (void) this;
+    if (buffer == NULL) return NULL;
+    switch (mode) {
+        case MSPACK_SYS_OPEN_READ:
+        case MSPACK_SYS_OPEN_UPDATE:
+        case MSPACK_SYS_OPEN_APPEND:
+          break;
+        case MSPACK_SYS_OPEN_WRITE:
+            buffer->size = 0;
+          break;
+        default:
+          return NULL;
+    }
+    fh = (struct memspack_file *) malloc(sizeof(struct memspack_file));
+    if (fh == NULL) return NULL;
+    fh->buffer = buffer;
+    fh->dropped = 0;
+    fh->position = mode == MSPACK_SYS_OPEN_APPEND ? buffer->size : 0;
+  return (struct mspack_file *) fh;
+}
+
+static void memspack_close(struct mspack_file *file) {
+    free(file);
+  return;
+}
+
+static int memspack_read(struct mspack_file *file, void *buffer, int bytes) {
+    struct memspack_file *fh = (struct memspack_file *) file;
+    size_t count;
+    if (fh == NULL || bytes < 0) return -1;
+    while (bytes && fh->position == fh->buffer->size && fh->buffer->more != NULL) {
+        fh->dropped += fh->buffer->size;
+        fh->buffer->size = 0;
+        fh->position = 0;
+        if (!fh->buffer->more(fh->buffer)) break;
+    }
+    count = fh->buffer->size - fh->position;
+    if (count > (size_t) bytes) count = (size_t) bytes;
+    memcpy(buffer, fh->buffer->data + fh->position, count);
+    fh->position += count;
+  return (int) count;
+}
+
+static int memspack_write(struct mspack_file *file, void *buffer, int bytes) {
+    struct memspack_file *fh = (struct memspack_file *) file;
+    struct memspack_buffer *out;
+    size_t start, end;
+    if (fh == NULL || bytes < 0) return -1;
+    out = fh->buffer;
+    if (out->window) {
+        // copy whatever overlaps the part being kept
+        start = fh->position > out->offset ? fh->position : out->offset;
+        end = fh->position + (size_t) bytes;
+        if (end > out->offset + out->capacity) end = out->offset + out->capacity;
+        if (start < end) memcpy(out->data + (start - out->offset), (unsigned char *) buffer + (start - fh->position), end - start);
+    }
+    else if ((size_t) bytes > out->capacity - fh->position) return -1;
+    else memcpy(out->data + fh->position, buffer, (size_t) bytes);
+    fh->position += (size_t) bytes;
+    if (fh->position > fh->buffer->size) fh->buffer->size = fh->position;
+  return bytes;
+}
+
+static int memspack_seek(struct mspack_file *file, off_t offset, int mode) {
+    // offsets count what more() has dropped, but there's no going back to it
+    struct memspack_file *fh = (struct memspack_file *) file;
+    off_t base, dropped;
+    if (fh == NULL) return -1;
+    dropped = (off_t) fh->dropped;
+    switch (mode) {
+        case MSPACK_SYS_SEEK_START: base = 0; break;
+        case MSPACK_SYS_SEEK_CUR:   base = dropped + (off_t) fh->position; break;
+        case MSPACK_SYS_SEEK_END:   base = dropped + (off_t) fh->buffer->size; break;
+        default: return -1;
+    }
+    if (base + offset < dropped || base + offset > dropped + (off_t) fh->buffer->size) return -1;
+    fh->position = (size_t) (base + offset - dropped);
+  return 0;
+}
+
+static off_t memspack_tell(struct mspack_file *file) {
+    struct memspack_file *fh = (struct memspack_file *) file;
+  return fh ? (off_t) (fh->dropped + fh->position) : 0;
+}
+
+static void memspack_message(struct mspack_file *file, char *format, ...) {
+    va_list ap;
+    (void) file;
+    va_start(ap, format);
+    vfprintf(stderr, format, ap);
+    va_end(ap);
+    fputc('\n', stderr);
+    fflush(stderr);
+  return;
+}
+
+static void *memspack_alloc(struct mspack_system *this, size_t bytes) {
+    (void) this;
+  return malloc(bytes);
+}
+
+static void memspack_free(void *buffer) {
+    free(buffer);
+  return;
+}
+
+static void memspack_copy(void *src, void *dest, size_t bytes) {
+    memcpy(dest, src, bytes);
+  return;
+}
+
+static struct mspack_system memspack_sys = {
+    &memspack_open, &memspack_close, &memspack_read, &memspack_write, &memspack_seek,
+    &memspack_tell, &memspack_message, &memspack_alloc, &memspack_free, &memspack_copy, NULL
+};
+
+struct mspack_system *memspack_system = &memspack_sys;
@@ -0,0 +1,28 @@
+#ifndef _MEMSPACK_H
+#define _MEMSPACK_H
+
+// a libmspack mspack_system whose "files" are buffers in memory, so lzxd can decompress a Xex straight from one
+// buffer into another.  Instead of a filename, open() is passed a pointer to a struct memspack_buffer (cast to
+// char *, the same trick libmspack's multifh example uses)
+
+#include <stddef.h>
+#include "mspack/mspack.h"
+
+struct memspack_buffer {
+    unsigned char *data;
+    size_t size;      // bytes of data (reading), or bytes written so far (writing)
+    size_t capacity;  // writes past this fail, it's never reallocated
+    // if set, a read that has caught up with size empties the buffer and calls this to refill it (up to capacity),
+    // it returns 0 when there isn't going to be any more
+    int (*more)(struct memspack_buffer *buffer);
+    void *morearg;
+    // writing: if window is set, data only keeps the capacity bytes that start offset bytes in and anything else that
+    // gets written is just counted in size, so a big output doesn't need a buffer its size when only part of it matters
+    int window;
+    size_t offset;
+};
+
+// the system to pass to lzxd_init() and friends
+extern struct mspack_system *memspack_system;
+
+#endif /* memspack.h */
@@ -0,0 +1,160 @@
+/*
+ *  prefetch.c - concurrent stealth file downloads for abgx360
+ *
+ *  Every file gets its own easy handle on one multi handle.  The multi handle keeps its connection cache between
+ *  batches, and with CURLPIPE_MULTIPLEX + CURLOPT_PIPEWAIT the transfers to an HTTP/2 server share one connection
+ *  while an HTTP/1.1 server gets up to PREFETCH_MAXCONNECTIONS of them.
+ */
+
+#define _LARGEFILE_SOURCE
+#define _LARGEFILE64_SOURCE
+#define _FILE_OFFSET_BITS 64
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "prefetch.h"
+
+struct prefetch_transfer {
+    struct prefetch_file *file;
+    CURL *easy;
+    FILE *stream;
+    char tmppath[2048+16];
+};
+
+static size_t prefetch_write(void *buffer, size_t size, size_t nmemb, void *data) {
+    struct prefetch_transfer *transfer = (struct prefetch_transfer *) data;
+    if (size == 0 || nmemb == 0) return 0;
+    if (transfer->stream == NULL) {
+        transfer->stream = fopen(transfer->tmppath, "wb");
+        if (transfer->stream == NULL) return 0;
+    }
+  return fwrite(buffer, size, nmemb, transfer->stream);
+}
+
+static void prefetch_finish(struct prefetch_transfer *transfer, CURLcode result) {
+    struct prefetch_file *file = transfer->file;
+    file->curlcode = result;
+    curl_easy_getinfo(transfer->easy, CURLINFO_RESPONSE_CODE, &file->httpcode);
+    if (transfer->stream != NULL) {
+        if (fclose(transfer->stream) != 0 && file->curlcode == CURLE_OK) {
+            file->curlcode = CURLE_WRITE_ERROR;
+            snprintf(file->error, CURL_ERROR_SIZE, "Failed to write %s (%s)", file->name, strerror(errno));
+        }
+        transfer->stream = NULL;
+        if (file->curlcode == CURLE_OK && rename(transfer->tmppath, file->path) != 0) {
+            file->curlcode = CURLE_WRITE_ERROR;
+            snprintf(file->error, CURL_ERROR_SIZE, "Failed to replace %s with the download (%s)", file->name, strerror(errno));
+        }
+        if (file->curlcode != CURLE_OK) remove(transfer->tmppath);
+        else file->result = PREFETCH_DOWNLOADED;
+    }
+    // nothing written means the time condition wasn't met (304) or the server's file is empty, same as my_curl_write()
+    else if (file->curlcode == CURLE_OK) file->result = PREFETCH_NOTMODIFIED;
+    if (file->curlcode != CURLE_OK) file->result = PREFETCH_FAILED;
+  return;
+}
+
+int prefetch_run(struct prefetch *pf, struct prefetch_file *files, int numfiles, const char *useragent,
+                 long connecttimeout, bool verbose) {
+    struct prefetch_transfer *transfers, *transfer;
+    struct stat st;
+    CURLMsg *msg;
+    int i, running = 0, msgsleft, done = 0;
+    if (numfiles <= 0) return 0;
+    if (pf->multi == NULL) {
+        pf->multi = curl_multi_init();
+        if (pf->multi == NULL) return -1;
+        #ifdef CURLPIPE_MULTIPLEX
+            curl_multi_setopt(pf->multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+        #endif
+        curl_multi_setopt(pf->multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long) PREFETCH_MAXCONNECTIONS);
+    }
+    transfers = (struct prefetch_transfer *) calloc(numfiles, sizeof(struct prefetch_transfer));
+    if (transfers == NULL) return -1;
+    for (i=0;i<numfiles;i++) {
+        transfer = &transfers[i];
+        transfer->file = &files[i];
+        files[i].result = PREFETCH_PENDING;
+        files[i].curlcode = CURLE_OK;
+        files[i].httpcode = 0;
+        memset(files[i].error, 0, CURL_ERROR_SIZE);
+        snprintf(transfer->tmppath, sizeof(transfer->tmppath), "%s.prefetch", files[i].path);
+        transfer->easy = curl_easy_init();
+        if (transfer->easy == NULL) {
+            files[i].result = PREFETCH_FAILED;
+            files[i].curlcode = CURLE_FAILED_INIT;
+            snprintf(files[i].error, CURL_ERROR_SIZE, "cURL initialization failed");
+          continue;
+        }
+        if (files[i].compressed) curl_easy_setopt(transfer->easy, CURLOPT_ENCODING, "");
+        curl_easy_setopt(transfer->easy, CURLOPT_USERAGENT, useragent);
+        curl_easy_setopt(transfer->easy, CURLOPT_ERRORBUFFER, files[i].error);
+        curl_easy_setopt(transfer->easy, CURLOPT_FAILONERROR, 1L);
+        curl_easy_setopt(transfer->easy, CURLOPT_FOLLOWLOCATION, 1L);
+        curl_easy_setopt(transfer->easy, CURLOPT_MAXREDIRS, 0L);  // refuse redirects, same as openstealthfile()
+        curl_easy_setopt(transfer->easy, CURLOPT_URL, files[i].url);
+        curl_easy_setopt(transfer->easy, CURLOPT_CONNECTTIMEOUT, connecttimeout);
+        curl_easy_setopt(transfer->easy, CURLOPT_NOPROGRESS, 1L);
+        curl_easy_setopt(transfer->easy, CURLOPT_WRITEFUNCTION, prefetch_write);
+        curl_easy_setopt(transfer->easy, CURLOPT_WRITEDATA, (void *) transfer);
+        curl_easy_setopt(transfer->easy, CURLOPT_PRIVATE, (void *) transfer);
+        // wait for a connection that can be multiplexed rather than opening another one (only HTTP/2 can, and curl only
+        // negotiates it over https, anything else would wait for the previous transfer)
+        if (strncasecmp(files[i].url, "https://", 8) == 0) curl_easy_setopt(transfer->easy, CURLOPT_PIPEWAIT, 1L);
+        if (verbose) curl_easy_setopt(transfer->easy, CURLOPT_VERBOSE, 1L);
+        if (stat(files[i].path, &st) == 0) {
+            curl_easy_setopt(transfer->easy, CURLOPT_TIMECONDITION, (long) CURL_TIMECOND_IFMODSINCE);
+            curl_easy_setopt(transfer->easy, CURLOPT_TIMEVALUE, (long) st.st_mtime);
+        }
+        if (curl_multi_add_handle(pf->multi, transfer->easy) != CURLM_OK) {
+            curl_easy_cleanup(transfer->easy);
+            transfer->easy = NULL;
+            files[i].result = PREFETCH_FAILED;
+            files[i].curlcode = CURLE_FAILED_INIT;
+            snprintf(files[i].error, CURL_ERROR_SIZE, "Failed to add the transfer to the cURL multi handle");
+        }
+    }
+    do {
+        if (curl_multi_perform(pf->multi, &running) != CURLM_OK) break;
+        while ((msg = curl_multi_info_read(pf->multi, &msgsleft)) != NULL) {
+            if (msg->msg != CURLMSG_DONE) continue;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char **) &transfer);
+            prefetch_finish(transfer, msg->data.result);
+            curl_multi_remove_handle(pf->multi, transfer->easy);
+            curl_easy_cleanup(transfer->easy);
+            transfer->easy = NULL;
+        }
+        if (running && curl_multi_wait(pf->multi, NULL, 0, 1000, NULL) != CURLM_OK) break;
+    } while (running);
+    for (i=0;i<numfiles;i++) {
+        transfer = &transfers[i];
+        if (transfer->easy != NULL) {
+            // only left over if the multi handle failed
+            curl_multi_remove_handle(pf->multi, transfer->easy);
+            curl_easy_cleanup(transfer->easy);
+            if (transfer->stream != NULL) {
+                fclose(transfer->stream);
+                remove(transfer->tmppath);
+            }
+            files[i].result = PREFETCH_FAILED;
+            files[i].curlcode = CURLE_FAILED_INIT;
+            snprintf(files[i].error, CURL_ERROR_SIZE, "The cURL multi handle failed");
+        }
+        if (files[i].result == PREFETCH_DOWNLOADED || files[i].result == PREFETCH_NOTMODIFIED) done++;
+    }
+    free(transfers);
+  return done;
+}
+
+void prefetch_cleanup(struct prefetch *pf) {
+    if (pf->multi != NULL) curl_multi_cleanup(pf->multi);
+    pf->multi = NULL;
+  return;
+}
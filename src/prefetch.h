@@ -0,0 +1,43 @@
+#ifndef _PREFETCH_H
+#define _PREFETCH_H
+
+// stealth file prefetch: download a batch of files at the same time with curl_multi (sharing connections, and
+// multiplexing them on servers that speak HTTP/2) instead of waiting for one curl_easy_perform() after another,
+// each file only if the server's copy is newer than the local one
+
+#include <stdbool.h>
+#include <curl/curl.h>
+
+#define PREFETCH_MAXCONNECTIONS 6  // per host, like a browser
+
+// results
+#define PREFETCH_PENDING     0
+#define PREFETCH_DOWNLOADED  1     // the local file was missing or older and has been replaced
+#define PREFETCH_NOTMODIFIED 2     // the server's file is no newer than the local file
+#define PREFETCH_FAILED      3     // curlcode and error say why (CURLE_HTTP_RETURNED_ERROR for a 404 and the like)
+
+struct prefetch_file {
+    char name[32];
+    char url[2048];
+    char path[2048];
+    bool compressed;               // accept gzip/deflate (not worth it for very small files)
+    int result;
+    CURLcode curlcode;
+    long httpcode;
+    char error[CURL_ERROR_SIZE];
+};
+
+struct prefetch {
+    CURLM *multi;                  // created on first use and kept so later batches reuse its connections
+};
+
+// download every file at once, sending If-Modified-Since with the mtime of the local file when there is one
+// (the same freshness check openstealthfile() makes); each download goes to a temp file that replaces path once it's
+// complete, so a failed one never leaves a partial file behind
+// returns the number of files that were downloaded or are up to date, or -1 if curl couldn't be set up
+int prefetch_run(struct prefetch *pf, struct prefetch_file *files, int numfiles, const char *useragent,
+                 long connecttimeout, bool verbose);
+
+void prefetch_cleanup(struct prefetch *pf);
+
+#endif /* prefetch.h */
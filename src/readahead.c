@@ -0,0 +1,491 @@
+/*
+ *  readahead.c - pipelined reader for abgx360
+ *
+ *  Reader threads keep a ring of large buffers filled with positional reads so that disk i/o
+ *  overlaps with the CRC/scan work done by the consumer.  With a queue depth above 1 there are
+ *  that many reads in flight at once, either queued in the kernel with io_uring (one thread
+ *  submitting and reaping) or spread over that many reader threads.  Blocks can complete in any
+ *  order but the consumer always gets them in file order.
+ */
+
+#define _LARGEFILE_SOURCE
+#define _LARGEFILE64_SOURCE
+#define _FILE_OFFSET_BITS 64
+#define _GNU_SOURCE
+
+#ifdef HAVE_CONFIG_H
+    #include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(HAVE_LINUX_IO_URING_H)
+    #define READAHEAD_IOURING
+    #include <stdint.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <linux/io_uring.h>
+#endif
+
+#include "readahead.h"
+
+#define READAHEAD_DIRECTALIGN 4096  // O_DIRECT reads need the offset, length and buffer aligned to this
+
+// read until len bytes have been read, EOF is reached or an error occurs
+// returns the number of bytes read or -1 on error
+static long long preadfull(int fd, unsigned char *buf, size_t len, unsigned long long offset) {
+    size_t done = 0;
+    ssize_t n;
+    while (done < len) {
+        n = pread(fd, buf + done, len - done, (off_t) (offset + done));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+          return -1;
+        }
+        if (n == 0) break;  // EOF
+        done += (size_t) n;
+    }
+  return (long long) done;
+}
+
+static void readahead_initblock(struct readahead_block *block, unsigned long long offset, size_t length) {
+    block->offset = offset;
+    block->length = length;
+    block->status = READAHEAD_OK;
+    block->error = 0;
+    block->retries = 0;
+    block->recovered = 0;
+    block->hole = false;
+  return;
+}
+
+void readahead_readblock(int fd, struct readahead_block *block, unsigned long long offset, size_t length,
+                         size_t unitsize, int retries, struct sparsemap *sparse) {
+    size_t pos, unitlength;
+    long long n;
+    int i;
+    readahead_initblock(block, offset, length);
+    block->hole = (sparse != NULL && sparse_iszero(sparse, offset, length));
+    if (block->hole) return;
+    if (preadfull(fd, block->data, length, offset) == (long long) length) return;
+    // something went wrong, go back over the block one unit at a time so that retries work the same way
+    // they always have (a unit that fails is retried up to retries times, a short read is EOF)
+    for (pos=0;pos<length;pos+=unitlength) {
+        unitlength = length - pos < unitsize ? length - pos : unitsize;
+        n = preadfull(fd, block->data + pos, unitlength, offset + pos);
+        if (n == (long long) unitlength) continue;
+        if (n >= 0) {
+            block->status = READAHEAD_EOF;
+            block->length = pos;
+          return;
+        }
+        for (i=0;i<retries;i++) {
+            block->retries++;
+            if (preadfull(fd, block->data + pos, unitlength, offset + pos) == (long long) unitlength) {
+                block->recovered++;
+              break;
+            }
+            block->error = errno;
+        }
+        if (i == retries) {
+            if (block->error == 0) block->error = errno;
+            block->status = READAHEAD_READERROR;
+            block->length = pos;
+          return;
+        }
+    }
+  return;
+}
+
+// the O_DIRECT descriptor if this read can use it, otherwise the normal one
+static int readahead_readfd(struct readahead *ra, unsigned long long offset, size_t length) {
+    if (ra->directfd >= 0 && offset % READAHEAD_DIRECTALIGN == 0 && length % READAHEAD_DIRECTALIGN == 0) return ra->directfd;
+  return ra->fd;
+}
+
+// read a block that isn't a hole, falling back to buffered reads (with retries) if the first attempt comes up short
+static void readahead_fillblock(struct readahead *ra, struct readahead_block *block, unsigned long long offset, size_t length) {
+    int fd = readahead_readfd(ra, offset, length);
+    if (fd != ra->fd) {
+        readahead_initblock(block, offset, length);
+        if (preadfull(fd, block->data, length, offset) == (long long) length) return;
+    }
+    readahead_readblock(ra->fd, block, offset, length, ra->unitsize, ra->retries, NULL);
+  return;
+}
+
+// take the next free slot in the ring for the next part of the file, call with the lock held
+static struct readahead_block *readahead_claim(struct readahead *ra, unsigned long long *offset, size_t *length, bool *hole) {
+    struct readahead_block *block = &ra->blocks[ra->tail];
+    *offset = ra->offset;
+    *length = ra->end - ra->offset < ra->blocksize ? (size_t) (ra->end - ra->offset) : ra->blocksize;
+    *hole = sparse_iszero(&ra->sparse, *offset, *length);
+    ra->offset += *length;
+    ra->tail = (ra->tail + 1) % ra->numblocks;
+    ra->inuse++;
+    block->ready = false;
+  return block;
+}
+
+// hand a filled block over to the consumer, call with the lock held
+static void readahead_complete(struct readahead *ra, struct readahead_block *block) {
+    block->ready = true;
+    // nothing after a failed block is of any use to the consumer
+    if (block->status != READAHEAD_OK) ra->offset = ra->end;
+    pthread_cond_signal(&ra->notempty);
+  return;
+}
+
+static void *readahead_thread(void *arg) {
+    struct readahead *ra = (struct readahead *) arg;
+    struct readahead_block *block;
+    unsigned long long offset;
+    size_t length;
+    bool hole;
+    for (;;) {
+        pthread_mutex_lock(&ra->lock);
+        while (ra->inuse == ra->numblocks && !ra->stop) pthread_cond_wait(&ra->notfull, &ra->lock);
+        if (ra->stop || ra->offset >= ra->end) {
+            ra->readers--;
+            pthread_cond_signal(&ra->notempty);
+            pthread_mutex_unlock(&ra->lock);
+          break;
+        }
+        block = readahead_claim(ra, &offset, &length, &hole);
+        pthread_mutex_unlock(&ra->lock);
+
+        if (hole) {
+            readahead_initblock(block, offset, length);
+            block->hole = true;
+        }
+        else readahead_fillblock(ra, block, offset, length);
+
+        pthread_mutex_lock(&ra->lock);
+        readahead_complete(ra, block);
+        pthread_mutex_unlock(&ra->lock);
+    }
+  return NULL;
+}
+
+#ifdef READAHEAD_IOURING
+// just enough of io_uring to queue reads, set up with the raw syscalls so there's no liburing dependency
+struct readahead_uring {
+    int fd;
+    unsigned entries;
+    void *sqring, *cqring;
+    size_t sqringsize, cqringsize, sqessize;
+    unsigned *sqhead, *sqtail, *sqmask, *sqarray, *cqhead, *cqtail, *cqmask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    unsigned tosubmit;
+};
+
+static void readahead_uringclose(struct readahead_uring *u) {
+    if (u->sqes != NULL && u->sqes != MAP_FAILED) munmap(u->sqes, u->sqessize);
+    if (u->cqring != NULL && u->cqring != MAP_FAILED) munmap(u->cqring, u->cqringsize);
+    if (u->sqring != NULL && u->sqring != MAP_FAILED) munmap(u->sqring, u->sqringsize);
+    if (u->fd >= 0) close(u->fd);
+    u->fd = -1;
+  return;
+}
+
+// returns 0 on success, 1 if io_uring isn't available (old kernel, or blocked by a seccomp filter)
+static int readahead_uringsetup(struct readahead_uring *u, unsigned entries) {
+    struct io_uring_params p;
+    memset(u, 0, sizeof(struct readahead_uring));
+    memset(&p, 0, sizeof(struct io_uring_params));
+    u->fd = (int) syscall(__NR_io_uring_setup, entries, &p);
+    if (u->fd < 0) return 1;
+    u->entries = p.sq_entries;
+    u->sqringsize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    u->cqringsize = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    u->sqessize = p.sq_entries * sizeof(struct io_uring_sqe);
+    u->sqring = mmap(NULL, u->sqringsize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, u->fd, IORING_OFF_SQ_RING);
+    u->cqring = mmap(NULL, u->cqringsize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, u->fd, IORING_OFF_CQ_RING);
+    u->sqes = (struct io_uring_sqe *) mmap(NULL, u->sqessize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                           u->fd, IORING_OFF_SQES);
+    if (u->sqring == MAP_FAILED || u->cqring == MAP_FAILED || u->sqes == MAP_FAILED) {
+        readahead_uringclose(u);
+      return 1;
+    }
+    u->sqhead  = (unsigned *) ((char *) u->sqring + p.sq_off.head);
+    u->sqtail  = (unsigned *) ((char *) u->sqring + p.sq_off.tail);
+    u->sqmask  = (unsigned *) ((char *) u->sqring + p.sq_off.ring_mask);
+    u->sqarray = (unsigned *) ((char *) u->sqring + p.sq_off.array);
+    u->cqhead  = (unsigned *) ((char *) u->cqring + p.cq_off.head);
+    u->cqtail  = (unsigned *) ((char *) u->cqring + p.cq_off.tail);
+    u->cqmask  = (unsigned *) ((char *) u->cqring + p.cq_off.ring_mask);
+    u->cqes    = (struct io_uring_cqe *) ((char *) u->cqring + p.cq_off.cqes);
+  return 0;
+}
+
+static void readahead_uringqueue(struct readahead_uring *u, int fd, unsigned char *buf, size_t length,
+                                 unsigned long long offset, int slot) {
+    unsigned tail = *u->sqtail;
+    unsigned index = tail & *u->sqmask;
+    struct io_uring_sqe *sqe = &u->sqes[index];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = (unsigned long long) (uintptr_t) buf;
+    sqe->len = (unsigned) length;
+    sqe->off = offset;
+    sqe->user_data = (unsigned long long) slot;
+    u->sqarray[index] = index;
+    __atomic_store_n(u->sqtail, tail + 1, __ATOMIC_RELEASE);
+    u->tosubmit++;
+  return;
+}
+
+// submit everything queued and wait for at least one completion, returns 0 or -1 with errno set
+static int readahead_uringenter(struct readahead_uring *u) {
+    long n;
+    for (;;) {
+        n = syscall(__NR_io_uring_enter, u->fd, u->tosubmit, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (n >= 0) {
+            u->tosubmit -= (unsigned) n;
+          return 0;
+        }
+        if (errno != EINTR && errno != EAGAIN && errno != EBUSY) return -1;
+    }
+}
+
+// read every claimed block that hasn't completed yet with the buffered reader
+static void readahead_uringdrain(struct readahead *ra) {
+    struct readahead_block *pending[READAHEAD_MAXQUEUEDEPTH * 2];
+    int i, slot, numpending = 0;
+    pthread_mutex_lock(&ra->lock);
+    for (i=0;i<ra->inuse;i++) {
+        slot = (ra->head + i) % ra->numblocks;
+        if (!ra->blocks[slot].ready) pending[numpending++] = &ra->blocks[slot];
+    }
+    pthread_mutex_unlock(&ra->lock);
+    for (i=0;i<numpending;i++) {
+        readahead_readblock(ra->fd, pending[i], pending[i]->offset, pending[i]->length, ra->unitsize, ra->retries, NULL);
+        pthread_mutex_lock(&ra->lock);
+        readahead_complete(ra, pending[i]);
+        pthread_mutex_unlock(&ra->lock);
+    }
+  return;
+}
+
+static void *readahead_uringthread(void *arg) {
+    struct readahead *ra = (struct readahead *) arg;
+    struct readahead_uring *u = (struct readahead_uring *) ra->uring;
+    struct readahead_block *block;
+    struct io_uring_cqe *cqe;
+    unsigned long long offset;
+    size_t length;
+    unsigned head;
+    int inflight = 0;
+    bool hole;
+    for (;;) {
+        pthread_mutex_lock(&ra->lock);
+        // queue reads into every free slot, up to the queue depth
+        while (!ra->stop && ra->offset < ra->end && ra->inuse < ra->numblocks && inflight < ra->queuedepth) {
+            block = readahead_claim(ra, &offset, &length, &hole);
+            if (hole) {
+                readahead_initblock(block, offset, length);
+                block->hole = true;
+                readahead_complete(ra, block);
+              continue;
+            }
+            readahead_initblock(block, offset, length);
+            readahead_uringqueue(u, readahead_readfd(ra, offset, length), block->data, length, offset, (int) (block - ra->blocks));
+            inflight++;
+        }
+        if (inflight == 0) {
+            if (ra->stop || ra->offset >= ra->end) {
+                ra->readers--;
+                pthread_cond_signal(&ra->notempty);
+                pthread_mutex_unlock(&ra->lock);
+              break;
+            }
+            // every slot is full of blocks the consumer hasn't released yet
+            pthread_cond_wait(&ra->notfull, &ra->lock);
+            pthread_mutex_unlock(&ra->lock);
+          continue;
+        }
+        pthread_mutex_unlock(&ra->lock);
+
+        if (readahead_uringenter(u) != 0) {
+            // the ring is unusable, so read everything that's still outstanding synchronously (if the kernel did take
+            // some of those reads it only writes the same data into the same buffers) and then carry on with the rest
+            // of the range as an ordinary reader thread, which also takes care of counting this reader as finished
+            readahead_uringdrain(ra);
+          return readahead_thread(arg);
+        }
+        // reap completions (in whatever order they finished, the consumer still takes them in file order)
+        head = *u->cqhead;
+        while (head != __atomic_load_n(u->cqtail, __ATOMIC_ACQUIRE)) {
+            cqe = &u->cqes[head & *u->cqmask];
+            block = &ra->blocks[(int) cqe->user_data];
+            // short reads and errors go through the buffered reader so EOF and retries are handled as usual
+            if (cqe->res != (int) block->length)
+                readahead_readblock(ra->fd, block, block->offset, block->length, ra->unitsize, ra->retries, NULL);
+            head++;
+            inflight--;
+            pthread_mutex_lock(&ra->lock);
+            readahead_complete(ra, block);
+            pthread_mutex_unlock(&ra->lock);
+        }
+        __atomic_store_n(u->cqhead, head, __ATOMIC_RELEASE);
+    }
+  return NULL;
+}
+#endif
+
+int readahead_start(struct readahead *ra, int fd, unsigned long long offset, unsigned long long length,
+                    size_t unitsize, int retries, const struct readahead_settings *settings) {
+    int i;
+    char path[64];
+    bool iouring = settings != NULL && settings->iouring, direct = settings != NULL && settings->direct;
+    memset(ra, 0, sizeof(struct readahead));
+    ra->fd = fd;
+    ra->directfd = -1;
+    ra->offset = offset;
+    ra->end = offset + length;
+    ra->blocksize = READAHEAD_BLOCKSIZE;
+    ra->unitsize = unitsize;
+    ra->queuedepth = settings != NULL ? settings->queuedepth : 1;
+    if (ra->queuedepth < 1) ra->queuedepth = 1;
+    if (ra->queuedepth > READAHEAD_MAXQUEUEDEPTH) ra->queuedepth = READAHEAD_MAXQUEUEDEPTH;
+    // enough slots for a full queue of reads plus the ones the consumer is working through
+    ra->numblocks = ra->queuedepth * 2 > READAHEAD_NUMBLOCKS ? ra->queuedepth * 2 : READAHEAD_NUMBLOCKS;
+    ra->retries = retries;
+    ra->backend = "thread";
+    sparse_init(&ra->sparse, fd);
+    #ifdef O_DIRECT
+        if (direct) {
+            // bypass the page cache for the big aligned reads, the descriptor we were given is still used for everything else
+            sprintf(path, "/proc/self/fd/%d", fd);
+            ra->directfd = open(path, O_RDONLY | O_DIRECT);
+        }
+    #else
+        (void) path; (void) direct;
+    #endif
+    ra->blocks = (struct readahead_block *) calloc(ra->numblocks, sizeof(struct readahead_block));
+    if (ra->blocks == NULL) {
+        readahead_stop(ra);
+      return 1;
+    }
+    for (i=0;i<ra->numblocks;i++) {
+        if (posix_memalign((void **) &ra->blocks[i].data, READAHEAD_DIRECTALIGN, ra->blocksize) != 0) {
+            ra->blocks[i].data = NULL;
+            readahead_stop(ra);
+          return 1;
+        }
+    }
+    pthread_mutex_init(&ra->lock, NULL);
+    pthread_cond_init(&ra->notempty, NULL);
+    pthread_cond_init(&ra->notfull, NULL);
+    #ifdef READAHEAD_IOURING
+        if (iouring) {
+            ra->uring = malloc(sizeof(struct readahead_uring));
+            if (ra->uring != NULL && readahead_uringsetup((struct readahead_uring *) ra->uring, (unsigned) ra->queuedepth) == 0) {
+                ra->readers = 1;
+                if (pthread_create(&ra->threads[0], NULL, readahead_uringthread, ra) == 0) {
+                    ra->numthreads = 1;
+                    ra->backend = "io_uring";
+                }
+                else {
+                    ra->readers = 0;
+                    readahead_uringclose((struct readahead_uring *) ra->uring);
+                }
+            }
+            if (ra->numthreads == 0) {
+                free(ra->uring);
+                ra->uring = NULL;
+            }
+        }
+    #else
+        (void) iouring;
+    #endif
+    // no io_uring: one reader thread per read in flight
+    if (ra->numthreads == 0) {
+        ra->readers = ra->queuedepth;
+        for (i=0;i<ra->queuedepth;i++) {
+            if (pthread_create(&ra->threads[i], NULL, readahead_thread, ra) != 0) break;
+            ra->numthreads++;
+        }
+        if (ra->numthreads == 0) {
+            pthread_mutex_destroy(&ra->lock);
+            pthread_cond_destroy(&ra->notempty);
+            pthread_cond_destroy(&ra->notfull);
+            readahead_stop(ra);
+          return 1;
+        }
+        if (ra->numthreads < ra->queuedepth) {
+            // make do with the threads we got
+            pthread_mutex_lock(&ra->lock);
+            ra->readers -= ra->queuedepth - ra->numthreads;
+            pthread_mutex_unlock(&ra->lock);
+        }
+    }
+    ra->started = true;
+  return 0;
+}
+
+const char *readahead_backend(const struct readahead *ra) {
+  return ra->backend;
+}
+
+struct readahead_block *readahead_next(struct readahead *ra) {
+    struct readahead_block *block = NULL;
+    pthread_mutex_lock(&ra->lock);
+    while ((ra->inuse == 0 && ra->readers > 0) || (ra->inuse > 0 && !ra->blocks[ra->head].ready))
+        pthread_cond_wait(&ra->notempty, &ra->lock);
+    if (ra->inuse) block = &ra->blocks[ra->head];
+    pthread_mutex_unlock(&ra->lock);
+  return block;
+}
+
+void readahead_release(struct readahead *ra) {
+    pthread_mutex_lock(&ra->lock);
+    if (ra->inuse) {
+        ra->blocks[ra->head].ready = false;
+        ra->head = (ra->head + 1) % ra->numblocks;
+        ra->inuse--;
+        pthread_cond_broadcast(&ra->notfull);
+    }
+    pthread_mutex_unlock(&ra->lock);
+  return;
+}
+
+void readahead_stop(struct readahead *ra) {
+    int i;
+    if (ra->started) {
+        pthread_mutex_lock(&ra->lock);
+        ra->stop = true;
+        pthread_cond_broadcast(&ra->notfull);
+        pthread_mutex_unlock(&ra->lock);
+        for (i=0;i<ra->numthreads;i++) pthread_join(ra->threads[i], NULL);
+        pthread_mutex_destroy(&ra->lock);
+        pthread_cond_destroy(&ra->notempty);
+        pthread_cond_destroy(&ra->notfull);
+        ra->started = false;
+    }
+    #ifdef READAHEAD_IOURING
+        if (ra->uring != NULL) {
+            readahead_uringclose((struct readahead_uring *) ra->uring);
+            free(ra->uring);
+            ra->uring = NULL;
+        }
+    #endif
+    if (ra->blocks != NULL) {
+        for (i=0;i<ra->numblocks;i++) free(ra->blocks[i].data);
+        free(ra->blocks);
+        ra->blocks = NULL;
+    }
+    if (ra->directfd >= 0) {
+        close(ra->directfd);
+        ra->directfd = -1;
+    }
+  return;
+}
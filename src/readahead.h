@@ -0,0 +1,84 @@
+#ifndef _READAHEAD_H
+#define _READAHEAD_H
+
+// pipelined reader: reader threads (or io_uring) fill a ring of large buffers from a file descriptor
+// while the calling thread consumes them in order (used for the long sequential scans)
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "sparse.h"
+
+#define READAHEAD_BLOCKSIZE 2097152  // 2 MB, must be an even multiple of the unit size passed to readahead_start()
+#define READAHEAD_NUMBLOCKS 8
+#define READAHEAD_MAXQUEUEDEPTH 64
+
+// block status
+#define READAHEAD_OK        0
+#define READAHEAD_EOF       1
+#define READAHEAD_READERROR 2
+
+struct readahead_block {
+    unsigned char *data;
+    unsigned long long offset;   // file offset of data[0]
+    size_t length;               // number of valid bytes (up to the failing unit if status != READAHEAD_OK)
+    int status;
+    int error;                   // errno for READAHEAD_READERROR
+    unsigned long retries;       // read retries needed while filling this block
+    unsigned long recovered;     // units that were recovered after retrying
+    bool hole;                   // the whole block is a filesystem hole, data wasn't read (it's all zeroes)
+    bool ready;                  // filled and waiting for the consumer
+};
+
+// how a reader reads: queuedepth reads are kept in flight (1 is a single reader thread), with io_uring if iouring is
+// true and the kernel allows it or on that many threads otherwise, and if direct is true the aligned reads bypass the
+// page cache with O_DIRECT (meant for block devices)
+struct readahead_settings {
+    int queuedepth;
+    bool iouring, direct;
+};
+
+struct readahead {
+    int fd;
+    int directfd;                // O_DIRECT descriptor for the same file, or -1
+    unsigned long long offset, end;
+    size_t blocksize, unitsize;
+    int numblocks, retries, queuedepth;
+    struct readahead_block *blocks;
+    int head, tail, inuse;       // inuse counts blocks being read plus blocks waiting for (or held by) the consumer
+    int readers;                 // reader threads that haven't finished yet
+    bool stop, started;
+    int numthreads;
+    pthread_t threads[READAHEAD_MAXQUEUEDEPTH];
+    void *uring;                 // io_uring state when that's what is doing the reading
+    const char *backend;
+    pthread_mutex_t lock;
+    pthread_cond_t notempty, notfull;
+    struct sparsemap sparse;
+};
+
+// start reading length bytes from fd at offset; read errors are retried unitsize bytes at a time (up to retries times)
+// settings can be NULL for a single buffered reader thread
+// returns 0 on success, 1 if memory allocation or thread creation failed
+int readahead_start(struct readahead *ra, int fd, unsigned long long offset, unsigned long long length,
+                    size_t unitsize, int retries, const struct readahead_settings *settings);
+
+// "io_uring" or "thread", for debug output
+const char *readahead_backend(const struct readahead *ra);
+
+// wait for the next block in file order (check block->hole before using its data); returns NULL after the last block
+struct readahead_block *readahead_next(struct readahead *ra);
+
+// hand the block returned by readahead_next() back to the reader thread
+void readahead_release(struct readahead *ra);
+
+// stop the reader thread (if it's still running) and free the ring
+void readahead_stop(struct readahead *ra);
+
+// fill block->data with length bytes from fd at offset, retrying failed units the same way the reader thread does
+// if sparse isn't NULL and the whole block is a hole, block->hole is set instead of reading it
+void readahead_readblock(int fd, struct readahead_block *block, unsigned long long offset, size_t length,
+                         size_t unitsize, int retries, struct sparsemap *sparse);
+
+#endif /* readahead.h */
@@ -0,0 +1,128 @@
+/*
+ *  resultcache.c - per-image result cache for abgx360
+ *
+ *  Each cache file is a few lines of text: a header, the key it was saved for (device, inode, size,
+ *  mtime in nanoseconds and a crc of the stealth sectors), the stealth/xex crcs, one line per range
+ *  that was read and one line per corruption offset.  Anything that doesn't parse or doesn't match
+ *  the key is a miss.
+ */
+
+#define _LARGEFILE_SOURCE
+#define _LARGEFILE64_SOURCE
+#define _FILE_OFFSET_BITS 64
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "resultcache.h"
+
+#define RESULTCACHE_HEADER "abgx360 result cache 1"
+
+int resultcache_getkey(int fd, struct resultcache_key *key) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) return -1;
+    if (!S_ISREG(st.st_mode)) {
+        // a disc in a drive can be swapped without anything here changing
+        errno = EINVAL;
+      return -1;
+    }
+    key->dev = (unsigned long long) st.st_dev;
+    key->ino = (unsigned long long) st.st_ino;
+    key->size = (unsigned long long) st.st_size;
+    key->mtime_sec = (long long) st.st_mtime;
+    #if defined(__APPLE__)
+        key->mtime_nsec = (long) st.st_mtimespec.tv_nsec;
+    #else
+        key->mtime_nsec = (long) st.st_mtim.tv_nsec;
+    #endif
+  return 0;
+}
+
+bool resultcache_samefile(const struct resultcache_key *a, const struct resultcache_key *b) {
+  return a->dev == b->dev && a->ino == b->ino && a->size == b->size &&
+         a->mtime_sec == b->mtime_sec && a->mtime_nsec == b->mtime_nsec;
+}
+
+void resultcache_filename(char *dest, size_t size, const char *dir, const struct resultcache_key *key) {
+    snprintf(dest, size, "%s%llX-%llX.txt", dir, key->dev, key->ino);
+  return;
+}
+
+int resultcache_load(const char *filename, const struct resultcache_key *key, struct resultcache_entry *entry) {
+    FILE *stream;
+    char line[256];
+    struct resultcache_key saved;
+    struct resultcache_range range;
+    int index, founddata, matched = 0;
+    memset(entry, 0, sizeof(struct resultcache_entry));
+    entry->key = *key;
+    stream = fopen(filename, "r");
+    if (stream == NULL) return 1;
+    if (fgets(line, sizeof(line), stream) == NULL || strncmp(line, RESULTCACHE_HEADER, strlen(RESULTCACHE_HEADER)) != 0) goto miss;
+    while (fgets(line, sizeof(line), stream) != NULL) {
+        if (sscanf(line, "key %llu %llu %llu %lld %ld %lX", &saved.dev, &saved.ino, &saved.size,
+                   &saved.mtime_sec, &saved.mtime_nsec, &saved.stealthcrc) == 6) {
+            if (!resultcache_samefile(&saved, key) || saved.stealthcrc != key->stealthcrc) goto miss;
+            matched = 1;
+        }
+        else if (!matched) goto miss;  // the key has to come first
+        else if (sscanf(line, "crcs %lX %lX %lX %lX", &entry->ss_crc32, &entry->dmi_crc32, &entry->pfi_crc32, &entry->xex_crc32) == 4) continue;
+        else if (sscanf(line, "range %d %llu %llu %lX %d %llu", &index, &range.start, &range.end, &range.crc,
+                        &founddata, &range.firstdata) == 6) {
+            if (index < 0 || index >= RESULTCACHE_NUMRANGES || range.end < range.start) goto miss;
+            range.valid = true;
+            range.founddata = founddata != 0;
+            entry->ranges[index] = range;
+        }
+        else if (sscanf(line, "corruption %llu", &entry->corruptionoffset[entry->corruptionoffsetcount]) == 1) {
+            if (++entry->corruptionoffsetcount == RESULTCACHE_MAXCORRUPTIONOFFSETS) break;
+        }
+        else goto miss;
+    }
+    fclose(stream);
+    if (matched) return 0;
+    memset(entry, 0, sizeof(struct resultcache_entry));
+    entry->key = *key;
+  return 1;
+
+    miss:
+    fclose(stream);
+    memset(entry, 0, sizeof(struct resultcache_entry));
+    entry->key = *key;
+  return 1;
+}
+
+int resultcache_save(const char *filename, const struct resultcache_entry *entry) {
+    FILE *stream;
+    char tmpfilename[2048];
+    int i, error = 0;
+    // the pid keeps parallel jobs (--jobs) from writing the same temp file
+    snprintf(tmpfilename, sizeof(tmpfilename), "%s.%ld", filename, (long) getpid());
+    stream = fopen(tmpfilename, "w");
+    if (stream == NULL) return -1;
+    fprintf(stream, "%s\n", RESULTCACHE_HEADER);
+    fprintf(stream, "key %llu %llu %llu %lld %ld %08lX\n", entry->key.dev, entry->key.ino, entry->key.size,
+            entry->key.mtime_sec, entry->key.mtime_nsec, entry->key.stealthcrc);
+    fprintf(stream, "crcs %08lX %08lX %08lX %08lX\n", entry->ss_crc32, entry->dmi_crc32, entry->pfi_crc32, entry->xex_crc32);
+    for (i=0;i<RESULTCACHE_NUMRANGES;i++) {
+        if (!entry->ranges[i].valid) continue;
+        fprintf(stream, "range %d %llu %llu %08lX %d %llu\n", i, entry->ranges[i].start, entry->ranges[i].end,
+                entry->ranges[i].crc, entry->ranges[i].founddata ? 1 : 0, entry->ranges[i].firstdata);
+    }
+    for (i=0;i<entry->corruptionoffsetcount && i<RESULTCACHE_MAXCORRUPTIONOFFSETS;i++)
+        fprintf(stream, "corruption %llu\n", entry->corruptionoffset[i]);
+    if (ferror(stream)) error = errno ? errno : EIO;
+    if (fclose(stream) != 0 && !error) error = errno;
+    if (!error && rename(tmpfilename, filename) != 0) error = errno;
+    if (error) {
+        remove(tmpfilename);
+        errno = error;
+      return -1;
+    }
+  return 0;
+}
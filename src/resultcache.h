@@ -0,0 +1,58 @@
+#ifndef _RESULTCACHE_H
+#define _RESULTCACHE_H
+
+// results of the whole-image reads (Video and Game CRCs, padding checks and corruption offsets) saved in one small
+// file per image and keyed by the image's identity, so rechecking an image that hasn't changed doesn't read it again
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#define RESULTCACHE_VIDEOL0   0
+#define RESULTCACHE_VIDEOL1   1
+#define RESULTCACHE_PADDINGL0 2
+#define RESULTCACHE_PADDINGL1 3
+#define RESULTCACHE_GAME      4
+#define RESULTCACHE_NUMRANGES 5
+
+#define RESULTCACHE_MAXCORRUPTIONOFFSETS 100
+
+struct resultcache_key {
+    unsigned long long dev, ino, size;
+    long long mtime_sec;
+    long mtime_nsec;
+    unsigned long stealthcrc;  // crc32 of the stealth sectors, filled in by the caller
+};
+
+// one range of the image that was read and what was found in it
+struct resultcache_range {
+    bool valid;
+    unsigned long long start, end;
+    unsigned long crc;
+    bool founddata;                // padding ranges: data was found at firstdata
+    unsigned long long firstdata;
+};
+
+struct resultcache_entry {
+    struct resultcache_key key;
+    struct resultcache_range ranges[RESULTCACHE_NUMRANGES];
+    unsigned long ss_crc32, dmi_crc32, pfi_crc32, xex_crc32;
+    int corruptionoffsetcount;
+    unsigned long long corruptionoffset[RESULTCACHE_MAXCORRUPTIONOFFSETS];
+};
+
+// fill in everything but stealthcrc from fstat(fd), returns -1 (errno set) if that fails or fd isn't a regular file
+int resultcache_getkey(int fd, struct resultcache_key *key);
+
+// true if a and b are the same file with the same size and mtime (stealthcrc isn't compared)
+bool resultcache_samefile(const struct resultcache_key *a, const struct resultcache_key *b);
+
+// name of the cache file for key inside dir (which needs to end with a directory separator)
+void resultcache_filename(char *dest, size_t size, const char *dir, const struct resultcache_key *key);
+
+// returns 0 if filename was saved for exactly this key, otherwise 1 and entry is cleared except for the key
+int resultcache_load(const char *filename, const struct resultcache_key *key, struct resultcache_entry *entry);
+
+// write entry to filename through a temp file and rename() so nobody ever reads half of one, returns 0 or -1 (errno set)
+int resultcache_save(const char *filename, const struct resultcache_entry *entry);
+
+#endif /* resultcache.h */
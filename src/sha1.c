@@ -31,6 +31,7 @@
 #include <stdio.h>
 
 #include "sha1.h"
+#include "sha1fast.h"
 
 /* 
  * 32-bit integer manipulation macros (big endian)
@@ -250,6 +251,12 @@ void sha1_update( sha1_context *ctx, uchar *input, uint length )
         left = 0;
     }
 
+    if( length >= 64 && sha1fast_blocks( ctx->state, input, length / 64 ) )
+    {
+        input  += length & ~63;
+        length &= 63;
+    }
+
     while( length >= 64 )
     {
         sha1_process( ctx, input );
@@ -0,0 +1,307 @@
+/*
+ *  sha1fast.c - SHA-1 with runtime cpu dispatch for abgx360
+ *
+ *  The x86 kernel is the usual SHA-NI sequence: SHA1RNDS4 does four rounds, SHA1NEXTE works the next E into the
+ *  message words, and SHA1MSG1/SHA1MSG2 expand the message schedule four words at a time a few steps ahead of the
+ *  rounds that need them.  The ARMv8 kernel does the same with SHA1C/SHA1P/SHA1M, SHA1H and SHA1SU0/SHA1SU1.
+ *  Without either, sha1fast_multi() runs up to SHA1FAST_LANES messages side by side with GCC vector extensions
+ *  (SSE2 on x86, NEON on ARM), one message per lane, refilling a lane with the next message as soon as it's done.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define SHA1FAST_X86
+    #include <cpuid.h>
+    #include <immintrin.h>
+#endif
+#if defined(__GNUC__) && defined(__aarch64__) && defined(__linux__)
+    #define SHA1FAST_ARMV8
+    #include <sys/auxv.h>
+    #include <asm/hwcap.h>
+    #include <arm_neon.h>
+    #ifdef __clang__
+        #define SHA1FAST_ARMV8_TARGET __attribute__((target("sha2")))
+    #else
+        #define SHA1FAST_ARMV8_TARGET __attribute__((target("+crypto")))
+    #endif
+#endif
+
+// after the system headers, it #defines uint and ulong
+#include "sha1.h"
+#include "sha1fast.h"
+
+#define SHA1FAST_PORTABLE 0
+#define SHA1FAST_SHANI    1
+#define SHA1FAST_ARMV8_SHA1 2
+
+static int sha1fast_impl = -1;
+
+#ifdef SHA1FAST_X86
+// rounds 4i..4i+3 for i >= 1: ea takes the next E and the message words for these rounds, eb saves abcd for the
+// next step, and the schedule for the steps ahead is worked on (the compiler drops what the last steps don't need)
+#define SHA1FAST_SHANI_STEP(ea, eb, m0, m1, m2, m3, f) \
+    ea = _mm_sha1nexte_epu32(ea, m0); \
+    eb = abcd; \
+    m1 = _mm_sha1msg2_epu32(m1, m0); \
+    abcd = _mm_sha1rnds4_epu32(abcd, ea, f); \
+    m3 = _mm_sha1msg1_epu32(m3, m0); \
+    m2 = _mm_xor_si128(m2, m0);
+
+__attribute__((target("sha,sse4.1,ssse3")))
+static void sha1fast_shani(uint32_t state[5], const unsigned char *data, size_t numblocks) {
+    const __m128i mask = _mm_set_epi64x(0x0001020304050607LL, 0x08090a0b0c0d0e0fLL);
+    __m128i abcd, abcdsave, e0, e0save, e1, msg0, msg1, msg2, msg3;
+    abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) state), 0x1B);
+    e0 = _mm_set_epi32((int) state[4], 0, 0, 0);
+    while (numblocks--) {
+        abcdsave = abcd;
+        e0save = e0;
+        msg0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + 0)), mask);
+        msg1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + 16)), mask);
+        msg2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + 32)), mask);
+        msg3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + 48)), mask);
+        // rounds 0-15, before the schedule has anything to expand
+        e0 = _mm_add_epi32(e0, msg0);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+        e1 = _mm_sha1nexte_epu32(e1, msg1);
+        e0 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+        msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+        e0 = _mm_sha1nexte_epu32(e0, msg2);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+        msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+        msg0 = _mm_xor_si128(msg0, msg2);
+        SHA1FAST_SHANI_STEP(e1, e0, msg3, msg0, msg1, msg2, 0)
+        // rounds 16-79
+        SHA1FAST_SHANI_STEP(e0, e1, msg0, msg1, msg2, msg3, 0)
+        SHA1FAST_SHANI_STEP(e1, e0, msg1, msg2, msg3, msg0, 1)
+        SHA1FAST_SHANI_STEP(e0, e1, msg2, msg3, msg0, msg1, 1)
+        SHA1FAST_SHANI_STEP(e1, e0, msg3, msg0, msg1, msg2, 1)
+        SHA1FAST_SHANI_STEP(e0, e1, msg0, msg1, msg2, msg3, 1)
+        SHA1FAST_SHANI_STEP(e1, e0, msg1, msg2, msg3, msg0, 1)
+        SHA1FAST_SHANI_STEP(e0, e1, msg2, msg3, msg0, msg1, 2)
+        SHA1FAST_SHANI_STEP(e1, e0, msg3, msg0, msg1, msg2, 2)
+        SHA1FAST_SHANI_STEP(e0, e1, msg0, msg1, msg2, msg3, 2)
+        SHA1FAST_SHANI_STEP(e1, e0, msg1, msg2, msg3, msg0, 2)
+        SHA1FAST_SHANI_STEP(e0, e1, msg2, msg3, msg0, msg1, 2)
+        SHA1FAST_SHANI_STEP(e1, e0, msg3, msg0, msg1, msg2, 3)
+        SHA1FAST_SHANI_STEP(e0, e1, msg0, msg1, msg2, msg3, 3)
+        SHA1FAST_SHANI_STEP(e1, e0, msg1, msg2, msg3, msg0, 3)
+        SHA1FAST_SHANI_STEP(e0, e1, msg2, msg3, msg0, msg1, 3)
+        SHA1FAST_SHANI_STEP(e1, e0, msg3, msg0, msg1, msg2, 3)
+        e0 = _mm_sha1nexte_epu32(e0, e0save);
+        abcd = _mm_add_epi32(abcd, abcdsave);
+        data += 64;
+    }
+    _mm_storeu_si128((__m128i *) state, _mm_shuffle_epi32(abcd, 0x1B));
+    state[4] = (uint32_t) _mm_extract_epi32(e0, 3);
+  return;
+}
+#endif
+
+#ifdef SHA1FAST_ARMV8
+SHA1FAST_ARMV8_TARGET
+static void sha1fast_armv8(uint32_t state[5], const unsigned char *data, size_t numblocks) {
+    static const uint32_t k[4] = {0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xCA62C1D6};
+    uint32x4_t abcd, abcdsave, w[20], wk;
+    uint32_t e, esave, enext;
+    int g;
+    abcd = vld1q_u32(state);
+    e = state[4];
+    while (numblocks--) {
+        abcdsave = abcd;
+        esave = e;
+        for (g=0;g<4;g++) w[g] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + g*16)));
+        for (g=4;g<20;g++) w[g] = vsha1su1q_u32(vsha1su0q_u32(w[g-4], w[g-3], w[g-2]), w[g-1]);
+        for (g=0;g<20;g++) {
+            wk = vaddq_u32(w[g], vdupq_n_u32(k[g/5]));
+            enext = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+            if (g < 5) abcd = vsha1cq_u32(abcd, e, wk);
+            else if (g >= 10 && g < 15) abcd = vsha1mq_u32(abcd, e, wk);
+            else abcd = vsha1pq_u32(abcd, e, wk);
+            e = enext;
+        }
+        abcd = vaddq_u32(abcd, abcdsave);
+        e += esave;
+        data += 64;
+    }
+    vst1q_u32(state, abcd);
+    state[4] = e;
+  return;
+}
+#endif
+
+void sha1fast_init(void) {
+    sha1fast_impl = SHA1FAST_PORTABLE;
+    #ifdef SHA1FAST_X86
+    {
+        unsigned int eax, ebx, ecx, edx;
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_SSE4_1) && (ecx & bit_SSSE3) &&
+            __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & bit_SHA))
+            sha1fast_impl = SHA1FAST_SHANI;
+    }
+    #endif
+    #ifdef SHA1FAST_ARMV8
+        if (getauxval(AT_HWCAP) & HWCAP_SHA1) sha1fast_impl = SHA1FAST_ARMV8_SHA1;
+    #endif
+  return;
+}
+
+int sha1fast_blocks(unsigned long state[5], const unsigned char *data, size_t numblocks) {
+    #if defined(SHA1FAST_X86) || defined(SHA1FAST_ARMV8)
+        uint32_t s[5];
+        int i;
+    #endif
+    if (sha1fast_impl < 0) sha1fast_init();
+    if (sha1fast_impl == SHA1FAST_PORTABLE) return 0;
+    #if defined(SHA1FAST_X86) || defined(SHA1FAST_ARMV8)
+        for (i=0;i<5;i++) s[i] = (uint32_t) state[i];
+        #ifdef SHA1FAST_X86
+            if (sha1fast_impl == SHA1FAST_SHANI) sha1fast_shani(s, data, numblocks);
+        #endif
+        #ifdef SHA1FAST_ARMV8
+            if (sha1fast_impl == SHA1FAST_ARMV8_SHA1) sha1fast_armv8(s, data, numblocks);
+        #endif
+        for (i=0;i<5;i++) state[i] = (unsigned long) s[i];
+      return 1;
+    #else
+        (void) state; (void) data; (void) numblocks;
+      return 0;
+    #endif
+}
+
+// one 32 bit word from every lane
+typedef uint32_t sha1fast_vec __attribute__((vector_size(4 * SHA1FAST_LANES)));
+
+#define SHA1FAST_ROL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+// run one block through each lane's state (lane l's state words are state[0..4][l])
+static void sha1fast_lanes(sha1fast_vec state[5], const unsigned char *const block[SHA1FAST_LANES]) {
+    sha1fast_vec w[16], a, b, c, d, e, f, temp;
+    uint32_t k;
+    int t, l;
+    for (t=0;t<16;t++) for (l=0;l<SHA1FAST_LANES;l++)
+        w[t][l] = (uint32_t) block[l][t*4] << 24 | (uint32_t) block[l][t*4+1] << 16 |
+                  (uint32_t) block[l][t*4+2] << 8 | (uint32_t) block[l][t*4+3];
+    a = state[0]; b = state[1]; c = state[2]; d = state[3]; e = state[4];
+    for (t=0;t<80;t++) {
+        if (t >= 16) {
+            temp = w[(t-3)&15] ^ w[(t-8)&15] ^ w[(t-14)&15] ^ w[t&15];
+            w[t&15] = SHA1FAST_ROL(temp, 1);
+        }
+        if (t < 20)      { f = d ^ (b & (c ^ d));       k = 0x5A827999; }
+        else if (t < 40) { f = b ^ c ^ d;               k = 0x6ED9EBA1; }
+        else if (t < 60) { f = (b & c) | (d & (b | c)); k = 0x8F1BBCDC; }
+        else             { f = b ^ c ^ d;               k = 0xCA62C1D6; }
+        temp = SHA1FAST_ROL(a, 5) + f + e + k + w[t&15];
+        e = d;
+        d = c;
+        c = SHA1FAST_ROL(b, 30);
+        b = a;
+        a = temp;
+    }
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d; state[4] += e;
+  return;
+}
+
+struct sha1fast_lane {
+    size_t message;             // index of the message in this lane
+    const unsigned char *data;  // its next whole block
+    size_t numblocks;           // whole blocks left
+    unsigned char tail[128];    // the leftover bytes and padding, one or two blocks
+    int tailblocks, tailblock;
+};
+
+static void sha1fast_startlane(struct sha1fast_lane *lane, sha1fast_vec state[5], int l,
+                               const unsigned char *data, size_t len, size_t message) {
+    static const uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    unsigned long long bits = (unsigned long long) len * 8;
+    size_t left = len & 63;
+    int i;
+    lane->message = message;
+    lane->data = data;
+    lane->numblocks = len / 64;
+    lane->tailblocks = left < 56 ? 1 : 2;
+    lane->tailblock = 0;
+    memset(lane->tail, 0, sizeof(lane->tail));
+    if (left) memcpy(lane->tail, data + len - left, left);
+    lane->tail[left] = 0x80;
+    for (i=0;i<8;i++) lane->tail[lane->tailblocks*64 - 1 - i] = (unsigned char) (bits >> (i*8));
+    for (i=0;i<5;i++) state[i][l] = h[i];
+  return;
+}
+
+void sha1fast_multi(const unsigned char *const *data, const size_t *len, unsigned char (*digest)[20], size_t count) {
+    static const unsigned char idle[64] = {0};
+    struct sha1fast_lane lanes[SHA1FAST_LANES];
+    const unsigned char *block[SHA1FAST_LANES];
+    sha1fast_vec state[5];
+    bool active[SHA1FAST_LANES];
+    size_t next = 0, m, n;
+    int l, i, numactive;
+    sha1_context ctx;
+    if (sha1fast_impl < 0) sha1fast_init();
+    if (sha1fast_impl != SHA1FAST_PORTABLE || count < 2) {
+        // one at a time is as fast as it gets on the hardware, and a single message has no lanes to share
+        for (m=0;m<count;m++) {
+            sha1_starts(&ctx);
+            for (n=0;n<len[m];n+=0x40000000) {
+                sha1_update(&ctx, (uchar *) data[m] + n, (uint) (len[m] - n > 0x40000000 ? 0x40000000 : len[m] - n));
+            }
+            sha1_finish(&ctx, digest[m]);
+        }
+      return;
+    }
+    memset(state, 0, sizeof(state));
+    for (l=0;l<SHA1FAST_LANES;l++) {
+        active[l] = next < count;
+        if (active[l]) {
+            sha1fast_startlane(&lanes[l], state, l, data[next], len[next], next);
+            next++;
+        }
+    }
+    do {
+        for (l=0;l<SHA1FAST_LANES;l++) {
+            if (!active[l]) block[l] = idle;
+            else if (lanes[l].numblocks) block[l] = lanes[l].data;
+            else block[l] = lanes[l].tail + lanes[l].tailblock*64;
+        }
+        sha1fast_lanes(state, block);
+        numactive = 0;
+        for (l=0;l<SHA1FAST_LANES;l++) {
+            if (!active[l]) continue;
+            if (lanes[l].numblocks) {
+                lanes[l].data += 64;
+                lanes[l].numblocks--;
+            }
+            else if (++lanes[l].tailblock == lanes[l].tailblocks) {
+                // this message is done, put the next one in its lane
+                for (i=0;i<5;i++) {
+                    digest[lanes[l].message][i*4]   = (unsigned char) (state[i][l] >> 24);
+                    digest[lanes[l].message][i*4+1] = (unsigned char) (state[i][l] >> 16);
+                    digest[lanes[l].message][i*4+2] = (unsigned char) (state[i][l] >> 8);
+                    digest[lanes[l].message][i*4+3] = (unsigned char) state[i][l];
+                }
+                active[l] = next < count;
+                if (active[l]) {
+                    sha1fast_startlane(&lanes[l], state, l, data[next], len[next], next);
+                    next++;
+                }
+            }
+            if (active[l]) numactive++;
+        }
+    } while (numactive);
+  return;
+}
+
+const char *sha1fast_implementation(void) {
+    if (sha1fast_impl < 0) sha1fast_init();
+    if (sha1fast_impl == SHA1FAST_SHANI) return "sha-ni";
+    if (sha1fast_impl == SHA1FAST_ARMV8_SHA1) return "armv8-sha1";
+  return "portable";
+}
@@ -0,0 +1,27 @@
+#ifndef _SHA1FAST_H
+#define _SHA1FAST_H
+
+// SHA-1 with the fastest implementation this cpu supports picked at runtime: the SHA extensions on x86 or the ARMv8
+// SHA1 instructions.  sha1_update() in sha1.c hands its whole blocks to sha1fast_blocks() and keeps its own code for
+// cpus that have neither.  sha1fast_multi() hashes a batch of independent messages at once: one after another on
+// the hardware, or four at a time in the lanes of a vector register when there isn't any
+
+#include <stddef.h>
+
+#define SHA1FAST_LANES 4
+
+// pick an implementation, call this once before any threads are started
+// (the other functions will call it if you forget, but that isn't thread safe)
+void sha1fast_init(void);
+
+// run numblocks 64 byte blocks of data through state (a sha1_context's state), returns 0 without touching anything
+// if there's no hardware to do it with
+int sha1fast_blocks(unsigned long state[5], const unsigned char *data, size_t numblocks);
+
+// digest[i] = SHA-1 of the len[i] bytes at data[i], for count messages
+void sha1fast_multi(const unsigned char *const *data, const size_t *len, unsigned char (*digest)[20], size_t count);
+
+// name of the implementation sha1fast_init() picked ("sha-ni", "armv8-sha1" or "portable")
+const char *sha1fast_implementation(void);
+
+#endif /* sha1fast.h */
@@ -0,0 +1,172 @@
+/*
+ *  shardcrc.c - multi-threaded sharded CRC-32 for abgx360
+ *
+ *  Every shard is read and hashed independently with positional reads, the shard CRCs are then
+ *  merged in order with crc32_combine() so the result is identical to one serial crc32() chain.
+ */
+
+#define _LARGEFILE_SOURCE
+#define _LARGEFILE64_SOURCE
+#define _FILE_OFFSET_BITS 64
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/time.h>
+#include <zlib.h>
+
+#include "crc32.h"
+#include "readahead.h"
+#include "shardcrc.h"
+
+static void *shardcrc_thread(void *arg) {
+    struct shardcrc_shard *shard = (struct shardcrc_shard *) arg;
+    struct shardcrc *sc = shard->sc;
+    struct readahead_block block;
+    struct sparsemap sparse;
+    unsigned long long pos = 0;
+    unsigned long crc = 0;
+    size_t length;
+    bool stop;
+    sparse_init(&sparse, sc->fd);
+    block.data = (unsigned char *) malloc(SHARDCRC_BLOCKSIZE);
+    if (block.data == NULL) {
+        shard->status = READAHEAD_READERROR;
+        shard->error = ENOMEM;
+        shard->erroroffset = shard->offset;
+        pos = shard->length;
+    }
+    while (pos < shard->length) {
+        pthread_mutex_lock(&sc->lock);
+        stop = sc->stop;
+        pthread_mutex_unlock(&sc->lock);
+        if (stop) break;
+        length = shard->length - pos < SHARDCRC_BLOCKSIZE ? (size_t) (shard->length - pos) : SHARDCRC_BLOCKSIZE;
+        readahead_readblock(sc->fd, &block, shard->offset + pos, length, sc->unitsize, sc->retries, &sparse);
+        if (block.hole) crc = crc32_zeros(crc, block.length);
+        else if (block.length) {
+            crc = crc32_fast(crc, block.data, (unsigned int) block.length);
+            if (sc->scan != NULL) sc->scan(sc->scanarg, shard->index, block.data, block.length, block.offset);
+        }
+        pthread_mutex_lock(&sc->lock);
+        sc->bytesdone += block.length;
+        sc->retries_total += block.retries;
+        sc->recovered_total += block.recovered;
+        pthread_mutex_unlock(&sc->lock);
+        if (block.status != READAHEAD_OK) {
+            shard->status = block.status;
+            shard->error = block.error;
+            shard->erroroffset = block.offset + block.length;
+          break;
+        }
+        pos += length;
+    }
+    shard->crc = crc;
+    free(block.data);
+    pthread_mutex_lock(&sc->lock);
+    sc->running--;
+    pthread_cond_broadcast(&sc->finished);
+    pthread_mutex_unlock(&sc->lock);
+  return NULL;
+}
+
+int shardcrc_start(struct shardcrc *sc, int fd, unsigned long long offset, unsigned long long length, int numshards,
+                   size_t unitsize, int retries, shardcrc_scanfunc scan, void *scanarg) {
+    int i;
+    unsigned long long units, unitspershard, extraunits;
+    memset(sc, 0, sizeof(struct shardcrc));
+    if (numshards < 1) numshards = 1;
+    if (numshards > SHARDCRC_MAXSHARDS) numshards = SHARDCRC_MAXSHARDS;
+    units = length / unitsize;
+    if (units < (unsigned long long) numshards) numshards = units ? (int) units : 1;
+    unitspershard = units / numshards;
+    extraunits = units % numshards;
+    sc->fd = fd;
+    sc->numshards = numshards;
+    sc->unitsize = unitsize;
+    sc->retries = retries;
+    sc->scan = scan;
+    sc->scanarg = scanarg;
+    for (i=0;i<numshards;i++) {
+        sc->shards[i].sc = sc;
+        sc->shards[i].index = i;
+        sc->shards[i].offset = offset;
+        sc->shards[i].length = (unitspershard + ((unsigned long long) i < extraunits ? 1 : 0)) * unitsize;
+        // the last shard also gets whatever doesn't fill a whole unit
+        if (i == numshards - 1) sc->shards[i].length += length % unitsize;
+        offset += sc->shards[i].length;
+    }
+    pthread_mutex_init(&sc->lock, NULL);
+    pthread_cond_init(&sc->finished, NULL);
+    for (i=0;i<numshards;i++) {
+        pthread_mutex_lock(&sc->lock);
+        sc->running++;
+        pthread_mutex_unlock(&sc->lock);
+        if (pthread_create(&sc->shards[i].thread, NULL, shardcrc_thread, &sc->shards[i]) != 0) {
+            pthread_mutex_lock(&sc->lock);
+            sc->running--;
+            pthread_mutex_unlock(&sc->lock);
+            shardcrc_cancel(sc);
+          return 1;
+        }
+        sc->shards[i].started = true;
+    }
+  return 0;
+}
+
+bool shardcrc_wait(struct shardcrc *sc, unsigned long msecs, unsigned long long *bytesdone,
+                   unsigned long *retries, unsigned long *recovered) {
+    struct timeval now;
+    struct timespec until;
+    bool done;
+    gettimeofday(&now, NULL);
+    until.tv_sec = now.tv_sec + (time_t) (msecs / 1000);
+    until.tv_nsec = (long) now.tv_usec * 1000 + (long) (msecs % 1000) * 1000000;
+    if (until.tv_nsec >= 1000000000) {
+        until.tv_sec++;
+        until.tv_nsec -= 1000000000;
+    }
+    pthread_mutex_lock(&sc->lock);
+    if (sc->running) pthread_cond_timedwait(&sc->finished, &sc->lock, &until);
+    done = (sc->running == 0);
+    if (bytesdone != NULL) *bytesdone = sc->bytesdone;
+    if (retries != NULL) *retries = sc->retries_total;
+    if (recovered != NULL) *recovered = sc->recovered_total;
+    pthread_mutex_unlock(&sc->lock);
+  return done;
+}
+
+static void shardcrc_join(struct shardcrc *sc) {
+    int i;
+    for (i=0;i<sc->numshards;i++) {
+        if (sc->shards[i].started) {
+            pthread_join(sc->shards[i].thread, NULL);
+            sc->shards[i].started = false;
+        }
+    }
+    pthread_mutex_destroy(&sc->lock);
+    pthread_cond_destroy(&sc->finished);
+  return;
+}
+
+int shardcrc_finish(struct shardcrc *sc, unsigned long *crc, struct shardcrc_shard **failedshard) {
+    int i;
+    shardcrc_join(sc);
+    for (i=0;i<sc->numshards;i++) {
+        if (sc->shards[i].status != READAHEAD_OK) {
+            if (failedshard != NULL) *failedshard = &sc->shards[i];
+          return sc->shards[i].status;
+        }
+        *crc = crc32_combine(*crc, sc->shards[i].crc, (z_off_t) sc->shards[i].length);
+    }
+  return READAHEAD_OK;
+}
+
+void shardcrc_cancel(struct shardcrc *sc) {
+    pthread_mutex_lock(&sc->lock);
+    sc->stop = true;
+    pthread_mutex_unlock(&sc->lock);
+    shardcrc_join(sc);
+  return;
+}
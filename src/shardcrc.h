@@ -0,0 +1,65 @@
+#ifndef _SHARDCRC_H
+#define _SHARDCRC_H
+
+// sharded CRC-32: a range of a file is split into shards that are read with positional i/o on their own
+// threads, and the per-shard CRCs are merged with crc32_combine() into the CRC of the whole range
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#define SHARDCRC_BLOCKSIZE 1048576  // 1 MB per read
+#define SHARDCRC_MAXSHARDS 64
+
+// called from the shard threads for every block read, offset is the file offset of data[0]
+// (not called for holes in sparse files, they're all zeroes)
+typedef void (*shardcrc_scanfunc)(void *arg, int shard, const unsigned char *data, size_t length, unsigned long long offset);
+
+struct shardcrc;
+
+struct shardcrc_shard {
+    struct shardcrc *sc;
+    int index;
+    unsigned long long offset, length;
+    unsigned long crc;
+    int status;          // READAHEAD_OK, READAHEAD_EOF or READAHEAD_READERROR
+    int error;
+    unsigned long long erroroffset;
+    pthread_t thread;
+    bool started;
+};
+
+struct shardcrc {
+    int fd;
+    int numshards;
+    size_t unitsize;
+    int retries;
+    shardcrc_scanfunc scan;
+    void *scanarg;
+    struct shardcrc_shard shards[SHARDCRC_MAXSHARDS];
+    pthread_mutex_t lock;
+    pthread_cond_t finished;
+    int running;
+    bool stop;
+    unsigned long long bytesdone;
+    unsigned long retries_total, recovered_total;
+};
+
+// start numshards threads reading length bytes of fd at offset, shard boundaries fall on unitsize boundaries
+// returns 0 on success, 1 if a thread could not be started (any threads that were started are stopped)
+int shardcrc_start(struct shardcrc *sc, int fd, unsigned long long offset, unsigned long long length, int numshards,
+                   size_t unitsize, int retries, shardcrc_scanfunc scan, void *scanarg);
+
+// wait up to msecs for the shards to finish, returns true if they're all done
+// bytesdone, retries and recovered are totals over all shards so far
+bool shardcrc_wait(struct shardcrc *sc, unsigned long msecs, unsigned long long *bytesdone,
+                   unsigned long *retries, unsigned long *recovered);
+
+// join the shard threads and merge their CRCs starting from crc
+// returns READAHEAD_OK or the status of the first shard that failed (stored in *failedshard)
+int shardcrc_finish(struct shardcrc *sc, unsigned long *crc, struct shardcrc_shard **failedshard);
+
+// ask the shard threads to stop early and join them
+void shardcrc_cancel(struct shardcrc *sc);
+
+#endif /* shardcrc.h */
@@ -0,0 +1,84 @@
+/*
+ *  sparse.c - filesystem hole detection for abgx360
+ *
+ *  On filesystems without SEEK_DATA/SEEK_HOLE (or where lseek just reports the whole file as data)
+ *  sparse_iszero() is always false and everything is read as usual.
+ */
+
+#define _LARGEFILE_SOURCE
+#define _LARGEFILE64_SOURCE
+#define _FILE_OFFSET_BITS 64
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "sparse.h"
+
+// the lseeks below move the file position that's shared by every thread using the fd, so only one lookup at a time
+static pthread_mutex_t sparse_lock = PTHREAD_MUTEX_INITIALIZER;
+
+void sparse_init(struct sparsemap *map, int fd) {
+    map->fd = fd;
+    map->disabled = false;
+    map->hole = false;
+    map->start = 0;
+    map->end = 0;
+    #ifndef SEEK_DATA
+        map->disabled = true;
+    #endif
+  return;
+}
+
+// find the run that offset is in
+static void sparse_findrun(struct sparsemap *map, unsigned long long offset) {
+    #ifdef SEEK_DATA
+        off_t data, hole, current;
+        int dataerror;
+        struct stat st;
+        map->start = offset;
+        // the fd may belong to a FILE that's being read sequentially, so put its file position back afterwards
+        pthread_mutex_lock(&sparse_lock);
+        current = lseek(map->fd, 0, SEEK_CUR);
+        data = lseek(map->fd, (off_t) offset, SEEK_DATA);
+        dataerror = errno;
+        if (data >= 0) hole = lseek(map->fd, (off_t) offset, SEEK_HOLE);
+        else hole = -1;
+        if (current >= 0) lseek(map->fd, current, SEEK_SET);
+        pthread_mutex_unlock(&sparse_lock);
+        if (data < 0) {
+            if (dataerror == ENXIO && fstat(map->fd, &st) == 0 && (unsigned long long) st.st_size > offset) {
+                // no more data after offset, the rest of the file is a hole
+                map->hole = true;
+                map->end = (unsigned long long) st.st_size;
+            }
+            else map->disabled = true;  // not supported (or offset is past the end of the file)
+          return;
+        }
+        if ((unsigned long long) data > offset) {
+            map->hole = true;
+            map->end = (unsigned long long) data;
+          return;
+        }
+        if (hole < 0 || (unsigned long long) hole <= offset) {
+            map->disabled = true;
+          return;
+        }
+        map->hole = false;
+        map->end = (unsigned long long) hole;
+    #else
+        (void) offset;
+        map->disabled = true;
+    #endif
+  return;
+}
+
+bool sparse_iszero(struct sparsemap *map, unsigned long long offset, unsigned long long length) {
+    if (map->disabled) return false;
+    if (offset < map->start || offset >= map->end) sparse_findrun(map, offset);
+    if (map->disabled) return false;
+  return map->hole && offset + length <= map->end;
+}
@@ -0,0 +1,22 @@
+#ifndef _SPARSE_H
+#define _SPARSE_H
+
+// filesystem hole detection with lseek(SEEK_DATA/SEEK_HOLE) so that unwritten parts of sparse images
+// can be treated as zeroes without reading them
+
+#include <stdbool.h>
+
+// the data or hole run that was found last, so forward scans only need a couple of lseeks per run
+struct sparsemap {
+    int fd;
+    bool disabled;                   // SEEK_DATA isn't supported here
+    bool hole;
+    unsigned long long start, end;   // run [start, end) is a hole if hole == true, otherwise data
+};
+
+void sparse_init(struct sparsemap *map, int fd);
+
+// true if bytes [offset, offset+length) of the file are entirely inside a hole
+bool sparse_iszero(struct sparsemap *map, unsigned long long offset, unsigned long long length);
+
+#endif /* sparse.h */
@@ -0,0 +1,259 @@
+/*
+ *  stealthstore.c - content-addressed store of verified stealth files for abgx360
+ *
+ *  Objects are named by the SHA-1 of their contents and made read-only, the stealth file keeps its usual name in
+ *  StealthFiles as another hard link to the same inode and a symlink in Store/names/ records which object that name
+ *  was verified as.  Nothing ever writes into an object: objects are read-only, downloads go to a new inode (prefetch
+ *  renames a temp file over the old name) and everything else that writes a file abgx360 was given a name for
+ *  (my_curl_write(), writeini(), the extraction options) goes through openforwriting(), which unlinks a linked file
+ *  first, so a name whose file is still its object's inode hasn't changed since it was verified.  An object that no file links to anymore has a link count of 1 and is what
+ *  stealthstore_gc() reclaims.
+ */
+
+#define _LARGEFILE_SOURCE
+#define _LARGEFILE64_SOURCE
+#define _FILE_OFFSET_BITS 64
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "sha1.h"
+#include "stealthstore.h"
+
+#define STEALTHSTORE_READSIZE 1048576
+
+static unsigned long stealthstore_tmpcount = 0;
+
+static void stealthstore_tmpname(char *tmppath, size_t size, const char *path) {
+    // unique per process and per thread (--jobs can insert from several at once)
+    snprintf(tmppath, size, "%s.%ld.%lu.tmp", path, (long) getpid(),
+             __atomic_fetch_add(&stealthstore_tmpcount, 1, __ATOMIC_RELAXED));
+  return;
+}
+
+static int stealthstore_sha1(const char *path, char *hex) {
+    sha1_context ctx;
+    unsigned char digest[20], *buffer;
+    size_t n;
+    int i, error = 0;
+    FILE *stream;
+    buffer = (unsigned char *) malloc(STEALTHSTORE_READSIZE);
+    if (buffer == NULL) {
+        errno = ENOMEM;
+      return -1;
+    }
+    stream = fopen(path, "rb");
+    if (stream == NULL) {
+        free(buffer);
+      return -1;
+    }
+    sha1_starts(&ctx);
+    while ((n = fread(buffer, 1, STEALTHSTORE_READSIZE, stream)) > 0) sha1_update(&ctx, buffer, (unsigned int) n);
+    if (ferror(stream)) error = errno ? errno : EIO;
+    fclose(stream);
+    free(buffer);
+    if (error) {
+        errno = error;
+      return -1;
+    }
+    sha1_finish(&ctx, digest);
+    for (i=0;i<20;i++) sprintf(hex+i*2, "%02x", digest[i]);
+  return 0;
+}
+
+static int stealthstore_mkdirs(const char *dir) {
+    char path[2048];
+    snprintf(path, sizeof(path), "%s%s", dir, STEALTHSTORE_DIR);
+    if (mkdir(path, 0755) != 0 && errno != EEXIST) return -1;
+    snprintf(path, sizeof(path), "%s%s", dir, STEALTHSTORE_OBJECTS);
+    if (mkdir(path, 0755) != 0 && errno != EEXIST) return -1;
+    snprintf(path, sizeof(path), "%s%s", dir, STEALTHSTORE_NAMES);
+    if (mkdir(path, 0755) != 0 && errno != EEXIST) return -1;
+  return 0;
+}
+
+static int stealthstore_linkname(const char *dir, const char *name, const char *hex) {
+    // point Store/names/<name> at the object, replacing whatever it pointed at before
+    char namepath[2048], tmppath[2100], target[64];
+    snprintf(namepath, sizeof(namepath), "%s%s%s", dir, STEALTHSTORE_NAMES, name);
+    snprintf(target, sizeof(target), "../objects/%s", hex);
+    stealthstore_tmpname(tmppath, sizeof(tmppath), namepath);
+    if (symlink(target, tmppath) != 0) return -1;
+    if (rename(tmppath, namepath) != 0) {
+        int error = errno;
+        unlink(tmppath);
+        errno = error;
+      return -1;
+    }
+  return 0;
+}
+
+static int stealthstore_replacewithobject(const char *objpath, const char *path) {
+    // swap path for a link to the object in one step, so there's never a moment without a file at path
+    char tmppath[2100];
+    stealthstore_tmpname(tmppath, sizeof(tmppath), path);
+    if (link(objpath, tmppath) != 0) return -1;
+    if (rename(tmppath, path) != 0) {
+        int error = errno;
+        unlink(tmppath);
+        errno = error;
+      return -1;
+    }
+  return 0;
+}
+
+bool stealthstore_trusted(const char *dir, const char *name, int fd) {
+    char namepath[2048];
+    struct stat fdst, objst;
+    snprintf(namepath, sizeof(namepath), "%s%s%s", dir, STEALTHSTORE_NAMES, name);
+    if (fstat(fd, &fdst) != 0 || stat(namepath, &objst) != 0) return false;
+  return S_ISREG(objst.st_mode) && fdst.st_dev == objst.st_dev && fdst.st_ino == objst.st_ino;
+}
+
+int stealthstore_insert(const char *dir, const char *name) {
+    char path[2048], namepath[2048], objpath[2048], hex[41];
+    struct stat st, objst;
+    int result = STEALTHSTORE_ADDED, tries;
+    snprintf(path, sizeof(path), "%s%s", dir, name);
+    snprintf(namepath, sizeof(namepath), "%s%s%s", dir, STEALTHSTORE_NAMES, name);
+    if (lstat(path, &st) != 0) return -1;
+    if (!S_ISREG(st.st_mode)) {
+        errno = EINVAL;
+      return -1;
+    }
+    if (stat(namepath, &objst) == 0 && st.st_dev == objst.st_dev && st.st_ino == objst.st_ino) return STEALTHSTORE_ALREADYTRUSTED;
+    if (stealthstore_mkdirs(dir) != 0) return -1;
+    if (stealthstore_sha1(path, hex) != 0) return -1;
+    snprintf(objpath, sizeof(objpath), "%s%s%s", dir, STEALTHSTORE_OBJECTS, hex);
+    for (tries=0;tries<2;tries++) {
+        if (stat(objpath, &objst) != 0) {
+            if (errno != ENOENT) return -1;
+            // a new object: the file itself becomes it
+            if (link(path, objpath) == 0) {
+                chmod(objpath, 0444);
+                result = STEALTHSTORE_ADDED;
+              break;
+            }
+            if (errno != EEXIST) return -1;
+            continue;  // another job added it first
+        }
+        if (objst.st_dev == st.st_dev && objst.st_ino == st.st_ino) {
+            // already the object (stealthstore_gc() deduplicated it), it only needed a name
+            result = STEALTHSTORE_ADDED;
+          break;
+        }
+        if (objst.st_size != st.st_size) {
+            // can't be the same contents, whatever is there isn't a valid object
+            if (unlink(objpath) != 0) return -1;
+            continue;
+        }
+        if (stealthstore_replacewithobject(objpath, path) != 0) return -1;
+        result = STEALTHSTORE_DEDUPLICATED;
+      break;
+    }
+    if (tries == 2) {
+        errno = EEXIST;
+      return -1;
+    }
+    if (stealthstore_linkname(dir, name, hex) != 0) return -1;
+  return result;
+}
+
+void stealthstore_forget(const char *dir, const char *name) {
+    char namepath[2048];
+    snprintf(namepath, sizeof(namepath), "%s%s%s", dir, STEALTHSTORE_NAMES, name);
+    unlink(namepath);
+  return;
+}
+
+struct stealthstore_object {
+    char hex[41];
+    off_t size;
+};
+
+int stealthstore_gc(const char *dir, struct stealthstore_gcstats *stats) {
+    char path[2048], namepath[2048], objpath[2048], hex[41];
+    struct stealthstore_object *objects = NULL, *grown;
+    unsigned long numobjects = 0, maxobjects = 0, i;
+    struct stat st, objst;
+    struct dirent *ep;
+    DIR *dp;
+    memset(stats, 0, sizeof(struct stealthstore_gcstats));
+    // names whose file is gone or was replaced since it was verified
+    snprintf(path, sizeof(path), "%s%s", dir, STEALTHSTORE_NAMES);
+    dp = opendir(path);
+    if (dp == NULL) return errno == ENOENT ? 0 : -1;
+    while ((ep = readdir(dp)) != NULL) {
+        if (ep->d_name[0] == '.') continue;
+        snprintf(namepath, sizeof(namepath), "%s%s%s", dir, STEALTHSTORE_NAMES, ep->d_name);
+        snprintf(path, sizeof(path), "%s%s", dir, ep->d_name);
+        if (stat(namepath, &objst) == 0 && lstat(path, &st) == 0 && st.st_dev == objst.st_dev && st.st_ino == objst.st_ino) continue;
+        if (unlink(namepath) == 0) stats->stalenames++;
+    }
+    closedir(dp);
+    // objects nothing links to anymore, and a list of the rest
+    snprintf(path, sizeof(path), "%s%s", dir, STEALTHSTORE_OBJECTS);
+    dp = opendir(path);
+    if (dp == NULL) return errno == ENOENT ? 0 : -1;
+    while ((ep = readdir(dp)) != NULL) {
+        if (strlen(ep->d_name) != 40) continue;
+        snprintf(objpath, sizeof(objpath), "%s%s%s", dir, STEALTHSTORE_OBJECTS, ep->d_name);
+        if (lstat(objpath, &objst) != 0 || !S_ISREG(objst.st_mode)) continue;
+        if (objst.st_nlink == 1) {
+            if (unlink(objpath) == 0) {
+                stats->objectsremoved++;
+                stats->bytesreclaimed += (unsigned long long) objst.st_size;
+            }
+          continue;
+        }
+        if (numobjects == maxobjects) {
+            maxobjects = maxobjects ? maxobjects * 2 : 256;
+            grown = (struct stealthstore_object *) realloc(objects, maxobjects * sizeof(struct stealthstore_object));
+            if (grown == NULL) {
+                closedir(dp);
+                free(objects);
+                errno = ENOMEM;
+              return -1;
+            }
+            objects = grown;
+        }
+        memcpy(objects[numobjects].hex, ep->d_name, 41);
+        objects[numobjects].size = objst.st_size;
+        numobjects++;
+    }
+    closedir(dp);
+    // files that are copies of an object; only ones the size of some object are worth hashing, and they get linked to
+    // the object but not named, since a copy under another name was never verified as that name
+    dp = opendir(dir);
+    if (dp == NULL) {
+        free(objects);
+      return -1;
+    }
+    while (numobjects && (ep = readdir(dp)) != NULL) {
+        if (ep->d_name[0] == '.') continue;
+        snprintf(path, sizeof(path), "%s%s", dir, ep->d_name);
+        if (lstat(path, &st) != 0 || !S_ISREG(st.st_mode) || st.st_nlink != 1) continue;
+        for (i=0;i<numobjects;i++) if (objects[i].size == st.st_size) break;
+        if (i == numobjects) continue;
+        if (stealthstore_sha1(path, hex) != 0) continue;
+        for (i=0;i<numobjects;i++) {
+            if (objects[i].size != st.st_size || strcmp(objects[i].hex, hex) != 0) continue;
+            snprintf(objpath, sizeof(objpath), "%s%s%s", dir, STEALTHSTORE_OBJECTS, hex);
+            if (stealthstore_replacewithobject(objpath, path) == 0) {
+                stats->filesdeduplicated++;
+                stats->bytesreclaimed += (unsigned long long) st.st_size;
+            }
+          break;
+        }
+    }
+    closedir(dp);
+    free(objects);
+  return 0;
+}
@@ -0,0 +1,39 @@
+#ifndef _STEALTHSTORE_H
+#define _STEALTHSTORE_H
+
+// stealth file store: stealth files that passed AutoFix's checks are kept once each under their SHA-1 in
+// StealthFiles/Store/objects/ (read-only), the file in StealthFiles is a hard link to its object and
+// StealthFiles/Store/names/<name> is a symlink to it, so a file that's still the object it was verified as can be
+// trusted without reading it again and identical files only take up space once
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#define STEALTHSTORE_DIR     "Store/"
+#define STEALTHSTORE_OBJECTS "Store/objects/"
+#define STEALTHSTORE_NAMES   "Store/names/"
+
+// results of stealthstore_insert()
+#define STEALTHSTORE_ALREADYTRUSTED 0
+#define STEALTHSTORE_ADDED          1  // a new object
+#define STEALTHSTORE_DEDUPLICATED   2  // the file was replaced with a link to an identical object that was already there
+
+struct stealthstore_gcstats {
+    unsigned long stalenames, objectsremoved, filesdeduplicated;
+    unsigned long long bytesreclaimed;
+};
+
+// true if the file open on fd is the object that dir/Store/names/<name> points to (dir ends with a slash)
+bool stealthstore_trusted(const char *dir, const char *name, int fd);
+
+// add dir/<name> (which the caller has just verified) to the store, returns one of the results above or -1 (errno set)
+int stealthstore_insert(const char *dir, const char *name);
+
+// dir/<name> is being deleted or replaced, drop its name link (the object is left for stealthstore_gc())
+void stealthstore_forget(const char *dir, const char *name);
+
+// remove name links that no longer point at the file they were made for and objects that no file links to anymore,
+// and replace any file in dir that's identical to an object with a link to it, returns 0 or -1 (errno set)
+int stealthstore_gc(const char *dir, struct stealthstore_gcstats *stats);
+
+#endif /* stealthstore.h */
@@ -0,0 +1,454 @@
+/*
+ *  videopack.c - chunk-indexed zlib container for video stealth files for abgx360
+ *
+ *  A header, an index with one entry per VIDEOPACK_CHUNKSIZE chunk of the original file, then the chunks in order.
+ *  Runs of zero chunks only take up their index entries.  The reader keeps a window of decompressed chunks starting
+ *  at the one it was asked for and decompresses the next window (only its non-zero chunks) on several threads at once
+ *  with positional reads, so a sequential reader (checkvideo() and AutoFix read 32 KB at a time) only waits for a
+ *  window every few MB.  Reads of zero chunks never touch the window.
+ */
+
+#define _LARGEFILE_SOURCE
+#define _LARGEFILE64_SOURCE
+#define _FILE_OFFSET_BITS 64
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+#include "crc32.h"
+#include "zeroscan.h"
+#include "videopack.h"
+
+#define VIDEOPACK_MAGIC "abgxvpk1"
+#define VIDEOPACK_WINDOW 2                // window size in chunks per thread
+#define VIDEOPACK_READSIZE 1048576        // read size when checking a packed file
+
+struct videopack_reader {
+    int fd;
+    struct videopack_header header;
+    struct videopack_chunk *chunks;
+    unsigned long long pos;
+    int threads;
+    unsigned char *window;                // windowchunks decompressed chunks starting at windowfirst
+    uint32_t windowchunks, windowfirst, windowcount;
+    unsigned char **inbuffers;            // compressed input, one per thread
+    uLong inbuffersize;
+};
+
+// one thread's share of a window (reading) or a batch (packing): chunks start, start+stride, ... of count
+struct videopack_work {
+    struct videopack_reader *reader;
+    uint32_t first, count, start, stride;
+    unsigned char *in, *raw, **out;       // packing: raw is the batch, out[i] gets chunk i's compressed data
+    uLong *outlength;
+    uint32_t *types;
+    int level, error;
+};
+
+static uint32_t videopack_chunklength(const struct videopack_header *header, uint32_t chunk) {
+    unsigned long long start = (unsigned long long) chunk * header->chunksize;
+    if (header->size - start < header->chunksize) return (uint32_t) (header->size - start);
+  return header->chunksize;
+}
+
+static int videopack_preadall(int fd, unsigned char *buf, size_t length, unsigned long long offset) {
+    ssize_t n;
+    while (length) {
+        n = pread(fd, buf, length, (off_t) offset);
+        if (n == -1 && errno == EINTR) continue;
+        if (n == -1) return -1;
+        if (n == 0) {
+            errno = EIO;
+          return -1;
+        }
+        buf += n;
+        length -= (size_t) n;
+        offset += (unsigned long long) n;
+    }
+  return 0;
+}
+
+static void *videopack_decompressthread(void *arg) {
+    struct videopack_work *work = (struct videopack_work *) arg;
+    struct videopack_reader *r = work->reader;
+    struct videopack_chunk *chunk;
+    unsigned char *dest;
+    uint32_t i, length;
+    uLongf destlength;
+    for (i=work->start;i<work->count && !work->error;i+=work->stride) {
+        chunk = &r->chunks[work->first + i];
+        dest = r->window + (size_t) i * r->header.chunksize;
+        length = videopack_chunklength(&r->header, work->first + i);
+        if (chunk->type == VIDEOPACK_ZERO) continue;
+        if (chunk->type == VIDEOPACK_STORED) {
+            if (videopack_preadall(r->fd, dest, length, chunk->offset) != 0) work->error = errno;
+          continue;
+        }
+        if (videopack_preadall(r->fd, work->in, chunk->length, chunk->offset) != 0) {
+            work->error = errno;
+          continue;
+        }
+        destlength = length;
+        if (uncompress(dest, &destlength, work->in, chunk->length) != Z_OK || destlength != length) work->error = EIO;
+    }
+  return NULL;
+}
+
+static int videopack_fillwindow(struct videopack_reader *r, uint32_t first) {
+    struct videopack_work work[VIDEOPACK_MAXTHREADS];
+    pthread_t threads[VIDEOPACK_MAXTHREADS];
+    uint32_t count, i, nonzero = 0;
+    int numthreads, started, t, error = 0;
+    count = r->header.numchunks - first;
+    if (count > r->windowchunks) count = r->windowchunks;
+    for (i=0;i<count;i++) if (r->chunks[first + i].type != VIDEOPACK_ZERO) nonzero++;
+    numthreads = (int) nonzero < r->threads ? (int) nonzero : r->threads;
+    if (numthreads < 1) numthreads = 1;
+    r->windowcount = 0;
+    for (t=0;t<numthreads;t++) {
+        memset(&work[t], 0, sizeof(struct videopack_work));
+        work[t].reader = r;
+        work[t].first = first;
+        work[t].count = count;
+        work[t].start = (uint32_t) t;
+        work[t].stride = (uint32_t) numthreads;
+        work[t].in = r->inbuffers[t];
+    }
+    // the calling thread does the first share itself, and any share a thread couldn't be started for
+    for (started=1;started<numthreads;started++) {
+        if (pthread_create(&threads[started], NULL, videopack_decompressthread, &work[started]) != 0) break;
+    }
+    for (t=started;t<numthreads;t++) videopack_decompressthread(&work[t]);
+    videopack_decompressthread(&work[0]);
+    for (t=1;t<started;t++) pthread_join(threads[t], NULL);
+    for (t=0;t<numthreads;t++) if (work[t].error && !error) error = work[t].error;
+    if (error) {
+        errno = error;
+      return -1;
+    }
+    r->windowfirst = first;
+    r->windowcount = count;
+  return 0;
+}
+
+static ssize_t videopack_read(void *cookie, char *buf, size_t size) {
+    struct videopack_reader *r = (struct videopack_reader *) cookie;
+    size_t done = 0, length;
+    uint32_t chunk, offset;
+    while (done < size && r->pos < r->header.size) {
+        chunk = (uint32_t) (r->pos / r->header.chunksize);
+        offset = (uint32_t) (r->pos % r->header.chunksize);
+        length = videopack_chunklength(&r->header, chunk) - offset;
+        if (length > size - done) length = size - done;
+        if (r->chunks[chunk].type == VIDEOPACK_ZERO) memset(buf + done, 0, length);
+        else {
+            if (r->windowcount == 0 || chunk < r->windowfirst || chunk >= r->windowfirst + r->windowcount) {
+                if (videopack_fillwindow(r, chunk) != 0) return done ? (ssize_t) done : -1;
+            }
+            memcpy(buf + done, r->window + (size_t) (chunk - r->windowfirst) * r->header.chunksize + offset, length);
+        }
+        done += length;
+        r->pos += length;
+    }
+  return (ssize_t) done;
+}
+
+static int videopack_seek(struct videopack_reader *r, long long *offset, int whence) {
+    long long newpos;
+    if (whence == SEEK_SET) newpos = *offset;
+    else if (whence == SEEK_CUR) newpos = (long long) r->pos + *offset;
+    else if (whence == SEEK_END) newpos = (long long) r->header.size + *offset;
+    else newpos = -1;
+    if (newpos < 0) {
+        errno = EINVAL;
+      return -1;
+    }
+    r->pos = (unsigned long long) newpos;
+    *offset = newpos;
+  return 0;
+}
+
+static void videopack_free(struct videopack_reader *r) {
+    int t;
+    if (r->fd != -1) close(r->fd);
+    free(r->chunks);
+    free(r->window);
+    if (r->inbuffers != NULL) {
+        for (t=0;t<r->threads;t++) free(r->inbuffers[t]);
+        free(r->inbuffers);
+    }
+    free(r);
+  return;
+}
+
+static int videopack_close(void *cookie) {
+    videopack_free((struct videopack_reader *) cookie);
+  return 0;
+}
+
+#if defined(__GLIBC__)
+    static int videopack_cookieseek(void *cookie, off64_t *offset, int whence) {
+        long long pos = (long long) *offset;
+        if (videopack_seek((struct videopack_reader *) cookie, &pos, whence) != 0) return -1;
+        *offset = (off64_t) pos;
+      return 0;
+    }
+#else
+    static int videopack_funread(void *cookie, char *buf, int size) {
+      return (int) videopack_read(cookie, buf, (size_t) size);
+    }
+    static fpos_t videopack_funseek(void *cookie, fpos_t offset, int whence) {
+        long long pos = (long long) offset;
+        if (videopack_seek((struct videopack_reader *) cookie, &pos, whence) != 0) return (fpos_t) -1;
+      return (fpos_t) pos;
+    }
+#endif
+
+FILE *videopack_fopen(const char *filename, int threads) {
+    struct videopack_reader *r;
+    struct stat st;
+    unsigned long long end;
+    uint32_t i;
+    int t, error;
+    FILE *stream;
+    r = (struct videopack_reader *) calloc(1, sizeof(struct videopack_reader));
+    if (r == NULL) {
+        errno = ENOMEM;
+      return NULL;
+    }
+    r->fd = open(filename, O_RDONLY);
+    if (r->fd == -1) {
+        error = errno;
+        free(r);
+        errno = error;
+      return NULL;
+    }
+    if (fstat(r->fd, &st) != 0 || videopack_preadall(r->fd, (unsigned char *) &r->header, sizeof(struct videopack_header), 0) != 0) goto error;
+    if (memcmp(r->header.magic, VIDEOPACK_MAGIC, 8) != 0 || r->header.chunksize == 0 || r->header.chunksize > 67108864 ||
+        r->header.numchunks != (r->header.size + r->header.chunksize - 1) / r->header.chunksize) goto invalid;
+    end = sizeof(struct videopack_header) + (unsigned long long) r->header.numchunks * sizeof(struct videopack_chunk);
+    if (end > (unsigned long long) st.st_size) goto invalid;
+    r->chunks = (struct videopack_chunk *) malloc((size_t) r->header.numchunks * sizeof(struct videopack_chunk) + 1);
+    if (r->chunks == NULL) goto nomemory;
+    if (videopack_preadall(r->fd, (unsigned char *) r->chunks, (size_t) r->header.numchunks * sizeof(struct videopack_chunk),
+                           sizeof(struct videopack_header)) != 0) goto error;
+    r->inbuffersize = compressBound(r->header.chunksize);
+    for (i=0;i<r->header.numchunks;i++) {
+        if (r->chunks[i].type > VIDEOPACK_STORED || r->chunks[i].length > r->inbuffersize ||
+            r->chunks[i].offset + r->chunks[i].length > (unsigned long long) st.st_size ||
+            (r->chunks[i].type == VIDEOPACK_STORED && r->chunks[i].length != videopack_chunklength(&r->header, i))) goto invalid;
+    }
+    if (threads <= 0) threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads < 1) threads = 1;
+    if (threads > VIDEOPACK_MAXTHREADS) threads = VIDEOPACK_MAXTHREADS;
+    r->windowchunks = (uint32_t) threads * VIDEOPACK_WINDOW;
+    r->window = (unsigned char *) malloc((size_t) r->windowchunks * r->header.chunksize);
+    r->inbuffers = (unsigned char **) calloc((size_t) threads, sizeof(unsigned char *));
+    if (r->window == NULL || r->inbuffers == NULL) goto nomemory;
+    r->threads = threads;
+    for (t=0;t<threads;t++) {
+        r->inbuffers[t] = (unsigned char *) malloc(r->inbuffersize);
+        if (r->inbuffers[t] == NULL) goto nomemory;
+    }
+    #if defined(__GLIBC__)
+        cookie_io_functions_t functions;
+        functions.read = videopack_read;
+        functions.write = NULL;
+        functions.seek = videopack_cookieseek;
+        functions.close = videopack_close;
+        stream = fopencookie(r, "rb", functions);
+    #else
+        stream = funopen(r, videopack_funread, NULL, videopack_funseek, videopack_close);
+    #endif
+    if (stream == NULL) goto error;
+  return stream;
+
+    invalid:
+    errno = EINVAL;
+    goto error;
+    nomemory:
+    errno = ENOMEM;
+    error:
+    error = errno;
+    videopack_free(r);
+    errno = error;
+  return NULL;
+}
+
+static void *videopack_compressthread(void *arg) {
+    struct videopack_work *work = (struct videopack_work *) arg;
+    uint32_t i, length;
+    uLongf outlength;
+    for (i=work->start;i<work->count;i+=work->stride) {
+        length = (uint32_t) work->outlength[i];  // comes in as the length of the raw chunk
+        if (zeroscan_allzeros(work->raw + (size_t) i * VIDEOPACK_CHUNKSIZE, length)) {
+            work->types[i] = VIDEOPACK_ZERO;
+            work->outlength[i] = 0;
+          continue;
+        }
+        outlength = compressBound(VIDEOPACK_CHUNKSIZE);
+        if (compress2(work->out[i], &outlength, work->raw + (size_t) i * VIDEOPACK_CHUNKSIZE, length, work->level) == Z_OK &&
+            outlength < length) {
+            work->types[i] = VIDEOPACK_DEFLATE;
+            work->outlength[i] = outlength;
+        }
+        else {
+            work->types[i] = VIDEOPACK_STORED;
+            memcpy(work->out[i], work->raw + (size_t) i * VIDEOPACK_CHUNKSIZE, length);
+            work->outlength[i] = length;
+        }
+    }
+  return NULL;
+}
+
+static int videopack_check(const char *filename, int threads, unsigned long long size, unsigned long crc) {
+    // read the packed file back the way it's going to be read and make sure it's what we packed
+    unsigned char *buffer;
+    unsigned long long total = 0;
+    unsigned long readcrc = 0;
+    size_t n;
+    int error = 0;
+    FILE *stream = videopack_fopen(filename, threads);
+    if (stream == NULL) return -1;
+    buffer = (unsigned char *) malloc(VIDEOPACK_READSIZE);
+    if (buffer == NULL) {
+        fclose(stream);
+        errno = ENOMEM;
+      return -1;
+    }
+    while ((n = fread(buffer, 1, VIDEOPACK_READSIZE, stream)) > 0) {
+        readcrc = crc32_fast(readcrc, buffer, n);
+        total += n;
+    }
+    if (ferror(stream)) error = errno ? errno : EIO;
+    else if (total != size || readcrc != crc) error = EIO;
+    free(buffer);
+    fclose(stream);
+    if (error) {
+        errno = error;
+      return -1;
+    }
+  return 0;
+}
+
+int videopack_pack(const char *srcfilename, const char *dstfilename, int threads, int level,
+                   unsigned long long *originalsize, unsigned long long *packedsize, unsigned long *crc) {
+    struct videopack_header header;
+    struct videopack_chunk *chunks = NULL;
+    struct videopack_work work[VIDEOPACK_MAXTHREADS];
+    pthread_t threadids[VIDEOPACK_MAXTHREADS];
+    unsigned char *raw = NULL, **out = NULL;
+    uLong *outlength = NULL;
+    uint32_t *types = NULL, batch, count, chunk = 0, i;
+    unsigned long long offset;
+    char tmpfilename[2048];
+    struct stat st;
+    int t, numthreads, started, error = 0;
+    FILE *src, *dst = NULL;
+    *originalsize = 0; *packedsize = 0; *crc = 0;
+    tmpfilename[0] = 0;
+    if (threads <= 0) threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads < 1) threads = 1;
+    if (threads > VIDEOPACK_MAXTHREADS) threads = VIDEOPACK_MAXTHREADS;
+    src = fopen(srcfilename, "rb");
+    if (src == NULL) return -1;
+    if (fstat(fileno(src), &st) != 0) goto error;
+    memset(&header, 0, sizeof(struct videopack_header));
+    memcpy(header.magic, VIDEOPACK_MAGIC, 8);
+    header.size = (uint64_t) st.st_size;
+    header.chunksize = VIDEOPACK_CHUNKSIZE;
+    header.numchunks = (uint32_t) ((header.size + VIDEOPACK_CHUNKSIZE - 1) / VIDEOPACK_CHUNKSIZE);
+    batch = (uint32_t) threads * VIDEOPACK_WINDOW;
+    chunks = (struct videopack_chunk *) calloc((size_t) header.numchunks + 1, sizeof(struct videopack_chunk));
+    raw = (unsigned char *) malloc((size_t) batch * VIDEOPACK_CHUNKSIZE);
+    out = (unsigned char **) calloc(batch, sizeof(unsigned char *));
+    outlength = (uLong *) calloc(batch, sizeof(uLong));
+    types = (uint32_t *) calloc(batch, sizeof(uint32_t));
+    if (chunks == NULL || raw == NULL || out == NULL || outlength == NULL || types == NULL) goto nomemory;
+    for (i=0;i<batch;i++) {
+        out[i] = (unsigned char *) malloc(compressBound(VIDEOPACK_CHUNKSIZE));
+        if (out[i] == NULL) goto nomemory;
+    }
+    snprintf(tmpfilename, sizeof(tmpfilename), "%s.%ld", dstfilename, (long) getpid());
+    dst = fopen(tmpfilename, "wb");
+    if (dst == NULL) goto error;
+    // the header and index are written again once the chunks are
+    offset = sizeof(struct videopack_header) + (unsigned long long) header.numchunks * sizeof(struct videopack_chunk);
+    if (fseeko(dst, (off_t) offset, SEEK_SET) != 0) goto error;
+    while (chunk < header.numchunks) {
+        count = header.numchunks - chunk < batch ? header.numchunks - chunk : batch;
+        for (i=0;i<count;i++) {
+            outlength[i] = videopack_chunklength(&header, chunk + i);
+            if (fread(raw + (size_t) i * VIDEOPACK_CHUNKSIZE, 1, outlength[i], src) != outlength[i]) {
+                if (!ferror(src)) errno = EIO;
+                goto error;
+            }
+            *crc = crc32_fast(*crc, raw + (size_t) i * VIDEOPACK_CHUNKSIZE, outlength[i]);
+        }
+        numthreads = (uint32_t) threads < count ? threads : (int) count;
+        for (t=0;t<numthreads;t++) {
+            memset(&work[t], 0, sizeof(struct videopack_work));
+            work[t].count = count;
+            work[t].start = (uint32_t) t;
+            work[t].stride = (uint32_t) numthreads;
+            work[t].raw = raw;
+            work[t].out = out;
+            work[t].outlength = outlength;
+            work[t].types = types;
+            work[t].level = level;
+        }
+        for (started=1;started<numthreads;started++) {
+            if (pthread_create(&threadids[started], NULL, videopack_compressthread, &work[started]) != 0) break;
+        }
+        for (t=started;t<numthreads;t++) videopack_compressthread(&work[t]);
+        videopack_compressthread(&work[0]);
+        for (t=1;t<started;t++) pthread_join(threadids[t], NULL);
+        for (i=0;i<count;i++) {
+            chunks[chunk + i].type = types[i];
+            chunks[chunk + i].length = (uint32_t) outlength[i];
+            chunks[chunk + i].offset = types[i] == VIDEOPACK_ZERO ? 0 : offset;
+            if (outlength[i] && fwrite(out[i], 1, outlength[i], dst) != outlength[i]) goto error;
+            offset += outlength[i];
+        }
+        chunk += count;
+    }
+    header.crc = (uint32_t) *crc;
+    if (fseeko(dst, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(struct videopack_header), 1, dst) != 1 ||
+        fwrite(chunks, sizeof(struct videopack_chunk), header.numchunks, dst) != header.numchunks) goto error;
+    if (fclose(dst) != 0) {
+        dst = NULL;
+        goto error;
+    }
+    dst = NULL;
+    if (videopack_check(tmpfilename, threads, header.size, *crc) != 0) goto error;
+    if (rename(tmpfilename, dstfilename) != 0) goto error;
+    *originalsize = header.size;
+    *packedsize = offset;
+    goto cleanup;
+
+    nomemory:
+    errno = ENOMEM;
+    error:
+    error = errno ? errno : EIO;
+    if (dst != NULL) fclose(dst);
+    if (tmpfilename[0]) remove(tmpfilename);
+    cleanup:
+    fclose(src);
+    if (out != NULL) for (i=0;i<batch;i++) free(out[i]);
+    free(out); free(outlength); free(types); free(raw); free(chunks);
+    if (error) {
+        errno = error;
+      return -1;
+    }
+  return 0;
+}
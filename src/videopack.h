@@ -0,0 +1,43 @@
+#ifndef _VIDEOPACK_H
+#define _VIDEOPACK_H
+
+// packed video files: a Video_XXXXXXXX.iso stealth file compressed with zlib a chunk at a time behind an index of
+// where each chunk is, so it can be read at any offset without decompressing what comes before it.  Chunks that are
+// all zeroes (most of a video partition is padding) aren't stored at all, reading them just fills in zeroes.
+// videopack_fopen() returns an ordinary read-only FILE * so fseeko()/fread() users don't need to know the difference
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define VIDEOPACK_SUFFIX     ".abgxz"    // Video_XXXXXXXX.iso.abgxz
+#define VIDEOPACK_CHUNKSIZE  1048576     // 1 MB
+#define VIDEOPACK_MAXTHREADS 16
+
+// chunk types
+#define VIDEOPACK_ZERO     0
+#define VIDEOPACK_DEFLATE  1
+#define VIDEOPACK_STORED   2             // didn't get any smaller
+
+struct videopack_header {
+    char magic[8];
+    uint64_t size;                       // of the original file
+    uint32_t chunksize, numchunks;
+    uint32_t crc;                        // CRC-32 of the original file
+    uint32_t reserved;
+};
+
+struct videopack_chunk {
+    uint64_t offset;                     // in the packed file
+    uint32_t length, type;
+};
+
+// open a packed file for reading, decompressing chunks ahead of the reader on up to threads threads (0 = one per
+// cpu), returns NULL if it couldn't be opened or isn't a packed file (errno set)
+FILE *videopack_fopen(const char *filename, int threads);
+
+// pack srcfilename into dstfilename through a temp file and rename(), then read the packed file back and make sure
+// it matches, returns 0 (sizes and CRC-32 of the original filled in) or -1 (errno set)
+int videopack_pack(const char *srcfilename, const char *dstfilename, int threads, int level,
+                   unsigned long long *originalsize, unsigned long long *packedsize, unsigned long *crc);
+
+#endif /* videopack.h */
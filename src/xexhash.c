@@ -0,0 +1,128 @@
+/*
+ *  xexhash.c - concurrent SHA-1 verification of Xex blocks for abgx360
+ *
+ *  Blocks are handed out from the front, SHA1FAST_LANES at a time so sha1fast_multi() can hash them side by side on
+ *  cpus without SHA instructions.  The caller never sits idle behind a block nobody has started: xexhash_wait()
+ *  hashes the next pending batch itself, which is also all the hashing there is when there are no threads.
+ */
+
+#include <string.h>
+
+#include "sha1fast.h"
+#include "xexhash.h"
+
+#ifdef _WIN32
+    #define XEXHASH_LOCK(xh)
+    #define XEXHASH_UNLOCK(xh)
+#else
+    #define XEXHASH_LOCK(xh)   pthread_mutex_lock(&(xh)->lock)
+    #define XEXHASH_UNLOCK(xh) pthread_mutex_unlock(&(xh)->lock)
+#endif
+
+// claim the next batch of pending blocks (with the lock held), returns how many
+static unsigned long xexhash_claim(struct xexhash *xh, unsigned long *first) {
+    unsigned long count = 0;
+    *first = xh->nextblock;
+    while (count < SHA1FAST_LANES && xh->nextblock < xh->numblocks) {
+        xh->blocks[xh->nextblock].state = XEXHASH_HASHING;
+        xh->nextblock++;
+        count++;
+    }
+  return count;
+}
+
+// hash a claimed batch (without the lock held) and publish the results
+static void xexhash_batch(struct xexhash *xh, unsigned long first, unsigned long count) {
+    const unsigned char *data[SHA1FAST_LANES] = {NULL};
+    size_t len[SHA1FAST_LANES] = {0};
+    unsigned char digest[SHA1FAST_LANES][20];
+    unsigned long i;
+    for (i=0;i<count;i++) {
+        data[i] = xh->blocks[first+i].data;
+        len[i] = xh->blocks[first+i].size;
+    }
+    sha1fast_multi(data, len, digest, (size_t) count);
+    XEXHASH_LOCK(xh);
+    for (i=0;i<count;i++) {
+        memcpy(xh->blocks[first+i].calculated, digest[i], 20);
+        xh->blocks[first+i].state = memcmp(digest[i], xh->blocks[first+i].expected, 20) == 0 ? XEXHASH_VALID : XEXHASH_CORRUPT;
+    }
+    #ifndef _WIN32
+        pthread_cond_broadcast(&xh->hashed);
+    #endif
+    XEXHASH_UNLOCK(xh);
+  return;
+}
+
+#ifndef _WIN32
+static void *xexhash_thread(void *arg) {
+    struct xexhash *xh = (struct xexhash *) arg;
+    unsigned long first, count;
+    while (1) {
+        pthread_mutex_lock(&xh->lock);
+        count = xexhash_claim(xh, &first);
+        pthread_mutex_unlock(&xh->lock);
+        if (count == 0) break;
+        xexhash_batch(xh, first, count);
+    }
+  return NULL;
+}
+#endif
+
+void xexhash_start(struct xexhash *xh, struct xexhash_block *blocks, unsigned long numblocks, int threads) {
+    unsigned long i;
+    xh->blocks = blocks;
+    xh->numblocks = numblocks;
+    xh->nextblock = 0;
+    xh->numthreads = 0;
+    for (i=0;i<numblocks;i++) blocks[i].state = XEXHASH_PENDING;
+    #ifndef _WIN32
+        pthread_mutex_init(&xh->lock, NULL);
+        pthread_cond_init(&xh->hashed, NULL);
+        // the caller takes the first batch as soon as it waits, so only start threads for the rest
+        if ((unsigned long) threads > (numblocks + SHA1FAST_LANES - 1) / SHA1FAST_LANES)
+            threads = (int) ((numblocks + SHA1FAST_LANES - 1) / SHA1FAST_LANES);
+        if (threads > XEXHASH_MAXTHREADS) threads = XEXHASH_MAXTHREADS;
+        while (xh->numthreads < threads - 1) {
+            if (pthread_create(&xh->threads[xh->numthreads], NULL, xexhash_thread, (void *) xh) != 0) break;
+            xh->numthreads++;
+        }
+    #else
+        (void) threads;
+    #endif
+  return;
+}
+
+int xexhash_wait(struct xexhash *xh, unsigned long i) {
+    unsigned long first, count;
+    int state;
+    XEXHASH_LOCK(xh);
+    while (xh->blocks[i].state < XEXHASH_VALID) {
+        if (xh->blocks[i].state == XEXHASH_PENDING) {
+            count = xexhash_claim(xh, &first);
+            XEXHASH_UNLOCK(xh);
+            xexhash_batch(xh, first, count);
+            XEXHASH_LOCK(xh);
+        }
+        #ifndef _WIN32
+            else pthread_cond_wait(&xh->hashed, &xh->lock);
+        #endif
+    }
+    state = xh->blocks[i].state;
+    XEXHASH_UNLOCK(xh);
+  return state;
+}
+
+void xexhash_finish(struct xexhash *xh) {
+    #ifndef _WIN32
+        int t;
+        pthread_mutex_lock(&xh->lock);
+        xh->nextblock = xh->numblocks;
+        pthread_mutex_unlock(&xh->lock);
+        for (t=0;t<xh->numthreads;t++) pthread_join(xh->threads[t], NULL);
+        pthread_cond_destroy(&xh->hashed);
+        pthread_mutex_destroy(&xh->lock);
+    #endif
+    xh->numthreads = 0;
+  return;
+}
@@ -0,0 +1,52 @@
+#ifndef _XEXHASH_H
+#define _XEXHASH_H
+
+// verify the SHA-1s of a list of blocks on a pool of threads, in roughly the order they come, while the caller
+// waits for them one at a time in order (for the compressed blocks of a Xex: the chain of sizes and hashes has to
+// be walked first, but then every block can be hashed at once while the ones at the front are being decompressed)
+
+#include <stddef.h>
+#ifndef _WIN32
+    #include <pthread.h>
+#endif
+
+#define XEXHASH_MAXTHREADS 64
+
+// block states
+#define XEXHASH_PENDING 0
+#define XEXHASH_HASHING 1
+#define XEXHASH_VALID   2
+#define XEXHASH_CORRUPT 3
+
+struct xexhash_block {
+    const unsigned char *data;
+    size_t size;
+    unsigned char expected[20];
+    unsigned char calculated[20];  // filled in once it's been hashed
+    int state;
+};
+
+struct xexhash {
+    struct xexhash_block *blocks;
+    unsigned long numblocks;
+    unsigned long nextblock;  // the first one nobody has started hashing yet
+    int numthreads;
+    #ifndef _WIN32
+        pthread_t threads[XEXHASH_MAXTHREADS];
+        pthread_mutex_t lock;
+        pthread_cond_t hashed;
+    #endif
+};
+
+// start hashing numblocks blocks on threads - 1 threads (the caller hashes too when it has to wait), or fewer if
+// there isn't enough to go around or they can't be started
+void xexhash_start(struct xexhash *xh, struct xexhash_block *blocks, unsigned long numblocks, int threads);
+
+// wait until block i has been hashed (hashing it and anything still pending before it on this thread if no other
+// thread has started on it yet), returns XEXHASH_VALID or XEXHASH_CORRUPT
+int xexhash_wait(struct xexhash *xh, unsigned long i);
+
+// stop handing out blocks and wait for the threads to finish what they're hashing
+void xexhash_finish(struct xexhash *xh);
+
+#endif /* xexhash.h */
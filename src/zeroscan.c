@@ -0,0 +1,111 @@
+/*
+ *  zeroscan.c - vectorized zero detection for abgx360
+ *
+ *  The vector loops OR 64 bytes together and only look closer when the result isn't zero,
+ *  so blank data runs at memory bandwidth and data is found within 64 bytes of where it starts.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "zeroscan.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define ZEROSCAN_X86
+    #include <cpuid.h>
+    #include <immintrin.h>
+#endif
+#if defined(__aarch64__) && defined(__ARM_NEON)
+    #define ZEROSCAN_NEON
+    #include <arm_neon.h>
+#endif
+
+// scalar scan, used for the tails and on cpus without vectors
+static size_t zeroscan_scalar(const unsigned char *buf, size_t len) {
+    size_t pos = 0;
+    uint64_t word;
+    for (;pos+8<=len;pos+=8) {
+        memcpy(&word, buf + pos, 8);
+        if (word) break;
+    }
+    for (;pos<len;pos++) if (buf[pos]) break;
+  return pos;
+}
+
+#ifdef ZEROSCAN_X86
+__attribute__((target("sse2")))
+static size_t zeroscan_sse2(const unsigned char *buf, size_t len) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i v;
+    size_t pos;
+    for (pos=0;pos+64<=len;pos+=64) {
+        v = _mm_or_si128(_mm_or_si128(_mm_loadu_si128((const __m128i *) (buf + pos)),
+                                      _mm_loadu_si128((const __m128i *) (buf + pos + 16))),
+                         _mm_or_si128(_mm_loadu_si128((const __m128i *) (buf + pos + 32)),
+                                      _mm_loadu_si128((const __m128i *) (buf + pos + 48))));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)) != 0xFFFF) break;
+    }
+  return pos + zeroscan_scalar(buf + pos, len - pos);
+}
+
+__attribute__((target("avx2")))
+static size_t zeroscan_avx2(const unsigned char *buf, size_t len) {
+    __m256i v;
+    size_t pos;
+    for (pos=0;pos+128<=len;pos+=128) {
+        v = _mm256_or_si256(_mm256_or_si256(_mm256_loadu_si256((const __m256i *) (buf + pos)),
+                                            _mm256_loadu_si256((const __m256i *) (buf + pos + 32))),
+                            _mm256_or_si256(_mm256_loadu_si256((const __m256i *) (buf + pos + 64)),
+                                            _mm256_loadu_si256((const __m256i *) (buf + pos + 96))));
+        if (!_mm256_testz_si256(v, v)) break;
+    }
+  return pos + zeroscan_sse2(buf + pos, len - pos);
+}
+
+static size_t (*zeroscan_impl)(const unsigned char *buf, size_t len) = NULL;
+
+static size_t zeroscan_x86(const unsigned char *buf, size_t len) {
+    unsigned int eax, ebx, ecx, edx;
+    // picking the same implementation twice from two threads is harmless
+    if (zeroscan_impl == NULL) {
+        zeroscan_impl = zeroscan_scalar;
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+            if (edx & bit_SSE2) zeroscan_impl = zeroscan_sse2;
+            // avx2 also needs the os to save the ymm registers (osxsave, and xgetbv says xmm and ymm state are enabled)
+            if ((ecx & bit_OSXSAVE) && (ecx & bit_AVX)) {
+                __asm__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+                if ((eax & 6) == 6 && __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & bit_AVX2))
+                    zeroscan_impl = zeroscan_avx2;
+            }
+        }
+    }
+  return zeroscan_impl(buf, len);
+}
+#endif
+
+#ifdef ZEROSCAN_NEON
+static size_t zeroscan_neon(const unsigned char *buf, size_t len) {
+    uint8x16_t v;
+    size_t pos;
+    for (pos=0;pos+64<=len;pos+=64) {
+        v = vorrq_u8(vorrq_u8(vld1q_u8(buf + pos), vld1q_u8(buf + pos + 16)),
+                     vorrq_u8(vld1q_u8(buf + pos + 32), vld1q_u8(buf + pos + 48)));
+        if (vmaxvq_u8(v)) break;
+    }
+  return pos + zeroscan_scalar(buf + pos, len - pos);
+}
+#endif
+
+size_t zeroscan_firstnonzero(const unsigned char *buf, size_t len) {
+    #if defined(ZEROSCAN_X86)
+      return zeroscan_x86(buf, len);
+    #elif defined(ZEROSCAN_NEON)
+      return zeroscan_neon(buf, len);
+    #else
+      return zeroscan_scalar(buf, len);
+    #endif
+}
+
+bool zeroscan_allzeros(const unsigned char *buf, size_t len) {
+  return zeroscan_firstnonzero(buf, len) == len;
+}
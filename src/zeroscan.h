@@ -0,0 +1,16 @@
+#ifndef _ZEROSCAN_H
+#define _ZEROSCAN_H
+
+// fast zero detection for padding/blank checks: SSE2 or AVX2 (picked at runtime) on x86, NEON on ARMv8,
+// 8 bytes at a time everywhere else; all of them stop at the first 64 byte block that isn't blank
+
+#include <stddef.h>
+#include <stdbool.h>
+
+// offset of the first non-zero byte in buf, or len if all len bytes are zero
+size_t zeroscan_firstnonzero(const unsigned char *buf, size_t len);
+
+// true if all len bytes of buf are zero
+bool zeroscan_allzeros(const unsigned char *buf, size_t len);
+
+#endif /* zeroscan.h */
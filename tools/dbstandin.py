@@ -0,0 +1,60 @@
+#!/usr/bin/env python3
+#
+#  dbstandin.py - a local stand-in for the online database, for testing the stealth file prefetch
+#
+#  Serves a folder laid out like the online db (verified/, unverified/ and StealthFiles/ with the inis and
+#  stealth files in them) over HTTP/1.1 with keep-alive and If-Modified-Since, like the real server, and
+#  waits --delay seconds before answering each request so the difference the prefetch makes shows up.
+#  Every request is logged to stderr with the time since the server started, requests that overlap are the
+#  ones that were made at the same time.
+#
+#  python3 tools/dbstandin.py --root /path/to/db --port 8000 --delay 0.2
+#
+#  then point abgx360 at it with these lines in ~/.abgx360/abgx360.ini:
+#
+#  web_inidir: http://127.0.0.1:8000/verified/
+#  web_unverifiedinidir: http://127.0.0.1:8000/unverified/
+#  web_stealthdir: http://127.0.0.1:8000/StealthFiles/
+#
+#  and compare a check with and without --noprefetch (use --noupdate, the stand-in has no abgx360.dat)
+#
+
+import argparse
+import functools
+import http.server
+import sys
+import time
+
+started = time.monotonic()
+
+
+class StandInHandler(http.server.SimpleHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"  # keep-alive, so connections get reused the way they are with the real server
+    delay = 0.0
+
+    def send_head(self):
+        time.sleep(self.delay)
+        return super().send_head()
+
+    def log_message(self, format, *args):
+        sys.stderr.write("%8.3f %s\n" % (time.monotonic() - started, format % args))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="local stand-in for the abgx360 online database")
+    parser.add_argument("--root", default=".", help="folder with verified/, unverified/ and StealthFiles/ in it")
+    parser.add_argument("--port", type=int, default=8000)
+    parser.add_argument("--delay", type=float, default=0.2, help="seconds to wait before answering each request")
+    args = parser.parse_args()
+    StandInHandler.delay = args.delay
+    handler = functools.partial(StandInHandler, directory=args.root)
+    server = http.server.ThreadingHTTPServer(("127.0.0.1", args.port), handler)
+    sys.stderr.write("serving %s on http://127.0.0.1:%d/ with a %.3f s delay\n" % (args.root, args.port, args.delay))
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()